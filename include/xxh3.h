@@ -29,16 +29,18 @@ extern "C" {
 #endif
 
 /* Platform-specific variant availability (FR-005) */
-/* x86-64: SSE2, AVX2, AVX512 variants are always available */
+/* x86-64: SSE2, SSE4.1, AVX2, AVX512 variants are always available */
 /* aarch64: NEON, SVE variants are available */
 #if defined(__x86_64__) || defined(_M_X64) || defined(__amd64__)
 #  define XXH3_HAVE_X86_SIMD 1
 #  define XXH3_HAVE_SSE2     1
+#  define XXH3_HAVE_SSE41    1
 #  define XXH3_HAVE_AVX2     1
 #  define XXH3_HAVE_AVX512   1
 #else
 #  define XXH3_HAVE_X86_SIMD 0
 #  define XXH3_HAVE_SSE2     0
+#  define XXH3_HAVE_SSE41    0
 #  define XXH3_HAVE_AVX2     0
 #  define XXH3_HAVE_AVX512   0
 #endif
@@ -87,6 +89,8 @@ uint64_t xxh3_64_scalar(const void* input, size_t size, uint64_t seed);
 uint64_t xxh3_64_scalar_unseeded(const void* input, size_t size);
 xxh3_128_t xxh3_128_scalar(const void* input, size_t size, uint64_t seed);
 xxh3_128_t xxh3_128_scalar_unseeded(const void* input, size_t size);
+uint64_t xxh3_64_nt_scalar(const void* input, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_nt_scalar(const void* input, size_t size, uint64_t seed);
 
 /* x86-64 SIMD variants (always available on x86-64 builds) */
 #if XXH3_HAVE_SSE2
@@ -94,6 +98,8 @@ uint64_t xxh3_64_sse2(const void* input, size_t size, uint64_t seed);
 uint64_t xxh3_64_sse2_unseeded(const void* input, size_t size);
 xxh3_128_t xxh3_128_sse2(const void* input, size_t size, uint64_t seed);
 xxh3_128_t xxh3_128_sse2_unseeded(const void* input, size_t size);
+uint64_t xxh3_64_nt_sse2(const void* input, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_nt_sse2(const void* input, size_t size, uint64_t seed);
 #endif
 
 #if XXH3_HAVE_AVX2
@@ -101,6 +107,8 @@ uint64_t xxh3_64_avx2(const void* input, size_t size, uint64_t seed);
 uint64_t xxh3_64_avx2_unseeded(const void* input, size_t size);
 xxh3_128_t xxh3_128_avx2(const void* input, size_t size, uint64_t seed);
 xxh3_128_t xxh3_128_avx2_unseeded(const void* input, size_t size);
+uint64_t xxh3_64_nt_avx2(const void* input, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_nt_avx2(const void* input, size_t size, uint64_t seed);
 #endif
 
 #if XXH3_HAVE_AVX512
@@ -108,6 +116,8 @@ uint64_t xxh3_64_avx512(const void* input, size_t size, uint64_t seed);
 uint64_t xxh3_64_avx512_unseeded(const void* input, size_t size);
 xxh3_128_t xxh3_128_avx512(const void* input, size_t size, uint64_t seed);
 xxh3_128_t xxh3_128_avx512_unseeded(const void* input, size_t size);
+uint64_t xxh3_64_nt_avx512(const void* input, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_nt_avx512(const void* input, size_t size, uint64_t seed);
 #endif
 
 /* aarch64 SIMD variants (only available on aarch64 builds) */
@@ -116,6 +126,8 @@ uint64_t xxh3_64_neon(const void* input, size_t size, uint64_t seed);
 uint64_t xxh3_64_neon_unseeded(const void* input, size_t size);
 xxh3_128_t xxh3_128_neon(const void* input, size_t size, uint64_t seed);
 xxh3_128_t xxh3_128_neon_unseeded(const void* input, size_t size);
+uint64_t xxh3_64_nt_neon(const void* input, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_nt_neon(const void* input, size_t size, uint64_t seed);
 #endif
 
 #if XXH3_HAVE_SVE
@@ -123,6 +135,8 @@ uint64_t xxh3_64_sve(const void* input, size_t size, uint64_t seed);
 uint64_t xxh3_64_sve_unseeded(const void* input, size_t size);
 xxh3_128_t xxh3_128_sve(const void* input, size_t size, uint64_t seed);
 xxh3_128_t xxh3_128_sve_unseeded(const void* input, size_t size);
+uint64_t xxh3_64_nt_sve(const void* input, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_nt_sve(const void* input, size_t size, uint64_t seed);
 #endif
 
 xxh3_state_t* xxh3_createState(void);
@@ -138,6 +152,46 @@ void xxh3_128_reset_unseeded(xxh3_state_t* state);
 int xxh3_128_update(xxh3_state_t* state, const void* input, size_t size);
 xxh3_128_t xxh3_128_digest(xxh3_state_t* state);
 
+/* Non-temporal streaming update: same result as xxh3_64_update() /
+ * xxh3_128_update(), but long inputs are read with non-temporal prefetches
+ * (see xxh3_64_nt_<variant>). May be mixed with regular updates on one state. */
+int xxh3_64_update_nt(xxh3_state_t* state, const void* input, size_t size);
+int xxh3_128_update_nt(xxh3_state_t* state, const void* input, size_t size);
+
+/* Lockstep multi-stream update: applies updates[i] = { state, input, size }
+ * for i < count, in order, with the same effect as calling xxh3_64_update()
+ * (resp. xxh3_128_update()) on each. Cache misses on the states of a batch
+ * are overlapped and the stripe loop uses the variant's kernel. A state may
+ * appear more than once. */
+typedef struct {
+    xxh3_state_t* state;
+    const void*   input;
+    size_t        size;
+} xxh3_stream_update_t;
+
+int xxh3_64_update_multi_scalar(const xxh3_stream_update_t* updates, size_t count);
+int xxh3_128_update_multi_scalar(const xxh3_stream_update_t* updates, size_t count);
+#if XXH3_HAVE_SSE2
+int xxh3_64_update_multi_sse2(const xxh3_stream_update_t* updates, size_t count);
+int xxh3_128_update_multi_sse2(const xxh3_stream_update_t* updates, size_t count);
+#endif
+#if XXH3_HAVE_AVX2
+int xxh3_64_update_multi_avx2(const xxh3_stream_update_t* updates, size_t count);
+int xxh3_128_update_multi_avx2(const xxh3_stream_update_t* updates, size_t count);
+#endif
+#if XXH3_HAVE_AVX512
+int xxh3_64_update_multi_avx512(const xxh3_stream_update_t* updates, size_t count);
+int xxh3_128_update_multi_avx512(const xxh3_stream_update_t* updates, size_t count);
+#endif
+#if XXH3_HAVE_NEON
+int xxh3_64_update_multi_neon(const xxh3_stream_update_t* updates, size_t count);
+int xxh3_128_update_multi_neon(const xxh3_stream_update_t* updates, size_t count);
+#endif
+#if XXH3_HAVE_SVE
+int xxh3_64_update_multi_sve(const xxh3_stream_update_t* updates, size_t count);
+int xxh3_128_update_multi_sve(const xxh3_stream_update_t* updates, size_t count);
+#endif
+
 uint64_t xxh3_64_withSecret(const void* input, size_t size, const void* secret, size_t secretSize);
 xxh3_128_t xxh3_128_withSecret(const void* input, size_t size, const void* secret, size_t secretSize);
 void xxh3_64_reset_withSecret(xxh3_state_t* state, const void* secret, size_t secretSize);
@@ -149,10 +203,276 @@ void xxh3_generateSecret(void* secretBuffer, size_t secretSize, uint64_t seed);
 /* State copying: Clone a hash state for branching computation (FR-023) */
 int xxh3_copyState(xxh3_state_t* dst, const xxh3_state_t* src);
 
-/* XXH32 and XXH64: scalar-only single-shot functions (no SIMD variants) */
+/* Prefix checkpoints: the digest of everything absorbed into `state`
+ * followed by `suffix`, equal to the one-shot hash of prefix + suffix.
+ * `state` is left unchanged, so one checkpoint serves any number of
+ * suffixes. Only the accumulators and the buffered tail are copied per
+ * call, not the whole state as with xxh3_copyState(). */
+uint64_t xxh3_64_digest_withSuffix(const xxh3_state_t* state, const void* suffix, size_t size);
+xxh3_128_t xxh3_128_digest_withSuffix(const xxh3_state_t* state, const void* suffix, size_t size);
+
+/* XXH32 and XXH64: scalar single-shot functions */
 uint32_t xxh32(const void* input, size_t size, uint32_t seed);
 uint64_t xxh64(const void* input, size_t size, uint64_t seed);
 
+/* XXH32 single-stream vector variants: same digest as xxh32(), with the four
+ * accumulators in one 128-bit vector. Streaming: xxh32_reset(), then
+ * xxh32_update_<variant>() (may be mixed with xxh32_update()), then
+ * xxh32_digest(). */
+#if XXH3_HAVE_SSE41
+uint32_t xxh32_sse41(const void* input, size_t size, uint32_t seed);
+int xxh32_update_sse41(xxh3_state_t* state, const void* input, size_t size);
+#endif
+#if XXH3_HAVE_NEON
+uint32_t xxh32_neon(const void* input, size_t size, uint32_t seed);
+int xxh32_update_neon(xxh3_state_t* state, const void* input, size_t size);
+#endif
+
+/* XXH32 and XXH64 multi-buffer: out[i] = xxh64(inputs[i], sizes[i], seed)
+ * (resp. xxh32) for i < count, hashing several messages side by side in SIMD
+ * lanes. Messages may have any size and alignment; sizes may differ. */
+void xxh64_batch_scalar(const void* const* inputs, const size_t* sizes, size_t count,
+                        uint64_t seed, uint64_t* out);
+void xxh32_batch_scalar(const void* const* inputs, const size_t* sizes, size_t count,
+                        uint32_t seed, uint32_t* out);
+#if XXH3_HAVE_SSE41
+void xxh32_batch_sse41(const void* const* inputs, const size_t* sizes, size_t count,
+                       uint32_t seed, uint32_t* out);
+#endif
+#if XXH3_HAVE_AVX2
+void xxh64_batch_avx2(const void* const* inputs, const size_t* sizes, size_t count,
+                      uint64_t seed, uint64_t* out);
+void xxh32_batch_avx2(const void* const* inputs, const size_t* sizes, size_t count,
+                      uint32_t seed, uint32_t* out);
+#endif
+#if XXH3_HAVE_AVX512
+void xxh64_batch_avx512(const void* const* inputs, const size_t* sizes, size_t count,
+                        uint64_t seed, uint64_t* out);
+void xxh32_batch_avx512(const void* const* inputs, const size_t* sizes, size_t count,
+                        uint32_t seed, uint32_t* out);
+#endif
+#if XXH3_HAVE_NEON
+void xxh64_batch_neon(const void* const* inputs, const size_t* sizes, size_t count,
+                      uint64_t seed, uint64_t* out);
+void xxh32_batch_neon(const void* const* inputs, const size_t* sizes, size_t count,
+                      uint32_t seed, uint32_t* out);
+#endif
+
+/* Fused copy-and-hash: copies `size` bytes from src to dst (which must not
+ * overlap) and returns the hash of src, equal to memcpy() followed by
+ * xxh3_64_<variant>() / xxh3_128_<variant>(), with the source read from
+ * memory once. The _nt forms write the copy with non-temporal stores when
+ * dst is 64-byte aligned. xxh3_64_update_copy_<variant>() is the streaming
+ * form of xxh3_64_update() (resp. 128). */
+uint64_t xxh3_64_copy_scalar(void* dst, const void* src, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_copy_scalar(void* dst, const void* src, size_t size, uint64_t seed);
+uint64_t xxh3_64_copy_nt_scalar(void* dst, const void* src, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_copy_nt_scalar(void* dst, const void* src, size_t size, uint64_t seed);
+int xxh3_64_update_copy_scalar(xxh3_state_t* state, void* dst, const void* src, size_t size);
+int xxh3_128_update_copy_scalar(xxh3_state_t* state, void* dst, const void* src, size_t size);
+#if XXH3_HAVE_SSE2
+uint64_t xxh3_64_copy_sse2(void* dst, const void* src, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_copy_sse2(void* dst, const void* src, size_t size, uint64_t seed);
+uint64_t xxh3_64_copy_nt_sse2(void* dst, const void* src, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_copy_nt_sse2(void* dst, const void* src, size_t size, uint64_t seed);
+int xxh3_64_update_copy_sse2(xxh3_state_t* state, void* dst, const void* src, size_t size);
+int xxh3_128_update_copy_sse2(xxh3_state_t* state, void* dst, const void* src, size_t size);
+#endif
+#if XXH3_HAVE_AVX2
+uint64_t xxh3_64_copy_avx2(void* dst, const void* src, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_copy_avx2(void* dst, const void* src, size_t size, uint64_t seed);
+uint64_t xxh3_64_copy_nt_avx2(void* dst, const void* src, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_copy_nt_avx2(void* dst, const void* src, size_t size, uint64_t seed);
+int xxh3_64_update_copy_avx2(xxh3_state_t* state, void* dst, const void* src, size_t size);
+int xxh3_128_update_copy_avx2(xxh3_state_t* state, void* dst, const void* src, size_t size);
+#endif
+#if XXH3_HAVE_AVX512
+uint64_t xxh3_64_copy_avx512(void* dst, const void* src, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_copy_avx512(void* dst, const void* src, size_t size, uint64_t seed);
+uint64_t xxh3_64_copy_nt_avx512(void* dst, const void* src, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_copy_nt_avx512(void* dst, const void* src, size_t size, uint64_t seed);
+int xxh3_64_update_copy_avx512(xxh3_state_t* state, void* dst, const void* src, size_t size);
+int xxh3_128_update_copy_avx512(xxh3_state_t* state, void* dst, const void* src, size_t size);
+#endif
+#if XXH3_HAVE_NEON
+uint64_t xxh3_64_copy_neon(void* dst, const void* src, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_copy_neon(void* dst, const void* src, size_t size, uint64_t seed);
+uint64_t xxh3_64_copy_nt_neon(void* dst, const void* src, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_copy_nt_neon(void* dst, const void* src, size_t size, uint64_t seed);
+int xxh3_64_update_copy_neon(xxh3_state_t* state, void* dst, const void* src, size_t size);
+int xxh3_128_update_copy_neon(xxh3_state_t* state, void* dst, const void* src, size_t size);
+#endif
+#if XXH3_HAVE_SVE
+uint64_t xxh3_64_copy_sve(void* dst, const void* src, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_copy_sve(void* dst, const void* src, size_t size, uint64_t seed);
+uint64_t xxh3_64_copy_nt_sve(void* dst, const void* src, size_t size, uint64_t seed);
+xxh3_128_t xxh3_128_copy_nt_sve(void* dst, const void* src, size_t size, uint64_t seed);
+int xxh3_64_update_copy_sve(xxh3_state_t* state, void* dst, const void* src, size_t size);
+int xxh3_128_update_copy_sve(xxh3_state_t* state, void* dst, const void* src, size_t size);
+#endif
+
+/* NUL-terminated strings: returns xxh3_64_<variant>(str, strlen(str), seed)
+ * (resp. 128), finding the terminator and hashing in the same pass, and
+ * stores strlen(str) in *length unless length is NULL. The terminator search
+ * never reads across a page boundary past the NUL. */
+uint64_t xxh3_64_cstr_scalar(const char* str, size_t* length, uint64_t seed);
+xxh3_128_t xxh3_128_cstr_scalar(const char* str, size_t* length, uint64_t seed);
+#if XXH3_HAVE_SSE2
+uint64_t xxh3_64_cstr_sse2(const char* str, size_t* length, uint64_t seed);
+xxh3_128_t xxh3_128_cstr_sse2(const char* str, size_t* length, uint64_t seed);
+#endif
+#if XXH3_HAVE_AVX2
+uint64_t xxh3_64_cstr_avx2(const char* str, size_t* length, uint64_t seed);
+xxh3_128_t xxh3_128_cstr_avx2(const char* str, size_t* length, uint64_t seed);
+#endif
+#if XXH3_HAVE_AVX512
+uint64_t xxh3_64_cstr_avx512(const char* str, size_t* length, uint64_t seed);
+xxh3_128_t xxh3_128_cstr_avx512(const char* str, size_t* length, uint64_t seed);
+#endif
+#if XXH3_HAVE_NEON
+uint64_t xxh3_64_cstr_neon(const char* str, size_t* length, uint64_t seed);
+xxh3_128_t xxh3_128_cstr_neon(const char* str, size_t* length, uint64_t seed);
+#endif
+#if XXH3_HAVE_SVE
+uint64_t xxh3_64_cstr_sve(const char* str, size_t* length, uint64_t seed);
+xxh3_128_t xxh3_128_cstr_sve(const char* str, size_t* length, uint64_t seed);
+#endif
+
+/* ASCII case-insensitive XXH3-64: returns xxh3_64_<variant>() of the input
+ * with 'A'..'Z' lowercased (other bytes, including those >= 0x80, as is),
+ * folding in registers without a lowercase copy. The batch form hashes
+ * `count` inputs into out[i]. xxh3_64_ci_update_<variant>() is the matching
+ * form of xxh3_64_update(): feed a state only through it and finish with
+ * xxh3_64_digest(). */
+uint64_t xxh3_64_ci_scalar(const void* input, size_t size, uint64_t seed);
+void xxh3_64_ci_batch_scalar(const void* const* inputs, const size_t* sizes, size_t count,
+                             uint64_t seed, uint64_t* out);
+int xxh3_64_ci_update_scalar(xxh3_state_t* state, const void* input, size_t size);
+#if XXH3_HAVE_SSE2
+uint64_t xxh3_64_ci_sse2(const void* input, size_t size, uint64_t seed);
+void xxh3_64_ci_batch_sse2(const void* const* inputs, const size_t* sizes, size_t count,
+                           uint64_t seed, uint64_t* out);
+int xxh3_64_ci_update_sse2(xxh3_state_t* state, const void* input, size_t size);
+#endif
+#if XXH3_HAVE_AVX2
+uint64_t xxh3_64_ci_avx2(const void* input, size_t size, uint64_t seed);
+void xxh3_64_ci_batch_avx2(const void* const* inputs, const size_t* sizes, size_t count,
+                           uint64_t seed, uint64_t* out);
+int xxh3_64_ci_update_avx2(xxh3_state_t* state, const void* input, size_t size);
+#endif
+#if XXH3_HAVE_AVX512
+uint64_t xxh3_64_ci_avx512(const void* input, size_t size, uint64_t seed);
+void xxh3_64_ci_batch_avx512(const void* const* inputs, const size_t* sizes, size_t count,
+                             uint64_t seed, uint64_t* out);
+int xxh3_64_ci_update_avx512(xxh3_state_t* state, const void* input, size_t size);
+#endif
+#if XXH3_HAVE_NEON
+uint64_t xxh3_64_ci_neon(const void* input, size_t size, uint64_t seed);
+void xxh3_64_ci_batch_neon(const void* const* inputs, const size_t* sizes, size_t count,
+                           uint64_t seed, uint64_t* out);
+int xxh3_64_ci_update_neon(xxh3_state_t* state, const void* input, size_t size);
+#endif
+#if XXH3_HAVE_SVE
+uint64_t xxh3_64_ci_sve(const void* input, size_t size, uint64_t seed);
+void xxh3_64_ci_batch_sve(const void* const* inputs, const size_t* sizes, size_t count,
+                          uint64_t seed, uint64_t* out);
+int xxh3_64_ci_update_sve(xxh3_state_t* state, const void* input, size_t size);
+#endif
+
+/* Strided 2D and field-gather XXH3-64, hashing scattered bytes as if they
+ * were contiguous without copying them out first.
+ * xxh3_64_strided2d_<variant>() hashes `rows` rows of `row_bytes` bytes, row
+ * r starting at base + r * pitch (e.g. an image tile inside a larger pitched
+ * buffer): the result equals xxh3_64_<variant>() of the rows laid end to end.
+ * xxh3_64_gather_<variant>() hashes, for each of `count` records
+ * `record_size` bytes apart, the byte ranges fields[0..nfields) of that
+ * record in list order (e.g. selected members of an array of structs).
+ * Fields may overlap, repeat or be empty; adjacent fields are read as one
+ * run. The total length must fit in a size_t. */
+typedef struct {
+    size_t offset;  /* from the start of the record */
+    size_t length;
+} xxh3_field_t;
+
+uint64_t xxh3_64_strided2d_scalar(const void* base, size_t row_bytes, size_t rows,
+                                  size_t pitch, uint64_t seed);
+uint64_t xxh3_64_gather_scalar(const void* records, size_t record_size, size_t count,
+                               const xxh3_field_t* fields, size_t nfields, uint64_t seed);
+#if XXH3_HAVE_SSE2
+uint64_t xxh3_64_strided2d_sse2(const void* base, size_t row_bytes, size_t rows,
+                                size_t pitch, uint64_t seed);
+uint64_t xxh3_64_gather_sse2(const void* records, size_t record_size, size_t count,
+                             const xxh3_field_t* fields, size_t nfields, uint64_t seed);
+#endif
+#if XXH3_HAVE_AVX2
+uint64_t xxh3_64_strided2d_avx2(const void* base, size_t row_bytes, size_t rows,
+                                size_t pitch, uint64_t seed);
+uint64_t xxh3_64_gather_avx2(const void* records, size_t record_size, size_t count,
+                             const xxh3_field_t* fields, size_t nfields, uint64_t seed);
+#endif
+#if XXH3_HAVE_AVX512
+uint64_t xxh3_64_strided2d_avx512(const void* base, size_t row_bytes, size_t rows,
+                                  size_t pitch, uint64_t seed);
+uint64_t xxh3_64_gather_avx512(const void* records, size_t record_size, size_t count,
+                               const xxh3_field_t* fields, size_t nfields, uint64_t seed);
+#endif
+#if XXH3_HAVE_NEON
+uint64_t xxh3_64_strided2d_neon(const void* base, size_t row_bytes, size_t rows,
+                                size_t pitch, uint64_t seed);
+uint64_t xxh3_64_gather_neon(const void* records, size_t record_size, size_t count,
+                             const xxh3_field_t* fields, size_t nfields, uint64_t seed);
+#endif
+#if XXH3_HAVE_SVE
+uint64_t xxh3_64_strided2d_sve(const void* base, size_t row_bytes, size_t rows,
+                               size_t pitch, uint64_t seed);
+uint64_t xxh3_64_gather_sve(const void* records, size_t record_size, size_t count,
+                            const xxh3_field_t* fields, size_t nfields, uint64_t seed);
+#endif
+
+/* Multi-seed XXH3-64: out[j] = xxh3_64_<variant>(input, size, seeds[j]) for
+ * j < k, reading the input once and running the seeds side by side in SIMD
+ * lanes. The batch form hashes `count` inputs: out[i * k + j] for input i. */
+void xxh3_64_multiseed_scalar(const void* input, size_t size,
+                              const uint64_t* seeds, size_t k, uint64_t* out);
+void xxh3_64_multiseed_batch_scalar(const void* const* inputs, const size_t* sizes,
+                                    size_t count, const uint64_t* seeds, size_t k,
+                                    uint64_t* out);
+#if XXH3_HAVE_SSE2
+void xxh3_64_multiseed_sse2(const void* input, size_t size,
+                            const uint64_t* seeds, size_t k, uint64_t* out);
+void xxh3_64_multiseed_batch_sse2(const void* const* inputs, const size_t* sizes,
+                                  size_t count, const uint64_t* seeds, size_t k,
+                                  uint64_t* out);
+#endif
+#if XXH3_HAVE_AVX2
+void xxh3_64_multiseed_avx2(const void* input, size_t size,
+                            const uint64_t* seeds, size_t k, uint64_t* out);
+void xxh3_64_multiseed_batch_avx2(const void* const* inputs, const size_t* sizes,
+                                  size_t count, const uint64_t* seeds, size_t k,
+                                  uint64_t* out);
+#endif
+#if XXH3_HAVE_AVX512
+void xxh3_64_multiseed_avx512(const void* input, size_t size,
+                              const uint64_t* seeds, size_t k, uint64_t* out);
+void xxh3_64_multiseed_batch_avx512(const void* const* inputs, const size_t* sizes,
+                                    size_t count, const uint64_t* seeds, size_t k,
+                                    uint64_t* out);
+#endif
+#if XXH3_HAVE_NEON
+void xxh3_64_multiseed_neon(const void* input, size_t size,
+                            const uint64_t* seeds, size_t k, uint64_t* out);
+void xxh3_64_multiseed_batch_neon(const void* const* inputs, const size_t* sizes,
+                                  size_t count, const uint64_t* seeds, size_t k,
+                                  uint64_t* out);
+#endif
+#if XXH3_HAVE_SVE
+void xxh3_64_multiseed_sve(const void* input, size_t size,
+                           const uint64_t* seeds, size_t k, uint64_t* out);
+void xxh3_64_multiseed_batch_sve(const void* const* inputs, const size_t* sizes,
+                                 size_t count, const uint64_t* seeds, size_t k,
+                                 uint64_t* out);
+#endif
+
 /* XXH32 and XXH64: streaming APIs (using shared xxh3_state_t) */
 void xxh32_reset(xxh3_state_t* state, uint32_t seed);
 int xxh32_update(xxh3_state_t* state, const void* input, size_t size);
@@ -177,6 +497,615 @@ void xxh3_generateSecret_fromSeed(void* secretBuffer, uint64_t seed);
 int xxh3_128_isEqual(xxh3_128_t h1, xxh3_128_t h2);
 int xxh3_128_cmp(const void* h128_1, const void* h128_2);
 
+/* Sorting and deduplication of digest arrays, in the order of
+ * xxh3_128_cmp(): by `low`, then by `high` (xxh3_128_cmp() reads an
+ * xxh3_128_t as the vendor's { low64, high64 }).
+ * xxh3_128_sort() is an in-place radix sort that needs no heap memory.
+ * xxh3_128_sort_mt() sorts the top-level buckets on `threads` threads (0: one
+ * per online CPU; single-threaded where pthreads are unavailable).
+ * xxh3_128_unique() removes adjacent duplicates from a sorted array in place
+ * and returns the number of distinct digests left at its start. */
+void xxh3_128_sort(xxh3_128_t* hashes, size_t n);
+void xxh3_128_sort_mt(xxh3_128_t* hashes, size_t n, unsigned threads);
+size_t xxh3_128_unique(xxh3_128_t* hashes, size_t n);
+
+/* Static digest index: a sorted set of digests laid out for search in an
+ * image that can be written to a file and memory-mapped back as is.
+ * xxh3_index_size() is the image size for n digests (0 on overflow).
+ * xxh3_index_build() writes the image of `sorted`, which must be strictly
+ * increasing in xxh3_128_cmp() order (xxh3_128_sort() then
+ * xxh3_128_unique()); it returns XXH3_ERROR otherwise or if dst_size is too
+ * small. The image is portable across byte orders: digests are stored in
+ * canonical form, in Eytzinger (breadth-first search tree) order.
+ * xxh3_index_view() checks an image's header and points `index` into it
+ * without copying; the image must stay mapped while `index` is used, and
+ * lookups are fastest when it is 64-byte aligned (mmap() results are).
+ * xxh3_index_contains() returns 1 if `h` is in the index.
+ * xxh3_index_contains_n() looks up n digests at once, overlapping their
+ * cache misses; found[i] is set to 0 or 1 and the number found returned. */
+#define XXH3_INDEX_VERSION 1
+typedef struct {
+    const unsigned char* slots;  /* read-only; set by xxh3_index_view() */
+    size_t               count;
+    unsigned             depth;
+} xxh3_index_t;
+size_t xxh3_index_size(size_t n);
+int xxh3_index_build(void* dst, size_t dst_size, const xxh3_128_t* sorted, size_t n);
+int xxh3_index_view(xxh3_index_t* index, const void* image, size_t size);
+int xxh3_index_contains(const xxh3_index_t* index, xxh3_128_t h);
+size_t xxh3_index_contains_n(const xxh3_index_t* index, const xxh3_128_t* queries, size_t n,
+                             unsigned char* found);
+
+/* Open-addressing hash map (SwissTable layout) with fixed-size keys and
+ * values stored in the table. Keys are compared bytewise and hashed with
+ * XXH3-64 under `seed`, unless `hash` is set (e.g. to xxh3_64_avx512 for
+ * 97-128 byte keys). Memory comes from `allocator` (copied at creation;
+ * NULL: malloc/free), which must return blocks aligned like malloc().
+ * Values are zeroed on insertion and aligned to the largest power of two,
+ * up to 16, that divides value_size. value_size may be 0 for a set.
+ * xxh3_map_create() returns NULL on allocation failure or a zero key_size.
+ * xxh3_map_find() returns the value of `key`, or NULL if it is absent.
+ * xxh3_map_insert() returns the value of `key`, adding the key if absent
+ * (*inserted, if not NULL, tells which); NULL if the table could not grow.
+ * xxh3_map_erase() returns 1 if `key` was removed. Inserting or erasing
+ * invalidates value pointers. xxh3_map_next() iterates from *pos = 0 and
+ * returns 0 after the last entry. xxh3_map.hpp wraps this in a C++ class. */
+typedef struct {
+    void* (*alloc)(void* ctx, size_t size);
+    void  (*free)(void* ctx, void* ptr, size_t size);
+    void*  ctx;
+} xxh3_allocator_t;
+typedef uint64_t (*xxh3_map_hash_fn)(const void* key, size_t size, uint64_t seed);
+typedef struct {
+    size_t                  key_size;
+    size_t                  value_size;
+    uint64_t                seed;
+    xxh3_map_hash_fn        hash;
+    const xxh3_allocator_t* allocator;
+} xxh3_map_config_t;
+typedef struct xxh3_map_s xxh3_map_t;
+xxh3_map_t* xxh3_map_create(const xxh3_map_config_t* config, size_t capacity);
+void xxh3_map_free(xxh3_map_t* map);
+size_t xxh3_map_size(const xxh3_map_t* map);
+size_t xxh3_map_capacity(const xxh3_map_t* map);
+int xxh3_map_reserve(xxh3_map_t* map, size_t n);
+void xxh3_map_clear(xxh3_map_t* map);
+void* xxh3_map_find(const xxh3_map_t* map, const void* key);
+void* xxh3_map_insert(xxh3_map_t* map, const void* key, int* inserted);
+int xxh3_map_erase(xxh3_map_t* map, const void* key);
+int xxh3_map_next(const xxh3_map_t* map, size_t* pos, const void** key, void** value);
+
+/* Blocked Bloom filter in an image that can be written to a file and
+ * memory-mapped back as is. Each key sets 8 bits in one 32-byte block,
+ * chosen from a single xxh3_64_<variant>() hash under the filter's seed, so
+ * a lookup touches one cache line. False-positive rates by bits per key:
+ * 8: 3.3%, 10: 1.3%, 12: 0.54%, 16: 0.13%, 20: 0.04%.
+ * xxh3_bloom_blocks() is the block count for `keys` keys at `bits_per_key`
+ * (0 on overflow); xxh3_bloom_size() the image size for `blocks` blocks (0
+ * if blocks is 0 or above 2^32). xxh3_bloom_init() writes an empty filter
+ * to `image` and xxh3_bloom_view() checks an image's header; both point
+ * `filter` into the image without copying, and XXH3_ERROR means the size or
+ * header is wrong. A filter viewed in a read-only mapping may only be
+ * queried. Images are portable across byte orders, and every variant sets
+ * the same bits. xxh3_bloom_merge() ORs `src` into `dst`, which must have
+ * the same block count and seed. xxh3_bloom_contains_<variant>() returns 1
+ * if `key` may have been added and 0 if it was not. The batch forms hash
+ * several keys before probing so that their cache misses overlap;
+ * xxh3_bloom_contains_batch_<variant>() sets found[i] to 0 or 1 and
+ * returns the number of 1s. */
+#define XXH3_BLOOM_VERSION 1
+typedef struct {
+    unsigned char* blocks;   /* set by xxh3_bloom_init() / xxh3_bloom_view() */
+    uint64_t       nblocks;
+    uint64_t       seed;
+} xxh3_bloom_t;
+uint64_t xxh3_bloom_blocks(uint64_t keys, unsigned bits_per_key);
+size_t xxh3_bloom_size(uint64_t blocks);
+int xxh3_bloom_init(xxh3_bloom_t* filter, void* image, size_t size, uint64_t blocks, uint64_t seed);
+int xxh3_bloom_view(xxh3_bloom_t* filter, void* image, size_t size);
+int xxh3_bloom_merge(xxh3_bloom_t* dst, const xxh3_bloom_t* src);
+void xxh3_bloom_add_scalar(xxh3_bloom_t* filter, const void* key, size_t size);
+int xxh3_bloom_contains_scalar(const xxh3_bloom_t* filter, const void* key, size_t size);
+void xxh3_bloom_add_batch_scalar(xxh3_bloom_t* filter, const void* const* inputs, const size_t* sizes,
+                                 size_t count);
+size_t xxh3_bloom_contains_batch_scalar(const xxh3_bloom_t* filter, const void* const* inputs,
+                                        const size_t* sizes, size_t count, unsigned char* found);
+#if XXH3_HAVE_SSE2
+void xxh3_bloom_add_sse2(xxh3_bloom_t* filter, const void* key, size_t size);
+int xxh3_bloom_contains_sse2(const xxh3_bloom_t* filter, const void* key, size_t size);
+void xxh3_bloom_add_batch_sse2(xxh3_bloom_t* filter, const void* const* inputs, const size_t* sizes,
+                               size_t count);
+size_t xxh3_bloom_contains_batch_sse2(const xxh3_bloom_t* filter, const void* const* inputs,
+                                      const size_t* sizes, size_t count, unsigned char* found);
+#endif
+#if XXH3_HAVE_AVX2
+void xxh3_bloom_add_avx2(xxh3_bloom_t* filter, const void* key, size_t size);
+int xxh3_bloom_contains_avx2(const xxh3_bloom_t* filter, const void* key, size_t size);
+void xxh3_bloom_add_batch_avx2(xxh3_bloom_t* filter, const void* const* inputs, const size_t* sizes,
+                               size_t count);
+size_t xxh3_bloom_contains_batch_avx2(const xxh3_bloom_t* filter, const void* const* inputs,
+                                      const size_t* sizes, size_t count, unsigned char* found);
+#endif
+#if XXH3_HAVE_AVX512
+void xxh3_bloom_add_avx512(xxh3_bloom_t* filter, const void* key, size_t size);
+int xxh3_bloom_contains_avx512(const xxh3_bloom_t* filter, const void* key, size_t size);
+void xxh3_bloom_add_batch_avx512(xxh3_bloom_t* filter, const void* const* inputs, const size_t* sizes,
+                                 size_t count);
+size_t xxh3_bloom_contains_batch_avx512(const xxh3_bloom_t* filter, const void* const* inputs,
+                                        const size_t* sizes, size_t count, unsigned char* found);
+#endif
+#if XXH3_HAVE_NEON
+void xxh3_bloom_add_neon(xxh3_bloom_t* filter, const void* key, size_t size);
+int xxh3_bloom_contains_neon(const xxh3_bloom_t* filter, const void* key, size_t size);
+void xxh3_bloom_add_batch_neon(xxh3_bloom_t* filter, const void* const* inputs, const size_t* sizes,
+                               size_t count);
+size_t xxh3_bloom_contains_batch_neon(const xxh3_bloom_t* filter, const void* const* inputs,
+                                      const size_t* sizes, size_t count, unsigned char* found);
+#endif
+#if XXH3_HAVE_SVE
+void xxh3_bloom_add_sve(xxh3_bloom_t* filter, const void* key, size_t size);
+int xxh3_bloom_contains_sve(const xxh3_bloom_t* filter, const void* key, size_t size);
+void xxh3_bloom_add_batch_sve(xxh3_bloom_t* filter, const void* const* inputs, const size_t* sizes,
+                              size_t count);
+size_t xxh3_bloom_contains_batch_sve(const xxh3_bloom_t* filter, const void* const* inputs,
+                                     const size_t* sizes, size_t count, unsigned char* found);
+#endif
+
+/* HyperLogLog cardinality sketch (HLL++ sparse form, Ertl's estimator).
+ * A sketch of precision p (4..18) has 2^p one-byte registers, a relative
+ * standard error of about 1.04 / sqrt(2^p) (0.81% at p = 14, 16 KiB), and
+ * hashes keys with xxh3_64_<variant>() under `seed`. It starts sparse,
+ * storing only the registers in use, and becomes dense when that stops
+ * saving memory. Memory comes from `allocator` as for xxh3_map_create().
+ * xxh3_hll_create() returns NULL for an invalid precision or on allocation
+ * failure. xxh3_hll_add_hash() adds an already computed 64-bit hash. The
+ * add functions return XXH3_ERROR if the sketch could not grow.
+ * xxh3_hll_merge_<variant>() adds all keys of `src` to `dst`, which must
+ * have the same precision and seed; `src` may be `dst`.
+ * xxh3_hll_estimate() returns the estimated number of distinct keys; it
+ * may compact a sparse sketch. xxh3_hll_clear() empties a sketch and keeps
+ * its memory. */
+typedef struct xxh3_hll_s xxh3_hll_t;
+xxh3_hll_t* xxh3_hll_create(unsigned precision, uint64_t seed, const xxh3_allocator_t* allocator);
+void xxh3_hll_free(xxh3_hll_t* hll);
+void xxh3_hll_clear(xxh3_hll_t* hll);
+unsigned xxh3_hll_precision(const xxh3_hll_t* hll);
+int xxh3_hll_is_dense(const xxh3_hll_t* hll);
+int xxh3_hll_add_hash(xxh3_hll_t* hll, uint64_t hash);
+double xxh3_hll_estimate(xxh3_hll_t* hll);
+int xxh3_hll_add_scalar(xxh3_hll_t* hll, const void* key, size_t size);
+int xxh3_hll_add_batch_scalar(xxh3_hll_t* hll, const void* const* inputs, const size_t* sizes,
+                              size_t count);
+int xxh3_hll_merge_scalar(xxh3_hll_t* dst, const xxh3_hll_t* src);
+#if XXH3_HAVE_SSE2
+int xxh3_hll_add_sse2(xxh3_hll_t* hll, const void* key, size_t size);
+int xxh3_hll_add_batch_sse2(xxh3_hll_t* hll, const void* const* inputs, const size_t* sizes,
+                            size_t count);
+int xxh3_hll_merge_sse2(xxh3_hll_t* dst, const xxh3_hll_t* src);
+#endif
+#if XXH3_HAVE_AVX2
+int xxh3_hll_add_avx2(xxh3_hll_t* hll, const void* key, size_t size);
+int xxh3_hll_add_batch_avx2(xxh3_hll_t* hll, const void* const* inputs, const size_t* sizes,
+                            size_t count);
+int xxh3_hll_merge_avx2(xxh3_hll_t* dst, const xxh3_hll_t* src);
+#endif
+#if XXH3_HAVE_AVX512
+int xxh3_hll_add_avx512(xxh3_hll_t* hll, const void* key, size_t size);
+int xxh3_hll_add_batch_avx512(xxh3_hll_t* hll, const void* const* inputs, const size_t* sizes,
+                              size_t count);
+int xxh3_hll_merge_avx512(xxh3_hll_t* dst, const xxh3_hll_t* src);
+#endif
+#if XXH3_HAVE_NEON
+int xxh3_hll_add_neon(xxh3_hll_t* hll, const void* key, size_t size);
+int xxh3_hll_add_batch_neon(xxh3_hll_t* hll, const void* const* inputs, const size_t* sizes,
+                            size_t count);
+int xxh3_hll_merge_neon(xxh3_hll_t* dst, const xxh3_hll_t* src);
+#endif
+#if XXH3_HAVE_SVE
+int xxh3_hll_add_sve(xxh3_hll_t* hll, const void* key, size_t size);
+int xxh3_hll_add_batch_sve(xxh3_hll_t* hll, const void* const* inputs, const size_t* sizes,
+                           size_t count);
+int xxh3_hll_merge_sve(xxh3_hll_t* dst, const xxh3_hll_t* src);
+#endif
+
+/* Order-independent multiset hash. A multiset is summarised by the sum,
+ * modulo 2^128, of the XXH3-128 hashes of its elements under `seed`, so it
+ * can be updated in O(1) as elements come and go, and two sets hold the
+ * same elements (with multiplicity) when their digests match, up to hash
+ * collisions. The sum is linear: it detects accidental divergence but is
+ * not meant to resist elements chosen to collide. xxh3_multiset_init()
+ * starts an empty set, whose digest is 0. xxh3_multiset_remove_<variant>()
+ * undoes an add of the same key; removing a key that was never added is
+ * not detected. xxh3_multiset_merge() adds all elements
+ * of `src` to `dst` and returns XXH3_ERROR if their seeds differ. The
+ * *_hash() forms take an already computed XXH3-128 hash. Compare digests
+ * directly or through xxh128_canonicalFromHash(). */
+typedef struct {
+    uint64_t high;
+    uint64_t low;
+    uint64_t seed;
+} xxh3_multiset_t;
+void xxh3_multiset_init(xxh3_multiset_t* set, uint64_t seed);
+void xxh3_multiset_add_hash(xxh3_multiset_t* set, xxh3_128_t hash);
+void xxh3_multiset_remove_hash(xxh3_multiset_t* set, xxh3_128_t hash);
+int xxh3_multiset_merge(xxh3_multiset_t* dst, const xxh3_multiset_t* src);
+xxh3_128_t xxh3_multiset_digest(const xxh3_multiset_t* set);
+void xxh3_multiset_add_scalar(xxh3_multiset_t* set, const void* key, size_t size);
+void xxh3_multiset_remove_scalar(xxh3_multiset_t* set, const void* key, size_t size);
+void xxh3_multiset_add_batch_scalar(xxh3_multiset_t* set, const void* const* inputs,
+                                    const size_t* sizes, size_t count);
+#if XXH3_HAVE_SSE2
+void xxh3_multiset_add_sse2(xxh3_multiset_t* set, const void* key, size_t size);
+void xxh3_multiset_remove_sse2(xxh3_multiset_t* set, const void* key, size_t size);
+void xxh3_multiset_add_batch_sse2(xxh3_multiset_t* set, const void* const* inputs,
+                                  const size_t* sizes, size_t count);
+#endif
+#if XXH3_HAVE_AVX2
+void xxh3_multiset_add_avx2(xxh3_multiset_t* set, const void* key, size_t size);
+void xxh3_multiset_remove_avx2(xxh3_multiset_t* set, const void* key, size_t size);
+void xxh3_multiset_add_batch_avx2(xxh3_multiset_t* set, const void* const* inputs,
+                                  const size_t* sizes, size_t count);
+#endif
+#if XXH3_HAVE_AVX512
+void xxh3_multiset_add_avx512(xxh3_multiset_t* set, const void* key, size_t size);
+void xxh3_multiset_remove_avx512(xxh3_multiset_t* set, const void* key, size_t size);
+void xxh3_multiset_add_batch_avx512(xxh3_multiset_t* set, const void* const* inputs,
+                                    const size_t* sizes, size_t count);
+#endif
+#if XXH3_HAVE_NEON
+void xxh3_multiset_add_neon(xxh3_multiset_t* set, const void* key, size_t size);
+void xxh3_multiset_remove_neon(xxh3_multiset_t* set, const void* key, size_t size);
+void xxh3_multiset_add_batch_neon(xxh3_multiset_t* set, const void* const* inputs,
+                                  const size_t* sizes, size_t count);
+#endif
+#if XXH3_HAVE_SVE
+void xxh3_multiset_add_sve(xxh3_multiset_t* set, const void* key, size_t size);
+void xxh3_multiset_remove_sve(xxh3_multiset_t* set, const void* key, size_t size);
+void xxh3_multiset_add_batch_sve(xxh3_multiset_t* set, const void* const* inputs,
+                                 const size_t* sizes, size_t count);
+#endif
+
+/* Minimal perfect hash function: maps each of n distinct keys to its own
+ * index in 0..n-1, in an image that can be written to a file and
+ * memory-mapped back as is (PTHash-style: partitions, buckets and 16-bit
+ * pilots, about 6.5 bits per key). Keys are hashed with xxh3_64_<variant>().
+ * xxh3_mphf_size() is the image size for n keys (0 above 2^32 - 1 keys).
+ * xxh3_mphf_build_<variant>() writes the image of the keys on `threads`
+ * threads (0: one per online CPU; single-threaded where pthreads are
+ * unavailable), starting from `seed` and moving to the next seeds if the
+ * keys do not place; it returns XXH3_ERROR if dst_size is too small, memory
+ * runs out or the keys are not distinct. It needs 8 bytes per key besides
+ * the image. xxh3_mphf_view() checks an image's header and points `mphf`
+ * into it without copying. xxh3_mphf_lookup_<variant>() returns the index
+ * of a key from the build after one hash and one or, for about 10% of the
+ * keys, two memory reads; other keys get an arbitrary index, below n if n
+ * is not 0. The batch form writes the index of inputs[i] to out[i]. */
+#define XXH3_MPHF_VERSION 1
+typedef struct {
+    const unsigned char* pilots;  /* read-only; set by xxh3_mphf_view() */
+    const unsigned char* remap;
+    uint64_t             count;
+    uint64_t             seed;
+    uint64_t             partitions;
+    uint32_t             buckets;     /* per partition */
+    uint32_t             dense;
+    uint32_t             slots;       /* per partition */
+} xxh3_mphf_t;
+size_t xxh3_mphf_size(size_t n);
+int xxh3_mphf_view(xxh3_mphf_t* mphf, const void* image, size_t size);
+int xxh3_mphf_build_scalar(void* dst, size_t dst_size, const void* const* inputs,
+                           const size_t* sizes, size_t n, uint64_t seed, unsigned threads);
+uint64_t xxh3_mphf_lookup_scalar(const xxh3_mphf_t* mphf, const void* key, size_t size);
+void xxh3_mphf_lookup_batch_scalar(const xxh3_mphf_t* mphf, const void* const* inputs,
+                                   const size_t* sizes, size_t count, uint64_t* out);
+#if XXH3_HAVE_SSE2
+int xxh3_mphf_build_sse2(void* dst, size_t dst_size, const void* const* inputs,
+                         const size_t* sizes, size_t n, uint64_t seed, unsigned threads);
+uint64_t xxh3_mphf_lookup_sse2(const xxh3_mphf_t* mphf, const void* key, size_t size);
+void xxh3_mphf_lookup_batch_sse2(const xxh3_mphf_t* mphf, const void* const* inputs,
+                                 const size_t* sizes, size_t count, uint64_t* out);
+#endif
+#if XXH3_HAVE_AVX2
+int xxh3_mphf_build_avx2(void* dst, size_t dst_size, const void* const* inputs,
+                         const size_t* sizes, size_t n, uint64_t seed, unsigned threads);
+uint64_t xxh3_mphf_lookup_avx2(const xxh3_mphf_t* mphf, const void* key, size_t size);
+void xxh3_mphf_lookup_batch_avx2(const xxh3_mphf_t* mphf, const void* const* inputs,
+                                 const size_t* sizes, size_t count, uint64_t* out);
+#endif
+#if XXH3_HAVE_AVX512
+int xxh3_mphf_build_avx512(void* dst, size_t dst_size, const void* const* inputs,
+                           const size_t* sizes, size_t n, uint64_t seed, unsigned threads);
+uint64_t xxh3_mphf_lookup_avx512(const xxh3_mphf_t* mphf, const void* key, size_t size);
+void xxh3_mphf_lookup_batch_avx512(const xxh3_mphf_t* mphf, const void* const* inputs,
+                                   const size_t* sizes, size_t count, uint64_t* out);
+#endif
+#if XXH3_HAVE_NEON
+int xxh3_mphf_build_neon(void* dst, size_t dst_size, const void* const* inputs,
+                         const size_t* sizes, size_t n, uint64_t seed, unsigned threads);
+uint64_t xxh3_mphf_lookup_neon(const xxh3_mphf_t* mphf, const void* key, size_t size);
+void xxh3_mphf_lookup_batch_neon(const xxh3_mphf_t* mphf, const void* const* inputs,
+                                 const size_t* sizes, size_t count, uint64_t* out);
+#endif
+#if XXH3_HAVE_SVE
+int xxh3_mphf_build_sve(void* dst, size_t dst_size, const void* const* inputs,
+                        const size_t* sizes, size_t n, uint64_t seed, unsigned threads);
+uint64_t xxh3_mphf_lookup_sve(const xxh3_mphf_t* mphf, const void* key, size_t size);
+void xxh3_mphf_lookup_batch_sve(const xxh3_mphf_t* mphf, const void* const* inputs,
+                                const size_t* sizes, size_t count, uint64_t* out);
+#endif
+
+/* Hash partitioning, the partition phase of radix hash joins: each row is
+ * hashed with xxh3_64_<variant>() and its tuple { hash, payload } written
+ * to partition hash >> (64 - bits), for 2^bits partitions (bits at most
+ * 16). The payload is payloads[i], or the row id i if payloads is NULL;
+ * the 64-bit hash stands for the key in the tuple, since keys of any width
+ * do not fit one, and the build and probe phases of the join need it. The
+ * partitions are laid end to end in dst[0..n) in order, partition p holding
+ * hist[p] tuples (2^bits counts written by the call), with rows in their
+ * input order within a partition. From 128 partitions on, tuples go
+ * through a 64-byte write-combining line per partition and out with
+ * non-temporal stores where the variant has them; dst is best 64-byte
+ * aligned. The rows are
+ * split over `threads` threads (0: one per online CPU; single-threaded
+ * where pthreads are unavailable, or below 65536 rows per thread), and
+ * dst does not depend on their number. xxh3_partition_<variant>() takes
+ * fixed-width keys, row i at (const char*)keys + i * key_size;
+ * xxh3_partition_var_<variant>() takes inputs[i] of sizes[i] bytes. Both
+ * return XXH3_ERROR on bad arguments or when memory runs out (they need
+ * (64 + 2 * sizeof(size_t)) bytes per partition and thread). */
+typedef struct {
+    uint64_t hash;
+    uint64_t payload;
+} xxh3_partition_tuple_t;
+int xxh3_partition_scalar(xxh3_partition_tuple_t* dst, size_t* hist, const void* keys,
+                          size_t key_size, const uint64_t* payloads, size_t n, unsigned bits,
+                          uint64_t seed, unsigned threads);
+int xxh3_partition_var_scalar(xxh3_partition_tuple_t* dst, size_t* hist,
+                              const void* const* inputs, const size_t* sizes,
+                              const uint64_t* payloads, size_t n, unsigned bits, uint64_t seed,
+                              unsigned threads);
+#if XXH3_HAVE_SSE2
+int xxh3_partition_sse2(xxh3_partition_tuple_t* dst, size_t* hist, const void* keys,
+                        size_t key_size, const uint64_t* payloads, size_t n, unsigned bits,
+                        uint64_t seed, unsigned threads);
+int xxh3_partition_var_sse2(xxh3_partition_tuple_t* dst, size_t* hist,
+                            const void* const* inputs, const size_t* sizes,
+                            const uint64_t* payloads, size_t n, unsigned bits, uint64_t seed,
+                            unsigned threads);
+#endif
+#if XXH3_HAVE_AVX2
+int xxh3_partition_avx2(xxh3_partition_tuple_t* dst, size_t* hist, const void* keys,
+                        size_t key_size, const uint64_t* payloads, size_t n, unsigned bits,
+                        uint64_t seed, unsigned threads);
+int xxh3_partition_var_avx2(xxh3_partition_tuple_t* dst, size_t* hist,
+                            const void* const* inputs, const size_t* sizes,
+                            const uint64_t* payloads, size_t n, unsigned bits, uint64_t seed,
+                            unsigned threads);
+#endif
+#if XXH3_HAVE_AVX512
+int xxh3_partition_avx512(xxh3_partition_tuple_t* dst, size_t* hist, const void* keys,
+                          size_t key_size, const uint64_t* payloads, size_t n, unsigned bits,
+                          uint64_t seed, unsigned threads);
+int xxh3_partition_var_avx512(xxh3_partition_tuple_t* dst, size_t* hist,
+                              const void* const* inputs, const size_t* sizes,
+                              const uint64_t* payloads, size_t n, unsigned bits, uint64_t seed,
+                              unsigned threads);
+#endif
+#if XXH3_HAVE_NEON
+int xxh3_partition_neon(xxh3_partition_tuple_t* dst, size_t* hist, const void* keys,
+                        size_t key_size, const uint64_t* payloads, size_t n, unsigned bits,
+                        uint64_t seed, unsigned threads);
+int xxh3_partition_var_neon(xxh3_partition_tuple_t* dst, size_t* hist,
+                            const void* const* inputs, const size_t* sizes,
+                            const uint64_t* payloads, size_t n, unsigned bits, uint64_t seed,
+                            unsigned threads);
+#endif
+#if XXH3_HAVE_SVE
+int xxh3_partition_sve(xxh3_partition_tuple_t* dst, size_t* hist, const void* keys,
+                       size_t key_size, const uint64_t* payloads, size_t n, unsigned bits,
+                       uint64_t seed, unsigned threads);
+int xxh3_partition_var_sve(xxh3_partition_tuple_t* dst, size_t* hist,
+                           const void* const* inputs, const size_t* sizes,
+                           const uint64_t* payloads, size_t n, unsigned bits, uint64_t seed,
+                           unsigned threads);
+#endif
+
+/* Consistent hashing. xxh3_jump_bucket() is the jump consistent hash of
+ * Lamping and Veach: it maps a key's 64-bit hash to one of `buckets`
+ * buckets (0 for 0 buckets), and when buckets grow from b to b + 1 only
+ * 1/(b + 1) of the keys move, all to the new bucket. Its results match
+ * other implementations of the paper's algorithm given the same hash.
+ * xxh3_jump_batch_<variant>() does this for inputs[i] hashed with
+ * xxh3_64_<variant>() under `seed`. xxh3_rendezvous_<variant>() ranks
+ * `nodes` nodes for a key by rendezvous (highest random weight) hashing,
+ * node j scoring the key's xxh3_64_<variant>() under seeds[j]. It writes
+ * the indices of the best min(n_top, XXH3_RENDEZVOUS_MAX_TOP) nodes to
+ * top[] best first, and returns how many it wrote. With weights, a key
+ * goes first to node j with probability weights[j] / sum(weights), nodes
+ * of weight 0 never being ranked; with weights NULL all nodes weigh the
+ * same. Adding or removing a node only moves the keys that rank it. The
+ * seeds can be any fixed function of the node names, the same wherever
+ * keys are placed. The ranking is exact without weights; with them it
+ * relies on the C library's log(), so two platforms may rank differently
+ * only when two scores are within a rounding error of each other.
+ * xxh3_rendezvous_batch_<variant>() ranks inputs[i] into
+ * top[i * n_top ...] (n_top clamped as above) and returns the count of
+ * each. */
+#define XXH3_RENDEZVOUS_MAX_TOP 64
+uint32_t xxh3_jump_bucket(uint64_t hash, uint32_t buckets);
+void xxh3_jump_batch_scalar(const void* const* inputs, const size_t* sizes, size_t count,
+                            uint64_t seed, uint32_t buckets, uint32_t* out);
+size_t xxh3_rendezvous_scalar(const void* key, size_t size, const uint64_t* seeds,
+                              const double* weights, size_t nodes, size_t* top, size_t n_top);
+size_t xxh3_rendezvous_batch_scalar(const void* const* inputs, const size_t* sizes, size_t count,
+                                    const uint64_t* seeds, const double* weights, size_t nodes,
+                                    size_t* top, size_t n_top);
+#if XXH3_HAVE_SSE2
+void xxh3_jump_batch_sse2(const void* const* inputs, const size_t* sizes, size_t count,
+                          uint64_t seed, uint32_t buckets, uint32_t* out);
+size_t xxh3_rendezvous_sse2(const void* key, size_t size, const uint64_t* seeds,
+                            const double* weights, size_t nodes, size_t* top, size_t n_top);
+size_t xxh3_rendezvous_batch_sse2(const void* const* inputs, const size_t* sizes, size_t count,
+                                  const uint64_t* seeds, const double* weights, size_t nodes,
+                                  size_t* top, size_t n_top);
+#endif
+#if XXH3_HAVE_AVX2
+void xxh3_jump_batch_avx2(const void* const* inputs, const size_t* sizes, size_t count,
+                          uint64_t seed, uint32_t buckets, uint32_t* out);
+size_t xxh3_rendezvous_avx2(const void* key, size_t size, const uint64_t* seeds,
+                            const double* weights, size_t nodes, size_t* top, size_t n_top);
+size_t xxh3_rendezvous_batch_avx2(const void* const* inputs, const size_t* sizes, size_t count,
+                                  const uint64_t* seeds, const double* weights, size_t nodes,
+                                  size_t* top, size_t n_top);
+#endif
+#if XXH3_HAVE_AVX512
+void xxh3_jump_batch_avx512(const void* const* inputs, const size_t* sizes, size_t count,
+                            uint64_t seed, uint32_t buckets, uint32_t* out);
+size_t xxh3_rendezvous_avx512(const void* key, size_t size, const uint64_t* seeds,
+                              const double* weights, size_t nodes, size_t* top, size_t n_top);
+size_t xxh3_rendezvous_batch_avx512(const void* const* inputs, const size_t* sizes, size_t count,
+                                    const uint64_t* seeds, const double* weights, size_t nodes,
+                                    size_t* top, size_t n_top);
+#endif
+#if XXH3_HAVE_NEON
+void xxh3_jump_batch_neon(const void* const* inputs, const size_t* sizes, size_t count,
+                          uint64_t seed, uint32_t buckets, uint32_t* out);
+size_t xxh3_rendezvous_neon(const void* key, size_t size, const uint64_t* seeds,
+                            const double* weights, size_t nodes, size_t* top, size_t n_top);
+size_t xxh3_rendezvous_batch_neon(const void* const* inputs, const size_t* sizes, size_t count,
+                                  const uint64_t* seeds, const double* weights, size_t nodes,
+                                  size_t* top, size_t n_top);
+#endif
+#if XXH3_HAVE_SVE
+void xxh3_jump_batch_sve(const void* const* inputs, const size_t* sizes, size_t count,
+                         uint64_t seed, uint32_t buckets, uint32_t* out);
+size_t xxh3_rendezvous_sve(const void* key, size_t size, const uint64_t* seeds,
+                           const double* weights, size_t nodes, size_t* top, size_t n_top);
+size_t xxh3_rendezvous_batch_sve(const void* const* inputs, const size_t* sizes, size_t count,
+                                 const uint64_t* seeds, const double* weights, size_t nodes,
+                                 size_t* top, size_t n_top);
+#endif
+
+/* Per-block checksums. xxh3_64_blocks_<variant>() splits buf[0..len) into
+ * blocks of block_size bytes, the last one possibly shorter, and writes
+ * out[i] = xxh3_64_<variant>() of block i under `seed`, for the
+ * ceil(len / block_size) blocks. Under a nonzero seed, the secret of
+ * blocks above 240 bytes is derived once per call rather than per block.
+ * xxh3_64_blocks_mt_<variant>() splits the blocks over `threads` threads
+ * (0: one per online CPU; single-threaded where pthreads are unavailable,
+ * or below 1 MiB per thread).
+ * xxh3_64_blocks_verify_<variant>() compares each block's hash with
+ * expected[i] instead. It sets *n_bad to the number of blocks that differ
+ * and writes the indices of the first min(*n_bad, max_bad) of them to
+ * bad[] in ascending order. All three return XXH3_ERROR on bad arguments
+ * (block_size 0) and, for the verify form, when memory runs out. */
+int xxh3_64_blocks_scalar(const void* buf, size_t len, size_t block_size, uint64_t seed,
+                          uint64_t* out);
+int xxh3_64_blocks_mt_scalar(const void* buf, size_t len, size_t block_size, uint64_t seed,
+                             uint64_t* out, unsigned threads);
+int xxh3_64_blocks_verify_scalar(const void* buf, size_t len, size_t block_size,
+                                 uint64_t seed, const uint64_t* expected, size_t* bad,
+                                 size_t max_bad, size_t* n_bad, unsigned threads);
+#if XXH3_HAVE_SSE2
+int xxh3_64_blocks_sse2(const void* buf, size_t len, size_t block_size, uint64_t seed,
+                        uint64_t* out);
+int xxh3_64_blocks_mt_sse2(const void* buf, size_t len, size_t block_size, uint64_t seed,
+                           uint64_t* out, unsigned threads);
+int xxh3_64_blocks_verify_sse2(const void* buf, size_t len, size_t block_size,
+                               uint64_t seed, const uint64_t* expected, size_t* bad,
+                               size_t max_bad, size_t* n_bad, unsigned threads);
+#endif
+#if XXH3_HAVE_AVX2
+int xxh3_64_blocks_avx2(const void* buf, size_t len, size_t block_size, uint64_t seed,
+                        uint64_t* out);
+int xxh3_64_blocks_mt_avx2(const void* buf, size_t len, size_t block_size, uint64_t seed,
+                           uint64_t* out, unsigned threads);
+int xxh3_64_blocks_verify_avx2(const void* buf, size_t len, size_t block_size,
+                               uint64_t seed, const uint64_t* expected, size_t* bad,
+                               size_t max_bad, size_t* n_bad, unsigned threads);
+#endif
+#if XXH3_HAVE_AVX512
+int xxh3_64_blocks_avx512(const void* buf, size_t len, size_t block_size, uint64_t seed,
+                          uint64_t* out);
+int xxh3_64_blocks_mt_avx512(const void* buf, size_t len, size_t block_size, uint64_t seed,
+                             uint64_t* out, unsigned threads);
+int xxh3_64_blocks_verify_avx512(const void* buf, size_t len, size_t block_size,
+                                 uint64_t seed, const uint64_t* expected, size_t* bad,
+                                 size_t max_bad, size_t* n_bad, unsigned threads);
+#endif
+#if XXH3_HAVE_NEON
+int xxh3_64_blocks_neon(const void* buf, size_t len, size_t block_size, uint64_t seed,
+                        uint64_t* out);
+int xxh3_64_blocks_mt_neon(const void* buf, size_t len, size_t block_size, uint64_t seed,
+                           uint64_t* out, unsigned threads);
+int xxh3_64_blocks_verify_neon(const void* buf, size_t len, size_t block_size,
+                               uint64_t seed, const uint64_t* expected, size_t* bad,
+                               size_t max_bad, size_t* n_bad, unsigned threads);
+#endif
+#if XXH3_HAVE_SVE
+int xxh3_64_blocks_sve(const void* buf, size_t len, size_t block_size, uint64_t seed,
+                       uint64_t* out);
+int xxh3_64_blocks_mt_sve(const void* buf, size_t len, size_t block_size, uint64_t seed,
+                          uint64_t* out, unsigned threads);
+int xxh3_64_blocks_verify_sve(const void* buf, size_t len, size_t block_size,
+                              uint64_t seed, const uint64_t* expected, size_t* bad,
+                              size_t max_bad, size_t* n_bad, unsigned threads);
+#endif
+
+/* Background integrity scrubber. Regions registered with
+ * xxh3_scrubber_add() are buffers, typically memory-mapped files, split into
+ * blocks of block_size bytes (the last one possibly shorter) whose stored
+ * checksums under `seed` are checksums[i], uint64_t for bits 64 and
+ * xxh3_128_t for bits 128. The region id, written to *region, is valid
+ * until xxh3_scrubber_remove() of it; later regions may reuse it. Blocks are checked in order with `hash64` or
+ * `hash128` (NULL: xxh3_64_nt_scalar / xxh3_128_nt_scalar; pass the _nt
+ * kernel of the variant in use), and each mismatch is reported to
+ * on_mismatch(ctx, region, block). on_progress(ctx, progress) follows every
+ * chunk of about chunk_bytes (0: 1 MiB). Both run on the checking thread
+ * and must not remove regions or free the scrubber.
+ * xxh3_scrubber_start() starts a background thread (at SCHED_IDLE priority
+ * where available) that loops over the regions, pass after pass, sleeping
+ * between chunks to stay within bytes_per_sec (0: unlimited) and to use no
+ * more than cpu_percent of one CPU (0: 100); XXH3_ERROR where pthreads are
+ * unavailable. xxh3_scrubber_pause() and xxh3_scrubber_resume() only set a
+ * flag, so a chunk in flight may still complete after a pause; the
+ * position is kept. xxh3_scrubber_step() checks whole blocks on the
+ * calling thread, without limits, until max_bytes or more are checked, and
+ * returns the bytes checked (0 while the thread runs or without regions);
+ * concurrent calls check disjoint chunks.
+ * xxh3_scrubber_remove() returns once the region is no longer being read,
+ * after which it may be unmapped. xxh3_scrubber_free() stops the thread. */
+typedef struct {
+    uint64_t passes;       /* full passes over the regions */
+    uint64_t bytes;        /* bytes checked */
+    uint64_t mismatches;   /* blocks that differed */
+    size_t   region;       /* position: the next block to check */
+    size_t   block;
+} xxh3_scrubber_progress_t;
+typedef void (*xxh3_scrubber_mismatch_fn)(void* ctx, size_t region, size_t block);
+typedef void (*xxh3_scrubber_progress_fn)(void* ctx, const xxh3_scrubber_progress_t* progress);
+typedef struct {
+    uint64_t                  bytes_per_sec;
+    unsigned                  cpu_percent;
+    size_t                    chunk_bytes;
+    uint64_t                  (*hash64)(const void* input, size_t size, uint64_t seed);
+    xxh3_128_t                (*hash128)(const void* input, size_t size, uint64_t seed);
+    xxh3_scrubber_mismatch_fn on_mismatch;
+    xxh3_scrubber_progress_fn on_progress;
+    void*                     ctx;
+} xxh3_scrubber_config_t;
+typedef struct xxh3_scrubber_s xxh3_scrubber_t;
+xxh3_scrubber_t* xxh3_scrubber_create(const xxh3_scrubber_config_t* config);
+void xxh3_scrubber_free(xxh3_scrubber_t* s);
+int xxh3_scrubber_add(xxh3_scrubber_t* s, const void* base, size_t len, size_t block_size,
+                      uint64_t seed, unsigned bits, const void* checksums, size_t* region);
+int xxh3_scrubber_remove(xxh3_scrubber_t* s, size_t region);
+int xxh3_scrubber_start(xxh3_scrubber_t* s);
+void xxh3_scrubber_pause(xxh3_scrubber_t* s);
+void xxh3_scrubber_resume(xxh3_scrubber_t* s);
+size_t xxh3_scrubber_step(xxh3_scrubber_t* s, size_t max_bytes);
+void xxh3_scrubber_progress(xxh3_scrubber_t* s, xxh3_scrubber_progress_t* progress);
+
 /* XXH32 Canonical Representation */
 typedef struct {
     unsigned char digest[4];
@@ -199,6 +1128,61 @@ typedef struct {
 void xxh128_canonicalFromHash(xxh128_canonical_t* dst, xxh3_128_t hash);
 xxh3_128_t xxh128_hashFromCanonical(const xxh128_canonical_t* src);
 
+/* Batch canonical and hex encoding of n digests, SIMD across the arrays.
+ * xxh64_canonicalFromHash_n_<variant>() / xxh128_canonicalFromHash_n_<variant>()
+ * write dst[i] as xxh64_canonicalFromHash() / xxh128_canonicalFromHash()
+ * would. xxh64_toHex_n_<variant>() / xxh128_toHex_n_<variant>() write the
+ * lowercase hex of each canonical digest, as printed by xxhsum: 16 (resp. 32)
+ * characters per digest, back to back, with no terminator. The fromHex forms
+ * read that text back, in either case, and return the number of digests
+ * decoded before the first one holding a non-hex character (n if none). */
+void xxh64_canonicalFromHash_n_scalar(xxh64_canonical_t* dst, const uint64_t* hashes, size_t n);
+void xxh128_canonicalFromHash_n_scalar(xxh128_canonical_t* dst, const xxh3_128_t* hashes, size_t n);
+void xxh64_toHex_n_scalar(char* dst, const uint64_t* hashes, size_t n);
+void xxh128_toHex_n_scalar(char* dst, const xxh3_128_t* hashes, size_t n);
+size_t xxh64_fromHex_n_scalar(uint64_t* hashes, const char* src, size_t n);
+size_t xxh128_fromHex_n_scalar(xxh3_128_t* hashes, const char* src, size_t n);
+#if XXH3_HAVE_SSE2
+void xxh64_canonicalFromHash_n_sse2(xxh64_canonical_t* dst, const uint64_t* hashes, size_t n);
+void xxh128_canonicalFromHash_n_sse2(xxh128_canonical_t* dst, const xxh3_128_t* hashes, size_t n);
+void xxh64_toHex_n_sse2(char* dst, const uint64_t* hashes, size_t n);
+void xxh128_toHex_n_sse2(char* dst, const xxh3_128_t* hashes, size_t n);
+size_t xxh64_fromHex_n_sse2(uint64_t* hashes, const char* src, size_t n);
+size_t xxh128_fromHex_n_sse2(xxh3_128_t* hashes, const char* src, size_t n);
+#endif
+#if XXH3_HAVE_AVX2
+void xxh64_canonicalFromHash_n_avx2(xxh64_canonical_t* dst, const uint64_t* hashes, size_t n);
+void xxh128_canonicalFromHash_n_avx2(xxh128_canonical_t* dst, const xxh3_128_t* hashes, size_t n);
+void xxh64_toHex_n_avx2(char* dst, const uint64_t* hashes, size_t n);
+void xxh128_toHex_n_avx2(char* dst, const xxh3_128_t* hashes, size_t n);
+size_t xxh64_fromHex_n_avx2(uint64_t* hashes, const char* src, size_t n);
+size_t xxh128_fromHex_n_avx2(xxh3_128_t* hashes, const char* src, size_t n);
+#endif
+#if XXH3_HAVE_AVX512
+void xxh64_canonicalFromHash_n_avx512(xxh64_canonical_t* dst, const uint64_t* hashes, size_t n);
+void xxh128_canonicalFromHash_n_avx512(xxh128_canonical_t* dst, const xxh3_128_t* hashes, size_t n);
+void xxh64_toHex_n_avx512(char* dst, const uint64_t* hashes, size_t n);
+void xxh128_toHex_n_avx512(char* dst, const xxh3_128_t* hashes, size_t n);
+size_t xxh64_fromHex_n_avx512(uint64_t* hashes, const char* src, size_t n);
+size_t xxh128_fromHex_n_avx512(xxh3_128_t* hashes, const char* src, size_t n);
+#endif
+#if XXH3_HAVE_NEON
+void xxh64_canonicalFromHash_n_neon(xxh64_canonical_t* dst, const uint64_t* hashes, size_t n);
+void xxh128_canonicalFromHash_n_neon(xxh128_canonical_t* dst, const xxh3_128_t* hashes, size_t n);
+void xxh64_toHex_n_neon(char* dst, const uint64_t* hashes, size_t n);
+void xxh128_toHex_n_neon(char* dst, const xxh3_128_t* hashes, size_t n);
+size_t xxh64_fromHex_n_neon(uint64_t* hashes, const char* src, size_t n);
+size_t xxh128_fromHex_n_neon(xxh3_128_t* hashes, const char* src, size_t n);
+#endif
+#if XXH3_HAVE_SVE
+void xxh64_canonicalFromHash_n_sve(xxh64_canonical_t* dst, const uint64_t* hashes, size_t n);
+void xxh128_canonicalFromHash_n_sve(xxh128_canonical_t* dst, const xxh3_128_t* hashes, size_t n);
+void xxh64_toHex_n_sve(char* dst, const uint64_t* hashes, size_t n);
+void xxh128_toHex_n_sve(char* dst, const xxh3_128_t* hashes, size_t n);
+size_t xxh64_fromHex_n_sve(uint64_t* hashes, const char* src, size_t n);
+size_t xxh128_fromHex_n_sve(xxh3_128_t* hashes, const char* src, size_t n);
+#endif
+
 /*
  * CPU requirements for variant functions (consumer dispatch responsibility):
  * - xxh3_*_sse2: x86/x64 with SSE2
@@ -207,7 +1191,30 @@ xxh3_128_t xxh128_hashFromCanonical(const xxh128_canonical_t* src);
  * - xxh3_*_neon: aarch64 with NEON
  * - xxh3_*_sve: aarch64 with SVE
  *
- * NOTE: xxh32 and xxh64 have no SIMD variants and can be called unconditionally.
+ * Non-temporal variants (xxh3_64_nt_<variant>, xxh3_128_nt_<variant>):
+ * identical digests to xxh3_64_<variant> / xxh3_128_<variant>. Inputs above
+ * 240 bytes are read with `prefetchnta` (x86) / `PRFM PLDL1STRM` (AArch64)
+ * so hashing a multi-GB object does not evict the LLC working set of
+ * co-running code. Opt-in: for cache-resident inputs prefer the regular
+ * variants.
+ *
+ * Multi-buffer XXH32 / XXH64 (xxh{32,64}_batch_<variant>): messages per pass
+ * are 4 (xxh32_batch_sse41, xxh64_batch_avx2), 8 (xxh32_batch_avx2,
+ * xxh64_batch_avx512), 16 (xxh32_batch_avx512), 2 / 4 (xxh64 / xxh32 NEON).
+ * xxh32_batch_sse41 needs SSE4.1; xxh64_batch_avx512 needs AVX512F + DQ.
+ * Throughput gains need many messages of at least a few hundred bytes;
+ * messages shorter than one stripe (16 / 32 bytes) are hashed one by one.
+ *
+ * xxh32_sse41 / xxh32_update_sse41 need SSE4.1. Every stripe waits on two
+ * `pmulld` (10-cycle latency on Intel cores), so beyond a few hundred bytes
+ * they are slower than the scalar xxh32() there. xxh32_neon targets AArch64
+ * cores whose vector multiply is about as fast as the scalar one.
+ *
+ * xxh3_64_multiseed_<variant> runs 4 (AVX2), 8 (AVX512) or svcntd() (SVE)
+ * seeds per vector for 9-240 byte inputs; other sizes and the scalar, SSE2
+ * and NEON variants call xxh3_64_<variant> once per seed.
+ *
+ * NOTE: xxh32 and xxh64 themselves are scalar and can be called unconditionally.
  * Streaming state is shared with XXH3 via xxh3_state_t; lock algorithm at reset time.
  *
  * NOTE: xxh32 and xxh64 do not support secret-based variants;
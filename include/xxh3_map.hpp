@@ -0,0 +1,121 @@
+#ifndef XXH3_MAP_HPP
+#define XXH3_MAP_HPP
+
+/* C++11 wrapper of xxh3_map_t (see xxh3.h).
+ *
+ * xxh3::map<K, V> owns an xxh3_map_t whose keys and values are K and V. Both
+ * must be trivially copyable: entries are moved with memcpy, and keys are
+ * hashed and compared as bytes, so K must not have padding bytes whose
+ * contents vary. Pointers and references to values are invalidated by any
+ * insertion or erasure. Allocation failures throw std::bad_alloc. A map
+ * that was moved from may only be assigned to or destroyed. */
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "xxh3.h"
+
+namespace xxh3 {
+
+template <class K, class V>
+class map {
+    static_assert(std::is_trivially_copyable<K>::value, "xxh3::map keys must be trivially copyable");
+    static_assert(std::is_trivially_copyable<V>::value, "xxh3::map values must be trivially copyable");
+
+public:
+    explicit map(std::size_t capacity = 0, std::uint64_t seed = 0,
+                 const xxh3_allocator_t* allocator = nullptr)
+    {
+        xxh3_map_config_t config;
+        config.key_size   = sizeof(K);
+        config.value_size = sizeof(V);
+        config.seed       = seed;
+        config.hash       = nullptr;
+        config.allocator  = allocator;
+        map_ = xxh3_map_create(&config, capacity);
+        if (map_ == nullptr) {
+            throw std::bad_alloc();
+        }
+    }
+
+    ~map() { xxh3_map_free(map_); }
+
+    map(const map&)            = delete;
+    map& operator=(const map&) = delete;
+
+    map(map&& other) noexcept : map_(other.map_) { other.map_ = nullptr; }
+
+    map& operator=(map&& other) noexcept
+    {
+        std::swap(map_, other.map_);
+        return *this;
+    }
+
+    std::size_t size() const { return xxh3_map_size(map_); }
+    bool        empty() const { return size() == 0; }
+    std::size_t capacity() const { return xxh3_map_capacity(map_); }
+
+    V*       find(const K& key) { return static_cast<V*>(xxh3_map_find(map_, &key)); }
+    const V* find(const K& key) const { return static_cast<const V*>(xxh3_map_find(map_, &key)); }
+    bool     contains(const K& key) const { return find(key) != nullptr; }
+
+    /* Adds key -> value if key is absent; returns the key's value and whether
+     * it was added (an existing value is left as is) */
+    std::pair<V*, bool> insert(const K& key, const V& value)
+    {
+        int inserted = 0;
+        V* const slot = static_cast<V*>(xxh3_map_insert(map_, &key, &inserted));
+        if (slot == nullptr) {
+            throw std::bad_alloc();
+        }
+        if (inserted) {
+            *slot = value;
+        }
+        return std::pair<V*, bool>(slot, inserted != 0);
+    }
+
+    /* The value of key, added zero-filled if absent */
+    V& operator[](const K& key)
+    {
+        V* const slot = static_cast<V*>(xxh3_map_insert(map_, &key, nullptr));
+        if (slot == nullptr) {
+            throw std::bad_alloc();
+        }
+        return *slot;
+    }
+
+    bool erase(const K& key) { return xxh3_map_erase(map_, &key) != 0; }
+    void clear() { xxh3_map_clear(map_); }
+
+    void reserve(std::size_t n)
+    {
+        if (xxh3_map_reserve(map_, n) != XXH3_OK) {
+            throw std::bad_alloc();
+        }
+    }
+
+    /* Calls f(const K&, V&) for every entry, in table order */
+    template <class F>
+    void for_each(F f)
+    {
+        std::size_t pos = 0;
+        const void* key;
+        void*       value;
+        while (xxh3_map_next(map_, &pos, &key, &value)) {
+            f(*static_cast<const K*>(key), *static_cast<V*>(value));
+        }
+    }
+
+    xxh3_map_t*       get() { return map_; }
+    const xxh3_map_t* get() const { return map_; }
+
+private:
+    xxh3_map_t* map_;
+};
+
+} // namespace xxh3
+
+#endif
@@ -0,0 +1,219 @@
+#!/usr/bin/env python3
+"""Benchmark regression gate for bench_variants.
+
+Runs ``bench_variants`` (or loads an existing ``--json`` report) and compares
+the per-variant, per-size throughput samples against a baseline report.
+
+A row is flagged as a regression only when BOTH hold:
+  * the median throughput dropped by more than ``--threshold`` (default 5%),
+  * a one-sided Mann-Whitney U test over the repeated trials rejects
+    "current is not slower" at ``--alpha`` (default 0.01).
+
+The first condition ignores statistically real but irrelevant drifts, the
+second ignores large-looking deltas that are within run-to-run noise.
+
+Usage:
+  bench_compare.py --bench build/bench_variants --baseline base.json
+  bench_compare.py --bench build/bench_variants --baseline base.json --record
+  bench_compare.py --current head.json --baseline base.json
+  bench_compare.py --bench build/bench_variants --baseline cold.json --bench-arg=--mode=flush
+
+Exit status: 0 = no significant slowdown, 1 = regression, 2 = usage/IO error.
+"""
+
+import argparse
+import json
+import math
+import os
+import subprocess
+import sys
+import tempfile
+
+DEFAULT_SIZES = "16,64,240,1024,16384,102400"
+
+
+def run_bench(exe, sizes, trials, min_time, extra):
+    fd, path = tempfile.mkstemp(suffix=".json")
+    os.close(fd)
+    try:
+        cmd = [exe, "--sizes=" + sizes, "--trials=%d" % trials,
+               "--min-time=%g" % min_time, "--json=" + path] + extra
+        print("running: " + " ".join(cmd), file=sys.stderr)
+        subprocess.run(cmd, check=True, stdout=sys.stderr)
+        with open(path) as f:
+            return json.load(f)
+    finally:
+        os.unlink(path)
+
+
+def index_results(report):
+    return {(r["algo"], r["variant"], int(r["size"])): r["samples"]
+            for r in report.get("results", [])}
+
+
+def median(xs):
+    s = sorted(xs)
+    n = len(s)
+    return s[n // 2] if n % 2 else 0.5 * (s[n // 2 - 1] + s[n // 2])
+
+
+def _exact_u_cdf(u, m, n):
+    """P(U <= u) under H0 for sample sizes m, n without ties."""
+    # counts[i][j] is the frequency table of U for sizes (i, j)
+    prev_row = [[1] for _ in range(n + 1)]
+    for i in range(1, m + 1):
+        row = [[1]]
+        for j in range(1, n + 1):
+            a = row[j - 1]              # last element from the second sample
+            b = prev_row[j]             # last element from the first sample, adds j
+            size = max(len(a), len(b) + j)
+            c = [0] * size
+            for k, v in enumerate(a):
+                c[k] += v
+            for k, v in enumerate(b):
+                c[k + j] += v
+            row.append(c)
+        prev_row = row
+    dist = prev_row[n]
+    total = float(sum(dist))
+    return sum(dist[:int(math.floor(u)) + 1]) / total
+
+
+def mann_whitney_less(cur, base):
+    """One-sided p-value for H1: samples in `cur` tend to be smaller."""
+    m, n = len(cur), len(base)
+    if m == 0 or n == 0:
+        return 1.0
+    pooled = sorted([(v, 0) for v in cur] + [(v, 1) for v in base])
+    ranks = [0.0] * len(pooled)
+    ties = []
+    i = 0
+    while i < len(pooled):
+        j = i
+        while j + 1 < len(pooled) and pooled[j + 1][0] == pooled[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2.0 + 1.0
+        if j > i:
+            ties.append(j - i + 1)
+        i = j + 1
+    r_cur = sum(r for r, (_, g) in zip(ranks, pooled) if g == 0)
+    u = r_cur - m * (m + 1) / 2.0
+
+    if not ties and m <= 20 and n <= 20:
+        return _exact_u_cdf(u, m, n)
+
+    mu = m * n / 2.0
+    tie_term = sum(t ** 3 - t for t in ties) / float((m + n) * (m + n - 1))
+    sigma = math.sqrt(m * n / 12.0 * ((m + n + 1) - tie_term))
+    if sigma == 0.0:
+        return 1.0
+    z = (u - mu + 0.5) / sigma   # continuity correction
+    return 0.5 * math.erfc(-z / math.sqrt(2.0))
+
+
+def compare(base, cur, threshold, alpha):
+    rows = []
+    regressions = 0
+    for key in sorted(set(base) | set(cur), key=lambda k: (k[0], k[1], k[2])):
+        b = base.get(key)
+        c = cur.get(key)
+        if b is None or c is None:
+            rows.append((key, b and median(b), c and median(c), None, None,
+                         "NEW" if b is None else "MISSING"))
+            continue
+        mb, mc = median(b), median(c)
+        delta = (mc - mb) / mb if mb else 0.0
+        p = mann_whitney_less(c, b)
+        if delta < -threshold and p < alpha:
+            status = "SLOWER"
+            regressions += 1
+        elif delta > threshold and mann_whitney_less(b, c) < alpha:
+            status = "FASTER"
+        else:
+            status = "ok"
+        rows.append((key, mb, mc, delta, p, status))
+    return rows, regressions
+
+
+def fmt(v, spec):
+    return "-" if v is None else spec % v
+
+
+def print_table(rows):
+    print("%-8s %-8s %9s %13s %13s %8s %8s  %s"
+          % ("algo", "variant", "size", "base MB/s", "cur MB/s", "delta", "p", "status"))
+    for (algo, variant, size), mb, mc, delta, p, status in rows:
+        print("%-8s %-8s %9d %13s %13s %8s %8s  %s"
+              % (algo, variant, size, fmt(mb, "%.1f"), fmt(mc, "%.1f"),
+                 fmt(delta and delta * 100.0, "%+.1f%%"), fmt(p, "%.4f"), status))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    src = ap.add_mutually_exclusive_group(required=True)
+    src.add_argument("--bench", help="path to the bench_variants executable")
+    src.add_argument("--current", help="existing JSON report to compare")
+    ap.add_argument("--baseline", required=True, help="baseline JSON report")
+    ap.add_argument("--record", action="store_true",
+                    help="write the current results to --baseline and exit")
+    ap.add_argument("--sizes", default=DEFAULT_SIZES)
+    ap.add_argument("--trials", type=int, default=7)
+    ap.add_argument("--min-time", type=float, default=0.05)
+    ap.add_argument("--bench-arg", action="append", default=[],
+                    help="extra bench_variants argument, e.g. --bench-arg=--mode=flush")
+    ap.add_argument("--threshold", type=float, default=0.05,
+                    help="relative median slowdown that counts (default 0.05)")
+    ap.add_argument("--alpha", type=float, default=0.01,
+                    help="significance level of the Mann-Whitney test")
+    args = ap.parse_args()
+
+    try:
+        if args.bench:
+            current = run_bench(args.bench, args.sizes, args.trials, args.min_time,
+                                args.bench_arg)
+        else:
+            with open(args.current) as f:
+                current = json.load(f)
+    except (OSError, ValueError, subprocess.CalledProcessError) as e:
+        print("error: %s" % e, file=sys.stderr)
+        return 2
+
+    if args.record:
+        with open(args.baseline, "w") as f:
+            json.dump(current, f, indent=2)
+            f.write("\n")
+        print("baseline written to %s" % args.baseline)
+        return 0
+
+    try:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+    except (OSError, ValueError) as e:
+        print("error: cannot load baseline: %s" % e, file=sys.stderr)
+        print("record one with: %s --bench <bench_variants> --baseline %s --record"
+              % (sys.argv[0], args.baseline), file=sys.stderr)
+        return 2
+
+    # reports written before the cold-cache modes existed are hot-mode runs
+    for field, default in (("mode", "hot"), ("arena", 0), ("pages", "n/a")):
+        b, c = baseline.get(field, default), current.get(field, default)
+        if b != c:
+            print("error: baseline %s=%r but current %s=%r; results are not comparable"
+                  % (field, b, field, c), file=sys.stderr)
+            return 2
+
+    rows, regressions = compare(index_results(baseline), index_results(current),
+                                args.threshold, args.alpha)
+    print_table(rows)
+    if regressions:
+        print("\n%d significant slowdown(s) beyond %.1f%% (alpha=%g)"
+              % (regressions, args.threshold * 100.0, args.alpha))
+        return 1
+    print("\nno significant slowdown beyond %.1f%% (alpha=%g)"
+          % (args.threshold * 100.0, args.alpha))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -45,4 +45,82 @@
 #  define XXH3_WRAPPER_GUARD(...) ((void)0)
 #endif
 
+/* --------------------------------------------------------------------------
+ * Variant templates
+ *
+ * Kernels shared by every SIMD variant live in `src/variants/templates/` and
+ * are instantiated by each variant TU, after xxhash.h (XXH_INLINE_ALL) and
+ * all other #includes:
+ *
+ *   #define XXH3_VARIANT avx2
+ *   #include "variants/templates/nt.h"
+ *
+ * XXH3_VARIANT_FN(xxh3_64_nt) then expands to `xxh3_64_nt_avx2`.
+ * -------------------------------------------------------------------------- */
+#define XXH3_VARIANT_CAT_(prefix, variant) prefix##_##variant
+#define XXH3_VARIANT_CAT(prefix, variant)  XXH3_VARIANT_CAT_(prefix, variant)
+#define XXH3_VARIANT_FN(prefix)            XXH3_VARIANT_CAT(prefix, XXH3_VARIANT)
+
+/* Library-internal symbols shared between TUs but not part of the ABI */
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_WIN32)
+#  define XXH3_WRAPPER_INTERNAL __attribute__((visibility("hidden")))
+#else
+#  define XXH3_WRAPPER_INTERNAL
+#endif
+
+/* --------------------------------------------------------------------------
+ * Non-temporal read hint
+ *
+ * XXH3_PREFETCH_NT(ptr) requests a line with minimal cache pollution:
+ * `prefetchnta` on x86, `PRFM PLDL1STRM` on AArch64. Prefetches never fault,
+ * so prefetching past the end of the input is harmless.
+ * -------------------------------------------------------------------------- */
+#if defined(__GNUC__) || defined(__clang__)
+#  define XXH3_PREFETCH_NT(ptr) __builtin_prefetch((ptr), 0 /* read */, 0 /* no temporal locality */)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#  include <xmmintrin.h>
+#  define XXH3_PREFETCH_NT(ptr) _mm_prefetch((const char*)(ptr), _MM_HINT_NTA)
+#else
+#  define XXH3_PREFETCH_NT(ptr) ((void)(ptr))
+#endif
+
+#ifndef XXH3_NT_PREFETCH_DIST
+#  define XXH3_NT_PREFETCH_DIST 512 /* bytes ahead of the current stripe */
+#endif
+
+/* --------------------------------------------------------------------------
+ * Terminator search
+ *
+ * The C-string kernels (variants/templates/cstr.h) look for the NUL 64
+ * bytes at a time without crossing a page, so the loads cannot fault, but
+ * they may cover bytes before the string and after its terminator, which
+ * AddressSanitizer reports; the search helpers are marked
+ * XXH3_NO_SANITIZE_ADDRESS. xxh3_ctz64(x) is the index of the lowest set
+ * bit of a nonzero x.
+ * -------------------------------------------------------------------------- */
+#if defined(__SANITIZE_ADDRESS__)
+#  define XXH3_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#elif defined(__has_feature)
+#  if __has_feature(address_sanitizer)
+#    define XXH3_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#  endif
+#endif
+#ifndef XXH3_NO_SANITIZE_ADDRESS
+#  define XXH3_NO_SANITIZE_ADDRESS
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#  define xxh3_ctz64(x) ((unsigned)__builtin_ctzll(x))
+#else
+static inline unsigned xxh3_ctz64(unsigned long long x)
+{
+    unsigned n = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+}
+#endif
+
 #endif
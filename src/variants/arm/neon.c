@@ -5,6 +5,13 @@
 #include "xxhash.h"
 
 #include "xxh3_converters.h"
+#include "xxh3_state_internal.h"
+#include "xxh3_xxh32_internal.h"
+#include "xxh3_hll_internal.h"
+#include "xxh3_mphf_internal.h"
+#include "xxh3_partition_internal.h"
+#include "xxh3_consistent_internal.h"
+#include "xxh3_blocks_internal.h"
 #include "common/internal_utils.h"
 
 uint64_t xxh3_64_neon(const void* input, size_t size, uint64_t seed)
@@ -47,3 +54,293 @@ xxh3_128_t xxh3_128_neon_unseeded(const void* input, size_t size)
     });
     return xxh128_to_xxh3(XXH3_128bits_withSeed(input, size, 0));
 }
+
+/* Non-temporal long-input kernels: xxh3_64_nt_neon(), xxh3_128_nt_neon() */
+#define XXH3_VARIANT neon
+#include "variants/templates/nt.h"
+
+/* ------------------------------------------------------------------------
+ * Multi-buffer XXH64 / XXH32 (see variants/templates/batch.h)
+ *
+ * XXH64: 2 messages per pass. NEON has no 64x64 multiply; the lane product
+ * with a prime is `umull` of the low halves plus the two cross products
+ * shifted up by 32 bits.
+ * XXH32: 4 messages per pass with `mul`.
+ * Rotates use shift + shift-right-and-insert (`sri`).
+ * ------------------------------------------------------------------------ */
+
+/* x * k mod 2^64 per lane */
+XXH_FORCE_INLINE uint64x2_t xxh_batch_mul64_neon(uint64x2_t x, xxh_u64 k)
+{
+    uint32x2_t const x_lo  = vmovn_u64(x);
+    uint32x2_t const x_hi  = vshrn_n_u64(x, 32);
+    uint32x2_t const k_lo  = vdup_n_u32((xxh_u32)k);
+    uint32x2_t const k_hi  = vdup_n_u32((xxh_u32)(k >> 32));
+    uint32x2_t const cross = vmla_u32(vmul_u32(x_hi, k_lo), x_lo, k_hi);
+    return vaddq_u64(vmull_u32(x_lo, k_lo), vshll_n_u32(cross, 32));
+}
+
+XXH_FORCE_INLINE uint64x2_t xxh_batch_round64_neon(uint64x2_t acc, uint64x2_t input)
+{
+    acc = vaddq_u64(acc, xxh_batch_mul64_neon(input, XXH_PRIME64_2));
+    acc = vsriq_n_u64(vshlq_n_u64(acc, 31), acc, 33);
+    return xxh_batch_mul64_neon(acc, XXH_PRIME64_1);
+}
+
+static void xxh64_batch_stripes_neon(xxh_u64 acc[4][2], const xxh_u8* in[2],
+                                     const size_t step[2], size_t nbStripes)
+{
+    uint64x2_t a0 = vld1q_u64(acc[0]);
+    uint64x2_t a1 = vld1q_u64(acc[1]);
+    uint64x2_t a2 = vld1q_u64(acc[2]);
+    uint64x2_t a3 = vld1q_u64(acc[3]);
+    const xxh_u8* p0 = in[0];
+    const xxh_u8* p1 = in[1];
+    size_t n;
+
+    for (n = 0; n < nbStripes; n++) {
+        uint64x2_t const x01 = vreinterpretq_u64_u8(vld1q_u8(p0));
+        uint64x2_t const x23 = vreinterpretq_u64_u8(vld1q_u8(p0 + 16));
+        uint64x2_t const y01 = vreinterpretq_u64_u8(vld1q_u8(p1));
+        uint64x2_t const y23 = vreinterpretq_u64_u8(vld1q_u8(p1 + 16));
+
+        a0 = xxh_batch_round64_neon(a0, vzip1q_u64(x01, y01));
+        a1 = xxh_batch_round64_neon(a1, vzip2q_u64(x01, y01));
+        a2 = xxh_batch_round64_neon(a2, vzip1q_u64(x23, y23));
+        a3 = xxh_batch_round64_neon(a3, vzip2q_u64(x23, y23));
+        p0 += step[0];
+        p1 += step[1];
+    }
+    vst1q_u64(acc[0], a0);
+    vst1q_u64(acc[1], a1);
+    vst1q_u64(acc[2], a2);
+    vst1q_u64(acc[3], a3);
+    in[0] = p0;
+    in[1] = p1;
+}
+
+XXH_FORCE_INLINE uint32x4_t xxh_batch_round32_neon(uint32x4_t acc, uint32x4_t input)
+{
+    acc = vmlaq_u32(acc, input, vdupq_n_u32(XXH_PRIME32_2));
+    acc = vsriq_n_u32(vshlq_n_u32(acc, 13), acc, 19);
+    return vmulq_u32(acc, vdupq_n_u32(XXH_PRIME32_1));
+}
+
+/* Single-stream XXH32: one vector holds the four accumulators of a message
+ * (see variants/templates/xxh32.h) */
+static void xxh32_stripes_vec(xxh_u32 v[4], const xxh_u8* p, size_t nbStripes)
+{
+    uint32x4_t acc = vld1q_u32(v);
+    size_t n;
+
+    for (n = 0; n < nbStripes; n++) {
+        acc = xxh_batch_round32_neon(acc, vreinterpretq_u32_u8(vld1q_u8(p + 16 * n)));
+    }
+    vst1q_u32(v, acc);
+}
+
+#include "variants/templates/xxh32.h"
+
+static void xxh32_batch_stripes_neon(xxh_u32 acc[4][4], const xxh_u8* in[4],
+                                     const size_t step[4], size_t nbStripes)
+{
+    uint32x4_t a0 = vld1q_u32(acc[0]);
+    uint32x4_t a1 = vld1q_u32(acc[1]);
+    uint32x4_t a2 = vld1q_u32(acc[2]);
+    uint32x4_t a3 = vld1q_u32(acc[3]);
+    const xxh_u8* p0 = in[0];
+    const xxh_u8* p1 = in[1];
+    const xxh_u8* p2 = in[2];
+    const xxh_u8* p3 = in[3];
+    size_t n;
+
+    for (n = 0; n < nbStripes; n++) {
+        /* 4x4 transpose of 32-bit words: w_k = word k of every message */
+        uint32x4_t const r0 = vreinterpretq_u32_u8(vld1q_u8(p0));
+        uint32x4_t const r1 = vreinterpretq_u32_u8(vld1q_u8(p1));
+        uint32x4_t const r2 = vreinterpretq_u32_u8(vld1q_u8(p2));
+        uint32x4_t const r3 = vreinterpretq_u32_u8(vld1q_u8(p3));
+        uint64x2_t const t0 = vreinterpretq_u64_u32(vtrn1q_u32(r0, r1));  /* w0 w2 of 0,1 */
+        uint64x2_t const t1 = vreinterpretq_u64_u32(vtrn2q_u32(r0, r1));  /* w1 w3 of 0,1 */
+        uint64x2_t const t2 = vreinterpretq_u64_u32(vtrn1q_u32(r2, r3));
+        uint64x2_t const t3 = vreinterpretq_u64_u32(vtrn2q_u32(r2, r3));
+
+        a0 = xxh_batch_round32_neon(a0, vreinterpretq_u32_u64(vtrn1q_u64(t0, t2)));
+        a1 = xxh_batch_round32_neon(a1, vreinterpretq_u32_u64(vtrn1q_u64(t1, t3)));
+        a2 = xxh_batch_round32_neon(a2, vreinterpretq_u32_u64(vtrn2q_u64(t0, t2)));
+        a3 = xxh_batch_round32_neon(a3, vreinterpretq_u32_u64(vtrn2q_u64(t1, t3)));
+        p0 += step[0];
+        p1 += step[1];
+        p2 += step[2];
+        p3 += step[3];
+    }
+    vst1q_u32(acc[0], a0);
+    vst1q_u32(acc[1], a1);
+    vst1q_u32(acc[2], a2);
+    vst1q_u32(acc[3], a3);
+    in[0] = p0;
+    in[1] = p1;
+    in[2] = p2;
+    in[3] = p3;
+}
+
+#define XXH_BATCH_FN      xxh64_batch_neon
+#define XXH_BATCH_BITS    64
+#define XXH_BATCH_LANES   2
+#define XXH_BATCH_STRIPES xxh64_batch_stripes_neon
+#include "variants/templates/batch.h"
+
+#define XXH_BATCH_FN      xxh32_batch_neon
+#define XXH_BATCH_BITS    32
+#define XXH_BATCH_LANES   4
+#define XXH_BATCH_STRIPES xxh32_batch_stripes_neon
+#include "variants/templates/batch.h"
+
+/* Multi-seed XXH3-64, scalar per-seed path (see variants/templates/multiseed.h) */
+#include "variants/templates/multiseed.h"
+
+/* Lockstep update of many streams (see variants/templates/multistream.h) */
+#include "variants/templates/multistream.h"
+
+/* Fused copy-and-hash (see variants/templates/copy.h). ACLE has no
+ * non-temporal NEON store, so the _nt forms use regular stores. */
+#include "variants/templates/copy.h"
+
+/* C-string hashing (see variants/templates/cstr.h). NEON has no movemask;
+ * narrowing the byte compare by 4 bits gives a nibble per byte. */
+static XXH3_NO_SANITIZE_ADDRESS size_t xxh3_cstr_line_nul_neon(const xxh_u8* line, size_t from)
+{
+    size_t i;
+    for (i = from & ~(size_t)15; i < 64; i += 16) {
+        uint8x16_t const eq = vceqq_u8(vld1q_u8(line + i), vdupq_n_u8(0));
+        xxh_u64 m = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        if (i < from) {
+            m &= ~(xxh_u64)0 << (4 * (from - i));
+        }
+        if (m != 0) {
+            return i + xxh3_ctz64(m) / 4;
+        }
+    }
+    return 64;
+}
+#define XXH3_CSTR_LINE_NUL(line, from) xxh3_cstr_line_nul_neon((line), (from))
+#include "variants/templates/cstr.h"
+
+/* Case-insensitive XXH3-64 (see variants/templates/ci.h). The stripe kernel
+ * is all-NEON: the vendor's scalar lanes would each need their own fold. */
+XXH_FORCE_INLINE uint8x16_t xxh3_ci_fold_neon(uint8x16_t v)
+{
+    uint8x16_t const upper = vcltq_u8(vsubq_u8(v, vdupq_n_u8('A')), vdupq_n_u8(26));
+    return vorrq_u8(v, vandq_u8(upper, vdupq_n_u8(0x20)));
+}
+
+XXH_FORCE_INLINE void xxh3_ci_fold_line_neon(xxh_u8* dst, const xxh_u8* src)
+{
+    size_t i;
+    for (i = 0; i < XXH_STRIPE_LEN; i += 16) {
+        vst1q_u8(dst + i, xxh3_ci_fold_neon(vld1q_u8(src + i)));
+    }
+}
+
+/* acc[i] += swap(data)[i] + lo32(data ^ key)[i] * hi32(data ^ key)[i] */
+XXH_FORCE_INLINE void xxh3_ci_accumulate_512_neon(xxh_u64* XXH_RESTRICT acc, const xxh_u8* XXH_RESTRICT input,
+                                                  const xxh_u8* XXH_RESTRICT secret)
+{
+    size_t i;
+    for (i = 0; i < XXH_ACC_NB; i += 2) {
+        uint64x2_t const data_vec  = vreinterpretq_u64_u8(xxh3_ci_fold_neon(vld1q_u8(input + 8 * i)));
+        uint64x2_t const data_key  = veorq_u64(data_vec, vreinterpretq_u64_u8(vld1q_u8(secret + 8 * i)));
+        uint64x2_t const data_swap = vextq_u64(data_vec, data_vec, 1);
+        uint64x2_t const sum       = vmlal_u32(data_swap, vmovn_u64(data_key), vshrn_n_u64(data_key, 32));
+        vst1q_u64(acc + i, vaddq_u64(vld1q_u64(acc + i), sum));
+    }
+}
+
+/* 16-byte reads of the short-input paths */
+XXH_FORCE_INLINE void xxh3_ci_fold128_neon(uint8x16_t v, xxh_u64* lo, xxh_u64* hi)
+{
+    uint64x2_t const folded = vreinterpretq_u64_u8(xxh3_ci_fold_neon(v));
+    *lo = vgetq_lane_u64(folded, 0);
+    *hi = vgetq_lane_u64(folded, 1);
+}
+#define XXH3_CI_READ2(p, q, lo, hi) \
+    xxh3_ci_fold128_neon(vcombine_u8(vld1_u8(p), vld1_u8(q)), &(lo), &(hi))
+#define XXH3_CI_READ128(p, lo, hi) \
+    xxh3_ci_fold128_neon(vld1q_u8(p), &(lo), &(hi))
+#define XXH3_CI_FOLD_LINE(dst, src)             xxh3_ci_fold_line_neon((dst), (src))
+#define XXH3_CI_ACCUMULATE_512(acc, in, secret) xxh3_ci_accumulate_512_neon((acc), (in), (secret))
+#include "variants/templates/ci.h"
+
+/* Strided 2D and field-gather hashing (see variants/templates/gather.h) */
+#include "variants/templates/gather.h"
+
+/* Batch canonical and hex encoding (see variants/templates/hex.h) with the
+ * kernels of variants/arm/neon_hooks.h */
+#include "variants/arm/neon_hooks.h"
+#define XXH3_HEX_BSWAP(dst, src) xxh3_hex_bswap_neon((dst), (src))
+#define XXH3_HEX_ENCODE(dst, src) xxh3_hex_encode_neon((dst), (src))
+#define XXH3_HEX_DECODE(dst, src) xxh3_hex_decode_neon((dst), (src))
+#include "variants/templates/hex.h"
+
+/* Blocked Bloom filter (see variants/templates/bloom.h) with the kernels of
+ * variants/arm/neon_hooks.h */
+#define XXH3_BLOOM_SET(block, key, salt) xxh3_bloom_set_neon((block), (key), (salt))
+#define XXH3_BLOOM_TEST(block, key, salt) xxh3_bloom_test_neon((block), (key), (salt))
+#include "variants/templates/bloom.h"
+
+/* HyperLogLog sketches (see variants/templates/hll.h). NEON counts leading
+ * zeros in 32-bit lanes only: the ranks of 8 hashes come from the upper
+ * halves of the shifted hashes, and the rare group where one of those is 0
+ * is ranked in scalar code. The register maximum is UMAX */
+XXH_FORCE_INLINE void xxh3_hll_rank8_neon(xxh_u8* ranks, const xxh_u64* hashes, unsigned p)
+{
+    int64x2_t const  count = vdupq_n_s64((int64_t)p);
+    uint64x2_t const guard = vdupq_n_u64((xxh_u64)1 << (p - 1));
+    uint32x4_t hi[2];
+    size_t j;
+
+    for (j = 0; j < 2; j++) {
+        uint64x2_t const a = vorrq_u64(vshlq_u64(vld1q_u64(hashes + 4 * j), count), guard);
+        uint64x2_t const b = vorrq_u64(vshlq_u64(vld1q_u64(hashes + 4 * j + 2), count), guard);
+        hi[j] = vcombine_u32(vshrn_n_u64(a, 32), vshrn_n_u64(b, 32));
+    }
+    if (vminvq_u32(vminq_u32(hi[0], hi[1])) == 0) {
+        for (j = 0; j < 8; j++) {
+            ranks[j] = (xxh_u8)xxh3_hll_rank(hashes[j], p);
+        }
+        return;
+    }
+    {   uint32x4_t const one = vdupq_n_u32(1);
+        uint16x8_t const r   = vcombine_u16(vmovn_u32(vaddq_u32(vclzq_u32(hi[0]), one)),
+                                            vmovn_u32(vaddq_u32(vclzq_u32(hi[1]), one)));
+        vst1_u8(ranks, vmovn_u16(r));
+    }
+}
+
+XXH_FORCE_INLINE void xxh3_hll_max_neon(xxh_u8* dst, const xxh_u8* src, size_t n)
+{
+    size_t i;
+    for (i = 0; i < n; i += 16) {
+        vst1q_u8(dst + i, vmaxq_u8(vld1q_u8(dst + i), vld1q_u8(src + i)));
+    }
+}
+#define XXH3_HLL_RANK8(ranks, hashes, p) xxh3_hll_rank8_neon((ranks), (hashes), (p))
+#define XXH3_HLL_MAX(dst, src, n) xxh3_hll_max_neon((dst), (src), (n))
+#include "variants/templates/hll.h"
+
+/* Multiset hashes (see variants/templates/multiset.h) */
+#include "variants/templates/multiset.h"
+
+/* Minimal perfect hash functions (see variants/templates/mphf.h) */
+#include "variants/templates/mphf.h"
+
+/* Hash partitioning (see variants/templates/partition.h). NEON has no
+ * 64-bit lane multiply and ACLE no non-temporal store: keys are hashed one
+ * at a time and lines written with regular stores. */
+#include "variants/templates/partition.h"
+
+/* Jump and rendezvous hashing (see variants/templates/consistent.h) */
+#include "variants/templates/consistent.h"
+
+/* Per-block checksums (see variants/templates/blocks.h) */
+#include "variants/templates/blocks.h"
@@ -0,0 +1,77 @@
+/* NEON kernels shared by the NEON and SVE variants. The hex and Bloom
+ * templates work on fixed 16- and 32-byte blocks, where SVE has nothing to
+ * add over NEON, which is always present with it. Each TU binds them to
+ * its template hooks.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) and <arm_neon.h>.
+ */
+#ifndef XXH3_VARIANTS_ARM_NEON_HOOKS_H
+#define XXH3_VARIANTS_ARM_NEON_HOOKS_H
+
+/* Batch canonical and hex encoding (see variants/templates/hex.h): VREV64,
+ * TBL digit lookups and interleaving VST2/VLD2 */
+XXH_FORCE_INLINE void xxh3_hex_bswap_neon(xxh_u8* dst, const xxh_u8* src)
+{
+    vst1q_u8(dst, vrev64q_u8(vld1q_u8(src)));
+}
+
+XXH_FORCE_INLINE void xxh3_hex_encode_neon(xxh_u8* dst, const xxh_u8* src)
+{
+    static const xxh_u8 digits[16] = { '0', '1', '2', '3', '4', '5', '6', '7',
+                                       '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+    uint8x16_t const table = vld1q_u8(digits);
+    uint8x16_t const v     = vld1q_u8(src);
+    uint8x16x2_t text;
+    text.val[0] = vqtbl1q_u8(table, vshrq_n_u8(v, 4));
+    text.val[1] = vqtbl1q_u8(table, vandq_u8(v, vdupq_n_u8(0x0F)));
+    vst2q_u8(dst, text);
+}
+
+/* Hex digits to nibbles, clearing the lanes of *ok that hold anything else */
+XXH_FORCE_INLINE uint8x16_t xxh3_hex_nibbles_neon(uint8x16_t c, uint8x16_t* ok)
+{
+    uint8x16_t const d     = vsubq_u8(c, vdupq_n_u8('0'));
+    uint8x16_t const l     = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    uint8x16_t const dec   = vcltq_u8(d, vdupq_n_u8(10));
+    uint8x16_t const alpha = vcltq_u8(l, vdupq_n_u8(6));
+    *ok = vandq_u8(*ok, vorrq_u8(dec, alpha));
+    return vbslq_u8(dec, d, vaddq_u8(l, vdupq_n_u8(10)));
+}
+
+XXH_FORCE_INLINE int xxh3_hex_decode_neon(xxh_u8* dst, const xxh_u8* src)
+{
+    uint8x16x2_t const text = vld2q_u8(src);
+    uint8x16_t ok = vdupq_n_u8(0xFF);
+    uint8x16_t const hi = xxh3_hex_nibbles_neon(text.val[0], &ok);
+    uint8x16_t const lo = xxh3_hex_nibbles_neon(text.val[1], &ok);
+    vst1q_u8(dst, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+    return vminvq_u8(ok) == 0xFF;
+}
+
+/* Blocked Bloom filter (see variants/templates/bloom.h): the block as two
+ * q registers, the bit indexes with VMUL and the bits with USHL */
+XXH_FORCE_INLINE uint32x4_t xxh3_bloom_mask_neon(xxh_u32 key, const xxh_u32* salt)
+{
+    uint32x4_t const b = vshrq_n_u32(vmulq_u32(vdupq_n_u32(key), vld1q_u32(salt)), 27);
+    return vshlq_u32(vdupq_n_u32(1), vreinterpretq_s32_u32(b));
+}
+
+XXH_FORCE_INLINE void xxh3_bloom_set_neon(xxh_u8* block, xxh_u32 key, const xxh_u32* salt)
+{
+    uint32x4_t const lo = vorrq_u32(vreinterpretq_u32_u8(vld1q_u8(block)), xxh3_bloom_mask_neon(key, salt));
+    uint32x4_t const hi = vorrq_u32(vreinterpretq_u32_u8(vld1q_u8(block + 16)),
+                                    xxh3_bloom_mask_neon(key, salt + 4));
+    vst1q_u8(block, vreinterpretq_u8_u32(lo));
+    vst1q_u8(block + 16, vreinterpretq_u8_u32(hi));
+}
+
+XXH_FORCE_INLINE int xxh3_bloom_test_neon(const xxh_u8* block, xxh_u32 key, const xxh_u32* salt)
+{
+    /* bits of the key that are clear in the block */
+    uint32x4_t const lo = vbicq_u32(xxh3_bloom_mask_neon(key, salt), vreinterpretq_u32_u8(vld1q_u8(block)));
+    uint32x4_t const hi = vbicq_u32(xxh3_bloom_mask_neon(key, salt + 4),
+                                    vreinterpretq_u32_u8(vld1q_u8(block + 16)));
+    return vmaxvq_u32(vorrq_u32(lo, hi)) == 0;
+}
+
+#endif /* XXH3_VARIANTS_ARM_NEON_HOOKS_H */
@@ -5,8 +5,107 @@
 #include "xxhash.h"
 
 #include "xxh3_converters.h"
+#include "xxh3_state_internal.h"
+#include "xxh3_hll_internal.h"
+#include "xxh3_mphf_internal.h"
+#include "xxh3_partition_internal.h"
+#include "xxh3_consistent_internal.h"
+#include "xxh3_blocks_internal.h"
 #include "common/internal_utils.h"
 
+/* ============================================
+   17-240 byte inputs
+   ============================================
+
+   The vendor 17-128 and 129-240 paths are sums of mix16B() products, one
+   64x64->128 multiply per 16-byte block. SVE has vector MUL and UMULH on
+   64-bit lanes, so each product is two instructions per vector. Blocks are
+   loaded with LD2 (de-interleaving the low/high words of each block) under a
+   WHILELT predicate, so the loops are vector-length agnostic and never read
+   past the input. The back blocks of the 17-128 path run in reverse memory
+   order and are fetched with a gather. Like the vendor SVE code this assumes
+   a little-endian target. */
+
+XXH_FORCE_INLINE svuint64_t
+xxh3_mix16B_sve(svbool_t pg, svuint64_t in_lo, svuint64_t in_hi,
+                svuint64_t sec_lo, svuint64_t sec_hi, svuint64_t seed)
+{
+    svuint64_t const a = sveor_u64_x(pg, in_lo, svadd_u64_x(pg, sec_lo, seed));
+    svuint64_t const b = sveor_u64_x(pg, in_hi, svsub_u64_x(pg, sec_hi, seed));
+    return sveor_u64_x(pg, svmul_u64_x(pg, a, b), svmulh_u64_x(pg, a, b));
+}
+
+static XXH64_hash_t
+xxh3_len_17to128_64b_sve(const xxh_u8* input, size_t len, XXH64_hash_t seed)
+{
+    const uint64_t* const xinput  = (const uint64_t*)(const void*)input;
+    const uint64_t* const xsecret = (const uint64_t*)(const void*)XXH3_kSecret;
+    uint64_t const rounds = (uint64_t)(len - 1) / 32 + 1;   /* 1..4 */
+    svuint64_t const vseed = svdup_n_u64(seed);
+    svuint64_t sum = svdup_n_u64(0);
+    uint64_t i;
+
+    for (i = 0; i < rounds; i += svcntd()) {
+        svbool_t const pg = svwhilelt_b64_u64(i, rounds);
+        /* secret + 32*i: {front lo, front hi, back lo, back hi} per round */
+        svuint64x4_t const sec   = svld4_u64(pg, xsecret + 4 * i);
+        svuint64x2_t const front = svld2_u64(pg, xinput + 2 * i);
+        /* round r reads its back block at input + len - 16*(r+1) */
+        svint64_t const off = svindex_s64((int64_t)(len - 16 - 16 * i), -16);
+        svuint64_t const back_lo = svld1_gather_s64offset_u64(pg, xinput, off);
+        svuint64_t const back_hi = svld1_gather_s64offset_u64(pg, xinput + 1, off);
+        sum = svadd_u64_m(pg, sum, xxh3_mix16B_sve(pg, svget2_u64(front, 0), svget2_u64(front, 1),
+                                                   svget4_u64(sec, 0), svget4_u64(sec, 1), vseed));
+        sum = svadd_u64_m(pg, sum, xxh3_mix16B_sve(pg, back_lo, back_hi,
+                                                   svget4_u64(sec, 2), svget4_u64(sec, 3), vseed));
+    }
+    return XXH3_avalanche(len * XXH_PRIME64_1 + svaddv_u64(svptrue_b64(), sum));
+}
+
+/* Sum of mix16B() over `count` consecutive blocks of input and secret */
+XXH_FORCE_INLINE xxh_u64
+xxh3_mix16B_sum_sve(const xxh_u8* input, const xxh_u8* secret, uint64_t count, svuint64_t vseed)
+{
+    const uint64_t* const xinput  = (const uint64_t*)(const void*)input;
+    const uint64_t* const xsecret = (const uint64_t*)(const void*)secret;
+    svuint64_t sum = svdup_n_u64(0);
+    uint64_t i;
+
+    for (i = 0; i < count; i += svcntd()) {
+        svbool_t const pg = svwhilelt_b64_u64(i, count);
+        svuint64x2_t const in  = svld2_u64(pg, xinput + 2 * i);
+        svuint64x2_t const sec = svld2_u64(pg, xsecret + 2 * i);
+        sum = svadd_u64_m(pg, sum, xxh3_mix16B_sve(pg, svget2_u64(in, 0), svget2_u64(in, 1),
+                                                   svget2_u64(sec, 0), svget2_u64(sec, 1), vseed));
+    }
+    return svaddv_u64(svptrue_b64(), sum);
+}
+
+static XXH64_hash_t
+xxh3_len_129to240_64b_sve(const xxh_u8* input, size_t len, XXH64_hash_t seed)
+{
+    const xxh_u8* const secret = XXH3_kSecret;
+    uint64_t const rounds = (uint64_t)len / 16;             /* 8..15 */
+    svuint64_t const vseed = svdup_n_u64(seed);
+    xxh_u64 const acc = XXH3_avalanche(len * XXH_PRIME64_1
+                                       + xxh3_mix16B_sum_sve(input, secret, 8, vseed));
+    xxh_u64 const acc_end =
+          xxh3_mix16B_sum_sve(input + 128, secret + XXH3_MIDSIZE_STARTOFFSET, rounds - 8, vseed)
+        + XXH3_mix16B(input + len - 16, secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET, seed);
+    return XXH3_avalanche(acc + acc_end);
+}
+
+XXH_FORCE_INLINE XXH64_hash_t xxh3_64_sve_internal(const void* input, size_t size, uint64_t seed)
+{
+    if (size > 16 && size <= 128) {
+        return xxh3_len_17to128_64b_sve((const xxh_u8*)input, size, seed);
+    }
+    if (size > 128 && size <= XXH3_MIDSIZE_MAX) {
+        return xxh3_len_129to240_64b_sve((const xxh_u8*)input, size, seed);
+    }
+    return XXH3_64bits_withSeed(input, size, seed);
+}
+
 uint64_t xxh3_64_sve(const void* input, size_t size, uint64_t seed)
 {
     XXH3_WRAPPER_GUARD({
@@ -14,7 +113,7 @@ uint64_t xxh3_64_sve(const void* input, size_t size, uint64_t seed)
             return 0;
         }
     });
-    return XXH3_64bits_withSeed(input, size, seed);
+    return xxh3_64_sve_internal(input, size, seed);
 }
 
 xxh3_128_t xxh3_128_sve(const void* input, size_t size, uint64_t seed)
@@ -35,7 +134,7 @@ uint64_t xxh3_64_sve_unseeded(const void* input, size_t size)
             return 0;
         }
     });
-    return XXH3_64bits_withSeed(input, size, 0);
+    return xxh3_64_sve_internal(input, size, 0);
 }
 
 xxh3_128_t xxh3_128_sve_unseeded(const void* input, size_t size)
@@ -47,3 +146,230 @@ xxh3_128_t xxh3_128_sve_unseeded(const void* input, size_t size)
     });
     return xxh128_to_xxh3(XXH3_128bits_withSeed(input, size, 0));
 }
+
+/* Non-temporal long-input kernels: xxh3_64_nt_sve(), xxh3_128_nt_sve() */
+#define XXH3_VARIANT sve
+#include "variants/templates/nt.h"
+
+/* ============================================
+   Multi-seed XXH3-64 (see variants/templates/multiseed.h)
+   ============================================
+
+   One seed per 64-bit lane, svcntd() seeds per call; the block words are
+   broadcast. Products use the same MUL/UMULH pair as the short-input path. */
+
+XXH_FORCE_INLINE svuint64_t xxh3_avalanche_sve(svbool_t pg, svuint64_t h)
+{
+    h = sveor_u64_x(pg, h, svlsr_n_u64_x(pg, h, 37));
+    h = svmul_n_u64_x(pg, h, 0x165667919E3779F9ULL);
+    return sveor_u64_x(pg, h, svlsr_n_u64_x(pg, h, 32));
+}
+
+XXH_FORCE_INLINE svuint64_t xxh3_ms_mix_sve(svbool_t pg, const xxh_u64* b, svuint64_t seed)
+{
+    return xxh3_mix16B_sve(pg, svdup_n_u64(b[0]), svdup_n_u64(b[1]),
+                           svdup_n_u64(b[2]), svdup_n_u64(b[3]), seed);
+}
+
+static void xxh3_ms_9to16_sve(xxh_u64* out, const xxh_u64* seeds, size_t len, const xxh_u64 blk[4])
+{
+    svbool_t const pg = svptrue_b64();
+    svuint64_t const seed = svld1_u64(pg, seeds);
+    svuint64_t const lo = sveor_u64_x(pg, svdup_n_u64(blk[0]), svadd_n_u64_x(pg, seed, blk[2]));
+    svuint64_t const hi = sveor_u64_x(pg, svdup_n_u64(blk[1]), svsubr_n_u64_x(pg, seed, blk[3]));
+    svuint64_t acc = svadd_n_u64_x(pg, svrevb_u64_x(pg, lo), (xxh_u64)len);
+    acc = svadd_u64_x(pg, acc, svadd_u64_x(pg, hi,
+              sveor_u64_x(pg, svmul_u64_x(pg, lo, hi), svmulh_u64_x(pg, lo, hi))));
+    svst1_u64(pg, out, xxh3_avalanche_sve(pg, acc));
+}
+
+static void xxh3_ms_17to240_sve(xxh_u64* out, const xxh_u64* seeds, size_t len,
+                                const xxh_u64 (*blk)[4], size_t nbFirst, size_t nbBlocks)
+{
+    svbool_t const pg = svptrue_b64();
+    svuint64_t const seed = svld1_u64(pg, seeds);
+    svuint64_t acc = svdup_n_u64(len * XXH_PRIME64_1);
+    size_t i;
+
+    for (i = 0; i < nbFirst; i++) {
+        acc = svadd_u64_x(pg, acc, xxh3_ms_mix_sve(pg, blk[i], seed));
+    }
+    if (nbFirst < nbBlocks) {
+        svuint64_t acc_end = svdup_n_u64(0);
+        for (; i < nbBlocks; i++) {
+            acc_end = svadd_u64_x(pg, acc_end, xxh3_ms_mix_sve(pg, blk[i], seed));
+        }
+        acc = svadd_u64_x(pg, xxh3_avalanche_sve(pg, acc), acc_end);
+    }
+    svst1_u64(pg, out, xxh3_avalanche_sve(pg, acc));
+}
+
+#define XXH3_MS_LANES         svcntd()
+#define XXH3_MS_9TO16_LANES   xxh3_ms_9to16_sve
+#define XXH3_MS_17TO240_LANES xxh3_ms_17to240_sve
+#include "variants/templates/multiseed.h"
+
+/* Lockstep update of many streams (see variants/templates/multistream.h) */
+#include "variants/templates/multistream.h"
+
+/* Fused copy-and-hash (see variants/templates/copy.h): STNT1 for the _nt forms */
+XXH_FORCE_INLINE void xxh3_copy_nt_line_sve(xxh_u8* dst, const xxh_u8* src)
+{
+    uint64_t i;
+    for (i = 0; i < 64; i += svcntb()) {
+        svbool_t const pg = svwhilelt_b8_u64(i, 64);
+        svstnt1_u8(pg, dst + i, svld1_u8(pg, src + i));
+    }
+}
+#define XXH3_COPY_NT_LINE(dst, src) xxh3_copy_nt_line_sve((dst), (src))
+#include "variants/templates/copy.h"
+
+/* C-string hashing (see variants/templates/cstr.h): predicated loads start
+ * at `from`, BRKB counts the bytes before the first NUL */
+static XXH3_NO_SANITIZE_ADDRESS size_t xxh3_cstr_line_nul_sve(const xxh_u8* line, size_t from)
+{
+    size_t i;
+    for (i = from; i < 64; i += svcntb()) {
+        svbool_t const pg = svwhilelt_b8_u64((uint64_t)i, 64);
+        svbool_t const eq = svcmpeq_n_u8(pg, svld1_u8(pg, line + i), 0);
+        if (svptest_any(pg, eq)) {
+            return i + (size_t)svcntp_b8(pg, svbrkb_z(pg, eq));
+        }
+    }
+    return 64;
+}
+#define XXH3_CSTR_LINE_NUL(line, from) xxh3_cstr_line_nul_sve((line), (from))
+#include "variants/templates/cstr.h"
+
+/* Case-insensitive XXH3-64 (see variants/templates/ci.h): a predicated OR
+ * on the lanes holding 'A'..'Z'; the stripe kernel is ACCRND over
+ * min(svcntd(), 8) lanes at a time */
+XXH_FORCE_INLINE svuint8_t xxh3_ci_fold_sve(svbool_t pg, svuint8_t v)
+{
+    svbool_t const upper = svcmplt_n_u8(pg, svsub_n_u8_x(pg, v, 'A'), 26);
+    return svorr_n_u8_m(upper, v, 0x20);
+}
+
+XXH_FORCE_INLINE void xxh3_ci_fold_line_sve(xxh_u8* dst, const xxh_u8* src)
+{
+    uint64_t i;
+    for (i = 0; i < XXH_STRIPE_LEN; i += svcntb()) {
+        svbool_t const pg = svwhilelt_b8_u64(i, XXH_STRIPE_LEN);
+        svst1_u8(pg, dst + i, xxh3_ci_fold_sve(pg, svld1_u8(pg, src + i)));
+    }
+}
+
+XXH_FORCE_INLINE void xxh3_ci_accumulate_512_sve(xxh_u64* XXH_RESTRICT acc, const xxh_u8* XXH_RESTRICT input,
+                                                 const xxh_u8* XXH_RESTRICT secret)
+{
+    svuint64_t const kSwap = sveor_n_u64_z(svptrue_b64(), svindex_u64(0, 1), 1);
+    uint64_t i;
+    for (i = 0; i < XXH_ACC_NB; i += svcntd()) {
+        svbool_t const mask   = svwhilelt_b64_u64(i, XXH_ACC_NB);
+        svbool_t const pg8    = svwhilelt_b8_u64(8 * i, XXH_STRIPE_LEN);
+        svuint64_t const data = svreinterpret_u64_u8(xxh3_ci_fold_sve(pg8, svld1_u8(pg8, input + 8 * i)));
+        svuint64_t const key  = svld1_u64(mask, (const uint64_t*)(const void*)secret + i);
+        svuint64_t const mixed = sveor_u64_x(mask, data, key);
+        svuint64_t const mul   = svmad_u64_x(mask, svextw_u64_x(mask, mixed), svlsr_n_u64_x(mask, mixed, 32),
+                                             svtbl_u64(data, kSwap));
+        svst1_u64(mask, acc + i, svadd_u64_x(mask, svld1_u64(mask, acc + i), mul));
+    }
+}
+#define XXH3_CI_FOLD_LINE(dst, src)             xxh3_ci_fold_line_sve((dst), (src))
+#define XXH3_CI_ACCUMULATE_512(acc, in, secret) xxh3_ci_accumulate_512_sve((acc), (in), (secret))
+#include "variants/templates/ci.h"
+
+/* Strided 2D and field-gather hashing (see variants/templates/gather.h) */
+#include "variants/templates/gather.h"
+
+/* Batch canonical and hex encoding (see variants/templates/hex.h) with the
+ * NEON kernels of variants/arm/neon_hooks.h: blocks are 16 bytes */
+#include "variants/arm/neon_hooks.h"
+#define XXH3_HEX_BSWAP(dst, src) xxh3_hex_bswap_neon((dst), (src))
+#define XXH3_HEX_ENCODE(dst, src) xxh3_hex_encode_neon((dst), (src))
+#define XXH3_HEX_DECODE(dst, src) xxh3_hex_decode_neon((dst), (src))
+#include "variants/templates/hex.h"
+
+/* Blocked Bloom filter (see variants/templates/bloom.h) with the NEON
+ * kernels of variants/arm/neon_hooks.h: a block is 32 bytes */
+#define XXH3_BLOOM_SET(block, key, salt) xxh3_bloom_set_neon((block), (key), (salt))
+#define XXH3_BLOOM_TEST(block, key, salt) xxh3_bloom_test_neon((block), (key), (salt))
+#include "variants/templates/bloom.h"
+
+/* HyperLogLog sketches (see variants/templates/hll.h). NEON counts leading
+ * zeros in 32-bit lanes only: the ranks of 8 hashes come from the upper
+ * halves of the shifted hashes, and the rare group where one of those is 0
+ * is ranked in scalar code. The register maximum is UMAX */
+XXH_FORCE_INLINE void xxh3_hll_rank8_sve(xxh_u8* ranks, const xxh_u64* hashes, unsigned p)
+{
+    int64x2_t const  count = vdupq_n_s64((int64_t)p);
+    uint64x2_t const guard = vdupq_n_u64((xxh_u64)1 << (p - 1));
+    uint32x4_t hi[2];
+    size_t j;
+
+    for (j = 0; j < 2; j++) {
+        uint64x2_t const a = vorrq_u64(vshlq_u64(vld1q_u64(hashes + 4 * j), count), guard);
+        uint64x2_t const b = vorrq_u64(vshlq_u64(vld1q_u64(hashes + 4 * j + 2), count), guard);
+        hi[j] = vcombine_u32(vshrn_n_u64(a, 32), vshrn_n_u64(b, 32));
+    }
+    if (vminvq_u32(vminq_u32(hi[0], hi[1])) == 0) {
+        for (j = 0; j < 8; j++) {
+            ranks[j] = (xxh_u8)xxh3_hll_rank(hashes[j], p);
+        }
+        return;
+    }
+    {   uint32x4_t const one = vdupq_n_u32(1);
+        uint16x8_t const r   = vcombine_u16(vmovn_u32(vaddq_u32(vclzq_u32(hi[0]), one)),
+                                            vmovn_u32(vaddq_u32(vclzq_u32(hi[1]), one)));
+        vst1_u8(ranks, vmovn_u16(r));
+    }
+}
+
+XXH_FORCE_INLINE void xxh3_hll_max_sve(xxh_u8* dst, const xxh_u8* src, size_t n)
+{
+    size_t i;
+    for (i = 0; i < n; i += 16) {
+        vst1q_u8(dst + i, vmaxq_u8(vld1q_u8(dst + i), vld1q_u8(src + i)));
+    }
+}
+#define XXH3_HLL_RANK8(ranks, hashes, p) xxh3_hll_rank8_sve((ranks), (hashes), (p))
+#define XXH3_HLL_MAX(dst, src, n) xxh3_hll_max_sve((dst), (src), (n))
+#include "variants/templates/hll.h"
+
+/* Multiset hashes (see variants/templates/multiset.h) */
+#include "variants/templates/multiset.h"
+
+/* Minimal perfect hash functions (see variants/templates/mphf.h) */
+#include "variants/templates/mphf.h"
+
+/* Hash partitioning (see variants/templates/partition.h): STNT1 lines, and
+ * 8-byte keys hashed svcntd() at a time with 64-bit MUL */
+XXH_FORCE_INLINE svuint64_t xxh3_partition_rotl_sve(svbool_t pg, svuint64_t h, unsigned r)
+{
+    return svorr_u64_x(pg, svlsl_n_u64_x(pg, h, r), svlsr_n_u64_x(pg, h, 64 - r));
+}
+
+XXH_FORCE_INLINE void xxh3_partition_hash8_sve(xxh_u64* out, const xxh_u8* keys, xxh_u64 bitflip)
+{
+    uint64_t i;
+    for (i = 0; i < 8; i += svcntd()) {
+        svbool_t const pg = svwhilelt_b64_u64(i, 8);
+        svuint64_t h = svreinterpret_u64_u8(svld1_u8(svwhilelt_b8_u64(8 * i, 64), keys + 8 * i));
+        h = sveor_n_u64_x(pg, xxh3_partition_rotl_sve(pg, h, 32), bitflip);
+        h = sveor_u64_x(pg, h, sveor_u64_x(pg, xxh3_partition_rotl_sve(pg, h, 49),
+                                           xxh3_partition_rotl_sve(pg, h, 24)));
+        h = svmul_n_u64_x(pg, h, PRIME_MX2);
+        h = sveor_u64_x(pg, h, svadd_n_u64_x(pg, svlsr_n_u64_x(pg, h, 35), 8));
+        h = svmul_n_u64_x(pg, h, PRIME_MX2);
+        svst1_u64(pg, out + i, sveor_u64_x(pg, h, svlsr_n_u64_x(pg, h, 28)));
+    }
+}
+#define XXH3_PARTITION_NT_LINE(dst, src)     xxh3_copy_nt_line_sve((dst), (src))
+#define XXH3_PARTITION_HASH8(out, keys, bitflip) xxh3_partition_hash8_sve((out), (keys), (bitflip))
+#include "variants/templates/partition.h"
+
+/* Jump and rendezvous hashing (see variants/templates/consistent.h) */
+#include "variants/templates/consistent.h"
+
+/* Per-block checksums (see variants/templates/blocks.h) */
+#include "variants/templates/blocks.h"
@@ -5,6 +5,13 @@
 #include "xxhash.h"
 
 #include "xxh3_converters.h"
+#include "xxh3_state_internal.h"
+#include "xxh3_hll_internal.h"
+#include "xxh3_mphf_internal.h"
+#include "xxh3_partition_internal.h"
+#include "xxh3_consistent_internal.h"
+#include "xxh3_blocks_internal.h"
+#include "xxh3_xxh32_internal.h"
 #include "common/internal_utils.h"
 
 uint64_t xxh3_64_scalar(const void* input, size_t size, uint64_t seed)
@@ -47,3 +54,161 @@ xxh3_128_t xxh3_128_scalar_unseeded(const void* input, size_t size)
     });
     return xxh128_to_xxh3(XXH3_128bits_withSeed(input, size, 0));
 }
+
+/* Non-temporal long-input kernels: xxh3_64_nt_scalar(), xxh3_128_nt_scalar() */
+#define XXH3_VARIANT scalar
+#include "variants/templates/nt.h"
+
+/* Multi-buffer XXH64 / XXH32 reference: one message at a time */
+void xxh64_batch_scalar(const void* const* inputs, const size_t* sizes, size_t count,
+                        uint64_t seed, uint64_t* out)
+{
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (count > 0 && (inputs == NULL || sizes == NULL || out == NULL)) {
+            return;
+        }
+    });
+    for (i = 0; i < count; i++) {
+        out[i] = XXH64(inputs[i], sizes[i], seed);
+    }
+}
+
+void xxh32_batch_scalar(const void* const* inputs, const size_t* sizes, size_t count,
+                        uint32_t seed, uint32_t* out)
+{
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (count > 0 && (inputs == NULL || sizes == NULL || out == NULL)) {
+            return;
+        }
+    });
+    for (i = 0; i < count; i++) {
+        out[i] = XXH32(inputs[i], sizes[i], seed);
+    }
+}
+
+/* XXH32 streaming on the wrapper's state (see src/xxh3_xxh32_internal.h) */
+static void xxh32_stripes_scalar(xxh_u32 v[4], const xxh_u8* p, size_t nbStripes)
+{
+    size_t n;
+
+    for (n = 0; n < nbStripes; n++, p += 16) {
+        v[0] = XXH32_round(v[0], XXH_readLE32(p));
+        v[1] = XXH32_round(v[1], XXH_readLE32(p + 4));
+        v[2] = XXH32_round(v[2], XXH_readLE32(p + 8));
+        v[3] = XXH32_round(v[3], XXH_readLE32(p + 12));
+    }
+}
+
+void xxh32_reset(xxh3_state_t* state, uint32_t seed)
+{
+    xxh32_stream_t* const s = xxh3_xxh32Stream(state);
+
+    XXH3_WRAPPER_GUARD({
+        if (s == NULL) {
+            return;
+        }
+    });
+    xxh32_stream_reset(s, seed);
+}
+
+int xxh32_update(xxh3_state_t* state, const void* input, size_t size)
+{
+    xxh32_stream_t* const s = xxh3_xxh32Stream(state);
+
+    XXH3_WRAPPER_GUARD({
+        if (s == NULL) {
+            return XXH3_ERROR;
+        }
+    });
+    if (input == NULL) {
+        return XXH3_OK;
+    }
+    xxh32_stream_update(s, (const xxh_u8*)input, size, xxh32_stripes_scalar);
+    return XXH3_OK;
+}
+
+uint32_t xxh32_digest(xxh3_state_t* state)
+{
+    xxh32_stream_t* const s = xxh3_xxh32Stream(state);
+
+    XXH3_WRAPPER_GUARD({
+        if (s == NULL) {
+            return 0;
+        }
+    });
+    return xxh32_stream_digest(s);
+}
+
+/* Multi-seed XXH3-64, scalar per-seed path (see variants/templates/multiseed.h) */
+#include "variants/templates/multiseed.h"
+
+/* Lockstep update of many streams (see variants/templates/multistream.h) */
+#include "variants/templates/multistream.h"
+
+/* Fused copy-and-hash (see variants/templates/copy.h); the _nt forms use
+ * regular stores */
+#include "variants/templates/copy.h"
+
+/* C-string hashing (see variants/templates/cstr.h): a word at a time, where
+ * ~(((v & 0x7F..) + 0x7F..) | v | 0x7F..) sets the top bit of each zero byte
+ * (exactly; the carry-based v - 0x01.. test can flag a byte above a zero) */
+static XXH3_NO_SANITIZE_ADDRESS size_t xxh3_cstr_line_nul_scalar(const xxh_u8* line, size_t from)
+{
+    xxh_u64 const low7 = 0x7F7F7F7F7F7F7F7FULL;
+    size_t w;
+
+    for (w = from / 8; w < 8; w++) {
+        xxh_u64 v, z;
+        memcpy(&v, line + 8 * w, sizeof(v));
+        if (!XXH_CPU_LITTLE_ENDIAN) {
+            v = XXH_swap64(v);
+        }
+        z = ~(((v & low7) + low7) | v | low7);
+        if (w == from / 8) {
+            z &= ~(xxh_u64)0 << (8 * (from % 8));
+        }
+        if (z != 0) {
+            return 8 * w + xxh3_ctz64(z) / 8;
+        }
+    }
+    return 64;
+}
+#define XXH3_CSTR_LINE_NUL(line, from) xxh3_cstr_line_nul_scalar((line), (from))
+#include "variants/templates/cstr.h"
+
+/* Case-insensitive XXH3-64 (see variants/templates/ci.h): SWAR fold and the
+ * scalar round */
+#include "variants/templates/ci.h"
+
+/* Strided 2D and field-gather hashing (see variants/templates/gather.h) */
+#include "variants/templates/gather.h"
+
+/* Batch canonical and hex encoding (see variants/templates/hex.h): scalar
+ * byte swaps and a digit table */
+#include "variants/templates/hex.h"
+
+/* Blocked Bloom filter (see variants/templates/bloom.h): scalar bit tests */
+#include "variants/templates/bloom.h"
+
+/* HyperLogLog sketches (see variants/templates/hll.h): scalar ranks and
+ * register maximum */
+#include "variants/templates/hll.h"
+
+/* Multiset hashes (see variants/templates/multiset.h) */
+#include "variants/templates/multiset.h"
+
+/* Minimal perfect hash functions (see variants/templates/mphf.h) */
+#include "variants/templates/mphf.h"
+
+/* Hash partitioning (see variants/templates/partition.h) */
+#include "variants/templates/partition.h"
+
+/* Jump and rendezvous hashing (see variants/templates/consistent.h) */
+#include "variants/templates/consistent.h"
+
+/* Per-block checksums (see variants/templates/blocks.h) */
+#include "variants/templates/blocks.h"
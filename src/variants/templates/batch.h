@@ -0,0 +1,158 @@
+/* Multi-buffer XXH32 / XXH64 driver.
+ *
+ * XXH32 and XXH64 run four independent accumulators over 16- / 32-byte
+ * stripes, and nothing is shared between messages. W messages can therefore
+ * be hashed side by side, with accumulator k of message i in lane i of
+ * vector k. This template holds the lane scheduler. The including variant TU
+ * supplies the SIMD stripe loop.
+ *
+ * As soon as a lane runs out of full stripes it is finished and refilled
+ * with the next message, so one long message does not hold up the rest.
+ * Messages shorter than one stripe, the partial tail and the final
+ * merge/avalanche use the vendor's scalar code, so results are bit-identical
+ * to xxh32() / xxh64().
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) with:
+ *   XXH_BATCH_FN       exported name, e.g. xxh64_batch_avx2
+ *   XXH_BATCH_BITS     32 or 64
+ *   XXH_BATCH_LANES    messages hashed side by side
+ *   XXH_BATCH_STRIPES  stripe loop:
+ *       void f(T acc[4][XXH_BATCH_LANES], const xxh_u8* in[XXH_BATCH_LANES],
+ *              const size_t step[XXH_BATCH_LANES], size_t nbStripes)
+ *     applies nbStripes rounds to every lane, advancing in[i] by step[i]
+ *     bytes per stripe (0 for idle lanes, which point at zeroes).
+ * The parameters are #undef'd at the end so a TU can instantiate both
+ * widths.
+ */
+
+#ifndef XXH3_VARIANTS_TEMPLATES_BATCH_H
+#define XXH3_VARIANTS_TEMPLATES_BATCH_H
+
+/* Read by idle lanes; one XXH64 stripe */
+static const xxh_u8 xxh_batch_zeroes[32] = { 0 };
+
+XXH_FORCE_INLINE xxh_u32 xxh_batch_finish32(const xxh_u32* v, const xxh_u8* tail, size_t len)
+{
+    xxh_u32 const h32 = XXH_rotl32(v[0], 1) + XXH_rotl32(v[1], 7)
+                      + XXH_rotl32(v[2], 12) + XXH_rotl32(v[3], 18);
+    return XXH32_finalize(h32 + (xxh_u32)len, tail, len & 15, XXH_unaligned);
+}
+
+XXH_FORCE_INLINE xxh_u64 xxh_batch_finish64(const xxh_u64* v, const xxh_u8* tail, size_t len)
+{
+    xxh_u64 h64 = XXH_rotl64(v[0], 1) + XXH_rotl64(v[1], 7)
+                + XXH_rotl64(v[2], 12) + XXH_rotl64(v[3], 18);
+    h64 = XXH64_mergeRound(h64, v[0]);
+    h64 = XXH64_mergeRound(h64, v[1]);
+    h64 = XXH64_mergeRound(h64, v[2]);
+    h64 = XXH64_mergeRound(h64, v[3]);
+    return XXH64_finalize(h64 + (xxh_u64)len, tail, len, XXH_unaligned);
+}
+
+#endif /* XXH3_VARIANTS_TEMPLATES_BATCH_H */
+
+#if XXH_BATCH_BITS == 64
+#  define XXH_BATCH_T          xxh_u64
+#  define XXH_BATCH_STRIPE     32
+#  define XXH_BATCH_P1         XXH_PRIME64_1
+#  define XXH_BATCH_P2         XXH_PRIME64_2
+#  define XXH_BATCH_SINGLE(p, n, s) XXH64((p), (n), (s))
+#  define XXH_BATCH_FINISH     xxh_batch_finish64
+#else
+#  define XXH_BATCH_T          xxh_u32
+#  define XXH_BATCH_STRIPE     16
+#  define XXH_BATCH_P1         XXH_PRIME32_1
+#  define XXH_BATCH_P2         XXH_PRIME32_2
+#  define XXH_BATCH_SINGLE(p, n, s) XXH32((p), (n), (s))
+#  define XXH_BATCH_FINISH     xxh_batch_finish32
+#endif
+
+void XXH_BATCH_FN(const void* const* inputs, const size_t* sizes, size_t count,
+                  XXH_BATCH_T seed, XXH_BATCH_T* out)
+{
+    XXH_ALIGN(64) XXH_BATCH_T acc[4][XXH_BATCH_LANES];
+    const xxh_u8* in[XXH_BATCH_LANES];
+    size_t step[XXH_BATCH_LANES];
+    size_t left[XXH_BATCH_LANES];   /* full stripes still to run */
+    size_t slot[XXH_BATCH_LANES];   /* message in the lane; `count` when idle */
+    size_t next = 0;
+    size_t busy = 0;
+    size_t lane;
+
+    XXH3_WRAPPER_GUARD({
+        if (count > 0 && (inputs == NULL || sizes == NULL || out == NULL)) {
+            return;
+        }
+    });
+    for (lane = 0; lane < XXH_BATCH_LANES; lane++) {
+        in[lane] = xxh_batch_zeroes;
+        step[lane] = 0;
+        left[lane] = 0;
+        slot[lane] = count;
+    }
+
+    for (;;) {
+        size_t n = (size_t)-1;
+
+        /* refill idle lanes; short messages are finished on the way */
+        for (lane = 0; lane < XXH_BATCH_LANES; lane++) {
+            if (slot[lane] != count) {
+                continue;
+            }
+            while (next < count && sizes[next] < XXH_BATCH_STRIPE) {
+                out[next] = XXH_BATCH_SINGLE(inputs[next], sizes[next], seed);
+                next++;
+            }
+            if (next == count) {
+                break;
+            }
+            acc[0][lane] = seed + XXH_BATCH_P1 + XXH_BATCH_P2;
+            acc[1][lane] = seed + XXH_BATCH_P2;
+            acc[2][lane] = seed + 0;
+            acc[3][lane] = seed - XXH_BATCH_P1;
+            in[lane] = (const xxh_u8*)inputs[next];
+            step[lane] = XXH_BATCH_STRIPE;
+            left[lane] = sizes[next] / XXH_BATCH_STRIPE;
+            slot[lane] = next++;
+            busy++;
+        }
+        if (busy == 0) {
+            return;
+        }
+
+        for (lane = 0; lane < XXH_BATCH_LANES; lane++) {
+            if (slot[lane] != count && left[lane] < n) {
+                n = left[lane];
+            }
+        }
+        XXH_BATCH_STRIPES(acc, in, step, n);
+
+        for (lane = 0; lane < XXH_BATCH_LANES; lane++) {
+            if (slot[lane] == count || (left[lane] -= n) != 0) {
+                continue;
+            }
+            {   XXH_BATCH_T v[4];
+                v[0] = acc[0][lane];
+                v[1] = acc[1][lane];
+                v[2] = acc[2][lane];
+                v[3] = acc[3][lane];
+                out[slot[lane]] = XXH_BATCH_FINISH(v, in[lane], sizes[slot[lane]]);
+            }
+            in[lane] = xxh_batch_zeroes;
+            step[lane] = 0;
+            slot[lane] = count;
+            busy--;
+        }
+    }
+}
+
+#undef XXH_BATCH_T
+#undef XXH_BATCH_STRIPE
+#undef XXH_BATCH_P1
+#undef XXH_BATCH_P2
+#undef XXH_BATCH_SINGLE
+#undef XXH_BATCH_FINISH
+#undef XXH_BATCH_FN
+#undef XXH_BATCH_BITS
+#undef XXH_BATCH_LANES
+#undef XXH_BATCH_STRIPES
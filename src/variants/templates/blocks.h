@@ -0,0 +1,100 @@
+/* Per-block XXH3-64 checksums of a contiguous buffer.
+ *
+ * Hashing an extent page by page with xxh3_64_<variant>() pays, per page,
+ * the call and length dispatch and, under a nonzero seed, the derivation
+ * of a 192-byte secret from the seed. Here the secret is derived once per
+ * range, and blocks above XXH3_MIDSIZE_MAX bytes go straight to the
+ * vendor's long-input loop with the variant's accumulate and scramble
+ * steps. Blocks of at most XXH3_MIDSIZE_MAX bytes, and a short last block,
+ * take the regular path. Results are bit-identical to xxh3_64_<variant>()
+ * on each block.
+ *
+ * Hashing two blocks at a time, with their stripes alternating and their
+ * finalizations independent, measured no faster on AVX2 and slower on
+ * scalar, SSE2 and AVX-512: the out-of-order core already overlaps one
+ * block's finalization with the next block's stripes.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) and xxh3_blocks_internal.h, with
+ * XXH3_VARIANT defined. Emits `xxh3_64_blocks_<variant>`,
+ * `xxh3_64_blocks_mt_<variant>` and `xxh3_64_blocks_verify_<variant>`.
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_BLOCKS_H
+#define XXH3_VARIANTS_TEMPLATES_BLOCKS_H
+
+/* Stores or checks block i's hash h; returns 1 on a mismatch */
+XXH_FORCE_INLINE size_t xxh3_blocks_emit(size_t i, xxh_u64 h, uint64_t* out, const uint64_t* expected,
+                                         size_t* bad, size_t max_bad, size_t found)
+{
+    if (expected == NULL) {
+        out[i] = h;
+        return 0;
+    }
+    if (h == expected[i]) {
+        return 0;
+    }
+    if (found < max_bad) {
+        bad[found] = i;
+    }
+    return 1;
+}
+
+static size_t XXH3_VARIANT_FN(xxh3_blocks_range)(const unsigned char* buf, size_t len,
+                                                 size_t block_size, uint64_t seed, size_t begin,
+                                                 size_t end, uint64_t* out,
+                                                 const uint64_t* expected, size_t* bad,
+                                                 size_t max_bad)
+{
+    XXH_ALIGN(64) xxh_u8 custom[XXH_SECRET_DEFAULT_SIZE];
+    const xxh_u8* secret = XXH3_kSecret;
+    size_t const  whole  = len / block_size;
+    size_t        found  = 0;
+    size_t        i      = begin;
+    xxh_u64       h;
+
+    if (block_size > XXH3_MIDSIZE_MAX && seed != 0) {
+        XXH3_initCustomSecret(custom, seed);
+        secret = custom;
+    }
+    for (; i < end; i++) {
+        const xxh_u8* const block = buf + i * block_size;
+        size_t const        size  = (i < whole) ? block_size : len - i * block_size;
+        h = (size > XXH3_MIDSIZE_MAX)
+                ? XXH3_hashLong_64b_internal(block, size, secret, XXH_SECRET_DEFAULT_SIZE,
+                                             XXH3_accumulate, XXH3_scrambleAcc)
+                : XXH3_64bits_withSeed(block, size, seed);
+        found += xxh3_blocks_emit(i, h, out, expected, bad, max_bad, found);
+    }
+    return found;
+}
+
+int XXH3_VARIANT_FN(xxh3_64_blocks)(const void* buf, size_t len, size_t block_size, uint64_t seed,
+                                    uint64_t* out)
+{
+    if (block_size == 0 || ((buf == NULL || out == NULL) && len > 0)) {
+        return XXH3_ERROR;
+    }
+    (void)XXH3_VARIANT_FN(xxh3_blocks_range)((const unsigned char*)buf, len, block_size, seed, 0,
+                                             xxh3_blocks_count(len, block_size), out, NULL, NULL,
+                                             0);
+    return XXH3_OK;
+}
+
+int XXH3_VARIANT_FN(xxh3_64_blocks_mt)(const void* buf, size_t len, size_t block_size,
+                                       uint64_t seed, uint64_t* out, unsigned threads)
+{
+    return xxh3_blocks_with(buf, len, block_size, seed, out, NULL, NULL, 0, NULL, threads,
+                            XXH3_VARIANT_FN(xxh3_blocks_range));
+}
+
+int XXH3_VARIANT_FN(xxh3_64_blocks_verify)(const void* buf, size_t len, size_t block_size,
+                                           uint64_t seed, const uint64_t* expected, size_t* bad,
+                                           size_t max_bad, size_t* n_bad, unsigned threads)
+{
+    if (n_bad == NULL) {
+        return XXH3_ERROR;
+    }
+    return xxh3_blocks_with(buf, len, block_size, seed, NULL, expected, bad, max_bad, n_bad,
+                            threads, XXH3_VARIANT_FN(xxh3_blocks_range));
+}
+
+#endif /* XXH3_VARIANTS_TEMPLATES_BLOCKS_H */
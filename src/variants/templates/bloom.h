@@ -0,0 +1,156 @@
+/* Blocked Bloom filter: adding and testing keys.
+ *
+ * The filter is split into 32-byte blocks of eight little-endian 32-bit
+ * words (see src/xxh3_bloom.c for the image around them). A key is hashed
+ * once with xxh3_64_<variant>() under the filter's seed; the high half of
+ * the hash picks the block by multiply-shift, and the low half sets or tests
+ * one bit in each word, the bit index being the top five bits of
+ * low32 * xxh3_bloom_salt[word]. A key thus touches a single cache line.
+ * The batch forms hash a group of keys and prefetch all their blocks before
+ * touching any, so that the misses of a group overlap.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) with XXH3_VARIANT defined, and
+ * optionally
+ *   XXH3_BLOOM_SET(block, key, salt)   set the eight bits of the 32-bit
+ *                                      `key` in the block at `block`, with
+ *                                      `salt` the eight multipliers
+ *   XXH3_BLOOM_TEST(block, key, salt)  nonzero if all eight are set
+ * defined; the defaults are scalar. Emits `xxh3_bloom_add_<variant>`,
+ * `xxh3_bloom_contains_<variant>`, `xxh3_bloom_add_batch_<variant>` and
+ * `xxh3_bloom_contains_batch_<variant>`.
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_BLOOM_H
+#define XXH3_VARIANTS_TEMPLATES_BLOOM_H
+
+/* Keys hashed and prefetched ahead of their probes in the batch forms */
+#define XXH3_BLOOM_GROUP 16
+
+/* Odd multipliers of the split block Bloom filter of Apache Parquet */
+static const xxh_u32 xxh3_bloom_salt[8] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+/* Bit b of little-endian word i is bit b % 8 of byte 4 * i + b / 8 */
+XXH_FORCE_INLINE void xxh3_bloom_set(xxh_u8* block, xxh_u32 key, const xxh_u32* salt)
+{
+    size_t i;
+    for (i = 0; i < 8; i++) {
+        xxh_u32 const b = (key * salt[i]) >> 27;
+        block[4 * i + (b >> 3)] |= (xxh_u8)(1U << (b & 7));
+    }
+}
+
+XXH_FORCE_INLINE int xxh3_bloom_test(const xxh_u8* block, xxh_u32 key, const xxh_u32* salt)
+{
+    unsigned all = 1;
+    size_t i;
+    for (i = 0; i < 8; i++) {
+        xxh_u32 const b = (key * salt[i]) >> 27;
+        all &= (unsigned)(block[4 * i + (b >> 3)] >> (b & 7));
+    }
+    return (int)(all & 1);
+}
+
+#ifndef XXH3_BLOOM_SET
+#  define XXH3_BLOOM_SET(block, key, salt) xxh3_bloom_set((block), (key), (salt))
+#endif
+#ifndef XXH3_BLOOM_TEST
+#  define XXH3_BLOOM_TEST(block, key, salt) xxh3_bloom_test((block), (key), (salt))
+#endif
+
+XXH_FORCE_INLINE xxh_u8* xxh3_bloom_block(const xxh3_bloom_t* filter, xxh_u64 h)
+{
+    return filter->blocks + 32 * (size_t)(((h >> 32) * filter->nblocks) >> 32);
+}
+
+void XXH3_VARIANT_FN(xxh3_bloom_add)(xxh3_bloom_t* filter, const void* key, size_t size)
+{
+    xxh_u64 h;
+
+    XXH3_WRAPPER_GUARD({
+        if (filter == NULL || (key == NULL && size > 0)) {
+            return;
+        }
+    });
+    h = XXH3_64bits_withSeed(key, size, filter->seed);
+    XXH3_BLOOM_SET(xxh3_bloom_block(filter, h), (xxh_u32)h, xxh3_bloom_salt);
+}
+
+int XXH3_VARIANT_FN(xxh3_bloom_contains)(const xxh3_bloom_t* filter, const void* key, size_t size)
+{
+    xxh_u64 h;
+
+    XXH3_WRAPPER_GUARD({
+        if (filter == NULL || (key == NULL && size > 0)) {
+            return 0;
+        }
+    });
+    h = XXH3_64bits_withSeed(key, size, filter->seed);
+    return XXH3_BLOOM_TEST(xxh3_bloom_block(filter, h), (xxh_u32)h, xxh3_bloom_salt);
+}
+
+/* Hashes inputs[0..n) and prefetches their blocks */
+XXH_FORCE_INLINE void xxh3_bloom_prepare(const xxh3_bloom_t* filter, const void* const* inputs,
+                                         const size_t* sizes, size_t n, xxh_u64* h,
+                                         xxh_u8** blocks)
+{
+    size_t i;
+    for (i = 0; i < n; i++) {
+        h[i]      = XXH3_64bits_withSeed(inputs[i], sizes[i], filter->seed);
+        blocks[i] = xxh3_bloom_block(filter, h[i]);
+        XXH_PREFETCH(blocks[i]);
+    }
+}
+
+void XXH3_VARIANT_FN(xxh3_bloom_add_batch)(xxh3_bloom_t* filter, const void* const* inputs,
+                                           const size_t* sizes, size_t count)
+{
+    xxh_u64 h[XXH3_BLOOM_GROUP];
+    xxh_u8* blocks[XXH3_BLOOM_GROUP];
+    size_t  i, j;
+
+    XXH3_WRAPPER_GUARD({
+        if (filter == NULL || (count > 0 && (inputs == NULL || sizes == NULL))) {
+            return;
+        }
+    });
+    for (i = 0; i < count; i += XXH3_BLOOM_GROUP) {
+        size_t const n = (count - i < XXH3_BLOOM_GROUP) ? count - i : XXH3_BLOOM_GROUP;
+        xxh3_bloom_prepare(filter, inputs + i, sizes + i, n, h, blocks);
+        for (j = 0; j < n; j++) {
+            XXH3_BLOOM_SET(blocks[j], (xxh_u32)h[j], xxh3_bloom_salt);
+        }
+    }
+}
+
+size_t XXH3_VARIANT_FN(xxh3_bloom_contains_batch)(const xxh3_bloom_t* filter,
+                                                  const void* const* inputs, const size_t* sizes,
+                                                  size_t count, unsigned char* found)
+{
+    xxh_u64 h[XXH3_BLOOM_GROUP];
+    xxh_u8* blocks[XXH3_BLOOM_GROUP];
+    size_t  hits = 0;
+    size_t  i, j;
+
+    XXH3_WRAPPER_GUARD({
+        if (filter == NULL || (count > 0 && (inputs == NULL || sizes == NULL || found == NULL))) {
+            return 0;
+        }
+    });
+    for (i = 0; i < count; i += XXH3_BLOOM_GROUP) {
+        size_t const n = (count - i < XXH3_BLOOM_GROUP) ? count - i : XXH3_BLOOM_GROUP;
+        xxh3_bloom_prepare(filter, inputs + i, sizes + i, n, h, blocks);
+        for (j = 0; j < n; j++) {
+            int const hit = XXH3_BLOOM_TEST(blocks[j], (xxh_u32)h[j], xxh3_bloom_salt);
+            found[i + j] = (unsigned char)hit;
+            hits += (size_t)hit;
+        }
+    }
+    return hits;
+}
+
+#undef XXH3_BLOOM_SET
+#undef XXH3_BLOOM_TEST
+
+#endif /* XXH3_VARIANTS_TEMPLATES_BLOOM_H */
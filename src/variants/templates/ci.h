@@ -0,0 +1,381 @@
+/* ASCII case-insensitive XXH3-64.
+ *
+ * Each input word or vector is folded as it is loaded: bytes 'A'..'Z' get
+ * bit 5 set, every other byte (including those >= 0x80) is left alone.
+ * Nothing else changes, so the result equals xxh3_64_<variant>() of the
+ * lowercased input, without a lowercase copy or a second pass.
+ *
+ * Inputs of at most XXH3_MIDSIZE_MAX bytes take copies of the vendor's
+ * short-input paths whose reads are folded, two words per vector where the
+ * variant has one and with a SWAR fold otherwise. Longer inputs follow
+ * XXH3_hashLong_internal_loop() with a stripe kernel that folds the data
+ * vector before the secret is mixed in. The streaming update is
+ * XXH3_update() with the input folded on its way into the state buffer and
+ * folded stripes for the bytes consumed in place; the buffer then holds
+ * lowercased bytes, so xxh3_64_digest() is used as is.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) and xxh3_state_internal.h, with
+ * XXH3_VARIANT defined and optionally
+ *   XXH3_CI_FOLD_LINE(dst, src)             store the 64 bytes at src,
+ *                                           folded, to dst
+ *   XXH3_CI_ACCUMULATE_512(acc, in, secret) XXH3_accumulate_512() of the
+ *                                           folded stripe at `in`
+ *   XXH3_CI_READ2(p, q, lo, hi)             set the lvalues lo, hi to the
+ *                                           folded XXH_readLE64() of p, q
+ *   XXH3_CI_READ128(p, lo, hi)              XXH3_CI_READ2(p, p + 8, lo, hi)
+ * Without them the template uses the SWAR fold and the scalar round. Emits
+ * `xxh3_64_ci_<variant>`, `xxh3_64_ci_batch_<variant>` and
+ * `xxh3_64_ci_update_<variant>`.
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_CI_H
+#define XXH3_VARIANTS_TEMPLATES_CI_H
+
+/* Per byte: h + 0x3F has the top bit set iff h >= 'A', h + 0x25 iff
+ * h > 'Z' (h = b & 0x7F, so neither sum carries into the next byte) */
+XXH_FORCE_INLINE xxh_u64 xxh3_ci_fold64(xxh_u64 v)
+{
+    xxh_u64 const low7  = 0x7F7F7F7F7F7F7F7FULL;
+    xxh_u64 const h     = v & low7;
+    xxh_u64 const upper = ~v & ~low7
+                        & ((h + 0x3F3F3F3F3F3F3F3FULL) ^ (h + 0x2525252525252525ULL));
+    return v | (upper >> 2);
+}
+
+XXH_FORCE_INLINE xxh_u8 xxh3_ci_fold8(xxh_u8 c)
+{
+    return (xxh_u8)(c | ((xxh_u8)(c - 'A') < 26) << 5);
+}
+
+XXH_FORCE_INLINE xxh_u64 xxh3_ci_read64(const xxh_u8* p)
+{
+    return xxh3_ci_fold64(XXH_readLE64(p));
+}
+
+XXH_FORCE_INLINE xxh_u32 xxh3_ci_read32(const xxh_u8* p)
+{
+    return (xxh_u32)xxh3_ci_fold64(XXH_readLE32(p));
+}
+
+#ifndef XXH3_CI_READ2
+#  define XXH3_CI_READ2(p, q, lo, hi) \
+    do { (lo) = xxh3_ci_read64(p); (hi) = xxh3_ci_read64(q); } while (0)
+#endif
+
+#ifndef XXH3_CI_READ128
+#  define XXH3_CI_READ128(p, lo, hi) \
+    do { (lo) = xxh3_ci_read64(p); (hi) = xxh3_ci_read64((p) + 8); } while (0)
+#endif
+
+#ifndef XXH3_CI_FOLD_LINE
+XXH_FORCE_INLINE void xxh3_ci_fold_line(xxh_u8* dst, const xxh_u8* src)
+{
+    size_t i;
+    for (i = 0; i < XXH_STRIPE_LEN; i += 8) {
+        xxh_u64 v;
+        XXH_memcpy(&v, src + i, sizeof(v));
+        v = xxh3_ci_fold64(v);
+        XXH_memcpy(dst + i, &v, sizeof(v));
+    }
+}
+#  define XXH3_CI_FOLD_LINE(dst, src) xxh3_ci_fold_line((dst), (src))
+#endif
+
+#ifndef XXH3_CI_ACCUMULATE_512
+/* XXH3_scalarRound() over folded words */
+XXH_FORCE_INLINE void xxh3_ci_accumulate_512(xxh_u64* XXH_RESTRICT acc, const xxh_u8* XXH_RESTRICT input,
+                                             const xxh_u8* XXH_RESTRICT secret)
+{
+    size_t i;
+    for (i = 0; i < XXH_ACC_NB; i++) {
+        xxh_u64 const data = xxh3_ci_read64(input + 8 * i);
+        xxh_u64 const key  = data ^ XXH_readLE64(secret + 8 * i);
+        acc[i ^ 1] += data;
+        acc[i]     += XXH_mult32to64(key & 0xFFFFFFFF, key >> 32);
+    }
+}
+#  define XXH3_CI_ACCUMULATE_512(acc, in, secret) xxh3_ci_accumulate_512((acc), (in), (secret))
+#endif
+
+/* Folding copy of len bytes; reads nothing outside [src, src + len) */
+XXH_FORCE_INLINE void xxh3_ci_fold_copy(xxh_u8* dst, const xxh_u8* src, size_t len)
+{
+    for (; len >= XXH_STRIPE_LEN; len -= XXH_STRIPE_LEN) {
+        XXH3_CI_FOLD_LINE(dst, src);
+        dst += XXH_STRIPE_LEN;
+        src += XXH_STRIPE_LEN;
+    }
+    for (; len >= 8; len -= 8) {
+        xxh_u64 v;
+        XXH_memcpy(&v, src, sizeof(v));
+        v = xxh3_ci_fold64(v);
+        XXH_memcpy(dst, &v, sizeof(v));
+        dst += 8;
+        src += 8;
+    }
+    for (; len > 0; len--) {
+        *dst++ = xxh3_ci_fold8(*src++);
+    }
+}
+
+/* ------------------------------------------------------------------ short */
+
+/* XXH3_len_*_64b() and XXH3_mix16B() with every input read folded */
+XXH_FORCE_INLINE XXH64_hash_t xxh3_ci_len_1to3(const xxh_u8* input, size_t len,
+                                               const xxh_u8* secret, XXH64_hash_t seed)
+{
+    xxh_u8  const c1 = xxh3_ci_fold8(input[0]);
+    xxh_u8  const c2 = xxh3_ci_fold8(input[len >> 1]);
+    xxh_u8  const c3 = xxh3_ci_fold8(input[len - 1]);
+    xxh_u32 const combined = ((xxh_u32)c1 << 16) | ((xxh_u32)c2  << 24)
+                           | ((xxh_u32)c3 <<  0) | ((xxh_u32)len << 8);
+    xxh_u64 const bitflip = (XXH_readLE32(secret) ^ XXH_readLE32(secret + 4)) + seed;
+    return XXH64_avalanche((xxh_u64)combined ^ bitflip);
+}
+
+XXH_FORCE_INLINE XXH64_hash_t xxh3_ci_len_4to8(const xxh_u8* input, size_t len,
+                                               const xxh_u8* secret, XXH64_hash_t seed)
+{
+    seed ^= (xxh_u64)XXH_swap32((xxh_u32)seed) << 32;
+    {   xxh_u32 const input1  = xxh3_ci_read32(input);
+        xxh_u32 const input2  = xxh3_ci_read32(input + len - 4);
+        xxh_u64 const bitflip = (XXH_readLE64(secret + 8) ^ XXH_readLE64(secret + 16)) - seed;
+        xxh_u64 const input64 = input2 + (((xxh_u64)input1) << 32);
+        return XXH3_rrmxmx(input64 ^ bitflip, len);
+    }
+}
+
+XXH_FORCE_INLINE XXH64_hash_t xxh3_ci_len_9to16(const xxh_u8* input, size_t len,
+                                                const xxh_u8* secret, XXH64_hash_t seed)
+{
+    xxh_u64 const bitflip1 = (XXH_readLE64(secret + 24) ^ XXH_readLE64(secret + 32)) + seed;
+    xxh_u64 const bitflip2 = (XXH_readLE64(secret + 40) ^ XXH_readLE64(secret + 48)) - seed;
+    xxh_u64 input_lo, input_hi;
+
+    XXH3_CI_READ2(input, input + len - 8, input_lo, input_hi);
+    input_lo ^= bitflip1;
+    input_hi ^= bitflip2;
+    return XXH3_avalanche(len + XXH_swap64(input_lo) + input_hi
+                          + XXH3_mul128_fold64(input_lo, input_hi));
+}
+
+XXH_FORCE_INLINE xxh_u64 xxh3_ci_mix16B(const xxh_u8* XXH_RESTRICT input,
+                                        const xxh_u8* XXH_RESTRICT secret, xxh_u64 seed)
+{
+    xxh_u64 lo, hi;
+    XXH3_CI_READ128(input, lo, hi);
+    return XXH3_mul128_fold64(lo ^ (XXH_readLE64(secret)     + seed),
+                              hi ^ (XXH_readLE64(secret + 8) - seed));
+}
+
+XXH_FORCE_INLINE XXH64_hash_t xxh3_ci_len_17to128(const xxh_u8* XXH_RESTRICT input, size_t len,
+                                                  const xxh_u8* XXH_RESTRICT secret,
+                                                  XXH64_hash_t seed)
+{
+    xxh_u64 acc = len * XXH_PRIME64_1;
+
+    if (len > 32) {
+        if (len > 64) {
+            if (len > 96) {
+                acc += xxh3_ci_mix16B(input + 48, secret + 96, seed);
+                acc += xxh3_ci_mix16B(input + len - 64, secret + 112, seed);
+            }
+            acc += xxh3_ci_mix16B(input + 32, secret + 64, seed);
+            acc += xxh3_ci_mix16B(input + len - 48, secret + 80, seed);
+        }
+        acc += xxh3_ci_mix16B(input + 16, secret + 32, seed);
+        acc += xxh3_ci_mix16B(input + len - 32, secret + 48, seed);
+    }
+    acc += xxh3_ci_mix16B(input + 0, secret + 0, seed);
+    acc += xxh3_ci_mix16B(input + len - 16, secret + 16, seed);
+    return XXH3_avalanche(acc);
+}
+
+XXH_NO_INLINE XXH64_hash_t xxh3_ci_len_129to240(const xxh_u8* XXH_RESTRICT input, size_t len,
+                                                const xxh_u8* XXH_RESTRICT secret,
+                                                XXH64_hash_t seed)
+{
+    unsigned int const nbRounds = (unsigned int)len / 16;
+    xxh_u64 acc = len * XXH_PRIME64_1;
+    xxh_u64 acc_end;
+    unsigned int i;
+
+    for (i = 0; i < 8; i++) {
+        acc += xxh3_ci_mix16B(input + 16 * i, secret + 16 * i, seed);
+    }
+    acc_end = xxh3_ci_mix16B(input + len - 16,
+                             secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET, seed);
+    acc = XXH3_avalanche(acc);
+    for (i = 8; i < nbRounds; i++) {
+        XXH_COMPILER_GUARD(acc);
+        acc_end += xxh3_ci_mix16B(input + 16 * i,
+                                  secret + 16 * (i - 8) + XXH3_MIDSIZE_STARTOFFSET, seed);
+    }
+    return XXH3_avalanche(acc + acc_end);
+}
+
+/* ------------------------------------------------------------------ long */
+
+XXH_FORCE_INLINE void xxh3_ci_accumulate(xxh_u64* XXH_RESTRICT acc, const xxh_u8* XXH_RESTRICT input,
+                                         const xxh_u8* XXH_RESTRICT secret, size_t nbStripes)
+{
+    size_t n;
+    for (n = 0; n < nbStripes; n++) {
+        const xxh_u8* const in = input + n * XXH_STRIPE_LEN;
+        XXH_PREFETCH(in + XXH_PREFETCH_DIST);
+        XXH3_CI_ACCUMULATE_512(acc, in, secret + n * XXH_SECRET_CONSUME_RATE);
+    }
+}
+
+/* XXH3_hashLong_64b_withSeed() over folded stripes; len > XXH3_MIDSIZE_MAX */
+XXH_NO_INLINE XXH64_hash_t xxh3_ci_64_long(const xxh_u8* XXH_RESTRICT input, size_t len,
+                                           XXH64_hash_t seed)
+{
+    size_t const secretSize        = XXH_SECRET_DEFAULT_SIZE;
+    size_t const nbStripesPerBlock = (secretSize - XXH_STRIPE_LEN) / XXH_SECRET_CONSUME_RATE;
+    size_t const block_len         = XXH_STRIPE_LEN * nbStripesPerBlock;
+    size_t const nb_blocks         = (len - 1) / block_len;
+    XXH_ALIGN(XXH_SEC_ALIGN) xxh_u8 custom[XXH_SECRET_DEFAULT_SIZE];
+    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+    const xxh_u8* secret = XXH3_kSecret;
+    size_t n;
+
+    if (seed != 0) {
+        XXH3_initCustomSecret(custom, seed);
+        secret = custom;
+    }
+    for (n = 0; n < nb_blocks; n++) {
+        xxh3_ci_accumulate(acc, input + n * block_len, secret, nbStripesPerBlock);
+        XXH3_scrambleAcc(acc, secret + secretSize - XXH_STRIPE_LEN);
+    }
+    {   size_t const nbStripes = ((len - 1) - block_len * nb_blocks) / XXH_STRIPE_LEN;
+        xxh3_ci_accumulate(acc, input + nb_blocks * block_len, secret, nbStripes);
+        XXH3_CI_ACCUMULATE_512(acc, input + len - XXH_STRIPE_LEN,
+                               secret + secretSize - XXH_STRIPE_LEN - XXH_SECRET_LASTACC_START);
+    }
+    return XXH3_mergeAccs(acc, secret + XXH_SECRET_MERGEACCS_START, (xxh_u64)len * XXH_PRIME64_1);
+}
+
+/* XXH3_64bits_withSeed() of the folded input */
+XXH_FORCE_INLINE XXH64_hash_t xxh3_ci_64(const xxh_u8* input, size_t len, XXH64_hash_t seed)
+{
+    const xxh_u8* const secret = XXH3_kSecret;
+
+    if (len <= 16) {
+        if (len > 8) {
+            return xxh3_ci_len_9to16(input, len, secret, seed);
+        }
+        if (len >= 4) {
+            return xxh3_ci_len_4to8(input, len, secret, seed);
+        }
+        if (len > 0) {
+            return xxh3_ci_len_1to3(input, len, secret, seed);
+        }
+        return XXH64_avalanche(seed ^ (XXH_readLE64(secret + 56) ^ XXH_readLE64(secret + 64)));
+    }
+    if (len <= 128) {
+        return xxh3_ci_len_17to128(input, len, secret, seed);
+    }
+    if (len <= XXH3_MIDSIZE_MAX) {
+        return xxh3_ci_len_129to240(input, len, secret, seed);
+    }
+    return xxh3_ci_64_long(input, len, seed);
+}
+
+uint64_t XXH3_VARIANT_FN(xxh3_64_ci)(const void* input, size_t size, uint64_t seed)
+{
+    XXH3_WRAPPER_GUARD({
+        if (input == NULL && size > 0) {
+            return 0;
+        }
+    });
+    return xxh3_ci_64((const xxh_u8*)input, size, seed);
+}
+
+void XXH3_VARIANT_FN(xxh3_64_ci_batch)(const void* const* inputs, const size_t* sizes, size_t count,
+                                       uint64_t seed, uint64_t* out)
+{
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (count > 0 && (inputs == NULL || sizes == NULL || out == NULL)) {
+            return;
+        }
+    });
+    for (i = 0; i < count; i++) {
+        /* keys are usually short and scattered: start the next fetch early */
+        if (i + 1 < count) {
+            XXH_PREFETCH(inputs[i + 1]);
+        }
+        out[i] = xxh3_ci_64((const xxh_u8*)inputs[i], sizes[i], seed);
+    }
+}
+
+/* ------------------------------------------------------------------ stream */
+
+/* Stripes of the state buffer were folded on the way in */
+XXH_FORCE_INLINE void xxh3_ci_accumulate_buffer(xxh_u64* XXH_RESTRICT acc,
+                                                const xxh_u8* XXH_RESTRICT input,
+                                                const xxh_u8* XXH_RESTRICT secret,
+                                                size_t nbStripes)
+{
+    XXH3_accumulate(acc, input, secret, nbStripes);
+}
+
+/* XXH3_update() with every copy into the state buffer folded */
+int XXH3_VARIANT_FN(xxh3_64_ci_update)(xxh3_state_t* state, const void* input, size_t size)
+{
+    XXH3_state_t* const vstate = (XXH3_state_t*)xxh3_vendorState(state);
+    const xxh_u8* in = (const xxh_u8*)input;
+    const xxh_u8* bEnd;
+    const xxh_u8* secret;
+    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB];
+
+    XXH3_WRAPPER_GUARD({
+        if (vstate == NULL || (input == NULL && size > 0)) {
+            return XXH3_ERROR;
+        }
+    });
+    if (size == 0) {
+        return XXH3_OK;
+    }
+    bEnd   = in + size;
+    secret = (vstate->extSecret == NULL) ? vstate->customSecret : vstate->extSecret;
+    vstate->totalLen += size;
+
+    if (size <= XXH3_INTERNALBUFFER_SIZE - vstate->bufferedSize) {
+        xxh3_ci_fold_copy(vstate->buffer + vstate->bufferedSize, in, size);
+        vstate->bufferedSize += (XXH32_hash_t)size;
+        return XXH3_OK;
+    }
+
+    XXH_memcpy(acc, vstate->acc, sizeof(acc));
+    if (vstate->bufferedSize) {
+        size_t const loadSize = XXH3_INTERNALBUFFER_SIZE - vstate->bufferedSize;
+        xxh3_ci_fold_copy(vstate->buffer + vstate->bufferedSize, in, loadSize);
+        in += loadSize;
+        XXH3_consumeStripes(acc, &vstate->nbStripesSoFar, vstate->nbStripesPerBlock,
+                            vstate->buffer, XXH3_INTERNALBUFFER_SIZE / XXH_STRIPE_LEN,
+                            secret, vstate->secretLimit,
+                            xxh3_ci_accumulate_buffer, XXH3_scrambleAcc);
+        vstate->bufferedSize = 0;
+    }
+    if (bEnd - in > XXH3_INTERNALBUFFER_SIZE) {
+        size_t const nbStripes = (size_t)(bEnd - 1 - in) / XXH_STRIPE_LEN;
+        in = XXH3_consumeStripes(acc, &vstate->nbStripesSoFar, vstate->nbStripesPerBlock,
+                                 in, nbStripes, secret, vstate->secretLimit,
+                                 xxh3_ci_accumulate, XXH3_scrambleAcc);
+        /* the digest's last stripe may reach back into these bytes */
+        XXH3_CI_FOLD_LINE(vstate->buffer + sizeof(vstate->buffer) - XXH_STRIPE_LEN,
+                          in - XXH_STRIPE_LEN);
+    }
+    xxh3_ci_fold_copy(vstate->buffer, in, (size_t)(bEnd - in));
+    vstate->bufferedSize = (XXH32_hash_t)(bEnd - in);
+    XXH_memcpy(vstate->acc, acc, sizeof(acc));
+    return XXH3_OK;
+}
+
+#undef XXH3_CI_READ128
+#undef XXH3_CI_FOLD_LINE
+#undef XXH3_CI_ACCUMULATE_512
+
+#endif /* XXH3_VARIANTS_TEMPLATES_CI_H */
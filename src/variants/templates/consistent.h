@@ -0,0 +1,156 @@
+/* Consistent hashing: batched jump hashing and weighted rendezvous hashing.
+ *
+ * Rendezvous (highest random weight) hashing scores a key against every
+ * node, node j's score being the key's XXH3-64 under the node's seed, and
+ * places the key on the best scoring nodes. All seeds go through
+ * xxh3_64_multiseed_<variant>(), which reads the key once and runs the
+ * seeds across SIMD lanes, XXH3_RDV_CHUNK seeds per call. Without weights
+ * the highest hashes win. With weights the logarithmic method of
+ * Schindelhauer and Schomaker applies: with u the hash as a fraction in
+ * (0, 1), node j scores -ln(u) / w_j and the lowest scores win, which
+ * places a key on node j with probability w_j / sum(w). Since
+ * -ln(u) >= 1 - u, a node whose (1 - u) / w_j already loses to the N-th
+ * best score so far is skipped without its logarithm, and with N much
+ * smaller than the node count most nodes are. Equal scores rank the lower
+ * node index first.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL), variants/templates/multiseed.h
+ * and xxh3_consistent_internal.h, with XXH3_VARIANT defined. Emits
+ * `xxh3_jump_batch_<variant>`, `xxh3_rendezvous_<variant>` and
+ * `xxh3_rendezvous_batch_<variant>`.
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_CONSISTENT_H
+#define XXH3_VARIANTS_TEMPLATES_CONSISTENT_H
+
+#include <math.h>
+
+/* Node seeds hashed per call of xxh3_64_multiseed_<variant>() */
+#define XXH3_RDV_CHUNK 64
+
+/* Inserts `node` into the ascending top[0..*m) by `rank`, keeping the
+ * first n; an equal rank goes after those already in */
+XXH_FORCE_INLINE void xxh3_rdv_insert_u64(xxh_u64* rank, size_t* top, size_t* m, size_t n,
+                                          xxh_u64 r, size_t node)
+{
+    size_t i = *m;
+    if (i == n) {
+        if (r >= rank[n - 1]) {
+            return;
+        }
+        i--;
+    } else {
+        (*m)++;
+    }
+    for (; i > 0 && r < rank[i - 1]; i--) {
+        rank[i] = rank[i - 1];
+        top[i]  = top[i - 1];
+    }
+    rank[i] = r;
+    top[i]  = node;
+}
+
+XXH_FORCE_INLINE void xxh3_rdv_insert_f64(double* score, size_t* top, size_t* m, size_t n,
+                                          double s, size_t node)
+{
+    size_t i = *m;
+    if (i == n) {
+        if (s >= score[n - 1]) {
+            return;
+        }
+        i--;
+    } else {
+        (*m)++;
+    }
+    for (; i > 0 && s < score[i - 1]; i--) {
+        score[i] = score[i - 1];
+        top[i]   = top[i - 1];
+    }
+    score[i] = s;
+    top[i]   = node;
+}
+
+void XXH3_VARIANT_FN(xxh3_jump_batch)(const void* const* inputs, const size_t* sizes, size_t count,
+                                      uint64_t seed, uint32_t buckets, uint32_t* out)
+{
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (count > 0 && (inputs == NULL || sizes == NULL || out == NULL)) {
+            return;
+        }
+    });
+    for (i = 0; i < count; i++) {
+        out[i] = xxh3_jump(XXH3_64bits_withSeed(inputs[i], sizes[i], seed), buckets);
+    }
+}
+
+size_t XXH3_VARIANT_FN(xxh3_rendezvous)(const void* key, size_t size, const uint64_t* seeds,
+                                        const double* weights, size_t nodes, size_t* top,
+                                        size_t n_top)
+{
+    xxh_u64 h[XXH3_RDV_CHUNK];
+    xxh_u64 rank[XXH3_RENDEZVOUS_MAX_TOP];
+    double  score[XXH3_RENDEZVOUS_MAX_TOP];
+    size_t  m = 0;
+    size_t  i, j;
+
+    XXH3_WRAPPER_GUARD({
+        if ((nodes > 0 && seeds == NULL) || (n_top > 0 && top == NULL)
+            || (key == NULL && size > 0)) {
+            return 0;
+        }
+    });
+    n_top = (n_top < XXH3_RENDEZVOUS_MAX_TOP) ? n_top : XXH3_RENDEZVOUS_MAX_TOP;
+    if (n_top == 0) {
+        return 0;
+    }
+    for (i = 0; i < nodes; i += XXH3_RDV_CHUNK) {
+        size_t const c = (nodes - i < XXH3_RDV_CHUNK) ? nodes - i : XXH3_RDV_CHUNK;
+        XXH3_VARIANT_FN(xxh3_64_multiseed)(key, size, seeds + i, c, h);
+        if (weights == NULL) {
+            for (j = 0; j < c; j++) {
+                xxh3_rdv_insert_u64(rank, top, &m, n_top, ~h[j], i + j);
+            }
+            continue;
+        }
+        for (j = 0; j < c; j++) {
+            double const  w = weights[i + j];
+            xxh_u64 const q = h[j] >> 12;  /* u = (q + 0.5) / 2^52 and 1 - u are exact */
+            if (!(w > 0)) {
+                continue;
+            }
+            /* the bound is shaded so that rounding never lets it pass the score */
+            if (m == n_top
+                && 0.999999 * ((double)(((xxh_u64)1 << 52) - q) - 0.5) * 0x1p-52 / w >= score[m - 1]) {
+                continue;
+            }
+            xxh3_rdv_insert_f64(score, top, &m, n_top, -log(((double)q + 0.5) * 0x1p-52) / w, i + j);
+        }
+    }
+    return m;
+}
+
+size_t XXH3_VARIANT_FN(xxh3_rendezvous_batch)(const void* const* inputs, const size_t* sizes,
+                                              size_t count, const uint64_t* seeds,
+                                              const double* weights, size_t nodes, size_t* top,
+                                              size_t n_top)
+{
+    size_t m = 0;
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (count > 0 && (inputs == NULL || sizes == NULL)) {
+            return 0;
+        }
+    });
+    n_top = (n_top < XXH3_RENDEZVOUS_MAX_TOP) ? n_top : XXH3_RENDEZVOUS_MAX_TOP;
+    for (i = 0; i < count; i++) {
+        m = XXH3_VARIANT_FN(xxh3_rendezvous)(inputs[i], sizes[i], seeds, weights, nodes,
+                                             top + i * n_top, n_top);
+    }
+    return m;
+}
+
+#undef XXH3_RDV_CHUNK
+
+#endif /* XXH3_VARIANTS_TEMPLATES_CONSISTENT_H */
@@ -0,0 +1,196 @@
+/* Fused copy-and-hash.
+ *
+ * Copying a buffer and then hashing it reads the source from memory twice.
+ * Here each 1 KiB block (one XXH3 block with the default secret) is
+ * accumulated with the variant's stripe loop and then copied while it is
+ * still in L1, so the source is read from memory once. The non-temporal
+ * forms write whole destination lines past the cache when the destination
+ * is 64-byte aligned, which also saves the read-for-ownership of each line.
+ * Block scrambling, the last stripe and the merge follow
+ * XXH3_hashLong_internal_loop(), so digests are bit-identical to the
+ * regular variants; inputs of at most XXH3_MIDSIZE_MAX bytes are copied and
+ * then hashed one-shot.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) and xxh3_state_internal.h, with
+ * XXH3_VARIANT defined and optionally
+ *   XXH3_COPY_NT_LINE(dst, src)  copy 64 bytes to a 64-byte aligned dst
+ *                                with non-temporal stores
+ *   XXH3_COPY_NT_FENCE()         order those stores before returning
+ * Without them the non-temporal forms use regular stores. Emits
+ * `xxh3_{64,128}_copy[_nt]_<variant>` and `xxh3_{64,128}_update_copy_<variant>`.
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_COPY_H
+#define XXH3_VARIANTS_TEMPLATES_COPY_H
+
+/* update_copy: source bytes per update + copy round; fits in L1 */
+#define XXH3_COPY_CHUNK (16 * 1024)
+
+XXH_FORCE_INLINE void xxh3_copy_block(xxh_u8* dst, const xxh_u8* src, size_t len, int nt)
+{
+#ifdef XXH3_COPY_NT_LINE
+    if (nt && ((size_t)dst & 63) == 0) {
+        size_t off;
+        for (off = 0; off + 64 <= len; off += 64) {
+            XXH3_COPY_NT_LINE(dst + off, src + off);
+        }
+        dst += off;
+        src += off;
+        len -= off;
+    }
+#else
+    (void)nt;
+#endif
+    XXH_memcpy(dst, src, len);
+}
+
+/* XXH3_hashLong_internal_loop() for the default secret size, copying each
+ * block after it is accumulated; len > XXH3_MIDSIZE_MAX */
+XXH_FORCE_INLINE void xxh3_copy_loop(xxh_u64* XXH_RESTRICT acc, xxh_u8* XXH_RESTRICT dst,
+                                     const xxh_u8* XXH_RESTRICT src, size_t len,
+                                     const xxh_u8* XXH_RESTRICT secret, int nt)
+{
+    size_t const secretSize        = XXH_SECRET_DEFAULT_SIZE;
+    size_t const nbStripesPerBlock = (secretSize - XXH_STRIPE_LEN) / XXH_SECRET_CONSUME_RATE;
+    size_t const block_len         = XXH_STRIPE_LEN * nbStripesPerBlock;
+    size_t const nb_blocks         = (len - 1) / block_len;
+    size_t n;
+
+    for (n = 0; n < nb_blocks; n++) {
+        XXH3_accumulate(acc, src + n * block_len, secret, nbStripesPerBlock);
+        XXH3_scrambleAcc(acc, secret + secretSize - XXH_STRIPE_LEN);
+        xxh3_copy_block(dst + n * block_len, src + n * block_len, block_len, nt);
+    }
+    {   size_t const done      = nb_blocks * block_len;
+        size_t const nbStripes = ((len - 1) - done) / XXH_STRIPE_LEN;
+        XXH3_accumulate(acc, src + done, secret, nbStripes);
+        XXH3_accumulate_512(acc, src + len - XXH_STRIPE_LEN,
+                            secret + secretSize - XXH_STRIPE_LEN - XXH_SECRET_LASTACC_START);
+        xxh3_copy_block(dst + done, src + done, len - done, nt);
+    }
+#ifdef XXH3_COPY_NT_FENCE
+    if (nt) {
+        XXH3_COPY_NT_FENCE();
+    }
+#endif
+}
+
+/* Returns the secret for `seed`, derived into `custom` unless seed == 0 */
+XXH_FORCE_INLINE const xxh_u8* xxh3_copy_secret(xxh_u8* custom, XXH64_hash_t seed)
+{
+    if (seed == 0) {
+        return XXH3_kSecret;
+    }
+    XXH3_initCustomSecret(custom, seed);
+    return custom;
+}
+
+XXH_FORCE_INLINE XXH64_hash_t xxh3_copy_64b(void* dst, const void* src, size_t len,
+                                            XXH64_hash_t seed, int nt)
+{
+    if (len <= XXH3_MIDSIZE_MAX) {
+        if (len > 0) {
+            XXH_memcpy(dst, src, len);
+        }
+        return XXH3_64bits_withSeed(src, len, seed);
+    }
+    {   XXH_ALIGN(XXH_SEC_ALIGN) xxh_u8 custom[XXH_SECRET_DEFAULT_SIZE];
+        XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+        const xxh_u8* const secret = xxh3_copy_secret(custom, seed);
+        xxh3_copy_loop(acc, (xxh_u8*)dst, (const xxh_u8*)src, len, secret, nt);
+        return XXH3_mergeAccs(acc, secret + XXH_SECRET_MERGEACCS_START, (xxh_u64)len * XXH_PRIME64_1);
+    }
+}
+
+XXH_FORCE_INLINE XXH128_hash_t xxh3_copy_128b(void* dst, const void* src, size_t len,
+                                              XXH64_hash_t seed, int nt)
+{
+    if (len <= XXH3_MIDSIZE_MAX) {
+        if (len > 0) {
+            XXH_memcpy(dst, src, len);
+        }
+        return XXH3_128bits_withSeed(src, len, seed);
+    }
+    {   XXH_ALIGN(XXH_SEC_ALIGN) xxh_u8 custom[XXH_SECRET_DEFAULT_SIZE];
+        XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+        const xxh_u8* const secret = xxh3_copy_secret(custom, seed);
+        XXH128_hash_t h128;
+        xxh3_copy_loop(acc, (xxh_u8*)dst, (const xxh_u8*)src, len, secret, nt);
+        h128.low64  = XXH3_mergeAccs(acc, secret + XXH_SECRET_MERGEACCS_START,
+                                     (xxh_u64)len * XXH_PRIME64_1);
+        h128.high64 = XXH3_mergeAccs(acc, secret + XXH_SECRET_DEFAULT_SIZE
+                                              - sizeof(acc) - XXH_SECRET_MERGEACCS_START,
+                                     ~((xxh_u64)len * XXH_PRIME64_2));
+        return h128;
+    }
+}
+
+uint64_t XXH3_VARIANT_FN(xxh3_64_copy)(void* dst, const void* src, size_t size, uint64_t seed)
+{
+    XXH3_WRAPPER_GUARD({
+        if ((dst == NULL || src == NULL) && size > 0) {
+            return 0;
+        }
+    });
+    return xxh3_copy_64b(dst, src, size, seed, 0);
+}
+
+xxh3_128_t XXH3_VARIANT_FN(xxh3_128_copy)(void* dst, const void* src, size_t size, uint64_t seed)
+{
+    XXH3_WRAPPER_GUARD({
+        if ((dst == NULL || src == NULL) && size > 0) {
+            return ((xxh3_128_t){0,0});
+        }
+    });
+    return xxh128_to_xxh3(xxh3_copy_128b(dst, src, size, seed, 0));
+}
+
+uint64_t XXH3_VARIANT_FN(xxh3_64_copy_nt)(void* dst, const void* src, size_t size, uint64_t seed)
+{
+    XXH3_WRAPPER_GUARD({
+        if ((dst == NULL || src == NULL) && size > 0) {
+            return 0;
+        }
+    });
+    return xxh3_copy_64b(dst, src, size, seed, 1);
+}
+
+xxh3_128_t XXH3_VARIANT_FN(xxh3_128_copy_nt)(void* dst, const void* src, size_t size, uint64_t seed)
+{
+    XXH3_WRAPPER_GUARD({
+        if ((dst == NULL || src == NULL) && size > 0) {
+            return ((xxh3_128_t){0,0});
+        }
+    });
+    return xxh128_to_xxh3(xxh3_copy_128b(dst, src, size, seed, 1));
+}
+
+/* xxh3_64_update() of src plus a copy to dst, XXH3_COPY_CHUNK bytes at a time */
+int XXH3_VARIANT_FN(xxh3_64_update_copy)(xxh3_state_t* state, void* dst, const void* src, size_t size)
+{
+    XXH3_state_t* const vstate = (XXH3_state_t*)xxh3_vendorState(state);
+    size_t off, n;
+
+    XXH3_WRAPPER_GUARD({
+        if (vstate == NULL || ((dst == NULL || src == NULL) && size > 0)) {
+            return XXH3_ERROR;
+        }
+    });
+    for (off = 0; off < size; off += n) {
+        n = (size - off < XXH3_COPY_CHUNK) ? size - off : XXH3_COPY_CHUNK;
+        (void)XXH3_64bits_update(vstate, (const xxh_u8*)src + off, n);
+        XXH_memcpy((xxh_u8*)dst + off, (const xxh_u8*)src + off, n);
+    }
+    return XXH3_OK;
+}
+
+int XXH3_VARIANT_FN(xxh3_128_update_copy)(xxh3_state_t* state, void* dst, const void* src, size_t size)
+{
+    /* XXH3 64- and 128-bit streams share the same update routine */
+    return XXH3_VARIANT_FN(xxh3_64_update_copy)(state, dst, src, size);
+}
+
+#undef XXH3_COPY_CHUNK
+#undef XXH3_COPY_NT_LINE
+#undef XXH3_COPY_NT_FENCE
+
+#endif /* XXH3_VARIANTS_TEMPLATES_COPY_H */
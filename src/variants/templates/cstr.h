@@ -0,0 +1,195 @@
+/* Hashing of NUL-terminated strings.
+ *
+ * The terminator is searched 64 bytes at a time, with unaligned loads while
+ * the 64 bytes lie in one 4 KiB page and otherwise with the rest of the
+ * aligned line. Neither load crosses a page boundary, so none can fault past
+ * the terminator (they may cover bytes after the NUL, and before the string
+ * in the aligned case). Strings of at most XXH3_MIDSIZE_MAX bytes are then
+ * hashed one-shot, from L1. Longer strings are searched in aligned lines and
+ * hashed while the search goes on: block n (1 KiB with the default secret)
+ * is accumulated and scrambled as soon as the search has passed its last
+ * byte, which is exactly when XXH3_hashLong_internal_loop() would process
+ * it, and the last stripes and the merge follow that loop. Results equal the
+ * sized functions over strlen(str) bytes.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) with XXH3_VARIANT and
+ *   XXH3_CSTR_LINE_NUL(line, from)  index of the first zero byte at or after
+ *                                   `from` in the 64 bytes at `line`, or 64
+ *                                   if there is none; `line` need not be
+ *                                   aligned, loads must stay in those bytes
+ * defined. Emits `xxh3_64_cstr_<variant>` and `xxh3_128_cstr_<variant>`.
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_CSTR_H
+#define XXH3_VARIANTS_TEMPLATES_CSTR_H
+
+/* Smallest page size: a load within one such page cannot fault if any byte
+ * of it is part of the string */
+#define XXH3_CSTR_PAGE 4096
+
+/* Searches the string while it may still be at most XXH3_MIDSIZE_MAX bytes
+ * long, 64 bytes at a time: unaligned while those bytes lie in one page,
+ * else the rest of the aligned line. Returns nonzero once the terminator is
+ * found; *next is then the terminator, otherwise the first byte not yet
+ * searched, and *len = *next - str. */
+XXH_FORCE_INLINE int xxh3_cstr_head(const xxh_u8* str, const xxh_u8** next, size_t* len)
+{
+    const xxh_u8* p = str;
+    size_t nul;
+
+    do {
+        const xxh_u8* base;
+        if (((size_t)p & (XXH3_CSTR_PAGE - 1)) <= XXH3_CSTR_PAGE - 64) {
+            base = p;
+            nul  = XXH3_CSTR_LINE_NUL(base, 0);
+        } else {
+            base = (const xxh_u8*)((size_t)p & ~(size_t)63);
+            nul  = XXH3_CSTR_LINE_NUL(base, (size_t)(p - base));
+        }
+        p = base + nul;
+    } while (nul == 64 && (size_t)(p - str) <= XXH3_MIDSIZE_MAX);
+    *next = p;
+    *len  = (size_t)(p - str);
+    return nul < 64;
+}
+
+/* Finishes a string longer than XXH3_MIDSIZE_MAX after xxh3_cstr_head(),
+ * searching on from `next` in aligned lines:
+ * XXH3_hashLong_internal_loop() for the default secret size, where block n
+ * is accumulated as soon as str[(n + 1) * block_len] is known to be part of
+ * the string. Returns strlen(str). */
+XXH_FORCE_INLINE size_t xxh3_cstr_long(xxh_u64* XXH_RESTRICT acc, const xxh_u8* XXH_RESTRICT str,
+                                       const xxh_u8* next, size_t len, int found,
+                                       const xxh_u8* XXH_RESTRICT secret)
+{
+    size_t const secretSize        = XXH_SECRET_DEFAULT_SIZE;
+    size_t const nbStripesPerBlock = (secretSize - XXH_STRIPE_LEN) / XXH_SECRET_CONSUME_RATE;
+    size_t const block_len         = XXH_STRIPE_LEN * nbStripesPerBlock;
+    const xxh_u8* line = (const xxh_u8*)((size_t)next & ~(size_t)63);
+    size_t from = (size_t)(next - line);
+    size_t nb_blocks;
+    size_t n = 0;
+
+    while (!found) {
+        size_t const nul = XXH3_CSTR_LINE_NUL(line, from);
+        len   = (size_t)(line + nul - str);
+        found = nul < 64;
+        line += 64;
+        from  = 0;
+        if (!found && len > (n + 1) * block_len) {
+            XXH3_accumulate(acc, str + n * block_len, secret, nbStripesPerBlock);
+            XXH3_scrambleAcc(acc, secret + secretSize - XXH_STRIPE_LEN);
+            n++;
+        }
+    }
+    nb_blocks = (len - 1) / block_len;
+    for (; n < nb_blocks; n++) {
+        XXH3_accumulate(acc, str + n * block_len, secret, nbStripesPerBlock);
+        XXH3_scrambleAcc(acc, secret + secretSize - XXH_STRIPE_LEN);
+    }
+    {   size_t const done      = nb_blocks * block_len;
+        size_t const nbStripes = ((len - 1) - done) / XXH_STRIPE_LEN;
+        XXH3_accumulate(acc, str + done, secret, nbStripes);
+        XXH3_accumulate_512(acc, str + len - XXH_STRIPE_LEN,
+                            secret + secretSize - XXH_STRIPE_LEN - XXH_SECRET_LASTACC_START);
+    }
+    return len;
+}
+
+/* Returns the secret for `seed`, derived into `custom` unless seed == 0 */
+XXH_FORCE_INLINE const xxh_u8* xxh3_cstr_secret(xxh_u8* custom, XXH64_hash_t seed)
+{
+    if (seed == 0) {
+        return XXH3_kSecret;
+    }
+    XXH3_initCustomSecret(custom, seed);
+    return custom;
+}
+
+/* The long-string paths are kept out of line so that short strings do not
+ * set up accumulators and a secret on the stack */
+XXH_NO_INLINE XXH64_hash_t xxh3_cstr_64_long(const xxh_u8* str, const xxh_u8* next, size_t len,
+                                             int found, XXH64_hash_t seed, size_t* length)
+{
+    XXH_ALIGN(XXH_SEC_ALIGN) xxh_u8 custom[XXH_SECRET_DEFAULT_SIZE];
+    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+    const xxh_u8* const secret = xxh3_cstr_secret(custom, seed);
+
+    len = xxh3_cstr_long(acc, str, next, len, found, secret);
+    if (length != NULL) {
+        *length = len;
+    }
+    return XXH3_mergeAccs(acc, secret + XXH_SECRET_MERGEACCS_START, (xxh_u64)len * XXH_PRIME64_1);
+}
+
+XXH_NO_INLINE XXH128_hash_t xxh3_cstr_128_long(const xxh_u8* str, const xxh_u8* next, size_t len,
+                                               int found, XXH64_hash_t seed, size_t* length)
+{
+    XXH_ALIGN(XXH_SEC_ALIGN) xxh_u8 custom[XXH_SECRET_DEFAULT_SIZE];
+    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+    const xxh_u8* const secret = xxh3_cstr_secret(custom, seed);
+    XXH128_hash_t h128;
+
+    len = xxh3_cstr_long(acc, str, next, len, found, secret);
+    if (length != NULL) {
+        *length = len;
+    }
+    h128.low64  = XXH3_mergeAccs(acc, secret + XXH_SECRET_MERGEACCS_START,
+                                 (xxh_u64)len * XXH_PRIME64_1);
+    h128.high64 = XXH3_mergeAccs(acc, secret + XXH_SECRET_DEFAULT_SIZE
+                                          - sizeof(acc) - XXH_SECRET_MERGEACCS_START,
+                                 ~((xxh_u64)len * XXH_PRIME64_2));
+    return h128;
+}
+
+uint64_t XXH3_VARIANT_FN(xxh3_64_cstr)(const char* str, size_t* length, uint64_t seed)
+{
+    const xxh_u8* next;
+    size_t len;
+    int found;
+
+    XXH3_WRAPPER_GUARD({
+        if (str == NULL) {
+            if (length != NULL) {
+                *length = 0;
+            }
+            return 0;
+        }
+    });
+    found = xxh3_cstr_head((const xxh_u8*)str, &next, &len);
+    if (!found || len > XXH3_MIDSIZE_MAX) {
+        return xxh3_cstr_64_long((const xxh_u8*)str, next, len, found, seed, length);
+    }
+    if (length != NULL) {
+        *length = len;
+    }
+    return XXH3_64bits_withSeed(str, len, seed);
+}
+
+xxh3_128_t XXH3_VARIANT_FN(xxh3_128_cstr)(const char* str, size_t* length, uint64_t seed)
+{
+    const xxh_u8* next;
+    size_t len;
+    int found;
+
+    XXH3_WRAPPER_GUARD({
+        if (str == NULL) {
+            if (length != NULL) {
+                *length = 0;
+            }
+            return ((xxh3_128_t){0,0});
+        }
+    });
+    found = xxh3_cstr_head((const xxh_u8*)str, &next, &len);
+    if (!found || len > XXH3_MIDSIZE_MAX) {
+        return xxh128_to_xxh3(xxh3_cstr_128_long((const xxh_u8*)str, next, len, found, seed, length));
+    }
+    if (length != NULL) {
+        *length = len;
+    }
+    return xxh128_to_xxh3(XXH3_128bits_withSeed(str, len, seed));
+}
+
+#undef XXH3_CSTR_LINE_NUL
+#undef XXH3_CSTR_PAGE
+
+#endif /* XXH3_VARIANTS_TEMPLATES_CSTR_H */
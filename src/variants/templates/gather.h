@@ -0,0 +1,260 @@
+/* Strided 2D and field-gather hashing.
+ *
+ * The input is a logical byte string scattered in memory: `count` records
+ * `record_size` bytes apart, and in each record the fields[] byte ranges in
+ * list order. The result is xxh3_64_<variant>() of those bytes laid end to
+ * end, without building that string. Runs of contiguous bytes (a row, or
+ * adjacent fields merged) go straight to the variant's stripe loop. Only a
+ * stripe that straddles two runs is assembled, in a 64-byte buffer; fields of
+ * at most 16 bytes are instead packed a block at a time (see
+ * xxh3_gather_small()). Blocks are scrambled after every nbStripesPerBlock
+ * stripes, and the last stripe and the merge follow
+ * XXH3_hashLong_internal_loop(). A logical string of at most
+ * XXH3_MIDSIZE_MAX bytes, and the final stripe of a longer one, are gathered
+ * into a stack buffer.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) with XXH3_VARIANT defined. Emits
+ * `xxh3_64_strided2d_<variant>` and `xxh3_64_gather_<variant>`.
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_GATHER_H
+#define XXH3_VARIANTS_TEMPLATES_GATHER_H
+
+typedef struct {
+    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB];
+    XXH_ALIGN(64) xxh_u8 stripe[XXH_STRIPE_LEN];
+    const xxh_u8* secret;
+    size_t nbStripesPerBlock;
+    size_t inBlock;  /* stripes accumulated in the current block */
+    size_t left;     /* stripes still due before the last one */
+    size_t fill;     /* bytes in stripe[] */
+} xxh3_gather_state;
+
+XXH_FORCE_INLINE void xxh3_gather_advance(xxh3_gather_state* g, size_t nbStripes)
+{
+    g->inBlock += nbStripes;
+    g->left    -= nbStripes;
+    if (g->inBlock == g->nbStripesPerBlock) {
+        XXH3_scrambleAcc(g->acc, g->secret + XXH_SECRET_DEFAULT_SIZE - XXH_STRIPE_LEN);
+        g->inBlock = 0;
+    }
+}
+
+/* memcpy() for n <= 16 with fixed-size moves, two of them overlapping */
+XXH_FORCE_INLINE void xxh3_gather_copy16(xxh_u8* dst, const xxh_u8* src, size_t n)
+{
+    if (n >= 8) {
+        XXH_memcpy(dst, src, 8);
+        XXH_memcpy(dst + n - 8, src + n - 8, 8);
+    } else if (n >= 4) {
+        XXH_memcpy(dst, src, 4);
+        XXH_memcpy(dst + n - 4, src + n - 4, 4);
+    } else if (n > 0) {
+        dst[0]     = src[0];
+        dst[n / 2] = src[n / 2];
+        dst[n - 1] = src[n - 1];
+    }
+}
+
+/* Appends n logical bytes; bytes past the last regular stripe are ignored,
+ * the final stripe is gathered separately */
+XXH_FORCE_INLINE void xxh3_gather_feed(xxh3_gather_state* g, const xxh_u8* p, size_t n)
+{
+    while (n > 0 && g->left > 0) {
+        if (g->fill == 0 && n >= XXH_STRIPE_LEN) {
+            size_t k = n / XXH_STRIPE_LEN;
+            k = (k < g->left) ? k : g->left;
+            k = (k < g->nbStripesPerBlock - g->inBlock) ? k : g->nbStripesPerBlock - g->inBlock;
+            XXH3_accumulate(g->acc, p, g->secret + g->inBlock * XXH_SECRET_CONSUME_RATE, k);
+            xxh3_gather_advance(g, k);
+            p += k * XXH_STRIPE_LEN;
+            n -= k * XXH_STRIPE_LEN;
+        } else {
+            size_t const c = (n < XXH_STRIPE_LEN - g->fill) ? n : XXH_STRIPE_LEN - g->fill;
+            XXH_memcpy(g->stripe + g->fill, p, c);
+            g->fill += c;
+            p += c;
+            n -= c;
+            if (g->fill == XXH_STRIPE_LEN) {
+                XXH3_accumulate_512(g->acc, g->stripe,
+                                    g->secret + g->inBlock * XXH_SECRET_CONSUME_RATE);
+                xxh3_gather_advance(g, 1);
+                g->fill = 0;
+            }
+        }
+    }
+}
+
+/* Bytes in one block with the default secret */
+#define XXH3_GATHER_BLOCK_LEN \
+    ((XXH_SECRET_DEFAULT_SIZE - XXH_STRIPE_LEN) / XXH_SECRET_CONSUME_RATE * XXH_STRIPE_LEN)
+
+/* Feeds the records, from the start, when no field is longer than 16 bytes.
+ * Fields are packed with fixed-size moves into one block of stripes in L1,
+ * which is accumulated when full; a field that fills it spills into the 16
+ * bytes after it, which start the next block. Going a block at a time keeps
+ * the vector loads of a stripe well behind the narrow stores that built it. */
+XXH_FORCE_INLINE void xxh3_gather_small(xxh3_gather_state* g, const xxh_u8* records,
+                                        size_t record_size, size_t count,
+                                        const xxh3_field_t* fields, size_t nfields)
+{
+    XXH_ALIGN(64) xxh_u8 block[XXH3_GATHER_BLOCK_LEN + 16];
+    size_t fill = 0;
+    size_t r, i, k;
+
+    for (r = 0; r < count; r++) {
+        const xxh_u8* const rec = records + r * record_size;
+        XXH_PREFETCH(rec + record_size);
+        for (i = 0; i < nfields; i++) {
+            xxh3_gather_copy16(block + fill, rec + fields[i].offset, fields[i].length);
+            fill += fields[i].length;
+            if (fill >= XXH3_GATHER_BLOCK_LEN) {
+                k = (g->nbStripesPerBlock < g->left) ? g->nbStripesPerBlock : g->left;
+                XXH3_accumulate(g->acc, block, g->secret, k);
+                xxh3_gather_advance(g, k);
+                if (g->left == 0) {
+                    return;
+                }
+                fill -= XXH3_GATHER_BLOCK_LEN;
+                XXH_memcpy(block, block + XXH3_GATHER_BLOCK_LEN, 16);
+            }
+        }
+    }
+    k = fill / XXH_STRIPE_LEN;
+    k = (k < g->left) ? k : g->left;
+    XXH3_accumulate(g->acc, block, g->secret, k);
+    xxh3_gather_advance(g, k);
+}
+
+/* Length of the contiguous run of fields starting at fields[*i]; advances
+ * *i past it and sets *offset to its start */
+XXH_FORCE_INLINE size_t xxh3_gather_run(const xxh3_field_t* fields, size_t nfields,
+                                        size_t* i, size_t* offset)
+{
+    size_t len = fields[*i].length;
+    *offset = fields[*i].offset;
+    while (*i + 1 < nfields && fields[*i + 1].offset == *offset + len) {
+        len += fields[++*i].length;
+    }
+    ++*i;
+    return len;
+}
+
+/* Copies logical bytes [from, from + n) to dst; rec_len is the sum of the
+ * field lengths */
+static void xxh3_gather_copy(xxh_u8* dst, const xxh_u8* records, size_t record_size,
+                             const xxh3_field_t* fields, size_t nfields, size_t rec_len,
+                             size_t from, size_t n)
+{
+    size_t r    = from / rec_len;
+    size_t skip = from % rec_len;
+
+    while (n > 0) {
+        const xxh_u8* const rec = records + r * record_size;
+        size_t i;
+        for (i = 0; i < nfields && n > 0; i++) {
+            size_t c;
+            if (skip >= fields[i].length) {
+                skip -= fields[i].length;
+                continue;
+            }
+            c = fields[i].length - skip;
+            c = (c < n) ? c : n;
+            XXH_memcpy(dst, rec + fields[i].offset + skip, c);
+            dst += c;
+            n   -= c;
+            skip = 0;
+        }
+        r++;
+    }
+}
+
+static XXH64_hash_t xxh3_gather_64(const xxh_u8* records, size_t record_size, size_t count,
+                                   const xxh3_field_t* fields, size_t nfields, XXH64_hash_t seed)
+{
+    size_t rec_len = 0, max_field = 0;
+    size_t len, start, r, i;
+
+    for (i = 0; i < nfields; i++) {
+        rec_len  += fields[i].length;
+        max_field = (fields[i].length > max_field) ? fields[i].length : max_field;
+    }
+    len = rec_len * count;
+    if (len <= XXH3_MIDSIZE_MAX) {
+        xxh_u8 buf[XXH3_MIDSIZE_MAX];
+        if (len > 0) {
+            xxh3_gather_copy(buf, records, record_size, fields, nfields, rec_len, 0, len);
+        }
+        return XXH3_64bits_withSeed(buf, len, seed);
+    }
+    {   XXH_ALIGN(XXH_SEC_ALIGN) xxh_u8 custom[XXH_SECRET_DEFAULT_SIZE];
+        xxh3_gather_state g;
+        XXH_ALIGN(64) xxh_u8 last[XXH_STRIPE_LEN];
+        xxh_u64 const init[XXH_ACC_NB] = XXH3_INIT_ACC;
+
+        XXH_memcpy(g.acc, init, sizeof(g.acc));
+        g.secret = XXH3_kSecret;
+        if (seed != 0) {
+            XXH3_initCustomSecret(custom, seed);
+            g.secret = custom;
+        }
+        g.nbStripesPerBlock = (XXH_SECRET_DEFAULT_SIZE - XXH_STRIPE_LEN) / XXH_SECRET_CONSUME_RATE;
+        g.inBlock = 0;
+        g.left    = (len - 1) / XXH_STRIPE_LEN;
+        g.fill    = 0;
+
+        i = 0;
+        if (xxh3_gather_run(fields, nfields, &i, &start) == record_size && start == 0
+            && i == nfields) {
+            /* the records are one contiguous run */
+            xxh3_gather_feed(&g, records, len);
+        } else if (max_field <= 16) {
+            xxh3_gather_small(&g, records, record_size, count, fields, nfields);
+        } else {
+            for (r = 0; r < count && g.left > 0; r++) {
+                const xxh_u8* const rec = records + r * record_size;
+                XXH_PREFETCH(rec + record_size);
+                for (i = 0; i < nfields;) {
+                    size_t offset;
+                    size_t const n = xxh3_gather_run(fields, nfields, &i, &offset);
+                    xxh3_gather_feed(&g, rec + offset, n);
+                }
+            }
+        }
+        xxh3_gather_copy(last, records, record_size, fields, nfields, rec_len,
+                         len - XXH_STRIPE_LEN, XXH_STRIPE_LEN);
+        XXH3_accumulate_512(g.acc, last, g.secret + XXH_SECRET_DEFAULT_SIZE - XXH_STRIPE_LEN
+                                                  - XXH_SECRET_LASTACC_START);
+        return XXH3_mergeAccs(g.acc, g.secret + XXH_SECRET_MERGEACCS_START,
+                              (xxh_u64)len * XXH_PRIME64_1);
+    }
+}
+
+uint64_t XXH3_VARIANT_FN(xxh3_64_strided2d)(const void* base, size_t row_bytes, size_t rows,
+                                            size_t pitch, uint64_t seed)
+{
+    xxh3_field_t row;
+
+    XXH3_WRAPPER_GUARD({
+        if (base == NULL && row_bytes > 0 && rows > 0) {
+            return 0;
+        }
+    });
+    row.offset = 0;
+    row.length = row_bytes;
+    return xxh3_gather_64((const xxh_u8*)base, pitch, rows, &row, 1, seed);
+}
+
+uint64_t XXH3_VARIANT_FN(xxh3_64_gather)(const void* records, size_t record_size, size_t count,
+                                         const xxh3_field_t* fields, size_t nfields, uint64_t seed)
+{
+    XXH3_WRAPPER_GUARD({
+        if (count > 0 && nfields > 0 && (records == NULL || fields == NULL)) {
+            return 0;
+        }
+    });
+    return xxh3_gather_64((const xxh_u8*)records, record_size, count, fields, nfields, seed);
+}
+
+#undef XXH3_GATHER_BLOCK_LEN
+
+#endif /* XXH3_VARIANTS_TEMPLATES_GATHER_H */
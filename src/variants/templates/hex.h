@@ -0,0 +1,221 @@
+/* Batch canonical and hex encoding of XXH64 / XXH128 digests.
+ *
+ * The canonical form is the big-endian one of XXH64_canonicalFromHash() and
+ * XXH128_canonicalFromHash() (high64 first). Hex is the lowercase text of
+ * the canonical bytes, as xxhsum prints it: 16 characters per 64-bit digest
+ * and 32 per 128-bit digest, without separators or a terminator. Decoding
+ * accepts either case. Digests go 16 bytes (32 characters) at a time, i.e.
+ * two 64-bit or one 128-bit digest; an odd last 64-bit digest is padded.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) with XXH3_VARIANT defined, and
+ * optionally
+ *   XXH3_HEX_BSWAP(dst, src)  16 canonical bytes at dst from the two native
+ *                             uint64_t at src, or back (dst may equal src)
+ *   XXH3_HEX_ENCODE(dst, src) 32 lowercase hex characters at dst from the 16
+ *                             bytes at src
+ *   XXH3_HEX_DECODE(dst, src) 16 bytes at dst from the 32 hex characters at
+ *                             src; nonzero if all of them are hex digits
+ *                             (dst is written either way)
+ * defined; the defaults are scalar. Emits `xxh64_canonicalFromHash_n_<variant>`,
+ * `xxh128_canonicalFromHash_n_<variant>`, `xxh64_toHex_n_<variant>`,
+ * `xxh128_toHex_n_<variant>`, `xxh64_fromHex_n_<variant>` and
+ * `xxh128_fromHex_n_<variant>`.
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_HEX_H
+#define XXH3_VARIANTS_TEMPLATES_HEX_H
+
+XXH_FORCE_INLINE void xxh3_hex_bswap(xxh_u8* dst, const xxh_u8* src)
+{
+    xxh_u64 a = XXH_read64(src);
+    xxh_u64 b = XXH_read64(src + 8);
+    if (XXH_CPU_LITTLE_ENDIAN) {
+        a = XXH_swap64(a);
+        b = XXH_swap64(b);
+    }
+    XXH_memcpy(dst, &a, 8);
+    XXH_memcpy(dst + 8, &b, 8);
+}
+
+XXH_FORCE_INLINE void xxh3_hex_encode(xxh_u8* dst, const xxh_u8* src)
+{
+    static const char digits[] = "0123456789abcdef";
+    size_t i;
+    for (i = 0; i < 16; i++) {
+        dst[2 * i]     = (xxh_u8)digits[src[i] >> 4];
+        dst[2 * i + 1] = (xxh_u8)digits[src[i] & 0x0F];
+    }
+}
+
+/* Value of a hex digit, or a value above 15 for any other byte */
+XXH_FORCE_INLINE unsigned xxh3_hex_nibble(xxh_u8 c)
+{
+    unsigned const d = (unsigned)c - '0';
+    unsigned const l = ((unsigned)c | 0x20) - 'a';
+    return (d < 10) ? d : (l < 6) ? l + 10 : 16;
+}
+
+XXH_FORCE_INLINE int xxh3_hex_decode(xxh_u8* dst, const xxh_u8* src)
+{
+    unsigned bad = 0;
+    size_t i;
+    for (i = 0; i < 16; i++) {
+        unsigned const hi = xxh3_hex_nibble(src[2 * i]);
+        unsigned const lo = xxh3_hex_nibble(src[2 * i + 1]);
+        bad   |= hi | lo;
+        dst[i] = (xxh_u8)((hi << 4) | (lo & 0x0F));
+    }
+    return (bad >> 4) == 0;
+}
+
+#ifndef XXH3_HEX_BSWAP
+#  define XXH3_HEX_BSWAP(dst, src) xxh3_hex_bswap((dst), (src))
+#endif
+#ifndef XXH3_HEX_ENCODE
+#  define XXH3_HEX_ENCODE(dst, src) xxh3_hex_encode((dst), (src))
+#endif
+#ifndef XXH3_HEX_DECODE
+#  define XXH3_HEX_DECODE(dst, src) xxh3_hex_decode((dst), (src))
+#endif
+
+void XXH3_VARIANT_FN(xxh64_canonicalFromHash_n)(xxh64_canonical_t* dst, const uint64_t* hashes,
+                                                size_t n)
+{
+    xxh_u8* const       out = (xxh_u8*)dst;
+    const xxh_u8* const in  = (const xxh_u8*)hashes;
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (n > 0 && (dst == NULL || hashes == NULL)) {
+            return;
+        }
+    });
+    for (i = 0; i + 2 <= n; i += 2) {
+        XXH3_HEX_BSWAP(out + 8 * i, in + 8 * i);
+    }
+    if (i < n) {
+        xxh_u8 tmp[16] = { 0 };
+        XXH_memcpy(tmp, in + 8 * i, 8);
+        XXH3_HEX_BSWAP(tmp, tmp);
+        XXH_memcpy(out + 8 * i, tmp, 8);
+    }
+}
+
+void XXH3_VARIANT_FN(xxh128_canonicalFromHash_n)(xxh128_canonical_t* dst, const xxh3_128_t* hashes,
+                                                 size_t n)
+{
+    xxh_u8* const       out = (xxh_u8*)dst;
+    const xxh_u8* const in  = (const xxh_u8*)hashes;
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (n > 0 && (dst == NULL || hashes == NULL)) {
+            return;
+        }
+    });
+    /* xxh3_128_t is { high, low }: each half swapped gives high64 first */
+    for (i = 0; i < n; i++) {
+        XXH3_HEX_BSWAP(out + 16 * i, in + 16 * i);
+    }
+}
+
+void XXH3_VARIANT_FN(xxh64_toHex_n)(char* dst, const uint64_t* hashes, size_t n)
+{
+    xxh_u8* const       out = (xxh_u8*)dst;
+    const xxh_u8* const in  = (const xxh_u8*)hashes;
+    xxh_u8 tmp[16] = { 0 };
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (n > 0 && (dst == NULL || hashes == NULL)) {
+            return;
+        }
+    });
+    for (i = 0; i + 2 <= n; i += 2) {
+        XXH3_HEX_BSWAP(tmp, in + 8 * i);
+        XXH3_HEX_ENCODE(out + 16 * i, tmp);
+    }
+    if (i < n) {
+        xxh_u8 text[32];
+        XXH_memcpy(tmp, in + 8 * i, 8);
+        XXH3_HEX_BSWAP(tmp, tmp);
+        XXH3_HEX_ENCODE(text, tmp);
+        XXH_memcpy(out + 16 * i, text, 16);
+    }
+}
+
+void XXH3_VARIANT_FN(xxh128_toHex_n)(char* dst, const xxh3_128_t* hashes, size_t n)
+{
+    xxh_u8* const       out = (xxh_u8*)dst;
+    const xxh_u8* const in  = (const xxh_u8*)hashes;
+    xxh_u8 tmp[16];
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (n > 0 && (dst == NULL || hashes == NULL)) {
+            return;
+        }
+    });
+    for (i = 0; i < n; i++) {
+        XXH3_HEX_BSWAP(tmp, in + 16 * i);
+        XXH3_HEX_ENCODE(out + 32 * i, tmp);
+    }
+}
+
+size_t XXH3_VARIANT_FN(xxh64_fromHex_n)(uint64_t* hashes, const char* src, size_t n)
+{
+    xxh_u8* const       out = (xxh_u8*)hashes;
+    const xxh_u8* const in  = (const xxh_u8*)src;
+    xxh_u8 tmp[16];
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (n > 0 && (hashes == NULL || src == NULL)) {
+            return 0;
+        }
+    });
+    for (i = 0; i + 2 <= n; i += 2) {
+        if (!XXH3_HEX_DECODE(tmp, in + 16 * i)) {
+            break;
+        }
+        XXH3_HEX_BSWAP(out + 8 * i, tmp);
+    }
+    /* an odd last digest, or the pair that failed, one digest at a time */
+    for (; i < n; i++) {
+        xxh_u8 text[32];
+        XXH_memcpy(text, in + 16 * i, 16);
+        memset(text + 16, '0', 16);
+        if (!XXH3_HEX_DECODE(tmp, text)) {
+            return i;
+        }
+        XXH3_HEX_BSWAP(tmp, tmp);
+        XXH_memcpy(out + 8 * i, tmp, 8);
+    }
+    return n;
+}
+
+size_t XXH3_VARIANT_FN(xxh128_fromHex_n)(xxh3_128_t* hashes, const char* src, size_t n)
+{
+    xxh_u8* const       out = (xxh_u8*)hashes;
+    const xxh_u8* const in  = (const xxh_u8*)src;
+    xxh_u8 tmp[16];
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (n > 0 && (hashes == NULL || src == NULL)) {
+            return 0;
+        }
+    });
+    for (i = 0; i < n; i++) {
+        if (!XXH3_HEX_DECODE(tmp, in + 32 * i)) {
+            return i;
+        }
+        XXH3_HEX_BSWAP(out + 16 * i, tmp);
+    }
+    return n;
+}
+
+#undef XXH3_HEX_BSWAP
+#undef XXH3_HEX_ENCODE
+#undef XXH3_HEX_DECODE
+
+#endif /* XXH3_VARIANTS_TEMPLATES_HEX_H */
@@ -0,0 +1,119 @@
+/* HyperLogLog sketches: adding keys and merging registers.
+ *
+ * Keys are hashed with xxh3_64_<variant>() under the sketch's seed. In a
+ * dense sketch the top p bits of the hash pick a register and the rank is
+ * the number of leading zeros of the remaining bits, plus one; a register
+ * keeps the largest rank it has seen (see src/xxh3_hll_internal.h). Sparse
+ * sketches go through src/xxh3_hll.c. The batch form hashes a group of
+ * keys, then ranks them 8 at a time, and merging takes the bytewise maximum
+ * of two register arrays.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) with XXH3_VARIANT defined, and
+ * optionally
+ *   XXH3_HLL_RANK8(ranks, hashes, p)  ranks[j] = xxh3_hll_rank(hashes[j], p)
+ *                                     for j < 8 (xxh_u8 ranks[8])
+ *   XXH3_HLL_MAX(dst, src, n)         dst[i] = max(dst[i], src[i]) for
+ *                                     i < n, a multiple of 16
+ * defined; the defaults are scalar. Emits `xxh3_hll_add_<variant>`,
+ * `xxh3_hll_add_batch_<variant>` and `xxh3_hll_merge_<variant>`.
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_HLL_H
+#define XXH3_VARIANTS_TEMPLATES_HLL_H
+
+/* Keys hashed ahead of their register updates in the batch form */
+#define XXH3_HLL_GROUP 16
+
+XXH_FORCE_INLINE void xxh3_hll_rank8(xxh_u8* ranks, const xxh_u64* hashes, unsigned p)
+{
+    size_t j;
+    for (j = 0; j < 8; j++) {
+        ranks[j] = (xxh_u8)xxh3_hll_rank(hashes[j], p);
+    }
+}
+
+XXH_FORCE_INLINE void xxh3_hll_max(xxh_u8* dst, const xxh_u8* src, size_t n)
+{
+    size_t i;
+    for (i = 0; i < n; i++) {
+        dst[i] = (src[i] > dst[i]) ? src[i] : dst[i];
+    }
+}
+
+#ifndef XXH3_HLL_RANK8
+#  define XXH3_HLL_RANK8(ranks, hashes, p) xxh3_hll_rank8((ranks), (hashes), (p))
+#endif
+#ifndef XXH3_HLL_MAX
+#  define XXH3_HLL_MAX(dst, src, n) xxh3_hll_max((dst), (src), (n))
+#endif
+
+int XXH3_VARIANT_FN(xxh3_hll_add)(xxh3_hll_t* hll, const void* key, size_t size)
+{
+    XXH3_WRAPPER_GUARD({
+        if (hll == NULL || (key == NULL && size > 0)) {
+            return XXH3_ERROR;
+        }
+    });
+    return xxh3_hll_add_hash(hll, XXH3_64bits_withSeed(key, size, hll->seed));
+}
+
+int XXH3_VARIANT_FN(xxh3_hll_add_batch)(xxh3_hll_t* hll, const void* const* inputs,
+                                        const size_t* sizes, size_t count)
+{
+    xxh_u64 h[XXH3_HLL_GROUP];
+    xxh_u8  ranks[XXH3_HLL_GROUP];
+    size_t  i, j;
+
+    XXH3_WRAPPER_GUARD({
+        if (hll == NULL || (count > 0 && (inputs == NULL || sizes == NULL))) {
+            return XXH3_ERROR;
+        }
+    });
+    for (i = 0; i < count; i += XXH3_HLL_GROUP) {
+        size_t const n = (count - i < XXH3_HLL_GROUP) ? count - i : XXH3_HLL_GROUP;
+        for (j = 0; j < n; j++) {
+            h[j] = XXH3_64bits_withSeed(inputs[i + j], sizes[i + j], hll->seed);
+        }
+        if (hll->registers == NULL) {
+            if (xxh3_hll_add_sparse(hll, h, n) != XXH3_OK) {
+                return XXH3_ERROR;
+            }
+            continue;
+        }
+        for (j = 0; j + 8 <= n; j += 8) {
+            XXH3_HLL_RANK8(ranks + j, h + j, hll->p);
+        }
+        for (; j < n; j++) {
+            ranks[j] = (xxh_u8)xxh3_hll_rank(h[j], hll->p);
+        }
+        for (j = 0; j < n; j++) {
+            xxh_u8* const r = hll->registers + (h[j] >> (64 - hll->p));
+            *r = (ranks[j] > *r) ? ranks[j] : *r;
+        }
+    }
+    return XXH3_OK;
+}
+
+int XXH3_VARIANT_FN(xxh3_hll_merge)(xxh3_hll_t* dst, const xxh3_hll_t* src)
+{
+    XXH3_WRAPPER_GUARD({
+        if (dst == NULL || src == NULL) {
+            return XXH3_ERROR;
+        }
+    });
+    if (dst->p != src->p || dst->seed != src->seed) {
+        return XXH3_ERROR;
+    }
+    if (src->registers == NULL) {
+        return xxh3_hll_merge_sparse(dst, src);
+    }
+    if (dst->registers == NULL && xxh3_hll_to_dense(dst) != XXH3_OK) {
+        return XXH3_ERROR;
+    }
+    XXH3_HLL_MAX(dst->registers, src->registers, (size_t)1 << dst->p);
+    return XXH3_OK;
+}
+
+#undef XXH3_HLL_RANK8
+#undef XXH3_HLL_MAX
+
+#endif /* XXH3_VARIANTS_TEMPLATES_HLL_H */
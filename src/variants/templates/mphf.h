@@ -0,0 +1,70 @@
+/* Minimal perfect hash functions: building and looking up keys.
+ *
+ * Keys are hashed with xxh3_64_<variant>() under the function's seed; the
+ * builder (src/xxh3_mphf.c) places the hashes and the lookup follows them
+ * to their index with the arithmetic of src/xxh3_mphf_internal.h: one pilot
+ * read, and a remap read for the keys placed past n. The batch lookup
+ * hashes a group of keys and prefetches their pilots before reading any.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) with XXH3_VARIANT defined. Emits
+ * `xxh3_mphf_build_<variant>`, `xxh3_mphf_lookup_<variant>` and
+ * `xxh3_mphf_lookup_batch_<variant>`.
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_MPHF_H
+#define XXH3_VARIANTS_TEMPLATES_MPHF_H
+
+/* Keys hashed and prefetched ahead of their lookups in the batch form */
+#define XXH3_MPHF_GROUP 16
+
+static void XXH3_VARIANT_FN(xxh3_mphf_hash)(uint64_t* out, const void* const* inputs,
+                                            const size_t* sizes, size_t count, uint64_t seed)
+{
+    size_t i;
+    for (i = 0; i < count; i++) {
+        out[i] = XXH3_64bits_withSeed(inputs[i], sizes[i], seed);
+    }
+}
+
+int XXH3_VARIANT_FN(xxh3_mphf_build)(void* dst, size_t dst_size, const void* const* inputs,
+                                     const size_t* sizes, size_t n, uint64_t seed,
+                                     unsigned threads)
+{
+    return xxh3_mphf_build_with(dst, dst_size, inputs, sizes, n, seed, threads,
+                                XXH3_VARIANT_FN(xxh3_mphf_hash));
+}
+
+uint64_t XXH3_VARIANT_FN(xxh3_mphf_lookup)(const xxh3_mphf_t* mphf, const void* key, size_t size)
+{
+    XXH3_WRAPPER_GUARD({
+        if (mphf == NULL || (key == NULL && size > 0)) {
+            return 0;
+        }
+    });
+    return xxh3_mphf_index(mphf, XXH3_64bits_withSeed(key, size, mphf->seed));
+}
+
+void XXH3_VARIANT_FN(xxh3_mphf_lookup_batch)(const xxh3_mphf_t* mphf, const void* const* inputs,
+                                             const size_t* sizes, size_t count, uint64_t* out)
+{
+    xxh_u64 h[XXH3_MPHF_GROUP];
+    size_t  i, j;
+
+    XXH3_WRAPPER_GUARD({
+        if (mphf == NULL || (count > 0 && (inputs == NULL || sizes == NULL || out == NULL))) {
+            return;
+        }
+    });
+    for (i = 0; i < count; i += XXH3_MPHF_GROUP) {
+        size_t const n = (count - i < XXH3_MPHF_GROUP) ? count - i : XXH3_MPHF_GROUP;
+        for (j = 0; j < n; j++) {
+            h[j] = XXH3_64bits_withSeed(inputs[i + j], sizes[i + j], mphf->seed);
+            XXH_PREFETCH(mphf->pilots + 2 * (xxh3_mphf_partition(mphf, h[j]) * mphf->buckets
+                                             + xxh3_mphf_bucket(mphf, h[j])));
+        }
+        for (j = 0; j < n; j++) {
+            out[i + j] = xxh3_mphf_index(mphf, h[j]);
+        }
+    }
+}
+
+#endif /* XXH3_VARIANTS_TEMPLATES_MPHF_H */
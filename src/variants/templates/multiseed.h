@@ -0,0 +1,129 @@
+/* Multi-seed XXH3-64: one input, k seeds.
+ *
+ * For inputs of 9-240 bytes the seed only enters XXH3 after the input words
+ * are read: each 16-byte block contributes
+ *   mul128_fold64(in_lo ^ (sec_lo + seed), in_hi ^ (sec_hi - seed))
+ * with fixed secret words. The blocks are read and paired with their secret
+ * words once; the per-seed part then runs for XXH3_MS_LANES seeds at a time.
+ * The 0-8 byte paths, the seeds left over after the last full vector, and
+ * inputs above 240 bytes (where every seed derives its own secret) hash once
+ * per seed with the vendor code; after the first seed the input is
+ * cache-resident. Results are bit-identical to XXH3_64bits_withSeed().
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) with XXH3_VARIANT defined. For the
+ * SIMD path also define all of
+ *   XXH3_MS_LANES          seeds per call of the hooks below (may be a
+ *                          run-time expression such as svcntd())
+ *   XXH3_MS_9TO16_LANES    void f(xxh_u64* out, const xxh_u64* seeds, size_t len,
+ *                                 const xxh_u64 blk[4])
+ *   XXH3_MS_17TO240_LANES  void f(xxh_u64* out, const xxh_u64* seeds, size_t len,
+ *                                 const xxh_u64 (*blk)[4], size_t nbFirst, size_t nbBlocks)
+ * where blk[i] = { in_lo, in_hi, sec_lo, sec_hi }. The 9-16 byte path is a
+ * single block whose secret words are the two bitflips. For 129-240 bytes
+ * the first nbFirst blocks are avalanched before the rest are added.
+ * Without them every seed takes the vendor path: a scalar block loop
+ * measured slower than the vendor's unrolled 17-128 byte code.
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_MULTISEED_H
+#define XXH3_VARIANTS_TEMPLATES_MULTISEED_H
+
+/* 129-240 bytes: 8 head blocks, the last block and up to 7 more */
+#define XXH3_MS_MAX_BLOCKS 16
+
+XXH_FORCE_INLINE void xxh3_ms_block(xxh_u64* b, const xxh_u8* in, const xxh_u8* sec)
+{
+    b[0] = XXH_readLE64(in);
+    b[1] = XXH_readLE64(in + 8);
+    b[2] = XXH_readLE64(sec);
+    b[3] = XXH_readLE64(sec + 8);
+}
+
+/* The 17-240 byte blocks in the vendor's pairing with the secret; returns
+ * the number of blocks. The sum is order-independent, only the split at
+ * *nbFirst matters. */
+XXH_FORCE_INLINE size_t xxh3_ms_blocks(xxh_u64 (*blk)[4], const xxh_u8* in, size_t len, size_t* nbFirst)
+{
+    const xxh_u8* const secret = XXH3_kSecret;
+    size_t n = 0;
+    size_t i;
+
+    if (len <= 128) {
+        size_t const rounds = (len - 1) / 32 + 1;
+        for (i = 0; i < rounds; i++) {
+            xxh3_ms_block(blk[n++], in + 16 * i, secret + 32 * i);
+            xxh3_ms_block(blk[n++], in + len - 16 * (i + 1), secret + 32 * i + 16);
+        }
+        *nbFirst = n;
+        return n;
+    }
+    for (i = 0; i < 8; i++) {
+        xxh3_ms_block(blk[n++], in + 16 * i, secret + 16 * i);
+    }
+    *nbFirst = n;
+    xxh3_ms_block(blk[n++], in + len - 16, secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET);
+    for (i = 8; i < len / 16; i++) {
+        xxh3_ms_block(blk[n++], in + 16 * i, secret + 16 * (i - 8) + XXH3_MIDSIZE_STARTOFFSET);
+    }
+    return n;
+}
+
+#endif /* XXH3_VARIANTS_TEMPLATES_MULTISEED_H */
+
+void XXH3_VARIANT_FN(xxh3_64_multiseed)(const void* input, size_t size,
+                                        const uint64_t* seeds, size_t k, uint64_t* out)
+{
+    size_t j = 0;
+
+    XXH3_WRAPPER_GUARD({
+        if (k > 0 && (seeds == NULL || out == NULL || (input == NULL && size > 0))) {
+            return;
+        }
+    });
+
+#ifdef XXH3_MS_LANES
+    {   const xxh_u8* const in = (const xxh_u8*)input;
+        if (size > 8 && size <= 16) {
+            xxh_u64 blk[4];
+            blk[0] = XXH_readLE64(in);
+            blk[1] = XXH_readLE64(in + size - 8);
+            blk[2] = XXH_readLE64(XXH3_kSecret + 24) ^ XXH_readLE64(XXH3_kSecret + 32);
+            blk[3] = XXH_readLE64(XXH3_kSecret + 40) ^ XXH_readLE64(XXH3_kSecret + 48);
+            for (; j + XXH3_MS_LANES <= k; j += XXH3_MS_LANES) {
+                XXH3_MS_9TO16_LANES(out + j, seeds + j, size, blk);
+            }
+        } else if (size > 16 && size <= XXH3_MIDSIZE_MAX) {
+            xxh_u64 blk[XXH3_MS_MAX_BLOCKS][4];
+            size_t nbFirst;
+            size_t const nbBlocks = xxh3_ms_blocks(blk, in, size, &nbFirst);
+            for (; j + XXH3_MS_LANES <= k; j += XXH3_MS_LANES) {
+                XXH3_MS_17TO240_LANES(out + j, seeds + j, size,
+                                      (const xxh_u64 (*)[4])blk, nbFirst, nbBlocks);
+            }
+        }
+    }
+#endif
+    for (; j < k; j++) {
+        out[j] = XXH3_64bits_withSeed(input, size, seeds[j]);
+    }
+}
+
+/* out[i * k + j] = hash of inputs[i] under seeds[j] */
+void XXH3_VARIANT_FN(xxh3_64_multiseed_batch)(const void* const* inputs, const size_t* sizes,
+                                              size_t count, const uint64_t* seeds, size_t k,
+                                              uint64_t* out)
+{
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (count > 0 && (inputs == NULL || sizes == NULL)) {
+            return;
+        }
+    });
+    for (i = 0; i < count; i++) {
+        XXH3_VARIANT_FN(xxh3_64_multiseed)(inputs[i], sizes[i], seeds, k, out + i * k);
+    }
+}
+
+#undef XXH3_MS_LANES
+#undef XXH3_MS_9TO16_LANES
+#undef XXH3_MS_17TO240_LANES
@@ -0,0 +1,56 @@
+/* Multiset hashes: adding and removing keys.
+ *
+ * A key contributes its XXH3-128 hash under the set's seed, added or
+ * subtracted modulo 2^128 (see src/xxh3_multiset.c), so the digest does not
+ * depend on the order of the updates. The batch form sums the hashes of
+ * its keys locally and folds the total into the set once.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) with XXH3_VARIANT defined. Emits
+ * `xxh3_multiset_add_<variant>`, `xxh3_multiset_remove_<variant>` and
+ * `xxh3_multiset_add_batch_<variant>`.
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_MULTISET_H
+#define XXH3_VARIANTS_TEMPLATES_MULTISET_H
+
+void XXH3_VARIANT_FN(xxh3_multiset_add)(xxh3_multiset_t* set, const void* key, size_t size)
+{
+    XXH3_WRAPPER_GUARD({
+        if (set == NULL || (key == NULL && size > 0)) {
+            return;
+        }
+    });
+    xxh3_multiset_add_hash(set, xxh128_to_xxh3(XXH3_128bits_withSeed(key, size, set->seed)));
+}
+
+void XXH3_VARIANT_FN(xxh3_multiset_remove)(xxh3_multiset_t* set, const void* key, size_t size)
+{
+    XXH3_WRAPPER_GUARD({
+        if (set == NULL || (key == NULL && size > 0)) {
+            return;
+        }
+    });
+    xxh3_multiset_remove_hash(set, xxh128_to_xxh3(XXH3_128bits_withSeed(key, size, set->seed)));
+}
+
+void XXH3_VARIANT_FN(xxh3_multiset_add_batch)(xxh3_multiset_t* set, const void* const* inputs,
+                                              const size_t* sizes, size_t count)
+{
+    xxh3_128_t sum;
+    size_t     i;
+
+    XXH3_WRAPPER_GUARD({
+        if (set == NULL || (count > 0 && (inputs == NULL || sizes == NULL))) {
+            return;
+        }
+    });
+    sum.high = 0;
+    sum.low  = 0;
+    for (i = 0; i < count; i++) {
+        XXH128_hash_t const h = XXH3_128bits_withSeed(inputs[i], sizes[i], set->seed);
+        sum.low += h.low64;
+        sum.high += h.high64 + (sum.low < h.low64);
+    }
+    xxh3_multiset_add_hash(set, sum);
+}
+
+#endif /* XXH3_VARIANTS_TEMPLATES_MULTISET_H */
@@ -0,0 +1,80 @@
+/* Lockstep update of many XXH3 streams.
+ *
+ * A proxy that keeps one stream per connection calls update once per packet:
+ * every call starts with cache misses on the handle, on the vendor state
+ * behind it and on the buffer line being appended to, and the misses of
+ * consecutive calls are serialised by the call boundaries. Here updates are
+ * taken XXH3_MULTI_CHUNK at a time in three passes, each of which only
+ * issues independent loads or prefetches, so the misses of a chunk overlap:
+ *   1. resolve the vendor states; prefetch their control fields and acc
+ *   2. prefetch the buffer line at bufferedSize and the first input lines
+ *   3. run the regular XXH3 update with this variant's stripe kernel
+ * One state already fills whole vectors (8 x 64-bit accumulators), so the
+ * states are not spread across lanes; the stripe loop itself is the
+ * variant's. Each stream ends up exactly as after its own xxh3_64_update().
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) and xxh3_state_internal.h, with
+ * XXH3_VARIANT defined. Emits `xxh3_64_update_multi_<variant>` and
+ * `xxh3_128_update_multi_<variant>`.
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_MULTISTREAM_H
+#define XXH3_VARIANTS_TEMPLATES_MULTISTREAM_H
+
+/* Updates in flight; 16 states are about 9 KiB of L1 */
+#define XXH3_MULTI_CHUNK 16
+/* Input bytes prefetched per update; the hardware prefetcher takes over
+ * on longer packets */
+#define XXH3_MULTI_INPUT_HEAD 256
+
+int XXH3_VARIANT_FN(xxh3_64_update_multi)(const xxh3_stream_update_t* updates, size_t count)
+{
+    XXH3_state_t* vstate[XXH3_MULTI_CHUNK];
+    size_t base, n, i;
+
+    XXH3_WRAPPER_GUARD({
+        if (updates == NULL && count > 0) {
+            return XXH3_ERROR;
+        }
+        for (i = 0; i < count; i++) {
+            if (xxh3_vendorState(updates[i].state) == NULL
+                || (updates[i].input == NULL && updates[i].size > 0)) {
+                return XXH3_ERROR;
+            }
+        }
+    });
+
+    for (base = 0; base < count; base += n) {
+        const xxh3_stream_update_t* const u = updates + base;
+        n = (count - base < XXH3_MULTI_CHUNK) ? count - base : XXH3_MULTI_CHUNK;
+
+        for (i = 0; i < n; i++) {
+            vstate[i] = (XXH3_state_t*)xxh3_vendorState(u[i].state);
+            XXH_PREFETCH(&vstate[i]->bufferedSize);
+            XXH_PREFETCH(vstate[i]->acc);
+        }
+        for (i = 0; i < n; i++) {
+            size_t const head = (u[i].size < XXH3_MULTI_INPUT_HEAD) ? u[i].size
+                                                                   : XXH3_MULTI_INPUT_HEAD;
+            size_t off;
+            XXH_PREFETCH(vstate[i]->buffer + vstate[i]->bufferedSize);
+            for (off = 0; off < head; off += 64) {
+                XXH_PREFETCH((const xxh_u8*)u[i].input + off);
+            }
+        }
+        for (i = 0; i < n; i++) {
+            (void)XXH3_64bits_update(vstate[i], (const xxh_u8*)u[i].input, u[i].size);
+        }
+    }
+    return XXH3_OK;
+}
+
+int XXH3_VARIANT_FN(xxh3_128_update_multi)(const xxh3_stream_update_t* updates, size_t count)
+{
+    /* XXH3 64- and 128-bit streams share the same update routine */
+    return XXH3_VARIANT_FN(xxh3_64_update_multi)(updates, count);
+}
+
+#undef XXH3_MULTI_CHUNK
+#undef XXH3_MULTI_INPUT_HEAD
+
+#endif /* XXH3_VARIANTS_TEMPLATES_MULTISTREAM_H */
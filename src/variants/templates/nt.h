@@ -0,0 +1,72 @@
+/* Non-temporal (cache-bypassing) XXH3 kernels.
+ *
+ * For inputs much larger than the LLC, the regular stripe loop prefetches
+ * with a T0 hint and leaves the whole input in every cache level, evicting
+ * the working set of whatever else runs on the socket. The loop below issues
+ * XXH3_PREFETCH_NT (`prefetchnta` / `PRFM PLDL1STRM`) instead and otherwise
+ * reuses the vendor's accumulate, scramble and merge steps, so digests are
+ * bit-identical to the regular variants.
+ *
+ * Inputs of at most XXH3_MIDSIZE_MAX bytes take the regular path: they fit
+ * in a few cache lines and there is nothing to bypass.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL). With XXH3_VARIANT defined this
+ * also emits the public `xxh3_64_nt_<variant>` / `xxh3_128_nt_<variant>`;
+ * without it only the stripe loop is provided (used by the streaming API).
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_NT_H
+#define XXH3_VARIANTS_TEMPLATES_NT_H
+
+XXH_FORCE_INLINE void
+xxh3_accumulate_nt(xxh_u64* XXH_RESTRICT acc,
+                   const xxh_u8* XXH_RESTRICT input,
+                   const xxh_u8* XXH_RESTRICT secret,
+                   size_t nbStripes)
+{
+#if (XXH_VECTOR == XXH_SVE)
+    /* The vendor SVE loop already prefetches with SV_PLDL1STRM and keeps the
+     * accumulators in registers across stripes; reuse it as-is. */
+    XXH3_accumulate(acc, input, secret, nbStripes);
+#else
+    size_t n;
+    for (n = 0; n < nbStripes; n++) {
+        const xxh_u8* const in = input + n * XXH_STRIPE_LEN;
+        XXH3_PREFETCH_NT(in + XXH3_NT_PREFETCH_DIST);
+        XXH3_accumulate_512(acc, in, secret + n * XXH_SECRET_CONSUME_RATE);
+    }
+#endif
+}
+
+#ifdef XXH3_VARIANT
+
+uint64_t XXH3_VARIANT_FN(xxh3_64_nt)(const void* input, size_t size, uint64_t seed)
+{
+    XXH3_WRAPPER_GUARD({
+        if (input == NULL && size > 0) {
+            return 0;
+        }
+    });
+    if (size <= XXH3_MIDSIZE_MAX) {
+        return XXH3_64bits_withSeed(input, size, seed);
+    }
+    return XXH3_hashLong_64b_withSeed_internal(input, size, seed,
+                xxh3_accumulate_nt, XXH3_scrambleAcc, XXH3_initCustomSecret);
+}
+
+xxh3_128_t XXH3_VARIANT_FN(xxh3_128_nt)(const void* input, size_t size, uint64_t seed)
+{
+    XXH3_WRAPPER_GUARD({
+        if (input == NULL && size > 0) {
+            return ((xxh3_128_t){0,0});
+        }
+    });
+    if (size <= XXH3_MIDSIZE_MAX) {
+        return xxh128_to_xxh3(XXH3_128bits_withSeed(input, size, seed));
+    }
+    return xxh128_to_xxh3(XXH3_hashLong_128b_withSeed_internal(input, size, seed,
+                xxh3_accumulate_nt, XXH3_scrambleAcc, XXH3_initCustomSecret));
+}
+
+#endif /* XXH3_VARIANT */
+
+#endif /* XXH3_VARIANTS_TEMPLATES_NT_H */
@@ -0,0 +1,223 @@
+/* Hash partitioning: the count and scatter passes of one thread.
+ *
+ * Both passes hash the rows of their range a block at a time with
+ * xxh3_64_<variant>(); rehashing in the scatter pass is cheaper than
+ * writing the hashes out and reading them back for the short keys joins
+ * are on. With non-temporal stores, the scatter pass does not write a
+ * tuple straight to its partition: 2^bits destinations at once would take
+ * a TLB miss and a read-for-ownership per tuple. Each partition has instead
+ * a 64-byte line of four tuples in `scratch`, laid out like the line of dst
+ * it will fill, and the line goes out with non-temporal stores once full.
+ * A line that dst shares with another thread or partition, at either end
+ * of the thread's run, is written tuple by tuple with regular stores.
+ * Without non-temporal stores, or with a dst not aligned to tuples, the
+ * lines only add a copy to the read-for-ownership, and tuples are stored
+ * straight to dst; so they are with few partitions.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) and xxh3_partition_internal.h,
+ * with XXH3_VARIANT defined and optionally
+ *   XXH3_PARTITION_NT_LINE(dst, src)  copy 64 bytes to a 64-byte aligned
+ *                                     dst with non-temporal stores
+ *   XXH3_PARTITION_NT_FENCE()         order those stores before returning
+ *   XXH3_PARTITION_HASH8(out, keys, bitflip)
+ *                                     xxh3_64_<variant>() of the eight
+ *                                     8-byte keys at `keys`, `bitflip`
+ *                                     being the seeded secret of the 4-8
+ *                                     byte path (see xxh3_partition_hash8())
+ * Without them tuples are stored straight to dst and keys are hashed one at
+ * a time. Emits `xxh3_partition_<variant>` and `xxh3_partition_var_<variant>`.
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_PARTITION_H
+#define XXH3_VARIANTS_TEMPLATES_PARTITION_H
+
+/* Rows hashed ahead of their counting or scattering */
+#define XXH3_PARTITION_BLOCK 64
+
+/* Fewest bits for which lines pay: below 2^7 partitions the destinations
+ * stay in the L1 DTLB and direct stores were up to 1.5x faster */
+#define XXH3_PARTITION_WC_BITS 7
+
+/* XXH3_len_4to8_64b() of an 8-byte key, `bitflip` being
+ * (secret[8..16) ^ secret[16..24)) - (seed ^ swap32(seed) << 32) */
+XXH_FORCE_INLINE xxh_u64 xxh3_partition_hash8(const xxh_u8* key, xxh_u64 bitflip)
+{
+    xxh_u64 const input64 = XXH_readLE32(key + 4) + ((xxh_u64)XXH_readLE32(key) << 32);
+    return XXH3_rrmxmx(input64 ^ bitflip, 8);
+}
+
+/* Hashes rows [i, i + m) into h[0..m) */
+XXH_FORCE_INLINE void xxh3_partition_hash_rows(const xxh3_partition_src_t* src, size_t i, size_t m,
+                                               xxh_u64* h)
+{
+    size_t j = 0;
+
+    if (src->keys == NULL) {
+        for (; j < m; j++) {
+            h[j] = XXH3_64bits_withSeed(src->inputs[i + j], src->sizes[i + j], src->seed);
+        }
+    } else if (src->key_size == 8) {
+        const xxh_u8* const keys = src->keys + 8 * i;
+        xxh_u64 const bitflip = (XXH_readLE64(XXH3_kSecret + 8) ^ XXH_readLE64(XXH3_kSecret + 16))
+                              - (src->seed ^ ((xxh_u64)XXH_swap32((xxh_u32)src->seed) << 32));
+#ifdef XXH3_PARTITION_HASH8
+        for (; j + 8 <= m; j += 8) {
+            XXH3_PARTITION_HASH8(h + j, keys + 8 * j, bitflip);
+        }
+#endif
+        for (; j < m; j++) {
+            h[j] = xxh3_partition_hash8(keys + 8 * j, bitflip);
+        }
+    } else {
+        for (; j < m; j++) {
+            h[j] = XXH3_64bits_withSeed(src->keys + (i + j) * src->key_size, src->key_size, src->seed);
+        }
+    }
+}
+
+#ifdef XXH3_PARTITION_NT_LINE
+/* Writes dst[from, to) from `line`, which holds dst[start, start + 4) */
+XXH_FORCE_INLINE void xxh3_partition_flush(xxh3_partition_tuple_t* dst,
+                                           const xxh3_partition_tuple_t* line, size_t start,
+                                           size_t from, size_t to)
+{
+    if (from == start && to == start + XXH3_PARTITION_LINE) {
+        XXH3_PARTITION_NT_LINE((xxh_u8*)(dst + start), (const xxh_u8*)line);
+    } else {
+        XXH_memcpy(dst + from, line + (from - start), (to - from) * sizeof(*dst));
+    }
+}
+
+/* The scatter pass through write-combining lines; dst is tuple-aligned */
+static void xxh3_partition_scatter_wc(const xxh3_partition_src_t* src, size_t begin, size_t end,
+                                      xxh3_partition_tuple_t* dst, size_t* cursor,
+                                      unsigned char* scratch)
+{
+    size_t const parts = (size_t)1 << src->bits;
+    xxh3_partition_tuple_t* const lines = (xxh3_partition_tuple_t*)(void*)scratch;
+    size_t* const first = (size_t*)(void*)(scratch + parts * 64);
+    /* tuple c of dst starts a line when (c + phase) % 4 == 0 */
+    size_t const phase = ((size_t)dst / sizeof(*dst)) & (XXH3_PARTITION_LINE - 1);
+    xxh_u64 h[XXH3_PARTITION_BLOCK];
+    size_t  i, j, p;
+
+    XXH_memcpy(first, cursor, parts * sizeof(size_t));
+    for (i = begin; i < end; i += XXH3_PARTITION_BLOCK) {
+        size_t const m = (end - i < XXH3_PARTITION_BLOCK) ? end - i : XXH3_PARTITION_BLOCK;
+        xxh3_partition_hash_rows(src, i, m, h);
+        for (j = 0; j < m; j++) {
+            size_t const part = xxh3_partition_of(h[j], src->bits);
+            size_t const c    = cursor[part]++;
+            size_t const k    = (c + phase) & (XXH3_PARTITION_LINE - 1);
+            xxh3_partition_tuple_t* const line = lines + XXH3_PARTITION_LINE * part;
+
+            line[k].hash    = h[j];
+            line[k].payload = (src->payloads != NULL) ? src->payloads[i + j] : (uint64_t)(i + j);
+            if (k == XXH3_PARTITION_LINE - 1) {
+                size_t const from = (c - first[part] >= k) ? c - k : first[part];
+                xxh3_partition_flush(dst, line, c - k, from, c + 1);
+            }
+        }
+    }
+    for (p = 0; p < parts; p++) {
+        size_t const c = cursor[p];
+        size_t const k = (c + phase) & (XXH3_PARTITION_LINE - 1);
+        if (k != 0) {
+            size_t const from = (c - first[p] >= k) ? c - k : first[p];
+            xxh3_partition_flush(dst, lines + XXH3_PARTITION_LINE * p, c - k, from, c);
+        }
+    }
+#ifdef XXH3_PARTITION_NT_FENCE
+    XXH3_PARTITION_NT_FENCE();
+#endif
+}
+#endif /* XXH3_PARTITION_NT_LINE */
+
+static void XXH3_VARIANT_FN(xxh3_partition_count)(const xxh3_partition_src_t* src, size_t begin,
+                                                  size_t end, size_t* hist)
+{
+    xxh_u64 h[XXH3_PARTITION_BLOCK];
+    size_t  i, j;
+
+    for (i = begin; i < end; i += XXH3_PARTITION_BLOCK) {
+        size_t const m = (end - i < XXH3_PARTITION_BLOCK) ? end - i : XXH3_PARTITION_BLOCK;
+        xxh3_partition_hash_rows(src, i, m, h);
+        for (j = 0; j < m; j++) {
+            hist[xxh3_partition_of(h[j], src->bits)]++;
+        }
+    }
+}
+
+static void XXH3_VARIANT_FN(xxh3_partition_scatter)(const xxh3_partition_src_t* src, size_t begin,
+                                                    size_t end, xxh3_partition_tuple_t* dst,
+                                                    size_t* cursor, unsigned char* scratch)
+{
+    xxh_u64 h[XXH3_PARTITION_BLOCK];
+    size_t  i, j;
+
+#ifdef XXH3_PARTITION_NT_LINE
+    if (src->bits >= XXH3_PARTITION_WC_BITS && ((size_t)dst & (sizeof(*dst) - 1)) == 0) {
+        xxh3_partition_scatter_wc(src, begin, end, dst, cursor, scratch);
+        return;
+    }
+#else
+    (void)scratch;
+#endif
+    for (i = begin; i < end; i += XXH3_PARTITION_BLOCK) {
+        size_t const m = (end - i < XXH3_PARTITION_BLOCK) ? end - i : XXH3_PARTITION_BLOCK;
+        xxh3_partition_hash_rows(src, i, m, h);
+        for (j = 0; j < m; j++) {
+            xxh3_partition_tuple_t* const out = dst + cursor[xxh3_partition_of(h[j], src->bits)]++;
+            out->hash    = h[j];
+            out->payload = (src->payloads != NULL) ? src->payloads[i + j] : (uint64_t)(i + j);
+        }
+    }
+}
+
+int XXH3_VARIANT_FN(xxh3_partition)(xxh3_partition_tuple_t* dst, size_t* hist, const void* keys,
+                                    size_t key_size, const uint64_t* payloads, size_t n,
+                                    unsigned bits, uint64_t seed, unsigned threads)
+{
+    xxh3_partition_src_t src;
+
+    if (keys == NULL && n > 0) {
+        return XXH3_ERROR;
+    }
+    src.keys     = (const unsigned char*)keys;
+    src.key_size = key_size;
+    src.inputs   = NULL;
+    src.sizes    = NULL;
+    src.payloads = payloads;
+    src.seed     = seed;
+    src.bits     = bits;
+    return xxh3_partition_with(dst, hist, &src, n, threads, XXH3_VARIANT_FN(xxh3_partition_count),
+                               XXH3_VARIANT_FN(xxh3_partition_scatter));
+}
+
+int XXH3_VARIANT_FN(xxh3_partition_var)(xxh3_partition_tuple_t* dst, size_t* hist,
+                                        const void* const* inputs, const size_t* sizes,
+                                        const uint64_t* payloads, size_t n, unsigned bits,
+                                        uint64_t seed, unsigned threads)
+{
+    xxh3_partition_src_t src;
+
+    if ((inputs == NULL || sizes == NULL) && n > 0) {
+        return XXH3_ERROR;
+    }
+    src.keys     = NULL;
+    src.key_size = 0;
+    src.inputs   = inputs;
+    src.sizes    = sizes;
+    src.payloads = payloads;
+    src.seed     = seed;
+    src.bits     = bits;
+    return xxh3_partition_with(dst, hist, &src, n, threads, XXH3_VARIANT_FN(xxh3_partition_count),
+                               XXH3_VARIANT_FN(xxh3_partition_scatter));
+}
+
+#undef XXH3_PARTITION_BLOCK
+#undef XXH3_PARTITION_WC_BITS
+#undef XXH3_PARTITION_NT_LINE
+#undef XXH3_PARTITION_NT_FENCE
+#undef XXH3_PARTITION_HASH8
+
+#endif /* XXH3_VARIANTS_TEMPLATES_PARTITION_H */
@@ -0,0 +1,63 @@
+/* Single-stream vector XXH32.
+ *
+ * The four XXH32 accumulators of one message fill one 128-bit vector, so a
+ * 16-byte stripe is a single vector round: load, multiply-add, rotate,
+ * multiply. Short inputs, the tail and the avalanche use the vendor's
+ * scalar code, so digests are bit-identical to xxh32().
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL), xxh3_state_internal.h and
+ * xxh3_xxh32_internal.h, with
+ * XXH3_VARIANT defined and
+ *   static void xxh32_stripes_vec(xxh_u32 v[4], const xxh_u8* p, size_t nbStripes)
+ * applying nbStripes consecutive stripes at p to the accumulators v.
+ * Emits `xxh32_<variant>` and the streaming `xxh32_update_<variant>`.
+ */
+#ifndef XXH3_VARIANTS_TEMPLATES_XXH32_H
+#define XXH3_VARIANTS_TEMPLATES_XXH32_H
+
+uint32_t XXH3_VARIANT_FN(xxh32)(const void* input, size_t size, uint32_t seed)
+{
+    const xxh_u8* p = (const xxh_u8*)input;
+    xxh_u32 h32;
+
+    XXH3_WRAPPER_GUARD({
+        if (input == NULL && size > 0) {
+            return 0;
+        }
+    });
+    if (size >= 16) {
+        xxh_u32 v[4];
+        v[0] = seed + XXH_PRIME32_1 + XXH_PRIME32_2;
+        v[1] = seed + XXH_PRIME32_2;
+        v[2] = seed + 0;
+        v[3] = seed - XXH_PRIME32_1;
+        xxh32_stripes_vec(v, p, size / 16);
+        p += size & ~(size_t)15;
+        h32 = XXH_rotl32(v[0], 1) + XXH_rotl32(v[1], 7)
+            + XXH_rotl32(v[2], 12) + XXH_rotl32(v[3], 18);
+    } else {
+        h32 = seed + XXH_PRIME32_5;
+    }
+    h32 += (xxh_u32)size;
+    return XXH32_finalize(h32, p, size & 15, XXH_unaligned);
+}
+
+/* xxh32_update() with the vector stripe loop; reset and digest are the
+ * scalar xxh32_reset() / xxh32_digest() */
+int XXH3_VARIANT_FN(xxh32_update)(xxh3_state_t* state, const void* input, size_t size)
+{
+    xxh32_stream_t* const s = xxh3_xxh32Stream(state);
+
+    XXH3_WRAPPER_GUARD({
+        if (s == NULL) {
+            return XXH3_ERROR;
+        }
+    });
+    if (input == NULL) {
+        return XXH3_OK;
+    }
+    xxh32_stream_update(s, (const xxh_u8*)input, size, xxh32_stripes_vec);
+    return XXH3_OK;
+}
+
+#endif /* XXH3_VARIANTS_TEMPLATES_XXH32_H */
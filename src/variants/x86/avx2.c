@@ -5,6 +5,12 @@
 #include "xxhash.h"
 
 #include "xxh3_converters.h"
+#include "xxh3_state_internal.h"
+#include "xxh3_hll_internal.h"
+#include "xxh3_mphf_internal.h"
+#include "xxh3_partition_internal.h"
+#include "xxh3_consistent_internal.h"
+#include "xxh3_blocks_internal.h"
 #include "common/internal_utils.h"
 
 uint64_t xxh3_64_avx2(const void* input, size_t size, uint64_t seed)
@@ -47,3 +53,427 @@ xxh3_128_t xxh3_128_avx2_unseeded(const void* input, size_t size)
     });
     return xxh128_to_xxh3(XXH3_128bits_withSeed(input, size, 0));
 }
+
+/* Non-temporal long-input kernels: xxh3_64_nt_avx2(), xxh3_128_nt_avx2() */
+#define XXH3_VARIANT avx2
+#include "variants/templates/nt.h"
+
+/* ------------------------------------------------------------------------
+ * Multi-buffer XXH64 / XXH32 (see variants/templates/batch.h)
+ *
+ * XXH64: 4 messages per pass. AVX2 has no 64-bit multiply, so the lane
+ * product with a prime is built from three 32x32->64 `vpmuludq`.
+ * XXH32: 8 messages per pass with `vpmulld`.
+ * ------------------------------------------------------------------------ */
+
+/* x * k mod 2^64, with k_lo / k_hi the 32-bit halves of k broadcast to
+ * every lane */
+XXH_FORCE_INLINE __m256i xxh_batch_mul64_avx2(__m256i x, __m256i k_lo, __m256i k_hi)
+{
+    __m256i const lo    = _mm256_mul_epu32(x, k_lo);
+    __m256i const cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), k_lo),
+                                           _mm256_mul_epu32(x, k_hi));
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+}
+
+XXH_FORCE_INLINE __m256i xxh_batch_round64_avx2(__m256i acc, __m256i input)
+{
+    __m256i const p1_lo = _mm256_set1_epi64x((long long)(XXH_PRIME64_1 & 0xFFFFFFFFULL));
+    __m256i const p1_hi = _mm256_set1_epi64x((long long)(XXH_PRIME64_1 >> 32));
+    __m256i const p2_lo = _mm256_set1_epi64x((long long)(XXH_PRIME64_2 & 0xFFFFFFFFULL));
+    __m256i const p2_hi = _mm256_set1_epi64x((long long)(XXH_PRIME64_2 >> 32));
+
+    acc = _mm256_add_epi64(acc, xxh_batch_mul64_avx2(input, p2_lo, p2_hi));
+    acc = _mm256_or_si256(_mm256_slli_epi64(acc, 31), _mm256_srli_epi64(acc, 33));
+    return xxh_batch_mul64_avx2(acc, p1_lo, p1_hi);
+}
+
+static void xxh64_batch_stripes_avx2(xxh_u64 acc[4][4], const xxh_u8* in[4],
+                                     const size_t step[4], size_t nbStripes)
+{
+    __m256i a0 = _mm256_load_si256((const __m256i*)acc[0]);
+    __m256i a1 = _mm256_load_si256((const __m256i*)acc[1]);
+    __m256i a2 = _mm256_load_si256((const __m256i*)acc[2]);
+    __m256i a3 = _mm256_load_si256((const __m256i*)acc[3]);
+    const xxh_u8* p0 = in[0];
+    const xxh_u8* p1 = in[1];
+    const xxh_u8* p2 = in[2];
+    const xxh_u8* p3 = in[3];
+    size_t n;
+
+    for (n = 0; n < nbStripes; n++) {
+        /* 4x4 transpose of 64-bit words: w_k = word k of every message */
+        __m256i const r0 = _mm256_loadu_si256((const __m256i*)p0);
+        __m256i const r1 = _mm256_loadu_si256((const __m256i*)p1);
+        __m256i const r2 = _mm256_loadu_si256((const __m256i*)p2);
+        __m256i const r3 = _mm256_loadu_si256((const __m256i*)p3);
+        __m256i const t0 = _mm256_unpacklo_epi64(r0, r1);
+        __m256i const t1 = _mm256_unpackhi_epi64(r0, r1);
+        __m256i const t2 = _mm256_unpacklo_epi64(r2, r3);
+        __m256i const t3 = _mm256_unpackhi_epi64(r2, r3);
+
+        a0 = xxh_batch_round64_avx2(a0, _mm256_permute2x128_si256(t0, t2, 0x20));
+        a1 = xxh_batch_round64_avx2(a1, _mm256_permute2x128_si256(t1, t3, 0x20));
+        a2 = xxh_batch_round64_avx2(a2, _mm256_permute2x128_si256(t0, t2, 0x31));
+        a3 = xxh_batch_round64_avx2(a3, _mm256_permute2x128_si256(t1, t3, 0x31));
+        p0 += step[0];
+        p1 += step[1];
+        p2 += step[2];
+        p3 += step[3];
+    }
+    _mm256_store_si256((__m256i*)acc[0], a0);
+    _mm256_store_si256((__m256i*)acc[1], a1);
+    _mm256_store_si256((__m256i*)acc[2], a2);
+    _mm256_store_si256((__m256i*)acc[3], a3);
+    in[0] = p0;
+    in[1] = p1;
+    in[2] = p2;
+    in[3] = p3;
+}
+
+XXH_FORCE_INLINE __m256i xxh_batch_round32_avx2(__m256i acc, __m256i input)
+{
+    acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(input, _mm256_set1_epi32((int)XXH_PRIME32_2)));
+    acc = _mm256_or_si256(_mm256_slli_epi32(acc, 13), _mm256_srli_epi32(acc, 19));
+    return _mm256_mullo_epi32(acc, _mm256_set1_epi32((int)XXH_PRIME32_1));
+}
+
+static void xxh32_batch_stripes_avx2(xxh_u32 acc[4][8], const xxh_u8* in[8],
+                                     const size_t step[8], size_t nbStripes)
+{
+    __m256i a0 = _mm256_load_si256((const __m256i*)acc[0]);
+    __m256i a1 = _mm256_load_si256((const __m256i*)acc[1]);
+    __m256i a2 = _mm256_load_si256((const __m256i*)acc[2]);
+    __m256i a3 = _mm256_load_si256((const __m256i*)acc[3]);
+    const xxh_u8* p[8];
+    size_t i, n;
+
+    for (i = 0; i < 8; i++) {
+        p[i] = in[i];
+    }
+    for (n = 0; n < nbStripes; n++) {
+        /* message i in the low 128-bit half, message i+4 in the high half,
+         * then a 4x4 transpose of 32-bit words within each half */
+        __m256i const r0 = _mm256_inserti128_si256(_mm256_castsi128_si256(
+                               _mm_loadu_si128((const __m128i*)p[0])),
+                               _mm_loadu_si128((const __m128i*)p[4]), 1);
+        __m256i const r1 = _mm256_inserti128_si256(_mm256_castsi128_si256(
+                               _mm_loadu_si128((const __m128i*)p[1])),
+                               _mm_loadu_si128((const __m128i*)p[5]), 1);
+        __m256i const r2 = _mm256_inserti128_si256(_mm256_castsi128_si256(
+                               _mm_loadu_si128((const __m128i*)p[2])),
+                               _mm_loadu_si128((const __m128i*)p[6]), 1);
+        __m256i const r3 = _mm256_inserti128_si256(_mm256_castsi128_si256(
+                               _mm_loadu_si128((const __m128i*)p[3])),
+                               _mm_loadu_si128((const __m128i*)p[7]), 1);
+        __m256i const t0 = _mm256_unpacklo_epi32(r0, r1);
+        __m256i const t1 = _mm256_unpacklo_epi32(r2, r3);
+        __m256i const t2 = _mm256_unpackhi_epi32(r0, r1);
+        __m256i const t3 = _mm256_unpackhi_epi32(r2, r3);
+
+        a0 = xxh_batch_round32_avx2(a0, _mm256_unpacklo_epi64(t0, t1));
+        a1 = xxh_batch_round32_avx2(a1, _mm256_unpackhi_epi64(t0, t1));
+        a2 = xxh_batch_round32_avx2(a2, _mm256_unpacklo_epi64(t2, t3));
+        a3 = xxh_batch_round32_avx2(a3, _mm256_unpackhi_epi64(t2, t3));
+        for (i = 0; i < 8; i++) {
+            p[i] += step[i];
+        }
+    }
+    _mm256_store_si256((__m256i*)acc[0], a0);
+    _mm256_store_si256((__m256i*)acc[1], a1);
+    _mm256_store_si256((__m256i*)acc[2], a2);
+    _mm256_store_si256((__m256i*)acc[3], a3);
+    for (i = 0; i < 8; i++) {
+        in[i] = p[i];
+    }
+}
+
+#define XXH_BATCH_FN      xxh64_batch_avx2
+#define XXH_BATCH_BITS    64
+#define XXH_BATCH_LANES   4
+#define XXH_BATCH_STRIPES xxh64_batch_stripes_avx2
+#include "variants/templates/batch.h"
+
+#define XXH_BATCH_FN      xxh32_batch_avx2
+#define XXH_BATCH_BITS    32
+#define XXH_BATCH_LANES   8
+#define XXH_BATCH_STRIPES xxh32_batch_stripes_avx2
+#include "variants/templates/batch.h"
+
+/* ------------------------------------------------------------------------
+ * Multi-seed XXH3-64 (see variants/templates/multiseed.h): 4 seeds per
+ * vector. The 64x64->128 product takes four `vpmuludq`.
+ * ------------------------------------------------------------------------ */
+
+/* Per-lane (a * b) as a 128-bit product, folded to low64 ^ high64 */
+XXH_FORCE_INLINE __m256i xxh3_mul128_fold64_avx2(__m256i a, __m256i b)
+{
+    const __m256i a_hi  = _mm256_srli_epi64(a, 32);
+    const __m256i b_hi  = _mm256_srli_epi64(b, 32);
+    const __m256i lo_lo = _mm256_mul_epu32(a, b);
+    const __m256i hi_lo = _mm256_mul_epu32(a_hi, b);
+    const __m256i lo_hi = _mm256_mul_epu32(a, b_hi);
+    const __m256i hi_hi = _mm256_mul_epu32(a_hi, b_hi);
+    /* same carry scheme as the portable XXH_mult64to128() */
+    const __m256i cross = _mm256_add_epi64(
+        _mm256_add_epi64(_mm256_srli_epi64(lo_lo, 32),
+                         _mm256_and_si256(hi_lo, _mm256_set1_epi64x(0xFFFFFFFF))),
+        lo_hi);
+    const __m256i upper = _mm256_add_epi64(
+        _mm256_add_epi64(_mm256_srli_epi64(hi_lo, 32), _mm256_srli_epi64(cross, 32)),
+        hi_hi);
+    const __m256i lower = _mm256_blend_epi32(lo_lo, _mm256_slli_epi64(cross, 32), 0xAA);
+    return _mm256_xor_si256(lower, upper);
+}
+
+XXH_FORCE_INLINE __m256i xxh3_avalanche_avx2(__m256i h)
+{
+    h = _mm256_xor_si256(h, _mm256_srli_epi64(h, 37));
+    h = xxh_batch_mul64_avx2(h, _mm256_set1_epi64x((long long)(0x165667919E3779F9ULL & 0xFFFFFFFFULL)),
+                                _mm256_set1_epi64x((long long)(0x165667919E3779F9ULL >> 32)));
+    return _mm256_xor_si256(h, _mm256_srli_epi64(h, 32));
+}
+
+/* mul128_fold64(in_lo ^ (sec_lo + seed), in_hi ^ (sec_hi - seed)) per seed */
+XXH_FORCE_INLINE __m256i xxh3_ms_mix_avx2(const xxh_u64* b, __m256i seed)
+{
+    __m256i const lo = _mm256_xor_si256(_mm256_set1_epi64x((long long)b[0]),
+                                        _mm256_add_epi64(_mm256_set1_epi64x((long long)b[2]), seed));
+    __m256i const hi = _mm256_xor_si256(_mm256_set1_epi64x((long long)b[1]),
+                                        _mm256_sub_epi64(_mm256_set1_epi64x((long long)b[3]), seed));
+    return xxh3_mul128_fold64_avx2(lo, hi);
+}
+
+static void xxh3_ms_9to16_avx2(xxh_u64* out, const xxh_u64* seeds, size_t len, const xxh_u64 blk[4])
+{
+    __m256i const seed  = _mm256_loadu_si256((const __m256i*)seeds);
+    __m256i const bswap = _mm256_broadcastsi128_si256(_mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15,
+                                                                   0, 1, 2, 3, 4, 5, 6, 7));
+    __m256i const lo = _mm256_xor_si256(_mm256_set1_epi64x((long long)blk[0]),
+                                        _mm256_add_epi64(_mm256_set1_epi64x((long long)blk[2]), seed));
+    __m256i const hi = _mm256_xor_si256(_mm256_set1_epi64x((long long)blk[1]),
+                                        _mm256_sub_epi64(_mm256_set1_epi64x((long long)blk[3]), seed));
+    __m256i acc = _mm256_add_epi64(_mm256_set1_epi64x((long long)len), _mm256_shuffle_epi8(lo, bswap));
+    acc = _mm256_add_epi64(acc, _mm256_add_epi64(hi, xxh3_mul128_fold64_avx2(lo, hi)));
+    _mm256_storeu_si256((__m256i*)out, xxh3_avalanche_avx2(acc));
+}
+
+static void xxh3_ms_17to240_avx2(xxh_u64* out, const xxh_u64* seeds, size_t len,
+                                 const xxh_u64 (*blk)[4], size_t nbFirst, size_t nbBlocks)
+{
+    __m256i const seed = _mm256_loadu_si256((const __m256i*)seeds);
+    __m256i acc = _mm256_set1_epi64x((long long)(len * XXH_PRIME64_1));
+    size_t i;
+
+    for (i = 0; i < nbFirst; i++) {
+        acc = _mm256_add_epi64(acc, xxh3_ms_mix_avx2(blk[i], seed));
+    }
+    if (nbFirst < nbBlocks) {
+        __m256i acc_end = _mm256_setzero_si256();
+        for (; i < nbBlocks; i++) {
+            acc_end = _mm256_add_epi64(acc_end, xxh3_ms_mix_avx2(blk[i], seed));
+        }
+        acc = _mm256_add_epi64(xxh3_avalanche_avx2(acc), acc_end);
+    }
+    _mm256_storeu_si256((__m256i*)out, xxh3_avalanche_avx2(acc));
+}
+
+#define XXH3_MS_LANES         4
+#define XXH3_MS_9TO16_LANES   xxh3_ms_9to16_avx2
+#define XXH3_MS_17TO240_LANES xxh3_ms_17to240_avx2
+#include "variants/templates/multiseed.h"
+
+/* Lockstep update of many streams (see variants/templates/multistream.h) */
+#include "variants/templates/multistream.h"
+
+/* Fused copy-and-hash (see variants/templates/copy.h) */
+XXH_FORCE_INLINE void xxh3_copy_nt_line_avx2(xxh_u8* dst, const xxh_u8* src)
+{
+    _mm256_stream_si256((__m256i*)dst,     _mm256_loadu_si256((const __m256i*)src));
+    _mm256_stream_si256((__m256i*)dst + 1, _mm256_loadu_si256((const __m256i*)src + 1));
+}
+#define XXH3_COPY_NT_LINE(dst, src) xxh3_copy_nt_line_avx2((dst), (src))
+#define XXH3_COPY_NT_FENCE()        _mm_sfence()
+#include "variants/templates/copy.h"
+
+/* C-string hashing (see variants/templates/cstr.h) */
+static XXH3_NO_SANITIZE_ADDRESS size_t xxh3_cstr_line_nul_avx2(const xxh_u8* line, size_t from)
+{
+    __m256i const zero = _mm256_setzero_si256();
+    const __m256i* const v = (const __m256i*)line;
+    xxh_u64 m = (xxh_u64)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(v), zero))
+             | (xxh_u64)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(v + 1), zero)) << 32;
+    m &= ~(xxh_u64)0 << from;
+    return m ? xxh3_ctz64(m) : 64;
+}
+#define XXH3_CSTR_LINE_NUL(line, from) xxh3_cstr_line_nul_avx2((line), (from))
+#include "variants/templates/cstr.h"
+
+/* Case-insensitive XXH3-64 (see variants/templates/ci.h): as in the SSE2
+ * variant, on 32 bytes at a time */
+XXH_FORCE_INLINE __m256i xxh3_ci_fold_avx2(__m256i v)
+{
+    __m256i const shifted = _mm256_add_epi8(v, _mm256_set1_epi8((char)(0x80 - 'A')));
+    __m256i const upper   = _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(0x80 + 26)), shifted);
+    return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+XXH_FORCE_INLINE void xxh3_ci_fold_line_avx2(xxh_u8* dst, const xxh_u8* src)
+{
+    _mm256_storeu_si256((__m256i*)dst,     xxh3_ci_fold_avx2(_mm256_loadu_si256((const __m256i*)src)));
+    _mm256_storeu_si256((__m256i*)dst + 1, xxh3_ci_fold_avx2(_mm256_loadu_si256((const __m256i*)src + 1)));
+}
+
+/* XXH3_accumulate_512_avx2() on the folded stripe */
+XXH_FORCE_INLINE void xxh3_ci_accumulate_512_avx2(xxh_u64* XXH_RESTRICT acc, const xxh_u8* XXH_RESTRICT input,
+                                                  const xxh_u8* XXH_RESTRICT secret)
+{
+    __m256i* const xacc = (__m256i*)acc;
+    size_t i;
+    for (i = 0; i < XXH_STRIPE_LEN / sizeof(__m256i); i++) {
+        __m256i const data_vec    = xxh3_ci_fold_avx2(_mm256_loadu_si256((const __m256i*)input + i));
+        __m256i const data_key    = _mm256_xor_si256(data_vec, _mm256_loadu_si256((const __m256i*)secret + i));
+        __m256i const data_key_lo = _mm256_srli_epi64(data_key, 32);
+        __m256i const product     = _mm256_mul_epu32(data_key, data_key_lo);
+        __m256i const data_swap   = _mm256_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2));
+        xacc[i] = _mm256_add_epi64(product, _mm256_add_epi64(xacc[i], data_swap));
+    }
+}
+
+/* 16-byte reads of the short-input paths */
+XXH_FORCE_INLINE void xxh3_ci_fold128_avx2(__m128i v, xxh_u64* lo, xxh_u64* hi)
+{
+    __m128i const shifted = _mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - 'A')));
+    __m128i const upper   = _mm_cmplt_epi8(shifted, _mm_set1_epi8((char)(0x80 + 26)));
+    __m128i const folded  = _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+    *lo = (xxh_u64)_mm_cvtsi128_si64(folded);
+    *hi = (xxh_u64)_mm_extract_epi64(folded, 1);
+}
+#define XXH3_CI_READ2(p, q, lo, hi) \
+    xxh3_ci_fold128_avx2(_mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)(p)), \
+                                            _mm_loadl_epi64((const __m128i*)(q))), &(lo), &(hi))
+#define XXH3_CI_READ128(p, lo, hi) \
+    xxh3_ci_fold128_avx2(_mm_loadu_si128((const __m128i*)(p)), &(lo), &(hi))
+#define XXH3_CI_FOLD_LINE(dst, src)             xxh3_ci_fold_line_avx2((dst), (src))
+#define XXH3_CI_ACCUMULATE_512(acc, in, secret) xxh3_ci_accumulate_512_avx2((acc), (in), (secret))
+#include "variants/templates/ci.h"
+
+/* Strided 2D and field-gather hashing (see variants/templates/gather.h) */
+#include "variants/templates/gather.h"
+
+/* Batch canonical and hex encoding (see variants/templates/hex.h) with the
+ * kernels of variants/x86/avx2_hooks.h */
+#include "variants/x86/avx2_hooks.h"
+#define XXH3_HEX_BSWAP(dst, src) xxh3_hex_bswap_avx2((dst), (src))
+#define XXH3_HEX_ENCODE(dst, src) xxh3_hex_encode_avx2((dst), (src))
+#define XXH3_HEX_DECODE(dst, src) xxh3_hex_decode_avx2((dst), (src))
+#include "variants/templates/hex.h"
+
+/* Blocked Bloom filter (see variants/templates/bloom.h) with the kernels of
+ * variants/x86/avx2_hooks.h */
+#define XXH3_BLOOM_SET(block, key, salt) xxh3_bloom_set_avx2((block), (key), (salt))
+#define XXH3_BLOOM_TEST(block, key, salt) xxh3_bloom_test_avx2((block), (key), (salt))
+#include "variants/templates/bloom.h"
+
+/* HyperLogLog sketches (see variants/templates/hll.h). AVX2 has no
+ * lane-wise leading-zero count: the ranks of 8 hashes come from the
+ * exponents of their upper 32 bits converted to float, and the rare group
+ * where one of those is 0 is ranked in scalar code */
+XXH_FORCE_INLINE void xxh3_hll_rank8_avx2(xxh_u8* ranks, const xxh_u64* hashes, unsigned p)
+{
+    __m128i const count = _mm_cvtsi32_si128((int)p);
+    __m256i const guard = _mm256_set1_epi64x((long long)((xxh_u64)1 << (p - 1)));
+    __m256i const odd   = _mm256_setr_epi32(1, 3, 5, 7, 1, 3, 5, 7);
+    const __m256i* const in = (const __m256i*)(const void*)hashes;
+    __m256i const a = _mm256_or_si256(_mm256_sll_epi64(_mm256_loadu_si256(in), count), guard);
+    __m256i const b = _mm256_or_si256(_mm256_sll_epi64(_mm256_loadu_si256(in + 1), count), guard);
+    /* upper halves of the 8 shifted hashes */
+    __m256i const hi = _mm256_permute2x128_si256(_mm256_permutevar8x32_epi32(a, odd),
+                                                 _mm256_permutevar8x32_epi32(b, odd), 0x20);
+    __m256i y, e, r;
+    size_t  j;
+
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(hi, _mm256_setzero_si256())) != 0) {
+        for (j = 0; j < 8; j++) {
+            ranks[j] = (xxh_u8)xxh3_hll_rank(hashes[j], p);
+        }
+        return;
+    }
+    /* Clearing the bit below each set bit keeps the top one, and leaves the
+     * value too far from the next power of two for the conversion to round
+     * up. Shifted right once, it is below 2^31 and converts as signed; the
+     * exponent of y >> 1 is then top - 1, or 0 when y is 1 (top 0). */
+    y = _mm256_andnot_si256(_mm256_srli_epi32(hi, 1), hi);
+    e = _mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(_mm256_srli_epi32(y, 1))), 23);
+    e = _mm256_max_epi32(_mm256_sub_epi32(e, _mm256_set1_epi32(126)), _mm256_setzero_si256());
+    /* rank = leading zeros + 1 = 32 - top, then the low bytes packed */
+    r = _mm256_sub_epi32(_mm256_set1_epi32(32), e);
+    r = _mm256_shuffle_epi8(r, _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+    r = _mm256_permutevar8x32_epi32(r, _mm256_setr_epi32(0, 4, 1, 1, 1, 1, 1, 1));
+    _mm_storel_epi64((__m128i*)(void*)ranks, _mm256_castsi256_si128(r));
+}
+
+/* Two ymm per iteration: merging is bound by memory bandwidth */
+XXH_FORCE_INLINE void xxh3_hll_max_avx2(xxh_u8* dst, const xxh_u8* src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m256i* const d = (__m256i*)(void*)(dst + i);
+        const __m256i* const s = (const __m256i*)(const void*)(src + i);
+        _mm256_storeu_si256(d, _mm256_max_epu8(_mm256_loadu_si256(d), _mm256_loadu_si256(s)));
+        _mm256_storeu_si256(d + 1, _mm256_max_epu8(_mm256_loadu_si256(d + 1), _mm256_loadu_si256(s + 1)));
+    }
+    for (; i < n; i += 16) {
+        __m128i* const d = (__m128i*)(void*)(dst + i);
+        _mm_storeu_si128(d, _mm_max_epu8(_mm_loadu_si128(d),
+                                         _mm_loadu_si128((const __m128i*)(const void*)(src + i))));
+    }
+}
+#define XXH3_HLL_RANK8(ranks, hashes, p) xxh3_hll_rank8_avx2((ranks), (hashes), (p))
+#define XXH3_HLL_MAX(dst, src, n) xxh3_hll_max_avx2((dst), (src), (n))
+#include "variants/templates/hll.h"
+
+/* Multiset hashes (see variants/templates/multiset.h) */
+#include "variants/templates/multiset.h"
+
+/* Minimal perfect hash functions (see variants/templates/mphf.h) */
+#include "variants/templates/mphf.h"
+
+/* Hash partitioning (see variants/templates/partition.h): 8-byte keys are
+ * hashed 4 per vector, the rrmxmx multiplies built from `vpmuludq` */
+XXH_FORCE_INLINE __m256i xxh3_partition_rrmxmx8_avx2(__m256i h)
+{
+    __m256i const mx2_lo = _mm256_set1_epi64x((long long)(PRIME_MX2 & 0xFFFFFFFFULL));
+    __m256i const mx2_hi = _mm256_set1_epi64x((long long)(PRIME_MX2 >> 32));
+    h = _mm256_xor_si256(h, _mm256_xor_si256(
+            _mm256_or_si256(_mm256_slli_epi64(h, 49), _mm256_srli_epi64(h, 15)),
+            _mm256_or_si256(_mm256_slli_epi64(h, 24), _mm256_srli_epi64(h, 40))));
+    h = xxh_batch_mul64_avx2(h, mx2_lo, mx2_hi);
+    h = _mm256_xor_si256(h, _mm256_add_epi64(_mm256_srli_epi64(h, 35), _mm256_set1_epi64x(8)));
+    h = xxh_batch_mul64_avx2(h, mx2_lo, mx2_hi);
+    return _mm256_xor_si256(h, _mm256_srli_epi64(h, 28));
+}
+
+XXH_FORCE_INLINE void xxh3_partition_hash8_avx2(xxh_u64* out, const xxh_u8* keys, xxh_u64 bitflip)
+{
+    __m256i const flip = _mm256_set1_epi64x((long long)bitflip);
+    size_t j;
+    for (j = 0; j < 8; j += 4) {
+        /* input2 + (input1 << 32) is the 64-bit key rotated by 32 */
+        __m256i const k = _mm256_shuffle_epi32(_mm256_loadu_si256((const __m256i*)(keys + 8 * j)),
+                                               _MM_SHUFFLE(2, 3, 0, 1));
+        _mm256_storeu_si256((__m256i*)(out + j),
+                            xxh3_partition_rrmxmx8_avx2(_mm256_xor_si256(k, flip)));
+    }
+}
+#define XXH3_PARTITION_NT_LINE(dst, src)     xxh3_copy_nt_line_avx2((dst), (src))
+#define XXH3_PARTITION_NT_FENCE()            _mm_sfence()
+#define XXH3_PARTITION_HASH8(out, keys, bitflip) xxh3_partition_hash8_avx2((out), (keys), (bitflip))
+#include "variants/templates/partition.h"
+
+/* Jump and rendezvous hashing (see variants/templates/consistent.h) */
+#include "variants/templates/consistent.h"
+
+/* Per-block checksums (see variants/templates/blocks.h) */
+#include "variants/templates/blocks.h"
@@ -0,0 +1,72 @@
+/* AVX2 kernels shared by the AVX2 and AVX-512 variants, whose hex and
+ * Bloom templates use the same 256-bit forms. Each TU binds them to its
+ * template hooks.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) and <immintrin.h> in a TU built
+ * with AVX2 enabled.
+ */
+#ifndef XXH3_VARIANTS_X86_AVX2_HOOKS_H
+#define XXH3_VARIANTS_X86_AVX2_HOOKS_H
+
+/* Batch canonical and hex encoding (see variants/templates/hex.h): byte
+ * swaps and digit lookups with PSHUFB, 32 characters per ymm */
+XXH_FORCE_INLINE void xxh3_hex_bswap_avx2(xxh_u8* dst, const xxh_u8* src)
+{
+    __m128i const rev = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+    _mm_storeu_si128((__m128i*)(void*)dst,
+                     _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(const void*)src), rev));
+}
+
+XXH_FORCE_INLINE void xxh3_hex_encode_avx2(xxh_u8* dst, const xxh_u8* src)
+{
+    __m256i const digits = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                            '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                                            '0', '1', '2', '3', '4', '5', '6', '7',
+                                            '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    /* byte i in 16-bit lane i: high nibble to the low byte, low nibble to the high byte */
+    __m256i const w = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(const void*)src));
+    __m256i const n = _mm256_or_si256(_mm256_srli_epi16(w, 4),
+                                      _mm256_slli_epi16(_mm256_and_si256(w, _mm256_set1_epi16(0x0F)), 8));
+    _mm256_storeu_si256((__m256i*)(void*)dst, _mm256_shuffle_epi8(digits, n));
+}
+
+XXH_FORCE_INLINE int xxh3_hex_decode_avx2(xxh_u8* dst, const xxh_u8* src)
+{
+    __m256i const c     = _mm256_loadu_si256((const __m256i*)(const void*)src);
+    __m256i const lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+    /* bytes >= 0x80 are negative and fail both signed range checks */
+    __m256i const dec   = _mm256_andnot_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('9')),
+                                              _mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)));
+    __m256i const alpha = _mm256_andnot_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('f')),
+                                              _mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)));
+    __m256i const n     = _mm256_or_si256(_mm256_and_si256(dec, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+                                          _mm256_and_si256(alpha, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+    /* high nibble * 16 + low nibble in each 16-bit lane */
+    __m256i const pairs = _mm256_maddubs_epi16(n, _mm256_set1_epi16(0x0110));
+    _mm_storeu_si128((__m128i*)(void*)dst, _mm_packus_epi16(_mm256_castsi256_si128(pairs),
+                                                            _mm256_extracti128_si256(pairs, 1)));
+    return _mm256_movemask_epi8(_mm256_or_si256(dec, alpha)) == -1;
+}
+
+/* Blocked Bloom filter (see variants/templates/bloom.h): the eight bit
+ * indexes of a key with one VPMULLD, the block as one ymm */
+XXH_FORCE_INLINE __m256i xxh3_bloom_mask_avx2(xxh_u32 key, const xxh_u32* salt)
+{
+    __m256i const s = _mm256_loadu_si256((const __m256i*)(const void*)salt);
+    __m256i const b = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((int)key), s), 27);
+    return _mm256_sllv_epi32(_mm256_set1_epi32(1), b);
+}
+
+XXH_FORCE_INLINE void xxh3_bloom_set_avx2(xxh_u8* block, xxh_u32 key, const xxh_u32* salt)
+{
+    __m256i* const p = (__m256i*)(void*)block;
+    _mm256_storeu_si256(p, _mm256_or_si256(_mm256_loadu_si256(p), xxh3_bloom_mask_avx2(key, salt)));
+}
+
+XXH_FORCE_INLINE int xxh3_bloom_test_avx2(const xxh_u8* block, xxh_u32 key, const xxh_u32* salt)
+{
+    return _mm256_testc_si256(_mm256_loadu_si256((const __m256i*)(const void*)block),
+                              xxh3_bloom_mask_avx2(key, salt));
+}
+
+#endif /* XXH3_VARIANTS_X86_AVX2_HOOKS_H */
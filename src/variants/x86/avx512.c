@@ -5,8 +5,101 @@
 #include "xxhash.h"
 
 #include "xxh3_converters.h"
+#include "xxh3_state_internal.h"
+#include "xxh3_hll_internal.h"
+#include "xxh3_mphf_internal.h"
+#include "xxh3_partition_internal.h"
+#include "xxh3_consistent_internal.h"
+#include "xxh3_blocks_internal.h"
 #include "common/internal_utils.h"
 
+/* ============================================
+   17-128 byte inputs
+   ============================================
+
+   XXH3_len_17to128_64b() sums mix16B() over up to 8 16-byte blocks: blocks
+   from the front of the input pair with the even 16-byte secret blocks,
+   blocks from the back (in reverse order) with the odd ones. Here the two
+   halves are fetched with masked loads (the back load is aligned to the end
+   of the input and lanes before its start are masked off, so nothing outside
+   [input, input+len) is touched), permuted into secret order and all
+   64x64->128 products are folded in one zmm register.
+
+   AVX-512 has no 64x64->128 multiply, so each product costs four
+   vpmuludq plus carry handling. That only pays off once most of the 8 lanes
+   are busy: below XXH3_AVX512_MIDSIZE_MIN the vendor's scalar mulx path is
+   faster and is used instead. The 129-240 byte path (two dependent
+   avalanche rounds) measured slower than scalar at every size and is left to
+   the vendor. */
+#ifndef XXH3_AVX512_MIDSIZE_MIN
+#  define XXH3_AVX512_MIDSIZE_MIN 97  /* 17..128; 97 = four mix16B rounds */
+#endif
+
+/* Per-lane (a * b) as a 128-bit product, folded to low64 ^ high64 */
+XXH_FORCE_INLINE __m512i xxh3_mul128_fold64_avx512(__m512i a, __m512i b)
+{
+    const __m512i a_hi  = _mm512_srli_epi64(a, 32);
+    const __m512i b_hi  = _mm512_srli_epi64(b, 32);
+    const __m512i lo_lo = _mm512_mul_epu32(a, b);
+    const __m512i hi_lo = _mm512_mul_epu32(a_hi, b);
+    const __m512i lo_hi = _mm512_mul_epu32(a, b_hi);
+    const __m512i hi_hi = _mm512_mul_epu32(a_hi, b_hi);
+    /* same carry scheme as the portable XXH_mult64to128() */
+    const __m512i cross = _mm512_add_epi64(
+        _mm512_add_epi64(_mm512_srli_epi64(lo_lo, 32),
+                         _mm512_and_si512(hi_lo, _mm512_set1_epi64(0xFFFFFFFF))),
+        lo_hi);
+    const __m512i upper = _mm512_add_epi64(
+        _mm512_add_epi64(_mm512_srli_epi64(hi_lo, 32), _mm512_srli_epi64(cross, 32)),
+        hi_hi);
+    const __m512i lower = _mm512_mask_blend_epi32(0xAAAA, lo_lo, _mm512_slli_epi64(cross, 32));
+    return _mm512_xor_si512(lower, upper);
+}
+
+/* Sum of the eight 64-bit lanes. GCC's _mm512_reduce_add_epi64() adds in
+ * signed long long, which -fsanitize=undefined reports as overflow. */
+XXH_FORCE_INLINE xxh_u64 xxh3_hsum64_avx512(__m512i v)
+{
+    __m256i const s256 = _mm256_add_epi64(_mm512_castsi512_si256(v), _mm512_extracti64x4_epi64(v, 1));
+    __m128i const s128 = _mm_add_epi64(_mm256_castsi256_si128(s256), _mm256_extracti128_si256(s256, 1));
+    return (xxh_u64)_mm_cvtsi128_si64(_mm_add_epi64(s128, _mm_unpackhi_epi64(s128, s128)));
+}
+
+static XXH64_hash_t
+xxh3_len_17to128_64b_avx512(const xxh_u8* input, size_t len, XXH64_hash_t seed)
+{
+    const xxh_u8* const secret = XXH3_kSecret;
+    unsigned const rounds = (unsigned)(len - 1) / 32 + 1;           /* 1..4 */
+    __mmask8 const live   = (__mmask8)((1u << (2 * rounds)) - 1);   /* qwords / lanes in use */
+    /* front: blocks 0..rounds-1 in qwords 0..2*rounds-1;
+     * back:  last 16*rounds bytes in the top qwords, block i counted from the end at qwords 6-2i */
+    __m512i const front = _mm512_maskz_loadu_epi64(live, input);
+    __m512i const back  = _mm512_maskz_loadu_epi64((__mmask8)~(0xFFu >> (2 * rounds)), input + len - 64);
+    /* secret block 2i pairs with front block i, 2i+1 with back block i */
+    __m512i const in_lo = _mm512_permutex2var_epi64(front, _mm512_set_epi64(8, 6, 10, 4, 12, 2, 14, 0), back);
+    __m512i const in_hi = _mm512_permutex2var_epi64(front, _mm512_set_epi64(9, 7, 11, 5, 13, 3, 15, 1), back);
+    __m512i const sec0  = _mm512_loadu_si512(secret);
+    __m512i const sec1  = _mm512_loadu_si512(secret + 64);
+    __m512i const key_lo = _mm512_add_epi64(
+        _mm512_permutex2var_epi64(sec0, _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0), sec1),
+        _mm512_set1_epi64((xxh_i64)seed));
+    __m512i const key_hi = _mm512_sub_epi64(
+        _mm512_permutex2var_epi64(sec0, _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1), sec1),
+        _mm512_set1_epi64((xxh_i64)seed));
+    __m512i const folded = xxh3_mul128_fold64_avx512(_mm512_xor_si512(in_lo, key_lo),
+                                                     _mm512_xor_si512(in_hi, key_hi));
+    xxh_u64 const acc = len * XXH_PRIME64_1 + xxh3_hsum64_avx512(_mm512_maskz_mov_epi64(live, folded));
+    return XXH3_avalanche(acc);
+}
+
+XXH_FORCE_INLINE XXH64_hash_t xxh3_64_avx512_internal(const void* input, size_t size, uint64_t seed)
+{
+    if (size >= XXH3_AVX512_MIDSIZE_MIN && size > 16 && size <= 128) {
+        return xxh3_len_17to128_64b_avx512((const xxh_u8*)input, size, seed);
+    }
+    return XXH3_64bits_withSeed(input, size, seed);
+}
+
 uint64_t xxh3_64_avx512(const void* input, size_t size, uint64_t seed)
 {
     XXH3_WRAPPER_GUARD({
@@ -14,7 +107,7 @@ uint64_t xxh3_64_avx512(const void* input, size_t size, uint64_t seed)
             return 0;
         }
     });
-    return XXH3_64bits_withSeed(input, size, seed);
+    return xxh3_64_avx512_internal(input, size, seed);
 }
 
 xxh3_128_t xxh3_128_avx512(const void* input, size_t size, uint64_t seed)
@@ -35,7 +128,7 @@ uint64_t xxh3_64_avx512_unseeded(const void* input, size_t size)
             return 0;
         }
     });
-    return XXH3_64bits_withSeed(input, size, 0);
+    return xxh3_64_avx512_internal(input, size, 0);
 }
 
 xxh3_128_t xxh3_128_avx512_unseeded(const void* input, size_t size)
@@ -47,3 +140,344 @@ xxh3_128_t xxh3_128_avx512_unseeded(const void* input, size_t size)
     });
     return xxh128_to_xxh3(XXH3_128bits_withSeed(input, size, 0));
 }
+
+/* Non-temporal long-input kernels: xxh3_64_nt_avx512(), xxh3_128_nt_avx512() */
+#define XXH3_VARIANT avx512
+#include "variants/templates/nt.h"
+
+/* ------------------------------------------------------------------------
+ * Multi-buffer XXH64 / XXH32 (see variants/templates/batch.h)
+ *
+ * XXH64: 8 messages per pass with `vpmullq` (AVX512DQ) and `vprolq`.
+ * XXH32: 16 messages per pass with `vpmulld` and `vprold`.
+ * ------------------------------------------------------------------------ */
+
+XXH_FORCE_INLINE __m512i xxh_batch_round64_avx512(__m512i acc, __m512i input)
+{
+    acc = _mm512_add_epi64(acc, _mm512_mullo_epi64(input, _mm512_set1_epi64((long long)XXH_PRIME64_2)));
+    acc = _mm512_rol_epi64(acc, 31);
+    return _mm512_mullo_epi64(acc, _mm512_set1_epi64((long long)XXH_PRIME64_1));
+}
+
+XXH_FORCE_INLINE __m512i xxh_batch_load2x256_avx512(const xxh_u8* lo, const xxh_u8* hi)
+{
+    return _mm512_inserti64x4(_mm512_castsi256_si512(_mm256_loadu_si256((const __m256i*)lo)),
+                              _mm256_loadu_si256((const __m256i*)hi), 1);
+}
+
+static void xxh64_batch_stripes_avx512(xxh_u64 acc[4][8], const xxh_u8* in[8],
+                                       const size_t step[8], size_t nbStripes)
+{
+    __m512i a0 = _mm512_load_si512((const void*)acc[0]);
+    __m512i a1 = _mm512_load_si512((const void*)acc[1]);
+    __m512i a2 = _mm512_load_si512((const void*)acc[2]);
+    __m512i a3 = _mm512_load_si512((const void*)acc[3]);
+    const xxh_u8* p[8];
+    size_t i, n;
+
+    for (i = 0; i < 8; i++) {
+        p[i] = in[i];
+    }
+    for (n = 0; n < nbStripes; n++) {
+        /* Pairing messages (0,2) (1,3) (4,6) (5,7) makes the 128-bit
+         * shuffles below land every message in its own lane. */
+        __m512i const r0 = xxh_batch_load2x256_avx512(p[0], p[2]);
+        __m512i const r1 = xxh_batch_load2x256_avx512(p[1], p[3]);
+        __m512i const r2 = xxh_batch_load2x256_avx512(p[4], p[6]);
+        __m512i const r3 = xxh_batch_load2x256_avx512(p[5], p[7]);
+        __m512i const t0 = _mm512_unpacklo_epi64(r0, r1);  /* w0 | w2 of 0,1 | 2,3 */
+        __m512i const t1 = _mm512_unpackhi_epi64(r0, r1);  /* w1 | w3 */
+        __m512i const t2 = _mm512_unpacklo_epi64(r2, r3);  /* w0 | w2 of 4,5 | 6,7 */
+        __m512i const t3 = _mm512_unpackhi_epi64(r2, r3);
+
+        a0 = xxh_batch_round64_avx512(a0, _mm512_shuffle_i64x2(t0, t2, _MM_SHUFFLE(2, 0, 2, 0)));
+        a1 = xxh_batch_round64_avx512(a1, _mm512_shuffle_i64x2(t1, t3, _MM_SHUFFLE(2, 0, 2, 0)));
+        a2 = xxh_batch_round64_avx512(a2, _mm512_shuffle_i64x2(t0, t2, _MM_SHUFFLE(3, 1, 3, 1)));
+        a3 = xxh_batch_round64_avx512(a3, _mm512_shuffle_i64x2(t1, t3, _MM_SHUFFLE(3, 1, 3, 1)));
+        for (i = 0; i < 8; i++) {
+            p[i] += step[i];
+        }
+    }
+    _mm512_store_si512((void*)acc[0], a0);
+    _mm512_store_si512((void*)acc[1], a1);
+    _mm512_store_si512((void*)acc[2], a2);
+    _mm512_store_si512((void*)acc[3], a3);
+    for (i = 0; i < 8; i++) {
+        in[i] = p[i];
+    }
+}
+
+XXH_FORCE_INLINE __m512i xxh_batch_round32_avx512(__m512i acc, __m512i input)
+{
+    acc = _mm512_add_epi32(acc, _mm512_mullo_epi32(input, _mm512_set1_epi32((int)XXH_PRIME32_2)));
+    acc = _mm512_rol_epi32(acc, 13);
+    return _mm512_mullo_epi32(acc, _mm512_set1_epi32((int)XXH_PRIME32_1));
+}
+
+/* Messages j, j+4, j+8, j+12 in the four 128-bit quarters */
+XXH_FORCE_INLINE __m512i xxh_batch_load4x128_avx512(const xxh_u8* const* p)
+{
+    __m512i r = _mm512_castsi128_si512(_mm_loadu_si128((const __m128i*)p[0]));
+    r = _mm512_inserti32x4(r, _mm_loadu_si128((const __m128i*)p[4]), 1);
+    r = _mm512_inserti32x4(r, _mm_loadu_si128((const __m128i*)p[8]), 2);
+    return _mm512_inserti32x4(r, _mm_loadu_si128((const __m128i*)p[12]), 3);
+}
+
+static void xxh32_batch_stripes_avx512(xxh_u32 acc[4][16], const xxh_u8* in[16],
+                                       const size_t step[16], size_t nbStripes)
+{
+    __m512i a0 = _mm512_load_si512((const void*)acc[0]);
+    __m512i a1 = _mm512_load_si512((const void*)acc[1]);
+    __m512i a2 = _mm512_load_si512((const void*)acc[2]);
+    __m512i a3 = _mm512_load_si512((const void*)acc[3]);
+    const xxh_u8* p[16];
+    size_t i, n;
+
+    for (i = 0; i < 16; i++) {
+        p[i] = in[i];
+    }
+    for (n = 0; n < nbStripes; n++) {
+        /* 4x4 transpose of 32-bit words within each 128-bit quarter */
+        __m512i const r0 = xxh_batch_load4x128_avx512(p + 0);
+        __m512i const r1 = xxh_batch_load4x128_avx512(p + 1);
+        __m512i const r2 = xxh_batch_load4x128_avx512(p + 2);
+        __m512i const r3 = xxh_batch_load4x128_avx512(p + 3);
+        __m512i const t0 = _mm512_unpacklo_epi32(r0, r1);
+        __m512i const t1 = _mm512_unpacklo_epi32(r2, r3);
+        __m512i const t2 = _mm512_unpackhi_epi32(r0, r1);
+        __m512i const t3 = _mm512_unpackhi_epi32(r2, r3);
+
+        a0 = xxh_batch_round32_avx512(a0, _mm512_unpacklo_epi64(t0, t1));
+        a1 = xxh_batch_round32_avx512(a1, _mm512_unpackhi_epi64(t0, t1));
+        a2 = xxh_batch_round32_avx512(a2, _mm512_unpacklo_epi64(t2, t3));
+        a3 = xxh_batch_round32_avx512(a3, _mm512_unpackhi_epi64(t2, t3));
+        for (i = 0; i < 16; i++) {
+            p[i] += step[i];
+        }
+    }
+    _mm512_store_si512((void*)acc[0], a0);
+    _mm512_store_si512((void*)acc[1], a1);
+    _mm512_store_si512((void*)acc[2], a2);
+    _mm512_store_si512((void*)acc[3], a3);
+    for (i = 0; i < 16; i++) {
+        in[i] = p[i];
+    }
+}
+
+#define XXH_BATCH_FN      xxh64_batch_avx512
+#define XXH_BATCH_BITS    64
+#define XXH_BATCH_LANES   8
+#define XXH_BATCH_STRIPES xxh64_batch_stripes_avx512
+#include "variants/templates/batch.h"
+
+#define XXH_BATCH_FN      xxh32_batch_avx512
+#define XXH_BATCH_BITS    32
+#define XXH_BATCH_LANES   16
+#define XXH_BATCH_STRIPES xxh32_batch_stripes_avx512
+#include "variants/templates/batch.h"
+
+/* ------------------------------------------------------------------------
+ * Multi-seed XXH3-64 (see variants/templates/multiseed.h): 8 seeds per
+ * vector, reusing the 128-bit product emulation of the short-input kernel.
+ * ------------------------------------------------------------------------ */
+
+XXH_FORCE_INLINE __m512i xxh3_avalanche_avx512(__m512i h)
+{
+    h = _mm512_xor_si512(h, _mm512_srli_epi64(h, 37));
+    h = _mm512_mullo_epi64(h, _mm512_set1_epi64((xxh_i64)0x165667919E3779F9ULL));
+    return _mm512_xor_si512(h, _mm512_srli_epi64(h, 32));
+}
+
+/* mul128_fold64(in_lo ^ (sec_lo + seed), in_hi ^ (sec_hi - seed)) per seed */
+XXH_FORCE_INLINE __m512i xxh3_ms_mix_avx512(const xxh_u64* b, __m512i seed)
+{
+    __m512i const lo = _mm512_xor_si512(_mm512_set1_epi64((xxh_i64)b[0]),
+                                        _mm512_add_epi64(_mm512_set1_epi64((xxh_i64)b[2]), seed));
+    __m512i const hi = _mm512_xor_si512(_mm512_set1_epi64((xxh_i64)b[1]),
+                                        _mm512_sub_epi64(_mm512_set1_epi64((xxh_i64)b[3]), seed));
+    return xxh3_mul128_fold64_avx512(lo, hi);
+}
+
+static void xxh3_ms_9to16_avx512(xxh_u64* out, const xxh_u64* seeds, size_t len, const xxh_u64 blk[4])
+{
+    __m512i const seed  = _mm512_loadu_si512((const void*)seeds);
+    __m512i const bswap = _mm512_broadcast_i32x4(_mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15,
+                                                              0, 1, 2, 3, 4, 5, 6, 7));
+    __m512i const lo = _mm512_xor_si512(_mm512_set1_epi64((xxh_i64)blk[0]),
+                                        _mm512_add_epi64(_mm512_set1_epi64((xxh_i64)blk[2]), seed));
+    __m512i const hi = _mm512_xor_si512(_mm512_set1_epi64((xxh_i64)blk[1]),
+                                        _mm512_sub_epi64(_mm512_set1_epi64((xxh_i64)blk[3]), seed));
+    __m512i acc = _mm512_add_epi64(_mm512_set1_epi64((xxh_i64)len), _mm512_shuffle_epi8(lo, bswap));
+    acc = _mm512_add_epi64(acc, _mm512_add_epi64(hi, xxh3_mul128_fold64_avx512(lo, hi)));
+    _mm512_storeu_si512((void*)out, xxh3_avalanche_avx512(acc));
+}
+
+static void xxh3_ms_17to240_avx512(xxh_u64* out, const xxh_u64* seeds, size_t len,
+                                   const xxh_u64 (*blk)[4], size_t nbFirst, size_t nbBlocks)
+{
+    __m512i const seed = _mm512_loadu_si512((const void*)seeds);
+    __m512i acc = _mm512_set1_epi64((xxh_i64)(len * XXH_PRIME64_1));
+    size_t i;
+
+    for (i = 0; i < nbFirst; i++) {
+        acc = _mm512_add_epi64(acc, xxh3_ms_mix_avx512(blk[i], seed));
+    }
+    if (nbFirst < nbBlocks) {
+        __m512i acc_end = _mm512_setzero_si512();
+        for (; i < nbBlocks; i++) {
+            acc_end = _mm512_add_epi64(acc_end, xxh3_ms_mix_avx512(blk[i], seed));
+        }
+        acc = _mm512_add_epi64(xxh3_avalanche_avx512(acc), acc_end);
+    }
+    _mm512_storeu_si512((void*)out, xxh3_avalanche_avx512(acc));
+}
+
+#define XXH3_MS_LANES         8
+#define XXH3_MS_9TO16_LANES   xxh3_ms_9to16_avx512
+#define XXH3_MS_17TO240_LANES xxh3_ms_17to240_avx512
+#include "variants/templates/multiseed.h"
+
+/* Lockstep update of many streams (see variants/templates/multistream.h) */
+#include "variants/templates/multistream.h"
+
+/* Fused copy-and-hash (see variants/templates/copy.h) */
+#define XXH3_COPY_NT_LINE(dst, src) \
+    _mm512_stream_si512((void*)(dst), _mm512_loadu_si512((const void*)(src)))
+#define XXH3_COPY_NT_FENCE()        _mm_sfence()
+#include "variants/templates/copy.h"
+
+/* C-string hashing (see variants/templates/cstr.h): one zmm compare per line */
+static XXH3_NO_SANITIZE_ADDRESS size_t xxh3_cstr_line_nul_avx512(const xxh_u8* line, size_t from)
+{
+    xxh_u64 m = (xxh_u64)_mm512_cmpeq_epi8_mask(_mm512_loadu_si512((const void*)line),
+                                                _mm512_setzero_si512());
+    m &= ~(xxh_u64)0 << from;
+    return m ? xxh3_ctz64(m) : 64;
+}
+#define XXH3_CSTR_LINE_NUL(line, from) xxh3_cstr_line_nul_avx512((line), (from))
+#include "variants/templates/cstr.h"
+
+/* Case-insensitive XXH3-64 (see variants/templates/ci.h): an unsigned
+ * compare gives the mask of 'A'..'Z', a masked add sets their bit 5 */
+XXH_FORCE_INLINE __m512i xxh3_ci_fold_avx512(__m512i v)
+{
+    __mmask64 const upper = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(v, _mm512_set1_epi8('A')),
+                                                   _mm512_set1_epi8(26));
+    return _mm512_mask_add_epi8(v, upper, v, _mm512_set1_epi8(0x20));
+}
+
+/* XXH3_accumulate_512_avx512() on the folded stripe */
+XXH_FORCE_INLINE void xxh3_ci_accumulate_512_avx512(xxh_u64* XXH_RESTRICT acc, const xxh_u8* XXH_RESTRICT input,
+                                                    const xxh_u8* XXH_RESTRICT secret)
+{
+    __m512i* const xacc        = (__m512i*)acc;
+    __m512i const  data_vec    = xxh3_ci_fold_avx512(_mm512_loadu_si512((const void*)input));
+    __m512i const  data_key    = _mm512_xor_si512(data_vec, _mm512_loadu_si512((const void*)secret));
+    __m512i const  data_key_lo = _mm512_srli_epi64(data_key, 32);
+    __m512i const  product     = _mm512_mul_epu32(data_key, data_key_lo);
+    __m512i const  data_swap   = _mm512_shuffle_epi32(data_vec, (_MM_PERM_ENUM)_MM_SHUFFLE(1, 0, 3, 2));
+    *xacc = _mm512_add_epi64(product, _mm512_add_epi64(*xacc, data_swap));
+}
+
+/* 16-byte reads of the short-input paths (no AVX512VL: SSE compares) */
+XXH_FORCE_INLINE void xxh3_ci_fold128_avx512(__m128i v, xxh_u64* lo, xxh_u64* hi)
+{
+    __m128i const shifted = _mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - 'A')));
+    __m128i const upper   = _mm_cmplt_epi8(shifted, _mm_set1_epi8((char)(0x80 + 26)));
+    __m128i const folded  = _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+    *lo = (xxh_u64)_mm_cvtsi128_si64(folded);
+    *hi = (xxh_u64)_mm_extract_epi64(folded, 1);
+}
+#define XXH3_CI_READ2(p, q, lo, hi) \
+    xxh3_ci_fold128_avx512(_mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)(p)), \
+                                            _mm_loadl_epi64((const __m128i*)(q))), &(lo), &(hi))
+#define XXH3_CI_READ128(p, lo, hi) \
+    xxh3_ci_fold128_avx512(_mm_loadu_si128((const __m128i*)(p)), &(lo), &(hi))
+#define XXH3_CI_FOLD_LINE(dst, src) \
+    _mm512_storeu_si512((void*)(dst), xxh3_ci_fold_avx512(_mm512_loadu_si512((const void*)(src))))
+#define XXH3_CI_ACCUMULATE_512(acc, in, secret) xxh3_ci_accumulate_512_avx512((acc), (in), (secret))
+#include "variants/templates/ci.h"
+
+/* Strided 2D and field-gather hashing (see variants/templates/gather.h) */
+#include "variants/templates/gather.h"
+
+/* Batch canonical and hex encoding (see variants/templates/hex.h) with the
+ * AVX2 kernels of variants/x86/avx2_hooks.h: blocks are 16 bytes */
+#include "variants/x86/avx2_hooks.h"
+#define XXH3_HEX_BSWAP(dst, src) xxh3_hex_bswap_avx2((dst), (src))
+#define XXH3_HEX_ENCODE(dst, src) xxh3_hex_encode_avx2((dst), (src))
+#define XXH3_HEX_DECODE(dst, src) xxh3_hex_decode_avx2((dst), (src))
+#include "variants/templates/hex.h"
+
+/* Blocked Bloom filter (see variants/templates/bloom.h) with the AVX2
+ * kernels of variants/x86/avx2_hooks.h: a block is one ymm */
+#define XXH3_BLOOM_SET(block, key, salt) xxh3_bloom_set_avx2((block), (key), (salt))
+#define XXH3_BLOOM_TEST(block, key, salt) xxh3_bloom_test_avx2((block), (key), (salt))
+#include "variants/templates/bloom.h"
+
+/* HyperLogLog sketches (see variants/templates/hll.h). Without AVX512CD's
+ * VPLZCNTQ, the ranks of 8 hashes come from the exponents of the shifted
+ * hashes converted to double (VCVTUQQ2PD, AVX512DQ) */
+XXH_FORCE_INLINE void xxh3_hll_rank8_avx512(xxh_u8* ranks, const xxh_u64* hashes, unsigned p)
+{
+    __m512i const w = _mm512_or_si512(_mm512_sll_epi64(_mm512_loadu_si512(hashes), _mm_cvtsi32_si128((int)p)),
+                                      _mm512_set1_epi64((long long)((xxh_u64)1 << (p - 1))));
+    /* Clearing the bit below each set bit keeps the top one and leaves the
+     * value too far from the next power of two for the conversion to round
+     * up, so the exponent is the position of the top bit */
+    __m512i const y = _mm512_andnot_si512(_mm512_srli_epi64(w, 1), w);
+    __m512i const e = _mm512_srli_epi64(_mm512_castpd_si512(_mm512_cvtepu64_pd(y)), 52);
+    /* rank = leading zeros + 1 = 64 - (e - 1023) */
+    __m512i const r = _mm512_sub_epi64(_mm512_set1_epi64(1087), e);
+    _mm_storel_epi64((__m128i*)(void*)ranks, _mm512_cvtepi64_epi8(r));
+}
+
+/* Two zmm per iteration: merging is bound by memory bandwidth */
+XXH_FORCE_INLINE void xxh3_hll_max_avx512(xxh_u8* dst, const xxh_u8* src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 128 <= n; i += 128) {
+        _mm512_storeu_si512(dst + i, _mm512_max_epu8(_mm512_loadu_si512(dst + i), _mm512_loadu_si512(src + i)));
+        _mm512_storeu_si512(dst + i + 64,
+                            _mm512_max_epu8(_mm512_loadu_si512(dst + i + 64), _mm512_loadu_si512(src + i + 64)));
+    }
+    for (; i < n; i += 16) {
+        __m128i* const d = (__m128i*)(void*)(dst + i);
+        _mm_storeu_si128(d, _mm_max_epu8(_mm_loadu_si128(d),
+                                         _mm_loadu_si128((const __m128i*)(const void*)(src + i))));
+    }
+}
+#define XXH3_HLL_RANK8(ranks, hashes, p) xxh3_hll_rank8_avx512((ranks), (hashes), (p))
+#define XXH3_HLL_MAX(dst, src, n) xxh3_hll_max_avx512((dst), (src), (n))
+#include "variants/templates/hll.h"
+
+/* Multiset hashes (see variants/templates/multiset.h) */
+#include "variants/templates/multiset.h"
+
+/* Minimal perfect hash functions (see variants/templates/mphf.h) */
+#include "variants/templates/mphf.h"
+
+/* Hash partitioning (see variants/templates/partition.h): 8-byte keys are
+ * hashed 8 per vector with `vprolq` and `vpmullq` */
+XXH_FORCE_INLINE void xxh3_partition_hash8_avx512(xxh_u64* out, const xxh_u8* keys, xxh_u64 bitflip)
+{
+    __m512i const mx2 = _mm512_set1_epi64((long long)PRIME_MX2);
+    __m512i h = _mm512_xor_si512(_mm512_rol_epi64(_mm512_loadu_si512((const void*)keys), 32),
+                                 _mm512_set1_epi64((long long)bitflip));
+    h = _mm512_ternarylogic_epi64(h, _mm512_rol_epi64(h, 49), _mm512_rol_epi64(h, 24), 0x96);
+    h = _mm512_mullo_epi64(h, mx2);
+    h = _mm512_xor_si512(h, _mm512_add_epi64(_mm512_srli_epi64(h, 35), _mm512_set1_epi64(8)));
+    h = _mm512_mullo_epi64(h, mx2);
+    _mm512_storeu_si512((void*)out, _mm512_xor_si512(h, _mm512_srli_epi64(h, 28)));
+}
+#define XXH3_PARTITION_NT_LINE(dst, src) \
+    _mm512_stream_si512((void*)(dst), _mm512_loadu_si512((const void*)(src)))
+#define XXH3_PARTITION_NT_FENCE()        _mm_sfence()
+#define XXH3_PARTITION_HASH8(out, keys, bitflip) xxh3_partition_hash8_avx512((out), (keys), (bitflip))
+#include "variants/templates/partition.h"
+
+/* Jump and rendezvous hashing (see variants/templates/consistent.h) */
+#include "variants/templates/consistent.h"
+
+/* Per-block checksums (see variants/templates/blocks.h) */
+#include "variants/templates/blocks.h"
@@ -5,6 +5,12 @@
 #include "xxhash.h"
 
 #include "xxh3_converters.h"
+#include "xxh3_state_internal.h"
+#include "xxh3_hll_internal.h"
+#include "xxh3_mphf_internal.h"
+#include "xxh3_partition_internal.h"
+#include "xxh3_consistent_internal.h"
+#include "xxh3_blocks_internal.h"
 #include "common/internal_utils.h"
 
 uint64_t xxh3_64_sse2(const void* input, size_t size, uint64_t seed)
@@ -47,3 +53,191 @@ xxh3_128_t xxh3_128_sse2_unseeded(const void* input, size_t size)
     });
     return xxh128_to_xxh3(XXH3_128bits_withSeed(input, size, 0));
 }
+
+/* Non-temporal long-input kernels: xxh3_64_nt_sse2(), xxh3_128_nt_sse2() */
+#define XXH3_VARIANT sse2
+#include "variants/templates/nt.h"
+
+/* Multi-seed XXH3-64, scalar per-seed path (see variants/templates/multiseed.h) */
+#include "variants/templates/multiseed.h"
+
+/* Lockstep update of many streams (see variants/templates/multistream.h) */
+#include "variants/templates/multistream.h"
+
+/* Fused copy-and-hash (see variants/templates/copy.h) */
+XXH_FORCE_INLINE void xxh3_copy_nt_line_sse2(xxh_u8* dst, const xxh_u8* src)
+{
+    _mm_stream_si128((__m128i*)dst,      _mm_loadu_si128((const __m128i*)src));
+    _mm_stream_si128((__m128i*)dst + 1,  _mm_loadu_si128((const __m128i*)src + 1));
+    _mm_stream_si128((__m128i*)dst + 2,  _mm_loadu_si128((const __m128i*)src + 2));
+    _mm_stream_si128((__m128i*)dst + 3,  _mm_loadu_si128((const __m128i*)src + 3));
+}
+#define XXH3_COPY_NT_LINE(dst, src) xxh3_copy_nt_line_sse2((dst), (src))
+#define XXH3_COPY_NT_FENCE()        _mm_sfence()
+#include "variants/templates/copy.h"
+
+/* C-string hashing (see variants/templates/cstr.h) */
+static XXH3_NO_SANITIZE_ADDRESS size_t xxh3_cstr_line_nul_sse2(const xxh_u8* line, size_t from)
+{
+    __m128i const zero = _mm_setzero_si128();
+    const __m128i* const v = (const __m128i*)line;
+    xxh_u64 m = (xxh_u64)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(v),     zero))
+             | (xxh_u64)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(v + 1), zero)) << 16
+             | (xxh_u64)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(v + 2), zero)) << 32
+             | (xxh_u64)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(v + 3), zero)) << 48;
+    m &= ~(xxh_u64)0 << from;
+    return m ? xxh3_ctz64(m) : 64;
+}
+#define XXH3_CSTR_LINE_NUL(line, from) xxh3_cstr_line_nul_sse2((line), (from))
+#include "variants/templates/cstr.h"
+
+/* Case-insensitive XXH3-64 (see variants/templates/ci.h): 'A'..'Z' are moved
+ * to the bottom of the signed byte range, so one compare finds them */
+XXH_FORCE_INLINE __m128i xxh3_ci_fold_sse2(__m128i v)
+{
+    __m128i const shifted = _mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - 'A')));
+    __m128i const upper   = _mm_cmplt_epi8(shifted, _mm_set1_epi8((char)(0x80 + 26)));
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+XXH_FORCE_INLINE void xxh3_ci_fold_line_sse2(xxh_u8* dst, const xxh_u8* src)
+{
+    size_t i;
+    for (i = 0; i < 4; i++) {
+        _mm_storeu_si128((__m128i*)dst + i, xxh3_ci_fold_sse2(_mm_loadu_si128((const __m128i*)src + i)));
+    }
+}
+
+/* XXH3_accumulate_512_sse2() on the folded stripe */
+XXH_FORCE_INLINE void xxh3_ci_accumulate_512_sse2(xxh_u64* XXH_RESTRICT acc, const xxh_u8* XXH_RESTRICT input,
+                                                  const xxh_u8* XXH_RESTRICT secret)
+{
+    __m128i* const xacc = (__m128i*)acc;
+    size_t i;
+    for (i = 0; i < XXH_STRIPE_LEN / sizeof(__m128i); i++) {
+        __m128i const data_vec    = xxh3_ci_fold_sse2(_mm_loadu_si128((const __m128i*)input + i));
+        __m128i const data_key    = _mm_xor_si128(data_vec, _mm_loadu_si128((const __m128i*)secret + i));
+        __m128i const data_key_lo = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        __m128i const product     = _mm_mul_epu32(data_key, data_key_lo);
+        __m128i const data_swap   = _mm_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2));
+        xacc[i] = _mm_add_epi64(product, _mm_add_epi64(xacc[i], data_swap));
+    }
+}
+
+/* 16-byte reads of the short-input paths */
+XXH_FORCE_INLINE void xxh3_ci_fold128_sse2(__m128i v, xxh_u64* lo, xxh_u64* hi)
+{
+    __m128i const folded = xxh3_ci_fold_sse2(v);
+    *lo = (xxh_u64)_mm_cvtsi128_si64(folded);
+    *hi = (xxh_u64)_mm_cvtsi128_si64(_mm_unpackhi_epi64(folded, folded));
+}
+#define XXH3_CI_READ2(p, q, lo, hi) \
+    xxh3_ci_fold128_sse2(_mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)(p)), \
+                                            _mm_loadl_epi64((const __m128i*)(q))), &(lo), &(hi))
+#define XXH3_CI_READ128(p, lo, hi) \
+    xxh3_ci_fold128_sse2(_mm_loadu_si128((const __m128i*)(p)), &(lo), &(hi))
+#define XXH3_CI_FOLD_LINE(dst, src)             xxh3_ci_fold_line_sse2((dst), (src))
+#define XXH3_CI_ACCUMULATE_512(acc, in, secret) xxh3_ci_accumulate_512_sse2((acc), (in), (secret))
+#include "variants/templates/ci.h"
+
+/* Strided 2D and field-gather hashing (see variants/templates/gather.h) */
+#include "variants/templates/gather.h"
+
+/* Batch canonical and hex encoding (see variants/templates/hex.h). SSE2 has
+ * no byte shuffle: bytes are swapped within words, then words reversed. */
+XXH_FORCE_INLINE void xxh3_hex_bswap_sse2(xxh_u8* dst, const xxh_u8* src)
+{
+    __m128i v = _mm_loadu_si128((const __m128i*)(const void*)src);
+    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+    _mm_storeu_si128((__m128i*)(void*)dst, v);
+}
+
+/* Nibbles 0..15 to lowercase hex digits */
+XXH_FORCE_INLINE __m128i xxh3_hex_digits_sse2(__m128i n)
+{
+    __m128i const alpha = _mm_and_si128(_mm_cmpgt_epi8(n, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+    return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')), alpha);
+}
+
+XXH_FORCE_INLINE void xxh3_hex_encode_sse2(xxh_u8* dst, const xxh_u8* src)
+{
+    __m128i const v    = _mm_loadu_si128((const __m128i*)(const void*)src);
+    __m128i const mask = _mm_set1_epi8(0x0F);
+    __m128i const hi   = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+    __m128i const lo   = _mm_and_si128(v, mask);
+    _mm_storeu_si128((__m128i*)(void*)dst, xxh3_hex_digits_sse2(_mm_unpacklo_epi8(hi, lo)));
+    _mm_storeu_si128((__m128i*)(void*)(dst + 16), xxh3_hex_digits_sse2(_mm_unpackhi_epi8(hi, lo)));
+}
+
+/* Hex digits to nibbles, clearing the lanes of *ok that hold anything else.
+ * Bytes >= 0x80 are negative and fail both signed range checks. */
+XXH_FORCE_INLINE __m128i xxh3_hex_nibbles_sse2(__m128i c, __m128i* ok)
+{
+    __m128i const lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    __m128i const dec   = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+    __m128i const alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                        _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+    *ok = _mm_and_si128(*ok, _mm_or_si128(dec, alpha));
+    return _mm_or_si128(_mm_and_si128(dec, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+                        _mm_and_si128(alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+}
+
+/* Nibble pairs (high one first) in 16-bit lanes to bytes in those lanes */
+XXH_FORCE_INLINE __m128i xxh3_hex_pairs_sse2(__m128i n)
+{
+    return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(n, _mm_set1_epi16(0x00FF)), 4),
+                        _mm_srli_epi16(n, 8));
+}
+
+XXH_FORCE_INLINE int xxh3_hex_decode_sse2(xxh_u8* dst, const xxh_u8* src)
+{
+    __m128i ok = _mm_set1_epi8(-1);
+    __m128i const a = xxh3_hex_nibbles_sse2(_mm_loadu_si128((const __m128i*)(const void*)src), &ok);
+    __m128i const b = xxh3_hex_nibbles_sse2(_mm_loadu_si128((const __m128i*)(const void*)(src + 16)), &ok);
+    _mm_storeu_si128((__m128i*)(void*)dst, _mm_packus_epi16(xxh3_hex_pairs_sse2(a), xxh3_hex_pairs_sse2(b)));
+    return _mm_movemask_epi8(ok) == 0xFFFF;
+}
+#define XXH3_HEX_BSWAP(dst, src) xxh3_hex_bswap_sse2((dst), (src))
+#define XXH3_HEX_ENCODE(dst, src) xxh3_hex_encode_sse2((dst), (src))
+#define XXH3_HEX_DECODE(dst, src) xxh3_hex_decode_sse2((dst), (src))
+#include "variants/templates/hex.h"
+
+/* Blocked Bloom filter (see variants/templates/bloom.h). SSE2 has neither a
+ * 32-bit multiply nor per-lane shifts, so the eight bits are set and tested
+ * one by one as in the scalar variant */
+#include "variants/templates/bloom.h"
+
+/* HyperLogLog sketches (see variants/templates/hll.h). Ranks are counted
+ * one hash at a time (SSE2 has no lane-wise count or 32-bit maximum); the
+ * register maximum is PMAXUB */
+XXH_FORCE_INLINE void xxh3_hll_max_sse2(xxh_u8* dst, const xxh_u8* src, size_t n)
+{
+    size_t i;
+    for (i = 0; i < n; i += 16) {
+        __m128i* const d = (__m128i*)(void*)(dst + i);
+        _mm_storeu_si128(d, _mm_max_epu8(_mm_loadu_si128(d),
+                                         _mm_loadu_si128((const __m128i*)(const void*)(src + i))));
+    }
+}
+#define XXH3_HLL_MAX(dst, src, n) xxh3_hll_max_sse2((dst), (src), (n))
+#include "variants/templates/hll.h"
+
+/* Multiset hashes (see variants/templates/multiset.h) */
+#include "variants/templates/multiset.h"
+
+/* Minimal perfect hash functions (see variants/templates/mphf.h) */
+#include "variants/templates/mphf.h"
+
+/* Hash partitioning (see variants/templates/partition.h): MOVNTDQ lines.
+ * SSE2 has no 64-bit lane multiply; keys are hashed one at a time. */
+#define XXH3_PARTITION_NT_LINE(dst, src) xxh3_copy_nt_line_sse2((dst), (src))
+#define XXH3_PARTITION_NT_FENCE()        _mm_sfence()
+#include "variants/templates/partition.h"
+
+/* Jump and rendezvous hashing (see variants/templates/consistent.h) */
+#include "variants/templates/consistent.h"
+
+/* Per-block checksums (see variants/templates/blocks.h) */
+#include "variants/templates/blocks.h"
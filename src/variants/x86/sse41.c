@@ -0,0 +1,93 @@
+#include "xxh3.h"
+
+#define XXH_VECTOR XXH_SSE2
+#define XXH_INLINE_ALL
+#include "xxhash.h"
+
+#include <smmintrin.h>
+
+#include "xxh3_state_internal.h"
+#include "xxh3_xxh32_internal.h"
+#include "common/internal_utils.h"
+
+/* XXH32 kernels built on `pmulld`, the SSE4.1 instruction that makes a
+ * 32-bit lane multiply a single op. XXH3 has no SSE4.1 code path in the
+ * vendor, so this library only hosts XXH32. */
+
+XXH_FORCE_INLINE __m128i xxh_batch_round32_sse41(__m128i acc, __m128i input)
+{
+    acc = _mm_add_epi32(acc, _mm_mullo_epi32(input, _mm_set1_epi32((int)XXH_PRIME32_2)));
+    acc = _mm_or_si128(_mm_slli_epi32(acc, 13), _mm_srli_epi32(acc, 19));
+    return _mm_mullo_epi32(acc, _mm_set1_epi32((int)XXH_PRIME32_1));
+}
+
+/* ------------------------------------------------------------------------
+ * Single-stream XXH32 (see variants/templates/xxh32.h)
+ * ------------------------------------------------------------------------ */
+
+static void xxh32_stripes_vec(xxh_u32 v[4], const xxh_u8* p, size_t nbStripes)
+{
+    __m128i acc = _mm_loadu_si128((const __m128i*)v);
+    size_t n;
+
+    for (n = 0; n < nbStripes; n++) {
+        acc = xxh_batch_round32_sse41(acc, _mm_loadu_si128((const __m128i*)(p + 16 * n)));
+    }
+    _mm_storeu_si128((__m128i*)v, acc);
+}
+
+#define XXH3_VARIANT sse41
+#include "variants/templates/xxh32.h"
+
+/* ------------------------------------------------------------------------
+ * Multi-buffer XXH32 (see variants/templates/batch.h): 4 messages per pass
+ * ------------------------------------------------------------------------ */
+
+static void xxh32_batch_stripes_sse41(xxh_u32 acc[4][4], const xxh_u8* in[4],
+                                      const size_t step[4], size_t nbStripes)
+{
+    __m128i a0 = _mm_load_si128((const __m128i*)acc[0]);
+    __m128i a1 = _mm_load_si128((const __m128i*)acc[1]);
+    __m128i a2 = _mm_load_si128((const __m128i*)acc[2]);
+    __m128i a3 = _mm_load_si128((const __m128i*)acc[3]);
+    const xxh_u8* p0 = in[0];
+    const xxh_u8* p1 = in[1];
+    const xxh_u8* p2 = in[2];
+    const xxh_u8* p3 = in[3];
+    size_t n;
+
+    for (n = 0; n < nbStripes; n++) {
+        /* 4x4 transpose of 32-bit words: w_k = word k of every message */
+        __m128i const r0 = _mm_loadu_si128((const __m128i*)p0);
+        __m128i const r1 = _mm_loadu_si128((const __m128i*)p1);
+        __m128i const r2 = _mm_loadu_si128((const __m128i*)p2);
+        __m128i const r3 = _mm_loadu_si128((const __m128i*)p3);
+        __m128i const t0 = _mm_unpacklo_epi32(r0, r1);
+        __m128i const t1 = _mm_unpacklo_epi32(r2, r3);
+        __m128i const t2 = _mm_unpackhi_epi32(r0, r1);
+        __m128i const t3 = _mm_unpackhi_epi32(r2, r3);
+
+        a0 = xxh_batch_round32_sse41(a0, _mm_unpacklo_epi64(t0, t1));
+        a1 = xxh_batch_round32_sse41(a1, _mm_unpackhi_epi64(t0, t1));
+        a2 = xxh_batch_round32_sse41(a2, _mm_unpacklo_epi64(t2, t3));
+        a3 = xxh_batch_round32_sse41(a3, _mm_unpackhi_epi64(t2, t3));
+        p0 += step[0];
+        p1 += step[1];
+        p2 += step[2];
+        p3 += step[3];
+    }
+    _mm_store_si128((__m128i*)acc[0], a0);
+    _mm_store_si128((__m128i*)acc[1], a1);
+    _mm_store_si128((__m128i*)acc[2], a2);
+    _mm_store_si128((__m128i*)acc[3], a3);
+    in[0] = p0;
+    in[1] = p1;
+    in[2] = p2;
+    in[3] = p3;
+}
+
+#define XXH_BATCH_FN      xxh32_batch_sse41
+#define XXH_BATCH_BITS    32
+#define XXH_BATCH_LANES   4
+#define XXH_BATCH_STRIPES xxh32_batch_stripes_sse41
+#include "variants/templates/batch.h"
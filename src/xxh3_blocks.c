@@ -0,0 +1,173 @@
+/* _POSIX_C_SOURCE 200112L: pthreads and sysconf under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "xxh3.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#  include <pthread.h>
+#  include <unistd.h>
+#  define XXH3_BLOCKS_THREADS 1
+#else
+#  define XXH3_BLOCKS_THREADS 0
+#endif
+
+#include "common/internal_utils.h"
+#include "xxh3_blocks_internal.h"
+
+/* Threaded driver of per-block checksums (see src/xxh3_blocks_internal.h).
+ * Thread t hashes blocks [t * n / T, (t + 1) * n / T) with the variant's
+ * kernel. When verifying, each thread keeps the first max_bad mismatches
+ * of its range in its own list, and the lists are concatenated in thread
+ * order, which is block order. */
+
+typedef struct {
+    const unsigned char* buf;
+    size_t               len;
+    size_t               block_size;
+    uint64_t             seed;
+    size_t               n;           /* blocks */
+    unsigned             threads;
+    uint64_t*            out;
+    const uint64_t*      expected;
+    size_t*              bad;         /* `stride` per thread */
+    size_t               max_bad;
+    size_t               stride;      /* min(max_bad, blocks of the longest range) */
+    size_t               found[64];   /* mismatches per thread */
+    xxh3_blocks_fn       fn;
+} xxh3_blocks_job_t;
+
+typedef struct {
+    xxh3_blocks_job_t* job;
+    unsigned           t;
+} xxh3_blocks_task_t;
+
+static void xxh3_blocks_task(xxh3_blocks_job_t* job, unsigned t)
+{
+    size_t const share = job->n / job->threads;
+    size_t const extra = job->n % job->threads;
+    size_t const begin = t * share + (t < extra ? t : extra);
+    size_t const end   = begin + share + (t < extra ? 1 : 0);
+
+    job->found[t] = job->fn(job->buf, job->len, job->block_size, job->seed, begin, end, job->out,
+                            job->expected, job->stride ? job->bad + t * job->stride : NULL,
+                            job->stride);
+}
+
+#if XXH3_BLOCKS_THREADS
+static void* xxh3_blocks_worker(void* arg)
+{
+    const xxh3_blocks_task_t* const task = (const xxh3_blocks_task_t*)arg;
+    xxh3_blocks_task(task->job, task->t);
+    return NULL;
+}
+#endif
+
+/* Runs one range per thread, the calling one included; a range whose
+ * thread could not be started is run by the calling thread */
+static void xxh3_blocks_run(xxh3_blocks_job_t* job)
+{
+#if XXH3_BLOCKS_THREADS
+    pthread_t          pool[64];
+    xxh3_blocks_task_t tasks[64];
+    int                started[64];
+#endif
+    unsigned t;
+
+#if XXH3_BLOCKS_THREADS
+    for (t = 1; t < job->threads; t++) {
+        tasks[t].job = job;
+        tasks[t].t   = t;
+        started[t]   = pthread_create(&pool[t], NULL, xxh3_blocks_worker, &tasks[t]) == 0;
+    }
+    xxh3_blocks_task(job, 0);
+    for (t = 1; t < job->threads; t++) {
+        if (started[t]) {
+            pthread_join(pool[t], NULL);
+        } else {
+            xxh3_blocks_task(job, t);
+        }
+    }
+#else
+    for (t = 0; t < job->threads; t++) {
+        xxh3_blocks_task(job, t);
+    }
+#endif
+}
+
+int xxh3_blocks_with(const void* buf, size_t len, size_t block_size, uint64_t seed, uint64_t* out,
+                     const uint64_t* expected, size_t* bad, size_t max_bad, size_t* n_bad,
+                     unsigned threads, xxh3_blocks_fn fn)
+{
+    xxh3_blocks_job_t job;
+    size_t            total, copied;
+    unsigned          t;
+
+    if (block_size == 0 || (buf == NULL && len > 0)) {
+        return XXH3_ERROR;
+    }
+    if (n_bad == NULL ? out == NULL && len > 0
+                      : (expected == NULL && len > 0) || (bad == NULL && max_bad > 0)) {
+        return XXH3_ERROR;
+    }
+#if XXH3_BLOCKS_THREADS
+    if (threads == 0) {
+        long const cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? (unsigned)cpus : 1;
+    }
+#else
+    threads = 1;
+#endif
+    threads = (threads == 0) ? 1 : (threads > 64) ? 64 : threads;
+    if (len / XXH3_BLOCKS_MIN_BYTES < threads) {
+        threads = (len < XXH3_BLOCKS_MIN_BYTES) ? 1 : (unsigned)(len / XXH3_BLOCKS_MIN_BYTES);
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.buf        = (const unsigned char*)buf;
+    job.len        = len;
+    job.block_size = block_size;
+    job.seed       = seed;
+    job.n          = xxh3_blocks_count(len, block_size);
+    job.threads    = (job.n < threads) ? (unsigned)(job.n ? job.n : 1) : threads;
+    job.out        = out;
+    job.expected   = expected;
+    job.bad        = bad;
+    job.max_bad    = max_bad;
+    job.stride     = max_bad;
+    job.fn         = fn;
+    if (n_bad != NULL && job.threads > 1 && max_bad > 0) {
+        /* a list per thread, of no more than the blocks in its range */
+        size_t const longest = job.n / job.threads + 1;
+        job.stride = (max_bad < longest) ? max_bad : longest;
+        job.bad    = (size_t*)malloc(job.threads * job.stride * sizeof(size_t));
+        if (job.bad == NULL) {
+            return XXH3_ERROR;
+        }
+    }
+
+    xxh3_blocks_run(&job);
+    if (n_bad == NULL) {
+        return XXH3_OK;
+    }
+    for (t = 0, total = 0, copied = 0; t < job.threads; t++) {
+        size_t const kept = (job.found[t] < job.stride) ? job.found[t] : job.stride;
+        size_t const take = (kept < max_bad - copied) ? kept : max_bad - copied;
+        if (job.bad != bad && take > 0) {
+            memcpy(bad + copied, job.bad + t * job.stride, take * sizeof(size_t));
+        }
+        copied += take;
+        total  += job.found[t];
+    }
+    if (job.bad != bad) {
+        free(job.bad);
+    }
+    *n_bad = total;
+    return XXH3_OK;
+}
@@ -0,0 +1,43 @@
+#ifndef XXH3_BLOCKS_INTERNAL_H
+#define XXH3_BLOCKS_INTERNAL_H
+
+/* Per-block checksums, shared by the threaded driver (src/xxh3_blocks.c)
+ * and the per-variant block kernels (variants/templates/blocks.h).
+ *
+ * Block i of a buffer is bytes [i * block_size, (i + 1) * block_size), the
+ * last one possibly shorter. The driver splits the blocks into one
+ * contiguous range per thread; the kernel hashes a range, and either
+ * stores the hashes or compares them with the expected ones.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xxh3.h"
+#include "common/internal_utils.h"
+
+/* Bytes per thread below which fewer threads are started */
+#define XXH3_BLOCKS_MIN_BYTES ((size_t)1 << 20)
+
+static inline size_t xxh3_blocks_count(size_t len, size_t block_size)
+{
+    return len / block_size + (len % block_size != 0);
+}
+
+/* Hashes blocks [begin, end) of buf[0..len) under `seed`. With expected
+ * NULL, stores block i's hash to out[i] and returns 0. Otherwise compares
+ * it with expected[i], writes the indices of the first max_bad mismatches
+ * in order to bad[], and returns the number of mismatches. */
+typedef size_t (*xxh3_blocks_fn)(const unsigned char* buf, size_t len, size_t block_size,
+                                 uint64_t seed, size_t begin, size_t end, uint64_t* out,
+                                 const uint64_t* expected, size_t* bad, size_t max_bad);
+
+/* xxh3_64_blocks_mt_<variant>() with n_bad NULL, and
+ * xxh3_64_blocks_verify_<variant>() otherwise, with the variant's kernel */
+XXH3_WRAPPER_INTERNAL int xxh3_blocks_with(const void* buf, size_t len, size_t block_size,
+                                           uint64_t seed, uint64_t* out,
+                                           const uint64_t* expected, size_t* bad,
+                                           size_t max_bad, size_t* n_bad, unsigned threads,
+                                           xxh3_blocks_fn fn);
+
+#endif /* XXH3_BLOCKS_INTERNAL_H */
@@ -0,0 +1,131 @@
+#include "xxh3.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common/internal_utils.h"
+
+/* Blocked Bloom filter images. Adding and testing keys is per variant (see
+ * variants/templates/bloom.h); this file creates, checks and merges images.
+ *
+ * Layout (all offsets in bytes):
+ *     0  magic "XXH3BLOM"
+ *     8  format version, uint32 little-endian (XXH3_BLOOM_VERSION)
+ *    12  block size, uint32 little-endian (32)
+ *    16  block count, uint64 little-endian
+ *    24  seed of the key hash, uint64 little-endian
+ *    32  image size, uint64 little-endian (xxh3_bloom_size())
+ *    40  zero up to the first block
+ *    64  the blocks, each eight uint32 words in little-endian order */
+
+#define XXH3_BLOOM_HEADER 64
+#define XXH3_BLOOM_BLOCK  32
+
+/* The block index is a 32-bit multiply-shift of the hash's high half */
+#define XXH3_BLOOM_MAX_BLOCKS ((uint64_t)1 << 32)
+
+static const unsigned char k_bloom_magic[8] = { 'X', 'X', 'H', '3', 'B', 'L', 'O', 'M' };
+
+static uint64_t xxh3_bloom_read_le(const unsigned char* p, unsigned bytes)
+{
+    uint64_t v = 0;
+    while (bytes-- > 0) {
+        v = (v << 8) | p[bytes];
+    }
+    return v;
+}
+
+static void xxh3_bloom_write_le(unsigned char* p, uint64_t v, unsigned bytes)
+{
+    unsigned i;
+    for (i = 0; i < bytes; i++) {
+        p[i] = (unsigned char)(v >> (8 * i));
+    }
+}
+
+uint64_t xxh3_bloom_blocks(uint64_t keys, unsigned bits_per_key)
+{
+    uint64_t blocks;
+    if (bits_per_key == 0 || keys > UINT64_MAX / bits_per_key) {
+        return 0;
+    }
+    blocks = (keys * bits_per_key + 8 * XXH3_BLOOM_BLOCK - 1) / (8 * XXH3_BLOOM_BLOCK);
+    return (blocks == 0) ? 1 : blocks;
+}
+
+size_t xxh3_bloom_size(uint64_t blocks)
+{
+    if (blocks == 0 || blocks > XXH3_BLOOM_MAX_BLOCKS
+        || blocks > (SIZE_MAX - XXH3_BLOOM_HEADER) / XXH3_BLOOM_BLOCK) {
+        return 0;
+    }
+    return XXH3_BLOOM_HEADER + XXH3_BLOOM_BLOCK * (size_t)blocks;
+}
+
+int xxh3_bloom_init(xxh3_bloom_t* filter, void* image, size_t size, uint64_t blocks, uint64_t seed)
+{
+    unsigned char* const out  = (unsigned char*)image;
+    size_t const         need = xxh3_bloom_size(blocks);
+
+    if (filter == NULL || image == NULL || need == 0 || size < need) {
+        return XXH3_ERROR;
+    }
+    memset(out, 0, need);
+    memcpy(out, k_bloom_magic, sizeof(k_bloom_magic));
+    xxh3_bloom_write_le(out + 8, XXH3_BLOOM_VERSION, 4);
+    xxh3_bloom_write_le(out + 12, XXH3_BLOOM_BLOCK, 4);
+    xxh3_bloom_write_le(out + 16, blocks, 8);
+    xxh3_bloom_write_le(out + 24, seed, 8);
+    xxh3_bloom_write_le(out + 32, (uint64_t)need, 8);
+    filter->blocks  = out + XXH3_BLOOM_HEADER;
+    filter->nblocks = blocks;
+    filter->seed    = seed;
+    return XXH3_OK;
+}
+
+int xxh3_bloom_view(xxh3_bloom_t* filter, void* image, size_t size)
+{
+    unsigned char* const in = (unsigned char*)image;
+    uint64_t blocks;
+
+    if (filter == NULL || image == NULL || size < XXH3_BLOOM_HEADER) {
+        return XXH3_ERROR;
+    }
+    blocks = xxh3_bloom_read_le(in + 16, 8);
+    if (memcmp(in, k_bloom_magic, sizeof(k_bloom_magic)) != 0
+        || xxh3_bloom_read_le(in + 8, 4) != XXH3_BLOOM_VERSION
+        || xxh3_bloom_read_le(in + 12, 4) != XXH3_BLOOM_BLOCK
+        || xxh3_bloom_size(blocks) == 0
+        || xxh3_bloom_read_le(in + 32, 8) != xxh3_bloom_size(blocks)
+        || size < xxh3_bloom_size(blocks)) {
+        return XXH3_ERROR;
+    }
+    filter->blocks  = in + XXH3_BLOOM_HEADER;
+    filter->nblocks = blocks;
+    filter->seed    = xxh3_bloom_read_le(in + 24, 8);
+    return XXH3_OK;
+}
+
+int xxh3_bloom_merge(xxh3_bloom_t* dst, const xxh3_bloom_t* src)
+{
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (dst == NULL || src == NULL) {
+            return XXH3_ERROR;
+        }
+    });
+    if (dst->nblocks != src->nblocks || dst->seed != src->seed) {
+        return XXH3_ERROR;
+    }
+    /* word-wise OR; the compiler vectorizes it */
+    for (i = 0; i < (size_t)dst->nblocks * (XXH3_BLOOM_BLOCK / 8); i++) {
+        uint64_t a, b;
+        memcpy(&a, dst->blocks + 8 * i, 8);
+        memcpy(&b, src->blocks + 8 * i, 8);
+        a |= b;
+        memcpy(dst->blocks + 8 * i, &a, 8);
+    }
+    return XXH3_OK;
+}
@@ -0,0 +1,14 @@
+#include "xxh3.h"
+
+#include <stdint.h>
+
+#include "xxh3_consistent_internal.h"
+
+/* Jump consistent hash of an already computed key hash. Hashing keys, and
+ * rendezvous hashing, are per variant (see
+ * variants/templates/consistent.h). */
+
+uint32_t xxh3_jump_bucket(uint64_t hash, uint32_t buckets)
+{
+    return xxh3_jump(hash, buckets);
+}
@@ -0,0 +1,28 @@
+#ifndef XXH3_CONSISTENT_INTERNAL_H
+#define XXH3_CONSISTENT_INTERNAL_H
+
+/* Consistent hashing, shared by xxh3_jump_bucket() (src/xxh3_consistent.c)
+ * and the per-variant batch and rendezvous forms
+ * (variants/templates/consistent.h). */
+
+#include <stdint.h>
+
+#include "xxh3.h"
+
+/* Jump consistent hash of Lamping and Veach, "A Fast, Minimal Memory,
+ * Consistent Hash Algorithm" (2014), with their LCG and floating-point
+ * step so that buckets match other implementations for the same hash */
+static inline uint32_t xxh3_jump(uint64_t h, uint32_t buckets)
+{
+    int64_t b = 0;
+    int64_t j = 0;
+
+    while (j < (int64_t)buckets) {
+        b = j;
+        h = h * 2862933555777941757ULL + 1;
+        j = (int64_t)((double)(b + 1) * ((double)(1LL << 31) / (double)((h >> 33) + 1)));
+    }
+    return (uint32_t)b;
+}
+
+#endif /* XXH3_CONSISTENT_INTERNAL_H */
@@ -0,0 +1,392 @@
+#include "xxh3.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xxh3_hll_internal.h"
+#include "common/internal_utils.h"
+
+/* HyperLogLog sketches: creation, the sparse representation and the
+ * estimator. Adding keys and merging dense registers are per variant (see
+ * variants/templates/hll.h).
+ *
+ * The sparse form follows HLL++ (Heule et al., 2013): entries are kept at
+ * the higher precision XXH3_HLL_SPARSE_P, so small cardinalities are counted
+ * as if the sketch had 2^25 registers. Entries are appended unsorted and
+ * compacted (sorted, one per index with the largest rank) when the buffer
+ * fills; the buffer doubles while compaction leaves it more than half full,
+ * up to the size of the dense registers, and then the sketch turns dense.
+ *
+ * The estimate is Ertl's improved raw estimator ("New cardinality estimation
+ * algorithms for HyperLogLog sketches", 2017), computed from the histogram
+ * of register values. It needs neither HLL++'s empirical bias tables nor a
+ * switch to linear counting, and the same code serves both forms. */
+
+#define XXH3_HLL_MIN_P 4
+#define XXH3_HLL_MAX_P 18
+
+/* Initial sparse capacity, in entries */
+#define XXH3_HLL_SPARSE_MIN 16
+
+/* 1 / (2 ln 2) */
+#define XXH3_HLL_ALPHA_INF 0.721347520444481703680
+
+static void* xxh3_hll_default_alloc(void* ctx, size_t size)
+{
+    XXH3_WRAPPER_UNUSED(ctx);
+    return malloc(size);
+}
+
+static void xxh3_hll_default_free(void* ctx, void* ptr, size_t size)
+{
+    XXH3_WRAPPER_UNUSED(ctx);
+    XXH3_WRAPPER_UNUSED(size);
+    free(ptr);
+}
+
+/* Largest sparse capacity: the entries fill as many bytes as the registers */
+static size_t xxh3_hll_sparse_limit(unsigned p)
+{
+    return ((size_t)1 << p) / sizeof(uint32_t);
+}
+
+xxh3_hll_t* xxh3_hll_create(unsigned precision, uint64_t seed, const xxh3_allocator_t* allocator)
+{
+    xxh3_allocator_t a;
+    xxh3_hll_t*      hll;
+    size_t           cap;
+
+    if (precision < XXH3_HLL_MIN_P || precision > XXH3_HLL_MAX_P) {
+        return NULL;
+    }
+    if (allocator != NULL) {
+        a = *allocator;
+        if (a.alloc == NULL || a.free == NULL) {
+            return NULL;
+        }
+    } else {
+        a.alloc = xxh3_hll_default_alloc;
+        a.free  = xxh3_hll_default_free;
+        a.ctx   = NULL;
+    }
+    hll = (xxh3_hll_t*)a.alloc(a.ctx, sizeof(*hll));
+    if (hll == NULL) {
+        return NULL;
+    }
+    cap = xxh3_hll_sparse_limit(precision);
+    cap = (cap < XXH3_HLL_SPARSE_MIN) ? cap : XXH3_HLL_SPARSE_MIN;
+    memset(hll, 0, sizeof(*hll));
+    hll->sparse = (uint32_t*)a.alloc(a.ctx, cap * sizeof(uint32_t));
+    if (hll->sparse == NULL) {
+        a.free(a.ctx, hll, sizeof(*hll));
+        return NULL;
+    }
+    hll->sparse_cap = cap;
+    hll->seed       = seed;
+    hll->p          = precision;
+    hll->allocator  = a;
+    return hll;
+}
+
+void xxh3_hll_free(xxh3_hll_t* hll)
+{
+    if (hll == NULL) {
+        return;
+    }
+    if (hll->registers != NULL) {
+        hll->allocator.free(hll->allocator.ctx, hll->registers, (size_t)1 << hll->p);
+    } else {
+        hll->allocator.free(hll->allocator.ctx, hll->sparse, hll->sparse_cap * sizeof(uint32_t));
+    }
+    hll->allocator.free(hll->allocator.ctx, hll, sizeof(*hll));
+}
+
+void xxh3_hll_clear(xxh3_hll_t* hll)
+{
+    XXH3_WRAPPER_GUARD({
+        if (hll == NULL) {
+            return;
+        }
+    });
+    if (hll->registers != NULL) {
+        memset(hll->registers, 0, (size_t)1 << hll->p);
+    } else {
+        hll->nsparse = 0;
+        hll->nsorted = 0;
+    }
+}
+
+unsigned xxh3_hll_precision(const xxh3_hll_t* hll)
+{
+    XXH3_WRAPPER_GUARD({
+        if (hll == NULL) {
+            return 0;
+        }
+    });
+    return hll->p;
+}
+
+int xxh3_hll_is_dense(const xxh3_hll_t* hll)
+{
+    XXH3_WRAPPER_GUARD({
+        if (hll == NULL) {
+            return 0;
+        }
+    });
+    return hll->registers != NULL;
+}
+
+/* ---------------------------------------------------------------- sparse */
+
+static uint32_t xxh3_hll_sparse_entry(uint64_t hash)
+{
+    return (uint32_t)(hash >> (64 - XXH3_HLL_SPARSE_P)) << 6
+           | (uint32_t)xxh3_hll_rank(hash, XXH3_HLL_SPARSE_P);
+}
+
+/* Register index and rank at precision p of a sparse entry. The index bits
+ * below p are the first hash bits after the dense index: the rank counts
+ * their leading zeros, or continues into the sparse rank if all are 0. */
+static void xxh3_hll_sparse_decode(uint32_t entry, unsigned p, size_t* index, unsigned* rank)
+{
+    unsigned const shift = XXH3_HLL_SPARSE_P - p;
+    uint32_t const idx   = entry >> 6;
+    uint32_t const low   = idx & (((uint32_t)1 << shift) - 1);
+
+    *index = (size_t)(idx >> shift);
+    *rank  = (low != 0) ? xxh3_hll_clz64(low) - (64 - shift) + 1 : shift + (entry & 63);
+}
+
+static int xxh3_hll_cmp_u32(const void* a, const void* b)
+{
+    uint32_t const x = *(const uint32_t*)a;
+    uint32_t const y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* Sorts the entries and keeps, for each index, the one of largest rank */
+static void xxh3_hll_compact(xxh3_hll_t* hll)
+{
+    uint32_t* const e = hll->sparse;
+    size_t i, n = 0;
+
+    if (hll->nsorted == hll->nsparse) {
+        return;
+    }
+    qsort(e, hll->nsparse, sizeof(uint32_t), xxh3_hll_cmp_u32);
+    for (i = 0; i < hll->nsparse; i++) {
+        /* equal indexes are adjacent, in increasing rank */
+        if (n > 0 && (e[n - 1] >> 6) == (e[i] >> 6)) {
+            n--;
+        }
+        e[n++] = e[i];
+    }
+    hll->nsparse = n;
+    hll->nsorted = n;
+}
+
+static void xxh3_hll_dense_entries(xxh3_hll_t* hll, const uint32_t* entries, size_t n)
+{
+    size_t i;
+    for (i = 0; i < n; i++) {
+        size_t   index;
+        unsigned rank;
+        xxh3_hll_sparse_decode(entries[i], hll->p, &index, &rank);
+        if (rank > hll->registers[index]) {
+            hll->registers[index] = (unsigned char)rank;
+        }
+    }
+}
+
+int xxh3_hll_to_dense(xxh3_hll_t* hll)
+{
+    size_t const         m         = (size_t)1 << hll->p;
+    unsigned char* const registers = (unsigned char*)hll->allocator.alloc(hll->allocator.ctx, m);
+
+    if (registers == NULL) {
+        return XXH3_ERROR;
+    }
+    memset(registers, 0, m);
+    hll->registers = registers;
+    xxh3_hll_dense_entries(hll, hll->sparse, hll->nsparse);
+    hll->allocator.free(hll->allocator.ctx, hll->sparse, hll->sparse_cap * sizeof(uint32_t));
+    hll->sparse     = NULL;
+    hll->nsparse    = 0;
+    hll->nsorted    = 0;
+    hll->sparse_cap = 0;
+    return XXH3_OK;
+}
+
+/* Makes room for one more entry: compacts a full buffer, then grows it or
+ * turns the sketch dense if it stays more than half full */
+static int xxh3_hll_sparse_reserve(xxh3_hll_t* hll)
+{
+    size_t    cap;
+    uint32_t* grown;
+
+    if (hll->nsparse < hll->sparse_cap) {
+        return XXH3_OK;
+    }
+    xxh3_hll_compact(hll);
+    if (hll->nsparse <= hll->sparse_cap / 2) {
+        return XXH3_OK;
+    }
+    cap = 2 * hll->sparse_cap;
+    if (cap > xxh3_hll_sparse_limit(hll->p)) {
+        return xxh3_hll_to_dense(hll);
+    }
+    grown = (uint32_t*)hll->allocator.alloc(hll->allocator.ctx, cap * sizeof(uint32_t));
+    if (grown == NULL) {
+        return XXH3_ERROR;
+    }
+    memcpy(grown, hll->sparse, hll->nsparse * sizeof(uint32_t));
+    hll->allocator.free(hll->allocator.ctx, hll->sparse, hll->sparse_cap * sizeof(uint32_t));
+    hll->sparse     = grown;
+    hll->sparse_cap = cap;
+    return XXH3_OK;
+}
+
+static int xxh3_hll_insert_entries(xxh3_hll_t* hll, const uint32_t* entries, size_t n)
+{
+    size_t i;
+    for (i = 0; i < n; i++) {
+        if (xxh3_hll_sparse_reserve(hll) != XXH3_OK) {
+            return XXH3_ERROR;
+        }
+        if (hll->registers != NULL) {
+            xxh3_hll_dense_entries(hll, entries + i, n - i);
+            return XXH3_OK;
+        }
+        hll->sparse[hll->nsparse++] = entries[i];
+    }
+    return XXH3_OK;
+}
+
+int xxh3_hll_add_sparse(xxh3_hll_t* hll, const uint64_t* hashes, size_t n)
+{
+    uint32_t entries[64];
+    size_t   i, j;
+
+    for (i = 0; i < n && hll->registers == NULL; i += j) {
+        size_t const chunk = (n - i < 64) ? n - i : 64;
+        for (j = 0; j < chunk; j++) {
+            entries[j] = xxh3_hll_sparse_entry(hashes[i + j]);
+        }
+        if (xxh3_hll_insert_entries(hll, entries, chunk) != XXH3_OK) {
+            return XXH3_ERROR;
+        }
+    }
+    /* the sketch turned dense part way */
+    for (; i < n; i++) {
+        xxh3_hll_add_hash(hll, hashes[i]);
+    }
+    return XXH3_OK;
+}
+
+int xxh3_hll_merge_sparse(xxh3_hll_t* dst, const xxh3_hll_t* src)
+{
+    /* a merge is idempotent, and inserting would grow the buffer it reads */
+    if (dst == src) {
+        return XXH3_OK;
+    }
+    if (dst->registers != NULL) {
+        xxh3_hll_dense_entries(dst, src->sparse, src->nsparse);
+        return XXH3_OK;
+    }
+    return xxh3_hll_insert_entries(dst, src->sparse, src->nsparse);
+}
+
+int xxh3_hll_add_hash(xxh3_hll_t* hll, uint64_t hash)
+{
+    XXH3_WRAPPER_GUARD({
+        if (hll == NULL) {
+            return XXH3_ERROR;
+        }
+    });
+    if (hll->registers != NULL) {
+        size_t const   index = (size_t)(hash >> (64 - hll->p));
+        unsigned const rank  = xxh3_hll_rank(hash, hll->p);
+        if (rank > hll->registers[index]) {
+            hll->registers[index] = (unsigned char)rank;
+        }
+        return XXH3_OK;
+    }
+    return xxh3_hll_add_sparse(hll, &hash, 1);
+}
+
+/* ------------------------------------------------------------- estimate */
+
+/* x + x^2 + 2 x^4 + 4 x^8 + ..., for 0 <= x < 1 */
+static double xxh3_hll_sigma(double x)
+{
+    double y = 1.0, z = x, prev;
+    do {
+        x    *= x;
+        prev  = z;
+        z    += x * y;
+        y    += y;
+    } while (z != prev);
+    return z;
+}
+
+/* (1 - x - sum (1 - x^(2^-k))^2 2^-k) / 3, for 0 <= x <= 1 */
+static double xxh3_hll_tau(double x)
+{
+    double y = 1.0, z, prev;
+    if (x == 0.0 || x == 1.0) {
+        return 0.0;
+    }
+    z = 1.0 - x;
+    do {
+        x     = sqrt(x);
+        prev  = z;
+        y    *= 0.5;
+        z    -= (1.0 - x) * (1.0 - x) * y;
+    } while (z != prev);
+    return z / 3.0;
+}
+
+/* Ertl's estimate from the histogram c[0..q+1] of m registers */
+static double xxh3_hll_ertl(const uint64_t* c, unsigned q, double m)
+{
+    double   z;
+    unsigned k;
+
+    if ((double)c[0] == m) {
+        return 0.0;
+    }
+    z = m * xxh3_hll_tau(1.0 - (double)c[q + 1] / m);
+    for (k = q; k >= 1; k--) {
+        z = 0.5 * (z + (double)c[k]);
+    }
+    z += m * xxh3_hll_sigma((double)c[0] / m);
+    return XXH3_HLL_ALPHA_INF * m * m / z;
+}
+
+double xxh3_hll_estimate(xxh3_hll_t* hll)
+{
+    uint64_t c[66];
+    size_t   i;
+
+    XXH3_WRAPPER_GUARD({
+        if (hll == NULL) {
+            return 0.0;
+        }
+    });
+    memset(c, 0, sizeof(c));
+    if (hll->registers != NULL) {
+        size_t const m = (size_t)1 << hll->p;
+        for (i = 0; i < m; i++) {
+            c[hll->registers[i]]++;
+        }
+        return xxh3_hll_ertl(c, 64 - hll->p, (double)m);
+    }
+    xxh3_hll_compact(hll);
+    for (i = 0; i < hll->nsparse; i++) {
+        c[hll->sparse[i] & 63]++;
+    }
+    c[0] = ((uint64_t)1 << XXH3_HLL_SPARSE_P) - hll->nsparse;
+    return xxh3_hll_ertl(c, 64 - XXH3_HLL_SPARSE_P, (double)((uint64_t)1 << XXH3_HLL_SPARSE_P));
+}
@@ -0,0 +1,71 @@
+#ifndef XXH3_HLL_INTERNAL_H
+#define XXH3_HLL_INTERNAL_H
+
+/* Internal layout of an `xxh3_hll_t` sketch.
+ *
+ * `src/xxh3_hll.c` owns the sketch: creation, the sparse representation and
+ * estimation. The per-variant add and merge functions
+ * (variants/templates/hll.h) update dense registers directly and hand sparse
+ * sketches back through the functions below.
+ *
+ * A dense sketch has 2^p one-byte registers; register i holds the largest
+ * rank seen among hashes whose top p bits are i, the rank being the number
+ * of leading zeros of the other 64 - p bits plus one. A sparse sketch
+ * instead keeps one uint32_t entry per distinct register at precision
+ * XXH3_HLL_SPARSE_P (index << 6 | rank); it becomes dense once its entries
+ * would take more room than the registers.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xxh3.h"
+#include "common/internal_utils.h"
+
+#define XXH3_HLL_SPARSE_P 25
+
+struct xxh3_hll_s {
+    unsigned char*   registers;    /* 2^p bytes when dense, else NULL */
+    uint32_t*        sparse;       /* sorted and distinct up to nsorted, then unsorted */
+    size_t           nsparse;
+    size_t           nsorted;
+    size_t           sparse_cap;
+    uint64_t         seed;
+    unsigned         p;
+    xxh3_allocator_t allocator;
+};
+
+/* Leading zeros of `w`, which is not 0 */
+static inline unsigned xxh3_hll_clz64(uint64_t w)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_clzll(w);
+#else
+    unsigned n = 0;
+    while (!(w >> 63)) {
+        w <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/* Rank of `hash` at precision p: leading zeros after the index bits, plus
+ * one; at most 65 - p */
+static inline unsigned xxh3_hll_rank(uint64_t hash, unsigned p)
+{
+    return xxh3_hll_clz64((hash << p) | ((uint64_t)1 << (p - 1))) + 1;
+}
+
+/* Adds n hashes to a sparse sketch, converting it to dense if it outgrows
+ * the registers. XXH3_ERROR if memory could not be allocated; the hashes
+ * added before that stay added. */
+XXH3_WRAPPER_INTERNAL int xxh3_hll_add_sparse(xxh3_hll_t* hll, const uint64_t* hashes, size_t n);
+
+/* Converts a sparse sketch to dense registers */
+XXH3_WRAPPER_INTERNAL int xxh3_hll_to_dense(xxh3_hll_t* hll);
+
+/* Merges a sparse `src` into `dst` of the same precision and seed */
+XXH3_WRAPPER_INTERNAL int xxh3_hll_merge_sparse(xxh3_hll_t* dst, const xxh3_hll_t* src);
+
+#endif /* XXH3_HLL_INTERNAL_H */
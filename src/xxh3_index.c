@@ -0,0 +1,264 @@
+#include "xxh3.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common/internal_utils.h"
+
+/* Static digest index: a set of xxh3_128_t digests in an image that can be
+ * written to a file and mapped back without any decoding.
+ *
+ * Layout (all offsets in bytes):
+ *     0  magic "XXH3EYTZ"
+ *     8  format version, uint32 little-endian (XXH3_INDEX_VERSION)
+ *    12  key size, uint32 little-endian (16)
+ *    16  digest count n, uint64 little-endian
+ *    24  image size, uint64 little-endian (xxh3_index_size(n))
+ *    32  zero up to the first slot
+ *    64  n + 1 slots of 16 bytes: slot 0 is zero, slots 1..n hold the digests
+ *        in canonical (big-endian) form, in Eytzinger order
+ *
+ * Eytzinger order is a sorted array stored as an implicit binary search tree
+ * in breadth-first order: the children of slot k are slots 2k and 2k+1. A
+ * search touches the root's neighbourhood first, so the top levels share a
+ * few cache lines that stay hot, and the descendants of a slot are
+ * contiguous: with 16-byte slots and a 64-byte aligned image, the 16 slots
+ * four levels below slot k, 16k..16k+15, are exactly four cache lines, which
+ * a search prefetches while it takes the next four steps. Digests are
+ * ordered as by xxh3_128_cmp(): by `low`, then by `high`. */
+
+#define XXH3_INDEX_HEADER 64
+#define XXH3_INDEX_KEY    16
+
+static const unsigned char k_index_magic[8] = { 'X', 'X', 'H', '3', 'E', 'Y', 'T', 'Z' };
+
+/* Queries searched together by xxh3_index_contains_n(); each one's next slot
+ * is prefetched and has the steps of the rest of the group to arrive. More
+ * than the ten or so misses a core keeps in flight, to cover TLB misses. */
+#define XXH3_INDEX_GROUP 32
+
+#if defined(__GNUC__) || defined(__clang__)
+#  define XXH3_INDEX_PREFETCH(p) __builtin_prefetch((p), 0)
+#else
+#  define XXH3_INDEX_PREFETCH(p) ((void)0)
+#endif
+
+static uint64_t xxh3_index_read_be64(const unsigned char* p)
+{
+    return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40)
+         | ((uint64_t)p[3] << 32) | ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16)
+         | ((uint64_t)p[6] << 8)  |  (uint64_t)p[7];
+}
+
+static uint64_t xxh3_index_read_le(const unsigned char* p, unsigned bytes)
+{
+    uint64_t v = 0;
+    while (bytes-- > 0) {
+        v = (v << 8) | p[bytes];
+    }
+    return v;
+}
+
+static void xxh3_index_write_le(unsigned char* p, uint64_t v, unsigned bytes)
+{
+    unsigned i;
+    for (i = 0; i < bytes; i++) {
+        p[i] = (unsigned char)(v >> (8 * i));
+    }
+}
+
+static void xxh3_index_write_key(unsigned char* p, xxh3_128_t h)
+{
+    unsigned i;
+    for (i = 0; i < 8; i++) {
+        p[i]     = (unsigned char)(h.high >> (56 - 8 * i));
+        p[8 + i] = (unsigned char)(h.low >> (56 - 8 * i));
+    }
+}
+
+/* 1 if the slot at p orders before the digest (lo, hi) */
+static inline size_t xxh3_index_less(const unsigned char* p, uint64_t lo, uint64_t hi)
+{
+    uint64_t const plo = xxh3_index_read_be64(p + 8);
+    uint64_t const phi = xxh3_index_read_be64(p);
+    return (size_t)((plo < lo) | ((plo == lo) & (phi < hi)));
+}
+
+static inline int xxh3_index_equal(const unsigned char* p, uint64_t lo, uint64_t hi)
+{
+    return (xxh3_index_read_be64(p + 8) == lo) & (xxh3_index_read_be64(p) == hi);
+}
+
+/* Undoes the right turns taken after the last left one: k becomes the slot
+ * of the smallest digest not below the query, or 0 if there is none */
+static inline size_t xxh3_index_lower_bound(size_t k)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    if (sizeof(size_t) <= sizeof(unsigned long)) {
+        return k >> (__builtin_ctzl((unsigned long)~k) + 1);
+    }
+#endif
+    while (k & 1) {
+        k >>= 1;
+    }
+    return k >> 1;
+}
+
+/* Ends a search at slot k after the `depth` unconditional steps: takes the
+ * last step if slot k exists, then checks the lower bound for a match */
+static inline int xxh3_index_finish(const unsigned char* slots, size_t count, size_t k,
+                                    uint64_t lo, uint64_t hi)
+{
+    size_t const last = (k <= count) ? k : 0;
+    size_t const next = 2 * k + xxh3_index_less(slots + XXH3_INDEX_KEY * last, lo, hi);
+    size_t const lb   = xxh3_index_lower_bound((last != 0) ? next : k);
+    /* lb is 0 only for a query above every digest, which cannot be the zero
+     * digest held by slot 0 */
+    return xxh3_index_equal(slots + XXH3_INDEX_KEY * lb, lo, hi);
+}
+
+size_t xxh3_index_size(size_t n)
+{
+    if (n > (SIZE_MAX - XXH3_INDEX_HEADER) / XXH3_INDEX_KEY - 1) {
+        return 0;
+    }
+    return XXH3_INDEX_HEADER + XXH3_INDEX_KEY * (n + 1);
+}
+
+/* In-order walk of the implicit tree: slot k gets the next digest after its
+ * left subtree. Depth is log2(n). */
+static const xxh3_128_t* xxh3_index_fill(unsigned char* slots, size_t n, size_t k,
+                                         const xxh3_128_t* next)
+{
+    if (k > n) {
+        return next;
+    }
+    next = xxh3_index_fill(slots, n, 2 * k, next);
+    xxh3_index_write_key(slots + XXH3_INDEX_KEY * k, *next);
+    return xxh3_index_fill(slots, n, 2 * k + 1, next + 1);
+}
+
+int xxh3_index_build(void* dst, size_t dst_size, const xxh3_128_t* sorted, size_t n)
+{
+    unsigned char* const out  = (unsigned char*)dst;
+    size_t const         size = xxh3_index_size(n);
+    size_t i;
+
+    if (dst == NULL || (sorted == NULL && n > 0) || size == 0 || dst_size < size) {
+        return XXH3_ERROR;
+    }
+    for (i = 1; i < n; i++) {
+        if (xxh3_128_cmp(&sorted[i - 1], &sorted[i]) >= 0) {
+            return XXH3_ERROR;
+        }
+    }
+    memset(out, 0, XXH3_INDEX_HEADER + XXH3_INDEX_KEY);
+    memcpy(out, k_index_magic, sizeof(k_index_magic));
+    xxh3_index_write_le(out + 8, XXH3_INDEX_VERSION, 4);
+    xxh3_index_write_le(out + 12, XXH3_INDEX_KEY, 4);
+    xxh3_index_write_le(out + 16, (uint64_t)n, 8);
+    xxh3_index_write_le(out + 24, (uint64_t)size, 8);
+    (void)xxh3_index_fill(out + XXH3_INDEX_HEADER, n, 1, sorted);
+    return XXH3_OK;
+}
+
+int xxh3_index_view(xxh3_index_t* index, const void* image, size_t size)
+{
+    const unsigned char* const in = (const unsigned char*)image;
+    uint64_t n, depth;
+
+    if (index == NULL || image == NULL || size < XXH3_INDEX_HEADER + XXH3_INDEX_KEY) {
+        return XXH3_ERROR;
+    }
+    n = xxh3_index_read_le(in + 16, 8);
+    if (memcmp(in, k_index_magic, sizeof(k_index_magic)) != 0
+        || xxh3_index_read_le(in + 8, 4) != XXH3_INDEX_VERSION
+        || xxh3_index_read_le(in + 12, 4) != XXH3_INDEX_KEY
+        || n > SIZE_MAX || xxh3_index_size((size_t)n) == 0
+        || xxh3_index_read_le(in + 24, 8) != xxh3_index_size((size_t)n)
+        || size < xxh3_index_size((size_t)n)) {
+        return XXH3_ERROR;
+    }
+    for (depth = 0; (n >> depth) > 1; depth++) {
+    }
+    index->slots = in + XXH3_INDEX_HEADER;
+    index->count = (size_t)n;
+    index->depth = (unsigned)depth;
+    return XXH3_OK;
+}
+
+/* With depth = floor(log2(n)), slots 1..n fill tree levels 0..depth-1 and
+ * part of level `depth`, so every search takes `depth` unconditional steps
+ * and at most one more */
+int xxh3_index_contains(const xxh3_index_t* index, xxh3_128_t h)
+{
+    const unsigned char* slots;
+    size_t   k = 1;
+    unsigned d;
+
+    XXH3_WRAPPER_GUARD({
+        if (index == NULL) {
+            return 0;
+        }
+    });
+    if (index->count == 0) {
+        return 0;
+    }
+    slots = index->slots;
+    for (d = 0; d < index->depth; d++) {
+        const unsigned char* const ahead = slots + XXH3_INDEX_KEY * 16 * k;
+        XXH3_INDEX_PREFETCH(ahead);
+        XXH3_INDEX_PREFETCH(ahead + 64);
+        XXH3_INDEX_PREFETCH(ahead + 128);
+        XXH3_INDEX_PREFETCH(ahead + 192);
+        k = 2 * k + xxh3_index_less(slots + XXH3_INDEX_KEY * k, h.low, h.high);
+    }
+    return xxh3_index_finish(slots, index->count, k, h.low, h.high);
+}
+
+size_t xxh3_index_contains_n(const xxh3_index_t* index, const xxh3_128_t* queries, size_t n,
+                             unsigned char* found)
+{
+    size_t hits = 0;
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (index == NULL || (n > 0 && (queries == NULL || found == NULL))) {
+            return 0;
+        }
+    });
+    if (index->count == 0) {
+        for (i = 0; i < n; i++) {
+            found[i] = 0;
+        }
+        return 0;
+    }
+    /* The group walks the tree level by level: a single search is a chain of
+     * dependent cache misses, but the searches of a group are independent,
+     * so their misses overlap */
+    for (i = 0; i < n; i += XXH3_INDEX_GROUP) {
+        const unsigned char* const slots = index->slots;
+        size_t const m = (n - i < XXH3_INDEX_GROUP) ? n - i : XXH3_INDEX_GROUP;
+        const xxh3_128_t* const q = queries + i;
+        size_t   k[XXH3_INDEX_GROUP];
+        unsigned d;
+        size_t   j;
+
+        for (j = 0; j < m; j++) {
+            k[j] = 1;
+        }
+        for (d = 0; d < index->depth; d++) {
+            for (j = 0; j < m; j++) {
+                k[j] = 2 * k[j] + xxh3_index_less(slots + XXH3_INDEX_KEY * k[j], q[j].low, q[j].high);
+                XXH3_INDEX_PREFETCH(slots + XXH3_INDEX_KEY * k[j]);
+            }
+        }
+        for (j = 0; j < m; j++) {
+            int const hit = xxh3_index_finish(slots, index->count, k[j], q[j].low, q[j].high);
+            found[i + j] = (unsigned char)hit;
+            hits += (size_t)hit;
+        }
+    }
+    return hits;
+}
@@ -0,0 +1,546 @@
+#include "xxh3.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The default hash is XXH3-64 inlined from the vendor header: map keys are
+ * short, and below 241 bytes every variant runs the same scalar code, so an
+ * inlined call beats the indirect one to xxh3_64_<variant>(). Longer keys use
+ * the vendor's default XXH_VECTOR for this target (SSE2 on x86-64, NEON on
+ * aarch64). Digests equal xxh3_64_<variant>(key, key_size, seed). */
+#define XXH_INLINE_ALL
+#include "xxhash.h"
+
+#include "common/internal_utils.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define XXH3_MAP_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#  include <arm_neon.h>
+#  define XXH3_MAP_NEON 1
+#endif
+
+/* Open-addressing hash map in the style of SwissTable.
+ *
+ * The table is `capacity` slots in groups of XXH3_MAP_GROUP, each slot with a
+ * control byte: XXH3_MAP_EMPTY, XXH3_MAP_DELETED (a tombstone), or the 7-bit
+ * H2 tag of the key it holds. A key's 64-bit hash is split into H1 = hash >> 7,
+ * which picks the group where its probe starts, and H2 = hash & 0x7F. A
+ * lookup compares H2 against a whole group of control bytes at once (one SSE2
+ * or NEON compare, or SWAR on 64-bit words) and compares keys only where the
+ * tag matches, i.e. about once per lookup; it moves on to the next group in a
+ * triangular sequence, which visits every group of a power-of-two table, and
+ * stops at the first group with an empty slot. Keys and values are stored in
+ * the slot array itself, so a hit touches two cache lines: the control group
+ * and the slot. At most 7/8 of the slots are used before the table grows.
+ *
+ * Erasing a key leaves its slot EMPTY if its group has an empty slot, since no
+ * probe went past that group, and DELETED otherwise. Tombstones count against
+ * the load; a rehash that finds mostly tombstones keeps the capacity. */
+
+#if defined(XXH3_MAP_SSE2) || defined(XXH3_MAP_NEON)
+#  define XXH3_MAP_GROUP 16
+#else
+#  define XXH3_MAP_GROUP 8
+#endif
+
+#define XXH3_MAP_EMPTY   0x80
+#define XXH3_MAP_DELETED 0xFE
+
+/* Bit masks over a group: each slot is 1 << XXH3_MAP_MASK_SHIFT bits wide
+ * (1 for the SSE2 movemask, 4 for the NEON narrowing shift, 8 for SWAR), of
+ * which one is set for a matching slot */
+typedef uint64_t xxh3_map_mask_t;
+
+#if defined(XXH3_MAP_SSE2)
+
+#define XXH3_MAP_MASK_SHIFT 0
+
+static inline xxh3_map_mask_t xxh3_map_match(const unsigned char* ctrl, unsigned h2)
+{
+    __m128i const g = _mm_loadu_si128((const __m128i*)(const void*)ctrl);
+    return (xxh3_map_mask_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)h2)));
+}
+
+static inline xxh3_map_mask_t xxh3_map_match_empty(const unsigned char* ctrl)
+{
+    return xxh3_map_match(ctrl, XXH3_MAP_EMPTY);
+}
+
+static inline xxh3_map_mask_t xxh3_map_match_free(const unsigned char* ctrl)
+{
+    return (xxh3_map_mask_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(const void*)ctrl));
+}
+
+#elif defined(XXH3_MAP_NEON)
+
+#define XXH3_MAP_MASK_SHIFT 2
+
+/* 0xFF/0x00 bytes to 4 bits per slot; only the top bit of each is kept */
+static inline xxh3_map_mask_t xxh3_map_narrow(uint8x16_t v)
+{
+    uint8x8_t const n = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(n), 0) & 0x8888888888888888ULL;
+}
+
+static inline xxh3_map_mask_t xxh3_map_match(const unsigned char* ctrl, unsigned h2)
+{
+    return xxh3_map_narrow(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8((uint8_t)h2)));
+}
+
+static inline xxh3_map_mask_t xxh3_map_match_empty(const unsigned char* ctrl)
+{
+    return xxh3_map_match(ctrl, XXH3_MAP_EMPTY);
+}
+
+static inline xxh3_map_mask_t xxh3_map_match_free(const unsigned char* ctrl)
+{
+    return xxh3_map_narrow(vcltzq_s8(vld1q_s8((const int8_t*)ctrl)));
+}
+
+#else
+
+#define XXH3_MAP_MASK_SHIFT 3
+#define XXH3_MAP_LSB 0x0101010101010101ULL
+#define XXH3_MAP_MSB 0x8080808080808080ULL
+
+static inline uint64_t xxh3_map_load(const unsigned char* ctrl)
+{
+    uint64_t w = 0;
+    unsigned i;
+    for (i = 0; i < 8; i++) {
+        w |= (uint64_t)ctrl[i] << (8 * i);
+    }
+    return w;
+}
+
+/* Zero-byte test: may also flag a full slot above a match (a borrow), never
+ * a free one; the key compare settles it */
+static inline xxh3_map_mask_t xxh3_map_match(const unsigned char* ctrl, unsigned h2)
+{
+    uint64_t const w = xxh3_map_load(ctrl);
+    uint64_t const x = w ^ (XXH3_MAP_LSB * h2);
+    return (x - XXH3_MAP_LSB) & ~x & ~w & XXH3_MAP_MSB;
+}
+
+/* EMPTY is the only control byte with bit 7 set and bit 6 clear */
+static inline xxh3_map_mask_t xxh3_map_match_empty(const unsigned char* ctrl)
+{
+    uint64_t const w = xxh3_map_load(ctrl);
+    return w & ~(w << 1) & XXH3_MAP_MSB;
+}
+
+static inline xxh3_map_mask_t xxh3_map_match_free(const unsigned char* ctrl)
+{
+    return xxh3_map_load(ctrl) & XXH3_MAP_MSB;
+}
+
+#endif
+
+static inline unsigned xxh3_map_first(xxh3_map_mask_t m)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(m) >> XXH3_MAP_MASK_SHIFT;
+#else
+    unsigned i = 0;
+    while ((m & 1) == 0) {
+        m >>= 1;
+        i++;
+    }
+    return i >> XXH3_MAP_MASK_SHIFT;
+#endif
+}
+
+struct xxh3_map_s {
+    unsigned char*   ctrl;          /* capacity control bytes */
+    unsigned char*   slots;         /* capacity * slot_size bytes */
+    size_t           capacity;      /* 0 or a power of two >= XXH3_MAP_GROUP */
+    size_t           size;
+    size_t           growth_left;   /* EMPTY slots that may still be filled */
+    size_t           key_size;
+    size_t           value_size;
+    size_t           value_offset;
+    size_t           slot_size;
+    uint64_t         seed;
+    xxh3_map_hash_fn hash;
+    xxh3_allocator_t allocator;
+};
+
+static void* xxh3_map_default_alloc(void* ctx, size_t size)
+{
+    XXH3_WRAPPER_UNUSED(ctx);
+    return malloc(size);
+}
+
+static void xxh3_map_default_free(void* ctx, void* ptr, size_t size)
+{
+    XXH3_WRAPPER_UNUSED(ctx);
+    XXH3_WRAPPER_UNUSED(size);
+    free(ptr);
+}
+
+/* Largest power of two dividing `size`, at most 16 */
+static size_t xxh3_map_align_of(size_t size)
+{
+    size_t const a = size & (0 - size);
+    return (size == 0) ? 1 : (a > 16) ? 16 : a;
+}
+
+static size_t xxh3_map_round_up(size_t n, size_t align)
+{
+    return (n + align - 1) & ~(align - 1);
+}
+
+/* Slots start 16-byte aligned after the control bytes */
+static size_t xxh3_map_block_size(const xxh3_map_t* map, size_t capacity)
+{
+    return xxh3_map_round_up(capacity, 16) + capacity * map->slot_size;
+}
+
+static inline uint64_t xxh3_map_hash(const xxh3_map_t* map, const void* key)
+{
+    if (map->hash != NULL) {
+        return map->hash(key, map->key_size, map->seed);
+    }
+    return XXH3_64bits_withSeed(key, map->key_size, map->seed);
+}
+
+static inline int xxh3_map_key_eq(const xxh3_map_t* map, const unsigned char* slot, const void* key)
+{
+    /* fixed-size compares for the common key sizes */
+    if (map->key_size == 8) {
+        uint64_t a, b;
+        memcpy(&a, slot, 8);
+        memcpy(&b, key, 8);
+        return a == b;
+    }
+    if (map->key_size == 16) {
+        uint64_t a[2], b[2];
+        memcpy(a, slot, 16);
+        memcpy(b, key, 16);
+        return ((a[0] ^ b[0]) | (a[1] ^ b[1])) == 0;
+    }
+    return memcmp(slot, key, map->key_size) == 0;
+}
+
+static size_t xxh3_map_growth(size_t capacity)
+{
+    return capacity - capacity / 8;
+}
+
+/* Index of the slot holding `key`, or `capacity` if there is none */
+static inline size_t xxh3_map_lookup(const xxh3_map_t* map, const void* key, uint64_t h)
+{
+    size_t const groups = map->capacity / XXH3_MAP_GROUP;
+    size_t       g      = (size_t)(h >> 7) & (groups - 1);
+    size_t       step   = 0;
+
+    for (;;) {
+        const unsigned char* const ctrl = map->ctrl + g * XXH3_MAP_GROUP;
+        xxh3_map_mask_t m = xxh3_map_match(ctrl, (unsigned)(h & 0x7F));
+        while (m != 0) {
+            size_t const i = g * XXH3_MAP_GROUP + xxh3_map_first(m);
+            if (xxh3_map_key_eq(map, map->slots + i * map->slot_size, key)) {
+                return i;
+            }
+            m &= m - 1;
+        }
+        if (xxh3_map_match_empty(ctrl) != 0 || ++step == groups) {
+            return map->capacity;
+        }
+        g = (g + step) & (groups - 1);
+    }
+}
+
+/* First EMPTY or DELETED slot on the probe sequence of hash h */
+static size_t xxh3_map_find_free(const xxh3_map_t* map, uint64_t h)
+{
+    size_t const groups = map->capacity / XXH3_MAP_GROUP;
+    size_t       g      = (size_t)(h >> 7) & (groups - 1);
+    size_t       step   = 0;
+
+    for (;;) {
+        xxh3_map_mask_t const m = xxh3_map_match_free(map->ctrl + g * XXH3_MAP_GROUP);
+        if (m != 0) {
+            return g * XXH3_MAP_GROUP + xxh3_map_first(m);
+        }
+        g = (g + ++step) & (groups - 1);
+    }
+}
+
+/* Moves every entry into a new table of `capacity` slots */
+static int xxh3_map_rehash(xxh3_map_t* map, size_t capacity)
+{
+    size_t const         block_size = xxh3_map_block_size(map, capacity);
+    unsigned char* const old_ctrl   = map->ctrl;
+    unsigned char* const old_slots  = map->slots;
+    size_t const         old_cap    = map->capacity;
+    unsigned char*       block;
+    size_t i;
+
+    if (capacity > ((size_t)-1 - 16) / (map->slot_size + 1)) {
+        return XXH3_ERROR;
+    }
+    block = (unsigned char*)map->allocator.alloc(map->allocator.ctx, block_size);
+    if (block == NULL) {
+        return XXH3_ERROR;
+    }
+    memset(block, XXH3_MAP_EMPTY, capacity);
+    map->ctrl        = block;
+    map->slots       = block + xxh3_map_round_up(capacity, 16);
+    map->capacity    = capacity;
+    map->growth_left = xxh3_map_growth(capacity) - map->size;
+    for (i = 0; i < old_cap; i++) {
+        if ((old_ctrl[i] & 0x80) == 0) {
+            const unsigned char* const src = old_slots + i * map->slot_size;
+            uint64_t const h = xxh3_map_hash(map, src);
+            size_t const   j = xxh3_map_find_free(map, h);
+            map->ctrl[j] = (unsigned char)(h & 0x7F);
+            memcpy(map->slots + j * map->slot_size, src, map->slot_size);
+        }
+    }
+    if (old_ctrl != NULL) {
+        map->allocator.free(map->allocator.ctx, old_ctrl, xxh3_map_block_size(map, old_cap));
+    }
+    return XXH3_OK;
+}
+
+/* Smallest capacity that holds n entries below the maximum load */
+static size_t xxh3_map_capacity_for(size_t n)
+{
+    size_t capacity = XXH3_MAP_GROUP;
+    while (xxh3_map_growth(capacity) < n) {
+        if (capacity > ((size_t)-1 >> 2)) {
+            return 0;
+        }
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+xxh3_map_t* xxh3_map_create(const xxh3_map_config_t* config, size_t capacity)
+{
+    xxh3_allocator_t allocator;
+    xxh3_map_t*      map;
+    size_t           key_align, value_align;
+
+    if (config == NULL || config->key_size == 0) {
+        return NULL;
+    }
+    if (config->allocator != NULL) {
+        allocator = *config->allocator;
+        if (allocator.alloc == NULL || allocator.free == NULL) {
+            return NULL;
+        }
+    } else {
+        allocator.alloc = xxh3_map_default_alloc;
+        allocator.free  = xxh3_map_default_free;
+        allocator.ctx   = NULL;
+    }
+    map = (xxh3_map_t*)allocator.alloc(allocator.ctx, sizeof(*map));
+    if (map == NULL) {
+        return NULL;
+    }
+    memset(map, 0, sizeof(*map));
+    key_align         = xxh3_map_align_of(config->key_size);
+    value_align       = xxh3_map_align_of(config->value_size);
+    map->key_size     = config->key_size;
+    map->value_size   = config->value_size;
+    map->value_offset = xxh3_map_round_up(config->key_size, value_align);
+    map->slot_size    = xxh3_map_round_up(map->value_offset + config->value_size,
+                                          key_align > value_align ? key_align : value_align);
+    map->seed         = config->seed;
+    map->hash         = config->hash;
+    map->allocator    = allocator;
+    if (capacity > 0 && xxh3_map_reserve(map, capacity) != XXH3_OK) {
+        allocator.free(allocator.ctx, map, sizeof(*map));
+        return NULL;
+    }
+    return map;
+}
+
+void xxh3_map_free(xxh3_map_t* map)
+{
+    if (map == NULL) {
+        return;
+    }
+    if (map->ctrl != NULL) {
+        map->allocator.free(map->allocator.ctx, map->ctrl, xxh3_map_block_size(map, map->capacity));
+    }
+    map->allocator.free(map->allocator.ctx, map, sizeof(*map));
+}
+
+size_t xxh3_map_size(const xxh3_map_t* map)
+{
+    XXH3_WRAPPER_GUARD({
+        if (map == NULL) {
+            return 0;
+        }
+    });
+    return map->size;
+}
+
+size_t xxh3_map_capacity(const xxh3_map_t* map)
+{
+    XXH3_WRAPPER_GUARD({
+        if (map == NULL) {
+            return 0;
+        }
+    });
+    return map->capacity;
+}
+
+int xxh3_map_reserve(xxh3_map_t* map, size_t n)
+{
+    size_t capacity;
+
+    XXH3_WRAPPER_GUARD({
+        if (map == NULL) {
+            return XXH3_ERROR;
+        }
+    });
+    if (n < map->size) {
+        n = map->size;
+    }
+    capacity = xxh3_map_capacity_for(n);
+    if (capacity == 0) {
+        return XXH3_ERROR;
+    }
+    if (capacity <= map->capacity && map->growth_left >= n - map->size) {
+        return XXH3_OK;
+    }
+    return xxh3_map_rehash(map, capacity > map->capacity ? capacity : map->capacity);
+}
+
+void xxh3_map_clear(xxh3_map_t* map)
+{
+    XXH3_WRAPPER_GUARD({
+        if (map == NULL) {
+            return;
+        }
+    });
+    if (map->capacity > 0) {
+        memset(map->ctrl, XXH3_MAP_EMPTY, map->capacity);
+    }
+    map->size        = 0;
+    map->growth_left = xxh3_map_growth(map->capacity);
+}
+
+void* xxh3_map_find(const xxh3_map_t* map, const void* key)
+{
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (map == NULL || key == NULL) {
+            return NULL;
+        }
+    });
+    if (map->size == 0) {
+        return NULL;
+    }
+    i = xxh3_map_lookup(map, key, xxh3_map_hash(map, key));
+    if (i == map->capacity) {
+        return NULL;
+    }
+    return map->slots + i * map->slot_size + map->value_offset;
+}
+
+void* xxh3_map_insert(xxh3_map_t* map, const void* key, int* inserted)
+{
+    uint64_t       h;
+    size_t         i;
+    unsigned char* slot;
+
+    XXH3_WRAPPER_GUARD({
+        if (map == NULL || key == NULL) {
+            return NULL;
+        }
+    });
+    h = xxh3_map_hash(map, key);
+    if (map->size > 0) {
+        i = xxh3_map_lookup(map, key, h);
+        if (i != map->capacity) {
+            if (inserted != NULL) {
+                *inserted = 0;
+            }
+            return map->slots + i * map->slot_size + map->value_offset;
+        }
+    }
+    i = (map->capacity > 0) ? xxh3_map_find_free(map, h) : 0;
+    if (map->capacity == 0 || (map->growth_left == 0 && map->ctrl[i] == XXH3_MAP_EMPTY)) {
+        /* mostly tombstones: same capacity; otherwise double */
+        size_t const capacity = (map->capacity == 0) ? XXH3_MAP_GROUP
+                              : (map->size < xxh3_map_growth(map->capacity) / 2) ? map->capacity
+                              : map->capacity * 2;
+        if (capacity == 0 || xxh3_map_rehash(map, capacity) != XXH3_OK) {
+            return NULL;
+        }
+        i = xxh3_map_find_free(map, h);
+    }
+    map->growth_left -= (map->ctrl[i] == XXH3_MAP_EMPTY);
+    map->ctrl[i] = (unsigned char)(h & 0x7F);
+    map->size++;
+    slot = map->slots + i * map->slot_size;
+    memcpy(slot, key, map->key_size);
+    memset(slot + map->key_size, 0, map->slot_size - map->key_size);
+    if (inserted != NULL) {
+        *inserted = 1;
+    }
+    return slot + map->value_offset;
+}
+
+int xxh3_map_erase(xxh3_map_t* map, const void* key)
+{
+    size_t i, g;
+
+    XXH3_WRAPPER_GUARD({
+        if (map == NULL || key == NULL) {
+            return 0;
+        }
+    });
+    if (map->size == 0) {
+        return 0;
+    }
+    i = xxh3_map_lookup(map, key, xxh3_map_hash(map, key));
+    if (i == map->capacity) {
+        return 0;
+    }
+    g = i - i % XXH3_MAP_GROUP;
+    if (xxh3_map_match_empty(map->ctrl + g) != 0) {
+        map->ctrl[i] = XXH3_MAP_EMPTY;
+        map->growth_left++;
+    } else {
+        map->ctrl[i] = XXH3_MAP_DELETED;
+    }
+    map->size--;
+    return 1;
+}
+
+int xxh3_map_next(const xxh3_map_t* map, size_t* pos, const void** key, void** value)
+{
+    size_t i;
+
+    XXH3_WRAPPER_GUARD({
+        if (map == NULL || pos == NULL) {
+            return 0;
+        }
+    });
+    for (i = *pos; i < map->capacity; i++) {
+        if ((map->ctrl[i] & 0x80) == 0) {
+            unsigned char* const slot = map->slots + i * map->slot_size;
+            if (key != NULL) {
+                *key = slot;
+            }
+            if (value != NULL) {
+                *value = slot + map->value_offset;
+            }
+            *pos = i + 1;
+            return 1;
+        }
+    }
+    *pos = map->capacity;
+    return 0;
+}
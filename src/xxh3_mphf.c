@@ -0,0 +1,509 @@
+/* _POSIX_C_SOURCE 200112L: pthreads and sysconf under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "xxh3.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#  include <pthread.h>
+#  include <unistd.h>
+#  define XXH3_MPHF_THREADS 1
+#else
+#  define XXH3_MPHF_THREADS 0
+#endif
+
+#include "common/internal_utils.h"
+#include "xxh3_mphf_internal.h"
+
+/* Minimal perfect hash function images, PTHash-style with partitions (see
+ * src/xxh3_mphf_internal.h for the slot arithmetic). Hashing keys is per
+ * variant (see variants/templates/mphf.h); this file builds and checks
+ * images.
+ *
+ * Layout (all offsets in bytes):
+ *     0  magic "XXH3MPHF"
+ *     8  format version, uint32 little-endian (XXH3_MPHF_VERSION)
+ *    12  pilot size, uint32 little-endian (2)
+ *    16  key count n, uint64 little-endian
+ *    24  seed of the key hash, uint64 little-endian
+ *    32  partition count, uint64 little-endian
+ *    40  buckets per partition, uint32 little-endian
+ *    44  slots per partition, uint32 little-endian
+ *    48  image size, uint64 little-endian (xxh3_mphf_size(n))
+ *    56  zero up to the pilots
+ *    64  one uint16 little-endian pilot per bucket, partition by partition,
+ *        zero-padded to a multiple of 64 bytes
+ *        then one uint32 little-endian remap entry per global slot from n
+ *        on: the index of a key placed in that slot, or 0
+ *
+ * Every geometry field follows from n, so that the image size is known
+ * before the build. A partition holds at most its mean plus six standard
+ * deviations of keys (and 16), and has 1/32 more slots than that, rounded
+ * up to 64 so that partitions own whole words of the build's slot bitmap.
+ * A build whose keys fill some partition past that bound, give two keys the
+ * same hash, or leave a bucket no pilot, starts over with the next seed. */
+
+#define XXH3_MPHF_HEADER 64
+
+/* Seeds tried before giving up: two equal keys fail them all */
+#define XXH3_MPHF_ATTEMPTS 16
+
+/* Keys hashed per task of the build */
+#define XXH3_MPHF_CHUNK 16384
+
+static const unsigned char k_mphf_magic[8] = { 'X', 'X', 'H', '3', 'M', 'P', 'H', 'F' };
+
+typedef struct {
+    uint64_t partitions;
+    uint32_t buckets;
+    uint32_t dense;
+    uint32_t slots;
+    uint32_t cap;          /* most keys a partition may hold */
+    uint64_t pilot_bytes;  /* padded */
+    uint64_t remap;        /* entries */
+    uint64_t size;
+} xxh3_mphf_geometry_t;
+
+static uint64_t xxh3_mphf_read_le(const unsigned char* p, unsigned bytes)
+{
+    uint64_t v = 0;
+    while (bytes-- > 0) {
+        v = (v << 8) | p[bytes];
+    }
+    return v;
+}
+
+static void xxh3_mphf_write_le(unsigned char* p, uint64_t v, unsigned bytes)
+{
+    unsigned i;
+    for (i = 0; i < bytes; i++) {
+        p[i] = (unsigned char)(v >> (8 * i));
+    }
+}
+
+/* n is at most 2^32 - 1 */
+static void xxh3_mphf_geometry(uint64_t n, xxh3_mphf_geometry_t* g)
+{
+    uint64_t const partitions = (n == 0) ? 1 : (n + XXH3_MPHF_PART - 1) / XXH3_MPHF_PART;
+    uint32_t const mean       = (uint32_t)((n + partitions - 1) / partitions);
+    uint32_t       root       = 0;
+    uint32_t       buckets;
+
+    while ((root + 1) * (root + 1) <= mean) {
+        root++;
+    }
+    buckets        = (mean + XXH3_MPHF_BUCKET - 1) / XXH3_MPHF_BUCKET;
+    buckets        = (buckets < 2) ? 2 : buckets;
+    g->partitions  = partitions;
+    g->buckets     = buckets;
+    g->dense       = (buckets * 3 + 5) / 10;
+    g->cap         = mean + 6 * root + 16;
+    g->slots       = (g->cap + g->cap / 32 + 63) & ~(uint32_t)63;
+    g->pilot_bytes = (2 * partitions * buckets + 63) & ~(uint64_t)63;
+    g->remap       = partitions * g->slots - n;
+    g->size        = XXH3_MPHF_HEADER + g->pilot_bytes + 4 * g->remap;
+}
+
+size_t xxh3_mphf_size(size_t n)
+{
+    xxh3_mphf_geometry_t g;
+
+    if ((uint64_t)n > UINT32_MAX) {
+        return 0;
+    }
+    xxh3_mphf_geometry((uint64_t)n, &g);
+    if (g.size > SIZE_MAX) {
+        return 0;
+    }
+    return (size_t)g.size;
+}
+
+/* ----------------------------------------------------------------- build */
+
+enum { XXH3_MPHF_PLACED, XXH3_MPHF_RETRY, XXH3_MPHF_FAILED };
+enum { XXH3_MPHF_PHASE_HASH, XXH3_MPHF_PHASE_PLACE };
+
+typedef struct {
+    const void* const* inputs;
+    const size_t*      sizes;
+    xxh3_mphf_hash_fn  hash;
+    uint64_t           seed;
+    uint64_t*          h;        /* n hashes, grouped by partition after hashing */
+    size_t             n;
+    const xxh3_mphf_t* mphf;
+    uint32_t           cap;
+    const uint64_t*    starts;   /* partitions + 1 */
+    uint64_t*          bitmap;   /* partitions * slots bits */
+    unsigned char*     pilots;
+    int                phase;
+    uint64_t           tasks;
+    uint64_t           next;     /* under lock */
+    int                status;   /* under lock */
+#if XXH3_MPHF_THREADS
+    int                locked;
+    pthread_mutex_t    lock;
+#endif
+} xxh3_mphf_job_t;
+
+/* Next task, or job->tasks once the job is done or has failed */
+static uint64_t xxh3_mphf_take(xxh3_mphf_job_t* job, int status)
+{
+    uint64_t t;
+#if XXH3_MPHF_THREADS
+    if (job->locked) {
+        pthread_mutex_lock(&job->lock);
+    }
+#endif
+    if (status != XXH3_MPHF_PLACED && job->status != XXH3_MPHF_FAILED) {
+        job->status = status;
+    }
+    t = (job->status == XXH3_MPHF_PLACED && job->next < job->tasks) ? job->next++ : job->tasks;
+#if XXH3_MPHF_THREADS
+    if (job->locked) {
+        pthread_mutex_unlock(&job->lock);
+    }
+#endif
+    return t;
+}
+
+/* Buffers of one worker placing partitions */
+typedef struct {
+    uint64_t* keys;    /* cap: the partition's hashes by bucket */
+    uint32_t* start;   /* buckets + 1 */
+    uint32_t* order;   /* buckets, largest first */
+    uint32_t* count;   /* cap + 2 */
+    uint32_t* slot;    /* cap */
+} xxh3_mphf_scratch_t;
+
+static int xxh3_mphf_place(const xxh3_mphf_job_t* job, uint64_t p, const xxh3_mphf_scratch_t* s)
+{
+    const xxh3_mphf_t* const mphf = job->mphf;
+    const uint64_t* const    h    = job->h + job->starts[p];
+    uint32_t const           np   = (uint32_t)(job->starts[p + 1] - job->starts[p]);
+    uint64_t* const          bits = job->bitmap + p * (mphf->slots / 64);
+    unsigned char* const     out  = job->pilots + 2 * p * mphf->buckets;
+    uint32_t                 largest = 0;
+    uint32_t                 b, i, j;
+
+    /* bucket sort the partition's hashes, then order the buckets by size */
+    memset(s->start, 0, (mphf->buckets + 1) * sizeof(uint32_t));
+    for (i = 0; i < np; i++) {
+        s->start[xxh3_mphf_bucket(mphf, h[i]) + 1]++;
+    }
+    for (b = 0; b < mphf->buckets; b++) {
+        largest = (s->start[b + 1] > largest) ? s->start[b + 1] : largest;
+        s->start[b + 1] += s->start[b];
+        s->count[b] = s->start[b];
+    }
+    for (i = 0; i < np; i++) {
+        s->keys[s->count[xxh3_mphf_bucket(mphf, h[i])]++] = h[i];
+    }
+    memset(s->count, 0, (largest + 2) * sizeof(uint32_t));
+    for (b = 0; b < mphf->buckets; b++) {
+        s->count[largest - (s->start[b + 1] - s->start[b]) + 1]++;
+    }
+    for (i = 0; i < largest; i++) {
+        s->count[i + 1] += s->count[i];
+    }
+    for (b = 0; b < mphf->buckets; b++) {
+        s->order[s->count[largest - (s->start[b + 1] - s->start[b])]++] = b;
+    }
+
+    for (j = 0; j < mphf->buckets; j++) {
+        const uint64_t* const k    = s->keys + s->start[s->order[j]];
+        uint32_t const        size = s->start[s->order[j] + 1] - s->start[s->order[j]];
+        unsigned              pilot;
+
+        if (size == 0) {
+            break;
+        }
+        for (i = 1; i < size; i++) {
+            uint32_t m;
+            for (m = 0; m < i; m++) {
+                if (k[m] == k[i]) {
+                    return XXH3_MPHF_RETRY;
+                }
+            }
+        }
+        for (pilot = 0; pilot <= 0xFFFF; pilot++) {
+            for (i = 0; i < size; i++) {
+                uint32_t const slot = xxh3_mphf_slot(mphf, k[i], pilot);
+                uint64_t const bit  = (uint64_t)1 << (slot & 63);
+                if (bits[slot / 64] & bit) {
+                    break;
+                }
+                bits[slot / 64] |= bit;
+                s->slot[i] = slot;
+            }
+            if (i == size) {
+                break;
+            }
+            while (i-- > 0) {
+                bits[s->slot[i] / 64] &= ~((uint64_t)1 << (s->slot[i] & 63));
+            }
+        }
+        if (pilot > 0xFFFF) {
+            return XXH3_MPHF_RETRY;
+        }
+        xxh3_mphf_write_le(out + 2 * s->order[j], pilot, 2);
+    }
+    return XXH3_MPHF_PLACED;
+}
+
+static void* xxh3_mphf_worker(void* arg)
+{
+    xxh3_mphf_job_t* const job = (xxh3_mphf_job_t*)arg;
+    xxh3_mphf_scratch_t    s;
+    int                    status = XXH3_MPHF_PLACED;
+    uint64_t               t;
+
+    memset(&s, 0, sizeof(s));
+    if (job->phase == XXH3_MPHF_PHASE_PLACE) {
+        uint32_t const buckets = job->mphf->buckets;
+        s.keys  = (uint64_t*)malloc(job->cap * sizeof(uint64_t));
+        s.start = (uint32_t*)malloc((buckets + 1) * sizeof(uint32_t));
+        s.order = (uint32_t*)malloc(buckets * sizeof(uint32_t));
+        s.count = (uint32_t*)malloc((job->cap + 2) * sizeof(uint32_t));
+        s.slot  = (uint32_t*)malloc(job->cap * sizeof(uint32_t));
+        if (s.keys == NULL || s.start == NULL || s.order == NULL || s.count == NULL
+            || s.slot == NULL) {
+            status = XXH3_MPHF_FAILED;
+        }
+    }
+    while ((t = xxh3_mphf_take(job, status)) < job->tasks) {
+        if (job->phase == XXH3_MPHF_PHASE_HASH) {
+            size_t const first = (size_t)t * XXH3_MPHF_CHUNK;
+            size_t const count = (job->n - first < XXH3_MPHF_CHUNK) ? job->n - first : XXH3_MPHF_CHUNK;
+            job->hash(job->h + first, job->inputs + first, job->sizes + first, count, job->seed);
+        } else {
+            status = xxh3_mphf_place(job, t, &s);
+        }
+    }
+    free(s.slot);
+    free(s.count);
+    free(s.order);
+    free(s.start);
+    free(s.keys);
+    return NULL;
+}
+
+/* Runs a phase on `threads` threads, the calling one included */
+static int xxh3_mphf_run(xxh3_mphf_job_t* job, int phase, uint64_t tasks, unsigned threads)
+{
+#if XXH3_MPHF_THREADS
+    pthread_t pool[64];
+    unsigned  started = 0;
+    unsigned  t;
+#endif
+
+    job->phase  = phase;
+    job->tasks  = tasks;
+    job->next   = 0;
+    job->status = XXH3_MPHF_PLACED;
+#if XXH3_MPHF_THREADS
+    threads = (tasks < threads) ? (unsigned)tasks : threads;
+    job->locked = threads > 1 && pthread_mutex_init(&job->lock, NULL) == 0;
+    for (t = 1; job->locked && t < threads; t++) {
+        if (pthread_create(&pool[started], NULL, xxh3_mphf_worker, job) == 0) {
+            started++;
+        }
+    }
+    (void)xxh3_mphf_worker(job);
+    for (t = 0; t < started; t++) {
+        pthread_join(pool[t], NULL);
+    }
+    if (job->locked) {
+        pthread_mutex_destroy(&job->lock);
+    }
+#else
+    XXH3_WRAPPER_UNUSED(threads);
+    (void)xxh3_mphf_worker(job);
+#endif
+    return job->status;
+}
+
+/* Groups the hashes by partition in place, as American flag sort does by
+ * a key byte, and sets starts[]. XXH3_MPHF_RETRY if a partition is over
+ * capacity. */
+static int xxh3_mphf_group(uint64_t* h, size_t n, const xxh3_mphf_t* mphf, uint32_t cap,
+                           uint64_t* starts, uint64_t* next)
+{
+    uint64_t const partitions = mphf->partitions;
+    uint64_t       p;
+    size_t         i;
+
+    memset(starts, 0, (partitions + 1) * sizeof(uint64_t));
+    for (i = 0; i < n; i++) {
+        starts[xxh3_mphf_partition(mphf, h[i]) + 1]++;
+    }
+    for (p = 0; p < partitions; p++) {
+        if (starts[p + 1] > cap) {
+            return XXH3_MPHF_RETRY;
+        }
+        starts[p + 1] += starts[p];
+        next[p] = starts[p];
+    }
+    for (p = 0; p < partitions; p++) {
+        while (next[p] < starts[p + 1]) {
+            uint64_t v = h[next[p]];
+            uint64_t q;
+            while ((q = xxh3_mphf_partition(mphf, v)) != p) {
+                uint64_t const w = h[next[q]];
+                h[next[q]++] = v;
+                v = w;
+            }
+            h[next[p]++] = v;
+        }
+    }
+    return XXH3_MPHF_PLACED;
+}
+
+/* Sends the keys placed in slots at or past n to the free slots below n,
+ * in increasing order of both */
+static void xxh3_mphf_fill_remap(unsigned char* remap, const uint64_t* bitmap, uint64_t n,
+                                 uint64_t slots)
+{
+    uint64_t free_slot = 0;
+    uint64_t s;
+
+    for (s = n; s < slots; s++) {
+        if (!((bitmap[s / 64] >> (s & 63)) & 1)) {
+            continue;
+        }
+        while ((bitmap[free_slot / 64] >> (free_slot & 63)) & 1) {
+            free_slot++;
+        }
+        xxh3_mphf_write_le(remap + 4 * (s - n), free_slot, 4);
+        free_slot++;
+    }
+}
+
+int xxh3_mphf_build_with(void* dst, size_t dst_size, const void* const* inputs,
+                         const size_t* sizes, size_t n, uint64_t seed, unsigned threads,
+                         xxh3_mphf_hash_fn hash)
+{
+    unsigned char* const out = (unsigned char*)dst;
+    xxh3_mphf_geometry_t g;
+    xxh3_mphf_job_t      job;
+    xxh3_mphf_t          mphf;
+    uint64_t*            h;
+    uint64_t*            starts;
+    uint64_t*            next;
+    uint64_t*            bitmap;
+    size_t               bitmap_bytes;
+    unsigned             attempt;
+    int                  status = XXH3_MPHF_RETRY;
+
+    if (dst == NULL || (n > 0 && (inputs == NULL || sizes == NULL)) || xxh3_mphf_size(n) == 0
+        || dst_size < xxh3_mphf_size(n)) {
+        return XXH3_ERROR;
+    }
+    xxh3_mphf_geometry((uint64_t)n, &g);
+#if XXH3_MPHF_THREADS
+    if (threads == 0) {
+        long const cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? (unsigned)cpus : 1;
+    }
+#endif
+    threads = (threads == 0) ? 1 : (threads > 64) ? 64 : threads;
+
+    memset(out, 0, XXH3_MPHF_HEADER);
+    mphf.pilots     = out + XXH3_MPHF_HEADER;
+    mphf.remap      = out + XXH3_MPHF_HEADER + g.pilot_bytes;
+    mphf.count      = (uint64_t)n;
+    mphf.partitions = g.partitions;
+    mphf.buckets    = g.buckets;
+    mphf.dense      = g.dense;
+    mphf.slots      = g.slots;
+    bitmap_bytes    = (size_t)(g.partitions * g.slots / 8);
+    h      = (uint64_t*)malloc((n > 0 ? n : 1) * sizeof(uint64_t));
+    starts = (uint64_t*)malloc((size_t)(g.partitions + 1) * sizeof(uint64_t));
+    next   = (uint64_t*)malloc((size_t)g.partitions * sizeof(uint64_t));
+    bitmap = (uint64_t*)malloc(bitmap_bytes);
+    if (h == NULL || starts == NULL || next == NULL || bitmap == NULL) {
+        status = XXH3_MPHF_FAILED;
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.inputs = inputs;
+    job.sizes  = sizes;
+    job.hash   = hash;
+    job.h      = h;
+    job.n      = n;
+    job.mphf   = &mphf;
+    job.cap    = g.cap;
+    job.starts = starts;
+    job.bitmap = bitmap;
+    job.pilots = out + XXH3_MPHF_HEADER;
+    for (attempt = 0; status == XXH3_MPHF_RETRY && attempt < XXH3_MPHF_ATTEMPTS; attempt++) {
+        job.seed = mphf.seed = seed + attempt;
+        status = xxh3_mphf_run(&job, XXH3_MPHF_PHASE_HASH,
+                               (n + XXH3_MPHF_CHUNK - 1) / XXH3_MPHF_CHUNK, threads);
+        if (status == XXH3_MPHF_PLACED) {
+            status = xxh3_mphf_group(h, n, &mphf, g.cap, starts, next);
+        }
+        if (status == XXH3_MPHF_PLACED) {
+            memset(bitmap, 0, bitmap_bytes);
+            memset(out + XXH3_MPHF_HEADER, 0, (size_t)g.pilot_bytes);
+            status = xxh3_mphf_run(&job, XXH3_MPHF_PHASE_PLACE, g.partitions, threads);
+        }
+    }
+    if (status == XXH3_MPHF_PLACED) {
+        unsigned char* const remap = out + XXH3_MPHF_HEADER + g.pilot_bytes;
+        memset(remap, 0, (size_t)(4 * g.remap));
+        xxh3_mphf_fill_remap(remap, bitmap, (uint64_t)n, g.partitions * g.slots);
+        memcpy(out, k_mphf_magic, sizeof(k_mphf_magic));
+        xxh3_mphf_write_le(out + 8, XXH3_MPHF_VERSION, 4);
+        xxh3_mphf_write_le(out + 12, 2, 4);
+        xxh3_mphf_write_le(out + 16, (uint64_t)n, 8);
+        xxh3_mphf_write_le(out + 24, mphf.seed, 8);
+        xxh3_mphf_write_le(out + 32, g.partitions, 8);
+        xxh3_mphf_write_le(out + 40, g.buckets, 4);
+        xxh3_mphf_write_le(out + 44, g.slots, 4);
+        xxh3_mphf_write_le(out + 48, g.size, 8);
+    }
+    free(bitmap);
+    free(next);
+    free(starts);
+    free(h);
+    return (status == XXH3_MPHF_PLACED) ? XXH3_OK : XXH3_ERROR;
+}
+
+int xxh3_mphf_view(xxh3_mphf_t* mphf, const void* image, size_t size)
+{
+    const unsigned char* const in = (const unsigned char*)image;
+    xxh3_mphf_geometry_t g;
+    uint64_t n;
+
+    if (mphf == NULL || image == NULL || size < XXH3_MPHF_HEADER) {
+        return XXH3_ERROR;
+    }
+    n = xxh3_mphf_read_le(in + 16, 8);
+    if (memcmp(in, k_mphf_magic, sizeof(k_mphf_magic)) != 0
+        || xxh3_mphf_read_le(in + 8, 4) != XXH3_MPHF_VERSION
+        || xxh3_mphf_read_le(in + 12, 4) != 2 || n > UINT32_MAX) {
+        return XXH3_ERROR;
+    }
+    xxh3_mphf_geometry(n, &g);
+    if (xxh3_mphf_read_le(in + 32, 8) != g.partitions
+        || xxh3_mphf_read_le(in + 40, 4) != g.buckets
+        || xxh3_mphf_read_le(in + 44, 4) != g.slots
+        || xxh3_mphf_read_le(in + 48, 8) != g.size || size < g.size) {
+        return XXH3_ERROR;
+    }
+    mphf->pilots     = in + XXH3_MPHF_HEADER;
+    mphf->remap      = in + XXH3_MPHF_HEADER + g.pilot_bytes;
+    mphf->count      = n;
+    mphf->seed       = xxh3_mphf_read_le(in + 24, 8);
+    mphf->partitions = g.partitions;
+    mphf->buckets    = g.buckets;
+    mphf->dense      = g.dense;
+    mphf->slots      = g.slots;
+    return XXH3_OK;
+}
@@ -0,0 +1,86 @@
+#ifndef XXH3_MPHF_INTERNAL_H
+#define XXH3_MPHF_INTERNAL_H
+
+/* Slot arithmetic of minimal perfect hash functions, shared by the builder
+ * (src/xxh3_mphf.c) and the per-variant lookups
+ * (variants/templates/mphf.h).
+ *
+ * The keys' 64-bit hashes are split into partitions of about
+ * XXH3_MPHF_PART keys, each with `buckets` buckets and `slots` slots. The
+ * high 32 bits of a hash pick the partition by multiply-shift, and the low
+ * 32 bits of that product pick the bucket: 60% of the keys (by the low 32
+ * bits of the hash) go to the first 30% of the buckets, so that the large
+ * buckets, placed first, are numerous. A bucket's 16-bit pilot is the first
+ * value for which all its keys land in distinct free slots of the
+ * partition, a key's slot being a multiply-shift of the high half of
+ * (hash ^ pilot * XXH3_MPHF_PILOT_MUL) * XXH3_MPHF_SLOT_MUL. Slot s of
+ * partition p is global slot p * slots + s. There are more slots than
+ * keys; the keys whose global slot is at or past the key count n are sent
+ * by the remap table to the free slots below n.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xxh3.h"
+#include "common/internal_utils.h"
+
+/* Keys per partition on average, and per bucket */
+#define XXH3_MPHF_PART   8192
+#define XXH3_MPHF_BUCKET 5
+
+/* Low 32 bits of the hash below which a key goes to the dense buckets: 0.6 * 2^32 */
+#define XXH3_MPHF_DENSE 0x9999999AU
+
+#define XXH3_MPHF_PILOT_MUL 0x9E3779B97F4A7C15ULL
+#define XXH3_MPHF_SLOT_MUL  0xFF51AFD7ED558CCDULL
+
+static inline uint64_t xxh3_mphf_partition(const xxh3_mphf_t* mphf, uint64_t h)
+{
+    return ((h >> 32) * mphf->partitions) >> 32;
+}
+
+/* Bucket of `h` within its partition */
+static inline uint32_t xxh3_mphf_bucket(const xxh3_mphf_t* mphf, uint64_t h)
+{
+    uint64_t const frac = (uint32_t)((h >> 32) * mphf->partitions);
+    if ((uint32_t)h < XXH3_MPHF_DENSE) {
+        return (uint32_t)((frac * mphf->dense) >> 32);
+    }
+    return mphf->dense + (uint32_t)((frac * (mphf->buckets - mphf->dense)) >> 32);
+}
+
+/* Slot of `h` within its partition under `pilot`. The keys of a bucket
+ * share the high bits of their hashes; the multiply carries their low bits
+ * up into the bits the slot is taken from. */
+static inline uint32_t xxh3_mphf_slot(const xxh3_mphf_t* mphf, uint64_t h, unsigned pilot)
+{
+    uint64_t const x = (h ^ (pilot * XXH3_MPHF_PILOT_MUL)) * XXH3_MPHF_SLOT_MUL;
+    return (uint32_t)(((x >> 32) * mphf->slots) >> 32);
+}
+
+static inline uint64_t xxh3_mphf_index(const xxh3_mphf_t* mphf, uint64_t h)
+{
+    uint64_t const p = xxh3_mphf_partition(mphf, h);
+    const unsigned char* const pilot =
+        mphf->pilots + 2 * (p * mphf->buckets + xxh3_mphf_bucket(mphf, h));
+    uint64_t const s = p * mphf->slots + xxh3_mphf_slot(mphf, h, pilot[0] | (unsigned)pilot[1] << 8);
+    const unsigned char* r;
+
+    if (s < mphf->count) {
+        return s;
+    }
+    r = mphf->remap + 4 * (s - mphf->count);
+    return (uint64_t)r[0] | (uint64_t)r[1] << 8 | (uint64_t)r[2] << 16 | (uint64_t)r[3] << 24;
+}
+
+/* Hashes inputs[0..count) into out[] under `seed` */
+typedef void (*xxh3_mphf_hash_fn)(uint64_t* out, const void* const* inputs, const size_t* sizes,
+                                  size_t count, uint64_t seed);
+
+/* xxh3_mphf_build_<variant>() with the variant's key hash */
+XXH3_WRAPPER_INTERNAL int xxh3_mphf_build_with(void* dst, size_t dst_size, const void* const* inputs,
+                                               const size_t* sizes, size_t n, uint64_t seed,
+                                               unsigned threads, xxh3_mphf_hash_fn hash);
+
+#endif /* XXH3_MPHF_INTERNAL_H */
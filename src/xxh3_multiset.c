@@ -0,0 +1,79 @@
+#include "xxh3.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common/internal_utils.h"
+
+/* Multiset hashes. A multiset is summarised by the sum, modulo 2^128, of
+ * the XXH3-128 hashes of its elements (the high word is the more
+ * significant). Hashing keys is per variant (see
+ * variants/templates/multiset.h); this file does the 128-bit arithmetic. */
+
+void xxh3_multiset_init(xxh3_multiset_t* set, uint64_t seed)
+{
+    XXH3_WRAPPER_GUARD({
+        if (set == NULL) {
+            return;
+        }
+    });
+    set->high = 0;
+    set->low  = 0;
+    set->seed = seed;
+}
+
+void xxh3_multiset_add_hash(xxh3_multiset_t* set, xxh3_128_t hash)
+{
+    XXH3_WRAPPER_GUARD({
+        if (set == NULL) {
+            return;
+        }
+    });
+    set->low += hash.low;
+    set->high += hash.high + (set->low < hash.low);
+}
+
+void xxh3_multiset_remove_hash(xxh3_multiset_t* set, xxh3_128_t hash)
+{
+    XXH3_WRAPPER_GUARD({
+        if (set == NULL) {
+            return;
+        }
+    });
+    set->high -= hash.high + (set->low < hash.low);
+    set->low -= hash.low;
+}
+
+int xxh3_multiset_merge(xxh3_multiset_t* dst, const xxh3_multiset_t* src)
+{
+    xxh3_128_t sum;
+
+    XXH3_WRAPPER_GUARD({
+        if (dst == NULL || src == NULL) {
+            return XXH3_ERROR;
+        }
+    });
+    if (dst->seed != src->seed) {
+        return XXH3_ERROR;
+    }
+    sum.high = src->high;
+    sum.low  = src->low;
+    xxh3_multiset_add_hash(dst, sum);
+    return XXH3_OK;
+}
+
+xxh3_128_t xxh3_multiset_digest(const xxh3_multiset_t* set)
+{
+    xxh3_128_t digest;
+
+    digest.high = 0;
+    digest.low  = 0;
+    XXH3_WRAPPER_GUARD({
+        if (set == NULL) {
+            return digest;
+        }
+    });
+    digest.high = set->high;
+    digest.low  = set->low;
+    return digest;
+}
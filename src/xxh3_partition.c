@@ -0,0 +1,168 @@
+/* _POSIX_C_SOURCE 200112L: pthreads and sysconf under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "xxh3.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#  include <pthread.h>
+#  include <unistd.h>
+#  define XXH3_PARTITION_THREADS 1
+#else
+#  define XXH3_PARTITION_THREADS 0
+#endif
+
+#include "common/internal_utils.h"
+#include "xxh3_partition_internal.h"
+
+/* Threaded driver of hash partitioning (see src/xxh3_partition_internal.h).
+ * Hashing and scattering are per variant (see
+ * variants/templates/partition.h); this file splits the rows, runs the
+ * count pass on every thread, turns the per-thread histograms into
+ * per-thread cursors, and runs the scatter pass. Thread t gets rows
+ * [t * n / T, (t + 1) * n / T), and its cursor for partition p is the
+ * number of rows of partitions below p, plus those of partition p in the
+ * ranges of threads below t. */
+
+enum { XXH3_PARTITION_PHASE_COUNT, XXH3_PARTITION_PHASE_SCATTER };
+
+typedef struct {
+    const xxh3_partition_src_t* src;
+    size_t                      n;
+    unsigned                    threads;
+    int                         phase;
+    xxh3_partition_count_fn     count;
+    xxh3_partition_scatter_fn   scatter;
+    xxh3_partition_tuple_t*     dst;
+    size_t*                     cursors;        /* 2^bits per thread: counts, then cursors */
+    unsigned char*              scratch;        /* scratch_bytes per thread, 64-byte aligned */
+    size_t                      scratch_bytes;
+} xxh3_partition_job_t;
+
+typedef struct {
+    xxh3_partition_job_t* job;
+    unsigned              t;
+} xxh3_partition_task_t;
+
+static void xxh3_partition_task(const xxh3_partition_job_t* job, unsigned t)
+{
+    size_t const parts = (size_t)1 << job->src->bits;
+    size_t const share = job->n / job->threads;
+    size_t const extra = job->n % job->threads;
+    size_t const begin = t * share + (t < extra ? t : extra);
+    size_t const end   = begin + share + (t < extra ? 1 : 0);
+
+    if (job->phase == XXH3_PARTITION_PHASE_COUNT) {
+        job->count(job->src, begin, end, job->cursors + t * parts);
+    } else {
+        job->scatter(job->src, begin, end, job->dst, job->cursors + t * parts,
+                     job->scratch + t * job->scratch_bytes);
+    }
+}
+
+#if XXH3_PARTITION_THREADS
+static void* xxh3_partition_worker(void* arg)
+{
+    const xxh3_partition_task_t* const task = (const xxh3_partition_task_t*)arg;
+    xxh3_partition_task(task->job, task->t);
+    return NULL;
+}
+#endif
+
+/* Runs a phase with one thread per range, the calling one included; a range
+ * whose thread could not be started is run by the calling thread */
+static void xxh3_partition_run(xxh3_partition_job_t* job, int phase)
+{
+#if XXH3_PARTITION_THREADS
+    pthread_t             pool[64];
+    xxh3_partition_task_t tasks[64];
+    int                   started[64];
+#endif
+    unsigned t;
+
+    job->phase = phase;
+#if XXH3_PARTITION_THREADS
+    for (t = 1; t < job->threads; t++) {
+        tasks[t].job = job;
+        tasks[t].t   = t;
+        started[t]   = pthread_create(&pool[t], NULL, xxh3_partition_worker, &tasks[t]) == 0;
+    }
+    xxh3_partition_task(job, 0);
+    for (t = 1; t < job->threads; t++) {
+        if (started[t]) {
+            pthread_join(pool[t], NULL);
+        } else {
+            xxh3_partition_task(job, t);
+        }
+    }
+#else
+    for (t = 0; t < job->threads; t++) {
+        xxh3_partition_task(job, t);
+    }
+#endif
+}
+
+int xxh3_partition_with(xxh3_partition_tuple_t* dst, size_t* hist, const xxh3_partition_src_t* src,
+                        size_t n, unsigned threads, xxh3_partition_count_fn count,
+                        xxh3_partition_scatter_fn scatter)
+{
+    xxh3_partition_job_t job;
+    size_t               parts, cursor_bytes, p, sum;
+    unsigned char*       block;
+    unsigned             t;
+
+    if (hist == NULL || src->bits > XXH3_PARTITION_MAX_BITS || (dst == NULL && n > 0)) {
+        return XXH3_ERROR;
+    }
+    parts = (size_t)1 << src->bits;
+#if XXH3_PARTITION_THREADS
+    if (threads == 0) {
+        long const cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? (unsigned)cpus : 1;
+    }
+#else
+    threads = 1;
+#endif
+    threads = (threads == 0) ? 1 : (threads > 64) ? 64 : threads;
+    if (n / XXH3_PARTITION_MIN_ROWS < threads) {
+        threads = (n < XXH3_PARTITION_MIN_ROWS) ? 1 : (unsigned)(n / XXH3_PARTITION_MIN_ROWS);
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.src           = src;
+    job.n             = n;
+    job.threads       = threads;
+    job.count         = count;
+    job.scatter       = scatter;
+    job.dst           = dst;
+    job.scratch_bytes = (parts * (64 + sizeof(size_t)) + 63) & ~(size_t)63;
+    cursor_bytes      = (threads * parts * sizeof(size_t) + 63) & ~(size_t)63;
+    block = (unsigned char*)malloc(cursor_bytes + threads * job.scratch_bytes + 63);
+    if (block == NULL) {
+        return XXH3_ERROR;
+    }
+    job.cursors = (size_t*)(void*)block;
+    job.scratch = block + ((64 - (size_t)block % 64) % 64) + cursor_bytes;
+    memset(job.cursors, 0, threads * parts * sizeof(size_t));
+
+    xxh3_partition_run(&job, XXH3_PARTITION_PHASE_COUNT);
+    for (p = 0, sum = 0; p < parts; p++) {
+        hist[p] = 0;
+        for (t = 0; t < threads; t++) {
+            size_t const c = job.cursors[t * parts + p];
+            job.cursors[t * parts + p] = sum;
+            sum     += c;
+            hist[p] += c;
+        }
+    }
+    xxh3_partition_run(&job, XXH3_PARTITION_PHASE_SCATTER);
+
+    free(block);
+    return XXH3_OK;
+}
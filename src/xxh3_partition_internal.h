@@ -0,0 +1,65 @@
+#ifndef XXH3_PARTITION_INTERNAL_H
+#define XXH3_PARTITION_INTERNAL_H
+
+/* Hash partitioning, shared by the threaded driver (src/xxh3_partition.c)
+ * and the per-variant count and scatter passes
+ * (variants/templates/partition.h).
+ *
+ * A key's partition is the top `bits` bits of its hash, leaving the low
+ * bits to the hash tables built on each partition. The driver splits the
+ * rows into one contiguous range per thread; each thread counts its range,
+ * and the prefix sum over partitions, then threads, gives every thread its
+ * own run of dst in every partition. Rows thus keep their order within a
+ * partition, and dst does not depend on the thread count.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xxh3.h"
+#include "common/internal_utils.h"
+
+/* Largest `bits`: 2^16 write-combining lines are 4 MiB per thread already */
+#define XXH3_PARTITION_MAX_BITS 16
+
+/* Tuples per 64-byte line */
+#define XXH3_PARTITION_LINE 4
+
+/* Rows per thread below which fewer threads are started */
+#define XXH3_PARTITION_MIN_ROWS 65536
+
+typedef struct {
+    const unsigned char* keys;      /* fixed width: row i at keys + i * key_size */
+    size_t               key_size;
+    const void* const*   inputs;    /* variable width, if keys is NULL */
+    const size_t*        sizes;
+    const uint64_t*      payloads;  /* NULL: row ids */
+    uint64_t             seed;
+    unsigned             bits;
+} xxh3_partition_src_t;
+
+static inline size_t xxh3_partition_of(uint64_t h, unsigned bits)
+{
+    /* h >> (64 - bits), and 0 for bits == 0 without a shift by 64 */
+    return (size_t)((h >> 1) >> (63 - bits));
+}
+
+/* Adds the rows [begin, end) to hist[] */
+typedef void (*xxh3_partition_count_fn)(const xxh3_partition_src_t* src, size_t begin, size_t end,
+                                        size_t* hist);
+
+/* Writes the rows [begin, end) to dst, row by row at cursor[p] for
+ * partition p. `scratch` is the write-combining lines (2^bits * 64 bytes,
+ * 64-byte aligned) followed by 2^bits size_t. */
+typedef void (*xxh3_partition_scatter_fn)(const xxh3_partition_src_t* src, size_t begin, size_t end,
+                                          xxh3_partition_tuple_t* dst, size_t* cursor,
+                                          unsigned char* scratch);
+
+/* xxh3_partition_<variant>() and xxh3_partition_var_<variant>() with the
+ * variant's passes */
+XXH3_WRAPPER_INTERNAL int xxh3_partition_with(xxh3_partition_tuple_t* dst, size_t* hist,
+                                              const xxh3_partition_src_t* src, size_t n,
+                                              unsigned threads, xxh3_partition_count_fn count,
+                                              xxh3_partition_scatter_fn scatter);
+
+#endif /* XXH3_PARTITION_INTERNAL_H */
@@ -0,0 +1,490 @@
+/* _GNU_SOURCE: SCHED_IDLE on Linux; elsewhere _POSIX_C_SOURCE 200112L for
+ * pthreads and clock_gettime under -std=c99 */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#  define _GNU_SOURCE
+#endif
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "xxh3.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#  include <pthread.h>
+#  include <sched.h>
+#  include <time.h>
+#  define XXH3_SCRUB_THREADS 1
+#else
+#  define XXH3_SCRUB_THREADS 0
+#endif
+
+#include "common/internal_utils.h"
+
+/* Background integrity scrubber.
+ *
+ * Regions never move: a region's id is its slot's index. The position is
+ * the next block to check, (region, block). A chunk of blocks is claimed
+ * under the lock, moving the position past it, and checked with the lock
+ * released, so concurrent checkers take disjoint chunks. Each region counts
+ * the chunks of it being checked. xxh3_scrubber_remove() frees the slot,
+ * moves the position out of it and waits those chunks out before the
+ * caller may unmap the region. xxh3_scrubber_add() takes the first free
+ * slot no chunk still reads before growing the array, and free slots at
+ * the end are trimmed, so replacing regions does not grow it. Pausing only sets a flag the worker reads
+ * between chunks, so the position survives it and neither call waits on a
+ * chunk.
+ *
+ * After each chunk the worker sleeps until both limits hold: the bytes
+ * checked since it last caught up stay within bytes_per_sec, and the CPU
+ * time of the chunk is at most cpu_percent of the wall time it spanned. A
+ * pause restarts the byte budget rather than letting it burst. */
+
+/* Bytes checked between two looks at the limits and the pause flag */
+#define XXH3_SCRUB_CHUNK ((size_t)1 << 20)
+
+typedef struct {
+    const unsigned char* base;
+    size_t               len;
+    size_t               block_size;
+    uint64_t             seed;
+    const void*          checksums;
+    unsigned             bits;
+    int                  used;         /* the slot holds a region */
+    unsigned             checking;     /* chunks being checked */
+} xxh3_scrub_region_t;
+
+struct xxh3_scrubber_s {
+    xxh3_scrubber_config_t   config;
+    xxh3_scrub_region_t*     regions;
+    size_t                   n_regions;
+    size_t                   cap_regions;
+    size_t                   live;         /* regions with blocks */
+    size_t                   region;       /* position */
+    size_t                   block;
+    int                      paused;
+    int                      stopping;
+    int                      running;
+    xxh3_scrubber_progress_t progress;
+#if XXH3_SCRUB_THREADS
+    pthread_mutex_t          lock;
+    pthread_cond_t           cond;
+    pthread_t                thread;
+#endif
+};
+
+#if XXH3_SCRUB_THREADS
+#  define XXH3_SCRUB_LOCK(s)      pthread_mutex_lock(&(s)->lock)
+#  define XXH3_SCRUB_UNLOCK(s)    pthread_mutex_unlock(&(s)->lock)
+#  define XXH3_SCRUB_BROADCAST(s) pthread_cond_broadcast(&(s)->cond)
+#else
+#  define XXH3_SCRUB_LOCK(s)      ((void)0)
+#  define XXH3_SCRUB_UNLOCK(s)    ((void)0)
+#  define XXH3_SCRUB_BROADCAST(s) ((void)0)
+#endif
+
+static size_t xxh3_scrub_blocks(const xxh3_scrub_region_t* r)
+{
+    return r->len / r->block_size + (r->len % r->block_size != 0);
+}
+
+/* Moves the position past free slots and empty regions, wrapping to the
+ * start (and
+ * counting a pass if `count_pass`) at the end. Returns 0 if no region has
+ * blocks. Called with the lock held. */
+static int xxh3_scrub_settle(xxh3_scrubber_t* s, int count_pass)
+{
+    if (s->live == 0) {
+        return 0;
+    }
+    for (;;) {
+        while (s->region < s->n_regions
+               && (!s->regions[s->region].used || s->regions[s->region].len == 0)) {
+            s->region++;
+            s->block = 0;
+        }
+        if (s->region < s->n_regions) {
+            return 1;
+        }
+        s->region = 0;
+        s->block  = 0;
+        if (count_pass) {
+            s->progress.passes++;
+            count_pass = 0;
+        }
+    }
+}
+
+/* Checks up to `budget` bytes (at least one block) from the position on,
+ * within one region. Returns the bytes checked, 0 if there is no region. */
+static size_t xxh3_scrub_chunk(xxh3_scrubber_t* s, size_t budget)
+{
+    xxh3_scrub_region_t      r;
+    xxh3_scrubber_progress_t snapshot;
+    size_t                   id, first, count, i, bytes = 0;
+    uint64_t                 bad = 0;
+
+    XXH3_SCRUB_LOCK(s);
+    if (!xxh3_scrub_settle(s, 0)) {
+        XXH3_SCRUB_UNLOCK(s);
+        return 0;
+    }
+    id    = s->region;
+    r     = s->regions[id];
+    first = s->block;
+    count = xxh3_scrub_blocks(&r) - first;
+    if (budget / r.block_size < count) {
+        count = (budget < r.block_size) ? 1 : budget / r.block_size;
+    }
+    s->block = first + count;
+    if (s->block == xxh3_scrub_blocks(&r)) {
+        s->region++;
+        s->block = 0;
+        (void)xxh3_scrub_settle(s, 1);
+    }
+    s->regions[id].checking++;
+    XXH3_SCRUB_UNLOCK(s);
+
+    for (i = first; i < first + count; i++) {
+        const unsigned char* const p    = r.base + i * r.block_size;
+        size_t const               size = (r.len - i * r.block_size < r.block_size)
+                                              ? r.len - i * r.block_size : r.block_size;
+        int                        ok;
+        if (r.bits == 64) {
+            ok = s->config.hash64(p, size, r.seed) == ((const uint64_t*)r.checksums)[i];
+        } else {
+            xxh3_128_t const h = s->config.hash128(p, size, r.seed);
+            xxh3_128_t const e = ((const xxh3_128_t*)r.checksums)[i];
+            ok = h.low == e.low && h.high == e.high;
+        }
+        if (!ok) {
+            bad++;
+            if (s->config.on_mismatch != NULL) {
+                s->config.on_mismatch(s->config.ctx, id, i);
+            }
+        }
+        bytes += size;
+    }
+
+    XXH3_SCRUB_LOCK(s);
+    s->regions[id].checking--;
+    s->progress.bytes      += bytes;
+    s->progress.mismatches += bad;
+    s->progress.region      = s->region;
+    s->progress.block       = s->block;
+    snapshot = s->progress;
+    XXH3_SCRUB_BROADCAST(s);
+    XXH3_SCRUB_UNLOCK(s);
+
+    if (s->config.on_progress != NULL) {
+        s->config.on_progress(s->config.ctx, &snapshot);
+    }
+    return bytes;
+}
+
+#if XXH3_SCRUB_THREADS
+static double xxh3_scrub_now(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Waits on the condition until `deadline` (CLOCK_MONOTONIC seconds), a
+ * pause or a stop. Called with the lock held. */
+static void xxh3_scrub_sleep(xxh3_scrubber_t* s, double deadline)
+{
+    struct timespec ts;
+    ts.tv_sec  = (time_t)deadline;
+    ts.tv_nsec = (long)((deadline - (double)ts.tv_sec) * 1e9);
+    while (!s->stopping && !s->paused && xxh3_scrub_now(CLOCK_MONOTONIC) < deadline) {
+        if (pthread_cond_timedwait(&s->cond, &s->lock, &ts) != 0) {
+            break;
+        }
+    }
+}
+
+static void* xxh3_scrub_worker(void* arg)
+{
+    xxh3_scrubber_t* const s       = (xxh3_scrubber_t*)arg;
+    double const           rate    = (double)s->config.bytes_per_sec;
+    double const           percent = (double)s->config.cpu_percent;
+    double                 next    = 0;   /* when the bytes checked so far are due */
+
+#if defined(SCHED_IDLE)
+    {   /* best effort: run only when the CPU would otherwise idle */
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        (void)pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+    }
+#endif
+    XXH3_SCRUB_LOCK(s);
+    while (!s->stopping) {
+        double start, cpu, wait;
+        size_t bytes;
+
+        if (s->paused || s->live == 0) {
+            pthread_cond_wait(&s->cond, &s->lock);
+            next = 0;
+            continue;
+        }
+        XXH3_SCRUB_UNLOCK(s);
+        start = xxh3_scrub_now(CLOCK_MONOTONIC);
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+        cpu   = xxh3_scrub_now(CLOCK_THREAD_CPUTIME_ID);
+#else
+        cpu   = start;
+#endif
+        bytes = xxh3_scrub_chunk(s, s->config.chunk_bytes);
+        wait  = 0;
+        if (percent < 100) {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+            cpu = xxh3_scrub_now(CLOCK_THREAD_CPUTIME_ID) - cpu;
+#else
+            cpu = xxh3_scrub_now(CLOCK_MONOTONIC) - cpu;
+#endif
+            wait = cpu * (100 - percent) / percent;
+        }
+        if (rate > 0) {
+            next = ((next > start) ? next : start) + (double)bytes / rate;
+            if (next - xxh3_scrub_now(CLOCK_MONOTONIC) > wait) {
+                wait = next - xxh3_scrub_now(CLOCK_MONOTONIC);
+            }
+        }
+        XXH3_SCRUB_LOCK(s);
+        if (wait > 0) {
+            xxh3_scrub_sleep(s, xxh3_scrub_now(CLOCK_MONOTONIC) + wait);
+        }
+    }
+    XXH3_SCRUB_UNLOCK(s);
+    return NULL;
+}
+#endif
+
+xxh3_scrubber_t* xxh3_scrubber_create(const xxh3_scrubber_config_t* config)
+{
+    xxh3_scrubber_t* s;
+
+    if (config == NULL || config->cpu_percent > 100) {
+        return NULL;
+    }
+    s = (xxh3_scrubber_t*)calloc(1, sizeof(*s));
+    if (s == NULL) {
+        return NULL;
+    }
+    s->config = *config;
+    if (s->config.cpu_percent == 0) {
+        s->config.cpu_percent = 100;
+    }
+    if (s->config.chunk_bytes == 0) {
+        s->config.chunk_bytes = XXH3_SCRUB_CHUNK;
+    }
+    if (s->config.hash64 == NULL) {
+        s->config.hash64 = xxh3_64_nt_scalar;
+    }
+    if (s->config.hash128 == NULL) {
+        s->config.hash128 = xxh3_128_nt_scalar;
+    }
+#if XXH3_SCRUB_THREADS
+    {
+        pthread_condattr_t attr;
+        int                ok;
+        if (pthread_condattr_init(&attr) != 0) {
+            free(s);
+            return NULL;
+        }
+        ok = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) == 0
+             && pthread_cond_init(&s->cond, &attr) == 0;
+        pthread_condattr_destroy(&attr);
+        if (!ok) {
+            free(s);
+            return NULL;
+        }
+        if (pthread_mutex_init(&s->lock, NULL) != 0) {
+            pthread_cond_destroy(&s->cond);
+            free(s);
+            return NULL;
+        }
+    }
+#endif
+    return s;
+}
+
+void xxh3_scrubber_free(xxh3_scrubber_t* s)
+{
+    if (s == NULL) {
+        return;
+    }
+#if XXH3_SCRUB_THREADS
+    XXH3_SCRUB_LOCK(s);
+    s->stopping = 1;
+    XXH3_SCRUB_BROADCAST(s);
+    XXH3_SCRUB_UNLOCK(s);
+    if (s->running) {
+        pthread_join(s->thread, NULL);
+    }
+    pthread_cond_destroy(&s->cond);
+    pthread_mutex_destroy(&s->lock);
+#endif
+    free(s->regions);
+    free(s);
+}
+
+int xxh3_scrubber_add(xxh3_scrubber_t* s, const void* base, size_t len, size_t block_size,
+                      uint64_t seed, unsigned bits, const void* checksums, size_t* region)
+{
+    size_t id;
+
+    if (s == NULL || block_size == 0 || (bits != 64 && bits != 128)
+        || ((base == NULL || checksums == NULL) && len > 0)) {
+        return XXH3_ERROR;
+    }
+    XXH3_SCRUB_LOCK(s);
+    /* a slot is freed before the removal waits out its chunks */
+    for (id = 0; id < s->n_regions; id++) {
+        if (!s->regions[id].used && s->regions[id].checking == 0) {
+            break;
+        }
+    }
+    if (id == s->cap_regions) {
+        size_t const               cap = s->cap_regions ? 2 * s->cap_regions : 8;
+        xxh3_scrub_region_t* const grown =
+            (xxh3_scrub_region_t*)realloc(s->regions, cap * sizeof(xxh3_scrub_region_t));
+        if (grown == NULL) {
+            XXH3_SCRUB_UNLOCK(s);
+            return XXH3_ERROR;
+        }
+        s->regions     = grown;
+        s->cap_regions = cap;
+    }
+    if (id == s->n_regions) {
+        s->regions[id].checking = 0;
+        s->n_regions++;
+    }
+    s->regions[id].base       = (const unsigned char*)base;
+    s->regions[id].len        = len;
+    s->regions[id].block_size = block_size;
+    s->regions[id].seed       = seed;
+    s->regions[id].checksums  = checksums;
+    s->regions[id].bits       = bits;
+    s->regions[id].used       = 1;
+    if (region != NULL) {
+        *region = id;
+    }
+    s->live += (len > 0);
+    XXH3_SCRUB_BROADCAST(s);
+    XXH3_SCRUB_UNLOCK(s);
+    return XXH3_OK;
+}
+
+int xxh3_scrubber_remove(xxh3_scrubber_t* s, size_t region)
+{
+    if (s == NULL) {
+        return XXH3_ERROR;
+    }
+    XXH3_SCRUB_LOCK(s);
+    if (region >= s->n_regions || !s->regions[region].used) {
+        XXH3_SCRUB_UNLOCK(s);
+        return XXH3_ERROR;
+    }
+    s->regions[region].used = 0;
+    s->live -= (s->regions[region].len > 0);
+    /* the slot may be reused, so the position must not stay inside it */
+    if (s->region == region) {
+        s->region++;
+        s->block = 0;
+        (void)xxh3_scrub_settle(s, 1);
+    }
+#if XXH3_SCRUB_THREADS
+    while (s->regions[region].checking > 0) {
+        pthread_cond_wait(&s->cond, &s->lock);
+    }
+#endif
+    while (s->n_regions > 0 && !s->regions[s->n_regions - 1].used
+           && s->regions[s->n_regions - 1].checking == 0) {
+        s->n_regions--;
+    }
+    if (s->live == 0) {
+        s->region = 0;
+        s->block  = 0;
+    }
+    s->progress.region = s->region;
+    s->progress.block  = s->block;
+    XXH3_SCRUB_UNLOCK(s);
+    return XXH3_OK;
+}
+
+int xxh3_scrubber_start(xxh3_scrubber_t* s)
+{
+#if XXH3_SCRUB_THREADS
+    int ok;
+
+    if (s == NULL) {
+        return XXH3_ERROR;
+    }
+    XXH3_SCRUB_LOCK(s);
+    ok = s->running || pthread_create(&s->thread, NULL, xxh3_scrub_worker, s) == 0;
+    s->running = ok;
+    XXH3_SCRUB_UNLOCK(s);
+    return ok ? XXH3_OK : XXH3_ERROR;
+#else
+    XXH3_WRAPPER_UNUSED(s);
+    return XXH3_ERROR;
+#endif
+}
+
+void xxh3_scrubber_pause(xxh3_scrubber_t* s)
+{
+    if (s != NULL) {
+        XXH3_SCRUB_LOCK(s);
+        s->paused = 1;
+        XXH3_SCRUB_BROADCAST(s);
+        XXH3_SCRUB_UNLOCK(s);
+    }
+}
+
+void xxh3_scrubber_resume(xxh3_scrubber_t* s)
+{
+    if (s != NULL) {
+        XXH3_SCRUB_LOCK(s);
+        s->paused = 0;
+        XXH3_SCRUB_BROADCAST(s);
+        XXH3_SCRUB_UNLOCK(s);
+    }
+}
+
+size_t xxh3_scrubber_step(xxh3_scrubber_t* s, size_t max_bytes)
+{
+    size_t done = 0;
+    int    running;
+
+    if (s == NULL) {
+        return 0;
+    }
+    XXH3_SCRUB_LOCK(s);
+    running = s->running;
+    XXH3_SCRUB_UNLOCK(s);
+    while (!running && done < max_bytes) {
+        size_t const budget = (max_bytes - done < s->config.chunk_bytes) ? max_bytes - done
+                                                                        : s->config.chunk_bytes;
+        size_t const bytes  = xxh3_scrub_chunk(s, budget);
+        if (bytes == 0) {
+            break;
+        }
+        done += bytes;
+    }
+    return done;
+}
+
+void xxh3_scrubber_progress(xxh3_scrubber_t* s, xxh3_scrubber_progress_t* progress)
+{
+    if (s != NULL && progress != NULL) {
+        XXH3_SCRUB_LOCK(s);
+        *progress = s->progress;
+        XXH3_SCRUB_UNLOCK(s);
+    }
+}
@@ -0,0 +1,280 @@
+/* _POSIX_C_SOURCE 200112L: pthreads and sysconf under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "xxh3.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if !defined(_WIN32)
+#  include <pthread.h>
+#  include <unistd.h>
+#  define XXH3_SORT_THREADS 1
+#else
+#  define XXH3_SORT_THREADS 0
+#endif
+
+#include "common/internal_utils.h"
+
+/* Sorting and deduplication of xxh3_128_t arrays.
+ *
+ * The order is that of xxh3_128_cmp(), which reads each element as the
+ * vendor's { low64, high64 }: on an xxh3_128_t { high, low } it compares
+ * `low` first, then `high`. The sort is an in-place MSD radix sort (American
+ * flag sort) on that 128-bit key, a byte per level: the array is counted by
+ * the key byte, permuted into its 256 buckets by cycles of swaps, and each
+ * bucket sorted at the next byte. Hash bits are uniform, so buckets shrink
+ * by 256x per level and n values need about log256(n) permuting passes
+ * before buckets reach XXH3_SORT_SMALL elements and go to insertion sort.
+ * A level where every key has the same byte (runs of duplicates) is skipped
+ * without permuting. No memory beyond the stack is used, which matters at
+ * hundreds of millions of digests; an LSD sort would need a second array. */
+
+/* Buckets at most this long are insertion sorted */
+#define XXH3_SORT_SMALL 32
+
+/* The permutation writes to 256 bucket heads at once, more streams than the
+ * hardware prefetcher follows; each head is prefetched this many elements
+ * ahead as it advances, which cuts a top-level pass over a large array from
+ * memory latency per element to about a quarter of that */
+#define XXH3_SORT_PREFETCH_DIST 32
+#if defined(__GNUC__) || defined(__clang__)
+#  define XXH3_SORT_PREFETCH(p) __builtin_prefetch((p), 1)
+#else
+#  define XXH3_SORT_PREFETCH(p) ((void)0)
+#endif
+
+/* Byte `level` (0 = most significant) of the 128-bit key */
+static inline unsigned xxh3_sort_byte(const xxh3_128_t* h, unsigned level)
+{
+    uint64_t const word = (level < 8) ? h->low : h->high;
+    return (unsigned)(word >> (56 - 8 * (level & 7))) & 0xFF;
+}
+
+static inline int xxh3_sort_less(const xxh3_128_t* a, const xxh3_128_t* b)
+{
+    return (a->low < b->low) || (a->low == b->low && a->high < b->high);
+}
+
+static void xxh3_sort_insertion(xxh3_128_t* h, size_t n)
+{
+    size_t i, j;
+    for (i = 1; i < n; i++) {
+        xxh3_128_t const v = h[i];
+        for (j = i; j > 0 && xxh3_sort_less(&v, &h[j - 1]); j--) {
+            h[j] = h[j - 1];
+        }
+        h[j] = v;
+    }
+}
+
+/* Counts h[0..n) by key byte from `level` (< 16) on, skipping levels where
+ * all keys agree. Returns the first level that splits, or 16 if the keys
+ * are all equal. */
+static unsigned xxh3_sort_count(const xxh3_128_t* h, size_t n, unsigned level, size_t counts[256])
+{
+    do {
+        size_t i;
+        for (i = 0; i < 256; i++) {
+            counts[i] = 0;
+        }
+        for (i = 0; i < n; i++) {
+            counts[xxh3_sort_byte(&h[i], level)]++;
+        }
+        if (counts[xxh3_sort_byte(&h[0], level)] != n) {
+            break;
+        }
+    } while (++level < 16);
+    return level;
+}
+
+/* Permutes h[0..n) into the buckets given by counts[]; on return
+ * ends[b] is one past bucket b */
+static void xxh3_sort_permute(xxh3_128_t* h, unsigned level, const size_t counts[256],
+                              size_t ends[256])
+{
+    size_t heads[256];
+    size_t sum = 0;
+    unsigned b;
+
+    for (b = 0; b < 256; b++) {
+        heads[b] = sum;
+        sum     += counts[b];
+        ends[b]  = sum;
+    }
+    for (b = 0; b < 256; b++) {
+        while (heads[b] < ends[b]) {
+            xxh3_128_t v = h[heads[b]];
+            unsigned   k = xxh3_sort_byte(&v, level);
+            while (k != b) {
+                xxh3_128_t const t = h[heads[k]];
+                XXH3_SORT_PREFETCH(h + heads[k] + XXH3_SORT_PREFETCH_DIST);
+                h[heads[k]++] = v;
+                v = t;
+                k = xxh3_sort_byte(&v, level);
+            }
+            h[heads[b]++] = v;
+        }
+    }
+}
+
+static void xxh3_sort_msd(xxh3_128_t* h, size_t n, unsigned level)
+{
+    size_t counts[256];
+    size_t ends[256];
+    size_t start = 0;
+    unsigned b;
+
+    if (n <= XXH3_SORT_SMALL) {
+        xxh3_sort_insertion(h, n);
+        return;
+    }
+    level = xxh3_sort_count(h, n, level, counts);
+    if (level == 16) {
+        return;
+    }
+    xxh3_sort_permute(h, level, counts, ends);
+    if (level == 15) {
+        return;
+    }
+    for (b = 0; b < 256; b++) {
+        if (ends[b] - start > 1) {
+            xxh3_sort_msd(h + start, ends[b] - start, level + 1);
+        }
+        start = ends[b];
+    }
+}
+
+void xxh3_128_sort(xxh3_128_t* hashes, size_t n)
+{
+    XXH3_WRAPPER_GUARD({
+        if (hashes == NULL) {
+            return;
+        }
+    });
+    xxh3_sort_msd(hashes, n, 0);
+}
+
+#if XXH3_SORT_THREADS
+
+/* The top level is permuted by the calling thread; the workers, that thread
+ * included, then take its buckets in turn from a shared cursor. Uniform keys
+ * make the buckets about equal, so taking them in order balances the load. */
+typedef struct {
+    xxh3_128_t*     h;
+    const size_t*   ends;
+    unsigned        level;
+    unsigned        next;  /* next bucket to take, under lock */
+    pthread_mutex_t lock;
+} xxh3_sort_job_t;
+
+static void* xxh3_sort_worker(void* arg)
+{
+    xxh3_sort_job_t* const job = (xxh3_sort_job_t*)arg;
+    for (;;) {
+        unsigned b;
+        size_t   start;
+        pthread_mutex_lock(&job->lock);
+        b = job->next++;
+        pthread_mutex_unlock(&job->lock);
+        if (b >= 256) {
+            return NULL;
+        }
+        start = (b == 0) ? 0 : job->ends[b - 1];
+        if (job->ends[b] - start > 1) {
+            xxh3_sort_msd(job->h + start, job->ends[b] - start, job->level + 1);
+        }
+    }
+}
+
+#endif /* XXH3_SORT_THREADS */
+
+void xxh3_128_sort_mt(xxh3_128_t* hashes, size_t n, unsigned threads)
+{
+#if XXH3_SORT_THREADS
+    pthread_t       pool[64];
+    xxh3_sort_job_t job;
+    size_t          counts[256];
+    size_t          ends[256];
+    unsigned        started = 0;
+    unsigned        t;
+#endif
+
+    XXH3_WRAPPER_GUARD({
+        if (hashes == NULL) {
+            return;
+        }
+    });
+#if XXH3_SORT_THREADS
+    if (threads == 0) {
+        long const cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? (unsigned)cpus : 1;
+    }
+    threads = (threads > 64) ? 64 : threads;
+    /* below a few buckets' worth per thread, threads cost more than they save */
+    if (threads <= 1 || n < (size_t)threads * 4096) {
+        xxh3_sort_msd(hashes, n, 0);
+        return;
+    }
+    job.level = xxh3_sort_count(hashes, n, 0, counts);
+    if (job.level == 16) {
+        return;
+    }
+    xxh3_sort_permute(hashes, job.level, counts, ends);
+    if (job.level == 15) {
+        return;
+    }
+    job.h    = hashes;
+    job.ends = ends;
+    job.next = 0;
+    if (pthread_mutex_init(&job.lock, NULL) != 0) {
+        job.next = 256;
+        for (t = 0; t < 256; t++) {
+            size_t const start = (t == 0) ? 0 : ends[t - 1];
+            xxh3_sort_msd(hashes + start, ends[t] - start, job.level + 1);
+        }
+        return;
+    }
+    /* the calling thread is one of the workers */
+    for (t = 1; t < threads; t++) {
+        if (pthread_create(&pool[started], NULL, xxh3_sort_worker, &job) == 0) {
+            started++;
+        }
+    }
+    (void)xxh3_sort_worker(&job);
+    for (t = 0; t < started; t++) {
+        pthread_join(pool[t], NULL);
+    }
+    pthread_mutex_destroy(&job.lock);
+#else
+    XXH3_WRAPPER_UNUSED(threads);
+    xxh3_sort_msd(hashes, n, 0);
+#endif
+}
+
+size_t xxh3_128_unique(xxh3_128_t* hashes, size_t n)
+{
+    xxh3_128_t last;
+    size_t i, out;
+
+    XXH3_WRAPPER_GUARD({
+        if (hashes == NULL) {
+            return 0;
+        }
+    });
+    if (n == 0) {
+        return 0;
+    }
+    /* branch-free: every digest is stored, and kept only if it differs from
+     * its predecessor (slot `out` is never ahead of i) */
+    last = hashes[0];
+    for (i = 1, out = 1; i < n; i++) {
+        xxh3_128_t const v = hashes[i];
+        hashes[out] = v;
+        out += (size_t)((v.low != last.low) | (v.high != last.high));
+        last = v;
+    }
+    return out;
+}
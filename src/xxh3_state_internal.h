@@ -0,0 +1,36 @@
+#ifndef XXH3_STATE_INTERNAL_H
+#define XXH3_STATE_INTERNAL_H
+
+/* Internal access to the vendor state behind an `xxh3_state_t` handle.
+ *
+ * `struct xxh3_state_t` is private to `src/xxh3_wrapper.c`. TUs that drive
+ * the vendor streaming internals directly (compiled with XXH_INLINE_ALL,
+ * which renames the vendor types) obtain the `XXH3_state_t*` through this
+ * accessor. The pointer is untyped so the declaration is valid in both
+ * compilation modes; cast it to the local `XXH3_state_t*`.
+ */
+
+#include <stdint.h>
+
+#include "xxh3.h"
+#include "common/internal_utils.h"
+
+/* Returns NULL when `state` is NULL or was never allocated a vendor state */
+XXH3_WRAPPER_INTERNAL void* xxh3_vendorState(const xxh3_state_t* state);
+
+/* XXH32 streaming state. It is the wrapper's own rather than the vendor's
+ * XXH32_state_t, whose private fields differ between vendor releases, so
+ * that xxh32_update() and the vector xxh32_update_<variant>() can share it
+ * (see src/xxh3_xxh32_internal.h). */
+typedef struct {
+    uint32_t      total_len;   /* bytes hashed, modulo 2^32 */
+    uint32_t      large_len;   /* set once 16 bytes or more were hashed */
+    uint32_t      v[4];        /* accumulators */
+    unsigned char buffer[16];  /* bytes of an incomplete stripe */
+    uint32_t      buffered;
+} xxh32_stream_t;
+
+/* Returns NULL when `state` is NULL */
+XXH3_WRAPPER_INTERNAL xxh32_stream_t* xxh3_xxh32Stream(const xxh3_state_t* state);
+
+#endif /* XXH3_STATE_INTERNAL_H */
@@ -0,0 +1,133 @@
+#include "xxh3.h"
+
+/* Streaming extensions that need the vendor's internal update loop.
+ *
+ * `src/xxh3_wrapper.c` delegates to the public vendor API compiled once in
+ * `xxhash.c`. The functions here instead inline the vendor implementation
+ * (same XXH_VECTOR as `xxhash.c`: SSE2 on x86-64, NEON on aarch64) so they
+ * can run `XXH3_update()` with custom stripe kernels or read the vendor
+ * state fields directly. They operate on the
+ * same `xxh3_state_t` and interleave freely with `xxh3_64_update()` etc. */
+#define XXH_INLINE_ALL
+#include "xxhash.h"
+
+#include "xxh3_converters.h"
+#include "xxh3_state_internal.h"
+#include "common/internal_utils.h"
+
+#include "variants/templates/nt.h"
+
+/* ============================================
+   Non-temporal streaming update
+   ============================================ */
+
+int xxh3_64_update_nt(xxh3_state_t* state, const void* input, size_t size)
+{
+    XXH3_state_t* vstate = (XXH3_state_t*)xxh3_vendorState(state);
+    XXH3_WRAPPER_GUARD(
+        if (vstate == NULL) {
+            return XXH3_ERROR;
+        }
+    );
+    return (int)XXH3_update(vstate, (const xxh_u8*)input, size,
+                            xxh3_accumulate_nt, XXH3_scrambleAcc);
+}
+
+int xxh3_128_update_nt(xxh3_state_t* state, const void* input, size_t size)
+{
+    /* XXH3 64- and 128-bit streams share the same update routine */
+    return xxh3_64_update_nt(state, input, size);
+}
+
+/* ============================================
+   Prefix checkpoints
+   ============================================ */
+
+XXH_FORCE_INLINE const xxh_u8* xxh3_stateSecret(const XXH3_state_t* state)
+{
+    return (state->extSecret == NULL) ? state->customSecret : state->extSecret;
+}
+
+/* Totals of at most XXH3_MIDSIZE_MAX bytes never touch the accumulators:
+ * the whole prefix is still buffered, so prefix + suffix is joined in `dst`
+ * and hashed one-shot, as the vendor digest would. Returns the length. */
+XXH_FORCE_INLINE size_t xxh3_joinShort(xxh_u8* dst, const XXH3_state_t* prefix,
+                                       const void* suffix, size_t size)
+{
+    size_t const plen = (size_t)prefix->totalLen;
+    XXH_memcpy(dst, prefix->buffer, plen);
+    if (size > 0) {
+        XXH_memcpy(dst + plen, suffix, size);
+    }
+    return plen + size;
+}
+
+/* Loads the resumable part of `src` into `dst`: accumulators, counters and
+ * the buffered tail. The secret is referenced in place rather than copied;
+ * `dst->customSecret` is left unset. */
+static void xxh3_fork(XXH3_state_t* dst, const XXH3_state_t* src)
+{
+    XXH_memcpy(dst->acc, src->acc, sizeof(dst->acc));
+    XXH_memcpy(dst->buffer, src->buffer, src->bufferedSize);
+    /* XXH3_digest_long() rebuilds a short last stripe from the end of the
+     * buffer, which still holds the last consumed stripe */
+    if (src->bufferedSize < XXH_STRIPE_LEN && src->totalLen > src->bufferedSize) {
+        XXH_memcpy(dst->buffer + sizeof(dst->buffer) - XXH_STRIPE_LEN,
+                   src->buffer + sizeof(src->buffer) - XXH_STRIPE_LEN, XXH_STRIPE_LEN);
+    }
+    dst->bufferedSize      = src->bufferedSize;
+    dst->useSeed           = src->useSeed;
+    dst->nbStripesSoFar    = src->nbStripesSoFar;
+    dst->totalLen          = src->totalLen;
+    dst->nbStripesPerBlock = src->nbStripesPerBlock;
+    dst->secretLimit       = src->secretLimit;
+    dst->seed              = src->seed;
+    dst->extSecret         = xxh3_stateSecret(src);
+}
+
+uint64_t xxh3_64_digest_withSuffix(const xxh3_state_t* state, const void* suffix, size_t size)
+{
+    const XXH3_state_t* prefix = (const XXH3_state_t*)xxh3_vendorState(state);
+    XXH3_state_t fork;
+    XXH3_WRAPPER_GUARD(
+        if (prefix == NULL || (suffix == NULL && size > 0)) {
+            return 0;
+        }
+    );
+    if (prefix->totalLen + size <= XXH3_MIDSIZE_MAX) {
+        xxh_u8 joined[XXH3_MIDSIZE_MAX];
+        size_t const len = xxh3_joinShort(joined, prefix, suffix, size);
+        if (prefix->useSeed) {
+            return XXH3_64bits_withSeed(joined, len, prefix->seed);
+        }
+        return XXH3_64bits_withSecret(joined, len, xxh3_stateSecret(prefix),
+                                      prefix->secretLimit + XXH_STRIPE_LEN);
+    }
+    xxh3_fork(&fork, prefix);
+    (void)XXH3_64bits_update(&fork, suffix, size);
+    return XXH3_64bits_digest(&fork);
+}
+
+xxh3_128_t xxh3_128_digest_withSuffix(const xxh3_state_t* state, const void* suffix, size_t size)
+{
+    const XXH3_state_t* prefix = (const XXH3_state_t*)xxh3_vendorState(state);
+    XXH3_state_t fork;
+    XXH3_WRAPPER_GUARD(
+        if (prefix == NULL || (suffix == NULL && size > 0)) {
+            return ((xxh3_128_t){0,0});
+        }
+    );
+    if (prefix->totalLen + size <= XXH3_MIDSIZE_MAX) {
+        xxh_u8 joined[XXH3_MIDSIZE_MAX];
+        size_t const len = xxh3_joinShort(joined, prefix, suffix, size);
+        /* XXH3_128bits_digest() tests the seed itself, not useSeed */
+        if (prefix->seed) {
+            return xxh128_to_xxh3(XXH3_128bits_withSeed(joined, len, prefix->seed));
+        }
+        return xxh128_to_xxh3(XXH3_128bits_withSecret(joined, len, xxh3_stateSecret(prefix),
+                                                      prefix->secretLimit + XXH_STRIPE_LEN));
+    }
+    xxh3_fork(&fork, prefix);
+    (void)XXH3_128bits_update(&fork, suffix, size);
+    return xxh128_to_xxh3(XXH3_128bits_digest(&fork));
+}
@@ -5,6 +5,7 @@
 
 #include "xxhash.h"
 #include "xxh3_converters.h"
+#include "xxh3_state_internal.h"
 #include "common/internal_utils.h"
 
 /* Vendor prototypes (ensure thin delegates compile even if header marshalling
@@ -15,7 +16,8 @@ extern XXH64_hash_t XXH3_64bits_withSecretandSeed(const void* input, size_t leng
 extern XXH128_hash_t XXH3_128bits_withSecretandSeed(const void* input, size_t length, const void* secret, size_t secretSize, XXH64_hash_t seed);
 
 struct xxh3_state_t {
-    XXH3_state_t* state;
+    XXH3_state_t*  state;
+    xxh32_stream_t xxh32;
 };
 
 static inline xxh3_128_t xxh3_convert_128(XXH128_hash_t value)
@@ -61,6 +63,16 @@ void xxh3_freeState(xxh3_state_t* state)
     free(state);
 }
 
+void* xxh3_vendorState(const xxh3_state_t* state)
+{
+    return (state != NULL) ? state->state : NULL;
+}
+
+xxh32_stream_t* xxh3_xxh32Stream(const xxh3_state_t* state)
+{
+    return (state != NULL) ? (xxh32_stream_t*)&state->xxh32 : NULL;
+}
+
 void xxh3_64_reset(xxh3_state_t* state, uint64_t seed)
 {
     XXH3_WRAPPER_GUARD(
@@ -236,6 +248,7 @@ int xxh3_copyState(xxh3_state_t* dst, const xxh3_state_t* src)
     }
     /* Copy vendor state */
     XXH3_copyState(dst->state, src->state);
+    dst->xxh32 = src->xxh32;
     return XXH3_OK;
 }
 
@@ -248,35 +261,8 @@ uint32_t xxh32(const void* input, size_t size, uint32_t seed)
     return XXH32(input, size, seed);
 }
 
-void xxh32_reset(xxh3_state_t* state, uint32_t seed)
-{
-    XXH3_WRAPPER_GUARD(
-        if (state == NULL || state->state == NULL) {
-            return;
-        }
-    );
-    (void)XXH32_reset((XXH32_state_t*)state->state, seed);
-}
-
-int xxh32_update(xxh3_state_t* state, const void* input, size_t size)
-{
-    XXH3_WRAPPER_GUARD(
-        if (state == NULL || state->state == NULL) {
-            return XXH3_ERROR;
-        }
-    );
-    return (int)XXH32_update((XXH32_state_t*)state->state, input, size);
-}
-
-uint32_t xxh32_digest(xxh3_state_t* state)
-{
-    XXH3_WRAPPER_GUARD(
-        if (state == NULL || state->state == NULL) {
-            return 0;
-        }
-    );
-    return XXH32_digest((XXH32_state_t*)state->state);
-}
+/* xxh32_reset(), xxh32_update() and xxh32_digest() are in
+ * src/variants/scalar.c, next to the vendor internals they build on */
 
 /* ============================================
    XXH64: Traditional 64-bit hash
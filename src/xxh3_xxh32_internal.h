@@ -0,0 +1,72 @@
+#ifndef XXH3_XXH32_INTERNAL_H
+#define XXH3_XXH32_INTERNAL_H
+
+/* XXH32 streaming on the wrapper's own state (xxh32_stream_t, see
+ * src/xxh3_state_internal.h), shared by the scalar xxh32_update() in
+ * variants/scalar.c and the vector xxh32_update_<variant>() of
+ * variants/templates/xxh32.h. Only the stripe loop differs between them;
+ * it is passed in and inlined. The digest follows XXH32_digest() and
+ * matches xxh32() of the concatenated input.
+ *
+ * Include after xxhash.h (XXH_INLINE_ALL) and xxh3_state_internal.h.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+typedef void (*xxh32_stripes_fn)(xxh_u32 v[4], const xxh_u8* p, size_t nbStripes);
+
+XXH_FORCE_INLINE void xxh32_stream_reset(xxh32_stream_t* s, xxh_u32 seed)
+{
+    memset(s, 0, sizeof(*s));
+    s->v[0] = seed + XXH_PRIME32_1 + XXH_PRIME32_2;
+    s->v[1] = seed + XXH_PRIME32_2;
+    s->v[2] = seed + 0;
+    s->v[3] = seed - XXH_PRIME32_1;
+}
+
+XXH_FORCE_INLINE void xxh32_stream_update(xxh32_stream_t* s, const xxh_u8* p, size_t size,
+                                          xxh32_stripes_fn stripes)
+{
+    const xxh_u8* const bEnd = p + size;
+
+    s->total_len += (xxh_u32)size;
+    s->large_len |= (xxh_u32)((size >= 16) | (s->total_len >= 16));
+
+    if (s->buffered + size < 16) {
+        XXH_memcpy(s->buffer + s->buffered, p, size);
+        s->buffered += (xxh_u32)size;
+        return;
+    }
+    if (s->buffered) {
+        XXH_memcpy(s->buffer + s->buffered, p, 16 - s->buffered);
+        stripes(s->v, s->buffer, 1);
+        p += 16 - s->buffered;
+        s->buffered = 0;
+    }
+    if ((size_t)(bEnd - p) >= 16) {
+        size_t const nbStripes = (size_t)(bEnd - p) / 16;
+        stripes(s->v, p, nbStripes);
+        p += nbStripes * 16;
+    }
+    if (p < bEnd) {
+        XXH_memcpy(s->buffer, p, (size_t)(bEnd - p));
+        s->buffered = (xxh_u32)(bEnd - p);
+    }
+}
+
+XXH_FORCE_INLINE xxh_u32 xxh32_stream_digest(const xxh32_stream_t* s)
+{
+    xxh_u32 h32;
+
+    if (s->large_len) {
+        h32 = XXH_rotl32(s->v[0], 1) + XXH_rotl32(s->v[1], 7)
+            + XXH_rotl32(s->v[2], 12) + XXH_rotl32(s->v[3], 18);
+    } else {
+        h32 = s->v[2] /* == seed */ + XXH_PRIME32_5;
+    }
+    h32 += s->total_len;
+    return XXH32_finalize(h32, s->buffer, s->buffered, XXH_unaligned);
+}
+
+#endif /* XXH3_XXH32_INTERNAL_H */
@@ -0,0 +1,235 @@
+/* Per-block checksum benchmark.
+ *
+ * Checksums an --extent MiB buffer in blocks of each --block bytes and
+ * reports GB/s. The "per call" columns call xxh3_64_<variant>() once per
+ * block; the "blocks" columns time one xxh3_64_blocks_<variant>() over the
+ * whole extent. Both are timed with seed 0 and with a nonzero seed, whose
+ * secret the per-call loop derives for every block. Each variant's
+ * checksums must match xxh3_64_scalar() per block, and
+ * xxh3_64_blocks_verify_<variant>() must accept them and find a corrupted
+ * block.
+ *
+ * Command line (all optional):
+ *   --extent=N  MiB checksummed per pass (default 8)
+ *   --block=N   block size in bytes, repeatable (default 512, 4096 and 65536)
+ *   --rounds=N  passes, the best one is reported (default 5)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime and sigsetjmp under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+
+#include "xxh3.h"
+
+#define SEED 0x9E3779B97F4A7C15ULL
+
+typedef uint64_t (*hash_fn)(const void*, size_t, uint64_t);
+typedef int (*blocks_fn)(const void*, size_t, size_t, uint64_t, uint64_t*);
+typedef int (*verify_fn)(const void*, size_t, size_t, uint64_t, const uint64_t*, size_t*, size_t,
+                         size_t*, unsigned);
+
+static size_t g_rounds = 5;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+typedef struct {
+    const char* name;
+    hash_fn     one;
+    blocks_fn   blocks;
+    verify_fn   verify;
+} variant_t;
+
+/* GB/s of the best of g_rounds passes; per_call picks the loop */
+static double run(const variant_t* v, unsigned char* buf, size_t len, size_t block, uint64_t seed,
+                  uint64_t* out, int per_call)
+{
+    size_t const n    = len / block + (len % block != 0);
+    double       best = 0;
+    size_t       r, i;
+
+    for (r = 0; r < g_rounds; r++) {
+        double t = now_sec();
+        if (per_call) {
+            for (i = 0; i < n; i++) {
+                out[i] = v->one(buf + i * block, (i + 1 < n) ? block : len - i * block, seed);
+            }
+        } else {
+            (void)v->blocks(buf, len, block, seed, out);
+        }
+        t = now_sec() - t;
+        best = (r == 0 || t < best) ? t : best;
+    }
+    return (double)len / best / 1e9;
+}
+
+/* 1 if out[] holds the scalar checksums and verify accepts them, then
+ * flags exactly a corrupted block */
+static int check(const variant_t* v, unsigned char* buf, size_t len, size_t block, uint64_t seed,
+                 const uint64_t* out)
+{
+    size_t const n = len / block + (len % block != 0);
+    size_t       bad[2], n_bad = 1, i;
+    int          ok = 1;
+
+    for (i = 0; i < n; i++) {
+        ok &= out[i] == xxh3_64_scalar(buf + i * block, (i + 1 < n) ? block : len - i * block, seed);
+    }
+    ok &= v->verify(buf, len, block, seed, out, bad, 2, &n_bad, 1) == XXH3_OK && n_bad == 0;
+    buf[(n / 2) * block] ^= 1;
+    ok &= v->verify(buf, len, block, seed, out, bad, 2, &n_bad, 1) == XXH3_OK && n_bad == 1
+          && bad[0] == n / 2;
+    buf[(n / 2) * block] ^= 1;
+    return ok;
+}
+
+/* Probe a variant under a SIGILL/SIGSEGV guard before timing it */
+static sigjmp_buf _bench_jmpbuf;
+static volatile sig_atomic_t _bench_caught_sig;
+
+static void _bench_sig_handler(int sig)
+{
+    _bench_caught_sig = sig;
+    siglongjmp(_bench_jmpbuf, 1);
+}
+
+static int variant_supported(blocks_fn fn)
+{
+    static const unsigned char buf[600] = { 0 };
+    uint64_t                   out[2];
+    struct sigaction           act, oldill, oldsegv;
+    volatile int               ok = 0;
+
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = _bench_sig_handler;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGILL,  &act, &oldill);
+    sigaction(SIGSEGV, &act, &oldsegv);
+    if (sigsetjmp(_bench_jmpbuf, 1) == 0) {
+        ok = fn(buf, sizeof(buf), 300, 1, out) == XXH3_OK;
+    }
+    sigaction(SIGILL,  &oldill,  NULL);
+    sigaction(SIGSEGV, &oldsegv, NULL);
+    return ok;
+}
+
+/* See bench_variants.c: only reference variants that can exist here */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define X86_FN(fn) fn
+#else
+#  define X86_FN(fn) NULL
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define ARM_FN(fn) fn
+#else
+#  define ARM_FN(fn) NULL
+#endif
+
+#define VARIANT(v, ISA_FN) \
+    { #v, ISA_FN(xxh3_64_##v), ISA_FN(xxh3_64_blocks_##v), ISA_FN(xxh3_64_blocks_verify_##v) }
+#define SCALAR_FN(fn) fn
+
+static int parse_count(const char* str, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || v == 0) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const variant_t variants[] = {
+        VARIANT(scalar, SCALAR_FN), VARIANT(sse2, X86_FN), VARIANT(avx2, X86_FN),
+        VARIANT(avx512, X86_FN),    VARIANT(neon, ARM_FN), VARIANT(sve, ARM_FN),
+    };
+    size_t         blocks[16] = { 512, 4096, 65536 };
+    size_t         n_blocks = 3, extent = 8, min_block = SIZE_MAX, len, b, i;
+    int            blocks_given = 0;
+    unsigned char* buf;
+    uint64_t*      out;
+    int            arg;
+
+    for (arg = 1; arg < argc; arg++) {
+        int ok;
+        if (strncmp(argv[arg], "--extent=", 9) == 0) {
+            ok = parse_count(argv[arg] + 9, &extent);
+        } else if (strncmp(argv[arg], "--block=", 8) == 0) {
+            n_blocks = blocks_given ? n_blocks : 0;
+            ok = n_blocks < 16 && parse_count(argv[arg] + 8, &blocks[n_blocks]);
+            n_blocks += ok ? 1 : 0;
+            blocks_given = 1;
+        } else if (strncmp(argv[arg], "--rounds=", 9) == 0) {
+            ok = parse_count(argv[arg] + 9, &g_rounds);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--extent=MiB] [--block=N]... [--rounds=N]\n", argv[0]);
+            return 2;
+        }
+    }
+    for (b = 0; b < n_blocks; b++) {
+        min_block = (blocks[b] < min_block) ? blocks[b] : min_block;
+    }
+    len = extent << 20;
+    buf = (unsigned char*)malloc(len);
+    out = (uint64_t*)malloc((len / min_block + 1) * sizeof(uint64_t));
+    if (buf == NULL || out == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    for (i = 0; i < len; i++) {
+        buf[i] = (unsigned char)(i * 2654435761U >> 24);
+    }
+
+    printf("%lu MiB extent, best of %lu rounds, GB/s\n", (unsigned long)extent,
+           (unsigned long)g_rounds);
+    for (b = 0; b < n_blocks; b++) {
+        printf("\n%lu-byte blocks\n", (unsigned long)blocks[b]);
+        printf("%-10s %10s %10s %14s %14s\n", "variant", "per call", "blocks", "per call, seed",
+               "blocks, seed");
+        for (i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+            double rate[4];
+            int    s, ok = 1;
+            if (variants[i].blocks == NULL) {
+                continue;
+            }
+            if (!variant_supported(variants[i].blocks)) {
+                printf("%-10s: not supported on this CPU, skipping\n", variants[i].name);
+                continue;
+            }
+            for (s = 0; s < 2; s++) {
+                uint64_t const seed = s ? SEED : 0;
+                rate[2 * s]     = run(&variants[i], buf, len, blocks[b], seed, out, 1);
+                rate[2 * s + 1] = run(&variants[i], buf, len, blocks[b], seed, out, 0);
+                ok &= check(&variants[i], buf, len, blocks[b], seed, out);
+            }
+            if (!ok) {
+                fprintf(stderr, "%s: checksums differ from xxh3_64_scalar()\n", variants[i].name);
+                return 1;
+            }
+            printf("%-10s %10.2f %10.2f %14.2f %14.2f\n", variants[i].name, rate[0], rate[1],
+                   rate[2], rate[3]);
+        }
+    }
+
+    free(out);
+    free(buf);
+    return 0;
+}
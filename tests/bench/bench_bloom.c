@@ -0,0 +1,350 @@
+/* Blocked Bloom filter benchmark.
+ *
+ * The "k-hash" row is the textbook filter teams write around
+ * xxh3_64_scalar(): one flat bit array of --bits bits per key and
+ * k = bits * ln 2 probes, each from its own xxh3_64_scalar() call under seed
+ * 0..k-1 and reduced modulo the bit count, so a key touches up to k cache
+ * lines. One row per variant then times xxh3_bloom_add_<variant>() and
+ * xxh3_bloom_contains_<variant>() a key at a time ("single") and the batch
+ * forms over the whole key array ("batch"). --count 16-byte keys are added;
+ * as many present and as many absent keys are then queried, interleaved.
+ * Reports million keys per second and the measured false-positive rate.
+ * Every variant must build the same image and give the same answers.
+ *
+ * Command line (all optional):
+ *   --count=N   keys added (default 1000000)
+ *   --bits=N    bits per key (default 10)
+ *   --rounds=N  passes, the best one is reported (default 3)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime and sigsetjmp under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+
+#include "xxh3.h"
+
+#define KEY_SIZE 16
+
+typedef void (*add_fn)(xxh3_bloom_t*, const void*, size_t);
+typedef int (*contains_fn)(const xxh3_bloom_t*, const void*, size_t);
+typedef void (*add_batch_fn)(xxh3_bloom_t*, const void* const*, const size_t*, size_t);
+typedef size_t (*contains_batch_fn)(const xxh3_bloom_t*, const void* const*, const size_t*, size_t,
+                                    unsigned char*);
+
+static size_t g_count  = 1000000;
+static size_t g_bits   = 10;
+static size_t g_rounds = 3;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+typedef struct {
+    const void**   keys;     /* g_count keys to add */
+    const void**   queries;  /* 2 * g_count: added and absent keys, alternating */
+    size_t*        sizes;    /* 2 * g_count, all KEY_SIZE */
+    unsigned char* found;    /* 2 * g_count */
+} workload;
+
+/* ------------------------------------------------------------ baseline */
+
+typedef struct {
+    unsigned char* bits;
+    uint64_t       nbits;
+    unsigned       k;
+} khash_filter;
+
+static void khash_add(khash_filter* f, const void* key)
+{
+    unsigned j;
+    for (j = 0; j < f->k; j++) {
+        uint64_t const b = xxh3_64_scalar(key, KEY_SIZE, j) % f->nbits;
+        f->bits[b >> 3] |= (unsigned char)(1U << (b & 7));
+    }
+}
+
+static int khash_contains(const khash_filter* f, const void* key)
+{
+    unsigned j;
+    for (j = 0; j < f->k; j++) {
+        uint64_t const b = xxh3_64_scalar(key, KEY_SIZE, j) % f->nbits;
+        if (!((f->bits[b >> 3] >> (b & 7)) & 1)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Adds and queries with the baseline; rates in M keys/s, hits of absent keys */
+static void run_khash(const workload* w, double* add, double* query, size_t* false_hits)
+{
+    khash_filter f;
+    size_t       r, i;
+
+    f.nbits = (uint64_t)g_count * g_bits;
+    f.k     = (unsigned)((g_bits * 693 + 500) / 1000);  /* bits * ln 2, rounded */
+    f.k     = f.k == 0 ? 1 : f.k;
+    f.bits  = (unsigned char*)malloc((size_t)(f.nbits + 7) / 8);
+    if (f.bits == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+    *add = *query = 0;
+    for (r = 0; r < g_rounds; r++) {
+        double t0, t1, t2;
+        size_t fp = 0;
+        memset(f.bits, 0, (size_t)(f.nbits + 7) / 8);
+        t0 = now_sec();
+        for (i = 0; i < g_count; i++) {
+            khash_add(&f, w->keys[i]);
+        }
+        t1 = now_sec();
+        for (i = 0; i < 2 * g_count; i++) {
+            w->found[i] = (unsigned char)khash_contains(&f, w->queries[i]);
+        }
+        t2 = now_sec();
+        for (i = 1; i < 2 * g_count; i += 2) {
+            fp += w->found[i];
+        }
+        *false_hits = fp;
+        *add   = (r == 0 || t1 - t0 < *add) ? t1 - t0 : *add;
+        *query = (r == 0 || t2 - t1 < *query) ? t2 - t1 : *query;
+    }
+    *add   = (double)g_count / *add / 1e6;
+    *query = (double)(2 * g_count) / *query / 1e6;
+    free(f.bits);
+}
+
+/* ------------------------------------------------------------------ runs */
+
+typedef struct {
+    const char*       name;
+    add_fn            add;
+    contains_fn       contains;
+    add_batch_fn      add_batch;
+    contains_batch_fn contains_batch;
+} variant_t;
+
+/* Rates in M keys/s: rate[0] add, rate[1] add batch, rate[2] query,
+ * rate[3] query batch. The filter is left holding all keys. Returns the
+ * number of answers that differ between the single and batch forms. */
+static size_t run_variant(const variant_t* v, xxh3_bloom_t* f, unsigned char* image, size_t size,
+                          const workload* w, double rate[4])
+{
+    double best[4] = { 0, 0, 0, 0 };
+    size_t r, i, diff = 0;
+
+    for (r = 0; r < g_rounds; r++) {
+        double t[4];
+        size_t hits = 0, batch_hits;
+
+        xxh3_bloom_init(f, image, size, f->nblocks, f->seed);
+        t[0] = now_sec();
+        for (i = 0; i < g_count; i++) {
+            v->add(f, w->keys[i], KEY_SIZE);
+        }
+        t[0] = now_sec() - t[0];
+        xxh3_bloom_init(f, image, size, f->nblocks, f->seed);
+        t[1] = now_sec();
+        v->add_batch(f, w->keys, w->sizes, g_count);
+        t[1] = now_sec() - t[1];
+        t[2] = now_sec();
+        for (i = 0; i < 2 * g_count; i++) {
+            hits += (size_t)v->contains(f, w->queries[i], KEY_SIZE);
+        }
+        t[2] = now_sec() - t[2];
+        t[3] = now_sec();
+        batch_hits = v->contains_batch(f, w->queries, w->sizes, 2 * g_count, w->found);
+        t[3] = now_sec() - t[3];
+        diff += hits != batch_hits;
+        for (i = 0; i < 4; i++) {
+            best[i] = (r == 0 || t[i] < best[i]) ? t[i] : best[i];
+        }
+    }
+    rate[0] = (double)g_count / best[0] / 1e6;
+    rate[1] = (double)g_count / best[1] / 1e6;
+    rate[2] = (double)(2 * g_count) / best[2] / 1e6;
+    rate[3] = (double)(2 * g_count) / best[3] / 1e6;
+    return diff;
+}
+
+/* Probe a variant under a SIGILL/SIGSEGV guard before timing it */
+static sigjmp_buf _bench_jmpbuf;
+static volatile sig_atomic_t _bench_caught_sig;
+
+static void _bench_sig_handler(int sig)
+{
+    _bench_caught_sig = sig;
+    siglongjmp(_bench_jmpbuf, 1);
+}
+
+static int variant_supported(add_fn fn)
+{
+    unsigned char    image[64 + 32];
+    xxh3_bloom_t     f;
+    struct sigaction act, oldill, oldsegv;
+    volatile int     ok = 0;
+
+    xxh3_bloom_init(&f, image, sizeof(image), 1, 0);
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = _bench_sig_handler;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGILL,  &act, &oldill);
+    sigaction(SIGSEGV, &act, &oldsegv);
+    if (sigsetjmp(_bench_jmpbuf, 1) == 0) {
+        fn(&f, "probe", 5);
+        ok = 1;
+    }
+    sigaction(SIGILL,  &oldill,  NULL);
+    sigaction(SIGSEGV, &oldsegv, NULL);
+    return ok;
+}
+
+/* See bench_variants.c: only reference variants that can exist here */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define X86_FN(fn) fn
+#else
+#  define X86_FN(fn) NULL
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define ARM_FN(fn) fn
+#else
+#  define ARM_FN(fn) NULL
+#endif
+
+#define VARIANT(v, ISA_FN) { #v, ISA_FN(xxh3_bloom_add_##v), ISA_FN(xxh3_bloom_contains_##v), \
+                             ISA_FN(xxh3_bloom_add_batch_##v), ISA_FN(xxh3_bloom_contains_batch_##v) }
+#define SCALAR_FN(fn) fn
+
+static int parse_count(const char* str, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || v == 0) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const variant_t variants[] = {
+        VARIANT(scalar, SCALAR_FN), VARIANT(sse2, X86_FN), VARIANT(avx2, X86_FN),
+        VARIANT(avx512, X86_FN),    VARIANT(neon, ARM_FN), VARIANT(sve, ARM_FN),
+    };
+    workload       w;
+    unsigned char* keys;
+    unsigned char* image;
+    unsigned char* ref = NULL;
+    size_t         size, i;
+    uint64_t       blocks;
+    int            arg;
+
+    for (arg = 1; arg < argc; arg++) {
+        int ok;
+        if (strncmp(argv[arg], "--count=", 8) == 0) {
+            ok = parse_count(argv[arg] + 8, &g_count);
+        } else if (strncmp(argv[arg], "--bits=", 7) == 0) {
+            ok = parse_count(argv[arg] + 7, &g_bits);
+        } else if (strncmp(argv[arg], "--rounds=", 9) == 0) {
+            ok = parse_count(argv[arg] + 9, &g_rounds);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--count=N] [--bits=N] [--rounds=N]\n", argv[0]);
+            return 2;
+        }
+    }
+    blocks    = xxh3_bloom_blocks(g_count, (unsigned)g_bits);
+    size      = xxh3_bloom_size(blocks);
+    keys      = (unsigned char*)malloc(2 * g_count * KEY_SIZE);
+    w.keys    = (const void**)malloc(g_count * sizeof(void*));
+    w.queries = (const void**)malloc(2 * g_count * sizeof(void*));
+    w.sizes   = (size_t*)malloc(2 * g_count * sizeof(size_t));
+    w.found   = (unsigned char*)malloc(2 * g_count);
+    image     = (unsigned char*)malloc(size);
+    ref       = (unsigned char*)malloc(size);
+    if (size == 0 || keys == NULL || w.keys == NULL || w.queries == NULL || w.sizes == NULL
+        || w.found == NULL || image == NULL || ref == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    /* key i: its index and a constant tail; keys g_count.. are never added */
+    for (i = 0; i < 2 * g_count; i++) {
+        uint64_t const id   = (uint64_t)i;
+        uint64_t const tail = 0x5A5A5A5A5A5A5A5AULL;
+        memcpy(keys + KEY_SIZE * i, &id, 8);
+        memcpy(keys + KEY_SIZE * i + 8, &tail, 8);
+        w.sizes[i] = KEY_SIZE;
+    }
+    for (i = 0; i < g_count; i++) {
+        w.keys[i]            = keys + KEY_SIZE * i;
+        w.queries[2 * i]     = keys + KEY_SIZE * i;
+        w.queries[2 * i + 1] = keys + KEY_SIZE * (g_count + i);
+    }
+
+    printf("%lu keys, %lu bits per key, best of %lu rounds, M keys/s\n\n",
+           (unsigned long)g_count, (unsigned long)g_bits, (unsigned long)g_rounds);
+    printf("%-10s %9s %9s %9s %9s %8s\n", "variant", "add", "add_n", "query", "query_n", "fpr");
+    {   double add, query;
+        size_t fp = 0;
+        run_khash(&w, &add, &query, &fp);
+        printf("%-10s %9.2f %9s %9.2f %9s %7.3f%%\n", "k-hash", add, "", query, "",
+               100.0 * (double)fp / (double)g_count);
+    }
+
+    for (i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+        xxh3_bloom_t f;
+        double       rate[4];
+        size_t       diff, j, fp = 0;
+
+        if (variants[i].add == NULL) {
+            continue;
+        }
+        if (!variant_supported(variants[i].add)) {
+            printf("%-10s: not supported on this CPU, skipping\n", variants[i].name);
+            continue;
+        }
+        f.nblocks = blocks;
+        f.seed    = 0;
+        diff = run_variant(&variants[i], &f, image, size, &w, rate);
+        for (j = 0; j < g_count; j++) {
+            if (!w.found[2 * j]) {
+                fprintf(stderr, "%s: added key %lu not found\n", variants[i].name, (unsigned long)j);
+                return 1;
+            }
+            fp += w.found[2 * j + 1];
+        }
+        if (i == 0) {
+            memcpy(ref, image, size);
+        }
+        if (diff != 0 || memcmp(image, ref, size) != 0) {
+            fprintf(stderr, "%s: filter differs from the scalar one\n", variants[i].name);
+            return 1;
+        }
+        printf("%-10s %9.2f %9.2f %9.2f %9.2f %7.3f%%\n", variants[i].name, rate[0], rate[1],
+               rate[2], rate[3], 100.0 * (double)fp / (double)g_count);
+    }
+
+    free(ref);
+    free(image);
+    free(w.found);
+    free(w.sizes);
+    free(w.queries);
+    free(w.keys);
+    free(keys);
+    return 0;
+}
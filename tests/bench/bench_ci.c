@@ -0,0 +1,282 @@
+/* Case-insensitive key benchmark for the xxh3_64_ci variants.
+ *
+ * Models header-name and hostname lookups: --count mixed-case ASCII keys of
+ * 4-60 bytes (or a fixed --len) hashed in order. Per variant it times
+ *   - xxh3_64_<variant>(): case-sensitive, for reference
+ *   - ASCII lowercase into a scratch buffer, then xxh3_64_<variant>()
+ *   - xxh3_64_ci_<variant>()
+ *   - xxh3_64_ci_batch_<variant>() over the whole table
+ * and reports million keys per second. The last three must agree on every
+ * hash.
+ *
+ * Command line (all optional):
+ *   --count=N   keys (default 100000)
+ *   --len=B     fixed key length in bytes (default: 4-60 bytes)
+ *   --rounds=N  passes over the table, the best one is reported (default 20)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime and sigsetjmp under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+
+#include "xxh3.h"
+
+typedef uint64_t (*hash_fn)(const void*, size_t, uint64_t);
+typedef void (*batch_fn)(const void* const*, const size_t*, size_t, uint64_t, uint64_t*);
+
+#define SEED 0x9E3779B97F4A7C15ULL
+
+static size_t g_count  = 100000;
+static size_t g_len    = 0;
+static size_t g_rounds = 20;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/* ------------------------------------------------------------------ table */
+
+typedef struct {
+    char*        text;
+    const void** key;
+    size_t*      len;
+    size_t       max_len;
+    uint64_t*    out;
+} table_t;
+
+static int table_init(table_t* t)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-.";
+    uint64_t rng = 0x0123456789ABCDEFULL;
+    size_t   cap = g_count * (g_len ? g_len : 60);
+    size_t   pos = 0;
+    size_t   i;
+
+    t->text    = (char*)malloc(cap);
+    t->key     = (const void**)malloc(g_count * sizeof(const void*));
+    t->len     = (size_t*)malloc(g_count * sizeof(size_t));
+    t->out     = (uint64_t*)malloc(g_count * sizeof(uint64_t));
+    t->max_len = 0;
+    if (t->text == NULL || t->key == NULL || t->len == NULL || t->out == NULL) {
+        free(t->text);
+        free(t->key);
+        free(t->len);
+        free(t->out);
+        return 0;
+    }
+    for (i = 0; i < g_count; i++) {
+        size_t len, l;
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+        len = g_len ? g_len : 4 + (size_t)(rng % 57);
+        t->key[i] = t->text + pos;
+        t->len[i] = len;
+        t->max_len = len > t->max_len ? len : t->max_len;
+        for (l = 0; l < len; l++) {
+            t->text[pos++] = alphabet[(rng >> (l % 58)) % (sizeof(alphabet) - 1)];
+        }
+    }
+    return 1;
+}
+
+/* ------------------------------------------------------------------ runs */
+
+static double run_single(hash_fn fn, const table_t* t, uint64_t* sum)
+{
+    double best = 1e30;
+    size_t r, i;
+
+    for (r = 0; r < g_rounds; r++) {
+        double const t0 = now_sec();
+        uint64_t     s  = 0;
+        for (i = 0; i < g_count; i++) {
+            s += fn(t->key[i], t->len[i], SEED);
+        }
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+        *sum = s;
+    }
+    return (double)g_count / best / 1e6;
+}
+
+static double run_lower(hash_fn fn, const table_t* t, unsigned char* scratch, uint64_t* sum)
+{
+    double best = 1e30;
+    size_t r, i, l;
+
+    for (r = 0; r < g_rounds; r++) {
+        double const t0 = now_sec();
+        uint64_t     s  = 0;
+        for (i = 0; i < g_count; i++) {
+            const unsigned char* const key = (const unsigned char*)t->key[i];
+            for (l = 0; l < t->len[i]; l++) {
+                unsigned char const c = key[l];
+                scratch[l] = (c >= 'A' && c <= 'Z') ? (unsigned char)(c + 32) : c;
+            }
+            s += fn(scratch, t->len[i], SEED);
+        }
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+        *sum = s;
+    }
+    return (double)g_count / best / 1e6;
+}
+
+static double run_batch(batch_fn fn, const table_t* t, uint64_t* sum)
+{
+    double best = 1e30;
+    size_t r, i;
+
+    for (r = 0; r < g_rounds; r++) {
+        double const t0 = now_sec();
+        uint64_t     s  = 0;
+        fn(t->key, t->len, g_count, SEED, t->out);
+        for (i = 0; i < g_count; i++) {
+            s += t->out[i];
+        }
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+        *sum = s;
+    }
+    return (double)g_count / best / 1e6;
+}
+
+/* Probe a variant under a SIGILL/SIGSEGV guard before timing it */
+static sigjmp_buf _bench_jmpbuf;
+static volatile sig_atomic_t _bench_caught_sig;
+
+static void _bench_sig_handler(int sig)
+{
+    _bench_caught_sig = sig;
+    siglongjmp(_bench_jmpbuf, 1);
+}
+
+static int variant_supported(hash_fn fn)
+{
+    static const char probe[300] = "Probe";
+    struct sigaction act, oldill, oldsegv;
+    volatile int ok = 0;
+
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = _bench_sig_handler;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGILL,  &act, &oldill);
+    sigaction(SIGSEGV, &act, &oldsegv);
+    if (sigsetjmp(_bench_jmpbuf, 1) == 0) {
+        (void)fn(probe, sizeof(probe), SEED);
+        ok = 1;
+    }
+    sigaction(SIGILL,  &oldill,  NULL);
+    sigaction(SIGSEGV, &oldsegv, NULL);
+    return ok;
+}
+
+/* See bench_variants.c: only reference variants that can exist here */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define X86_FN(fn) fn
+#else
+#  define X86_FN(fn) NULL
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define ARM_FN(fn) fn
+#else
+#  define ARM_FN(fn) NULL
+#endif
+
+static int parse_count(const char* str, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || v == 0) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const struct { const char* name; hash_fn fn; hash_fn ci; batch_fn batch; } variants[] = {
+        { "scalar", xxh3_64_scalar,         xxh3_64_ci_scalar,         xxh3_64_ci_batch_scalar },
+        { "sse2",   X86_FN(xxh3_64_sse2),   X86_FN(xxh3_64_ci_sse2),   X86_FN(xxh3_64_ci_batch_sse2) },
+        { "avx2",   X86_FN(xxh3_64_avx2),   X86_FN(xxh3_64_ci_avx2),   X86_FN(xxh3_64_ci_batch_avx2) },
+        { "avx512", X86_FN(xxh3_64_avx512), X86_FN(xxh3_64_ci_avx512), X86_FN(xxh3_64_ci_batch_avx512) },
+        { "neon",   ARM_FN(xxh3_64_neon),   ARM_FN(xxh3_64_ci_neon),   ARM_FN(xxh3_64_ci_batch_neon) },
+        { "sve",    ARM_FN(xxh3_64_sve),    ARM_FN(xxh3_64_ci_sve),    ARM_FN(xxh3_64_ci_batch_sve) },
+    };
+    table_t        table;
+    unsigned char* scratch;
+    size_t         i;
+    int            a;
+
+    for (a = 1; a < argc; a++) {
+        int ok;
+        if (strncmp(argv[a], "--count=", 8) == 0) {
+            ok = parse_count(argv[a] + 8, &g_count);
+        } else if (strncmp(argv[a], "--len=", 6) == 0) {
+            ok = parse_count(argv[a] + 6, &g_len);
+        } else if (strncmp(argv[a], "--rounds=", 9) == 0) {
+            ok = parse_count(argv[a] + 9, &g_rounds);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--count=N] [--len=B] [--rounds=N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!table_init(&table) || (scratch = (unsigned char*)malloc(table.max_len)) == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+
+    if (g_len) {
+        printf("%lu keys of %lu bytes, best of %lu rounds, M keys/s\n\n",
+               (unsigned long)g_count, (unsigned long)g_len, (unsigned long)g_rounds);
+    } else {
+        printf("%lu keys of 4-60 bytes, best of %lu rounds, M keys/s\n\n",
+               (unsigned long)g_count, (unsigned long)g_rounds);
+    }
+    printf("%-10s %10s %12s %10s %10s\n", "variant", "hash", "lower+hash", "ci", "ci_batch");
+
+    for (i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+        double   plain, lowered, ci, batch;
+        uint64_t sum_plain = 0, sum_lower = 0, sum_ci = 0, sum_batch = 0;
+        if (variants[i].ci == NULL) {
+            continue;
+        }
+        if (!variant_supported(variants[i].ci)) {
+            printf("%-10s: not supported on this CPU, skipping\n", variants[i].name);
+            continue;
+        }
+        plain   = run_single(variants[i].fn, &table, &sum_plain);
+        lowered = run_lower(variants[i].fn, &table, scratch, &sum_lower);
+        ci      = run_single(variants[i].ci, &table, &sum_ci);
+        batch   = run_batch(variants[i].batch, &table, &sum_batch);
+        if (sum_ci != sum_lower || sum_batch != sum_lower) {
+            fprintf(stderr, "%s: ci hashes differ from lowercase + hash\n", variants[i].name);
+            return 1;
+        }
+        printf("%-10s %10.2f %12.2f %10.2f %10.2f\n", variants[i].name, plain, lowered, ci, batch);
+    }
+
+    free(scratch);
+    free(table.text);
+    free(table.key);
+    free(table.len);
+    free(table.out);
+    return 0;
+}
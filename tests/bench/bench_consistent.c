@@ -0,0 +1,308 @@
+/* Consistent hashing benchmark.
+ *
+ * Ranks --keys keys of --size bytes against each --nodes node count and
+ * keeps the best --top nodes, in nanoseconds per (key, node) pair. The
+ * "per pair" row is rendezvous hashing without batching: one
+ * xxh3_64_scalar() per pair, the weighted score -ln(u) / w computed for
+ * every node, and the same top-N insertion. The other rows time
+ * xxh3_rendezvous_<variant>() without weights ("equal") and with weights
+ * 1 to 4 ("weighted"); both must rank as the per-pair loop does. The last
+ * column is xxh3_jump_batch_<variant>() over the same keys into as many
+ * buckets as nodes, in nanoseconds per key.
+ *
+ * Command line (all optional):
+ *   --keys=N    keys (default 100000)
+ *   --size=N    bytes per key (default 16)
+ *   --nodes=N   node count, repeatable (default 50 and 500)
+ *   --top=N     nodes ranked per key (default 3)
+ *   --rounds=N  passes, the best one is reported (default 3)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime and sigsetjmp under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+
+#include "xxh3.h"
+
+typedef size_t (*rendezvous_batch_fn)(const void* const*, const size_t*, size_t, const uint64_t*,
+                                      const double*, size_t, size_t*, size_t);
+typedef void (*jump_batch_fn)(const void* const*, const size_t*, size_t, uint64_t, uint32_t,
+                              uint32_t*);
+
+static size_t g_keys   = 100000;
+static size_t g_size   = 16;
+static size_t g_top    = 3;
+static size_t g_rounds = 3;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+typedef struct {
+    const void**    ptrs;
+    size_t*         sizes;
+    uint64_t*       seeds;     /* per node */
+    double*         weights;   /* per node */
+    size_t*         ref[2];    /* g_keys * g_top: equal, weighted */
+    size_t*         top;
+    uint32_t*       buckets;   /* g_keys */
+} workload;
+
+/* Inserts `node` into the ascending top[0..*m) by score, keeping g_top */
+static void insert(double* score, size_t* top, size_t* m, double s, size_t node)
+{
+    size_t i = *m;
+    if (i == g_top) {
+        if (s >= score[i - 1]) {
+            return;
+        }
+        i--;
+    } else {
+        (*m)++;
+    }
+    for (; i > 0 && s < score[i - 1]; i--) {
+        score[i] = score[i - 1];
+        top[i]   = top[i - 1];
+    }
+    score[i] = s;
+    top[i]   = node;
+}
+
+/* ns per pair of the per-pair loop; fills w->ref[weighted] */
+static double run_per_pair(const workload* w, size_t nodes, int weighted)
+{
+    double best = 0;
+    size_t r, i, j;
+
+    for (r = 0; r < g_rounds; r++) {
+        double t = now_sec();
+        for (i = 0; i < g_keys; i++) {
+            double score[64];
+            size_t m = 0;
+            for (j = 0; j < nodes; j++) {
+                uint64_t const h = xxh3_64_scalar(w->ptrs[i], g_size, w->seeds[j]);
+                double const   u = ((double)(h >> 12) + 0.5) * 0x1p-52;
+                /* without weights the highest hash wins: rank by -u */
+                insert(score, w->ref[weighted] + i * g_top, &m,
+                       weighted ? -log(u) / w->weights[j] : -u, j);
+            }
+        }
+        t = now_sec() - t;
+        best = (r == 0 || t < best) ? t : best;
+    }
+    return best / (double)(g_keys * nodes) * 1e9;
+}
+
+typedef struct {
+    const char*         name;
+    rendezvous_batch_fn rendezvous;
+    jump_batch_fn       jump;
+} variant_t;
+
+/* rate[0] equal and rate[1] weighted in ns per pair, rate[2] jump in ns
+ * per key; returns 0 if a ranking differs from the per-pair one */
+static int run_variant(const variant_t* v, const workload* w, size_t nodes, double rate[3])
+{
+    size_t f, r;
+    int    ok = 1;
+
+    for (f = 0; f < 3; f++) {
+        double best = 0;
+        for (r = 0; r < g_rounds; r++) {
+            double t = now_sec();
+            if (f < 2) {
+                (void)v->rendezvous((const void* const*)w->ptrs, w->sizes, g_keys, w->seeds,
+                                    f == 1 ? w->weights : NULL, nodes, w->top, g_top);
+            } else {
+                v->jump((const void* const*)w->ptrs, w->sizes, g_keys, 0, (uint32_t)nodes,
+                        w->buckets);
+            }
+            t = now_sec() - t;
+            best = (r == 0 || t < best) ? t : best;
+        }
+        if (f < 2) {
+            ok &= memcmp(w->top, w->ref[f], g_keys * g_top * sizeof(size_t)) == 0;
+            rate[f] = best / (double)(g_keys * nodes) * 1e9;
+        } else {
+            rate[f] = best / (double)g_keys * 1e9;
+        }
+    }
+    return ok;
+}
+
+/* Probe a variant under a SIGILL/SIGSEGV guard before timing it */
+static sigjmp_buf _bench_jmpbuf;
+static volatile sig_atomic_t _bench_caught_sig;
+
+static void _bench_sig_handler(int sig)
+{
+    _bench_caught_sig = sig;
+    siglongjmp(_bench_jmpbuf, 1);
+}
+
+static int variant_supported(rendezvous_batch_fn fn)
+{
+    static const uint64_t seeds[16] = { 0 };
+    const void*           key       = "probe key of 17 b";
+    size_t                size      = 17;
+    size_t                top[1];
+    struct sigaction      act, oldill, oldsegv;
+    volatile int          ok = 0;
+
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = _bench_sig_handler;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGILL,  &act, &oldill);
+    sigaction(SIGSEGV, &act, &oldsegv);
+    if (sigsetjmp(_bench_jmpbuf, 1) == 0) {
+        ok = fn(&key, &size, 1, seeds, NULL, 16, top, 1) == 1;
+    }
+    sigaction(SIGILL,  &oldill,  NULL);
+    sigaction(SIGSEGV, &oldsegv, NULL);
+    return ok;
+}
+
+/* See bench_variants.c: only reference variants that can exist here */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define X86_FN(fn) fn
+#else
+#  define X86_FN(fn) NULL
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define ARM_FN(fn) fn
+#else
+#  define ARM_FN(fn) NULL
+#endif
+
+#define VARIANT(v, ISA_FN) { #v, ISA_FN(xxh3_rendezvous_batch_##v), ISA_FN(xxh3_jump_batch_##v) }
+#define SCALAR_FN(fn) fn
+
+static int parse_count(const char* str, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || v == 0) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const variant_t variants[] = {
+        VARIANT(scalar, SCALAR_FN), VARIANT(sse2, X86_FN), VARIANT(avx2, X86_FN),
+        VARIANT(avx512, X86_FN),    VARIANT(neon, ARM_FN), VARIANT(sve, ARM_FN),
+    };
+    size_t         node_counts[16] = { 50, 500 };
+    size_t         n_counts = 2, max_nodes = 0, c, i;
+    int            nodes_given = 0;
+    unsigned char* keys;
+    workload       w;
+    int            arg;
+
+    for (arg = 1; arg < argc; arg++) {
+        int ok;
+        if (strncmp(argv[arg], "--keys=", 7) == 0) {
+            ok = parse_count(argv[arg] + 7, &g_keys);
+        } else if (strncmp(argv[arg], "--size=", 7) == 0) {
+            ok = parse_count(argv[arg] + 7, &g_size);
+        } else if (strncmp(argv[arg], "--nodes=", 8) == 0) {
+            n_counts = nodes_given ? n_counts : 0;
+            ok = n_counts < 16 && parse_count(argv[arg] + 8, &node_counts[n_counts]);
+            n_counts += ok ? 1 : 0;
+            nodes_given = 1;
+        } else if (strncmp(argv[arg], "--top=", 6) == 0) {
+            ok = parse_count(argv[arg] + 6, &g_top) && g_top <= 64;
+        } else if (strncmp(argv[arg], "--rounds=", 9) == 0) {
+            ok = parse_count(argv[arg] + 9, &g_rounds);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--keys=N] [--size=N] [--nodes=N]... [--top=N] [--rounds=N]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    for (c = 0; c < n_counts; c++) {
+        max_nodes = (node_counts[c] > max_nodes) ? node_counts[c] : max_nodes;
+        g_top     = (g_top < node_counts[c]) ? g_top : node_counts[c];
+    }
+    keys      = (unsigned char*)malloc(g_keys * g_size);
+    w.ptrs    = (const void**)malloc(g_keys * sizeof(void*));
+    w.sizes   = (size_t*)malloc(g_keys * sizeof(size_t));
+    w.seeds   = (uint64_t*)malloc(max_nodes * sizeof(uint64_t));
+    w.weights = (double*)malloc(max_nodes * sizeof(double));
+    w.ref[0]  = (size_t*)malloc(g_keys * g_top * sizeof(size_t));
+    w.ref[1]  = (size_t*)malloc(g_keys * g_top * sizeof(size_t));
+    w.top     = (size_t*)malloc(g_keys * g_top * sizeof(size_t));
+    w.buckets = (uint32_t*)malloc(g_keys * sizeof(uint32_t));
+    if (keys == NULL || w.ptrs == NULL || w.sizes == NULL || w.seeds == NULL || w.weights == NULL
+        || w.ref[0] == NULL || w.ref[1] == NULL || w.top == NULL || w.buckets == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    for (i = 0; i < g_keys * g_size; i++) {
+        keys[i] = (unsigned char)(i * 2654435761U >> 24);
+    }
+    for (i = 0; i < g_keys; i++) {
+        w.ptrs[i]  = keys + i * g_size;
+        w.sizes[i] = g_size;
+    }
+    for (i = 0; i < max_nodes; i++) {
+        w.seeds[i]   = xxh3_64_scalar(&i, sizeof(i), 0);
+        w.weights[i] = (double)(1 + i % 4);
+    }
+
+    printf("%lu keys of %lu bytes, top %lu nodes, best of %lu rounds\n", (unsigned long)g_keys,
+           (unsigned long)g_size, (unsigned long)g_top, (unsigned long)g_rounds);
+    for (c = 0; c < n_counts; c++) {
+        size_t const nodes = node_counts[c];
+        double       pp[2];
+
+        pp[0] = run_per_pair(&w, nodes, 0);
+        pp[1] = run_per_pair(&w, nodes, 1);
+        printf("\n%lu nodes\n", (unsigned long)nodes);
+        printf("%-10s %15s %15s %15s\n", "variant", "equal (ns/node)", "weighted", "jump (ns/key)");
+        printf("%-10s %15.2f %15.2f %15s\n", "per pair", pp[0], pp[1], "-");
+        for (i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+            double rate[3];
+            if (variants[i].rendezvous == NULL) {
+                continue;
+            }
+            if (!variant_supported(variants[i].rendezvous)) {
+                printf("%-10s: not supported on this CPU, skipping\n", variants[i].name);
+                continue;
+            }
+            if (!run_variant(&variants[i], &w, nodes, rate)) {
+                fprintf(stderr, "%s: ranking differs from the per-pair one\n", variants[i].name);
+                return 1;
+            }
+            printf("%-10s %15.2f %15.2f %15.2f\n", variants[i].name, rate[0], rate[1], rate[2]);
+        }
+    }
+
+    free(w.buckets);
+    free(w.top);
+    free(w.ref[1]);
+    free(w.ref[0]);
+    free(w.weights);
+    free(w.seeds);
+    free(w.sizes);
+    free(w.ptrs);
+    free(keys);
+    return 0;
+}
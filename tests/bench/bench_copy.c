@@ -0,0 +1,240 @@
+/* Copy-and-hash benchmark for the fused copy kernels.
+ *
+ * Models a receive path that moves a buffer out of a ring and checksums it.
+ * Source and destination are --size bytes each (default 256 MiB, larger than
+ * the LLC), so every pass streams both through memory. Per variant it times
+ *   - memcpy(): the copy alone, for reference
+ *   - memcpy() followed by xxh3_64_<variant>()
+ *   - xxh3_64_copy_<variant>()
+ *   - xxh3_64_copy_nt_<variant>()
+ * and reports source bytes per second (GB/s). The fused forms must produce
+ * the same hash and the same destination bytes as the separate calls.
+ *
+ * Command line (all optional):
+ *   --size=B    buffer size in bytes (default 268435456)
+ *   --passes=N  passes per measurement, the best one is reported (default 5)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime, posix_memalign and sigsetjmp under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+
+#include "xxh3.h"
+
+typedef uint64_t (*hash_fn)(const void*, size_t, uint64_t);
+typedef uint64_t (*copy_fn)(void*, const void*, size_t, uint64_t);
+
+#define SEED 0x9E3779B97F4A7C15ULL
+
+static size_t g_size   = (size_t)256 << 20;
+static size_t g_passes = 5;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+static double gbps(double sec)
+{
+    return (double)g_size / sec / 1e9;
+}
+
+/* ------------------------------------------------------------------ runs */
+
+static double run_memcpy(unsigned char* dst, const unsigned char* src)
+{
+    double best = 1e30;
+    size_t p;
+
+    for (p = 0; p < g_passes; p++) {
+        double const t0 = now_sec();
+        memcpy(dst, src, g_size);
+        {   double const t = now_sec() - t0;
+            best = t < best ? t : best;
+        }
+    }
+    return gbps(best);
+}
+
+static double run_separate(hash_fn fn, unsigned char* dst, const unsigned char* src, uint64_t* h)
+{
+    double best = 1e30;
+    size_t p;
+
+    for (p = 0; p < g_passes; p++) {
+        double const t0 = now_sec();
+        memcpy(dst, src, g_size);
+        *h = fn(dst, g_size, SEED);
+        {   double const t = now_sec() - t0;
+            best = t < best ? t : best;
+        }
+    }
+    return gbps(best);
+}
+
+static double run_fused(copy_fn fn, unsigned char* dst, const unsigned char* src, uint64_t* h)
+{
+    double best = 1e30;
+    size_t p;
+
+    for (p = 0; p < g_passes; p++) {
+        double const t0 = now_sec();
+        *h = fn(dst, src, g_size, SEED);
+        {   double const t = now_sec() - t0;
+            best = t < best ? t : best;
+        }
+    }
+    return gbps(best);
+}
+
+/* Probe a variant under a SIGILL/SIGSEGV guard before timing it */
+static sigjmp_buf _bench_jmpbuf;
+static volatile sig_atomic_t _bench_caught_sig;
+
+static void _bench_sig_handler(int sig)
+{
+    _bench_caught_sig = sig;
+    siglongjmp(_bench_jmpbuf, 1);
+}
+
+static int variant_supported(copy_fn fn)
+{
+    static unsigned char probe[2048];
+    static unsigned char out[2048];
+    struct sigaction act, oldill, oldsegv;
+    volatile int ok = 0;
+
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = _bench_sig_handler;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGILL,  &act, &oldill);
+    sigaction(SIGSEGV, &act, &oldsegv);
+    if (sigsetjmp(_bench_jmpbuf, 1) == 0) {
+        (void)fn(out, probe, sizeof(probe), SEED);
+        ok = 1;
+    }
+    sigaction(SIGILL,  &oldill,  NULL);
+    sigaction(SIGSEGV, &oldsegv, NULL);
+    return ok;
+}
+
+/* See bench_variants.c: only reference variants that can exist here */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define X86_FN(fn) fn
+#else
+#  define X86_FN(fn) NULL
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define ARM_FN(fn) fn
+#else
+#  define ARM_FN(fn) NULL
+#endif
+
+static int parse_count(const char* str, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || v == 0) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const struct { const char* name; hash_fn fn; copy_fn copy; copy_fn copy_nt; } variants[] = {
+        { "scalar", xxh3_64_scalar,         xxh3_64_copy_scalar,         xxh3_64_copy_nt_scalar },
+        { "sse2",   X86_FN(xxh3_64_sse2),   X86_FN(xxh3_64_copy_sse2),   X86_FN(xxh3_64_copy_nt_sse2) },
+        { "avx2",   X86_FN(xxh3_64_avx2),   X86_FN(xxh3_64_copy_avx2),   X86_FN(xxh3_64_copy_nt_avx2) },
+        { "avx512", X86_FN(xxh3_64_avx512), X86_FN(xxh3_64_copy_avx512), X86_FN(xxh3_64_copy_nt_avx512) },
+        { "neon",   ARM_FN(xxh3_64_neon),   ARM_FN(xxh3_64_copy_neon),   ARM_FN(xxh3_64_copy_nt_neon) },
+        { "sve",    ARM_FN(xxh3_64_sve),    ARM_FN(xxh3_64_copy_sve),    ARM_FN(xxh3_64_copy_nt_sve) },
+    };
+    void*          src_mem = NULL;
+    void*          dst_mem = NULL;
+    unsigned char* src;
+    unsigned char* dst;
+    unsigned char* ref;
+    size_t         i;
+    int            a;
+
+    for (a = 1; a < argc; a++) {
+        int ok;
+        if (strncmp(argv[a], "--size=", 7) == 0) {
+            ok = parse_count(argv[a] + 7, &g_size);
+        } else if (strncmp(argv[a], "--passes=", 9) == 0) {
+            ok = parse_count(argv[a] + 9, &g_passes);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--size=B] [--passes=N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    /* 64-byte aligned destination so that the _nt forms stream whole lines */
+    if (posix_memalign(&src_mem, 64, g_size) != 0 || posix_memalign(&dst_mem, 64, g_size) != 0
+        || (ref = (unsigned char*)malloc(g_size)) == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    src = (unsigned char*)src_mem;
+    dst = (unsigned char*)dst_mem;
+    for (i = 0; i < g_size; i++) {
+        src[i] = (unsigned char)(i * 2654435761u >> 24);
+    }
+    memset(dst, 0, g_size);
+    memcpy(ref, src, g_size);
+
+    printf("%lu MiB buffers, best of %lu passes, GB/s of source\n\n",
+           (unsigned long)(g_size >> 20), (unsigned long)g_passes);
+    printf("%-10s %10s %10s %10s %10s\n", "variant", "memcpy", "cpy+hash", "copy", "copy_nt");
+
+    for (i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+        double mc, sep, fused, fused_nt;
+        uint64_t h_sep = 0, h_fused = 0, h_nt = 0;
+        if (variants[i].copy == NULL) {
+            continue;
+        }
+        if (!variant_supported(variants[i].copy)) {
+            printf("%-10s: not supported on this CPU, skipping\n", variants[i].name);
+            continue;
+        }
+        mc  = run_memcpy(dst, src);
+        sep = run_separate(variants[i].fn, dst, src, &h_sep);
+        memset(dst, 0, g_size);
+        fused = run_fused(variants[i].copy, dst, src, &h_fused);
+        if (memcmp(dst, ref, g_size) != 0) {
+            fprintf(stderr, "%s: copy differs from the source\n", variants[i].name);
+            return 1;
+        }
+        memset(dst, 0, g_size);
+        fused_nt = run_fused(variants[i].copy_nt, dst, src, &h_nt);
+        if (memcmp(dst, ref, g_size) != 0) {
+            fprintf(stderr, "%s: non-temporal copy differs from the source\n", variants[i].name);
+            return 1;
+        }
+        if (h_fused != h_sep || h_nt != h_sep) {
+            fprintf(stderr, "%s: fused hash differs from memcpy + hash\n", variants[i].name);
+            return 1;
+        }
+        printf("%-10s %10.2f %10.2f %10.2f %10.2f\n", variants[i].name, mc, sep, fused, fused_nt);
+    }
+
+    free(src_mem);
+    free(dst_mem);
+    free(ref);
+    return 0;
+}
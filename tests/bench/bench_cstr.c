@@ -0,0 +1,238 @@
+/* C-string key benchmark for the fused strlen-and-hash variants.
+ *
+ * Models a symbol table: --count NUL-terminated names of 4-60 bytes (or a
+ * fixed --len) packed back to back, as in a string table, and hashed in
+ * order. Per variant it times
+ *   - strlen() followed by xxh3_64_<variant>()
+ *   - xxh3_64_cstr_<variant>()
+ * and reports million strings per second. Both must agree on every hash.
+ *
+ * Command line (all optional):
+ *   --count=N   strings (default 100000)
+ *   --len=B     fixed string length in bytes (default: 4-60 bytes)
+ *   --rounds=N  passes over the table, the best one is reported (default 20)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime and sigsetjmp under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+
+#include "xxh3.h"
+
+typedef uint64_t (*hash_fn)(const void*, size_t, uint64_t);
+typedef uint64_t (*cstr_fn)(const char*, size_t*, uint64_t);
+
+#define SEED 0x9E3779B97F4A7C15ULL
+
+static size_t g_count  = 100000;
+static size_t g_len    = 0;
+static size_t g_rounds = 20;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/* ------------------------------------------------------------------ table */
+
+typedef struct {
+    char*        text;
+    const char** str;
+} table_t;
+
+static int table_init(table_t* t)
+{
+    uint64_t rng = 0x0123456789ABCDEFULL;
+    size_t   cap = g_count * ((g_len ? g_len : 60) + 1);
+    size_t   pos = 0;
+    size_t   i;
+
+    t->text = (char*)malloc(cap);
+    t->str  = (const char**)malloc(g_count * sizeof(const char*));
+    if (t->text == NULL || t->str == NULL) {
+        free(t->text);
+        free(t->str);
+        return 0;
+    }
+    for (i = 0; i < g_count; i++) {
+        size_t len, l;
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+        len = g_len ? g_len : 4 + (size_t)(rng % 57);
+        t->str[i] = t->text + pos;
+        for (l = 0; l < len; l++) {
+            t->text[pos++] = (char)('_' + (rng >> (l % 58)) % 28);
+        }
+        t->text[pos++] = '\0';
+    }
+    return 1;
+}
+
+/* ------------------------------------------------------------------ runs */
+
+static double run_strlen(hash_fn fn, const table_t* t, uint64_t* sum)
+{
+    double best = 1e30;
+    size_t r, i;
+
+    for (r = 0; r < g_rounds; r++) {
+        double const t0 = now_sec();
+        uint64_t     s  = 0;
+        for (i = 0; i < g_count; i++) {
+            s += fn(t->str[i], strlen(t->str[i]), SEED);
+        }
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+        *sum = s;
+    }
+    return (double)g_count / best / 1e6;
+}
+
+static double run_cstr(cstr_fn fn, const table_t* t, uint64_t* sum)
+{
+    double best = 1e30;
+    size_t r, i;
+
+    for (r = 0; r < g_rounds; r++) {
+        double const t0 = now_sec();
+        uint64_t     s  = 0;
+        for (i = 0; i < g_count; i++) {
+            s += fn(t->str[i], NULL, SEED);
+        }
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+        *sum = s;
+    }
+    return (double)g_count / best / 1e6;
+}
+
+/* Probe a variant under a SIGILL/SIGSEGV guard before timing it */
+static sigjmp_buf _bench_jmpbuf;
+static volatile sig_atomic_t _bench_caught_sig;
+
+static void _bench_sig_handler(int sig)
+{
+    _bench_caught_sig = sig;
+    siglongjmp(_bench_jmpbuf, 1);
+}
+
+static int variant_supported(cstr_fn fn)
+{
+    struct sigaction act, oldill, oldsegv;
+    volatile int ok = 0;
+
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = _bench_sig_handler;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGILL,  &act, &oldill);
+    sigaction(SIGSEGV, &act, &oldsegv);
+    if (sigsetjmp(_bench_jmpbuf, 1) == 0) {
+        (void)fn("probe", NULL, SEED);
+        ok = 1;
+    }
+    sigaction(SIGILL,  &oldill,  NULL);
+    sigaction(SIGSEGV, &oldsegv, NULL);
+    return ok;
+}
+
+/* See bench_variants.c: only reference variants that can exist here */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define X86_FN(fn) fn
+#else
+#  define X86_FN(fn) NULL
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define ARM_FN(fn) fn
+#else
+#  define ARM_FN(fn) NULL
+#endif
+
+static int parse_count(const char* str, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || v == 0) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const struct { const char* name; hash_fn fn; cstr_fn cstr; } variants[] = {
+        { "scalar", xxh3_64_scalar,         xxh3_64_cstr_scalar },
+        { "sse2",   X86_FN(xxh3_64_sse2),   X86_FN(xxh3_64_cstr_sse2) },
+        { "avx2",   X86_FN(xxh3_64_avx2),   X86_FN(xxh3_64_cstr_avx2) },
+        { "avx512", X86_FN(xxh3_64_avx512), X86_FN(xxh3_64_cstr_avx512) },
+        { "neon",   ARM_FN(xxh3_64_neon),   ARM_FN(xxh3_64_cstr_neon) },
+        { "sve",    ARM_FN(xxh3_64_sve),    ARM_FN(xxh3_64_cstr_sve) },
+    };
+    table_t table;
+    size_t  i;
+    int     a;
+
+    for (a = 1; a < argc; a++) {
+        int ok;
+        if (strncmp(argv[a], "--count=", 8) == 0) {
+            ok = parse_count(argv[a] + 8, &g_count);
+        } else if (strncmp(argv[a], "--len=", 6) == 0) {
+            ok = parse_count(argv[a] + 6, &g_len);
+        } else if (strncmp(argv[a], "--rounds=", 9) == 0) {
+            ok = parse_count(argv[a] + 9, &g_rounds);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--count=N] [--len=B] [--rounds=N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!table_init(&table)) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+
+    if (g_len) {
+        printf("%lu strings of %lu bytes, best of %lu rounds\n\n",
+               (unsigned long)g_count, (unsigned long)g_len, (unsigned long)g_rounds);
+    } else {
+        printf("%lu strings of 4-60 bytes, best of %lu rounds\n\n",
+               (unsigned long)g_count, (unsigned long)g_rounds);
+    }
+    printf("%-10s %16s %16s %8s\n", "variant", "strlen+hash M/s", "cstr M/s", "speedup");
+
+    for (i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+        double   sized, fused;
+        uint64_t sum_sized = 0, sum_fused = 0;
+        if (variants[i].cstr == NULL) {
+            continue;
+        }
+        if (!variant_supported(variants[i].cstr)) {
+            printf("%-10s: not supported on this CPU, skipping\n", variants[i].name);
+            continue;
+        }
+        sized = run_strlen(variants[i].fn, &table, &sum_sized);
+        fused = run_cstr(variants[i].cstr, &table, &sum_fused);
+        if (sum_sized != sum_fused) {
+            fprintf(stderr, "%s: cstr hashes differ from strlen + hash\n", variants[i].name);
+            return 1;
+        }
+        printf("%-10s %16.2f %16.2f %7.2fx\n", variants[i].name, sized, fused, fused / sized);
+    }
+
+    free(table.text);
+    free(table.str);
+    return 0;
+}
@@ -0,0 +1,265 @@
+/* Strided and field-gather benchmark for the xxh3_64_strided2d and
+ * xxh3_64_gather variants.
+ *
+ * Two inputs, each hashed two ways per variant:
+ *   - tile: a 256 x 256 RGBA tile (1 KiB rows) inside a 1920-pixel-wide
+ *     framebuffer, i.e. rows 7680 bytes apart
+ *   - aos:  --count records of 64 bytes, of which three fields (8 + 8 + 4
+ *     bytes at offsets 0, 16 and 32) are hashed
+ * "copy+hash" gathers the bytes into a scratch buffer and calls
+ * xxh3_64_<variant>(); "direct" calls xxh3_64_strided2d_<variant>() or
+ * xxh3_64_gather_<variant>(). Reports GB/s of hashed (gathered) bytes. Both
+ * ways must agree.
+ *
+ * Command line (all optional):
+ *   --count=N   records in the aos input (default 100000)
+ *   --rounds=N  repetitions, the best one is reported (default 50)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime and sigsetjmp under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+
+#include "xxh3.h"
+
+typedef uint64_t (*hash_fn)(const void*, size_t, uint64_t);
+typedef uint64_t (*strided2d_fn)(const void*, size_t, size_t, size_t, uint64_t);
+typedef uint64_t (*gather_fn)(const void*, size_t, size_t, const xxh3_field_t*, size_t, uint64_t);
+
+#define SEED 0x9E3779B97F4A7C15ULL
+
+#define TILE_ROW_BYTES (256 * 4)
+#define TILE_ROWS      256
+#define TILE_PITCH     (1920 * 4)
+#define RECORD_SIZE    64
+
+static const xxh3_field_t k_fields[] = { { 0, 8 }, { 16, 8 }, { 32, 4 } };
+#define NFIELDS  (sizeof(k_fields) / sizeof(k_fields[0]))
+#define REC_LEN  20
+
+static size_t g_count  = 100000;
+static size_t g_rounds = 50;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/* ------------------------------------------------------------------ runs */
+
+static double run_tile_copy(hash_fn fn, const unsigned char* fb, unsigned char* scratch,
+                            uint64_t* h)
+{
+    double best = 1e30;
+    size_t r, y;
+
+    for (r = 0; r < g_rounds; r++) {
+        double const t0 = now_sec();
+        for (y = 0; y < TILE_ROWS; y++) {
+            memcpy(scratch + y * TILE_ROW_BYTES, fb + y * TILE_PITCH, TILE_ROW_BYTES);
+        }
+        *h = fn(scratch, (size_t)TILE_ROWS * TILE_ROW_BYTES, SEED);
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+    }
+    return (double)TILE_ROWS * TILE_ROW_BYTES / best / 1e9;
+}
+
+static double run_tile_direct(strided2d_fn fn, const unsigned char* fb, uint64_t* h)
+{
+    double best = 1e30;
+    size_t r;
+
+    for (r = 0; r < g_rounds; r++) {
+        double const t0 = now_sec();
+        *h = fn(fb, TILE_ROW_BYTES, TILE_ROWS, TILE_PITCH, SEED);
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+    }
+    return (double)TILE_ROWS * TILE_ROW_BYTES / best / 1e9;
+}
+
+static double run_aos_copy(hash_fn fn, const unsigned char* recs, unsigned char* scratch,
+                           uint64_t* h)
+{
+    double best = 1e30;
+    size_t r, i;
+
+    for (r = 0; r < g_rounds; r++) {
+        double const t0 = now_sec();
+        unsigned char* out = scratch;
+        for (i = 0; i < g_count; i++) {
+            const unsigned char* const rec = recs + i * RECORD_SIZE;
+            memcpy(out,      rec + 0,  8);
+            memcpy(out + 8,  rec + 16, 8);
+            memcpy(out + 16, rec + 32, 4);
+            out += REC_LEN;
+        }
+        *h = fn(scratch, g_count * REC_LEN, SEED);
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+    }
+    return (double)g_count * REC_LEN / best / 1e9;
+}
+
+static double run_aos_direct(gather_fn fn, const unsigned char* recs, uint64_t* h)
+{
+    double best = 1e30;
+    size_t r;
+
+    for (r = 0; r < g_rounds; r++) {
+        double const t0 = now_sec();
+        *h = fn(recs, RECORD_SIZE, g_count, k_fields, NFIELDS, SEED);
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+    }
+    return (double)g_count * REC_LEN / best / 1e9;
+}
+
+/* Probe a variant under a SIGILL/SIGSEGV guard before timing it */
+static sigjmp_buf _bench_jmpbuf;
+static volatile sig_atomic_t _bench_caught_sig;
+
+static void _bench_sig_handler(int sig)
+{
+    _bench_caught_sig = sig;
+    siglongjmp(_bench_jmpbuf, 1);
+}
+
+static int variant_supported(strided2d_fn fn)
+{
+    static const char probe[300] = "Probe";
+    struct sigaction act, oldill, oldsegv;
+    volatile int ok = 0;
+
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = _bench_sig_handler;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGILL,  &act, &oldill);
+    sigaction(SIGSEGV, &act, &oldsegv);
+    if (sigsetjmp(_bench_jmpbuf, 1) == 0) {
+        (void)fn(probe, 100, 3, 100, SEED);
+        ok = 1;
+    }
+    sigaction(SIGILL,  &oldill,  NULL);
+    sigaction(SIGSEGV, &oldsegv, NULL);
+    return ok;
+}
+
+/* See bench_variants.c: only reference variants that can exist here */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define X86_FN(fn) fn
+#else
+#  define X86_FN(fn) NULL
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define ARM_FN(fn) fn
+#else
+#  define ARM_FN(fn) NULL
+#endif
+
+static int parse_count(const char* str, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || v == 0) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const struct {
+        const char* name; hash_fn fn; strided2d_fn strided; gather_fn gather;
+    } variants[] = {
+        { "scalar", xxh3_64_scalar,         xxh3_64_strided2d_scalar,         xxh3_64_gather_scalar },
+        { "sse2",   X86_FN(xxh3_64_sse2),   X86_FN(xxh3_64_strided2d_sse2),   X86_FN(xxh3_64_gather_sse2) },
+        { "avx2",   X86_FN(xxh3_64_avx2),   X86_FN(xxh3_64_strided2d_avx2),   X86_FN(xxh3_64_gather_avx2) },
+        { "avx512", X86_FN(xxh3_64_avx512), X86_FN(xxh3_64_strided2d_avx512), X86_FN(xxh3_64_gather_avx512) },
+        { "neon",   ARM_FN(xxh3_64_neon),   ARM_FN(xxh3_64_strided2d_neon),   ARM_FN(xxh3_64_gather_neon) },
+        { "sve",    ARM_FN(xxh3_64_sve),    ARM_FN(xxh3_64_strided2d_sve),    ARM_FN(xxh3_64_gather_sve) },
+    };
+    unsigned char* fb;
+    unsigned char* recs;
+    unsigned char* scratch;
+    size_t         scratch_size, i;
+    int            a;
+
+    for (a = 1; a < argc; a++) {
+        int ok;
+        if (strncmp(argv[a], "--count=", 8) == 0) {
+            ok = parse_count(argv[a] + 8, &g_count);
+        } else if (strncmp(argv[a], "--rounds=", 9) == 0) {
+            ok = parse_count(argv[a] + 9, &g_rounds);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--count=N] [--rounds=N]\n", argv[0]);
+            return 2;
+        }
+    }
+    scratch_size = g_count * REC_LEN > (size_t)TILE_ROWS * TILE_ROW_BYTES
+                 ? g_count * REC_LEN : (size_t)TILE_ROWS * TILE_ROW_BYTES;
+    fb      = (unsigned char*)malloc((size_t)TILE_ROWS * TILE_PITCH);
+    recs    = (unsigned char*)malloc(g_count * RECORD_SIZE);
+    scratch = (unsigned char*)malloc(scratch_size);
+    if (fb == NULL || recs == NULL || scratch == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    for (i = 0; i < (size_t)TILE_ROWS * TILE_PITCH; i++) {
+        fb[i] = (unsigned char)(i * 31 + (i >> 11));
+    }
+    for (i = 0; i < g_count * RECORD_SIZE; i++) {
+        recs[i] = (unsigned char)(i * 17 + (i >> 9));
+    }
+
+    printf("tile %dx%d bytes, pitch %d; aos %lu x %d-byte records, %d bytes each; "
+           "best of %lu rounds, GB/s\n\n",
+           TILE_ROW_BYTES, TILE_ROWS, TILE_PITCH, (unsigned long)g_count, RECORD_SIZE, REC_LEN,
+           (unsigned long)g_rounds);
+    printf("%-10s %12s %10s %12s %10s\n", "variant", "tile copy", "direct", "aos copy", "direct");
+
+    for (i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+        double   tc, td, ac, ad;
+        uint64_t h_tc = 0, h_td = 0, h_ac = 0, h_ad = 0;
+        if (variants[i].strided == NULL) {
+            continue;
+        }
+        if (!variant_supported(variants[i].strided)) {
+            printf("%-10s: not supported on this CPU, skipping\n", variants[i].name);
+            continue;
+        }
+        tc = run_tile_copy(variants[i].fn, fb, scratch, &h_tc);
+        td = run_tile_direct(variants[i].strided, fb, &h_td);
+        ac = run_aos_copy(variants[i].fn, recs, scratch, &h_ac);
+        ad = run_aos_direct(variants[i].gather, recs, &h_ad);
+        if (h_tc != h_td || h_ac != h_ad) {
+            fprintf(stderr, "%s: direct hashes differ from copy + hash\n", variants[i].name);
+            return 1;
+        }
+        printf("%-10s %12.2f %10.2f %12.2f %10.2f\n", variants[i].name, tc, td, ac, ad);
+    }
+
+    free(scratch);
+    free(recs);
+    free(fb);
+    return 0;
+}
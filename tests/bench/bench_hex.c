@@ -0,0 +1,281 @@
+/* Batch canonical and hex encoding benchmark for 128-bit digests.
+ *
+ * Models writing a manifest of --count xxh3_128 digests and reading it back.
+ * The "single" row is the per-digest code such a writer uses today:
+ * xxh128_canonicalFromHash(), snprintf("%016llx%016llx") and two strtoull()
+ * calls per digest. One row per variant then times
+ * xxh128_canonicalFromHash_n_<variant>(), xxh128_toHex_n_<variant>() and
+ * xxh128_fromHex_n_<variant>() over the whole array. Reports million digests
+ * per second. All rows must produce the same bytes, text and digests.
+ *
+ * Command line (all optional):
+ *   --count=N   digests (default 100000)
+ *   --rounds=N  passes, the best one is reported (default 20)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime and sigsetjmp under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+
+#include "xxh3.h"
+
+typedef void (*canon_fn)(xxh128_canonical_t*, const xxh3_128_t*, size_t);
+typedef void (*to_hex_fn)(char*, const xxh3_128_t*, size_t);
+typedef size_t (*from_hex_fn)(xxh3_128_t*, const char*, size_t);
+
+static size_t g_count  = 100000;
+static size_t g_rounds = 20;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/* ------------------------------------------------------------------ runs */
+
+typedef struct {
+    xxh3_128_t*         hashes;
+    xxh128_canonical_t* canon;
+    char*               text;    /* 32 * count + 1 */
+    xxh3_128_t*         decoded;
+} arrays_t;
+
+/* Times one pass of `which` (0: canonical, 1: to hex, 2: from hex) */
+static double run_single(const arrays_t* a, int which)
+{
+    double best = 1e30;
+    size_t r, i;
+
+    for (r = 0; r < g_rounds; r++) {
+        double const t0 = now_sec();
+        for (i = 0; i < g_count; i++) {
+            if (which == 0) {
+                xxh128_canonicalFromHash(&a->canon[i], a->hashes[i]);
+            } else if (which == 1) {
+                snprintf(a->text + 32 * i, 33, "%016llx%016llx",
+                         (unsigned long long)a->hashes[i].high, (unsigned long long)a->hashes[i].low);
+            } else {
+                char half[17];
+                memcpy(half, a->text + 32 * i, 16);
+                half[16] = '\0';
+                a->decoded[i].high = strtoull(half, NULL, 16);
+                memcpy(half, a->text + 32 * i + 16, 16);
+                a->decoded[i].low = strtoull(half, NULL, 16);
+            }
+        }
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+    }
+    return (double)g_count / best / 1e6;
+}
+
+static double run_canon(canon_fn fn, const arrays_t* a)
+{
+    double best = 1e30;
+    size_t r;
+
+    for (r = 0; r < g_rounds; r++) {
+        double const t0 = now_sec();
+        fn(a->canon, a->hashes, g_count);
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+    }
+    return (double)g_count / best / 1e6;
+}
+
+static double run_to_hex(to_hex_fn fn, const arrays_t* a)
+{
+    double best = 1e30;
+    size_t r;
+
+    for (r = 0; r < g_rounds; r++) {
+        double const t0 = now_sec();
+        fn(a->text, a->hashes, g_count);
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+    }
+    return (double)g_count / best / 1e6;
+}
+
+static double run_from_hex(from_hex_fn fn, const arrays_t* a, size_t* decoded)
+{
+    double best = 1e30;
+    size_t r;
+
+    for (r = 0; r < g_rounds; r++) {
+        double const t0 = now_sec();
+        *decoded = fn(a->decoded, a->text, g_count);
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+    }
+    return (double)g_count / best / 1e6;
+}
+
+/* Probe a variant under a SIGILL/SIGSEGV guard before timing it */
+static sigjmp_buf _bench_jmpbuf;
+static volatile sig_atomic_t _bench_caught_sig;
+
+static void _bench_sig_handler(int sig)
+{
+    _bench_caught_sig = sig;
+    siglongjmp(_bench_jmpbuf, 1);
+}
+
+static int variant_supported(to_hex_fn fn)
+{
+    static const xxh3_128_t probe[2] = { { 1, 2 }, { 3, 4 } };
+    char text[64];
+    struct sigaction act, oldill, oldsegv;
+    volatile int ok = 0;
+
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = _bench_sig_handler;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGILL,  &act, &oldill);
+    sigaction(SIGSEGV, &act, &oldsegv);
+    if (sigsetjmp(_bench_jmpbuf, 1) == 0) {
+        fn(text, probe, 2);
+        ok = 1;
+    }
+    sigaction(SIGILL,  &oldill,  NULL);
+    sigaction(SIGSEGV, &oldsegv, NULL);
+    return ok;
+}
+
+/* See bench_variants.c: only reference variants that can exist here */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define X86_FN(fn) fn
+#else
+#  define X86_FN(fn) NULL
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define ARM_FN(fn) fn
+#else
+#  define ARM_FN(fn) NULL
+#endif
+
+static int parse_count(const char* str, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || v == 0) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const struct {
+        const char* name; canon_fn canon; to_hex_fn to_hex; from_hex_fn from_hex;
+    } variants[] = {
+        { "scalar", xxh128_canonicalFromHash_n_scalar, xxh128_toHex_n_scalar, xxh128_fromHex_n_scalar },
+        { "sse2",   X86_FN(xxh128_canonicalFromHash_n_sse2), X86_FN(xxh128_toHex_n_sse2),
+                    X86_FN(xxh128_fromHex_n_sse2) },
+        { "avx2",   X86_FN(xxh128_canonicalFromHash_n_avx2), X86_FN(xxh128_toHex_n_avx2),
+                    X86_FN(xxh128_fromHex_n_avx2) },
+        { "avx512", X86_FN(xxh128_canonicalFromHash_n_avx512), X86_FN(xxh128_toHex_n_avx512),
+                    X86_FN(xxh128_fromHex_n_avx512) },
+        { "neon",   ARM_FN(xxh128_canonicalFromHash_n_neon), ARM_FN(xxh128_toHex_n_neon),
+                    ARM_FN(xxh128_fromHex_n_neon) },
+        { "sve",    ARM_FN(xxh128_canonicalFromHash_n_sve), ARM_FN(xxh128_toHex_n_sve),
+                    ARM_FN(xxh128_fromHex_n_sve) },
+    };
+    arrays_t            a;
+    xxh128_canonical_t* ref_canon;
+    char*               ref_text;
+    size_t              i;
+    int                 arg;
+
+    for (arg = 1; arg < argc; arg++) {
+        int ok;
+        if (strncmp(argv[arg], "--count=", 8) == 0) {
+            ok = parse_count(argv[arg] + 8, &g_count);
+        } else if (strncmp(argv[arg], "--rounds=", 9) == 0) {
+            ok = parse_count(argv[arg] + 9, &g_rounds);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--count=N] [--rounds=N]\n", argv[0]);
+            return 2;
+        }
+    }
+    a.hashes  = (xxh3_128_t*)malloc(g_count * sizeof(xxh3_128_t));
+    a.canon   = (xxh128_canonical_t*)malloc(g_count * sizeof(xxh128_canonical_t));
+    a.text    = (char*)malloc(32 * g_count + 1);
+    a.decoded = (xxh3_128_t*)malloc(g_count * sizeof(xxh3_128_t));
+    ref_canon = (xxh128_canonical_t*)malloc(g_count * sizeof(xxh128_canonical_t));
+    ref_text  = (char*)malloc(32 * g_count + 1);
+    if (a.hashes == NULL || a.canon == NULL || a.text == NULL || a.decoded == NULL
+        || ref_canon == NULL || ref_text == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    for (i = 0; i < g_count; i++) {
+        a.hashes[i] = xxh3_128_scalar(&i, sizeof(i), 0);
+    }
+
+    printf("%lu xxh3_128 digests, best of %lu rounds, M digests/s\n\n",
+           (unsigned long)g_count, (unsigned long)g_rounds);
+    printf("%-10s %10s %10s %10s\n", "variant", "canonical", "to_hex", "from_hex");
+    {   double const canon = run_single(&a, 0);
+        double const to    = run_single(&a, 1);
+        double const from  = run_single(&a, 2);
+        memcpy(ref_canon, a.canon, g_count * sizeof(xxh128_canonical_t));
+        memcpy(ref_text, a.text, 32 * g_count);
+        if (memcmp(a.decoded, a.hashes, g_count * sizeof(xxh3_128_t)) != 0) {
+            fprintf(stderr, "single: strtoull round trip failed\n");
+            return 1;
+        }
+        printf("%-10s %10.2f %10.2f %10.2f\n", "single", canon, to, from);
+    }
+
+    for (i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+        double canon, to, from;
+        size_t decoded = 0;
+        if (variants[i].to_hex == NULL) {
+            continue;
+        }
+        if (!variant_supported(variants[i].to_hex)) {
+            printf("%-10s: not supported on this CPU, skipping\n", variants[i].name);
+            continue;
+        }
+        memset(a.canon, 0, g_count * sizeof(xxh128_canonical_t));
+        memset(a.text, 0, 32 * g_count);
+        memset(a.decoded, 0, g_count * sizeof(xxh3_128_t));
+        canon = run_canon(variants[i].canon, &a);
+        to    = run_to_hex(variants[i].to_hex, &a);
+        from  = run_from_hex(variants[i].from_hex, &a, &decoded);
+        if (memcmp(a.canon, ref_canon, g_count * sizeof(xxh128_canonical_t)) != 0
+            || memcmp(a.text, ref_text, 32 * g_count) != 0 || decoded != g_count
+            || memcmp(a.decoded, a.hashes, g_count * sizeof(xxh3_128_t)) != 0) {
+            fprintf(stderr, "%s: results differ from the per-digest functions\n", variants[i].name);
+            return 1;
+        }
+        printf("%-10s %10.2f %10.2f %10.2f\n", variants[i].name, canon, to, from);
+    }
+
+    free(ref_text);
+    free(ref_canon);
+    free(a.decoded);
+    free(a.text);
+    free(a.canon);
+    free(a.hashes);
+    return 0;
+}
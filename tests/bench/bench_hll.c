@@ -0,0 +1,285 @@
+/* HyperLogLog benchmark.
+ *
+ * One row per variant times xxh3_hll_add_<variant>() a key at a time
+ * ("add") and xxh3_hll_add_batch_<variant>() over the whole key array
+ * ("add_n"), adding --count 16-byte keys to a sketch of --precision bits,
+ * in million keys per second; then xxh3_hll_merge_<variant>() folding
+ * --sketches dense sketches into one ("merge"), in GB/s of registers read.
+ * Every variant must reach the same estimates as the scalar one. A last
+ * table gives the relative error of the estimate at powers of ten up to
+ * --count.
+ *
+ * Command line (all optional):
+ *   --count=N      keys added (default 1000000)
+ *   --precision=N  index bits, 4..18 (default 14)
+ *   --sketches=N   sketches merged (default 4096)
+ *   --rounds=N     passes, the best one is reported (default 3)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime and sigsetjmp under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+
+#include "xxh3.h"
+
+#define KEY_SIZE 16
+
+/* Distinct dense sketches the merged ones are copied from */
+#define MERGE_SOURCES 16
+
+typedef int (*add_fn)(xxh3_hll_t*, const void*, size_t);
+typedef int (*add_batch_fn)(xxh3_hll_t*, const void* const*, const size_t*, size_t);
+typedef int (*merge_fn)(xxh3_hll_t*, const xxh3_hll_t*);
+
+static size_t g_count     = 1000000;
+static size_t g_precision = 14;
+static size_t g_sketches  = 4096;
+static size_t g_rounds    = 3;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+static xxh3_hll_t* new_sketch(void)
+{
+    xxh3_hll_t* hll = xxh3_hll_create((unsigned)g_precision, 0, NULL);
+    if (hll == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+    return hll;
+}
+
+typedef struct {
+    const char*  name;
+    add_fn       add;
+    add_batch_fn add_batch;
+    merge_fn     merge;
+} variant_t;
+
+/* rate[0] add and rate[1] add batch in M keys/s, rate[2] merge in GB/s;
+ * est[0..2] the estimates after each. */
+static void run_variant(const variant_t* v, const void* const* keys, const size_t* sizes,
+                        xxh3_hll_t* const* sketches, double rate[3], double est[3])
+{
+    double best[3] = { 0, 0, 0 };
+    size_t r, i;
+
+    for (r = 0; r < g_rounds; r++) {
+        xxh3_hll_t* hll[3];
+        double      t[3];
+
+        for (i = 0; i < 3; i++) {
+            hll[i] = new_sketch();
+        }
+        t[0] = now_sec();
+        for (i = 0; i < g_count; i++) {
+            v->add(hll[0], keys[i], KEY_SIZE);
+        }
+        t[0] = now_sec() - t[0];
+        t[1] = now_sec();
+        v->add_batch(hll[1], keys, sizes, g_count);
+        t[1] = now_sec() - t[1];
+        v->merge(hll[2], sketches[0]);
+        t[2] = now_sec();
+        for (i = 1; i < g_sketches; i++) {
+            v->merge(hll[2], sketches[i]);
+        }
+        t[2] = now_sec() - t[2];
+        for (i = 0; i < 3; i++) {
+            best[i] = (r == 0 || t[i] < best[i]) ? t[i] : best[i];
+            est[i]  = xxh3_hll_estimate(hll[i]);
+            xxh3_hll_free(hll[i]);
+        }
+    }
+    rate[0] = (double)g_count / best[0] / 1e6;
+    rate[1] = (double)g_count / best[1] / 1e6;
+    rate[2] = (double)(g_sketches - 1) * (double)((size_t)1 << g_precision) / best[2] / 1e9;
+}
+
+/* Probe a variant under a SIGILL/SIGSEGV guard before timing it */
+static sigjmp_buf _bench_jmpbuf;
+static volatile sig_atomic_t _bench_caught_sig;
+
+static void _bench_sig_handler(int sig)
+{
+    _bench_caught_sig = sig;
+    siglongjmp(_bench_jmpbuf, 1);
+}
+
+static int variant_supported(add_fn fn)
+{
+    xxh3_hll_t*      hll = new_sketch();
+    struct sigaction act, oldill, oldsegv;
+    volatile int     ok = 0;
+
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = _bench_sig_handler;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGILL,  &act, &oldill);
+    sigaction(SIGSEGV, &act, &oldsegv);
+    if (sigsetjmp(_bench_jmpbuf, 1) == 0) {
+        fn(hll, "probe", 5);
+        ok = 1;
+    }
+    sigaction(SIGILL,  &oldill,  NULL);
+    sigaction(SIGSEGV, &oldsegv, NULL);
+    xxh3_hll_free(hll);
+    return ok;
+}
+
+/* See bench_variants.c: only reference variants that can exist here */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define X86_FN(fn) fn
+#else
+#  define X86_FN(fn) NULL
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define ARM_FN(fn) fn
+#else
+#  define ARM_FN(fn) NULL
+#endif
+
+#define VARIANT(v, ISA_FN) { #v, ISA_FN(xxh3_hll_add_##v), ISA_FN(xxh3_hll_add_batch_##v), \
+                             ISA_FN(xxh3_hll_merge_##v) }
+#define SCALAR_FN(fn) fn
+
+static int parse_count(const char* str, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || v == 0) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const variant_t variants[] = {
+        VARIANT(scalar, SCALAR_FN), VARIANT(sse2, X86_FN), VARIANT(avx2, X86_FN),
+        VARIANT(avx512, X86_FN),    VARIANT(neon, ARM_FN), VARIANT(sve, ARM_FN),
+    };
+    unsigned char* keys;
+    const void**   ptrs;
+    size_t*        sizes;
+    xxh3_hll_t**   sketches;
+    xxh3_hll_t*    sources[MERGE_SOURCES];
+    xxh3_hll_t*    hll;
+    double         ref[3] = { 0, 0, 0 };
+    size_t         i, n;
+    int            arg;
+
+    for (arg = 1; arg < argc; arg++) {
+        int ok;
+        if (strncmp(argv[arg], "--count=", 8) == 0) {
+            ok = parse_count(argv[arg] + 8, &g_count);
+        } else if (strncmp(argv[arg], "--precision=", 12) == 0) {
+            ok = parse_count(argv[arg] + 12, &g_precision) && g_precision >= 4
+                 && g_precision <= 18;
+        } else if (strncmp(argv[arg], "--sketches=", 11) == 0) {
+            ok = parse_count(argv[arg] + 11, &g_sketches);
+        } else if (strncmp(argv[arg], "--rounds=", 9) == 0) {
+            ok = parse_count(argv[arg] + 9, &g_rounds);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--count=N] [--precision=N] [--sketches=N] [--rounds=N]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    keys     = (unsigned char*)malloc(g_count * KEY_SIZE);
+    ptrs     = (const void**)malloc(g_count * sizeof(void*));
+    sizes    = (size_t*)malloc(g_count * sizeof(size_t));
+    sketches = (xxh3_hll_t**)malloc(g_sketches * sizeof(xxh3_hll_t*));
+    if (keys == NULL || ptrs == NULL || sizes == NULL || sketches == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    /* key i: its index and a constant tail */
+    for (i = 0; i < g_count; i++) {
+        uint64_t const id   = (uint64_t)i;
+        uint64_t const tail = 0x5A5A5A5A5A5A5A5AULL;
+        memcpy(keys + KEY_SIZE * i, &id, 8);
+        memcpy(keys + KEY_SIZE * i + 8, &tail, 8);
+        ptrs[i]  = keys + KEY_SIZE * i;
+        sizes[i] = KEY_SIZE;
+    }
+    /* dense sources over disjoint hashes, then copies of them by merging
+     * each into an empty sketch */
+    for (i = 0; i < MERGE_SOURCES; i++) {
+        uint64_t h = (uint64_t)i << 32;
+        sources[i] = new_sketch();
+        while (!xxh3_hll_is_dense(sources[i])) {
+            xxh3_hll_add_hash(sources[i], xxh3_64_scalar(&h, sizeof(h), 0));
+            h++;
+        }
+    }
+    for (i = 0; i < g_sketches; i++) {
+        sketches[i] = new_sketch();
+        xxh3_hll_merge_scalar(sketches[i], sources[i % MERGE_SOURCES]);
+    }
+
+    printf("%lu keys, precision %lu, %lu sketches merged, best of %lu rounds\n\n",
+           (unsigned long)g_count, (unsigned long)g_precision, (unsigned long)g_sketches,
+           (unsigned long)g_rounds);
+    printf("%-10s %12s %12s %12s\n", "variant", "add (M/s)", "add_n (M/s)", "merge (GB/s)");
+    for (i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+        double rate[3], est[3];
+
+        if (variants[i].add == NULL) {
+            continue;
+        }
+        if (!variant_supported(variants[i].add)) {
+            printf("%-10s: not supported on this CPU, skipping\n", variants[i].name);
+            continue;
+        }
+        run_variant(&variants[i], ptrs, sizes, sketches, rate, est);
+        if (i == 0) {
+            memcpy(ref, est, sizeof(ref));
+        }
+        if (est[0] != ref[0] || est[1] != ref[0] || est[2] != ref[2]) {
+            fprintf(stderr, "%s: estimates differ from the scalar ones\n", variants[i].name);
+            return 1;
+        }
+        printf("%-10s %12.2f %12.2f %12.2f\n", variants[i].name, rate[0], rate[1], rate[2]);
+    }
+
+    printf("\n%-12s %14s %10s\n", "cardinality", "estimate", "error");
+    hll = new_sketch();
+    for (i = 0, n = 10; n <= g_count; n *= 10) {
+        double e;
+        xxh3_hll_add_batch_scalar(hll, ptrs + i, sizes + i, n - i);
+        i = n;
+        e = xxh3_hll_estimate(hll);
+        printf("%-12lu %14.1f %+9.3f%%\n", (unsigned long)n, e,
+               100.0 * (e - (double)n) / (double)n);
+    }
+    xxh3_hll_free(hll);
+
+    for (i = 0; i < g_sketches; i++) {
+        xxh3_hll_free(sketches[i]);
+    }
+    for (i = 0; i < MERGE_SOURCES; i++) {
+        xxh3_hll_free(sources[i]);
+    }
+    free(sketches);
+    free(sizes);
+    free(ptrs);
+    free(keys);
+    return 0;
+}
@@ -0,0 +1,192 @@
+/* Static digest index lookup benchmark for xxh3_index_contains /
+ * xxh3_index_contains_n.
+ *
+ * Builds a set of --count distinct xxh3_128 digests, writes its index image
+ * to a temporary file and maps it back, then looks up --queries digests of
+ * which --hits percent are in the set. Times
+ *   - bsearch() with xxh3_128_cmp over the sorted array, the usual way
+ *   - xxh3_index_contains() once per query
+ *   - xxh3_index_contains_n() over all queries
+ * and reports million lookups per second and nanoseconds per lookup. All
+ * three must find the same digests. The time from mmap() to a usable index
+ * is reported too.
+ *
+ * Command line (all optional):
+ *   --count=N    digests in the set (default 1000000)
+ *   --queries=N  lookups per round (default 1000000)
+ *   --hits=P     percent of queries that are in the set (default 50)
+ *   --rounds=N   repetitions, the best one is reported (default 5)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime and mmap under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#include "xxh3.h"
+
+static size_t g_count   = 1000000;
+static size_t g_queries = 1000000;
+static size_t g_hits    = 50;
+static size_t g_rounds  = 5;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/* Times looking up every query (0: bsearch, 1: contains, 2: contains_n) */
+static double run_lookup(int which, const xxh3_128_t* set, size_t n, const xxh3_index_t* index,
+                         const xxh3_128_t* queries, unsigned char* found, size_t* hits)
+{
+    double best = 1e30;
+    size_t r, i;
+
+    for (r = 0; r < g_rounds; r++) {
+        double const t0 = now_sec();
+        size_t h = 0;
+        if (which == 0) {
+            for (i = 0; i < g_queries; i++) {
+                found[i] = bsearch(&queries[i], set, n, sizeof(xxh3_128_t), xxh3_128_cmp) != NULL;
+                h += found[i];
+            }
+        } else if (which == 1) {
+            for (i = 0; i < g_queries; i++) {
+                found[i] = (unsigned char)xxh3_index_contains(index, queries[i]);
+                h += found[i];
+            }
+        } else {
+            h = xxh3_index_contains_n(index, queries, g_queries, found);
+        }
+        *hits = h;
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+    }
+    return best;
+}
+
+static int parse_count(const char* str, size_t* out, int allow_zero)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || (v == 0 && !allow_zero)) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const char* const names[] = { "bsearch + xxh3_128_cmp", "xxh3_index_contains",
+                                         "xxh3_index_contains_n" };
+    xxh3_128_t*    set;
+    xxh3_128_t*    queries;
+    unsigned char* found;
+    unsigned char* ref;
+    unsigned char* image;
+    void*          map;
+    FILE*          file;
+    xxh3_index_t   index;
+    size_t         n, size, i;
+    double         t0, t_open, t_base = 0;
+    uint64_t       rng = 0x0123456789ABCDEFULL;
+    int            a, which;
+
+    for (a = 1; a < argc; a++) {
+        int ok;
+        if (strncmp(argv[a], "--count=", 8) == 0) {
+            ok = parse_count(argv[a] + 8, &g_count, 0);
+        } else if (strncmp(argv[a], "--queries=", 10) == 0) {
+            ok = parse_count(argv[a] + 10, &g_queries, 0);
+        } else if (strncmp(argv[a], "--hits=", 7) == 0) {
+            ok = parse_count(argv[a] + 7, &g_hits, 1) && g_hits <= 100;
+        } else if (strncmp(argv[a], "--rounds=", 9) == 0) {
+            ok = parse_count(argv[a] + 9, &g_rounds, 0);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--count=N] [--queries=N] [--hits=P] [--rounds=N]\n", argv[0]);
+            return 2;
+        }
+    }
+    set     = (xxh3_128_t*)malloc(g_count * sizeof(xxh3_128_t));
+    queries = (xxh3_128_t*)malloc(g_queries * sizeof(xxh3_128_t));
+    found   = (unsigned char*)malloc(g_queries);
+    ref     = (unsigned char*)malloc(g_queries);
+    image   = (unsigned char*)malloc(xxh3_index_size(g_count));
+    if (set == NULL || queries == NULL || found == NULL || ref == NULL || image == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    for (i = 0; i < g_count; i++) {
+        set[i] = xxh3_128_scalar(&i, sizeof(i), 0);
+    }
+    for (i = 0; i < g_queries; i++) {
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+        if (rng % 100 < g_hits) {
+            queries[i] = set[(rng >> 8) % g_count];
+        } else {
+            queries[i] = xxh3_128_scalar(&rng, sizeof(rng), 1);
+        }
+    }
+    xxh3_128_sort(set, g_count);
+    n    = xxh3_128_unique(set, g_count);
+    size = xxh3_index_size(n);
+    file = tmpfile();
+    if (xxh3_index_build(image, size, set, n) != XXH3_OK || file == NULL
+        || fwrite(image, 1, size, file) != size || fflush(file) != 0) {
+        fprintf(stderr, "writing the index failed\n");
+        return 1;
+    }
+    free(image);
+
+    t0  = now_sec();
+    map = mmap(NULL, size, PROT_READ, MAP_SHARED, fileno(file), 0);
+    if (map == MAP_FAILED || xxh3_index_view(&index, map, size) != XXH3_OK) {
+        fprintf(stderr, "mapping the index failed\n");
+        return 1;
+    }
+    t_open = now_sec() - t0;
+
+    printf("%lu digests (%.1f MB index), %lu queries, %lu%% hits, best of %lu rounds\n",
+           (unsigned long)n, (double)size / 1e6, (unsigned long)g_queries, (unsigned long)g_hits,
+           (unsigned long)g_rounds);
+    printf("mmap + xxh3_index_view: %.1f us\n\n", t_open * 1e6);
+    printf("%-24s %10s %10s\n", "", "M/s", "ns/lookup");
+    for (which = 0; which < 3; which++) {
+        size_t       hits = 0;
+        double const t    = run_lookup(which, set, n, &index, queries, which == 0 ? ref : found, &hits);
+        if (which == 0) {
+            t_base = t;
+        } else if (memcmp(found, ref, g_queries) != 0) {
+            fprintf(stderr, "%s: results differ from bsearch\n", names[which]);
+            return 1;
+        }
+        printf("%-24s %10.2f %10.1f", names[which], (double)g_queries / t / 1e6,
+               t / (double)g_queries * 1e9);
+        if (which == 0) {
+            printf("  (%lu found)\n", (unsigned long)hits);
+        } else {
+            printf("  (%.1fx)\n", t_base / t);
+        }
+    }
+
+    munmap(map, size);
+    fclose(file);
+    free(ref);
+    free(found);
+    free(queries);
+    free(set);
+    return 0;
+}
@@ -0,0 +1,335 @@
+/* Hash map benchmark: xxh3_map_t against a separately chained table.
+ *
+ * The baseline is the table teams write around xxh3_64_<variant>(): a
+ * power-of-two bucket array of singly linked nodes, one malloc() per entry,
+ * grown at load factor 1, hashing keys with xxh3_64_scalar(). Both tables
+ * map keys to 8-byte values. Three key distributions:
+ *   - u64:    8-byte sequential ids
+ *   - digest: 16-byte xxh3_128 digests
+ *   - string: 32-byte zero-padded strings "user:<id>@example.com"
+ * For each, --count keys are inserted into an empty table, looked up in a
+ * shuffled order (hits), looked up with keys that are absent (misses) and
+ * erased. Reports million operations per second. Both tables must find the
+ * same values.
+ *
+ * Command line (all optional):
+ *   --count=N   keys (default 1000000)
+ *   --rounds=N  repetitions, the best one is reported (default 3)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "xxh3.h"
+
+#define MAX_KEY 32
+
+static size_t g_count  = 1000000;
+static size_t g_rounds = 3;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/* ------------------------------------------------------------ baseline */
+
+typedef struct chain_node {
+    struct chain_node* next;
+    uint64_t           hash;
+    uint64_t           value;
+    unsigned char      key[MAX_KEY];
+} chain_node;
+
+typedef struct {
+    chain_node** buckets;
+    size_t       mask;
+    size_t       size;
+    size_t       key_size;
+} chain_table;
+
+static void chain_init(chain_table* t, size_t key_size)
+{
+    t->mask     = 15;
+    t->size     = 0;
+    t->key_size = key_size;
+    t->buckets  = (chain_node**)calloc(t->mask + 1, sizeof(chain_node*));
+}
+
+static void chain_grow(chain_table* t)
+{
+    size_t const       mask    = 2 * t->mask + 1;
+    chain_node** const buckets = (chain_node**)calloc(mask + 1, sizeof(chain_node*));
+    size_t b;
+    for (b = 0; b <= t->mask; b++) {
+        chain_node* n = t->buckets[b];
+        while (n != NULL) {
+            chain_node* const next = n->next;
+            n->next = buckets[n->hash & mask];
+            buckets[n->hash & mask] = n;
+            n = next;
+        }
+    }
+    free(t->buckets);
+    t->buckets = buckets;
+    t->mask    = mask;
+}
+
+static uint64_t* chain_find(const chain_table* t, const void* key)
+{
+    uint64_t const h = xxh3_64_scalar(key, t->key_size, 0);
+    chain_node*    n;
+    for (n = t->buckets[h & t->mask]; n != NULL; n = n->next) {
+        if (n->hash == h && memcmp(n->key, key, t->key_size) == 0) {
+            return &n->value;
+        }
+    }
+    return NULL;
+}
+
+static uint64_t* chain_insert(chain_table* t, const void* key)
+{
+    uint64_t const h = xxh3_64_scalar(key, t->key_size, 0);
+    chain_node*    n;
+    for (n = t->buckets[h & t->mask]; n != NULL; n = n->next) {
+        if (n->hash == h && memcmp(n->key, key, t->key_size) == 0) {
+            return &n->value;
+        }
+    }
+    if (t->size > t->mask) {
+        chain_grow(t);
+    }
+    n = (chain_node*)malloc(sizeof(chain_node));
+    n->hash  = h;
+    n->value = 0;
+    memcpy(n->key, key, t->key_size);
+    n->next = t->buckets[h & t->mask];
+    t->buckets[h & t->mask] = n;
+    t->size++;
+    return &n->value;
+}
+
+static int chain_erase(chain_table* t, const void* key)
+{
+    uint64_t const h = xxh3_64_scalar(key, t->key_size, 0);
+    chain_node**   p;
+    for (p = &t->buckets[h & t->mask]; *p != NULL; p = &(*p)->next) {
+        if ((*p)->hash == h && memcmp((*p)->key, key, t->key_size) == 0) {
+            chain_node* const n = *p;
+            *p = n->next;
+            free(n);
+            t->size--;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void chain_destroy(chain_table* t)
+{
+    size_t b;
+    for (b = 0; b <= t->mask; b++) {
+        while (t->buckets[b] != NULL) {
+            chain_node* const n = t->buckets[b];
+            t->buckets[b] = n->next;
+            free(n);
+        }
+    }
+    free(t->buckets);
+}
+
+/* ------------------------------------------------------------------ runs */
+
+typedef struct {
+    const char*          name;
+    size_t               key_size;
+    const unsigned char* keys;     /* g_count keys */
+    const unsigned char* misses;   /* g_count absent keys */
+    const size_t*        order;    /* shuffled 0..g_count-1 */
+} workload;
+
+/* Best times of the four phases for one table (0: chained, 1: xxh3_map) */
+static void run_table(int which, const workload* w, double best[4], uint64_t* check)
+{
+    size_t r, i;
+
+    for (r = 0; r < g_rounds; r++) {
+        chain_table   chain;
+        xxh3_map_t*   map = NULL;
+        double        t[5];
+        uint64_t      sum = 0;
+
+        memset(&chain, 0, sizeof(chain));
+        if (which == 0) {
+            chain_init(&chain, w->key_size);
+        } else {
+            xxh3_map_config_t config;
+            memset(&config, 0, sizeof(config));
+            config.key_size   = w->key_size;
+            config.value_size = sizeof(uint64_t);
+            map = xxh3_map_create(&config, 0);
+        }
+        t[0] = now_sec();
+        for (i = 0; i < g_count; i++) {
+            const void* const key = w->keys + i * w->key_size;
+            uint64_t* const   v   = (which == 0) ? chain_insert(&chain, key)
+                                                 : (uint64_t*)xxh3_map_insert(map, key, NULL);
+            *v = i;
+        }
+        t[1] = now_sec();
+        for (i = 0; i < g_count; i++) {
+            const void* const key = w->keys + w->order[i] * w->key_size;
+            const uint64_t* const v = (which == 0) ? chain_find(&chain, key)
+                                                   : (const uint64_t*)xxh3_map_find(map, key);
+            sum += *v;
+        }
+        t[2] = now_sec();
+        for (i = 0; i < g_count; i++) {
+            const void* const key = w->misses + w->order[i] * w->key_size;
+            sum += ((which == 0) ? (void*)chain_find(&chain, key) : xxh3_map_find(map, key)) != NULL;
+        }
+        t[3] = now_sec();
+        for (i = 0; i < g_count; i++) {
+            const void* const key = w->keys + w->order[i] * w->key_size;
+            sum += (uint64_t)((which == 0) ? chain_erase(&chain, key) : xxh3_map_erase(map, key));
+        }
+        t[4] = now_sec();
+        if (which == 0) {
+            chain_destroy(&chain);
+        } else {
+            xxh3_map_free(map);
+        }
+        for (i = 0; i < 4; i++) {
+            double const dt = t[i + 1] - t[i];
+            best[i] = (r == 0 || dt < best[i]) ? dt : best[i];
+        }
+        *check = sum;
+    }
+}
+
+static int parse_count(const char* str, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || v == 0) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+/* Key i of distribution d (0: u64, 1: digest, 2: string); `miss` selects a
+ * key that is not among keys 0..g_count-1 */
+static void make_key(unsigned char* key, int d, size_t i, int miss)
+{
+    uint64_t const id = (uint64_t)i + (miss ? (uint64_t)g_count : 0);
+    if (d == 0) {
+        memcpy(key, &id, 8);
+    } else if (d == 1) {
+        xxh3_128_t const h = xxh3_128_scalar(&id, sizeof(id), 0);
+        memcpy(key, &h, 16);
+    } else {
+        char   text[64];
+        size_t len = (size_t)snprintf(text, sizeof(text), "user:%llu@example.com",
+                                      (unsigned long long)id);
+        len = len < 32 ? len : 32;
+        memset(key, 0, 32);
+        memcpy(key, text, len);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    static const char* const names[]     = { "u64", "digest", "string" };
+    static const size_t      key_sizes[] = { 8, 16, 32 };
+    static const char* const phases[]    = { "insert", "hit", "miss", "erase" };
+    unsigned char* keys;
+    unsigned char* misses;
+    size_t*        order;
+    size_t         i;
+    uint64_t       rng = 0x0123456789ABCDEFULL;
+    int            a, d;
+
+    for (a = 1; a < argc; a++) {
+        int ok;
+        if (strncmp(argv[a], "--count=", 8) == 0) {
+            ok = parse_count(argv[a] + 8, &g_count);
+        } else if (strncmp(argv[a], "--rounds=", 9) == 0) {
+            ok = parse_count(argv[a] + 9, &g_rounds);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--count=N] [--rounds=N]\n", argv[0]);
+            return 2;
+        }
+    }
+    keys   = (unsigned char*)malloc(g_count * MAX_KEY);
+    misses = (unsigned char*)malloc(g_count * MAX_KEY);
+    order  = (size_t*)malloc(g_count * sizeof(size_t));
+    if (keys == NULL || misses == NULL || order == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    for (i = 0; i < g_count; i++) {
+        order[i] = i;
+    }
+    for (i = g_count - 1; i > 0; i--) {
+        size_t j, tmp;
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+        j = (size_t)(rng % (i + 1));
+        tmp = order[i]; order[i] = order[j]; order[j] = tmp;
+    }
+
+    printf("%lu keys, best of %lu rounds, M operations/s\n\n", (unsigned long)g_count,
+           (unsigned long)g_rounds);
+    printf("%-8s %-9s %9s %9s %9s %9s\n", "keys", "table", phases[0], phases[1], phases[2], phases[3]);
+    for (d = 0; d < 3; d++) {
+        workload w;
+        double   best[2][4];
+        uint64_t check[2];
+        int      which;
+
+        for (i = 0; i < g_count; i++) {
+            make_key(keys + i * key_sizes[d], d, i, 0);
+            make_key(misses + i * key_sizes[d], d, i, 1);
+        }
+        w.name     = names[d];
+        w.key_size = key_sizes[d];
+        w.keys     = keys;
+        w.misses   = misses;
+        w.order    = order;
+        for (which = 0; which < 2; which++) {
+            run_table(which, &w, best[which], &check[which]);
+        }
+        if (check[0] != check[1]) {
+            fprintf(stderr, "%s: xxh3_map results differ from the chained table\n", names[d]);
+            return 1;
+        }
+        for (which = 0; which < 2; which++) {
+            printf("%-8s %-9s", which == 0 ? names[d] : "", which == 0 ? "chained" : "xxh3_map");
+            for (i = 0; i < 4; i++) {
+                printf(" %9.2f", (double)g_count / best[which][i] / 1e6);
+            }
+            if (which == 1) {
+                printf("  (%.1fx %.1fx %.1fx %.1fx)", best[0][0] / best[1][0], best[0][1] / best[1][1],
+                       best[0][2] / best[1][2], best[0][3] / best[1][3]);
+            }
+            printf("\n");
+        }
+    }
+
+    free(order);
+    free(misses);
+    free(keys);
+    return 0;
+}
@@ -0,0 +1,278 @@
+/* MinHash signature benchmark for the multi-seed XXH3-64 variants.
+ *
+ * A synthetic document is split into overlapping word shingles (4 words by
+ * default, 10-50 bytes). Its MinHash signature is the minimum over all
+ * shingles of the hash under each of k seeds. Two ways are timed per variant:
+ *   - per-seed:  k calls of xxh3_64_<variant>() per shingle
+ *   - multiseed: one xxh3_64_multiseed_<variant>() call per shingle
+ * and reported in shingles/second. Both must give the same signature.
+ *
+ * Command line (all optional):
+ *   --k=N         signature length / number of seeds (default 128)
+ *   --words=N     words per shingle (default 4)
+ *   --shingles=N  shingles in the document (default 100000)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime and sigsetjmp under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+
+#include "xxh3.h"
+
+typedef uint64_t (*hash_fn)(const void*, size_t, uint64_t);
+typedef void (*multiseed_fn)(const void*, size_t, const uint64_t*, size_t, uint64_t*);
+
+static size_t g_k        = 128;
+static size_t g_words    = 4;
+static size_t g_shingles = 100000;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/* ------------------------------------------------------------------ corpus */
+
+typedef struct {
+    char*   text;
+    size_t* start;   /* word i begins at text + start[i]; start[nwords] = end */
+    size_t  nwords;
+} corpus_t;
+
+/* Lower-case words of 2-10 letters separated by single spaces */
+static int corpus_init(corpus_t* c, size_t nwords)
+{
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    size_t   pos = 0;
+    size_t   i;
+
+    c->nwords = nwords;
+    c->text   = (char*)malloc(nwords * 11 + 1);
+    c->start  = (size_t*)malloc((nwords + 1) * sizeof(size_t));
+    if (c->text == NULL || c->start == NULL) {
+        free(c->text);
+        free(c->start);
+        return 0;
+    }
+    for (i = 0; i < nwords; i++) {
+        size_t len, l;
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+        len = 2 + (size_t)(rng % 9);
+        c->start[i] = pos;
+        for (l = 0; l < len; l++) {
+            c->text[pos++] = (char)('a' + (rng >> (8 + 3 * l)) % 26);
+        }
+        c->text[pos++] = ' ';
+    }
+    c->start[nwords] = pos;
+    return 1;
+}
+
+/* Shingle i: words i .. i + g_words - 1 without the trailing space */
+static size_t shingle(const corpus_t* c, size_t i, const char** p)
+{
+    *p = c->text + c->start[i];
+    return c->start[i + g_words] - c->start[i] - 1;
+}
+
+/* ------------------------------------------------------------------ runs */
+
+static void sig_init(uint64_t* sig)
+{
+    size_t j;
+    for (j = 0; j < g_k; j++) {
+        sig[j] = UINT64_MAX;
+    }
+}
+
+static double run_per_seed(hash_fn fn, const corpus_t* c, const uint64_t* seeds, uint64_t* sig)
+{
+    double t0, t1;
+    size_t i, j;
+
+    sig_init(sig);
+    t0 = now_sec();
+    for (i = 0; i < g_shingles; i++) {
+        const char* p;
+        size_t const len = shingle(c, i, &p);
+        for (j = 0; j < g_k; j++) {
+            uint64_t const h = fn(p, len, seeds[j]);
+            if (h < sig[j]) {
+                sig[j] = h;
+            }
+        }
+    }
+    t1 = now_sec();
+    return (double)g_shingles / (t1 - t0);
+}
+
+static double run_multiseed(multiseed_fn fn, const corpus_t* c, const uint64_t* seeds,
+                            uint64_t* sig, uint64_t* h)
+{
+    double t0, t1;
+    size_t i, j;
+
+    sig_init(sig);
+    t0 = now_sec();
+    for (i = 0; i < g_shingles; i++) {
+        const char* p;
+        size_t const len = shingle(c, i, &p);
+        fn(p, len, seeds, g_k, h);
+        for (j = 0; j < g_k; j++) {
+            if (h[j] < sig[j]) {
+                sig[j] = h[j];
+            }
+        }
+    }
+    t1 = now_sec();
+    return (double)g_shingles / (t1 - t0);
+}
+
+/* Probe a variant under a SIGILL/SIGSEGV guard before timing it */
+static sigjmp_buf _bench_jmpbuf;
+static volatile sig_atomic_t _bench_caught_sig;
+
+static void _bench_sig_handler(int sig)
+{
+    _bench_caught_sig = sig;
+    siglongjmp(_bench_jmpbuf, 1);
+}
+
+static int variant_supported(multiseed_fn fn)
+{
+    static const unsigned char probe[64];
+    static const uint64_t seeds[16];
+    uint64_t out[16];
+    struct sigaction act, oldill, oldsegv;
+    volatile int ok = 0;
+
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = _bench_sig_handler;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGILL,  &act, &oldill);
+    sigaction(SIGSEGV, &act, &oldsegv);
+    if (sigsetjmp(_bench_jmpbuf, 1) == 0) {
+        fn(probe, 12, seeds, 16, out);
+        fn(probe, sizeof(probe), seeds, 16, out);
+        ok = 1;
+    }
+    sigaction(SIGILL,  &oldill,  NULL);
+    sigaction(SIGSEGV, &oldsegv, NULL);
+    return ok;
+}
+
+/* See bench_variants.c: only reference variants that can exist here */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define X86_FN(fn) fn
+#else
+#  define X86_FN(fn) NULL
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define ARM_FN(fn) fn
+#else
+#  define ARM_FN(fn) NULL
+#endif
+
+static int parse_count(const char* str, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || v == 0) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const struct { const char* name; hash_fn fn; multiseed_fn ms; } variants[] = {
+        { "scalar", xxh3_64_scalar,         xxh3_64_multiseed_scalar },
+        { "sse2",   X86_FN(xxh3_64_sse2),   X86_FN(xxh3_64_multiseed_sse2) },
+        { "avx2",   X86_FN(xxh3_64_avx2),   X86_FN(xxh3_64_multiseed_avx2) },
+        { "avx512", X86_FN(xxh3_64_avx512), X86_FN(xxh3_64_multiseed_avx512) },
+        { "neon",   ARM_FN(xxh3_64_neon),   ARM_FN(xxh3_64_multiseed_neon) },
+        { "sve",    ARM_FN(xxh3_64_sve),    ARM_FN(xxh3_64_multiseed_sve) },
+    };
+    corpus_t  corpus;
+    uint64_t* seeds;
+    uint64_t* sig_ref;
+    uint64_t* sig;
+    uint64_t* h;
+    uint64_t  rng = 0x0123456789ABCDEFULL;
+    size_t    i, j;
+    int       a;
+
+    for (a = 1; a < argc; a++) {
+        int ok;
+        if (strncmp(argv[a], "--k=", 4) == 0) {
+            ok = parse_count(argv[a] + 4, &g_k);
+        } else if (strncmp(argv[a], "--words=", 8) == 0) {
+            ok = parse_count(argv[a] + 8, &g_words);
+        } else if (strncmp(argv[a], "--shingles=", 11) == 0) {
+            ok = parse_count(argv[a] + 11, &g_shingles);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--k=N] [--words=N] [--shingles=N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    seeds   = (uint64_t*)malloc(g_k * sizeof(uint64_t));
+    sig_ref = (uint64_t*)malloc(g_k * sizeof(uint64_t));
+    sig     = (uint64_t*)malloc(g_k * sizeof(uint64_t));
+    h       = (uint64_t*)malloc(g_k * sizeof(uint64_t));
+    if (seeds == NULL || sig_ref == NULL || sig == NULL || h == NULL
+        || !corpus_init(&corpus, g_shingles + g_words)) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    for (j = 0; j < g_k; j++) {
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+        seeds[j] = rng;
+    }
+
+    printf("%lu shingles of %lu words, k = %lu\n\n",
+           (unsigned long)g_shingles, (unsigned long)g_words, (unsigned long)g_k);
+    printf("%-10s %16s %16s %8s\n", "variant", "per-seed sh/s", "multiseed sh/s", "speedup");
+
+    (void)run_per_seed(xxh3_64_scalar, &corpus, seeds, sig_ref);
+    for (i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+        double per_seed, multi;
+        if (variants[i].ms == NULL) {
+            continue;
+        }
+        if (!variant_supported(variants[i].ms)) {
+            printf("%-10s: not supported on this CPU, skipping\n", variants[i].name);
+            continue;
+        }
+        per_seed = run_per_seed(variants[i].fn, &corpus, seeds, sig);
+        multi    = run_multiseed(variants[i].ms, &corpus, seeds, sig, h);
+        if (memcmp(sig, sig_ref, g_k * sizeof(uint64_t)) != 0) {
+            fprintf(stderr, "%s: signature mismatch\n", variants[i].name);
+            return 1;
+        }
+        printf("%-10s %16.0f %16.0f %7.2fx\n", variants[i].name, per_seed, multi,
+               multi / per_seed);
+    }
+
+    free(corpus.text);
+    free(corpus.start);
+    free(h);
+    free(sig);
+    free(sig_ref);
+    free(seeds);
+    return 0;
+}
@@ -0,0 +1,348 @@
+/* Minimal perfect hash function benchmark.
+ *
+ * Builds the function of --count 8-byte keys with xxh3_mphf_build_scalar()
+ * on --threads threads and reports the build time and the image size per
+ * key, then checks that the keys get distinct indices. One row per variant
+ * then times xxh3_mphf_lookup_<variant>() as a chain of dependent lookups,
+ * each key chosen from the previous index ("latency", in nanoseconds), and
+ * xxh3_mphf_lookup_batch_<variant>() over --queries random keys, in million
+ * keys per second. The "bsearch" row is the usual static dictionary around
+ * xxh3_64_scalar(): the sorted hashes of the keys, a key's index being the
+ * rank of its hash, found by binary search.
+ *
+ * Command line (all optional):
+ *   --count=N    keys (default 10000000)
+ *   --queries=N  keys looked up per round (default 1000000)
+ *   --threads=N  build threads, 0 for one per CPU (default 0)
+ *   --rounds=N   passes, the best one is reported (default 3)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime and sigsetjmp under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+
+#include "xxh3.h"
+
+#define KEY_SIZE 8
+
+typedef uint64_t (*lookup_fn)(const xxh3_mphf_t*, const void*, size_t);
+typedef void (*lookup_batch_fn)(const xxh3_mphf_t*, const void* const*, const size_t*, size_t,
+                                uint64_t*);
+
+static size_t   g_count   = 10000000;
+static size_t   g_queries = 1000000;
+static size_t   g_threads = 0;
+static size_t   g_rounds  = 3;
+static uint64_t g_sink;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/* Key of the next dependent lookup after index `prev` */
+static size_t next_key(uint64_t prev, size_t i)
+{
+    uint32_t const x = (uint32_t)((prev + i) * 0x9E3779B97F4A7C15ULL >> 32);
+    return (size_t)(((uint64_t)x * g_count) >> 32);
+}
+
+typedef struct {
+    const uint64_t* ids;       /* g_count keys */
+    const void**    queries;   /* g_queries random keys */
+    size_t*         sizes;     /* g_queries, all KEY_SIZE */
+    uint64_t*       out;       /* g_queries */
+} workload;
+
+/* ------------------------------------------------------------ baseline */
+
+static int cmp_u64(const void* a, const void* b)
+{
+    uint64_t const x = *(const uint64_t*)a;
+    uint64_t const y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t bsearch_rank(const uint64_t* sorted, size_t n, uint64_t h)
+{
+    size_t lo = 0;
+    while (n > 1) {
+        size_t const half = n / 2;
+        lo += (sorted[lo + half - 1] < h) ? half : 0;
+        n -= half;
+    }
+    return lo;
+}
+
+/* Latency in ns and throughput in M keys/s of the sorted-array dictionary */
+static void run_bsearch(const workload* w, double* latency, double* rate)
+{
+    uint64_t* sorted = (uint64_t*)malloc(g_count * sizeof(uint64_t));
+    size_t    r, i;
+
+    if (sorted == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+    for (i = 0; i < g_count; i++) {
+        sorted[i] = xxh3_64_scalar(&w->ids[i], KEY_SIZE, 0);
+    }
+    qsort(sorted, g_count, sizeof(uint64_t), cmp_u64);
+    *latency = *rate = 0;
+    for (r = 0; r < g_rounds; r++) {
+        double   t0, t1, t2;
+        uint64_t prev = 0;
+        t0 = now_sec();
+        for (i = 0; i < g_queries; i++) {
+            const uint64_t* const key = &w->ids[next_key(prev, i)];
+            prev = bsearch_rank(sorted, g_count, xxh3_64_scalar(key, KEY_SIZE, 0));
+        }
+        t1 = now_sec();
+        for (i = 0; i < g_queries; i++) {
+            w->out[i] = bsearch_rank(sorted, g_count, xxh3_64_scalar(w->queries[i], KEY_SIZE, 0));
+        }
+        t2 = now_sec();
+        g_sink += prev + w->out[g_queries - 1];
+        *latency = (r == 0 || t1 - t0 < *latency) ? t1 - t0 : *latency;
+        *rate    = (r == 0 || t2 - t1 < *rate) ? t2 - t1 : *rate;
+    }
+    *latency = *latency / (double)g_queries * 1e9;
+    *rate    = (double)g_queries / *rate / 1e6;
+    free(sorted);
+}
+
+/* ------------------------------------------------------------------ runs */
+
+typedef struct {
+    const char*     name;
+    lookup_fn       lookup;
+    lookup_batch_fn lookup_batch;
+} variant_t;
+
+/* Latency in ns and batch throughput in M keys/s. Returns the number of
+ * batch results that differ from single lookups. */
+static size_t run_variant(const variant_t* v, const xxh3_mphf_t* mphf, const workload* w,
+                          double* latency, double* rate)
+{
+    size_t r, i, diff = 0;
+
+    *latency = *rate = 0;
+    for (r = 0; r < g_rounds; r++) {
+        double   t0, t1, t2;
+        uint64_t prev = 0;
+        t0 = now_sec();
+        for (i = 0; i < g_queries; i++) {
+            prev = v->lookup(mphf, &w->ids[next_key(prev, i)], KEY_SIZE);
+        }
+        t1 = now_sec();
+        v->lookup_batch(mphf, w->queries, w->sizes, g_queries, w->out);
+        t2 = now_sec();
+        g_sink += prev;
+        *latency = (r == 0 || t1 - t0 < *latency) ? t1 - t0 : *latency;
+        *rate    = (r == 0 || t2 - t1 < *rate) ? t2 - t1 : *rate;
+    }
+    for (i = 0; i < g_queries; i += 997) {
+        diff += w->out[i] != v->lookup(mphf, w->queries[i], KEY_SIZE);
+    }
+    *latency = *latency / (double)g_queries * 1e9;
+    *rate    = (double)g_queries / *rate / 1e6;
+    return diff;
+}
+
+/* Probe a variant under a SIGILL/SIGSEGV guard before timing it */
+static sigjmp_buf _bench_jmpbuf;
+static volatile sig_atomic_t _bench_caught_sig;
+
+static void _bench_sig_handler(int sig)
+{
+    _bench_caught_sig = sig;
+    siglongjmp(_bench_jmpbuf, 1);
+}
+
+static int variant_supported(lookup_fn fn, const xxh3_mphf_t* mphf)
+{
+    struct sigaction act, oldill, oldsegv;
+    volatile int     ok = 0;
+
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = _bench_sig_handler;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGILL,  &act, &oldill);
+    sigaction(SIGSEGV, &act, &oldsegv);
+    if (sigsetjmp(_bench_jmpbuf, 1) == 0) {
+        g_sink += fn(mphf, "probe", 5);
+        ok = 1;
+    }
+    sigaction(SIGILL,  &oldill,  NULL);
+    sigaction(SIGSEGV, &oldsegv, NULL);
+    return ok;
+}
+
+/* See bench_variants.c: only reference variants that can exist here */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define X86_FN(fn) fn
+#else
+#  define X86_FN(fn) NULL
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define ARM_FN(fn) fn
+#else
+#  define ARM_FN(fn) NULL
+#endif
+
+#define VARIANT(v, ISA_FN) { #v, ISA_FN(xxh3_mphf_lookup_##v), ISA_FN(xxh3_mphf_lookup_batch_##v) }
+#define SCALAR_FN(fn) fn
+
+static int parse_count(const char* str, size_t* out, int zero_ok)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || (v == 0 && !zero_ok)) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const variant_t variants[] = {
+        VARIANT(scalar, SCALAR_FN), VARIANT(sse2, X86_FN), VARIANT(avx2, X86_FN),
+        VARIANT(avx512, X86_FN),    VARIANT(neon, ARM_FN), VARIANT(sve, ARM_FN),
+    };
+    workload       w;
+    uint64_t*      ids;
+    const void**   keys;
+    size_t*        key_sizes;
+    unsigned char* image;
+    unsigned char* seen;
+    xxh3_mphf_t    mphf;
+    size_t         size, i, r;
+    double         build = 0;
+    int            arg;
+
+    for (arg = 1; arg < argc; arg++) {
+        int ok;
+        if (strncmp(argv[arg], "--count=", 8) == 0) {
+            ok = parse_count(argv[arg] + 8, &g_count, 0);
+        } else if (strncmp(argv[arg], "--queries=", 10) == 0) {
+            ok = parse_count(argv[arg] + 10, &g_queries, 0);
+        } else if (strncmp(argv[arg], "--threads=", 10) == 0) {
+            ok = parse_count(argv[arg] + 10, &g_threads, 1);
+        } else if (strncmp(argv[arg], "--rounds=", 9) == 0) {
+            ok = parse_count(argv[arg] + 9, &g_rounds, 0);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--count=N] [--queries=N] [--threads=N] [--rounds=N]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    size      = xxh3_mphf_size(g_count);
+    ids       = (uint64_t*)malloc(g_count * sizeof(uint64_t));
+    keys      = (const void**)malloc(g_count * sizeof(void*));
+    key_sizes = (size_t*)malloc(g_count * sizeof(size_t));
+    image     = (unsigned char*)malloc(size);
+    if (size == 0 || ids == NULL || keys == NULL || key_sizes == NULL || image == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    /* key i: the id i * 2^64 / phi */
+    for (i = 0; i < g_count; i++) {
+        ids[i]       = (uint64_t)i * 0x9E3779B97F4A7C15ULL;
+        keys[i]      = &ids[i];
+        key_sizes[i] = KEY_SIZE;
+    }
+    for (r = 0; r < g_rounds; r++) {
+        double t = now_sec();
+        if (xxh3_mphf_build_scalar(image, size, keys, key_sizes, g_count, 0, (unsigned)g_threads)
+            != XXH3_OK) {
+            fprintf(stderr, "build failed\n");
+            return 1;
+        }
+        t = now_sec() - t;
+        build = (r == 0 || t < build) ? t : build;
+    }
+    free(key_sizes);
+    free(keys);
+    if (xxh3_mphf_view(&mphf, image, size) != XXH3_OK) {
+        fprintf(stderr, "bad image\n");
+        return 1;
+    }
+    seen = (unsigned char*)calloc(g_count, 1);
+    if (seen == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    for (i = 0; i < g_count; i++) {
+        uint64_t const idx = xxh3_mphf_lookup_scalar(&mphf, &ids[i], KEY_SIZE);
+        if (idx >= g_count || seen[idx]) {
+            fprintf(stderr, "key %lu: index %lu taken or out of range\n", (unsigned long)i,
+                    (unsigned long)idx);
+            return 1;
+        }
+        seen[idx] = 1;
+    }
+    free(seen);
+
+    w.ids     = ids;
+    w.queries = (const void**)malloc(g_queries * sizeof(void*));
+    w.sizes   = (size_t*)malloc(g_queries * sizeof(size_t));
+    w.out     = (uint64_t*)malloc(g_queries * sizeof(uint64_t));
+    if (w.queries == NULL || w.sizes == NULL || w.out == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    for (i = 0; i < g_queries; i++) {
+        w.queries[i] = &ids[next_key(0, i)];
+        w.sizes[i]   = KEY_SIZE;
+    }
+
+    printf("%lu keys, %lu queries, best of %lu rounds\n", (unsigned long)g_count,
+           (unsigned long)g_queries, (unsigned long)g_rounds);
+    printf("build: %.2f s (%.2f M keys/s), %.2f bits per key\n\n", build,
+           (double)g_count / build / 1e6, 8.0 * (double)size / (double)g_count);
+    printf("%-10s %14s %14s\n", "variant", "latency (ns)", "batch (M/s)");
+    {   double latency, rate;
+        run_bsearch(&w, &latency, &rate);
+        printf("%-10s %14.1f %14.2f\n", "bsearch", latency, rate);
+    }
+    for (i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+        double latency, rate;
+
+        if (variants[i].lookup == NULL) {
+            continue;
+        }
+        if (!variant_supported(variants[i].lookup, &mphf)) {
+            printf("%-10s: not supported on this CPU, skipping\n", variants[i].name);
+            continue;
+        }
+        if (run_variant(&variants[i], &mphf, &w, &latency, &rate) != 0) {
+            fprintf(stderr, "%s: batch and single lookups differ\n", variants[i].name);
+            return 1;
+        }
+        printf("%-10s %14.1f %14.2f\n", variants[i].name, latency, rate);
+    }
+    if (g_sink == 42) {
+        printf("\n");
+    }
+
+    free(w.out);
+    free(w.sizes);
+    free(w.queries);
+    free(image);
+    free(ids);
+    return 0;
+}
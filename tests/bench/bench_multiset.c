@@ -0,0 +1,248 @@
+/* Multiset hash benchmark.
+ *
+ * The "rehash" column is what a fingerprint costs without a multiset hash:
+ * xxh3_128_<variant>() over all --count records of --size bytes, laid out
+ * in a fixed order, in milliseconds per fingerprint. The other columns time
+ * the multiset hash of the same records: building it with
+ * xxh3_multiset_add_<variant>() a record at a time ("add") and with
+ * xxh3_multiset_add_batch_<variant>() over all records ("add_n"), in
+ * million records per second, and then replacing records one at a time
+ * (remove the old version, add the new one; "update"), in million updates
+ * per second. Every variant must reach the same digests as the scalar one.
+ *
+ * Command line (all optional):
+ *   --count=N   records (default 1000000)
+ *   --size=N    bytes per record (default 64)
+ *   --rounds=N  passes, the best one is reported (default 3)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime and sigsetjmp under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+
+#include "xxh3.h"
+
+/* Records replaced per round of the update column */
+#define UPDATES 100000
+
+typedef xxh3_128_t (*hash_fn)(const void*, size_t, uint64_t);
+typedef void (*add_fn)(xxh3_multiset_t*, const void*, size_t);
+typedef void (*add_batch_fn)(xxh3_multiset_t*, const void* const*, const size_t*, size_t);
+
+static size_t g_count  = 1000000;
+static size_t g_size   = 64;
+static size_t g_rounds = 3;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+typedef struct {
+    const char*  name;
+    hash_fn      hash;
+    add_fn       add;
+    add_fn       remove;
+    add_batch_fn add_batch;
+} variant_t;
+
+/* rate[0] rehash in ms, rate[1] add and rate[2] add batch in M records/s,
+ * rate[3] update in M updates/s; digest[0..2] after add, add batch and the
+ * updates. The updates flip byte 0 of records and flip it back after. */
+static void run_variant(const variant_t* v, unsigned char* records, const void* const* ptrs,
+                        const size_t* sizes, double rate[4], xxh3_128_t digest[3])
+{
+    double best[4] = { 0, 0, 0, 0 };
+    size_t r, i;
+
+    for (r = 0; r < g_rounds; r++) {
+        xxh3_multiset_t set[2];
+        double          t[4];
+        xxh3_128_t      h;
+
+        t[0] = now_sec();
+        h = v->hash(records, g_count * g_size, 0);
+        t[0] = now_sec() - t[0];
+        (void)h;
+        xxh3_multiset_init(&set[0], 0);
+        xxh3_multiset_init(&set[1], 0);
+        t[1] = now_sec();
+        for (i = 0; i < g_count; i++) {
+            v->add(&set[0], ptrs[i], g_size);
+        }
+        t[1] = now_sec() - t[1];
+        t[2] = now_sec();
+        v->add_batch(&set[1], ptrs, sizes, g_count);
+        t[2] = now_sec() - t[2];
+        digest[0] = xxh3_multiset_digest(&set[0]);
+        digest[1] = xxh3_multiset_digest(&set[1]);
+        t[3] = now_sec();
+        for (i = 0; i < UPDATES; i++) {
+            unsigned char* const rec = records + (i * 7919 % g_count) * g_size;
+            v->remove(&set[0], rec, g_size);
+            rec[0] ^= 1;
+            v->add(&set[0], rec, g_size);
+        }
+        t[3] = now_sec() - t[3];
+        digest[2] = xxh3_multiset_digest(&set[0]);
+        for (i = 0; i < UPDATES; i++) {
+            records[(i * 7919 % g_count) * g_size] ^= 1;
+        }
+        for (i = 0; i < 4; i++) {
+            best[i] = (r == 0 || t[i] < best[i]) ? t[i] : best[i];
+        }
+    }
+    rate[0] = best[0] * 1e3;
+    rate[1] = (double)g_count / best[1] / 1e6;
+    rate[2] = (double)g_count / best[2] / 1e6;
+    rate[3] = (double)UPDATES / best[3] / 1e6;
+}
+
+/* Probe a variant under a SIGILL/SIGSEGV guard before timing it */
+static sigjmp_buf _bench_jmpbuf;
+static volatile sig_atomic_t _bench_caught_sig;
+
+static void _bench_sig_handler(int sig)
+{
+    _bench_caught_sig = sig;
+    siglongjmp(_bench_jmpbuf, 1);
+}
+
+static int variant_supported(add_fn fn)
+{
+    xxh3_multiset_t  set;
+    struct sigaction act, oldill, oldsegv;
+    volatile int     ok = 0;
+
+    xxh3_multiset_init(&set, 0);
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = _bench_sig_handler;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGILL,  &act, &oldill);
+    sigaction(SIGSEGV, &act, &oldsegv);
+    if (sigsetjmp(_bench_jmpbuf, 1) == 0) {
+        fn(&set, "probe", 5);
+        ok = 1;
+    }
+    sigaction(SIGILL,  &oldill,  NULL);
+    sigaction(SIGSEGV, &oldsegv, NULL);
+    return ok;
+}
+
+/* See bench_variants.c: only reference variants that can exist here */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define X86_FN(fn) fn
+#else
+#  define X86_FN(fn) NULL
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define ARM_FN(fn) fn
+#else
+#  define ARM_FN(fn) NULL
+#endif
+
+#define VARIANT(v, ISA_FN) { #v, ISA_FN(xxh3_128_##v), ISA_FN(xxh3_multiset_add_##v), \
+                             ISA_FN(xxh3_multiset_remove_##v), ISA_FN(xxh3_multiset_add_batch_##v) }
+#define SCALAR_FN(fn) fn
+
+static int parse_count(const char* str, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || v == 0) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const variant_t variants[] = {
+        VARIANT(scalar, SCALAR_FN), VARIANT(sse2, X86_FN), VARIANT(avx2, X86_FN),
+        VARIANT(avx512, X86_FN),    VARIANT(neon, ARM_FN), VARIANT(sve, ARM_FN),
+    };
+    unsigned char* records;
+    const void**   ptrs;
+    size_t*        sizes;
+    xxh3_128_t     ref[3];
+    size_t         i;
+    int            arg;
+
+    for (arg = 1; arg < argc; arg++) {
+        int ok;
+        if (strncmp(argv[arg], "--count=", 8) == 0) {
+            ok = parse_count(argv[arg] + 8, &g_count);
+        } else if (strncmp(argv[arg], "--size=", 7) == 0) {
+            ok = parse_count(argv[arg] + 7, &g_size);
+        } else if (strncmp(argv[arg], "--rounds=", 9) == 0) {
+            ok = parse_count(argv[arg] + 9, &g_rounds);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--count=N] [--size=N] [--rounds=N]\n", argv[0]);
+            return 2;
+        }
+    }
+    records = (unsigned char*)malloc(g_count * g_size);
+    ptrs    = (const void**)malloc(g_count * sizeof(void*));
+    sizes   = (size_t*)malloc(g_count * sizeof(size_t));
+    if (records == NULL || ptrs == NULL || sizes == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    for (i = 0; i < g_count * g_size; i++) {
+        records[i] = (unsigned char)(i * 2654435761U >> 24);
+    }
+    for (i = 0; i < g_count; i++) {
+        ptrs[i]  = records + i * g_size;
+        sizes[i] = g_size;
+    }
+
+    printf("%lu records of %lu bytes, best of %lu rounds\n\n", (unsigned long)g_count,
+           (unsigned long)g_size, (unsigned long)g_rounds);
+    printf("%-10s %12s %12s %12s %12s\n", "variant", "rehash (ms)", "add (M/s)", "add_n (M/s)",
+           "update (M/s)");
+    for (i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+        double     rate[4];
+        xxh3_128_t digest[3];
+        size_t     j;
+
+        if (variants[i].add == NULL) {
+            continue;
+        }
+        if (!variant_supported(variants[i].add)) {
+            printf("%-10s: not supported on this CPU, skipping\n", variants[i].name);
+            continue;
+        }
+        run_variant(&variants[i], records, ptrs, sizes, rate, digest);
+        if (i == 0) {
+            memcpy(ref, digest, sizeof(ref));
+        }
+        for (j = 0; j < 3; j++) {
+            if (digest[j].high != ref[j].high || digest[j].low != ref[j].low
+                || digest[1].high != digest[0].high || digest[1].low != digest[0].low) {
+                fprintf(stderr, "%s: digests differ from the scalar ones\n", variants[i].name);
+                return 1;
+            }
+        }
+        printf("%-10s %12.3f %12.2f %12.2f %12.2f\n", variants[i].name, rate[0], rate[1], rate[2],
+               rate[3]);
+    }
+
+    free(sizes);
+    free(ptrs);
+    free(records);
+    return 0;
+}
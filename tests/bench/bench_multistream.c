@@ -0,0 +1,278 @@
+/* Many-connection streaming benchmark for the lockstep multi-stream update.
+ *
+ * Models a proxy with one running XXH3 stream per connection: each packet
+ * goes to a random connection, so the states (and the packets, drawn from a
+ * large pool) are cache-cold. The same packet sequence is applied
+ *   - one xxh3_64_update() call per packet, and
+ *   - xxh3_64_update_multi_<variant>() over batches of --batch packets,
+ * and reported in million packets per second. The final digests of both
+ * runs must agree.
+ *
+ * Command line (all optional):
+ *   --conns=N    connections / streams (default 100000)
+ *   --packets=N  packets per run (default 2000000)
+ *   --batch=N    packets per update_multi call (default 64)
+ *   --size=B     fixed packet size in bytes (default: mix of 64, 576, 1500)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime and sigsetjmp under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+
+#include "xxh3.h"
+
+typedef int (*update_multi_fn)(const xxh3_stream_update_t*, size_t);
+
+#define POOL_SIZE ((size_t)64 << 20)   /* packet payloads, larger than the LLC */
+
+static size_t g_conns   = 100000;
+static size_t g_packets = 2000000;
+static size_t g_batch   = 64;
+static size_t g_size    = 0;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/* ------------------------------------------------------------------ traffic */
+
+typedef struct {
+    uint32_t conn;
+    uint32_t size;
+    size_t   offset;   /* into the packet pool */
+} packet_t;
+
+static packet_t* make_traffic(void)
+{
+    static const uint32_t mix[] = { 64, 64, 64, 64, 576, 576, 576, 1500, 1500, 1500 };
+    packet_t* t = (packet_t*)malloc(g_packets * sizeof(packet_t));
+    uint64_t  rng = 0x9E3779B97F4A7C15ULL;
+    size_t    i;
+
+    if (t == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < g_packets; i++) {
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+        t[i].conn   = (uint32_t)(rng % g_conns);
+        t[i].size   = g_size ? (uint32_t)g_size : mix[(rng >> 32) % 10];
+        t[i].offset = (size_t)(rng >> 20) % (POOL_SIZE - t[i].size);
+    }
+    return t;
+}
+
+static void reset_all(xxh3_state_t** states)
+{
+    size_t i;
+    for (i = 0; i < g_conns; i++) {
+        xxh3_64_reset(states[i], (uint64_t)i);
+    }
+}
+
+static uint64_t digest_all(xxh3_state_t** states)
+{
+    uint64_t sum = 0;
+    size_t   i;
+    for (i = 0; i < g_conns; i++) {
+        sum += xxh3_64_digest(states[i]) * (2 * i + 1);
+    }
+    return sum;
+}
+
+/* ------------------------------------------------------------------ runs */
+
+static double run_single(xxh3_state_t** states, const packet_t* t, const unsigned char* pool)
+{
+    double t0, t1;
+    size_t i;
+
+    t0 = now_sec();
+    for (i = 0; i < g_packets; i++) {
+        (void)xxh3_64_update(states[t[i].conn], pool + t[i].offset, t[i].size);
+    }
+    t1 = now_sec();
+    return (double)g_packets / (t1 - t0) / 1e6;
+}
+
+static double run_multi(update_multi_fn fn, xxh3_state_t** states, const packet_t* t,
+                        const unsigned char* pool, xxh3_stream_update_t* batch)
+{
+    double t0, t1;
+    size_t i, j, n;
+
+    t0 = now_sec();
+    for (i = 0; i < g_packets; i += n) {
+        n = (g_packets - i < g_batch) ? g_packets - i : g_batch;
+        for (j = 0; j < n; j++) {
+            batch[j].state = states[t[i + j].conn];
+            batch[j].input = pool + t[i + j].offset;
+            batch[j].size  = t[i + j].size;
+        }
+        (void)fn(batch, n);
+    }
+    t1 = now_sec();
+    return (double)g_packets / (t1 - t0) / 1e6;
+}
+
+/* Probe a variant under a SIGILL/SIGSEGV guard before timing it */
+static sigjmp_buf _bench_jmpbuf;
+static volatile sig_atomic_t _bench_caught_sig;
+
+static void _bench_sig_handler(int sig)
+{
+    _bench_caught_sig = sig;
+    siglongjmp(_bench_jmpbuf, 1);
+}
+
+static int variant_supported(update_multi_fn fn, xxh3_state_t* scratch)
+{
+    static unsigned char probe[1024];
+    xxh3_stream_update_t u;
+    struct sigaction act, oldill, oldsegv;
+    volatile int ok = 0;
+
+    u.state = scratch;
+    u.input = probe;
+    u.size  = sizeof(probe);
+    xxh3_64_reset(scratch, 0);
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = _bench_sig_handler;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGILL,  &act, &oldill);
+    sigaction(SIGSEGV, &act, &oldsegv);
+    if (sigsetjmp(_bench_jmpbuf, 1) == 0) {
+        (void)fn(&u, 1);
+        ok = 1;
+    }
+    sigaction(SIGILL,  &oldill,  NULL);
+    sigaction(SIGSEGV, &oldsegv, NULL);
+    return ok;
+}
+
+/* See bench_variants.c: only reference variants that can exist here */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define X86_FN(fn) fn
+#else
+#  define X86_FN(fn) NULL
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define ARM_FN(fn) fn
+#else
+#  define ARM_FN(fn) NULL
+#endif
+
+static int parse_count(const char* str, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || v == 0) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const struct { const char* name; update_multi_fn fn; } variants[] = {
+        { "scalar", xxh3_64_update_multi_scalar },
+        { "sse2",   X86_FN(xxh3_64_update_multi_sse2) },
+        { "avx2",   X86_FN(xxh3_64_update_multi_avx2) },
+        { "avx512", X86_FN(xxh3_64_update_multi_avx512) },
+        { "neon",   ARM_FN(xxh3_64_update_multi_neon) },
+        { "sve",    ARM_FN(xxh3_64_update_multi_sve) },
+    };
+    xxh3_state_t**        states;
+    xxh3_stream_update_t* batch;
+    unsigned char*        pool;
+    packet_t*             traffic;
+    double                single;
+    uint64_t              ref;
+    size_t                i;
+    int                   a;
+
+    for (a = 1; a < argc; a++) {
+        int ok;
+        if (strncmp(argv[a], "--conns=", 8) == 0) {
+            ok = parse_count(argv[a] + 8, &g_conns);
+        } else if (strncmp(argv[a], "--packets=", 10) == 0) {
+            ok = parse_count(argv[a] + 10, &g_packets);
+        } else if (strncmp(argv[a], "--batch=", 8) == 0) {
+            ok = parse_count(argv[a] + 8, &g_batch);
+        } else if (strncmp(argv[a], "--size=", 7) == 0) {
+            ok = parse_count(argv[a] + 7, &g_size) && g_size < 65536;
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--conns=N] [--packets=N] [--batch=N] [--size=B]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    states  = (xxh3_state_t**)calloc(g_conns, sizeof(xxh3_state_t*));
+    batch   = (xxh3_stream_update_t*)malloc(g_batch * sizeof(xxh3_stream_update_t));
+    pool    = (unsigned char*)malloc(POOL_SIZE);
+    traffic = make_traffic();
+    if (states == NULL || batch == NULL || pool == NULL || traffic == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    for (i = 0; i < g_conns; i++) {
+        states[i] = xxh3_createState();
+        if (states[i] == NULL) {
+            fprintf(stderr, "allocation failed\n");
+            return 1;
+        }
+    }
+    for (i = 0; i < POOL_SIZE; i++) {
+        pool[i] = (unsigned char)(i * 2654435761u >> 24);
+    }
+
+    reset_all(states);
+    single = run_single(states, traffic, pool);
+    ref = digest_all(states);
+    printf("%lu connections, %lu packets (%s), batches of %lu\n\n",
+           (unsigned long)g_conns, (unsigned long)g_packets,
+           g_size ? "fixed size" : "64/576/1500 B mix", (unsigned long)g_batch);
+    printf("%-10s %14s %8s\n", "variant", "Mpackets/s", "speedup");
+    printf("%-10s %14.2f %8s\n", "update", single, "-");
+
+    for (i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+        double multi;
+        if (variants[i].fn == NULL) {
+            continue;
+        }
+        if (!variant_supported(variants[i].fn, states[0])) {
+            printf("%-10s: not supported on this CPU, skipping\n", variants[i].name);
+            continue;
+        }
+        reset_all(states);
+        multi = run_multi(variants[i].fn, states, traffic, pool, batch);
+        if (digest_all(states) != ref) {
+            fprintf(stderr, "%s: digests differ from per-packet updates\n", variants[i].name);
+            return 1;
+        }
+        printf("%-10s %14.2f %7.2fx\n", variants[i].name, multi, multi / single);
+    }
+
+    for (i = 0; i < g_conns; i++) {
+        xxh3_freeState(states[i]);
+    }
+    free(states);
+    free(batch);
+    free(pool);
+    free(traffic);
+    return 0;
+}
@@ -0,0 +1,292 @@
+/* Cache-pollution benchmark for the non-temporal XXH3 variants.
+ *
+ * A "victim" thread pointer-chases a random cycle over a cache-resident
+ * working set (default 4 MiB) while the main thread hashes a buffer much
+ * larger than the LLC (default 1 GiB), once with the regular variant and once
+ * with its `_nt` counterpart. Reported per variant:
+ *   - hash throughput of the main thread (MB/s)
+ *   - victim latency per load, and its slowdown against the victim alone
+ *
+ * A smaller victim slowdown for `_nt` at equal hash throughput is the point
+ * of the non-temporal mode. Run with the victim on a core sharing the LLC
+ * with the hashing thread (the default on a single-socket machine).
+ *
+ * Command line (all optional):
+ *   --size=BYTES[K|M|G]    hashed buffer (default 1G)
+ *   --victim=BYTES[K|M|G]  victim working set (default 4M)
+ *   --passes=N             hashes of the buffer per measurement (default 3)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime, sigsetjmp and pthreads under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+#include <pthread.h>
+
+#include "xxh3.h"
+
+typedef uint64_t (*hash_fn)(const void*, size_t, uint64_t);
+
+static size_t g_size   = (size_t)1 << 30;
+static size_t g_victim = (size_t)4 << 20;
+static int    g_passes = 3;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/* ------------------------------------------------------------------ victim */
+
+#define VICTIM_LINE 64
+
+typedef struct {
+    size_t* chain;        /* chain[i] = index of the next line, one cycle */
+    size_t  lines;
+    volatile int stop;
+    double  ns_per_load;  /* result */
+} victim_t;
+
+/* Sattolo's algorithm: a uniformly random single cycle over all lines, so
+ * the chase visits the whole working set and defeats the prefetchers. */
+static int victim_init(victim_t* v, size_t bytes)
+{
+    const size_t stride = VICTIM_LINE / sizeof(size_t);
+    size_t* order;
+    size_t  i;
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+
+    v->lines = bytes / VICTIM_LINE;
+    if (v->lines < 2) {
+        v->lines = 2;
+    }
+    v->chain = (size_t*)malloc(v->lines * VICTIM_LINE);
+    order = (size_t*)malloc(v->lines * sizeof(size_t));
+    if (v->chain == NULL || order == NULL) {
+        free(v->chain);
+        free(order);
+        return 0;
+    }
+    for (i = 0; i < v->lines; i++) {
+        order[i] = i;
+    }
+    for (i = v->lines - 1; i > 0; i--) {
+        size_t j, t;
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+        j = (size_t)(rng % i);
+        t = order[i]; order[i] = order[j]; order[j] = t;
+    }
+    for (i = 0; i < v->lines; i++) {
+        v->chain[order[i] * stride] = order[(i + 1) % v->lines] * stride;
+    }
+    free(order);
+    return 1;
+}
+
+static void* victim_run(void* arg)
+{
+    victim_t* v = (victim_t*)arg;
+    const size_t* chain = v->chain;
+    size_t  p = 0;
+    size_t  i;
+    uint64_t loads = 0;
+    double  t0, t1;
+
+    for (i = 0; i < v->lines; i++) {   /* warm the working set */
+        p = chain[p];
+    }
+    t0 = now_sec();
+    while (!v->stop) {
+        for (i = 0; i < 4096; i++) {
+            p = chain[p];
+        }
+        loads += 4096;
+    }
+    t1 = now_sec();
+    v->ns_per_load = (t1 - t0) * 1e9 / (double)loads;
+    if (p == (size_t)-1) {             /* keep the chase observable */
+        printf("%lu\n", (unsigned long)p);
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ runs */
+
+/* Hash the buffer g_passes times with the victim running; returns MB/s */
+static double run_with_victim(victim_t* v, hash_fn fn, const unsigned char* data, uint64_t* sink)
+{
+    pthread_t th;
+    double t0, t1;
+    int i;
+
+    v->stop = 0;
+    if (pthread_create(&th, NULL, victim_run, v) != 0) {
+        return 0.0;
+    }
+    t0 = now_sec();
+    for (i = 0; i < g_passes; i++) {
+        *sink += fn(data, g_size, (uint64_t)i);
+    }
+    t1 = now_sec();
+    v->stop = 1;
+    pthread_join(th, NULL);
+    return (double)g_size * g_passes / (t1 - t0) / (1024.0 * 1024.0);
+}
+
+static double victim_alone(victim_t* v)
+{
+    pthread_t th;
+    struct timespec ts = { 0, 500000000 };
+
+    v->stop = 0;
+    if (pthread_create(&th, NULL, victim_run, v) != 0) {
+        return 0.0;
+    }
+    nanosleep(&ts, NULL);
+    v->stop = 1;
+    pthread_join(th, NULL);
+    return v->ns_per_load;
+}
+
+/* Probe a variant on the main thread under a SIGILL/SIGSEGV guard before it
+ * runs alongside the victim thread. */
+static sigjmp_buf _bench_jmpbuf;
+static volatile sig_atomic_t _bench_caught_sig;
+
+static void _bench_sig_handler(int sig)
+{
+    _bench_caught_sig = sig;
+    siglongjmp(_bench_jmpbuf, 1);
+}
+
+static int variant_supported(hash_fn fn)
+{
+    static unsigned char probe[1024];
+    struct sigaction act, oldill, oldsegv;
+    volatile int ok = 0;
+
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = _bench_sig_handler;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGILL,  &act, &oldill);
+    sigaction(SIGSEGV, &act, &oldsegv);
+    if (sigsetjmp(_bench_jmpbuf, 1) == 0) {
+        (void)fn(probe, sizeof(probe), 0);
+        ok = 1;
+    }
+    sigaction(SIGILL,  &oldill,  NULL);
+    sigaction(SIGSEGV, &oldsegv, NULL);
+    return ok;
+}
+
+/* See bench_variants.c: only reference variants that can exist here */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define X86_FN(fn) fn
+#else
+#  define X86_FN(fn) NULL
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define ARM_FN(fn) fn
+#else
+#  define ARM_FN(fn) NULL
+#endif
+
+static int parse_bytes(const char* str, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    switch (*end) {
+    case 'G': case 'g': v <<= 10; /* fall through */
+    case 'M': case 'm': v <<= 10; /* fall through */
+    case 'K': case 'k': v <<= 10; end++; break;
+    default: break;
+    }
+    if (end == str || *end != '\0' || v == 0) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const struct { const char* name; hash_fn fn; hash_fn fn_nt; } variants[] = {
+        { "scalar", xxh3_64_scalar,         xxh3_64_nt_scalar },
+        { "sse2",   X86_FN(xxh3_64_sse2),   X86_FN(xxh3_64_nt_sse2) },
+        { "avx2",   X86_FN(xxh3_64_avx2),   X86_FN(xxh3_64_nt_avx2) },
+        { "avx512", X86_FN(xxh3_64_avx512), X86_FN(xxh3_64_nt_avx512) },
+        { "neon",   ARM_FN(xxh3_64_neon),   ARM_FN(xxh3_64_nt_neon) },
+        { "sve",    ARM_FN(xxh3_64_sve),    ARM_FN(xxh3_64_nt_sve) },
+    };
+    victim_t victim;
+    unsigned char* data;
+    double base_ns;
+    uint64_t sink = 0;
+    size_t i;
+    int a;
+
+    for (a = 1; a < argc; a++) {
+        int ok;
+        if (strncmp(argv[a], "--size=", 7) == 0) {
+            ok = parse_bytes(argv[a] + 7, &g_size);
+        } else if (strncmp(argv[a], "--victim=", 9) == 0) {
+            ok = parse_bytes(argv[a] + 9, &g_victim);
+        } else if (strncmp(argv[a], "--passes=", 9) == 0) {
+            g_passes = atoi(argv[a] + 9);
+            ok = g_passes > 0;
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--size=BYTES] [--victim=BYTES] [--passes=N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    data = (unsigned char*)malloc(g_size);
+    if (data == NULL || !victim_init(&victim, g_victim)) {
+        fprintf(stderr, "allocation failed\n");
+        free(data);
+        return 1;
+    }
+    memset(data, 7, g_size);
+
+    base_ns = victim_alone(&victim);
+    printf("hashed %lu MiB x %d, victim working set %lu KiB\n",
+           (unsigned long)(g_size >> 20), g_passes, (unsigned long)(g_victim >> 10));
+    printf("victim alone: %.2f ns/load\n\n", base_ns);
+    printf("%-10s %12s %14s %10s\n", "variant", "hash MB/s", "victim ns/ld", "slowdown");
+
+    for (i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+        char name[32];
+        int nt;
+        if (variants[i].fn == NULL) {
+            continue;
+        }
+        if (!variant_supported(variants[i].fn) || !variant_supported(variants[i].fn_nt)) {
+            printf("%-10s: not supported on this CPU, skipping\n", variants[i].name);
+            continue;
+        }
+        for (nt = 0; nt < 2; nt++) {
+            double mbps = run_with_victim(&victim, nt ? variants[i].fn_nt : variants[i].fn,
+                                          data, &sink);
+            snprintf(name, sizeof(name), "%s%s", variants[i].name, nt ? "_nt" : "");
+            printf("%-10s %12.1f %14.2f %9.1f%%\n", name, mbps, victim.ns_per_load,
+                   (victim.ns_per_load / base_ns - 1.0) * 100.0);
+        }
+    }
+
+    printf("\n(checksum %016llx)\n", (unsigned long long)sink);
+    free(victim.chain);
+    free(data);
+    return 0;
+}
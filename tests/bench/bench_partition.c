@@ -0,0 +1,285 @@
+/* Hash partitioning benchmark.
+ *
+ * Partitions --count rows of 8-byte keys with row-id payloads into 2^bits
+ * partitions, for each --bits, and reports million rows per second. The
+ * "direct" row is the naive partition phase around xxh3_64_scalar(): a
+ * pass that counts the rows of every partition, then a pass that rehashes
+ * each key and stores its tuple straight to its partition. The other rows
+ * time xxh3_partition_<variant>() on the same fixed-width column ("fixed")
+ * and xxh3_partition_var_<variant>() on pointers to its keys ("var"), on
+ * --threads threads. Every variant must write the same tuples and
+ * histogram as the direct one.
+ *
+ * Command line (all optional):
+ *   --count=N    rows (default 16777216)
+ *   --bits=N     partition bits, repeatable (default 6, 10 and 14)
+ *   --threads=N  threads, 0 for one per CPU (default 0)
+ *   --rounds=N   passes, the best one is reported (default 3)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime and sigsetjmp under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+
+#include "xxh3.h"
+
+#define KEY_SIZE 8
+
+typedef int (*partition_fn)(xxh3_partition_tuple_t*, size_t*, const void*, size_t, const uint64_t*,
+                            size_t, unsigned, uint64_t, unsigned);
+typedef int (*partition_var_fn)(xxh3_partition_tuple_t*, size_t*, const void* const*,
+                                const size_t*, const uint64_t*, size_t, unsigned, uint64_t,
+                                unsigned);
+
+static size_t g_count   = 16777216;
+static size_t g_threads = 0;
+static size_t g_rounds  = 3;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+typedef struct {
+    const uint64_t*         keys;
+    const void**            ptrs;
+    size_t*                 sizes;
+    xxh3_partition_tuple_t* dst;     /* 64-byte aligned */
+    size_t*                 hist;
+    size_t*                 cursor;
+} workload;
+
+/* The naive partition phase, in M rows/s */
+static double run_direct(const workload* w, unsigned bits)
+{
+    size_t const parts = (size_t)1 << bits;
+    double       best  = 0;
+    size_t       r, i, p, sum;
+
+    for (r = 0; r < g_rounds; r++) {
+        double t = now_sec();
+        memset(w->hist, 0, parts * sizeof(size_t));
+        for (i = 0; i < g_count; i++) {
+            w->hist[(xxh3_64_scalar(&w->keys[i], KEY_SIZE, 0) >> 1) >> (63 - bits)]++;
+        }
+        for (p = 0, sum = 0; p < parts; p++) {
+            w->cursor[p] = sum;
+            sum += w->hist[p];
+        }
+        for (i = 0; i < g_count; i++) {
+            uint64_t const h = xxh3_64_scalar(&w->keys[i], KEY_SIZE, 0);
+            xxh3_partition_tuple_t* const out = &w->dst[w->cursor[(h >> 1) >> (63 - bits)]++];
+            out->hash    = h;
+            out->payload = i;
+        }
+        t = now_sec() - t;
+        best = (r == 0 || t < best) ? t : best;
+    }
+    return (double)g_count / best / 1e6;
+}
+
+typedef struct {
+    const char*      name;
+    partition_fn     fixed;
+    partition_var_fn var;
+} variant_t;
+
+/* M rows/s of the fixed and variable-width forms; 0 if the output differs
+ * from `ref` and `ref_hist` */
+static void run_variant(const variant_t* v, const workload* w, unsigned bits,
+                        const xxh3_partition_tuple_t* ref, const size_t* ref_hist, double rate[2])
+{
+    size_t const parts = (size_t)1 << bits;
+    size_t       r, f;
+
+    for (f = 0; f < 2; f++) {
+        double best = 0;
+        for (r = 0; r < g_rounds; r++) {
+            double t = now_sec();
+            int    status;
+            if (f == 0) {
+                status = v->fixed(w->dst, w->hist, w->keys, KEY_SIZE, NULL, g_count, bits, 0,
+                                  (unsigned)g_threads);
+            } else {
+                status = v->var(w->dst, w->hist, (const void* const*)w->ptrs, w->sizes, NULL,
+                                g_count, bits, 0, (unsigned)g_threads);
+            }
+            t = now_sec() - t;
+            if (status != XXH3_OK) {
+                fprintf(stderr, "%s: partitioning failed\n", v->name);
+                exit(1);
+            }
+            best = (r == 0 || t < best) ? t : best;
+        }
+        rate[f] = (memcmp(w->dst, ref, g_count * sizeof(*ref)) == 0
+                   && memcmp(w->hist, ref_hist, parts * sizeof(size_t)) == 0)
+                ? (double)g_count / best / 1e6 : 0;
+    }
+}
+
+/* Probe a variant under a SIGILL/SIGSEGV guard before timing it */
+static sigjmp_buf _bench_jmpbuf;
+static volatile sig_atomic_t _bench_caught_sig;
+
+static void _bench_sig_handler(int sig)
+{
+    _bench_caught_sig = sig;
+    siglongjmp(_bench_jmpbuf, 1);
+}
+
+static int variant_supported(partition_fn fn)
+{
+    xxh3_partition_tuple_t dst[8];
+    size_t                 hist[2];
+    uint64_t               keys[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    struct sigaction       act, oldill, oldsegv;
+    volatile int           ok = 0;
+
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = _bench_sig_handler;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGILL,  &act, &oldill);
+    sigaction(SIGSEGV, &act, &oldsegv);
+    if (sigsetjmp(_bench_jmpbuf, 1) == 0) {
+        ok = fn(dst, hist, keys, KEY_SIZE, NULL, 8, 1, 0, 1) == XXH3_OK;
+    }
+    sigaction(SIGILL,  &oldill,  NULL);
+    sigaction(SIGSEGV, &oldsegv, NULL);
+    return ok;
+}
+
+/* See bench_variants.c: only reference variants that can exist here */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define X86_FN(fn) fn
+#else
+#  define X86_FN(fn) NULL
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define ARM_FN(fn) fn
+#else
+#  define ARM_FN(fn) NULL
+#endif
+
+#define VARIANT(v, ISA_FN) { #v, ISA_FN(xxh3_partition_##v), ISA_FN(xxh3_partition_var_##v) }
+#define SCALAR_FN(fn) fn
+
+static int parse_count(const char* str, size_t* out, int zero_ok)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || (v == 0 && !zero_ok)) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const variant_t variants[] = {
+        VARIANT(scalar, SCALAR_FN), VARIANT(sse2, X86_FN), VARIANT(avx2, X86_FN),
+        VARIANT(avx512, X86_FN),    VARIANT(neon, ARM_FN), VARIANT(sve, ARM_FN),
+    };
+    unsigned                bits[16] = { 6, 10, 14 };
+    size_t                  nbits = 3, b, i;
+    int                     bits_given = 0;
+    uint64_t*               keys;
+    unsigned char*          dst_block;
+    xxh3_partition_tuple_t* ref;
+    size_t*                 ref_hist;
+    workload                w;
+    int                     arg;
+
+    for (arg = 1; arg < argc; arg++) {
+        int ok;
+        if (strncmp(argv[arg], "--count=", 8) == 0) {
+            ok = parse_count(argv[arg] + 8, &g_count, 0);
+        } else if (strncmp(argv[arg], "--bits=", 7) == 0) {
+            size_t v;
+            nbits = bits_given ? nbits : 0;
+            ok = parse_count(argv[arg] + 7, &v, 1) && v <= 16 && nbits < 16;
+            if (ok) {
+                bits[nbits++] = (unsigned)v;
+                bits_given    = 1;
+            }
+        } else if (strncmp(argv[arg], "--threads=", 10) == 0) {
+            ok = parse_count(argv[arg] + 10, &g_threads, 1);
+        } else if (strncmp(argv[arg], "--rounds=", 9) == 0) {
+            ok = parse_count(argv[arg] + 9, &g_rounds, 0);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--count=N] [--bits=N]... [--threads=N] [--rounds=N]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    keys      = (uint64_t*)malloc(g_count * sizeof(uint64_t));
+    w.ptrs    = (const void**)malloc(g_count * sizeof(void*));
+    w.sizes   = (size_t*)malloc(g_count * sizeof(size_t));
+    dst_block = (unsigned char*)malloc(g_count * sizeof(xxh3_partition_tuple_t) + 63);
+    ref       = (xxh3_partition_tuple_t*)malloc(g_count * sizeof(xxh3_partition_tuple_t));
+    ref_hist  = (size_t*)malloc(((size_t)1 << 16) * sizeof(size_t));
+    w.hist    = (size_t*)malloc(((size_t)1 << 16) * sizeof(size_t));
+    w.cursor  = (size_t*)malloc(((size_t)1 << 16) * sizeof(size_t));
+    if (keys == NULL || w.ptrs == NULL || w.sizes == NULL || dst_block == NULL || ref == NULL
+        || ref_hist == NULL || w.hist == NULL || w.cursor == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    for (i = 0; i < g_count; i++) {
+        keys[i]    = (uint64_t)i * 0x9E3779B97F4A7C15ULL;
+        w.ptrs[i]  = &keys[i];
+        w.sizes[i] = KEY_SIZE;
+    }
+    w.keys = keys;
+    w.dst  = (xxh3_partition_tuple_t*)(void*)(dst_block + (64 - (size_t)dst_block % 64) % 64);
+    memset(w.dst, 0, g_count * sizeof(xxh3_partition_tuple_t));
+
+    printf("%lu rows of %d-byte keys, %lu threads (0: one per CPU), best of %lu rounds\n",
+           (unsigned long)g_count, KEY_SIZE, (unsigned long)g_threads, (unsigned long)g_rounds);
+    for (b = 0; b < nbits; b++) {
+        printf("\n%u bits (%lu partitions)\n", bits[b], (unsigned long)1 << bits[b]);
+        printf("%-10s %14s %14s\n", "variant", "fixed (M/s)", "var (M/s)");
+        printf("%-10s %14.2f %14s\n", "direct", run_direct(&w, bits[b]), "-");
+        memcpy(ref, w.dst, g_count * sizeof(*ref));
+        memcpy(ref_hist, w.hist, ((size_t)1 << bits[b]) * sizeof(size_t));
+        for (i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+            double rate[2];
+            if (variants[i].fixed == NULL) {
+                continue;
+            }
+            if (!variant_supported(variants[i].fixed)) {
+                printf("%-10s: not supported on this CPU, skipping\n", variants[i].name);
+                continue;
+            }
+            run_variant(&variants[i], &w, bits[b], ref, ref_hist, rate);
+            if (rate[0] == 0 || rate[1] == 0) {
+                fprintf(stderr, "%s: tuples differ from the direct ones\n", variants[i].name);
+                return 1;
+            }
+            printf("%-10s %14.2f %14.2f\n", variants[i].name, rate[0], rate[1]);
+        }
+    }
+
+    free(w.cursor);
+    free(w.hist);
+    free(ref_hist);
+    free(ref);
+    free(dst_block);
+    free(w.sizes);
+    free(w.ptrs);
+    free(keys);
+    return 0;
+}
@@ -0,0 +1,165 @@
+/* Digest sort and dedup benchmark for xxh3_128_sort / xxh3_128_unique.
+ *
+ * Models a dedup pipeline: --count xxh3_128 digests, --dups percent of which
+ * repeat an earlier digest, sorted and then deduplicated. Times
+ *   - qsort() with xxh3_128_cmp, the usual way to do it
+ *   - xxh3_128_sort()
+ *   - xxh3_128_sort_mt() on --threads threads
+ *   - xxh3_128_unique() on the sorted array
+ * and reports million digests per second. Every sort must produce the same
+ * array as qsort().
+ *
+ * Command line (all optional):
+ *   --count=N    digests (default 1000000)
+ *   --dups=P     percent of digests that repeat an earlier one (default 0)
+ *   --threads=N  threads for xxh3_128_sort_mt (default 0: one per CPU)
+ *   --rounds=N   repetitions, the best one is reported (default 5)
+ */
+/* _POSIX_C_SOURCE 200112L: clock_gettime under -std=c99 */
+#if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 200112L
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "xxh3.h"
+
+static size_t g_count   = 1000000;
+static size_t g_dups    = 0;
+static size_t g_threads = 0;
+static size_t g_rounds  = 5;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/* Times sorting a fresh copy of `input` into `work` (0: qsort, 1: sort,
+ * 2: sort_mt) */
+static double run_sort(int which, const xxh3_128_t* input, xxh3_128_t* work)
+{
+    double best = 1e30;
+    size_t r;
+
+    for (r = 0; r < g_rounds; r++) {
+        double t0;
+        memcpy(work, input, g_count * sizeof(xxh3_128_t));
+        t0 = now_sec();
+        if (which == 0) {
+            qsort(work, g_count, sizeof(xxh3_128_t), xxh3_128_cmp);
+        } else if (which == 1) {
+            xxh3_128_sort(work, g_count);
+        } else {
+            xxh3_128_sort_mt(work, g_count, (unsigned)g_threads);
+        }
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+    }
+    return (double)g_count / best / 1e6;
+}
+
+static double run_unique(const xxh3_128_t* sorted, xxh3_128_t* work, size_t* distinct)
+{
+    double best = 1e30;
+    size_t r;
+
+    for (r = 0; r < g_rounds; r++) {
+        double t0;
+        memcpy(work, sorted, g_count * sizeof(xxh3_128_t));
+        t0 = now_sec();
+        *distinct = xxh3_128_unique(work, g_count);
+        {   double const dt = now_sec() - t0;
+            best = dt < best ? dt : best;
+        }
+    }
+    return (double)g_count / best / 1e6;
+}
+
+static int parse_count(const char* str, size_t* out, int allow_zero)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str || *end != '\0' || (v == 0 && !allow_zero)) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    xxh3_128_t* input;
+    xxh3_128_t* ref;
+    xxh3_128_t* work;
+    double      t_qsort, t_sort, t_mt, t_unique;
+    size_t      distinct = 0, i;
+    uint64_t    rng = 0x0123456789ABCDEFULL;
+    int         a;
+
+    for (a = 1; a < argc; a++) {
+        int ok;
+        if (strncmp(argv[a], "--count=", 8) == 0) {
+            ok = parse_count(argv[a] + 8, &g_count, 0);
+        } else if (strncmp(argv[a], "--dups=", 7) == 0) {
+            ok = parse_count(argv[a] + 7, &g_dups, 1) && g_dups <= 100;
+        } else if (strncmp(argv[a], "--threads=", 10) == 0) {
+            ok = parse_count(argv[a] + 10, &g_threads, 1);
+        } else if (strncmp(argv[a], "--rounds=", 9) == 0) {
+            ok = parse_count(argv[a] + 9, &g_rounds, 0);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--count=N] [--dups=P] [--threads=N] [--rounds=N]\n", argv[0]);
+            return 2;
+        }
+    }
+    input = (xxh3_128_t*)malloc(g_count * sizeof(xxh3_128_t));
+    ref   = (xxh3_128_t*)malloc(g_count * sizeof(xxh3_128_t));
+    work  = (xxh3_128_t*)malloc(g_count * sizeof(xxh3_128_t));
+    if (input == NULL || ref == NULL || work == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    for (i = 0; i < g_count; i++) {
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+        if (i > 0 && rng % 100 < g_dups) {
+            input[i] = input[(rng >> 8) % i];
+        } else {
+            input[i] = xxh3_128_scalar(&i, sizeof(i), 0);
+        }
+    }
+
+    printf("%lu digests, %lu%% duplicates, best of %lu rounds, M digests/s\n\n",
+           (unsigned long)g_count, (unsigned long)g_dups, (unsigned long)g_rounds);
+    t_qsort = run_sort(0, input, ref);
+    t_sort  = run_sort(1, input, work);
+    if (memcmp(work, ref, g_count * sizeof(xxh3_128_t)) != 0) {
+        fprintf(stderr, "xxh3_128_sort: order differs from qsort with xxh3_128_cmp\n");
+        return 1;
+    }
+    t_mt = run_sort(2, input, work);
+    if (memcmp(work, ref, g_count * sizeof(xxh3_128_t)) != 0) {
+        fprintf(stderr, "xxh3_128_sort_mt: order differs from qsort with xxh3_128_cmp\n");
+        return 1;
+    }
+    t_unique = run_unique(ref, work, &distinct);
+
+    printf("%-22s %10.2f\n", "qsort + xxh3_128_cmp", t_qsort);
+    printf("%-22s %10.2f  (%.1fx)\n", "xxh3_128_sort", t_sort, t_sort / t_qsort);
+    printf("%-22s %10.2f  (%.1fx, %lu threads)\n", "xxh3_128_sort_mt", t_mt, t_mt / t_qsort,
+           (unsigned long)g_threads);
+    printf("%-22s %10.2f  (%lu distinct)\n", "xxh3_128_unique", t_unique, (unsigned long)distinct);
+
+    free(work);
+    free(ref);
+    free(input);
+    return 0;
+}
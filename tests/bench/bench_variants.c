@@ -1,8 +1,12 @@
 /* _POSIX_C_SOURCE 199309L is required for clock_gettime / CLOCK_MONOTONIC
- * on POSIX platforms when compiling with -std=c99. */
+ * on POSIX platforms when compiling with -std=c99. _DEFAULT_SOURCE exposes
+ * MAP_ANONYMOUS / MAP_HUGETLB / madvise() for the cold-cache arena. */
 #if !defined(_POSIX_C_SOURCE) || _POSIX_C_SOURCE < 199309L
 #  define _POSIX_C_SOURCE 199309L
 #endif
+#ifndef _DEFAULT_SOURCE
+#  define _DEFAULT_SOURCE 1
+#endif
 
 #include <stdint.h>
 #include <stdio.h>
@@ -11,6 +15,11 @@
 #include <time.h>
 #include <signal.h>
 #include <setjmp.h>
+#include <sys/mman.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  include <emmintrin.h>  /* _mm_clflush / _mm_mfence (SSE2 baseline) */
+#endif
 
 #include "xxh3.h"
 
@@ -21,60 +30,533 @@ static double elapsed(struct timespec start, struct timespec end)
     return s + ns;
 }
 
-static void run_bench(const char* name, uint64_t (*fn)(const void*, size_t, uint64_t), const unsigned char* data, size_t size)
+/* ------------------------------------------------------------------ config
+ * Command line (all optional; defaults reproduce the historical 100 KB run):
+ *   --sizes=16,240,1024,...  input sizes in bytes (max 16 entries); `short`
+ *                            sweeps the 17-128 / 129-240 size classes
+ *   --trials=N               timed repetitions per (variant, size); the
+ *                            median is printed, all samples go to JSON
+ *   --min-time=SEC           minimum duration of a single trial
+ *   --json=PATH              write machine-readable results for
+ *                            scripts/bench_compare.py
+ *   --mode=hot|flush|footprint
+ *                            hot: every call hashes the same (cached) buffer
+ *                            flush: clflush / `dc civac` a 4 MiB arena of
+ *                              input slots before each pass (untimed), so
+ *                              every hash reads from DRAM
+ *                            footprint: visit slots of a --footprint sized
+ *                              arena in scattered order; defeats the caches
+ *                              and, for large footprints, the TLB
+ *   --footprint=BYTES[K|M|G] arena size for --mode=footprint (default 1G)
+ *   --pages=4k|2m            back the arena with 4 KiB pages
+ *                            (MADV_NOHUGEPAGE) or 2 MiB pages (MAP_HUGETLB,
+ *                            falling back to transparent huge pages)
+ * ------------------------------------------------------------------------ */
+#define BENCH_MAX_SIZES  16
+#define BENCH_MAX_TRIALS 64
+
+static size_t g_sizes[BENCH_MAX_SIZES] = { 100 * 1024 }; /* 100 KB for more stable benchmarks */
+static size_t g_num_sizes = 1;
+static int    g_trials = 1;
+static double g_min_time = 0.1;
+static FILE*  g_json = NULL;
+static int    g_json_records = 0;
+
+enum { BENCH_HOT, BENCH_FLUSH, BENCH_FOOTPRINT };
+static const char* const g_mode_names[] = { "hot", "flush", "footprint" };
+static int    g_mode = BENCH_HOT;
+static size_t g_footprint = (size_t)1 << 30;
+static int    g_huge_pages = 0;
+static const char* g_pages_used = "default";
+
+static unsigned char* g_arena = NULL;
+static size_t g_arena_size = 0;
+
+#define BENCH_FLUSH_ARENA ((size_t)4 << 20)
+
+static int cmp_double(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* Print the median of `samples` and append all of them to the JSON report */
+static void report(const char* algo, const char* name, size_t size,
+                   double* samples, int n, unsigned long long hash)
+{
+    double sorted[BENCH_MAX_TRIALS];
+    double median;
+    int i;
+
+    memcpy(sorted, samples, (size_t)n * sizeof(double));
+    qsort(sorted, (size_t)n, sizeof(double), cmp_double);
+    median = (n % 2) ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+
+    if (g_num_sizes == 1 && g_trials == 1) {
+        printf("%-10s: %.3f MB/s (hash=%llu)\n", name, median, hash);
+    } else {
+        printf("%-10s %8lu B: %12.3f MB/s (median of %d, hash=%llu)\n",
+               name, (unsigned long)size, median, n, hash);
+    }
+
+    if (g_json != NULL) {
+        fprintf(g_json, "%s\n    {\"algo\": \"%s\", \"variant\": \"%s\", \"size\": %lu, \"samples\": [",
+                g_json_records++ ? "," : "", algo, name, (unsigned long)size);
+        for (i = 0; i < n; i++) {
+            fprintf(g_json, "%s%.3f", i ? ", " : "", samples[i]);
+        }
+        fprintf(g_json, "]}");
+    }
+}
+
+static size_t batch_for(size_t size);
+
+/* ------------------------------------------------------------ cold inputs */
+
+static unsigned char* arena_alloc(size_t bytes)
+{
+    unsigned char* p = NULL;
+#if defined(MAP_ANONYMOUS) || defined(MAP_ANON)
+#  ifndef MAP_ANONYMOUS
+#    define MAP_ANONYMOUS MAP_ANON
+#  endif
+    void* m = MAP_FAILED;
+#  ifdef MAP_HUGETLB
+    if (g_huge_pages) {
+        m = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        g_pages_used = "2m-hugetlb";
+    }
+#  endif
+    if (m == MAP_FAILED) {
+        m = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (m == MAP_FAILED) {
+            return NULL;
+        }
+        g_pages_used = "default";
+#  if defined(MADV_HUGEPAGE) && defined(MADV_NOHUGEPAGE)
+        if (madvise(m, bytes, g_huge_pages ? MADV_HUGEPAGE : MADV_NOHUGEPAGE) == 0) {
+            g_pages_used = g_huge_pages ? "2m-thp" : "4k";
+        }
+#  endif
+    }
+    p = (unsigned char*)m;
+#else
+    p = (unsigned char*)malloc(bytes);
+#endif
+    if (p != NULL) {
+        memset(p, 7, bytes); /* fault every page in before timing */
+    }
+    return p;
+}
+
+static void arena_free(void)
+{
+    if (g_arena == NULL) {
+        return;
+    }
+#if defined(MAP_ANONYMOUS) || defined(MAP_ANON)
+    munmap(g_arena, g_arena_size);
+#else
+    free(g_arena);
+#endif
+    g_arena = NULL;
+}
+
+/* Evict [p, p + len) from every cache level (not timed) */
+static void flush_range(const unsigned char* p, size_t len)
+{
+    size_t off;
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    for (off = 0; off < len; off += 64) {
+        _mm_clflush(p + off);
+    }
+    _mm_mfence();
+#elif defined(__aarch64__)
+    for (off = 0; off < len; off += 64) {
+        __asm__ __volatile__("dc civac, %0" : : "r"(p + off) : "memory");
+    }
+    __asm__ __volatile__("dsb ish" : : : "memory");
+#else
+    /* No portable flush: fall back to sweeping a second arena-sized buffer */
+    static volatile unsigned char sink;
+    static unsigned char* sweep = NULL;
+    if (sweep == NULL) {
+        sweep = (unsigned char*)calloc(1, 4 * BENCH_FLUSH_ARENA);
+    }
+    for (off = 0; sweep != NULL && off < 4 * BENCH_FLUSH_ARENA; off += 64) {
+        sink ^= sweep[off];
+    }
+    (void)p;
+    (void)len;
+#endif
+}
+
+/* Input slots for one (variant, size) pair in the cold modes. Consecutive
+ * calls visit slot (k * step) % nslots with `step` coprime to nslots, so
+ * every slot is touched once per pass and neighbours are far apart. */
+typedef struct {
+    size_t stride;
+    size_t nslots;
+    size_t step;
+    size_t next;
+} bench_slots_t;
+
+static size_t gcd_size(size_t a, size_t b)
+{
+    while (b != 0) {
+        size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static void slots_init(bench_slots_t* sl, size_t size)
+{
+    sl->stride = (size + 63u) & ~(size_t)63u;
+    if (sl->stride == 0) {
+        sl->stride = 64;
+    }
+    sl->nslots = g_arena_size / sl->stride;
+    if (sl->nslots == 0) {
+        sl->nslots = 1;
+    }
+    sl->step = (size_t)((double)sl->nslots * 0.6180339887) | 1u;
+    while (sl->step > 1 && gcd_size(sl->step, sl->nslots) != 1) {
+        sl->step++;
+    }
+    if (sl->step >= sl->nslots) {
+        sl->step = 1;
+    }
+    sl->next = 0;
+}
+
+static const unsigned char* slots_next(bench_slots_t* sl)
+{
+    const unsigned char* p = g_arena + sl->next * sl->stride;
+    sl->next += sl->step;
+    if (sl->next >= sl->nslots) {
+        sl->next -= sl->nslots;
+    }
+    return p;
+}
+
+/* Calls in the next timed pass; in flush mode the arena is evicted first */
+static size_t slots_pass(const bench_slots_t* sl, size_t size)
+{
+    if (g_mode == BENCH_FLUSH) {
+        flush_range(g_arena, sl->nslots * sl->stride);
+        return sl->nslots;
+    }
+    return batch_for(size) < sl->nslots ? batch_for(size) : sl->nslots;
+}
+
+/* Number of calls between two clock reads: about 1 MiB of input, so the
+ * timer overhead stays negligible even for tiny sizes. */
+static size_t batch_for(size_t size)
+{
+    return size >= (1u << 20) ? 1 : (size_t)(1u << 20) / (size ? size : 1);
+}
+
+static void run_bench(const char* algo, const char* name, uint64_t (*fn)(const void*, size_t, uint64_t), const unsigned char* data)
 {
     struct timespec start;
     struct timespec end;
     uint64_t hash = 0;
-    int iterations = 1000; /* increased for stability */
+    double samples[BENCH_MAX_TRIALS];
+    size_t s;
     size_t i;
+    int t;
 
     /* warmup: run for ~500ms to let CPU frequency scaling settle */
     clock_gettime(CLOCK_MONOTONIC, &start);
     do {
         for (i = 0; i < 10000; i++) {
-            hash ^= fn(data, size, (uint64_t)i);
+            hash ^= fn(data, g_sizes[0], (uint64_t)i);
         }
         clock_gettime(CLOCK_MONOTONIC, &end);
     } while (elapsed(start, end) < 0.5);
 
-    clock_gettime(CLOCK_MONOTONIC, &start);
-    for (i = 0; i < (size_t)iterations; i++) {
-        hash ^= fn(data, size, (uint64_t)i);
+    for (s = 0; s < g_num_sizes; s++) {
+        const size_t size = g_sizes[s];
+        const size_t batch = batch_for(size);
+        for (t = 0; t < g_trials; t++) {
+            size_t iterations = 0;
+            if (g_mode == BENCH_HOT) {
+                clock_gettime(CLOCK_MONOTONIC, &start);
+                do {
+                    for (i = 0; i < batch; i++) {
+                        hash ^= fn(data, size, (uint64_t)(iterations + i));
+                    }
+                    iterations += batch;
+                    clock_gettime(CLOCK_MONOTONIC, &end);
+                } while (elapsed(start, end) < g_min_time);
+                samples[t] = ((double)size * (double)iterations / (1024.0 * 1024.0)) / elapsed(start, end);
+            } else {
+                bench_slots_t sl;
+                double busy = 0.0;
+                slots_init(&sl, size);
+                do {
+                    const size_t n = slots_pass(&sl, size);
+                    clock_gettime(CLOCK_MONOTONIC, &start);
+                    for (i = 0; i < n; i++) {
+                        hash ^= fn(slots_next(&sl), size, (uint64_t)(iterations + i));
+                    }
+                    clock_gettime(CLOCK_MONOTONIC, &end);
+                    busy += elapsed(start, end);
+                    iterations += n;
+                } while (busy < g_min_time);
+                samples[t] = ((double)size * (double)iterations / (1024.0 * 1024.0)) / busy;
+            }
+        }
+        report(algo, name, size, samples, g_trials, (unsigned long long)hash);
     }
-    clock_gettime(CLOCK_MONOTONIC, &end);
-
-    printf("%-10s: %.3f MB/s (hash=%llu)\n", name,
-           ((double)size * (double)iterations / (1024.0 * 1024.0)) / elapsed(start, end),
-           (unsigned long long)hash);
 }
 
-static void run_bench32(const char* name, uint32_t (*fn)(const void*, size_t, uint32_t), const unsigned char* data, size_t size)
+static void run_bench32(const char* algo, const char* name, uint32_t (*fn)(const void*, size_t, uint32_t), const unsigned char* data)
 {
     struct timespec start;
     struct timespec end;
     uint32_t hash = 0;
-    int iterations = 1000;
+    double samples[BENCH_MAX_TRIALS];
+    size_t s;
     size_t i;
+    int t;
 
     /* warmup: run for ~500ms to let CPU frequency scaling settle */
     clock_gettime(CLOCK_MONOTONIC, &start);
     do {
         for (i = 0; i < 10000; i++) {
-            hash ^= fn(data, size, (uint32_t)i);
+            hash ^= fn(data, g_sizes[0], (uint32_t)i);
         }
         clock_gettime(CLOCK_MONOTONIC, &end);
     } while (elapsed(start, end) < 0.5);
 
-    clock_gettime(CLOCK_MONOTONIC, &start);
-    for (i = 0; i < (size_t)iterations; i++) {
-        hash ^= fn(data, size, (uint32_t)i);
+    for (s = 0; s < g_num_sizes; s++) {
+        const size_t size = g_sizes[s];
+        const size_t batch = batch_for(size);
+        for (t = 0; t < g_trials; t++) {
+            size_t iterations = 0;
+            if (g_mode == BENCH_HOT) {
+                clock_gettime(CLOCK_MONOTONIC, &start);
+                do {
+                    for (i = 0; i < batch; i++) {
+                        hash ^= fn(data, size, (uint32_t)(iterations + i));
+                    }
+                    iterations += batch;
+                    clock_gettime(CLOCK_MONOTONIC, &end);
+                } while (elapsed(start, end) < g_min_time);
+                samples[t] = ((double)size * (double)iterations / (1024.0 * 1024.0)) / elapsed(start, end);
+            } else {
+                bench_slots_t sl;
+                double busy = 0.0;
+                slots_init(&sl, size);
+                do {
+                    const size_t n = slots_pass(&sl, size);
+                    clock_gettime(CLOCK_MONOTONIC, &start);
+                    for (i = 0; i < n; i++) {
+                        hash ^= fn(slots_next(&sl), size, (uint32_t)(iterations + i));
+                    }
+                    clock_gettime(CLOCK_MONOTONIC, &end);
+                    busy += elapsed(start, end);
+                    iterations += n;
+                } while (busy < g_min_time);
+                samples[t] = ((double)size * (double)iterations / (1024.0 * 1024.0)) / busy;
+            }
+        }
+        report(algo, name, size, samples, g_trials, (unsigned long long)hash);
     }
-    clock_gettime(CLOCK_MONOTONIC, &end);
+}
+
+/* Messages per multi-buffer call: enough to keep 16 lanes refilled */
+#define BENCH_BATCH_MSGS 64
 
-    printf("%-10s: %.3f MB/s (hash=%u)\n", name,
-           ((double)size * (double)iterations / (1024.0 * 1024.0)) / elapsed(start, end),
-           (unsigned int)hash);
+typedef void (*batch64_fn)(const void* const*, const size_t*, size_t, uint64_t, uint64_t*);
+typedef void (*batch32_fn)(const void* const*, const size_t*, size_t, uint32_t, uint32_t*);
+
+/* Throughput of xxh64_batch_* / xxh32_batch_* over BENCH_BATCH_MSGS
+ * messages of `size` bytes per call (one of fn64 / fn32 is NULL). In the
+ * cold modes every message is a separate arena slot. */
+static void run_bench_batch(const char* algo, const char* name, batch64_fn fn64, batch32_fn fn32,
+                            const unsigned char* data)
+{
+    struct timespec start;
+    struct timespec end;
+    const void* inputs[BENCH_BATCH_MSGS];
+    size_t sizes[BENCH_BATCH_MSGS];
+    uint64_t out64[BENCH_BATCH_MSGS];
+    uint32_t out32[BENCH_BATCH_MSGS];
+    uint64_t hash = 0;
+    double samples[BENCH_MAX_TRIALS];
+    size_t s;
+    size_t i;
+    size_t k;
+    int t;
+
+    for (s = 0; s < g_num_sizes; s++) {
+        const size_t size = g_sizes[s];
+        const size_t batch = batch_for(size);
+        for (k = 0; k < BENCH_BATCH_MSGS; k++) {
+            inputs[k] = data;
+            sizes[k] = size;
+        }
+        for (t = 0; t < g_trials; t++) {
+            size_t iterations = 0;
+            if (g_mode == BENCH_HOT) {
+                clock_gettime(CLOCK_MONOTONIC, &start);
+                do {
+                    for (i = 0; i < batch; i += BENCH_BATCH_MSGS) {
+                        if (fn64 != NULL) {
+                            fn64(inputs, sizes, BENCH_BATCH_MSGS, (uint64_t)(iterations + i), out64);
+                            for (k = 0; k < BENCH_BATCH_MSGS; k++) {
+                                hash ^= out64[k];
+                            }
+                        } else {
+                            fn32(inputs, sizes, BENCH_BATCH_MSGS, (uint32_t)(iterations + i), out32);
+                            for (k = 0; k < BENCH_BATCH_MSGS; k++) {
+                                hash ^= out32[k];
+                            }
+                        }
+                    }
+                    iterations += i;
+                    clock_gettime(CLOCK_MONOTONIC, &end);
+                } while (elapsed(start, end) < g_min_time);
+                samples[t] = ((double)size * (double)iterations / (1024.0 * 1024.0)) / elapsed(start, end);
+            } else {
+                bench_slots_t sl;
+                double busy = 0.0;
+                slots_init(&sl, size);
+                do {
+                    const size_t n = slots_pass(&sl, size);
+                    clock_gettime(CLOCK_MONOTONIC, &start);
+                    for (i = 0; i < n; i += BENCH_BATCH_MSGS) {
+                        const size_t m = (n - i < BENCH_BATCH_MSGS) ? n - i : BENCH_BATCH_MSGS;
+                        for (k = 0; k < m; k++) {
+                            inputs[k] = slots_next(&sl);
+                        }
+                        if (fn64 != NULL) {
+                            fn64(inputs, sizes, m, (uint64_t)(iterations + i), out64);
+                            for (k = 0; k < m; k++) {
+                                hash ^= out64[k];
+                            }
+                        } else {
+                            fn32(inputs, sizes, m, (uint32_t)(iterations + i), out32);
+                            for (k = 0; k < m; k++) {
+                                hash ^= out32[k];
+                            }
+                        }
+                    }
+                    clock_gettime(CLOCK_MONOTONIC, &end);
+                    busy += elapsed(start, end);
+                    iterations += n;
+                } while (busy < g_min_time);
+                samples[t] = ((double)size * (double)iterations / (1024.0 * 1024.0)) / busy;
+            }
+        }
+        report(algo, name, size, samples, g_trials, (unsigned long long)hash);
+    }
+}
+
+/* --sizes=short: both sides of every XXH3 short-input size class
+ * (0-16, 17-128 in 32-byte rounds, 129-240, long) */
+static const size_t g_short_sizes[] = {
+    16, 17, 32, 33, 64, 65, 96, 97, 128, 129, 160, 192, 224, 240, 241, 256
+};
+
+static int parse_sizes(const char* list)
+{
+    char* end;
+    g_num_sizes = 0;
+    if (strcmp(list, "short") == 0) {
+        g_num_sizes = sizeof(g_short_sizes) / sizeof(g_short_sizes[0]);
+        memcpy(g_sizes, g_short_sizes, sizeof(g_short_sizes));
+        return 1;
+    }
+    while (*list != '\0') {
+        unsigned long v = strtoul(list, &end, 10);
+        if (end == list || g_num_sizes == BENCH_MAX_SIZES) {
+            return 0;
+        }
+        g_sizes[g_num_sizes++] = (size_t)v;
+        list = (*end == ',') ? end + 1 : end;
+    }
+    return g_num_sizes > 0;
+}
+
+/* Parse a byte count with an optional K/M/G (binary) suffix */
+static int parse_bytes(const char* str, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(str, &end, 10);
+    if (end == str) {
+        return 0;
+    }
+    switch (*end) {
+    case 'G': case 'g': v <<= 10; /* fall through */
+    case 'M': case 'm': v <<= 10; /* fall through */
+    case 'K': case 'k': v <<= 10; end++; break;
+    default: break;
+    }
+    if (*end != '\0' || v == 0 || v > (unsigned long long)(size_t)-1) {
+        return 0;
+    }
+    *out = (size_t)v;
+    return 1;
+}
+
+static int parse_args(int argc, char** argv)
+{
+    int i;
+    for (i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        if (strncmp(a, "--sizes=", 8) == 0) {
+            if (!parse_sizes(a + 8)) {
+                fprintf(stderr, "invalid --sizes list: %s\n", a + 8);
+                return 0;
+            }
+        } else if (strncmp(a, "--trials=", 9) == 0) {
+            g_trials = atoi(a + 9);
+            if (g_trials < 1 || g_trials > BENCH_MAX_TRIALS) {
+                fprintf(stderr, "--trials must be in [1, %d]\n", BENCH_MAX_TRIALS);
+                return 0;
+            }
+        } else if (strncmp(a, "--min-time=", 11) == 0) {
+            g_min_time = atof(a + 11);
+        } else if (strncmp(a, "--json=", 7) == 0) {
+            g_json = fopen(a + 7, "w");
+            if (g_json == NULL) {
+                perror(a + 7);
+                return 0;
+            }
+        } else if (strncmp(a, "--mode=", 7) == 0) {
+            for (g_mode = 0; g_mode < 3; g_mode++) {
+                if (strcmp(a + 7, g_mode_names[g_mode]) == 0) {
+                    break;
+                }
+            }
+            if (g_mode == 3) {
+                fprintf(stderr, "--mode must be hot, flush or footprint\n");
+                return 0;
+            }
+        } else if (strncmp(a, "--footprint=", 12) == 0) {
+            if (!parse_bytes(a + 12, &g_footprint)) {
+                fprintf(stderr, "invalid --footprint: %s\n", a + 12);
+                return 0;
+            }
+        } else if (strcmp(a, "--pages=4k") == 0) {
+            g_huge_pages = 0;
+        } else if (strcmp(a, "--pages=2m") == 0) {
+            g_huge_pages = 1;
+        } else {
+            fprintf(stderr, "usage: %s [--sizes=N,...] [--trials=N] [--min-time=SEC] [--json=PATH]\n"
+                            "       [--mode=hot|flush|footprint] [--footprint=BYTES[K|M|G]] [--pages=4k|2m]\n",
+                    argv[0]);
+            return 0;
+        }
+    }
+    return 1;
 }
 
 /* Generic signal guard for SIMD variants that may raise SIGILL or SIGSEGV on
@@ -139,6 +621,12 @@ extern uint64_t xxh3_64_avx512(const void* input, size_t size, uint64_t seed);
 #define xxh3_64_sse2   NULL
 #define xxh3_64_avx2   NULL
 #define xxh3_64_avx512 NULL
+#define xxh32_sse41        NULL
+#define xxh32_batch_sse41  NULL
+#define xxh32_batch_avx2   NULL
+#define xxh64_batch_avx2   NULL
+#define xxh32_batch_avx512 NULL
+#define xxh64_batch_avx512 NULL
 #define HAVE_X86_VARIANTS 0
 #endif
 
@@ -149,32 +637,88 @@ extern uint64_t xxh3_64_sve(const void* input, size_t size, uint64_t seed);
 #else
 #define xxh3_64_neon NULL
 #define xxh3_64_sve  NULL
+#define xxh32_neon       NULL
+#define xxh32_batch_neon NULL
+#define xxh64_batch_neon NULL
 #define HAVE_ARM_VARIANTS 0
 #endif
 
-int main(void)
+int main(int argc, char** argv)
 {
-    size_t size = 100 * 1024; /* 100 KB for more stable benchmarks */
-    unsigned char* data = (unsigned char*)malloc(size);
+    size_t max_size = 0;
+    size_t i;
+    unsigned char* data;
+
+    if (!parse_args(argc, argv)) {
+        return 2;
+    }
+    for (i = 0; i < g_num_sizes; i++) {
+        if (g_sizes[i] > max_size) {
+            max_size = g_sizes[i];
+        }
+    }
+    data = (unsigned char*)malloc(max_size ? max_size : 1);
     if (data == NULL) {
         return 1;
     }
-    memset(data, 7, size);
+    memset(data, 7, max_size);
+
+    if (g_mode != BENCH_HOT) {
+        g_arena_size = (g_mode == BENCH_FLUSH) ? BENCH_FLUSH_ARENA : g_footprint;
+        if (g_arena_size < max_size) {
+            g_arena_size = max_size;
+        }
+        g_arena = arena_alloc(g_arena_size);
+        if (g_arena == NULL) {
+            fprintf(stderr, "cannot allocate a %lu byte arena\n", (unsigned long)g_arena_size);
+            free(data);
+            return 1;
+        }
+        printf("mode: %s, arena %lu MiB, pages %s\n\n", g_mode_names[g_mode],
+               (unsigned long)(g_arena_size >> 20), g_pages_used);
+    }
+
+    if (g_json != NULL) {
+        fprintf(g_json, "{\n  \"schema\": 1,\n  \"unit\": \"MB/s\",\n  \"mode\": \"%s\",\n"
+                        "  \"arena\": %lu,\n  \"pages\": \"%s\",\n  \"results\": [",
+                g_mode_names[g_mode], (unsigned long)g_arena_size,
+                g_mode == BENCH_HOT ? "n/a" : g_pages_used);
+    }
 
     /* scalar is always safe — no guard needed */
     printf("--- XXH3 64-bit Variants ---\n");
-    run_bench("scalar", xxh3_64_scalar, data, size);
+    run_bench("xxh3_64", "scalar", xxh3_64_scalar, data);
 
-    RUN_BENCH_SAFE("neon",   xxh3_64_neon,   run_bench("neon",   xxh3_64_neon,   data, size));
-    RUN_BENCH_SAFE("sve",    xxh3_64_sve,    run_bench("sve",    xxh3_64_sve,    data, size));
-    RUN_BENCH_SAFE("sse2",   xxh3_64_sse2,   run_bench("sse2",   xxh3_64_sse2,   data, size));
-    RUN_BENCH_SAFE("avx2",   xxh3_64_avx2,   run_bench("avx2",   xxh3_64_avx2,   data, size));
-    RUN_BENCH_SAFE("avx512", xxh3_64_avx512, run_bench("avx512", xxh3_64_avx512, data, size));
+    RUN_BENCH_SAFE("neon",   xxh3_64_neon,   run_bench("xxh3_64", "neon",   xxh3_64_neon,   data));
+    RUN_BENCH_SAFE("sve",    xxh3_64_sve,    run_bench("xxh3_64", "sve",    xxh3_64_sve,    data));
+    RUN_BENCH_SAFE("sse2",   xxh3_64_sse2,   run_bench("xxh3_64", "sse2",   xxh3_64_sse2,   data));
+    RUN_BENCH_SAFE("avx2",   xxh3_64_avx2,   run_bench("xxh3_64", "avx2",   xxh3_64_avx2,   data));
+    RUN_BENCH_SAFE("avx512", xxh3_64_avx512, run_bench("xxh3_64", "avx512", xxh3_64_avx512, data));
 
-    printf("\n--- Legacy XXH32 / XXH64 (Scalar) ---\n");
-    run_bench32("xxh32", xxh32, data, size);
-    run_bench("xxh64", xxh64, data, size);
+    printf("\n--- Legacy XXH32 / XXH64 ---\n");
+    run_bench32("xxh32", "xxh32", xxh32, data);
+    RUN_BENCH_SAFE("xxh32_neon",  xxh32_neon,  run_bench32("xxh32", "xxh32_neon",  xxh32_neon,  data));
+    RUN_BENCH_SAFE("xxh32_sse41", xxh32_sse41, run_bench32("xxh32", "xxh32_sse41", xxh32_sse41, data));
+    run_bench("xxh64", "xxh64", xxh64, data);
 
+    printf("\n--- Multi-buffer XXH32 (%d messages per call) ---\n", BENCH_BATCH_MSGS);
+    run_bench_batch("xxh32_batch", "scalar", NULL, xxh32_batch_scalar, data);
+    RUN_BENCH_SAFE("neon",   xxh32_batch_neon,   run_bench_batch("xxh32_batch", "neon",   NULL, xxh32_batch_neon,   data));
+    RUN_BENCH_SAFE("sse41",  xxh32_batch_sse41,  run_bench_batch("xxh32_batch", "sse41",  NULL, xxh32_batch_sse41,  data));
+    RUN_BENCH_SAFE("avx2",   xxh32_batch_avx2,   run_bench_batch("xxh32_batch", "avx2",   NULL, xxh32_batch_avx2,   data));
+    RUN_BENCH_SAFE("avx512", xxh32_batch_avx512, run_bench_batch("xxh32_batch", "avx512", NULL, xxh32_batch_avx512, data));
+
+    printf("\n--- Multi-buffer XXH64 (%d messages per call) ---\n", BENCH_BATCH_MSGS);
+    run_bench_batch("xxh64_batch", "scalar", xxh64_batch_scalar, NULL, data);
+    RUN_BENCH_SAFE("neon",   xxh64_batch_neon,   run_bench_batch("xxh64_batch", "neon",   xxh64_batch_neon,   NULL, data));
+    RUN_BENCH_SAFE("avx2",   xxh64_batch_avx2,   run_bench_batch("xxh64_batch", "avx2",   xxh64_batch_avx2,   NULL, data));
+    RUN_BENCH_SAFE("avx512", xxh64_batch_avx512, run_bench_batch("xxh64_batch", "avx512", xxh64_batch_avx512, NULL, data));
+
+    if (g_json != NULL) {
+        fprintf(g_json, "\n  ]\n}\n");
+        fclose(g_json);
+    }
+    arena_free();
     free(data);
     return 0;
 }
@@ -0,0 +1,115 @@
+/* =============================================================================
+ * tests/unit/test_map_cpp.cpp
+ *
+ * Unity tests for the C++ wrapper of the hash map (include/xxh3_map.hpp).
+ * The C map itself is covered by test_variants.c; these check that the
+ * wrapper compiles as C++11 and forwards to it correctly.
+ * =============================================================================
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+#include "xxh3_map.hpp"
+
+extern "C" {
+#include "unity.h"
+}
+
+extern "C" void setUp(void) {}
+extern "C" void tearDown(void) {}
+
+struct point {
+    std::int32_t x;
+    std::int32_t y;
+};
+
+static void test_map_wrapper_insert_find_erase(void)
+{
+    xxh3::map<std::uint64_t, point> m;
+    std::uint64_t                   i;
+
+    TEST_ASSERT_TRUE(m.empty());
+    for (i = 0; i < 1000; i++) {
+        point const p = { static_cast<std::int32_t>(i), -static_cast<std::int32_t>(i) };
+        std::pair<point*, bool> const r = m.insert(i, p);
+        TEST_ASSERT_TRUE(r.second);
+        TEST_ASSERT_EQUAL_INT(static_cast<int>(i), r.first->x);
+    }
+    {   point const other = { 7, 7 };
+        std::pair<point*, bool> const r = m.insert(5, other);
+        TEST_ASSERT_FALSE(r.second);
+        TEST_ASSERT_EQUAL_INT(5, r.first->x);
+    }
+    TEST_ASSERT_EQUAL_UINT64(1000, m.size());
+    TEST_ASSERT_TRUE(m.contains(999));
+    TEST_ASSERT_FALSE(m.contains(1000));
+    TEST_ASSERT_EQUAL_INT(-42, m.find(42)->y);
+
+    m[2000].x = 3;   /* added zero-filled */
+    TEST_ASSERT_EQUAL_INT(3, m.find(2000)->x);
+    TEST_ASSERT_EQUAL_INT(0, m.find(2000)->y);
+
+    for (i = 0; i < 1000; i += 2) {
+        TEST_ASSERT_TRUE(m.erase(i));
+    }
+    TEST_ASSERT_FALSE(m.erase(0));
+    TEST_ASSERT_EQUAL_UINT64(501, m.size());
+
+    {   std::uint64_t sum = 0, n = 0;
+        m.for_each([&](const std::uint64_t& key, point& value) {
+            sum += key;
+            n++;
+            value.y = 1;
+        });
+        TEST_ASSERT_EQUAL_UINT64(501, n);
+        TEST_ASSERT_EQUAL_UINT64(250000 + 2000, sum);
+        TEST_ASSERT_EQUAL_INT(1, m.find(1)->y);
+    }
+
+    xxh3::map<std::uint64_t, point> moved(std::move(m));
+    TEST_ASSERT_EQUAL_UINT64(501, moved.size());
+    moved.clear();
+    TEST_ASSERT_TRUE(moved.empty());
+}
+
+static int g_allocs;
+
+static void* counting_alloc(void* ctx, std::size_t size)
+{
+    (void)ctx;
+    g_allocs++;
+    return std::malloc(size);
+}
+
+static void counting_free(void* ctx, void* ptr, std::size_t size)
+{
+    (void)ctx;
+    (void)size;
+    g_allocs--;
+    std::free(ptr);
+}
+
+static void test_map_wrapper_allocator_and_reserve(void)
+{
+    xxh3_allocator_t const allocator = { counting_alloc, counting_free, nullptr };
+    {
+        xxh3::map<std::uint32_t, std::uint16_t> m(0, 1234, &allocator);
+        m.reserve(10000);
+        TEST_ASSERT_TRUE(m.capacity() * 7 / 8 >= 10000);
+        TEST_ASSERT_TRUE(g_allocs > 0);
+        m[17] = 4;
+        TEST_ASSERT_EQUAL_INT(4, *m.find(17));
+    }
+    TEST_ASSERT_EQUAL_INT(0, g_allocs);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_map_wrapper_insert_find_erase);
+    RUN_TEST(test_map_wrapper_allocator_and_reserve);
+    return UNITY_END();
+}
@@ -9,10 +9,33 @@
  *   - XXH3 streaming: reset/update/digest matches single-shot (seeded & unseeded)
  *   - XXH3 incremental chunked streaming
  *   - XXH3 secret-based hashing (single-shot + streaming)
+ *   - XXH3 non-temporal variants and streaming update match the regular path
  *   - xxh32 single-shot stability and seed sensitivity
  *   - xxh32 streaming and chunked streaming matches single-shot
+ *   - xxh32 SSE4.1/NEON single-stream and streaming variants match xxh32
  *   - xxh64 single-shot stability and seed sensitivity
  *   - xxh64 streaming and chunked streaming matches single-shot
+ *   - xxh32/xxh64 multi-buffer variants match single-shot
+ *   - XXH3-64 multi-seed variants and batch match one hash per seed
+ *   - XXH3 digest_withSuffix checkpoints match single-shot of prefix + suffix
+ *   - XXH3 lockstep multi-stream update matches per-stream single-shot
+ *   - Fused copy-and-hash (single-shot and streaming) matches memcpy + hash
+ *   - NUL-terminated string hashing matches the sized hash, no read past NUL
+ *   - Case-insensitive XXH3-64 (single-shot, batch, stream) = lowercase + hash
+ *   - Strided 2D and field-gather hashing match hashing a contiguous copy
+ *   - Batch canonical/hex encoding and decoding match the single-digest helpers
+ *   - xxh3_128_t radix sort and dedup match a cmp-based reference
+ *   - Static digest index lookups match a sorted array; bad images rejected
+ *   - Hash map matches a reference table, allocation failure is harmless
+ *     (the C++ wrapper is covered by test_map_cpp.cpp)
+ *   - Bloom filter variants match scalar; false-positive rate, merge, views
+ *   - HyperLogLog variants match scalar; estimate error, sparse/dense merges
+ *   - Multiset hash variants match scalar; add/remove/merge arithmetic
+ *   - Minimal perfect hash variants match scalar; image checks and errors
+ *   - Hash-partitioning scatter variants match a direct partition; errors
+ *   - Jump and rendezvous variants match naive; monotonicity and weighting
+ *   - Per-block checksums (threaded and verify) match per-block hashing
+ *   - Integrity scrubber: mismatches, slot reuse, limits, pausing, concurrency
  *   - Edge cases: empty input, single byte, large deterministic inputs
  *   - Seed sensitivity: seeded variants produce different outputs
  *   - Unseeded consistency: unseeded variants always produce same output (seed=0)
@@ -30,12 +53,24 @@
 /* Expose POSIX/XSI helpers (sigjmp_buf/sigsetjmp) when compiling under -std=c99. */
 #define _XOPEN_SOURCE 700
 
+#include <math.h>
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <signal.h>
 #include <setjmp.h>
+#include <time.h>
+#if !defined(_WIN32)
+#  include <pthread.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#  include <sys/mman.h>
+#  include <unistd.h>
+#  define TEST_HAVE_MPROTECT 1
+#else
+#  define TEST_HAVE_MPROTECT 0
+#endif
 
 #include "xxh3.h"
 #include "../unity/unity.h"
@@ -245,6 +280,58 @@ static void test_xxh3_64_variants_match_scalar_1mb(void)
     free(buf);
 }
 
+/* Every length up to XXH3_MIDSIZE_MAX (240), at two alignments: covers the
+ * SIMD short-input kernels of each variant class boundary by boundary. */
+static void test_xxh3_64_variants_match_scalar_every_short_size(void)
+{
+    unsigned char* buf = make_buf(256);
+    size_t         size;
+    size_t         align;
+
+    TEST_ASSERT_NOT_NULL(buf);
+    for (align = 0; align < 2; align++) {
+        for (size = 0; size <= 240; size++) {
+            const unsigned char* in  = buf + align;
+            const uint64_t       ref = xxh3_64_scalar(in, size, SEED2);
+#if XXH3_HAVE_SSE2
+            TEST_ASSERT_EQUAL_UINT64(ref, xxh3_64_sse2(in, size, SEED2));
+#endif
+#if XXH3_HAVE_AVX2
+            TEST_TRY_VARIANT("AVX2", {
+                uint64_t avx2_result = xxh3_64_avx2(in, size, SEED2);
+                if (!_test_skip_variant) {
+                    TEST_ASSERT_EQUAL_UINT64(ref, avx2_result);
+                }
+            });
+#endif
+#if XXH3_HAVE_AVX512
+            TEST_TRY_VARIANT("AVX512", {
+                uint64_t avx512_result = xxh3_64_avx512(in, size, SEED2);
+                if (!_test_skip_variant) {
+                    TEST_ASSERT_EQUAL_UINT64(ref, avx512_result);
+                    TEST_ASSERT_EQUAL_UINT64(xxh3_64_scalar_unseeded(in, size),
+                                             xxh3_64_avx512_unseeded(in, size));
+                }
+            });
+#endif
+#if XXH3_HAVE_NEON
+            TEST_ASSERT_EQUAL_UINT64(ref, xxh3_64_neon(in, size, SEED2));
+#endif
+#if XXH3_HAVE_SVE
+            TEST_TRY_VARIANT("SVE", {
+                uint64_t sve_result = xxh3_64_sve(in, size, SEED2);
+                if (!_test_skip_variant) {
+                    TEST_ASSERT_EQUAL_UINT64(ref, sve_result);
+                    TEST_ASSERT_EQUAL_UINT64(xxh3_64_scalar_unseeded(in, size),
+                                             xxh3_64_sve_unseeded(in, size));
+                }
+            });
+#endif
+        }
+    }
+    free(buf);
+}
+
 /* ------------------------------------------------------------ xxh3-128 variants */
 
 static void test_xxh3_128_variants_match_scalar_short(void)
@@ -572,6 +659,76 @@ static void test_xxh3_128_copy_state_branches_hashing(void)
     xxh3_freeState(state3);
 }
 
+/* Prefix lengths around the 240-byte, stripe and 256-byte buffer edges and
+ * past the first 1 KiB block; suffixes that stay buffered or spill over. */
+static const size_t FORK_PREFIXES[] = { 0, 5, 63, 64, 200, 240, 256, 300, 1031, 5000 };
+static const size_t FORK_SUFFIXES[] = { 0, 1, 17, 64, 100, 241, 1000, 3000 };
+#define FORK_MAX_LEN (5000 + 3000)
+#define FORK_COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+static void test_xxh3_64_digest_withSuffix_matches_single_shot(void)
+{
+    unsigned char* buf   = make_buf(FORK_MAX_LEN);
+    xxh3_state_t*  state = xxh3_createState();
+    size_t         p, q;
+
+    TEST_ASSERT_NOT_NULL(buf);
+    TEST_ASSERT_NOT_NULL(state);
+    for (p = 0; p < FORK_COUNT(FORK_PREFIXES); p++) {
+        const size_t plen = FORK_PREFIXES[p];
+        xxh3_64_reset(state, SEED1);
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_64_update(state, buf, plen));
+        for (q = 0; q < FORK_COUNT(FORK_SUFFIXES); q++) {
+            const size_t slen = FORK_SUFFIXES[q];
+            TEST_ASSERT_EQUAL_UINT64(xxh3_64_scalar(buf, plen + slen, SEED1),
+                                     xxh3_64_digest_withSuffix(state, buf + plen, slen));
+        }
+        /* the checkpoint itself is untouched */
+        TEST_ASSERT_EQUAL_UINT64(xxh3_64_scalar(buf, plen, SEED1), xxh3_64_digest(state));
+
+        xxh3_64_reset_unseeded(state);
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_64_update(state, buf, plen));
+        TEST_ASSERT_EQUAL_UINT64(xxh3_64_scalar_unseeded(buf, plen + 100),
+                                 xxh3_64_digest_withSuffix(state, buf + plen, 100));
+    }
+    xxh3_freeState(state);
+    free(buf);
+}
+
+static void test_xxh3_128_digest_withSuffix_matches_single_shot(void)
+{
+    unsigned char  secret[192];
+    unsigned char* buf   = make_buf(FORK_MAX_LEN);
+    xxh3_state_t*  state = xxh3_createState();
+    size_t         p, q;
+
+    TEST_ASSERT_NOT_NULL(buf);
+    TEST_ASSERT_NOT_NULL(state);
+    xxh3_generateSecret(secret, sizeof(secret), SEED2);
+    for (p = 0; p < FORK_COUNT(FORK_PREFIXES); p++) {
+        const size_t plen = FORK_PREFIXES[p];
+        xxh3_128_reset(state, SEED2);
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_128_update(state, buf, plen));
+        for (q = 0; q < FORK_COUNT(FORK_SUFFIXES); q++) {
+            const size_t slen = FORK_SUFFIXES[q];
+            xxh3_128_t ref = xxh3_128_scalar(buf, plen + slen, SEED2);
+            xxh3_128_t got = xxh3_128_digest_withSuffix(state, buf + plen, slen);
+            TEST_ASSERT_TRUE(xxh3_128_isEqual(ref, got));
+        }
+
+        /* external secret: referenced by the fork, not copied */
+        xxh3_128_reset_withSecret(state, secret, sizeof(secret));
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_128_update(state, buf, plen));
+        {
+            xxh3_128_t ref = xxh3_128_withSecret(buf, plen + 1000, secret, sizeof(secret));
+            xxh3_128_t got = xxh3_128_digest_withSuffix(state, buf + plen, 1000);
+            TEST_ASSERT_TRUE(xxh3_128_isEqual(ref, got));
+        }
+    }
+    xxh3_freeState(state);
+    free(buf);
+}
+
 static void test_generate_secret_produces_nonzero_output(void)
 {
     unsigned char secret[XXH3_SECRET_SIZE_MIN];
@@ -749,186 +906,3564 @@ static void test_state_can_be_reset_and_reused(void)
     xxh3_freeState(state);
 }
 
-/* ------------------------------------------------------ xxh32 */
+/* -------------------------------------------------- non-temporal variants */
 
-static void test_xxh32_single_shot_stable(void)
-{
-    uint32_t a = xxh32(LOREM, strlen(LOREM), SEED32_1);
-    uint32_t b = xxh32(LOREM, strlen(LOREM), SEED32_1);
-    TEST_ASSERT_EQUAL_UINT32(a, b);
-}
+static const size_t NT_SIZES[] = { 0, 17, 240, 241, 1024, (1u << 20) + 3 };
 
-static void test_xxh32_different_seeds_differ(void)
+static void test_xxh3_64_nt_variants_match_scalar(void)
 {
-    uint32_t a = xxh32(LOREM, strlen(LOREM), SEED32_0);
-    uint32_t b = xxh32(LOREM, strlen(LOREM), SEED32_1);
-    TEST_ASSERT_NOT_EQUAL(a, b);
-}
+    const size_t   max  = (1u << 20) + 3;
+    unsigned char* buf  = make_buf(max);
+    size_t         i;
 
-static void test_xxh32_empty_input_stable(void)
-{
-    uint32_t a = xxh32("", 0, SEED32_0);
-    uint32_t b = xxh32("", 0, SEED32_0);
-    TEST_ASSERT_EQUAL_UINT32(a, b);
+    TEST_ASSERT_NOT_NULL(buf);
+    for (i = 0; i < sizeof(NT_SIZES) / sizeof(NT_SIZES[0]); i++) {
+        const size_t   size = NT_SIZES[i];
+        const uint64_t ref  = xxh3_64_scalar(buf, size, SEED2);
+
+        TEST_ASSERT_EQUAL_UINT64(ref, xxh3_64_nt_scalar(buf, size, SEED2));
+#if XXH3_HAVE_SSE2
+        TEST_ASSERT_EQUAL_UINT64(ref, xxh3_64_nt_sse2(buf, size, SEED2));
+#endif
+#if XXH3_HAVE_AVX2
+        TEST_TRY_VARIANT("AVX2", {
+            uint64_t avx2_result = xxh3_64_nt_avx2(buf, size, SEED2);
+            if (!_test_skip_variant) {
+                TEST_ASSERT_EQUAL_UINT64(ref, avx2_result);
+            }
+        });
+#endif
+#if XXH3_HAVE_AVX512
+        TEST_TRY_VARIANT("AVX512", {
+            uint64_t avx512_result = xxh3_64_nt_avx512(buf, size, SEED2);
+            if (!_test_skip_variant) {
+                TEST_ASSERT_EQUAL_UINT64(ref, avx512_result);
+            }
+        });
+#endif
+#if XXH3_HAVE_NEON
+        TEST_ASSERT_EQUAL_UINT64(ref, xxh3_64_nt_neon(buf, size, SEED2));
+#endif
+#if XXH3_HAVE_SVE
+        TEST_TRY_VARIANT("SVE", {
+            uint64_t sve_result = xxh3_64_nt_sve(buf, size, SEED2);
+            if (!_test_skip_variant) {
+                TEST_ASSERT_EQUAL_UINT64(ref, sve_result);
+            }
+        });
+#endif
+    }
+    free(buf);
 }
 
-static void test_xxh32_stream_matches_single_shot(void)
+static void test_xxh3_128_nt_variants_match_scalar(void)
 {
-    const size_t   size  = strlen(LOREM);
-    const uint32_t ref   = xxh32(LOREM, size, SEED32_1);
-    xxh3_state_t*  state = xxh3_createState();
+    const size_t   max  = (1u << 20) + 3;
+    unsigned char* buf  = make_buf(max);
+    size_t         i;
 
-    TEST_ASSERT_NOT_NULL(state);
-    xxh32_reset(state, SEED32_1);
-    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh32_update(state, LOREM, size));
-    TEST_ASSERT_EQUAL_UINT32(ref, xxh32_digest(state));
-    xxh3_freeState(state);
+    TEST_ASSERT_NOT_NULL(buf);
+    for (i = 0; i < sizeof(NT_SIZES) / sizeof(NT_SIZES[0]); i++) {
+        const size_t     size = NT_SIZES[i];
+        const xxh3_128_t ref  = xxh3_128_scalar(buf, size, SEED2);
+        xxh3_128_t       got;
+
+        got = xxh3_128_nt_scalar(buf, size, SEED2);
+        TEST_ASSERT_EQUAL_UINT64(ref.high, got.high);
+        TEST_ASSERT_EQUAL_UINT64(ref.low,  got.low);
+#if XXH3_HAVE_SSE2
+        got = xxh3_128_nt_sse2(buf, size, SEED2);
+        TEST_ASSERT_EQUAL_UINT64(ref.high, got.high);
+        TEST_ASSERT_EQUAL_UINT64(ref.low,  got.low);
+#endif
+#if XXH3_HAVE_AVX2
+        TEST_TRY_VARIANT("AVX2", {
+            xxh3_128_t avx2_result = xxh3_128_nt_avx2(buf, size, SEED2);
+            if (!_test_skip_variant) {
+                TEST_ASSERT_EQUAL_UINT64(ref.high, avx2_result.high);
+                TEST_ASSERT_EQUAL_UINT64(ref.low,  avx2_result.low);
+            }
+        });
+#endif
+#if XXH3_HAVE_AVX512
+        TEST_TRY_VARIANT("AVX512", {
+            xxh3_128_t avx512_result = xxh3_128_nt_avx512(buf, size, SEED2);
+            if (!_test_skip_variant) {
+                TEST_ASSERT_EQUAL_UINT64(ref.high, avx512_result.high);
+                TEST_ASSERT_EQUAL_UINT64(ref.low,  avx512_result.low);
+            }
+        });
+#endif
+#if XXH3_HAVE_NEON
+        got = xxh3_128_nt_neon(buf, size, SEED2);
+        TEST_ASSERT_EQUAL_UINT64(ref.high, got.high);
+        TEST_ASSERT_EQUAL_UINT64(ref.low,  got.low);
+#endif
+#if XXH3_HAVE_SVE
+        TEST_TRY_VARIANT("SVE", {
+            xxh3_128_t sve_result = xxh3_128_nt_sve(buf, size, SEED2);
+            if (!_test_skip_variant) {
+                TEST_ASSERT_EQUAL_UINT64(ref.high, sve_result.high);
+                TEST_ASSERT_EQUAL_UINT64(ref.low,  sve_result.low);
+            }
+        });
+#endif
+    }
+    free(buf);
 }
 
-static void test_xxh32_chunked_streaming_matches_single_shot(void)
+static void test_xxh3_nt_stream_matches_single_shot(void)
 {
-    const size_t   size  = strlen(LOREM);
-    const size_t   chunk = 8;
-    const uint32_t ref   = xxh32(LOREM, size, SEED32_0);
-    xxh3_state_t*  state = xxh3_createState();
-    size_t         offset;
+    const size_t     size  = (1u << 20) + 3;
+    const size_t     chunk = 4093;  /* odd size: crosses stripe/block edges */
+    unsigned char*   buf   = make_buf(size);
+    xxh3_state_t*    state = xxh3_createState();
+    uint64_t         ref64;
+    xxh3_128_t       ref128, got128;
+    size_t           offset;
 
+    TEST_ASSERT_NOT_NULL(buf);
     TEST_ASSERT_NOT_NULL(state);
-    xxh32_reset(state, SEED32_0);
+    ref64  = xxh3_64_scalar(buf, size, SEED2);
+    ref128 = xxh3_128_scalar(buf, size, SEED2);
+
+    /* chunked non-temporal updates, interleaved with a regular update */
+    xxh3_64_reset(state, SEED2);
     for (offset = 0; offset + chunk <= size; offset += chunk) {
-        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh32_update(state, LOREM + offset, chunk));
-    }
-    if (offset < size) {
-        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh32_update(state, LOREM + offset, size - offset));
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_64_update_nt(state, buf + offset, chunk));
     }
-    TEST_ASSERT_EQUAL_UINT32(ref, xxh32_digest(state));
-    xxh3_freeState(state);
-}
-
-static void test_xxh32_stream_reset_reuse(void)
-{
-    const size_t   size  = strlen(SHORT_INPUT);
-    const uint32_t ref   = xxh32(SHORT_INPUT, size, SEED32_1);
-    xxh3_state_t*  state = xxh3_createState();
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_64_update(state, buf + offset, size - offset));
+    TEST_ASSERT_EQUAL_UINT64(ref64, xxh3_64_digest(state));
 
-    TEST_ASSERT_NOT_NULL(state);
-    xxh32_reset(state, SEED32_1);
-    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh32_update(state, SHORT_INPUT, size));
-    TEST_ASSERT_EQUAL_UINT32(ref, xxh32_digest(state));
+    /* one large non-temporal update */
+    xxh3_128_reset(state, SEED2);
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_128_update_nt(state, buf, size));
+    got128 = xxh3_128_digest(state);
+    TEST_ASSERT_EQUAL_UINT64(ref128.high, got128.high);
+    TEST_ASSERT_EQUAL_UINT64(ref128.low,  got128.low);
 
-    xxh32_reset(state, SEED32_1);
-    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh32_update(state, SHORT_INPUT, size));
-    TEST_ASSERT_EQUAL_UINT32(ref, xxh32_digest(state));
     xxh3_freeState(state);
+    free(buf);
 }
 
-/* ---------------------------------------------------- Canonical representation tests */
-
-static void test_xxh32_canonical_roundtrip(void)
-{
-    const size_t size = strlen(SHORT_INPUT);
-    uint32_t h = xxh32(SHORT_INPUT, size, SEED32_1);
-    xxh32_canonical_t can;
-    unsigned char expected[4];
+/* Lockstep multi-stream update: MULTI_STREAMS streams, each fed its own
+ * slice of the buffer in packets of 0..MULTI_MAX_PACKET bytes. Stream 0 also
+ * appears a second time in every batch. */
+#define MULTI_STREAMS    40
+#define MULTI_ROUNDS     24
+#define MULTI_MAX_PACKET 700
 
-    xxh32_canonicalFromHash(&can, h);
+typedef int (*update_multi_fn)(const xxh3_stream_update_t*, size_t);
 
-    /* Round-trip numeric equality */
-    TEST_ASSERT_EQUAL_UINT32(h, xxh32_hashFromCanonical(&can));
+static size_t multi_packet(size_t round, size_t stream)
+{
+    return (round * 131 + stream * 71 + (round ^ stream) * 17) % (MULTI_MAX_PACKET + 1);
+}
 
-    /* Canonical form MUST be big-endian */
-    expected[0] = (unsigned char)((h >> 24) & 0xFFu);
-    expected[1] = (unsigned char)((h >> 16) & 0xFFu);
-    expected[2] = (unsigned char)((h >> 8)  & 0xFFu);
-    expected[3] = (unsigned char)(h & 0xFFu);
-    for (size_t i = 0; i < 4; ++i) {
-        TEST_ASSERT_EQUAL_UINT((unsigned long)expected[i], (unsigned long)can.digest[i]);
+static void assert_equal_u64_array(const uint64_t* ref, const uint64_t* got, size_t n)
+{
+    size_t i;
+    for (i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL_UINT64(ref[i], got[i]);
     }
 }
 
-static void test_xxh64_canonical_roundtrip(void)
+/* Returns the first non-OK result of fn, XXH3_OK otherwise */
+static int run_update_multi(update_multi_fn fn, xxh3_state_t** states,
+                            const unsigned char* buf, uint64_t* got)
 {
-    const size_t size = strlen(SHORT_INPUT);
-    uint64_t h = xxh64(SHORT_INPUT, size, SEED2);
-    xxh64_canonical_t can;
-    unsigned char expected[8];
-
-    xxh64_canonicalFromHash(&can, h);
-
-    /* Round-trip numeric equality */
-    TEST_ASSERT_EQUAL_UINT64(h, xxh64_hashFromCanonical(&can));
-
-    /* Canonical form MUST be big-endian */
-    expected[0] = (unsigned char)((h >> 56) & 0xFFu);
-    expected[1] = (unsigned char)((h >> 48) & 0xFFu);
-    expected[2] = (unsigned char)((h >> 40) & 0xFFu);
-    expected[3] = (unsigned char)((h >> 32) & 0xFFu);
-    expected[4] = (unsigned char)((h >> 24) & 0xFFu);
-    expected[5] = (unsigned char)((h >> 16) & 0xFFu);
-    expected[6] = (unsigned char)((h >> 8)  & 0xFFu);
-    expected[7] = (unsigned char)(h & 0xFFu);
-    for (size_t i = 0; i < 8; ++i) {
-        TEST_ASSERT_EQUAL_UINT((unsigned long)expected[i], (unsigned long)can.digest[i]);
+    xxh3_stream_update_t updates[MULTI_STREAMS + 1];
+    size_t               fed[MULTI_STREAMS];
+    size_t               r, i;
+    int                  rc = XXH3_OK;
+
+    for (i = 0; i < MULTI_STREAMS; i++) {
+        xxh3_64_reset(states[i], (i & 1) ? SEED2 : SEED1);
+        fed[i] = 0;
+    }
+    for (r = 0; r < MULTI_ROUNDS; r++) {
+        for (i = 0; i < MULTI_STREAMS; i++) {
+            updates[i].state = states[i];
+            updates[i].input = buf + i * 7 + fed[i];
+            updates[i].size  = multi_packet(r, i);
+            fed[i] += updates[i].size;
+        }
+        updates[MULTI_STREAMS].state = states[0];
+        updates[MULTI_STREAMS].input = buf + fed[0];
+        updates[MULTI_STREAMS].size  = multi_packet(r, MULTI_STREAMS);
+        fed[0] += updates[MULTI_STREAMS].size;
+        if (fn(updates, MULTI_STREAMS + 1) != XXH3_OK) {
+            rc = XXH3_ERROR;
+        }
+    }
+    for (i = 0; i < MULTI_STREAMS; i++) {
+        got[i] = xxh3_64_digest(states[i]);
     }
+    return rc;
 }
 
-static void test_xxh128_canonical_roundtrip(void)
+static void test_xxh3_update_multi_matches_single_shot(void)
 {
-    const size_t size = strlen(LOREM);
-    xxh3_128_t h = xxh3_128_scalar(LOREM, size, SEED2);
-    xxh128_canonical_t can;
-    xxh3_128_t out;
-    unsigned char expected[16];
-    size_t i;
-
-    xxh128_canonicalFromHash(&can, h);
-    out = xxh128_hashFromCanonical(&can);
-
-    /* Round-trip numeric equality */
-    TEST_ASSERT_EQUAL_UINT64(h.high, out.high);
-    TEST_ASSERT_EQUAL_UINT64(h.low, out.low);
+    const size_t   size = MULTI_STREAMS * 7 + 2 * MULTI_ROUNDS * MULTI_MAX_PACKET;
+    unsigned char* buf  = make_buf(size);
+    xxh3_state_t*  states[MULTI_STREAMS];
+    uint64_t       ref[MULTI_STREAMS], got[MULTI_STREAMS];
+    size_t         r, i;
+    int            rc = XXH3_OK;
 
-    /* Canonical MUST be big-endian, with high64 first, then low64 */
-    for (i = 0; i < 8; ++i)
-        expected[i] = (unsigned char)((h.high >> ((7 - i) * 8)) & 0xFFu);
-    for (i = 0; i < 8; ++i)
-        expected[8 + i] = (unsigned char)((h.low >> ((7 - i) * 8)) & 0xFFu);
+    TEST_ASSERT_NOT_NULL(buf);
+    for (i = 0; i < MULTI_STREAMS; i++) {
+        size_t total = 0;
+        states[i] = xxh3_createState();
+        TEST_ASSERT_NOT_NULL(states[i]);
+        for (r = 0; r < MULTI_ROUNDS; r++) {
+            total += multi_packet(r, i) + (i == 0 ? multi_packet(r, MULTI_STREAMS) : 0);
+        }
+        ref[i] = xxh3_64_scalar(buf + i * 7, total, (i & 1) ? SEED2 : SEED1);
+    }
 
-    for (size_t i = 0; i < 16; ++i) {
-        TEST_ASSERT_EQUAL_UINT((unsigned long)expected[i], (unsigned long)can.digest[i]);
+    memset(got, 0, sizeof(got));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, run_update_multi(xxh3_64_update_multi_scalar, states, buf, got));
+    assert_equal_u64_array(ref, got, MULTI_STREAMS);
+#if XXH3_HAVE_SSE2
+    memset(got, 0, sizeof(got));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, run_update_multi(xxh3_64_update_multi_sse2, states, buf, got));
+    assert_equal_u64_array(ref, got, MULTI_STREAMS);
+#endif
+#if XXH3_HAVE_AVX2
+    memset(got, 0, sizeof(got));
+    TEST_TRY_VARIANT("AVX2", {
+        rc = run_update_multi(xxh3_64_update_multi_avx2, states, buf, got);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(XXH3_OK, rc);
+            assert_equal_u64_array(ref, got, MULTI_STREAMS);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    memset(got, 0, sizeof(got));
+    TEST_TRY_VARIANT("AVX512", {
+        rc = run_update_multi(xxh3_64_update_multi_avx512, states, buf, got);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(XXH3_OK, rc);
+            assert_equal_u64_array(ref, got, MULTI_STREAMS);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    memset(got, 0, sizeof(got));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, run_update_multi(xxh3_64_update_multi_neon, states, buf, got));
+    assert_equal_u64_array(ref, got, MULTI_STREAMS);
+#endif
+#if XXH3_HAVE_SVE
+    memset(got, 0, sizeof(got));
+    TEST_TRY_VARIANT("SVE", {
+        rc = run_update_multi(xxh3_64_update_multi_sve, states, buf, got);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(XXH3_OK, rc);
+            assert_equal_u64_array(ref, got, MULTI_STREAMS);
+        }
+    });
+#endif
+    for (i = 0; i < MULTI_STREAMS; i++) {
+        xxh3_freeState(states[i]);
     }
+    free(buf);
 }
 
-/* ------------------------------------------------------ xxh64 */
+/* Fused copy-and-hash: sizes around the 240-byte, stripe and 1 KiB block
+ * edges and past the 16 KiB update_copy chunk; 64-byte aligned and
+ * misaligned destinations. */
+static const size_t COPY_SIZES[] = { 0, 1, 17, 240, 241, 1024, 1025, 4103, 70001 };
+#define COPY_MAX_LEN 70001
 
-static void test_xxh64_single_shot_stable(void)
-{
-    uint64_t a = xxh64(LOREM, strlen(LOREM), SEED2);
-    uint64_t b = xxh64(LOREM, strlen(LOREM), SEED2);
-    TEST_ASSERT_EQUAL_UINT64(a, b);
-}
+typedef uint64_t   (*copy64_fn)(void*, const void*, size_t, uint64_t);
+typedef xxh3_128_t (*copy128_fn)(void*, const void*, size_t, uint64_t);
+typedef int        (*update_copy_fn)(xxh3_state_t*, void*, const void*, size_t);
 
-static void test_xxh64_different_seeds_differ(void)
+/* Returns the number of wrong hashes or copies */
+static int run_copy(copy64_fn f64, copy128_fn f128, const unsigned char* src, unsigned char* dst)
 {
-    uint64_t a = xxh64(LOREM, strlen(LOREM), SEED1);
-    uint64_t b = xxh64(LOREM, strlen(LOREM), SEED2);
-    TEST_ASSERT_NOT_EQUAL(a, b);
+    static const size_t dst_offsets[] = { 0, 3 };
+    static const uint64_t seeds[] = { SEED1, SEED2 };
+    int    bad = 0;
+    size_t i, a, k;
+
+    for (i = 0; i < sizeof(COPY_SIZES) / sizeof(COPY_SIZES[0]); i++) {
+        const size_t len = COPY_SIZES[i];
+        for (a = 0; a < 2; a++) {
+            unsigned char* const d = dst + dst_offsets[a];
+            for (k = 0; k < 2; k++) {
+                xxh3_128_t h128, r128;
+                memset(d, 0, len);
+                bad += f64(d, src, len, seeds[k]) != xxh3_64_scalar(src, len, seeds[k]);
+                bad += memcmp(d, src, len) != 0;
+                memset(d, 0, len);
+                h128 = f128(d, src, len, seeds[k]);
+                r128 = xxh3_128_scalar(src, len, seeds[k]);
+                bad += !xxh3_128_isEqual(h128, r128);
+                bad += memcmp(d, src, len) != 0;
+            }
+        }
+    }
+    return bad;
 }
 
-static void test_xxh64_empty_input_stable(void)
+/* 64-byte aligned view of a buffer allocated with 64 spare bytes */
+static unsigned char* align64(unsigned char* p)
 {
-    uint64_t a = xxh64("", 0, SEED1);
-    uint64_t b = xxh64("", 0, SEED1);
-    TEST_ASSERT_EQUAL_UINT64(a, b);
+    return p + ((64 - ((size_t)p & 63)) & 63);
 }
 
-static void test_xxh64_stream_matches_single_shot(void)
+static void test_xxh3_copy_variants_match_memcpy_and_hash(void)
 {
-    const size_t   size  = strlen(LOREM);
-    const uint64_t ref   = xxh64(LOREM, size, SEED2);
-    xxh3_state_t*  state = xxh3_createState();
+    unsigned char* src  = make_buf(COPY_MAX_LEN);
+    unsigned char* mem  = (unsigned char*)malloc(COPY_MAX_LEN + 64 + 3);
+    unsigned char* dst;
+    int            bad = 0;
 
-    TEST_ASSERT_NOT_NULL(state);
+    TEST_ASSERT_NOT_NULL(src);
+    TEST_ASSERT_NOT_NULL(mem);
+    dst = align64(mem);
+
+    TEST_ASSERT_EQUAL_INT(0, run_copy(xxh3_64_copy_scalar, xxh3_128_copy_scalar, src, dst));
+    TEST_ASSERT_EQUAL_INT(0, run_copy(xxh3_64_copy_nt_scalar, xxh3_128_copy_nt_scalar, src, dst));
+#if XXH3_HAVE_SSE2
+    TEST_ASSERT_EQUAL_INT(0, run_copy(xxh3_64_copy_sse2, xxh3_128_copy_sse2, src, dst));
+    TEST_ASSERT_EQUAL_INT(0, run_copy(xxh3_64_copy_nt_sse2, xxh3_128_copy_nt_sse2, src, dst));
+#endif
+#if XXH3_HAVE_AVX2
+    TEST_TRY_VARIANT("AVX2", {
+        bad = run_copy(xxh3_64_copy_avx2, xxh3_128_copy_avx2, src, dst)
+            + run_copy(xxh3_64_copy_nt_avx2, xxh3_128_copy_nt_avx2, src, dst);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    TEST_TRY_VARIANT("AVX512", {
+        bad = run_copy(xxh3_64_copy_avx512, xxh3_128_copy_avx512, src, dst)
+            + run_copy(xxh3_64_copy_nt_avx512, xxh3_128_copy_nt_avx512, src, dst);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    TEST_ASSERT_EQUAL_INT(0, run_copy(xxh3_64_copy_neon, xxh3_128_copy_neon, src, dst));
+    TEST_ASSERT_EQUAL_INT(0, run_copy(xxh3_64_copy_nt_neon, xxh3_128_copy_nt_neon, src, dst));
+#endif
+#if XXH3_HAVE_SVE
+    TEST_TRY_VARIANT("SVE", {
+        bad = run_copy(xxh3_64_copy_sve, xxh3_128_copy_sve, src, dst)
+            + run_copy(xxh3_64_copy_nt_sve, xxh3_128_copy_nt_sve, src, dst);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+    (void)bad;
+    free(mem);
+    free(src);
+}
+
+/* Streams src in odd-sized pieces through fn; returns the number of wrong
+ * digests or copies */
+static int run_update_copy(update_copy_fn fn, xxh3_state_t* state,
+                           const unsigned char* src, unsigned char* dst)
+{
+    const size_t piece = 5003;
+    size_t       off, n;
+    int          bad = 0;
+
+    memset(dst, 0, COPY_MAX_LEN);
+    xxh3_64_reset(state, SEED2);
+    for (off = 0; off < COPY_MAX_LEN; off += n) {
+        n = (COPY_MAX_LEN - off < piece) ? COPY_MAX_LEN - off : piece;
+        bad += fn(state, dst + off, src + off, n) != XXH3_OK;
+    }
+    bad += xxh3_64_digest(state) != xxh3_64_scalar(src, COPY_MAX_LEN, SEED2);
+    bad += memcmp(dst, src, COPY_MAX_LEN) != 0;
+    return bad;
+}
+
+static void test_xxh3_update_copy_matches_memcpy_and_hash(void)
+{
+    unsigned char* src   = make_buf(COPY_MAX_LEN);
+    unsigned char* dst   = (unsigned char*)malloc(COPY_MAX_LEN);
+    xxh3_state_t*  state = xxh3_createState();
+    int            bad   = 0;
+
+    TEST_ASSERT_NOT_NULL(src);
+    TEST_ASSERT_NOT_NULL(dst);
+    TEST_ASSERT_NOT_NULL(state);
+
+    TEST_ASSERT_EQUAL_INT(0, run_update_copy(xxh3_64_update_copy_scalar, state, src, dst));
+#if XXH3_HAVE_SSE2
+    TEST_ASSERT_EQUAL_INT(0, run_update_copy(xxh3_64_update_copy_sse2, state, src, dst));
+#endif
+#if XXH3_HAVE_AVX2
+    TEST_TRY_VARIANT("AVX2", {
+        bad = run_update_copy(xxh3_64_update_copy_avx2, state, src, dst);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    TEST_TRY_VARIANT("AVX512", {
+        bad = run_update_copy(xxh3_64_update_copy_avx512, state, src, dst);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    TEST_ASSERT_EQUAL_INT(0, run_update_copy(xxh3_64_update_copy_neon, state, src, dst));
+#endif
+#if XXH3_HAVE_SVE
+    TEST_TRY_VARIANT("SVE", {
+        bad = run_update_copy(xxh3_64_update_copy_sve, state, src, dst);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+    (void)bad;
+    xxh3_freeState(state);
+    free(dst);
+    free(src);
+}
+
+/* C-string hashing: lengths around the 64-byte line, 240-byte and 1 KiB
+ * block edges at every start offset within a line; SEED1 (0) takes the
+ * default secret. */
+static const size_t CSTR_LENS[] = { 0, 1, 15, 16, 63, 64, 65, 127, 240, 241, 1023, 1024, 1025, 2049, 5000 };
+#define CSTR_MAX_LEN 5000
+
+typedef uint64_t   (*cstr64_fn)(const char*, size_t*, uint64_t);
+typedef xxh3_128_t (*cstr128_fn)(const char*, size_t*, uint64_t);
+
+/* Returns the number of wrong hashes or lengths. `text` is 64-byte aligned
+ * and holds CSTR_MAX_LEN + 64 non-zero bytes; `page_end`, if not NULL, is a
+ * NUL right before an inaccessible page, preceded by non-zero bytes. */
+static int run_cstr(cstr64_fn f64, cstr128_fn f128, char* text, const char* page_end)
+{
+    static const uint64_t seeds[] = { SEED1, SEED2 };
+    int    bad = 0;
+    size_t i, off, k;
+
+    for (i = 0; i < sizeof(CSTR_LENS) / sizeof(CSTR_LENS[0]); i++) {
+        const size_t len = CSTR_LENS[i];
+        for (off = 0; off < 64; off++) {
+            char* const s     = text + off;
+            const char  saved = s[len];
+            s[len] = '\0';
+            for (k = 0; k < 2; k++) {
+                size_t     got = (size_t)-1;
+                xxh3_128_t h128;
+                bad += f64(s, &got, seeds[k]) != xxh3_64_scalar(s, len, seeds[k]);
+                bad += got != len;
+                got  = (size_t)-1;
+                h128 = f128(s, &got, seeds[k]);
+                bad += !xxh3_128_isEqual(h128, xxh3_128_scalar(s, len, seeds[k]));
+                bad += got != len;
+            }
+            s[len] = saved;
+        }
+    }
+
+    if (page_end != NULL) {
+        for (i = 0; i < sizeof(CSTR_LENS) / sizeof(CSTR_LENS[0]); i++) {
+            const char* const s = page_end - CSTR_LENS[i];
+            size_t            got = (size_t)-1;
+            bad += f64(s, &got, SEED2) != xxh3_64_scalar(s, CSTR_LENS[i], SEED2);
+            bad += got != CSTR_LENS[i];
+            bad += !xxh3_128_isEqual(f128(s, NULL, SEED2), xxh3_128_scalar(s, CSTR_LENS[i], SEED2));
+        }
+    }
+    return bad;
+}
+
+/* Fills [p, p + n) with non-zero bytes */
+static void fill_nonzero(char* p, size_t n)
+{
+    size_t i;
+    for (i = 0; i < n; i++) {
+        p[i] = (char)(1 + (i ^ (i >> 8)) % 255);
+    }
+}
+
+static void test_xxh3_cstr_matches_sized_hash(void)
+{
+    char* mem      = (char*)malloc(CSTR_MAX_LEN + 64 + 64);
+    char* text;
+    char* page_mem = NULL;
+    char* page_end = NULL;
+    int   bad      = 0;
+
+    TEST_ASSERT_NOT_NULL(mem);
+    text = (char*)align64((unsigned char*)mem);
+    fill_nonzero(text, CSTR_MAX_LEN + 64);
+#if TEST_HAVE_MPROTECT
+    {   /* a string ending right before a PROT_NONE page */
+        const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        const size_t body = (CSTR_MAX_LEN + 1 + page - 1) / page * page;
+        void*        p    = NULL;
+        TEST_ASSERT_EQUAL_INT(0, posix_memalign(&p, page, body + page));
+        page_mem = (char*)p;
+        fill_nonzero(page_mem, body - 1);
+        page_end  = page_mem + body - 1;
+        *page_end = '\0';
+        TEST_ASSERT_EQUAL_INT(0, mprotect(page_mem + body, page, PROT_NONE));
+    }
+#endif
+
+    TEST_ASSERT_EQUAL_INT(0, run_cstr(xxh3_64_cstr_scalar, xxh3_128_cstr_scalar, text, page_end));
+#if XXH3_HAVE_SSE2
+    TEST_ASSERT_EQUAL_INT(0, run_cstr(xxh3_64_cstr_sse2, xxh3_128_cstr_sse2, text, page_end));
+#endif
+#if XXH3_HAVE_AVX2
+    TEST_TRY_VARIANT("AVX2", {
+        bad = run_cstr(xxh3_64_cstr_avx2, xxh3_128_cstr_avx2, text, page_end);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+    /* a load past the terminator would fault as SIGSEGV, not SIGILL */
+    TEST_ASSERT_NOT_EQUAL(SIGSEGV, (int)_test_caught_sig);
+#endif
+#if XXH3_HAVE_AVX512
+    TEST_TRY_VARIANT("AVX512", {
+        bad = run_cstr(xxh3_64_cstr_avx512, xxh3_128_cstr_avx512, text, page_end);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+    TEST_ASSERT_NOT_EQUAL(SIGSEGV, (int)_test_caught_sig);
+#endif
+#if XXH3_HAVE_NEON
+    TEST_ASSERT_EQUAL_INT(0, run_cstr(xxh3_64_cstr_neon, xxh3_128_cstr_neon, text, page_end));
+#endif
+#if XXH3_HAVE_SVE
+    TEST_TRY_VARIANT("SVE", {
+        bad = run_cstr(xxh3_64_cstr_sve, xxh3_128_cstr_sve, text, page_end);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+    TEST_ASSERT_NOT_EQUAL(SIGSEGV, (int)_test_caught_sig);
+#endif
+    (void)bad;
+#if TEST_HAVE_MPROTECT
+    {   const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        const size_t body = (size_t)(page_end + 1 - page_mem);
+        TEST_ASSERT_EQUAL_INT(0, mprotect(page_mem + body, page, PROT_READ | PROT_WRITE));
+        free(page_mem);
+    }
+#endif
+    free(mem);
+}
+
+#define CI_MAX_LEN 5000
+
+typedef uint64_t (*ci_fn)(const void*, size_t, uint64_t);
+typedef void (*ci_batch_fn)(const void* const*, const size_t*, size_t, uint64_t, uint64_t*);
+typedef int (*ci_update_fn)(xxh3_state_t*, const void*, size_t);
+
+/* Checks f, fb and fu against xxh3_64_scalar() of `lower`, the ASCII
+ * lowercase of `text` (CI_MAX_LEN + 64 bytes each): every length up to
+ * 300 and a few long ones at offsets 0..3, the batch form over the same
+ * inputs, and streams cut into pieces of several sizes. Returns the number
+ * of mismatches. */
+static int run_ci(ci_fn f, ci_batch_fn fb, ci_update_fn fu, xxh3_state_t* state,
+                  const unsigned char* text, const unsigned char* lower)
+{
+    static const size_t long_lens[] = { 1023, 1025, 2049, CI_MAX_LEN };
+    static const size_t pieces[]    = { 1, 7, 64, 255, 256, 1000 };
+    const void* inputs[301 + 4];
+    size_t      sizes[301 + 4];
+    uint64_t    out[301 + 4];
+    size_t      n = 0, i, off, p;
+    int         bad = 0;
+
+    for (i = 0; i < 301 + 4; i++) {
+        size_t const len = (i <= 300) ? i : long_lens[i - 301];
+        for (off = 0; off < 4; off++) {
+            bad += f(text + off, len, SEED1) != xxh3_64_scalar(lower + off, len, SEED1);
+            bad += f(text + off, len, SEED2) != xxh3_64_scalar(lower + off, len, SEED2);
+        }
+        inputs[n] = text + (i & 3);
+        sizes[n]  = len;
+        n++;
+    }
+    fb(inputs, sizes, n, SEED2, out);
+    for (i = 0; i < n; i++) {
+        bad += out[i] != xxh3_64_scalar(lower + (i & 3), sizes[i], SEED2);
+    }
+    for (p = 0; p < sizeof(pieces) / sizeof(pieces[0]); p++) {
+        xxh3_64_reset(state, SEED2);
+        for (off = 0; off < CI_MAX_LEN; off += pieces[p]) {
+            size_t const len = (CI_MAX_LEN - off < pieces[p]) ? CI_MAX_LEN - off : pieces[p];
+            bad += fu(state, text + off, len) != XXH3_OK;
+        }
+        bad += xxh3_64_digest(state) != xxh3_64_scalar(lower, CI_MAX_LEN, SEED2);
+    }
+    return bad;
+}
+
+static void test_xxh3_64_ci_matches_lowercased_hash(void)
+{
+    unsigned char* text  = (unsigned char*)malloc(CI_MAX_LEN + 64);
+    unsigned char* lower = (unsigned char*)malloc(CI_MAX_LEN + 64);
+    xxh3_state_t*  state = xxh3_createState();
+    int            bad   = 0;
+    size_t         i;
+
+    TEST_ASSERT_NOT_NULL(text);
+    TEST_ASSERT_NOT_NULL(lower);
+    TEST_ASSERT_NOT_NULL(state);
+    /* every byte value in each 256-byte window, letters from the first bytes
+     * on, so that the short paths see '@' '[' '`' '{' and bytes >= 0x80 */
+    for (i = 0; i < CI_MAX_LEN + 64; i++) {
+        text[i]  = (unsigned char)((i * 7 + 0x3C) ^ (i >> 8));
+        lower[i] = (text[i] >= 'A' && text[i] <= 'Z') ? (unsigned char)(text[i] + 32) : text[i];
+    }
+    TEST_ASSERT_NOT_EQUAL(xxh3_64_scalar(text, CI_MAX_LEN, SEED1),
+                          xxh3_64_scalar(lower, CI_MAX_LEN, SEED1));
+
+    TEST_ASSERT_EQUAL_INT(0, run_ci(xxh3_64_ci_scalar, xxh3_64_ci_batch_scalar,
+                                    xxh3_64_ci_update_scalar, state, text, lower));
+#if XXH3_HAVE_SSE2
+    TEST_ASSERT_EQUAL_INT(0, run_ci(xxh3_64_ci_sse2, xxh3_64_ci_batch_sse2,
+                                    xxh3_64_ci_update_sse2, state, text, lower));
+#endif
+#if XXH3_HAVE_AVX2
+    TEST_TRY_VARIANT("AVX2", {
+        bad = run_ci(xxh3_64_ci_avx2, xxh3_64_ci_batch_avx2, xxh3_64_ci_update_avx2,
+                     state, text, lower);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    TEST_TRY_VARIANT("AVX512", {
+        bad = run_ci(xxh3_64_ci_avx512, xxh3_64_ci_batch_avx512, xxh3_64_ci_update_avx512,
+                     state, text, lower);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    TEST_ASSERT_EQUAL_INT(0, run_ci(xxh3_64_ci_neon, xxh3_64_ci_batch_neon,
+                                    xxh3_64_ci_update_neon, state, text, lower));
+#endif
+#if XXH3_HAVE_SVE
+    TEST_TRY_VARIANT("SVE", {
+        bad = run_ci(xxh3_64_ci_sve, xxh3_64_ci_batch_sve, xxh3_64_ci_update_sve,
+                     state, text, lower);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+    (void)bad;
+    xxh3_freeState(state);
+    free(lower);
+    free(text);
+}
+
+#define GATHER_MEM (64 * 1024)
+
+typedef uint64_t (*strided2d_fn)(const void*, size_t, size_t, size_t, uint64_t);
+typedef uint64_t (*gather_fn)(const void*, size_t, size_t, const xxh3_field_t*, size_t, uint64_t);
+
+/* Lays the fields of `count` records end to end in tmp, returns the length */
+static size_t gather_ref(unsigned char* tmp, const unsigned char* records, size_t record_size,
+                         size_t count, const xxh3_field_t* fields, size_t nfields)
+{
+    size_t n = 0, r, i;
+
+    for (r = 0; r < count; r++) {
+        for (i = 0; i < nfields; i++) {
+            memcpy(tmp + n, records + r * record_size + fields[i].offset, fields[i].length);
+            n += fields[i].length;
+        }
+    }
+    return n;
+}
+
+/* Checks fs and fg against xxh3_64_scalar() of the gathered bytes: pitched
+ * rows with and without padding, and records with adjacent, reordered, empty,
+ * overlapping and whole-record fields, short and long. Returns the number of
+ * mismatches. */
+static int run_gather(strided2d_fn fs, gather_fn fg, const unsigned char* mem, unsigned char* tmp)
+{
+    static const size_t row_bytes[] = { 1, 7, 64, 100, 1000 };
+    static const size_t rows[]      = { 0, 1, 3, 50 };
+    static const size_t pads[]      = { 0, 1, 64 };
+    static const size_t counts[]    = { 0, 1, 5, 6, 40, 300, 1000 };
+    static const xxh3_field_t f_adjacent[] = { { 0, 8 }, { 8, 4 }, { 20, 16 } };
+    static const xxh3_field_t f_reorder[]  = { { 16, 8 }, { 0, 8 }, { 0, 0 }, { 40, 8 } };
+    static const xxh3_field_t f_overlap[]  = { { 4, 20 }, { 10, 20 } };
+    static const xxh3_field_t f_whole[]    = { { 0, 48 } };
+    static const struct { const xxh3_field_t* f; size_t n; } sets[] = {
+        { f_adjacent, 3 }, { f_reorder, 4 }, { f_overlap, 2 }, { f_whole, 1 }, { f_whole, 0 },
+    };
+    size_t a, b, c;
+    int    bad = 0;
+
+    for (a = 0; a < sizeof(row_bytes) / sizeof(row_bytes[0]); a++) {
+        for (b = 0; b < sizeof(rows) / sizeof(rows[0]); b++) {
+            for (c = 0; c < sizeof(pads) / sizeof(pads[0]); c++) {
+                xxh3_field_t const row = { 0, row_bytes[a] };
+                size_t const pitch = row_bytes[a] + pads[c];
+                size_t const len   = gather_ref(tmp, mem, pitch, rows[b], &row, 1);
+                bad += fs(mem, row_bytes[a], rows[b], pitch, SEED1) != xxh3_64_scalar(tmp, len, SEED1);
+                bad += fs(mem, row_bytes[a], rows[b], pitch, SEED2) != xxh3_64_scalar(tmp, len, SEED2);
+            }
+        }
+    }
+    for (a = 0; a < sizeof(sets) / sizeof(sets[0]); a++) {
+        for (b = 0; b < sizeof(counts) / sizeof(counts[0]); b++) {
+            size_t const len = gather_ref(tmp, mem, 48, counts[b], sets[a].f, sets[a].n);
+            bad += fg(mem, 48, counts[b], sets[a].f, sets[a].n, SEED1) != xxh3_64_scalar(tmp, len, SEED1);
+            bad += fg(mem, 48, counts[b], sets[a].f, sets[a].n, SEED2) != xxh3_64_scalar(tmp, len, SEED2);
+        }
+    }
+    return bad;
+}
+
+static void test_xxh3_64_strided2d_and_gather_match_contiguous(void)
+{
+    unsigned char* mem = make_buf(GATHER_MEM);
+    unsigned char* tmp = (unsigned char*)malloc(GATHER_MEM);
+    int            bad = 0;
+
+    TEST_ASSERT_NOT_NULL(mem);
+    TEST_ASSERT_NOT_NULL(tmp);
+    TEST_ASSERT_EQUAL_INT(0, run_gather(xxh3_64_strided2d_scalar, xxh3_64_gather_scalar, mem, tmp));
+#if XXH3_HAVE_SSE2
+    TEST_ASSERT_EQUAL_INT(0, run_gather(xxh3_64_strided2d_sse2, xxh3_64_gather_sse2, mem, tmp));
+#endif
+#if XXH3_HAVE_AVX2
+    TEST_TRY_VARIANT("AVX2", {
+        bad = run_gather(xxh3_64_strided2d_avx2, xxh3_64_gather_avx2, mem, tmp);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    TEST_TRY_VARIANT("AVX512", {
+        bad = run_gather(xxh3_64_strided2d_avx512, xxh3_64_gather_avx512, mem, tmp);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    TEST_ASSERT_EQUAL_INT(0, run_gather(xxh3_64_strided2d_neon, xxh3_64_gather_neon, mem, tmp));
+#endif
+#if XXH3_HAVE_SVE
+    TEST_TRY_VARIANT("SVE", {
+        bad = run_gather(xxh3_64_strided2d_sve, xxh3_64_gather_sve, mem, tmp);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+    (void)bad;
+    free(tmp);
+    free(mem);
+}
+
+/* ------------------------------------------------------ xxh32 */
+
+static void test_xxh32_single_shot_stable(void)
+{
+    uint32_t a = xxh32(LOREM, strlen(LOREM), SEED32_1);
+    uint32_t b = xxh32(LOREM, strlen(LOREM), SEED32_1);
+    TEST_ASSERT_EQUAL_UINT32(a, b);
+}
+
+static void test_xxh32_different_seeds_differ(void)
+{
+    uint32_t a = xxh32(LOREM, strlen(LOREM), SEED32_0);
+    uint32_t b = xxh32(LOREM, strlen(LOREM), SEED32_1);
+    TEST_ASSERT_NOT_EQUAL(a, b);
+}
+
+static void test_xxh32_empty_input_stable(void)
+{
+    uint32_t a = xxh32("", 0, SEED32_0);
+    uint32_t b = xxh32("", 0, SEED32_0);
+    TEST_ASSERT_EQUAL_UINT32(a, b);
+}
+
+static void test_xxh32_stream_matches_single_shot(void)
+{
+    const size_t   size  = strlen(LOREM);
+    const uint32_t ref   = xxh32(LOREM, size, SEED32_1);
+    xxh3_state_t*  state = xxh3_createState();
+
+    TEST_ASSERT_NOT_NULL(state);
+    xxh32_reset(state, SEED32_1);
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh32_update(state, LOREM, size));
+    TEST_ASSERT_EQUAL_UINT32(ref, xxh32_digest(state));
+    xxh3_freeState(state);
+}
+
+static void test_xxh32_chunked_streaming_matches_single_shot(void)
+{
+    const size_t   size  = strlen(LOREM);
+    const size_t   chunk = 8;
+    const uint32_t ref   = xxh32(LOREM, size, SEED32_0);
+    xxh3_state_t*  state = xxh3_createState();
+    size_t         offset;
+
+    TEST_ASSERT_NOT_NULL(state);
+    xxh32_reset(state, SEED32_0);
+    for (offset = 0; offset + chunk <= size; offset += chunk) {
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh32_update(state, LOREM + offset, chunk));
+    }
+    if (offset < size) {
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh32_update(state, LOREM + offset, size - offset));
+    }
+    TEST_ASSERT_EQUAL_UINT32(ref, xxh32_digest(state));
+    xxh3_freeState(state);
+}
+
+static void test_xxh32_stream_reset_reuse(void)
+{
+    const size_t   size  = strlen(SHORT_INPUT);
+    const uint32_t ref   = xxh32(SHORT_INPUT, size, SEED32_1);
+    xxh3_state_t*  state = xxh3_createState();
+
+    TEST_ASSERT_NOT_NULL(state);
+    xxh32_reset(state, SEED32_1);
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh32_update(state, SHORT_INPUT, size));
+    TEST_ASSERT_EQUAL_UINT32(ref, xxh32_digest(state));
+
+    xxh32_reset(state, SEED32_1);
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh32_update(state, SHORT_INPUT, size));
+    TEST_ASSERT_EQUAL_UINT32(ref, xxh32_digest(state));
+    xxh3_freeState(state);
+}
+
+static void test_xxh32_vector_variants_match_scalar(void)
+{
+    const size_t   max = (1u << 16) + 64;
+    unsigned char* buf = make_buf(max);
+    size_t         size, align;
+
+    TEST_ASSERT_NOT_NULL(buf);
+    for (align = 0; align < 2; align++) {
+        for (size = 0; size + align <= max; size = (size < 80) ? size + 1 : size * 2 + 3) {
+            const uint32_t ref = xxh32(buf + align, size, SEED32_1);
+            (void)ref;  /* unused when neither variant is built */
+#if XXH3_HAVE_SSE41
+            TEST_TRY_VARIANT("SSE4.1", {
+                uint32_t sse41_result = xxh32_sse41(buf + align, size, SEED32_1);
+                if (!_test_skip_variant) {
+                    TEST_ASSERT_EQUAL_UINT32(ref, sse41_result);
+                }
+            });
+#endif
+#if XXH3_HAVE_NEON
+            TEST_ASSERT_EQUAL_UINT32(ref, xxh32_neon(buf + align, size, SEED32_1));
+#endif
+        }
+    }
+    free(buf);
+}
+
+static void test_xxh32_vector_stream_matches_single_shot(void)
+{
+    const size_t   size  = 10007;
+    const size_t   chunk = 13;  /* odd size: leaves partial stripes buffered */
+    unsigned char* buf   = make_buf(size);
+    xxh3_state_t*  state = xxh3_createState();
+    xxh3_state_t*  copy;
+    uint32_t       ref;
+    size_t         offset;
+
+    TEST_ASSERT_NOT_NULL(buf);
+    TEST_ASSERT_NOT_NULL(state);
+    ref = xxh32(buf, size, SEED32_1);
+    (void)ref; (void)chunk; (void)offset;  /* unused when neither variant is built */
+#if XXH3_HAVE_SSE41
+    TEST_TRY_VARIANT("SSE4.1", {
+        int ok = 1;
+        xxh32_reset(state, SEED32_1);
+        /* chunked vector updates, then one regular update for the rest */
+        for (offset = 0; offset + chunk <= size / 2; offset += chunk) {
+            ok &= xxh32_update_sse41(state, buf + offset, chunk) == XXH3_OK;
+        }
+        ok &= xxh32_update(state, buf + offset, size / 2 - offset) == XXH3_OK;
+        ok &= xxh32_update_sse41(state, buf + size / 2, size - size / 2) == XXH3_OK;
+        if (!_test_skip_variant) {
+            TEST_ASSERT_TRUE(ok);
+            TEST_ASSERT_EQUAL_UINT32(ref, xxh32_digest(state));
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    xxh32_reset(state, SEED32_1);
+    for (offset = 0; offset + chunk <= size / 2; offset += chunk) {
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh32_update_neon(state, buf + offset, chunk));
+    }
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh32_update(state, buf + offset, size / 2 - offset));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh32_update_neon(state, buf + size / 2, size - size / 2));
+    TEST_ASSERT_EQUAL_UINT32(ref, xxh32_digest(state));
+#endif
+
+    /* xxh3_copyState() carries the XXH32 stream, buffered bytes included */
+    copy = xxh3_createState();
+    TEST_ASSERT_NOT_NULL(copy);
+    xxh32_reset(state, SEED32_1);
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh32_update(state, buf, 1007));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_copyState(copy, state));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh32_update(copy, buf + 1007, size - 1007));
+    TEST_ASSERT_EQUAL_UINT32(ref, xxh32_digest(copy));
+    xxh3_freeState(copy);
+    xxh3_freeState(state);
+    free(buf);
+}
+
+/* ------------------------------------------------ multi-buffer xxh32/xxh64 */
+
+/* Sizes around the 16- / 32-byte stripe edges plus long messages that keep
+ * one lane busy while the others are refilled. */
+static const size_t BATCH_SIZES[] = {
+    0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 100, 4099, 255, 256, 1000, 7, 65537
+};
+#define BATCH_COUNT 37   /* not a multiple of any lane count */
+
+static unsigned char* make_batch(const void** inputs, size_t* sizes)
+{
+    unsigned char* buf = make_buf(65537 + 16);
+    size_t         i;
+
+    for (i = 0; buf != NULL && i < BATCH_COUNT; i++) {
+        sizes[i]  = BATCH_SIZES[i % (sizeof(BATCH_SIZES) / sizeof(BATCH_SIZES[0]))];
+        inputs[i] = buf + i % 13;  /* varying alignment */
+    }
+    return buf;
+}
+
+static void assert_batch64_equal(const uint64_t* ref, const uint64_t* got)
+{
+    size_t i;
+    for (i = 0; i < BATCH_COUNT; i++) {
+        TEST_ASSERT_EQUAL_UINT64(ref[i], got[i]);
+    }
+}
+
+static void assert_batch32_equal(const uint32_t* ref, const uint32_t* got)
+{
+    size_t i;
+    for (i = 0; i < BATCH_COUNT; i++) {
+        TEST_ASSERT_EQUAL_UINT32(ref[i], got[i]);
+    }
+}
+
+static void test_xxh64_batch_variants_match_single_shot(void)
+{
+    const void*    inputs[BATCH_COUNT];
+    size_t         sizes[BATCH_COUNT];
+    uint64_t       ref[BATCH_COUNT], got[BATCH_COUNT];
+    unsigned char* buf = make_batch(inputs, sizes);
+    size_t         i;
+
+    TEST_ASSERT_NOT_NULL(buf);
+    for (i = 0; i < BATCH_COUNT; i++) {
+        ref[i] = xxh64(inputs[i], sizes[i], SEED2);
+    }
+
+    memset(got, 0, sizeof(got));
+    xxh64_batch_scalar(inputs, sizes, BATCH_COUNT, SEED2, got);
+    assert_batch64_equal(ref, got);
+#if XXH3_HAVE_AVX2
+    memset(got, 0, sizeof(got));
+    TEST_TRY_VARIANT("AVX2", {
+        xxh64_batch_avx2(inputs, sizes, BATCH_COUNT, SEED2, got);
+        if (!_test_skip_variant) {
+            assert_batch64_equal(ref, got);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    memset(got, 0, sizeof(got));
+    TEST_TRY_VARIANT("AVX512", {
+        xxh64_batch_avx512(inputs, sizes, BATCH_COUNT, SEED2, got);
+        if (!_test_skip_variant) {
+            assert_batch64_equal(ref, got);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    memset(got, 0, sizeof(got));
+    xxh64_batch_neon(inputs, sizes, BATCH_COUNT, SEED2, got);
+    assert_batch64_equal(ref, got);
+#endif
+    free(buf);
+}
+
+static void test_xxh32_batch_variants_match_single_shot(void)
+{
+    const void*    inputs[BATCH_COUNT];
+    size_t         sizes[BATCH_COUNT];
+    uint32_t       ref[BATCH_COUNT], got[BATCH_COUNT];
+    unsigned char* buf = make_batch(inputs, sizes);
+    size_t         i;
+
+    TEST_ASSERT_NOT_NULL(buf);
+    for (i = 0; i < BATCH_COUNT; i++) {
+        ref[i] = xxh32(inputs[i], sizes[i], SEED32_1);
+    }
+
+    memset(got, 0, sizeof(got));
+    xxh32_batch_scalar(inputs, sizes, BATCH_COUNT, SEED32_1, got);
+    assert_batch32_equal(ref, got);
+#if XXH3_HAVE_SSE41
+    memset(got, 0, sizeof(got));
+    TEST_TRY_VARIANT("SSE4.1", {
+        xxh32_batch_sse41(inputs, sizes, BATCH_COUNT, SEED32_1, got);
+        if (!_test_skip_variant) {
+            assert_batch32_equal(ref, got);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX2
+    memset(got, 0, sizeof(got));
+    TEST_TRY_VARIANT("AVX2", {
+        xxh32_batch_avx2(inputs, sizes, BATCH_COUNT, SEED32_1, got);
+        if (!_test_skip_variant) {
+            assert_batch32_equal(ref, got);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    memset(got, 0, sizeof(got));
+    TEST_TRY_VARIANT("AVX512", {
+        xxh32_batch_avx512(inputs, sizes, BATCH_COUNT, SEED32_1, got);
+        if (!_test_skip_variant) {
+            assert_batch32_equal(ref, got);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    memset(got, 0, sizeof(got));
+    xxh32_batch_neon(inputs, sizes, BATCH_COUNT, SEED32_1, got);
+    assert_batch32_equal(ref, got);
+#endif
+    free(buf);
+}
+
+/* ------------------------------------------------------ multi-seed xxh3_64 */
+
+#define MS_SEEDS 37      /* not a multiple of any lane count */
+#define MS_MAX_LEN 300   /* covers every <= 240 byte path and the long path */
+
+typedef void (*multiseed_fn)(const void*, size_t, const uint64_t*, size_t, uint64_t*);
+
+static void make_seeds(uint64_t* seeds)
+{
+    uint64_t s = SEED2;
+    size_t   j;
+
+    seeds[0] = 0;
+    for (j = 1; j < MS_SEEDS; j++) {
+        s = s * 6364136223846793005ULL + 1442695040888963407ULL;
+        seeds[j] = s;
+    }
+}
+
+/* got[len * MS_SEEDS + j]: fn over buf + len % 7 for every len <= MS_MAX_LEN */
+static void run_multiseed(multiseed_fn fn, const unsigned char* buf,
+                          const uint64_t* seeds, uint64_t* got)
+{
+    size_t len;
+
+    for (len = 0; len <= MS_MAX_LEN; len++) {
+        fn(buf + len % 7, len, seeds, MS_SEEDS, got + len * MS_SEEDS);
+    }
+}
+
+static void assert_multiseed_equal(const uint64_t* ref, const uint64_t* got)
+{
+    size_t i;
+    for (i = 0; i < (MS_MAX_LEN + 1) * MS_SEEDS; i++) {
+        TEST_ASSERT_EQUAL_UINT64(ref[i], got[i]);
+    }
+}
+
+static void test_xxh3_64_multiseed_variants_match_per_seed(void)
+{
+    const size_t   n   = (MS_MAX_LEN + 1) * MS_SEEDS;
+    unsigned char* buf = make_buf(MS_MAX_LEN + 8);
+    uint64_t*      ref = (uint64_t*)malloc(n * sizeof(uint64_t));
+    uint64_t*      got = (uint64_t*)malloc(n * sizeof(uint64_t));
+    uint64_t       seeds[MS_SEEDS];
+    size_t         len, j;
+
+    TEST_ASSERT_NOT_NULL(buf);
+    TEST_ASSERT_NOT_NULL(ref);
+    TEST_ASSERT_NOT_NULL(got);
+    make_seeds(seeds);
+    for (len = 0; len <= MS_MAX_LEN; len++) {
+        for (j = 0; j < MS_SEEDS; j++) {
+            ref[len * MS_SEEDS + j] = xxh3_64_scalar(buf + len % 7, len, seeds[j]);
+        }
+    }
+
+    memset(got, 0, n * sizeof(uint64_t));
+    run_multiseed(xxh3_64_multiseed_scalar, buf, seeds, got);
+    assert_multiseed_equal(ref, got);
+#if XXH3_HAVE_SSE2
+    memset(got, 0, n * sizeof(uint64_t));
+    run_multiseed(xxh3_64_multiseed_sse2, buf, seeds, got);
+    assert_multiseed_equal(ref, got);
+#endif
+#if XXH3_HAVE_AVX2
+    memset(got, 0, n * sizeof(uint64_t));
+    TEST_TRY_VARIANT("AVX2", {
+        run_multiseed(xxh3_64_multiseed_avx2, buf, seeds, got);
+        if (!_test_skip_variant) {
+            assert_multiseed_equal(ref, got);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    memset(got, 0, n * sizeof(uint64_t));
+    TEST_TRY_VARIANT("AVX512", {
+        run_multiseed(xxh3_64_multiseed_avx512, buf, seeds, got);
+        if (!_test_skip_variant) {
+            assert_multiseed_equal(ref, got);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    memset(got, 0, n * sizeof(uint64_t));
+    run_multiseed(xxh3_64_multiseed_neon, buf, seeds, got);
+    assert_multiseed_equal(ref, got);
+#endif
+#if XXH3_HAVE_SVE
+    memset(got, 0, n * sizeof(uint64_t));
+    TEST_TRY_VARIANT("SVE", {
+        run_multiseed(xxh3_64_multiseed_sve, buf, seeds, got);
+        if (!_test_skip_variant) {
+            assert_multiseed_equal(ref, got);
+        }
+    });
+#endif
+    free(got);
+    free(ref);
+    free(buf);
+}
+
+static void test_xxh3_64_multiseed_batch_matches_per_seed(void)
+{
+    const void*    inputs[BATCH_COUNT];
+    size_t         sizes[BATCH_COUNT];
+    uint64_t       seeds[MS_SEEDS];
+    uint64_t*      got = (uint64_t*)malloc(BATCH_COUNT * MS_SEEDS * sizeof(uint64_t));
+    unsigned char* buf = make_batch(inputs, sizes);
+    size_t         i, j;
+
+    TEST_ASSERT_NOT_NULL(buf);
+    TEST_ASSERT_NOT_NULL(got);
+    make_seeds(seeds);
+    memset(got, 0, BATCH_COUNT * MS_SEEDS * sizeof(uint64_t));
+    xxh3_64_multiseed_batch_scalar(inputs, sizes, BATCH_COUNT, seeds, MS_SEEDS, got);
+    for (i = 0; i < BATCH_COUNT; i++) {
+        for (j = 0; j < MS_SEEDS; j++) {
+            TEST_ASSERT_EQUAL_UINT64(xxh3_64_scalar(inputs[i], sizes[i], seeds[j]),
+                                     got[i * MS_SEEDS + j]);
+        }
+    }
+    free(got);
+    free(buf);
+}
+
+/* ---------------------------------------------------- Canonical representation tests */
+
+static void test_xxh32_canonical_roundtrip(void)
+{
+    const size_t size = strlen(SHORT_INPUT);
+    uint32_t h = xxh32(SHORT_INPUT, size, SEED32_1);
+    xxh32_canonical_t can;
+    unsigned char expected[4];
+
+    xxh32_canonicalFromHash(&can, h);
+
+    /* Round-trip numeric equality */
+    TEST_ASSERT_EQUAL_UINT32(h, xxh32_hashFromCanonical(&can));
+
+    /* Canonical form MUST be big-endian */
+    expected[0] = (unsigned char)((h >> 24) & 0xFFu);
+    expected[1] = (unsigned char)((h >> 16) & 0xFFu);
+    expected[2] = (unsigned char)((h >> 8)  & 0xFFu);
+    expected[3] = (unsigned char)(h & 0xFFu);
+    for (size_t i = 0; i < 4; ++i) {
+        TEST_ASSERT_EQUAL_UINT((unsigned long)expected[i], (unsigned long)can.digest[i]);
+    }
+}
+
+static void test_xxh64_canonical_roundtrip(void)
+{
+    const size_t size = strlen(SHORT_INPUT);
+    uint64_t h = xxh64(SHORT_INPUT, size, SEED2);
+    xxh64_canonical_t can;
+    unsigned char expected[8];
+
+    xxh64_canonicalFromHash(&can, h);
+
+    /* Round-trip numeric equality */
+    TEST_ASSERT_EQUAL_UINT64(h, xxh64_hashFromCanonical(&can));
+
+    /* Canonical form MUST be big-endian */
+    expected[0] = (unsigned char)((h >> 56) & 0xFFu);
+    expected[1] = (unsigned char)((h >> 48) & 0xFFu);
+    expected[2] = (unsigned char)((h >> 40) & 0xFFu);
+    expected[3] = (unsigned char)((h >> 32) & 0xFFu);
+    expected[4] = (unsigned char)((h >> 24) & 0xFFu);
+    expected[5] = (unsigned char)((h >> 16) & 0xFFu);
+    expected[6] = (unsigned char)((h >> 8)  & 0xFFu);
+    expected[7] = (unsigned char)(h & 0xFFu);
+    for (size_t i = 0; i < 8; ++i) {
+        TEST_ASSERT_EQUAL_UINT((unsigned long)expected[i], (unsigned long)can.digest[i]);
+    }
+}
+
+static void test_xxh128_canonical_roundtrip(void)
+{
+    const size_t size = strlen(LOREM);
+    xxh3_128_t h = xxh3_128_scalar(LOREM, size, SEED2);
+    xxh128_canonical_t can;
+    xxh3_128_t out;
+    unsigned char expected[16];
+    size_t i;
+
+    xxh128_canonicalFromHash(&can, h);
+    out = xxh128_hashFromCanonical(&can);
+
+    /* Round-trip numeric equality */
+    TEST_ASSERT_EQUAL_UINT64(h.high, out.high);
+    TEST_ASSERT_EQUAL_UINT64(h.low, out.low);
+
+    /* Canonical MUST be big-endian, with high64 first, then low64 */
+    for (i = 0; i < 8; ++i)
+        expected[i] = (unsigned char)((h.high >> ((7 - i) * 8)) & 0xFFu);
+    for (i = 0; i < 8; ++i)
+        expected[8 + i] = (unsigned char)((h.low >> ((7 - i) * 8)) & 0xFFu);
+
+    for (size_t i = 0; i < 16; ++i) {
+        TEST_ASSERT_EQUAL_UINT((unsigned long)expected[i], (unsigned long)can.digest[i]);
+    }
+}
+
+/* Digests for the sort tests: random, with repeats, pairs that share `low`
+ * and differ in `high` (down to its last byte), and a run of equal values */
+static void make_sort_input(xxh3_128_t* h, size_t n, uint64_t seed)
+{
+    size_t i;
+    for (i = 0; i < n; i++) {
+        seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+        switch ((i == 0) ? 7 : seed % 8) {
+        case 0:  h[i] = h[(seed >> 8) % i]; break;
+        case 1:  h[i].low = h[i - 1].low; h[i].high = seed >> 3; break;
+        case 2:  h[i] = h[i - 1]; h[i].high ^= 1; break;
+        default: h[i].low = seed; h[i].high = seed * 0x9E3779B97F4A7C15ULL; break;
+        }
+    }
+    for (i = n / 2; i < n / 2 + 100 && i < n; i++) {
+        h[i].low = 0x0123456789ABCDEFULL; h[i].high = 42;
+    }
+}
+
+static void test_xxh3_128_sort_and_unique_match_cmp(void)
+{
+    static const size_t sizes[] = { 0, 1, 2, 33, 1000, 70000 };
+    size_t const   max = 70000;
+    xxh3_128_t*    in  = (xxh3_128_t*)malloc(max * sizeof(xxh3_128_t));
+    xxh3_128_t*    ref = (xxh3_128_t*)malloc(max * sizeof(xxh3_128_t));
+    xxh3_128_t*    out = (xxh3_128_t*)malloc(max * sizeof(xxh3_128_t));
+    size_t         s, i;
+
+    TEST_ASSERT_NOT_NULL(in);
+    TEST_ASSERT_NOT_NULL(ref);
+    TEST_ASSERT_NOT_NULL(out);
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t const n = sizes[s];
+        size_t distinct = (n > 0);
+        unsigned threads;
+
+        make_sort_input(in, n, 0x0123456789ABCDEFULL + n);
+        memcpy(ref, in, n * sizeof(xxh3_128_t));
+        qsort(ref, n, sizeof(xxh3_128_t), xxh3_128_cmp);
+        for (i = 1; i < n; i++) {
+            distinct += xxh3_128_cmp(&ref[i - 1], &ref[i]) != 0;
+        }
+
+        memcpy(out, in, n * sizeof(xxh3_128_t));
+        xxh3_128_sort(out, n);
+        TEST_ASSERT_TRUE(memcmp(ref, out, n * sizeof(xxh3_128_t)) == 0);
+        for (threads = 0; threads <= 3; threads++) {
+            memcpy(out, in, n * sizeof(xxh3_128_t));
+            xxh3_128_sort_mt(out, n, threads);
+            TEST_ASSERT_TRUE(memcmp(ref, out, n * sizeof(xxh3_128_t)) == 0);
+        }
+
+        TEST_ASSERT_EQUAL_UINT64((uint64_t)distinct, (uint64_t)xxh3_128_unique(out, n));
+        for (i = 1; i < distinct; i++) {
+            TEST_ASSERT_TRUE(xxh3_128_cmp(&out[i - 1], &out[i]) < 0);
+        }
+    }
+    free(out);
+    free(ref);
+    free(in);
+}
+
+/* Queries around each digest of a sorted set: the digest, its neighbours
+ * in `low` and a `high` that differs in the last bit */
+static void make_index_queries(xxh3_128_t* q, const xxh3_128_t* set, size_t n)
+{
+    size_t i;
+    for (i = 0; i < n; i++) {
+        q[4 * i] = set[i];
+        q[4 * i + 1] = set[i];
+        q[4 * i + 1].low--;
+        q[4 * i + 2] = set[i];
+        q[4 * i + 2].low++;
+        q[4 * i + 3] = set[i];
+        q[4 * i + 3].high ^= 1;
+    }
+}
+
+static void test_xxh3_index_matches_sorted_array(void)
+{
+    static const size_t sizes[] = { 0, 1, 2, 3, 7, 8, 9, 1000, 70000 };
+    size_t const   max   = 70000;
+    xxh3_128_t*    set   = (xxh3_128_t*)malloc(max * sizeof(xxh3_128_t));
+    xxh3_128_t*    q     = (xxh3_128_t*)malloc((4 * max + 1) * sizeof(xxh3_128_t));
+    unsigned char* found = (unsigned char*)malloc(4 * max + 1);
+    unsigned char* image = (unsigned char*)malloc(xxh3_index_size(max));
+    size_t         s, i;
+
+    TEST_ASSERT_NOT_NULL(set);
+    TEST_ASSERT_NOT_NULL(q);
+    TEST_ASSERT_NOT_NULL(found);
+    TEST_ASSERT_NOT_NULL(image);
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t const size = xxh3_index_size(sizes[s]);
+        size_t       n, nq, hits = 0;
+        xxh3_index_t index;
+
+        make_sort_input(set, sizes[s], 0xFEDCBA9876543210ULL + sizes[s]);
+        if (sizes[s] == 3) {
+            set[1].low = 0;  /* the zero digest is a valid member */
+            set[1].high = 0;
+        }
+        xxh3_128_sort(set, sizes[s]);
+        n = xxh3_128_unique(set, sizes[s]);
+        TEST_ASSERT_EQUAL_UINT64((uint64_t)(64 + 16 * (sizes[s] + 1)), (uint64_t)size);
+        TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_index_build(image, xxh3_index_size(n) - 1, set, n));
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_index_build(image, size, set, n));
+        TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_index_view(&index, image, xxh3_index_size(n) - 1));
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_index_view(&index, image, size));
+        TEST_ASSERT_EQUAL_UINT64((uint64_t)n, (uint64_t)index.count);
+
+        make_index_queries(q, set, n);
+        nq = 4 * n;
+        q[nq].low = 0;
+        q[nq].high = 0;
+        nq++;
+        for (i = 0; i < nq; i++) {
+            int const expect = bsearch(&q[i], set, n, sizeof(xxh3_128_t), xxh3_128_cmp) != NULL;
+            TEST_ASSERT_EQUAL_INT(expect, xxh3_index_contains(&index, q[i]));
+            hits += (size_t)expect;
+        }
+        TEST_ASSERT_EQUAL_UINT64((uint64_t)hits, (uint64_t)xxh3_index_contains_n(&index, q, nq, found));
+        for (i = 0; i < nq; i++) {
+            TEST_ASSERT_EQUAL_INT(xxh3_index_contains(&index, q[i]), found[i]);
+        }
+    }
+
+    /* unsorted or repeated input, and damaged headers, are rejected */
+    set[0].low = 2; set[0].high = 0;
+    set[1].low = 1; set[1].high = 0;
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_index_build(image, xxh3_index_size(2), set, 2));
+    set[1] = set[0];
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_index_build(image, xxh3_index_size(2), set, 2));
+    set[1].high = 1;
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_index_build(image, xxh3_index_size(2), set, 2));
+    for (i = 0; i < 32; i++) {
+        xxh3_index_t index;
+        image[i] ^= 0x40;
+        TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_index_view(&index, image, xxh3_index_size(2)));
+        image[i] ^= 0x40;
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_index_view(&index, image, xxh3_index_size(2)));
+    }
+    free(image);
+    free(found);
+    free(q);
+    free(set);
+}
+
+/* Allocator for the map tests: counts live blocks and fails once `budget`
+ * allocations have been made */
+typedef struct {
+    size_t live;
+    size_t budget;
+} map_alloc_ctx;
+
+static void* map_test_alloc(void* ctx, size_t size)
+{
+    map_alloc_ctx* const c = (map_alloc_ctx*)ctx;
+    if (c->budget == 0) {
+        return NULL;
+    }
+    c->budget--;
+    c->live++;
+    return malloc(size);
+}
+
+static void map_test_free(void* ctx, void* ptr, size_t size)
+{
+    (void)size;
+    ((map_alloc_ctx*)ctx)->live--;
+    free(ptr);
+}
+
+/* Every key in one probe sequence with one H2 tag */
+static uint64_t map_test_constant_hash(const void* key, size_t size, uint64_t seed)
+{
+    (void)key;
+    (void)size;
+    return seed;
+}
+
+/* Key i: its index in the first bytes, then bytes that depend on it */
+static void make_map_key(unsigned char* key, size_t i, size_t key_size)
+{
+    size_t b;
+    memcpy(key, &i, sizeof(i));
+    for (b = sizeof(i); b < key_size; b++) {
+        key[b] = (unsigned char)(i * 131 + b);
+    }
+}
+
+/* Inserts, finds, erases and iterates keys 0..n-1 (spread into key_size
+ * bytes) against a presence array; rounds of erasing and re-inserting
+ * leave tombstones behind */
+static void run_map(const xxh3_map_config_t* config, size_t n)
+{
+    xxh3_map_t*    map     = xxh3_map_create(config, 0);
+    unsigned char* present = (unsigned char*)calloc(n, 1);
+    unsigned char  key[24];
+    size_t         i, round, size = 0;
+
+    TEST_ASSERT_NOT_NULL(map);
+    TEST_ASSERT_NOT_NULL(present);
+    for (round = 0; round < 4; round++) {
+        const void* k;
+        void*       v;
+        size_t      pos = 0, seen = 0, cap;
+
+        for (i = 0; i < n; i++) {
+            int inserted = -1;
+            unsigned char* value;
+            if ((i * 7 + round) % 3 == 0) {
+                continue;
+            }
+            make_map_key(key, i, config->key_size);
+            value = (unsigned char*)xxh3_map_insert(map, key, &inserted);
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_INT(!present[i], inserted);
+            if (inserted && config->value_size >= sizeof(size_t)) {
+                TEST_ASSERT_EQUAL_UINT64(0, (uint64_t)((size_t*)(void*)value)[0]);
+                memcpy(value, &i, sizeof(i));
+            }
+            size += (size_t)inserted;
+            present[i] = 1;
+        }
+        TEST_ASSERT_EQUAL_UINT64((uint64_t)size, (uint64_t)xxh3_map_size(map));
+        cap = xxh3_map_capacity(map);
+        for (i = 0; i < n + 50; i++) {
+            unsigned char* value;
+            make_map_key(key, i, config->key_size);
+            value = (unsigned char*)xxh3_map_find(map, key);
+            TEST_ASSERT_EQUAL_INT(i < n && present[i], value != NULL);
+            if (value != NULL && config->value_size >= sizeof(size_t)) {
+                TEST_ASSERT_TRUE(memcmp(value, &i, sizeof(i)) == 0);
+            }
+            if (i < n && i % (round + 2) == 0) {
+                TEST_ASSERT_EQUAL_INT(present[i], xxh3_map_erase(map, key));
+                size -= present[i];
+                present[i] = 0;
+                TEST_ASSERT_NULL(xxh3_map_find(map, key));
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT64((uint64_t)size, (uint64_t)xxh3_map_size(map));
+        TEST_ASSERT_EQUAL_UINT64((uint64_t)cap, (uint64_t)xxh3_map_capacity(map));
+        while (xxh3_map_next(map, &pos, &k, &v)) {
+            size_t idx;
+            memcpy(&idx, k, sizeof(idx));
+            TEST_ASSERT_TRUE(idx < n && present[idx]);
+            TEST_ASSERT_NOT_NULL(v);
+            seen++;
+        }
+        TEST_ASSERT_EQUAL_UINT64((uint64_t)size, (uint64_t)seen);
+    }
+    /* churn on a fixed set must reuse tombstones, not grow the table */
+    {   size_t const cap = xxh3_map_capacity(map);
+        for (i = 0; i < 20 * n; i++) {
+            size_t const j = i % n;
+            make_map_key(key, j, config->key_size);
+            if (present[j]) {
+                TEST_ASSERT_EQUAL_INT(1, xxh3_map_erase(map, key));
+                TEST_ASSERT_NOT_NULL(xxh3_map_insert(map, key, NULL));
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT64((uint64_t)cap, (uint64_t)xxh3_map_capacity(map));
+        TEST_ASSERT_EQUAL_UINT64((uint64_t)size, (uint64_t)xxh3_map_size(map));
+    }
+    xxh3_map_clear(map);
+    TEST_ASSERT_EQUAL_UINT64(0, (uint64_t)xxh3_map_size(map));
+    memset(key, 0, sizeof(key));
+    TEST_ASSERT_NULL(xxh3_map_find(map, key));
+    xxh3_map_free(map);
+    free(present);
+}
+
+static void test_xxh3_map_matches_reference(void)
+{
+    map_alloc_ctx      ctx       = { 0, (size_t)-1 };
+    xxh3_allocator_t   allocator = { map_test_alloc, map_test_free, NULL };
+    xxh3_map_config_t  config;
+    xxh3_map_t*        map;
+    size_t             i;
+
+    allocator.ctx = &ctx;
+    memset(&config, 0, sizeof(config));
+    config.key_size   = 8;
+    config.value_size = 8;
+    config.allocator  = &allocator;
+    run_map(&config, 5000);
+    TEST_ASSERT_EQUAL_UINT64(0, (uint64_t)ctx.live);
+
+    config.key_size   = 16;
+    config.value_size = 24;
+    config.seed       = SEED2;
+    run_map(&config, 3000);
+    config.key_size   = 13;     /* odd size: memcmp keys, value at offset 16 */
+    config.value_size = 0;      /* a set */
+    run_map(&config, 1000);
+    config.key_size   = 12;
+    config.value_size = 8;
+    config.hash       = map_test_constant_hash;
+    run_map(&config, 300);
+    TEST_ASSERT_EQUAL_UINT64(0, (uint64_t)ctx.live);
+
+    /* the default hash is XXH3-64 of the key bytes */
+    config.key_size = 8;
+    config.hash     = NULL;
+    map = xxh3_map_create(&config, 100);
+    TEST_ASSERT_NOT_NULL(map);
+    TEST_ASSERT_TRUE(xxh3_map_capacity(map) * 7 / 8 >= 100);
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_map_reserve(map, 1000));
+    TEST_ASSERT_TRUE(xxh3_map_capacity(map) * 7 / 8 >= 1000);
+    xxh3_map_free(map);
+
+    /* a failed allocation leaves the map as it was */
+    ctx.budget = 2;
+    map = xxh3_map_create(&config, 1);
+    TEST_ASSERT_NOT_NULL(map);
+    for (i = 0; xxh3_map_insert(map, &i, NULL) != NULL; i++) {
+    }
+    TEST_ASSERT_EQUAL_UINT64((uint64_t)i, (uint64_t)xxh3_map_size(map));
+    while (i-- > 0) {
+        TEST_ASSERT_NOT_NULL(xxh3_map_find(map, &i));
+    }
+    xxh3_map_free(map);
+    TEST_ASSERT_EQUAL_UINT64(0, (uint64_t)ctx.live);
+    config.key_size = 0;
+    TEST_ASSERT_NULL(xxh3_map_create(&config, 0));
+}
+
+#define HEX_N 37
+
+typedef struct {
+    void (*canon64)(xxh64_canonical_t*, const uint64_t*, size_t);
+    void (*canon128)(xxh128_canonical_t*, const xxh3_128_t*, size_t);
+    void (*to_hex64)(char*, const uint64_t*, size_t);
+    void (*to_hex128)(char*, const xxh3_128_t*, size_t);
+    size_t (*from_hex64)(uint64_t*, const char*, size_t);
+    size_t (*from_hex128)(xxh3_128_t*, const char*, size_t);
+} hex_fns_t;
+
+/* Checks one variant's batch canonical and hex functions against the
+ * single-digest canonical functions and printf-formatted hex: every count up
+ * to HEX_N, upper-case input, and each non-hex byte at several positions.
+ * Returns the number of mismatches. */
+static int run_hex(const hex_fns_t* f)
+{
+    static const unsigned char bad_chars[] = { 'g', 'G', '/', ':', '@', '`', ' ', 0xB0, 0 };
+    static const size_t bad_pos[] = { 0, 15, 16, 31, 17 * 16 + 3, HEX_N * 16 - 1 };
+    uint64_t           h64[HEX_N], d64[HEX_N];
+    xxh3_128_t         h128[HEX_N], d128[HEX_N];
+    xxh64_canonical_t  c64[HEX_N + 1];
+    xxh128_canonical_t c128[HEX_N + 1];
+    char               ref64[HEX_N * 16 + 1], ref128[HEX_N * 32 + 1];
+    char               text[HEX_N * 32 + 1];
+    size_t             n, i, b, p;
+    int                bad = 0;
+
+    for (i = 0; i < HEX_N; i++) {
+        h64[i]  = xxh3_64_scalar(LOREM, i, SEED2);
+        h128[i] = xxh3_128_scalar(LOREM, i, SEED2);
+        snprintf(ref64 + 16 * i, 17, "%016llx", (unsigned long long)h64[i]);
+        snprintf(ref128 + 32 * i, 33, "%016llx%016llx",
+                 (unsigned long long)h128[i].high, (unsigned long long)h128[i].low);
+    }
+    for (n = 0; n <= HEX_N; n++) {
+        memset(c64, 0xA5, sizeof(c64));
+        memset(c128, 0xA5, sizeof(c128));
+        f->canon64(c64, h64, n);
+        f->canon128(c128, h128, n);
+        for (i = 0; i < n; i++) {
+            xxh64_canonical_t  e64;
+            xxh128_canonical_t e128;
+            xxh64_canonicalFromHash(&e64, h64[i]);
+            xxh128_canonicalFromHash(&e128, h128[i]);
+            bad += memcmp(&c64[i], &e64, sizeof(e64)) != 0;
+            bad += memcmp(&c128[i], &e128, sizeof(e128)) != 0;
+        }
+        bad += c64[n].digest[0] != 0xA5 || c128[n].digest[0] != 0xA5;
+
+        memset(text, '#', sizeof(text));
+        f->to_hex64(text, h64, n);
+        bad += memcmp(text, ref64, 16 * n) != 0 || text[16 * n] != '#';
+        bad += f->from_hex64(d64, text, n) != n;
+        bad += memcmp(d64, h64, n * sizeof(uint64_t)) != 0;
+
+        memset(text, '#', sizeof(text));
+        f->to_hex128(text, h128, n);
+        bad += memcmp(text, ref128, 32 * n) != 0 || text[32 * n] != '#';
+        bad += f->from_hex128(d128, text, n) != n;
+        bad += memcmp(d128, h128, n * sizeof(xxh3_128_t)) != 0;
+    }
+
+    /* upper case decodes the same */
+    for (i = 0; i < HEX_N * 32; i++) {
+        text[i] = (ref128[i] >= 'a') ? (char)(ref128[i] - 32) : ref128[i];
+    }
+    bad += f->from_hex128(d128, text, HEX_N) != HEX_N;
+    bad += memcmp(d128, h128, sizeof(h128)) != 0;
+    for (i = 0; i < HEX_N * 16; i++) {
+        text[i] = (ref64[i] >= 'a') ? (char)(ref64[i] - 32) : ref64[i];
+    }
+    bad += f->from_hex64(d64, text, HEX_N) != HEX_N;
+    bad += memcmp(d64, h64, sizeof(h64)) != 0;
+
+    /* a non-hex byte stops decoding at its digest */
+    for (b = 0; b < sizeof(bad_chars); b++) {
+        for (p = 0; p < sizeof(bad_pos) / sizeof(bad_pos[0]); p++) {
+            memcpy(text, ref64, HEX_N * 16);
+            text[bad_pos[p]] = (char)bad_chars[b];
+            memset(d64, 0, sizeof(d64));
+            bad += f->from_hex64(d64, text, HEX_N) != bad_pos[p] / 16;
+            bad += memcmp(d64, h64, bad_pos[p] / 16 * sizeof(uint64_t)) != 0;
+
+            memcpy(text, ref128, HEX_N * 32);
+            text[2 * bad_pos[p]] = (char)bad_chars[b];
+            bad += f->from_hex128(d128, text, HEX_N) != bad_pos[p] / 16;
+        }
+    }
+    return bad;
+}
+
+#define HEX_FNS(v) { xxh64_canonicalFromHash_n_##v, xxh128_canonicalFromHash_n_##v, \
+                     xxh64_toHex_n_##v, xxh128_toHex_n_##v, xxh64_fromHex_n_##v, xxh128_fromHex_n_##v }
+
+static void test_hex_and_canonical_batch_match_single(void)
+{
+    static const hex_fns_t scalar = HEX_FNS(scalar);
+    int bad = 0;
+
+    TEST_ASSERT_EQUAL_INT(0, run_hex(&scalar));
+#if XXH3_HAVE_SSE2
+    {   static const hex_fns_t sse2 = HEX_FNS(sse2);
+        TEST_ASSERT_EQUAL_INT(0, run_hex(&sse2));
+    }
+#endif
+#if XXH3_HAVE_AVX2
+    TEST_TRY_VARIANT("AVX2", {
+        static const hex_fns_t avx2 = HEX_FNS(avx2);
+        bad = run_hex(&avx2);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    TEST_TRY_VARIANT("AVX512", {
+        static const hex_fns_t avx512 = HEX_FNS(avx512);
+        bad = run_hex(&avx512);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    {   static const hex_fns_t neon = HEX_FNS(neon);
+        TEST_ASSERT_EQUAL_INT(0, run_hex(&neon));
+    }
+#endif
+#if XXH3_HAVE_SVE
+    TEST_TRY_VARIANT("SVE", {
+        static const hex_fns_t sve = HEX_FNS(sve);
+        bad = run_hex(&sve);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+    (void)bad;
+}
+
+#define BLOOM_N 20000
+
+typedef struct {
+    void (*add)(xxh3_bloom_t*, const void*, size_t);
+    int (*contains)(const xxh3_bloom_t*, const void*, size_t);
+    void (*add_batch)(xxh3_bloom_t*, const void* const*, const size_t*, size_t);
+    size_t (*contains_batch)(const xxh3_bloom_t*, const void* const*, const size_t*, size_t,
+                             unsigned char*);
+} bloom_fns_t;
+
+/* Keys i < BLOOM_N / 2 go in the filters, the others are absent: key i is 8
+ * bytes derived from i followed by 0 to 16 bytes of LOREM */
+static void make_bloom_keys(unsigned char* keys, const void** ptrs, size_t* sizes)
+{
+    size_t i;
+    for (i = 0; i < BLOOM_N; i++) {
+        uint64_t const id = (uint64_t)i * 0x9E3779B97F4A7C15ULL;
+        memcpy(keys + 24 * i, &id, 8);
+        memcpy(keys + 24 * i + 8, LOREM, 16);
+        ptrs[i]  = keys + 24 * i;
+        sizes[i] = 8 + i % 17;
+    }
+}
+
+/* Fills one variant's filters with the first half of the keys, one at a
+ * time and in batches, and checks them against the scalar image `ref` and
+ * each other. Returns the number of mismatches. */
+static int run_bloom(const bloom_fns_t* f, const void* const* ptrs, const size_t* sizes,
+                     const unsigned char* ref, size_t size)
+{
+    unsigned char* found  = (unsigned char*)malloc(BLOOM_N);
+    unsigned char* single = (unsigned char*)malloc(size);
+    unsigned char* batch  = (unsigned char*)malloc(size);
+    uint64_t const blocks = (size - 64) / 32;
+    xxh3_bloom_t   a, b;
+    size_t         i, hits = 0;
+    int            bad = 0;
+
+    if (found == NULL || single == NULL || batch == NULL) {
+        free(batch);
+        free(single);
+        free(found);
+        return 1;
+    }
+    bad += xxh3_bloom_init(&a, single, size, blocks, SEED2) != XXH3_OK;
+    bad += xxh3_bloom_init(&b, batch, size, blocks, SEED2) != XXH3_OK;
+    for (i = 0; i < BLOOM_N / 2; i++) {
+        f->add(&a, ptrs[i], sizes[i]);
+    }
+    /* uneven batches, to cover partial groups */
+    for (i = 0; i < BLOOM_N / 2; i += i % 37 + 1) {
+        size_t const n = (i % 37 + 1 < BLOOM_N / 2 - i) ? i % 37 + 1 : BLOOM_N / 2 - i;
+        f->add_batch(&b, ptrs + i, sizes + i, n);
+    }
+    bad += memcmp(single, ref, size) != 0;
+    bad += memcmp(batch, ref, size) != 0;
+
+    for (i = 0; i < BLOOM_N; i++) {
+        int const hit = f->contains(&a, ptrs[i], sizes[i]);
+        bad += hit != xxh3_bloom_contains_scalar(&a, ptrs[i], sizes[i]);
+        hits += (size_t)hit;
+    }
+    memset(found, 0xA5, BLOOM_N);
+    bad += f->contains_batch(&b, ptrs, sizes, BLOOM_N, found) != hits;
+    for (i = 0; i < BLOOM_N; i++) {
+        bad += found[i] != f->contains(&a, ptrs[i], sizes[i]);
+    }
+    free(batch);
+    free(single);
+    free(found);
+    return bad;
+}
+
+#define BLOOM_FNS(v) { xxh3_bloom_add_##v, xxh3_bloom_contains_##v, xxh3_bloom_add_batch_##v, \
+                       xxh3_bloom_contains_batch_##v }
+
+static void test_xxh3_bloom_variants_match_scalar(void)
+{
+    static const bloom_fns_t scalar = BLOOM_FNS(scalar);
+    uint64_t const blocks = xxh3_bloom_blocks(BLOOM_N / 2, 10);
+    size_t const   size   = xxh3_bloom_size(blocks);
+    unsigned char* keys   = (unsigned char*)malloc(24 * BLOOM_N);
+    const void**   ptrs   = (const void**)malloc(BLOOM_N * sizeof(void*));
+    size_t*        sizes  = (size_t*)malloc(BLOOM_N * sizeof(size_t));
+    unsigned char* ref    = (unsigned char*)malloc(size);
+    unsigned char* half   = (unsigned char*)malloc(size);
+    unsigned char* part   = (unsigned char*)malloc(size);
+    xxh3_bloom_t   filter, other;
+    size_t         i, fp = 0;
+    int            bad = 0;
+
+    TEST_ASSERT_EQUAL_UINT64((BLOOM_N / 2 * 10 + 255) / 256, blocks);
+    TEST_ASSERT_EQUAL_UINT64(64 + 32 * blocks, (uint64_t)size);
+    TEST_ASSERT_EQUAL_UINT64(1, xxh3_bloom_blocks(0, 10));
+    TEST_ASSERT_EQUAL_UINT64(0, xxh3_bloom_blocks(100, 0));
+    TEST_ASSERT_EQUAL_UINT64(0, (uint64_t)xxh3_bloom_size(0));
+    TEST_ASSERT_EQUAL_UINT64(0, (uint64_t)xxh3_bloom_size(((uint64_t)1 << 32) + 1));
+    TEST_ASSERT_NOT_NULL(keys);
+    TEST_ASSERT_NOT_NULL(ptrs);
+    TEST_ASSERT_NOT_NULL(sizes);
+    TEST_ASSERT_NOT_NULL(ref);
+    TEST_ASSERT_NOT_NULL(half);
+    TEST_ASSERT_NOT_NULL(part);
+    make_bloom_keys(keys, ptrs, sizes);
+
+    /* reference image, and its false-positive rate (1.3% expected) */
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_bloom_init(&filter, ref, size - 1, blocks, SEED2));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_bloom_init(&filter, ref, size, blocks, SEED2));
+    for (i = 0; i < BLOOM_N / 2; i++) {
+        xxh3_bloom_add_scalar(&filter, ptrs[i], sizes[i]);
+    }
+    for (i = 0; i < BLOOM_N / 2; i++) {
+        TEST_ASSERT_EQUAL_INT(1, xxh3_bloom_contains_scalar(&filter, ptrs[i], sizes[i]));
+    }
+    for (i = BLOOM_N / 2; i < BLOOM_N; i++) {
+        fp += (size_t)xxh3_bloom_contains_scalar(&filter, ptrs[i], sizes[i]);
+    }
+    TEST_ASSERT_TRUE(fp > 0 && fp < BLOOM_N / 2 / 40);
+
+    TEST_ASSERT_EQUAL_INT(0, run_bloom(&scalar, ptrs, sizes, ref, size));
+#if XXH3_HAVE_SSE2
+    {   static const bloom_fns_t sse2 = BLOOM_FNS(sse2);
+        TEST_ASSERT_EQUAL_INT(0, run_bloom(&sse2, ptrs, sizes, ref, size));
+    }
+#endif
+#if XXH3_HAVE_AVX2
+    TEST_TRY_VARIANT("AVX2", {
+        static const bloom_fns_t avx2 = BLOOM_FNS(avx2);
+        bad = run_bloom(&avx2, ptrs, sizes, ref, size);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    TEST_TRY_VARIANT("AVX512", {
+        static const bloom_fns_t avx512 = BLOOM_FNS(avx512);
+        bad = run_bloom(&avx512, ptrs, sizes, ref, size);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    {   static const bloom_fns_t neon = BLOOM_FNS(neon);
+        TEST_ASSERT_EQUAL_INT(0, run_bloom(&neon, ptrs, sizes, ref, size));
+    }
+#endif
+#if XXH3_HAVE_SVE
+    TEST_TRY_VARIANT("SVE", {
+        static const bloom_fns_t sve = BLOOM_FNS(sve);
+        bad = run_bloom(&sve, ptrs, sizes, ref, size);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+    (void)bad;
+
+    /* filters of the two quarters merged give the reference image */
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_bloom_init(&filter, half, size, blocks, SEED2));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_bloom_init(&other, part, size, blocks, SEED2));
+    xxh3_bloom_add_batch_scalar(&filter, ptrs, sizes, BLOOM_N / 4);
+    xxh3_bloom_add_batch_scalar(&other, ptrs + BLOOM_N / 4, sizes + BLOOM_N / 4, BLOOM_N / 4);
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_bloom_merge(&filter, &other));
+    TEST_ASSERT_TRUE(memcmp(half, ref, size) == 0);
+    other.seed++;
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_bloom_merge(&filter, &other));
+
+    /* a view reads the header back; damaged headers are rejected */
+    memset(&filter, 0, sizeof(filter));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_bloom_view(&filter, ref, size - 1));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_bloom_view(&filter, ref, size));
+    TEST_ASSERT_TRUE(filter.blocks == ref + 64);
+    TEST_ASSERT_EQUAL_UINT64(blocks, filter.nblocks);
+    TEST_ASSERT_EQUAL_UINT64(SEED2, filter.seed);
+    TEST_ASSERT_EQUAL_INT(1, xxh3_bloom_contains_scalar(&filter, ptrs[0], sizes[0]));
+    for (i = 0; i < 40; i++) {
+        if (i >= 24 && i < 32) {
+            continue;  /* the seed */
+        }
+        ref[i] ^= 0x40;
+        TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_bloom_view(&filter, ref, size));
+        ref[i] ^= 0x40;
+    }
+    free(part);
+    free(half);
+    free(ref);
+    free(sizes);
+    free(ptrs);
+    free(keys);
+}
+
+#define HLL_N 100000
+
+typedef struct {
+    int (*add)(xxh3_hll_t*, const void*, size_t);
+    int (*add_batch)(xxh3_hll_t*, const void* const*, const size_t*, size_t);
+    int (*merge)(xxh3_hll_t*, const xxh3_hll_t*);
+} hll_fns_t;
+
+/* Key i is the 8-byte id i * 2^64 / phi */
+static void make_hll_keys(uint64_t* ids, const void** ptrs, size_t* sizes, size_t n)
+{
+    size_t i;
+    for (i = 0; i < n; i++) {
+        ids[i]   = (uint64_t)i * 0x9E3779B97F4A7C15ULL;
+        ptrs[i]  = &ids[i];
+        sizes[i] = sizeof(uint64_t);
+    }
+}
+
+/* Fills one variant's sketches of precision 10 (sparse up to 256 registers)
+ * with n keys, one at a time, in uneven batches and as four merged shards,
+ * and checks them against a scalar sketch; then merges sparse and dense
+ * sketches both ways. Returns the number of mismatches. */
+static int run_hll(const hll_fns_t* f, const void* const* ptrs, const size_t* sizes, size_t n)
+{
+    xxh3_hll_t* ref    = xxh3_hll_create(10, SEED2, NULL);
+    xxh3_hll_t* single = xxh3_hll_create(10, SEED2, NULL);
+    xxh3_hll_t* batch  = xxh3_hll_create(10, SEED2, NULL);
+    xxh3_hll_t* merged = xxh3_hll_create(10, SEED2, NULL);
+    xxh3_hll_t* small  = xxh3_hll_create(10, SEED2, NULL);
+    double      expect;
+    size_t      i, k;
+    int         bad = 0;
+
+    if (ref == NULL || single == NULL || batch == NULL || merged == NULL || small == NULL) {
+        bad = 1;
+        goto done;
+    }
+    for (i = 0; i < n; i++) {
+        bad += xxh3_hll_add_scalar(ref, ptrs[i], sizes[i]) != XXH3_OK;
+        bad += f->add(single, ptrs[i], sizes[i]) != XXH3_OK;
+    }
+    for (i = 0; i < n; i += i % 29 + 1) {
+        size_t const len = (i % 29 + 1 < n - i) ? i % 29 + 1 : n - i;
+        bad += f->add_batch(batch, ptrs + i, sizes + i, len) != XXH3_OK;
+    }
+    for (k = 0; k < 4; k++) {
+        xxh3_hll_t* const shard = xxh3_hll_create(10, SEED2, NULL);
+        if (shard == NULL) {
+            bad++;
+            break;
+        }
+        bad += f->add_batch(shard, ptrs + k * n / 4, sizes + k * n / 4, (k + 1) * n / 4 - k * n / 4)
+               != XXH3_OK;
+        bad += f->merge(merged, shard) != XXH3_OK;
+        xxh3_hll_free(shard);
+    }
+    expect = xxh3_hll_estimate(ref);
+    bad += xxh3_hll_estimate(single) != expect || xxh3_hll_is_dense(single) != xxh3_hll_is_dense(ref);
+    bad += xxh3_hll_estimate(batch) != expect || xxh3_hll_is_dense(batch) != xxh3_hll_is_dense(ref);
+    bad += xxh3_hll_estimate(merged) != expect;
+
+    /* a subset merged into the whole leaves it as is, and the whole merged
+     * into the subset gives the whole */
+    bad += f->add_batch(small, ptrs, sizes, n < 20 ? n : 20) != XXH3_OK;
+    bad += f->merge(ref, small) != XXH3_OK;
+    bad += xxh3_hll_estimate(ref) != expect;
+    bad += f->merge(small, ref) != XXH3_OK;
+    bad += xxh3_hll_estimate(small) != expect;
+done:
+    xxh3_hll_free(small);
+    xxh3_hll_free(merged);
+    xxh3_hll_free(batch);
+    xxh3_hll_free(single);
+    xxh3_hll_free(ref);
+    return bad;
+}
+
+/* Sparse, near the switch to dense, and dense */
+static int run_hll_sizes(const hll_fns_t* f, const void* const* ptrs, const size_t* sizes)
+{
+    return run_hll(f, ptrs, sizes, 50) + run_hll(f, ptrs, sizes, 300)
+           + run_hll(f, ptrs, sizes, HLL_N);
+}
+
+#define HLL_FNS(v) { xxh3_hll_add_##v, xxh3_hll_add_batch_##v, xxh3_hll_merge_##v }
+
+static void test_xxh3_hll_variants_match_scalar(void)
+{
+    static const hll_fns_t scalar = HLL_FNS(scalar);
+    uint64_t*    ids   = (uint64_t*)malloc(HLL_N * sizeof(uint64_t));
+    const void** ptrs  = (const void**)malloc(HLL_N * sizeof(void*));
+    size_t*      sizes = (size_t*)malloc(HLL_N * sizeof(size_t));
+    int          bad   = 0;
+
+    TEST_ASSERT_NOT_NULL(ids);
+    TEST_ASSERT_NOT_NULL(ptrs);
+    TEST_ASSERT_NOT_NULL(sizes);
+    make_hll_keys(ids, ptrs, sizes, HLL_N);
+    TEST_ASSERT_EQUAL_INT(0, run_hll_sizes(&scalar, ptrs, sizes));
+#if XXH3_HAVE_SSE2
+    {   static const hll_fns_t sse2 = HLL_FNS(sse2);
+        TEST_ASSERT_EQUAL_INT(0, run_hll_sizes(&sse2, ptrs, sizes));
+    }
+#endif
+#if XXH3_HAVE_AVX2
+    TEST_TRY_VARIANT("AVX2", {
+        static const hll_fns_t avx2 = HLL_FNS(avx2);
+        bad = run_hll_sizes(&avx2, ptrs, sizes);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    TEST_TRY_VARIANT("AVX512", {
+        static const hll_fns_t avx512 = HLL_FNS(avx512);
+        bad = run_hll_sizes(&avx512, ptrs, sizes);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    {   static const hll_fns_t neon = HLL_FNS(neon);
+        TEST_ASSERT_EQUAL_INT(0, run_hll_sizes(&neon, ptrs, sizes));
+    }
+#endif
+#if XXH3_HAVE_SVE
+    TEST_TRY_VARIANT("SVE", {
+        static const hll_fns_t sve = HLL_FNS(sve);
+        bad = run_hll_sizes(&sve, ptrs, sizes);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+    (void)bad;
+    free(sizes);
+    free(ptrs);
+    free(ids);
+}
+
+static void test_xxh3_hll_estimates_and_errors(void)
+{
+    map_alloc_ctx    ctx       = { 0, (size_t)-1 };
+    xxh3_allocator_t allocator = { map_test_alloc, map_test_free, NULL };
+    xxh3_hll_t*      hll;
+    xxh3_hll_t*      other;
+    uint64_t         i;
+    double           e;
+
+    TEST_ASSERT_NULL(xxh3_hll_create(3, 0, NULL));
+    TEST_ASSERT_NULL(xxh3_hll_create(19, 0, NULL));
+
+    /* 0.81% standard error when dense; exact-ish while sparse */
+    allocator.ctx = &ctx;
+    hll = xxh3_hll_create(14, SEED1, &allocator);
+    TEST_ASSERT_NOT_NULL(hll);
+    TEST_ASSERT_EQUAL_UINT64(14, xxh3_hll_precision(hll));
+    TEST_ASSERT_TRUE(xxh3_hll_estimate(hll) == 0.0);
+    for (i = 0; i < 1000; i++) {
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_hll_add_scalar(hll, &i, sizeof(i)));
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_hll_add_scalar(hll, &i, sizeof(i)));
+    }
+    TEST_ASSERT_FALSE(xxh3_hll_is_dense(hll));
+    e = xxh3_hll_estimate(hll);
+    TEST_ASSERT_TRUE(e > 995.0 && e < 1005.0);
+    for (; i < 300000; i++) {
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_hll_add_hash(hll, xxh3_64_scalar(&i, sizeof(i), SEED1)));
+    }
+    TEST_ASSERT_TRUE(xxh3_hll_is_dense(hll));
+    e = xxh3_hll_estimate(hll);
+    TEST_ASSERT_TRUE(e > 300000.0 * 0.97 && e < 300000.0 * 1.03);
+    xxh3_hll_clear(hll);
+    TEST_ASSERT_TRUE(xxh3_hll_estimate(hll) == 0.0);
+    xxh3_hll_free(hll);
+    TEST_ASSERT_EQUAL_UINT64(0, (uint64_t)ctx.live);
+
+    /* registers filled from sparse entries match those set directly, also
+     * when the rank runs past the bits kept by the sparse index */
+    hll   = xxh3_hll_create(10, SEED1, NULL);
+    other = xxh3_hll_create(10, SEED1, NULL);
+    TEST_ASSERT_NOT_NULL(hll);
+    TEST_ASSERT_NOT_NULL(other);
+    for (i = 0; !xxh3_hll_is_dense(other); i++) {
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_hll_add_scalar(other, &i, sizeof(i)));
+    }
+    xxh3_hll_clear(other);
+    for (i = 0; i < 1024; i++) {
+        uint64_t const h[2] = { i << 54 | (uint64_t)1 << (i % 39),
+                                i << 54 | (uint64_t)1 << (39 + i % 15) };
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_hll_add_hash(hll, h[i & 1]));
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_hll_add_hash(other, h[i & 1]));
+    }
+    TEST_ASSERT_TRUE(xxh3_hll_is_dense(hll));
+    TEST_ASSERT_TRUE(xxh3_hll_estimate(hll) == xxh3_hll_estimate(other));
+    xxh3_hll_free(other);
+
+    /* merging a sketch into itself changes nothing, at every sparse size
+     * through the growth steps and the switch to dense */
+    other = xxh3_hll_create(10, SEED1, NULL);
+    TEST_ASSERT_NOT_NULL(other);
+    for (i = 0; i < 512; i++) {
+        int dense;
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_hll_add_scalar(other, &i, sizeof(i)));
+        e     = xxh3_hll_estimate(other);
+        dense = xxh3_hll_is_dense(other);
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_hll_merge_scalar(other, other));
+        TEST_ASSERT_TRUE(xxh3_hll_estimate(other) == e);
+        TEST_ASSERT_EQUAL_INT(dense, xxh3_hll_is_dense(other));
+    }
+    TEST_ASSERT_TRUE(xxh3_hll_is_dense(other));
+    xxh3_hll_free(other);
+
+    /* only sketches of the same precision and seed merge */
+    other = xxh3_hll_create(11, SEED1, NULL);
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_hll_merge_scalar(hll, other));
+    xxh3_hll_free(other);
+    other = xxh3_hll_create(10, SEED2, NULL);
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_hll_merge_scalar(hll, other));
+    xxh3_hll_free(other);
+    xxh3_hll_free(hll);
+
+    /* a failed allocation is reported and the sketch stays usable */
+    ctx.budget = 2;
+    hll = xxh3_hll_create(14, SEED1, &allocator);
+    TEST_ASSERT_NOT_NULL(hll);
+    for (i = 0; xxh3_hll_add_scalar(hll, &i, sizeof(i)) == XXH3_OK; i++) {
+    }
+    TEST_ASSERT_TRUE(i >= 16);
+    TEST_ASSERT_FALSE(xxh3_hll_is_dense(hll));
+    e = xxh3_hll_estimate(hll);
+    TEST_ASSERT_TRUE(e > (double)i - 1.0 && e < (double)i + 2.0);
+    xxh3_hll_free(hll);
+    TEST_ASSERT_EQUAL_UINT64(0, (uint64_t)ctx.live);
+}
+
+#define MSET_N 1000
+
+typedef struct {
+    void (*add)(xxh3_multiset_t*, const void*, size_t);
+    void (*remove)(xxh3_multiset_t*, const void*, size_t);
+    void (*add_batch)(xxh3_multiset_t*, const void* const*, const size_t*, size_t);
+} multiset_fns_t;
+
+/* Key i: 0..299 bytes of a fixed buffer, some of them equal */
+static void make_multiset_keys(unsigned char* buf, const void** ptrs, size_t* sizes, size_t n)
+{
+    size_t i;
+    for (i = 0; i < 4096; i++) {
+        buf[i] = (unsigned char)(i * 131 + (i >> 7));
+    }
+    for (i = 0; i < n; i++) {
+        ptrs[i]  = buf + (i * 37) % 3000;
+        sizes[i] = (i * 7) % 300;
+    }
+}
+
+static int multiset_equal(const xxh3_multiset_t* a, const xxh3_multiset_t* b)
+{
+    xxh3_128_t const x = xxh3_multiset_digest(a);
+    xxh3_128_t const y = xxh3_multiset_digest(b);
+    return x.high == y.high && x.low == y.low;
+}
+
+/* Builds one variant's set of n keys in reverse order, in uneven batches
+ * and as three merged shards, and checks them against the scalar set in
+ * order; then removes every other key, and the rest. Returns the number of
+ * mismatches. */
+static int run_multiset(const multiset_fns_t* f, const void* const* ptrs, const size_t* sizes,
+                        size_t n)
+{
+    xxh3_multiset_t ref, single, batch, merged, even;
+    size_t          i, k;
+    int             bad = 0;
+
+    xxh3_multiset_init(&ref, SEED2);
+    xxh3_multiset_init(&single, SEED2);
+    xxh3_multiset_init(&batch, SEED2);
+    xxh3_multiset_init(&merged, SEED2);
+    xxh3_multiset_init(&even, SEED2);
+    for (i = 0; i < n; i++) {
+        xxh3_multiset_add_scalar(&ref, ptrs[i], sizes[i]);
+        f->add(&single, ptrs[n - 1 - i], sizes[n - 1 - i]);
+        if (i % 2 == 0) {
+            xxh3_multiset_add_scalar(&even, ptrs[i], sizes[i]);
+        }
+    }
+    for (i = 0; i < n; i += i % 29 + 1) {
+        size_t const len = (i % 29 + 1 < n - i) ? i % 29 + 1 : n - i;
+        f->add_batch(&batch, ptrs + i, sizes + i, len);
+    }
+    for (k = 0; k < 3; k++) {
+        xxh3_multiset_t shard;
+        xxh3_multiset_init(&shard, SEED2);
+        f->add_batch(&shard, ptrs + k * n / 3, sizes + k * n / 3, (k + 1) * n / 3 - k * n / 3);
+        bad += xxh3_multiset_merge(&merged, &shard) != XXH3_OK;
+    }
+    bad += !multiset_equal(&single, &ref);
+    bad += !multiset_equal(&batch, &ref);
+    bad += !multiset_equal(&merged, &ref);
+
+    for (i = 1; i < n; i += 2) {
+        f->remove(&single, ptrs[i], sizes[i]);
+    }
+    bad += !multiset_equal(&single, &even);
+    for (i = 0; i < n; i += 2) {
+        f->remove(&single, ptrs[i], sizes[i]);
+    }
+    bad += single.high != 0 || single.low != 0;
+    return bad;
+}
+
+#define MULTISET_FNS(v) { xxh3_multiset_add_##v, xxh3_multiset_remove_##v, \
+                          xxh3_multiset_add_batch_##v }
+
+static void test_xxh3_multiset_variants_match_scalar(void)
+{
+    static const multiset_fns_t scalar = MULTISET_FNS(scalar);
+    static unsigned char buf[4096];
+    const void*          ptrs[MSET_N];
+    size_t               sizes[MSET_N];
+    int                  bad = 0;
+
+    make_multiset_keys(buf, ptrs, sizes, MSET_N);
+    TEST_ASSERT_EQUAL_INT(0, run_multiset(&scalar, ptrs, sizes, MSET_N));
+#if XXH3_HAVE_SSE2
+    {   static const multiset_fns_t sse2 = MULTISET_FNS(sse2);
+        TEST_ASSERT_EQUAL_INT(0, run_multiset(&sse2, ptrs, sizes, MSET_N));
+    }
+#endif
+#if XXH3_HAVE_AVX2
+    TEST_TRY_VARIANT("AVX2", {
+        static const multiset_fns_t avx2 = MULTISET_FNS(avx2);
+        bad = run_multiset(&avx2, ptrs, sizes, MSET_N);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    TEST_TRY_VARIANT("AVX512", {
+        static const multiset_fns_t avx512 = MULTISET_FNS(avx512);
+        bad = run_multiset(&avx512, ptrs, sizes, MSET_N);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    {   static const multiset_fns_t neon = MULTISET_FNS(neon);
+        TEST_ASSERT_EQUAL_INT(0, run_multiset(&neon, ptrs, sizes, MSET_N));
+    }
+#endif
+#if XXH3_HAVE_SVE
+    TEST_TRY_VARIANT("SVE", {
+        static const multiset_fns_t sve = MULTISET_FNS(sve);
+        bad = run_multiset(&sve, ptrs, sizes, MSET_N);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+    (void)bad;
+}
+
+static void test_xxh3_multiset_arithmetic(void)
+{
+    xxh3_multiset_t set, other;
+    xxh3_128_t      h, d;
+
+    xxh3_multiset_init(&set, SEED1);
+    d = xxh3_multiset_digest(&set);
+    TEST_ASSERT_EQUAL_UINT64(0, d.high);
+    TEST_ASSERT_EQUAL_UINT64(0, d.low);
+
+    /* one element: its XXH3-128 hash */
+    xxh3_multiset_add_scalar(&set, LOREM, strlen(LOREM));
+    h = xxh3_128_scalar(LOREM, strlen(LOREM), SEED1);
+    d = xxh3_multiset_digest(&set);
+    TEST_ASSERT_EQUAL_UINT64(h.high, d.high);
+    TEST_ASSERT_EQUAL_UINT64(h.low, d.low);
+
+    /* carries and borrows cross the two words, modulo 2^128 */
+    xxh3_multiset_init(&set, SEED1);
+    h.high = 0;
+    h.low  = ~(uint64_t)0;
+    xxh3_multiset_add_hash(&set, h);
+    h.low = 1;
+    xxh3_multiset_add_hash(&set, h);
+    TEST_ASSERT_EQUAL_UINT64(1, set.high);
+    TEST_ASSERT_EQUAL_UINT64(0, set.low);
+    h.low = 2;
+    xxh3_multiset_remove_hash(&set, h);
+    TEST_ASSERT_EQUAL_UINT64(0, set.high);
+    TEST_ASSERT_EQUAL_UINT64(~(uint64_t)0 - 1, set.low);
+    h.high = ~(uint64_t)0;
+    h.low  = 3;
+    xxh3_multiset_add_hash(&set, h);
+    TEST_ASSERT_EQUAL_UINT64(0, set.high);
+    TEST_ASSERT_EQUAL_UINT64(1, set.low);
+
+    /* a multiset: adding a key twice differs from adding it once */
+    xxh3_multiset_init(&set, SEED1);
+    xxh3_multiset_init(&other, SEED1);
+    xxh3_multiset_add_scalar(&set, "abc", 3);
+    xxh3_multiset_add_scalar(&other, "abc", 3);
+    xxh3_multiset_add_scalar(&other, "abc", 3);
+    TEST_ASSERT_FALSE(multiset_equal(&set, &other));
+    xxh3_multiset_remove_scalar(&other, "abc", 3);
+    TEST_ASSERT_TRUE(multiset_equal(&set, &other));
+
+    /* only sets of the same seed merge */
+    xxh3_multiset_init(&other, SEED2);
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_multiset_merge(&set, &other));
+    d = xxh3_multiset_digest(&set);
+    h = xxh3_128_scalar("abc", 3, SEED1);
+    TEST_ASSERT_EQUAL_UINT64(h.high, d.high);
+    TEST_ASSERT_EQUAL_UINT64(h.low, d.low);
+}
+
+#define MPHF_N 50000
+
+typedef struct {
+    int (*build)(void*, size_t, const void* const*, const size_t*, size_t, uint64_t, unsigned);
+    uint64_t (*lookup)(const xxh3_mphf_t*, const void*, size_t);
+    void (*lookup_batch)(const xxh3_mphf_t*, const void* const*, const size_t*, size_t, uint64_t*);
+} mphf_fns_t;
+
+/* Key i: the 8-byte id i * 2^64 / phi and i % 9 more bytes */
+static void make_mphf_keys(unsigned char* buf, const void** ptrs, size_t* sizes, size_t n)
+{
+    size_t i;
+    for (i = 0; i < n; i++) {
+        uint64_t const id = (uint64_t)i * 0x9E3779B97F4A7C15ULL;
+        memcpy(buf + 17 * i, &id, 8);
+        memset(buf + 17 * i + 8, (int)i, 9);
+        ptrs[i]  = buf + 17 * i;
+        sizes[i] = 8 + i % 9;
+    }
+}
+
+/* Builds one variant's function of n keys on two threads and checks that
+ * the image is the scalar single-threaded one, and that the keys' indices,
+ * single and batched, are 0..n-1. Returns the number of mismatches. */
+static int run_mphf(const mphf_fns_t* f, const void* const* ptrs, const size_t* sizes, size_t n)
+{
+    size_t const   size  = xxh3_mphf_size(n);
+    unsigned char* ref   = (unsigned char*)malloc(size);
+    unsigned char* image = (unsigned char*)malloc(size);
+    unsigned char* seen  = (unsigned char*)calloc(n + 1, 1);
+    uint64_t*      out   = (uint64_t*)malloc((n + 1) * sizeof(uint64_t));
+    xxh3_mphf_t    mphf;
+    size_t         i;
+    int            bad = 0;
+
+    if (size == 0 || ref == NULL || image == NULL || seen == NULL || out == NULL) {
+        bad = 1;
+        goto done;
+    }
+    bad += xxh3_mphf_build_scalar(ref, size, ptrs, sizes, n, SEED1, 1) != XXH3_OK;
+    bad += f->build(image, size, ptrs, sizes, n, SEED1, 2) != XXH3_OK;
+    bad += memcmp(image, ref, size) != 0;
+    if (xxh3_mphf_view(&mphf, image, size) != XXH3_OK) {
+        bad++;
+        goto done;
+    }
+    for (i = 0; i < n; i += i % 29 + 1) {
+        size_t const len = (i % 29 + 1 < n - i) ? i % 29 + 1 : n - i;
+        f->lookup_batch(&mphf, ptrs + i, sizes + i, len, out + i);
+    }
+    for (i = 0; i < n; i++) {
+        uint64_t const idx = f->lookup(&mphf, ptrs[i], sizes[i]);
+        bad += idx != out[i];
+        if (idx >= n || seen[idx]) {
+            bad++;
+            continue;
+        }
+        seen[idx] = 1;
+    }
+done:
+    free(out);
+    free(seen);
+    free(image);
+    free(ref);
+    return bad;
+}
+
+/* Empty, one partition and several */
+static int run_mphf_sizes(const mphf_fns_t* f, const void* const* ptrs, const size_t* sizes)
+{
+    return run_mphf(f, ptrs, sizes, 0) + run_mphf(f, ptrs, sizes, 1) + run_mphf(f, ptrs, sizes, 7)
+           + run_mphf(f, ptrs, sizes, 1000) + run_mphf(f, ptrs, sizes, MPHF_N);
+}
+
+#define MPHF_FNS(v) { xxh3_mphf_build_##v, xxh3_mphf_lookup_##v, xxh3_mphf_lookup_batch_##v }
+
+static void test_xxh3_mphf_variants_match_scalar(void)
+{
+    static const mphf_fns_t scalar = MPHF_FNS(scalar);
+    unsigned char* buf   = (unsigned char*)malloc(17 * MPHF_N);
+    const void**   ptrs  = (const void**)malloc(MPHF_N * sizeof(void*));
+    size_t*        sizes = (size_t*)malloc(MPHF_N * sizeof(size_t));
+    int            bad   = 0;
+
+    TEST_ASSERT_NOT_NULL(buf);
+    TEST_ASSERT_NOT_NULL(ptrs);
+    TEST_ASSERT_NOT_NULL(sizes);
+    make_mphf_keys(buf, ptrs, sizes, MPHF_N);
+    TEST_ASSERT_EQUAL_INT(0, run_mphf_sizes(&scalar, ptrs, sizes));
+#if XXH3_HAVE_SSE2
+    {   static const mphf_fns_t sse2 = MPHF_FNS(sse2);
+        TEST_ASSERT_EQUAL_INT(0, run_mphf_sizes(&sse2, ptrs, sizes));
+    }
+#endif
+#if XXH3_HAVE_AVX2
+    TEST_TRY_VARIANT("AVX2", {
+        static const mphf_fns_t avx2 = MPHF_FNS(avx2);
+        bad = run_mphf_sizes(&avx2, ptrs, sizes);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    TEST_TRY_VARIANT("AVX512", {
+        static const mphf_fns_t avx512 = MPHF_FNS(avx512);
+        bad = run_mphf_sizes(&avx512, ptrs, sizes);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    {   static const mphf_fns_t neon = MPHF_FNS(neon);
+        TEST_ASSERT_EQUAL_INT(0, run_mphf_sizes(&neon, ptrs, sizes));
+    }
+#endif
+#if XXH3_HAVE_SVE
+    TEST_TRY_VARIANT("SVE", {
+        static const mphf_fns_t sve = MPHF_FNS(sve);
+        bad = run_mphf_sizes(&sve, ptrs, sizes);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+    (void)bad;
+    free(sizes);
+    free(ptrs);
+    free(buf);
+}
+
+static void test_xxh3_mphf_image_and_errors(void)
+{
+    static unsigned char buf[17 * 1000];
+    const void*          ptrs[1000];
+    size_t               sizes[1000];
+    size_t const         size  = xxh3_mphf_size(1000);
+    unsigned char*       image = (unsigned char*)malloc(size);
+    xxh3_mphf_t          mphf;
+
+    TEST_ASSERT_NOT_NULL(image);
+    make_mphf_keys(buf, ptrs, sizes, 1000);
+    TEST_ASSERT_TRUE(xxh3_mphf_size(1000000) < 1000000);  /* under 8 bits per key */
+    if (sizeof(size_t) > 4) {
+        TEST_ASSERT_EQUAL_UINT64(0, xxh3_mphf_size((size_t)((uint64_t)UINT32_MAX + 1)));
+    }
+
+    /* too small a destination, and keys that are not distinct */
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_mphf_build_scalar(image, size - 1, ptrs, sizes, 1000,
+                                                             SEED1, 1));
+    ptrs[500]  = ptrs[100];
+    sizes[500] = sizes[100];
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_mphf_build_scalar(image, size, ptrs, sizes, 1000,
+                                                             SEED1, 1));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_mphf_view(&mphf, image, size));
+    make_mphf_keys(buf, ptrs, sizes, 1000);
+
+    /* the seed is recorded, and the image checked */
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_mphf_build_scalar(image, size, ptrs, sizes, 1000, SEED1, 0));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_mphf_view(&mphf, image, size));
+    TEST_ASSERT_EQUAL_UINT64(1000, mphf.count);
+    TEST_ASSERT_TRUE(mphf.seed - SEED1 < 16);
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_mphf_view(&mphf, image, size - 1));
+    image[16] ^= 1;
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_mphf_view(&mphf, image, size));
+    image[16] ^= 1;
+    image[8] ^= 1;
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_mphf_view(&mphf, image, size));
+    free(image);
+}
+
+#define PARTITION_N 200003
+
+typedef struct {
+    int (*fixed)(xxh3_partition_tuple_t*, size_t*, const void*, size_t, const uint64_t*, size_t,
+                 unsigned, uint64_t, unsigned);
+    int (*var)(xxh3_partition_tuple_t*, size_t*, const void* const*, const size_t*,
+               const uint64_t*, size_t, unsigned, uint64_t, unsigned);
+} partition_fns_t;
+
+/* The stable partition of rows ptrs[i] / sizes[i] by the top `bits` bits of
+ * xxh3_64_scalar(), one store per tuple */
+static void partition_direct(xxh3_partition_tuple_t* out, size_t* hist, const void* const* ptrs,
+                             const size_t* sizes, const uint64_t* payloads, size_t n,
+                             unsigned bits)
+{
+    size_t const parts  = (size_t)1 << bits;
+    size_t*      cursor = (size_t*)calloc(parts, sizeof(size_t));
+    size_t       i, p, sum;
+
+    memset(hist, 0, parts * sizeof(size_t));
+    for (i = 0; i < n; i++) {
+        uint64_t const h = xxh3_64_scalar(ptrs[i], sizes[i], SEED2);
+        hist[bits ? h >> (64 - bits) : 0]++;
+    }
+    for (p = 0, sum = 0; p < parts; p++) {
+        cursor[p] = sum;
+        sum += hist[p];
+    }
+    for (i = 0; i < n; i++) {
+        uint64_t const h = xxh3_64_scalar(ptrs[i], sizes[i], SEED2);
+        xxh3_partition_tuple_t* const t = &out[cursor[bits ? h >> (64 - bits) : 0]++];
+        t->hash    = h;
+        t->payload = (payloads != NULL) ? payloads[i] : i;
+    }
+    free(cursor);
+}
+
+/* Partitions the first n rows with one variant on `threads` threads, into
+ * a dst `offset` bytes past a 64-byte boundary: fixed-width keys of
+ * `key_size` bytes from buf with row ids, and the variable-width keys
+ * ptrs / sizes with payloads. Returns the number of mismatches with
+ * partition_direct(). */
+static int run_partition(const partition_fns_t* f, const unsigned char* buf,
+                         const void* const* ptrs, const size_t* sizes, size_t n, size_t key_size,
+                         unsigned bits, unsigned threads, size_t offset)
+{
+    size_t const            parts    = (size_t)1 << bits;
+    size_t const            bytes    = (n + 1) * sizeof(xxh3_partition_tuple_t);
+    unsigned char*          block    = (unsigned char*)malloc(bytes + 128);
+    xxh3_partition_tuple_t* ref      = (xxh3_partition_tuple_t*)malloc(bytes);
+    size_t*                 hist     = (size_t*)malloc(parts * sizeof(size_t));
+    size_t*                 ref_hist = (size_t*)malloc(parts * sizeof(size_t));
+    const void**            kptrs    = (const void**)malloc((n + 1) * sizeof(void*));
+    size_t*                 ksizes   = (size_t*)malloc((n + 1) * sizeof(size_t));
+    uint64_t*               payloads = (uint64_t*)malloc((n + 1) * sizeof(uint64_t));
+    xxh3_partition_tuple_t* dst;
+    size_t                  i;
+    int                     bad = 0;
+
+    if (block == NULL || ref == NULL || hist == NULL || ref_hist == NULL || kptrs == NULL
+        || ksizes == NULL || payloads == NULL) {
+        bad = 1;
+        goto done;
+    }
+    dst = (xxh3_partition_tuple_t*)(void*)(block + (64 - (size_t)block % 64) % 64 + offset);
+    for (i = 0; i < n; i++) {
+        kptrs[i]    = buf + i * key_size;
+        ksizes[i]   = key_size;
+        payloads[i] = (uint64_t)i * 3 + 1;
+    }
+
+    partition_direct(ref, ref_hist, kptrs, ksizes, NULL, n, bits);
+    bad += f->fixed(dst, hist, buf, key_size, NULL, n, bits, SEED2, threads) != XXH3_OK;
+    bad += memcmp(dst, ref, n * sizeof(*ref)) != 0;
+    bad += memcmp(hist, ref_hist, parts * sizeof(size_t)) != 0;
+
+    partition_direct(ref, ref_hist, ptrs, sizes, payloads, n, bits);
+    bad += f->var(dst, hist, ptrs, sizes, payloads, n, bits, SEED2, threads) != XXH3_OK;
+    bad += memcmp(dst, ref, n * sizeof(*ref)) != 0;
+    bad += memcmp(hist, ref_hist, parts * sizeof(size_t)) != 0;
+done:
+    free(payloads);
+    free(ksizes);
+    free(kptrs);
+    free(ref_hist);
+    free(hist);
+    free(ref);
+    free(block);
+    return bad;
+}
+
+/* Direct and write-combined stores at every line phase and unaligned, the
+ * 8-byte and generic key paths, and several threads */
+static int run_partition_cases(const partition_fns_t* f, const unsigned char* buf,
+                               const void* const* ptrs, const size_t* sizes)
+{
+    static const size_t   key_sizes[] = { 8, 5, 17 };
+    static const unsigned bits[]      = { 0, 3, 9, 16 };
+    static const size_t   offsets[]   = { 0, 16, 48, 8 };
+    size_t k, b, o;
+    int    bad = run_partition(f, buf, ptrs, sizes, 0, 8, 4, 1, 0);
+
+    for (k = 0; k < 3; k++) {
+        for (b = 0; b < 4; b++) {
+            for (o = 0; o < 4; o++) {
+                bad += run_partition(f, buf, ptrs, sizes, 1001, key_sizes[k], bits[b], 1,
+                                     offsets[o]);
+            }
+        }
+    }
+    bad += run_partition(f, buf, ptrs, sizes, PARTITION_N, 8, 10, 3, 16);
+    bad += run_partition(f, buf, ptrs, sizes, PARTITION_N, 17, 5, 0, 0);
+    return bad;
+}
+
+#define PARTITION_FNS(v) { xxh3_partition_##v, xxh3_partition_var_##v }
+
+static void test_xxh3_partition_variants_match_direct(void)
+{
+    static const partition_fns_t scalar = PARTITION_FNS(scalar);
+    unsigned char* buf   = (unsigned char*)malloc(17 * PARTITION_N);
+    const void**   ptrs  = (const void**)malloc(PARTITION_N * sizeof(void*));
+    size_t*        sizes = (size_t*)malloc(PARTITION_N * sizeof(size_t));
+    int            bad   = 0;
+
+    TEST_ASSERT_NOT_NULL(buf);
+    TEST_ASSERT_NOT_NULL(ptrs);
+    TEST_ASSERT_NOT_NULL(sizes);
+    make_mphf_keys(buf, ptrs, sizes, PARTITION_N);
+    TEST_ASSERT_EQUAL_INT(0, run_partition_cases(&scalar, buf, ptrs, sizes));
+#if XXH3_HAVE_SSE2
+    {   static const partition_fns_t sse2 = PARTITION_FNS(sse2);
+        TEST_ASSERT_EQUAL_INT(0, run_partition_cases(&sse2, buf, ptrs, sizes));
+    }
+#endif
+#if XXH3_HAVE_AVX2
+    TEST_TRY_VARIANT("AVX2", {
+        static const partition_fns_t avx2 = PARTITION_FNS(avx2);
+        bad = run_partition_cases(&avx2, buf, ptrs, sizes);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    TEST_TRY_VARIANT("AVX512", {
+        static const partition_fns_t avx512 = PARTITION_FNS(avx512);
+        bad = run_partition_cases(&avx512, buf, ptrs, sizes);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    {   static const partition_fns_t neon = PARTITION_FNS(neon);
+        TEST_ASSERT_EQUAL_INT(0, run_partition_cases(&neon, buf, ptrs, sizes));
+    }
+#endif
+#if XXH3_HAVE_SVE
+    TEST_TRY_VARIANT("SVE", {
+        static const partition_fns_t sve = PARTITION_FNS(sve);
+        bad = run_partition_cases(&sve, buf, ptrs, sizes);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+    (void)bad;
+    free(sizes);
+    free(ptrs);
+    free(buf);
+}
+
+static void test_xxh3_partition_errors(void)
+{
+    static const uint64_t  keys[4] = { 1, 2, 3, 4 };
+    const void*            ptrs[4] = { &keys[0], &keys[1], &keys[2], &keys[3] };
+    size_t                 sizes[4] = { 8, 8, 8, 8 };
+    xxh3_partition_tuple_t dst[4];
+    size_t                 hist[2] = { 7, 7 };
+
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_partition_scalar(dst, hist, keys, 8, NULL, 4, 17, SEED2, 1));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_partition_scalar(dst, NULL, keys, 8, NULL, 4, 1, SEED2, 1));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_partition_scalar(NULL, hist, keys, 8, NULL, 4, 1, SEED2, 1));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_partition_scalar(dst, hist, NULL, 8, NULL, 4, 1, SEED2, 1));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_partition_var_scalar(dst, hist, NULL, sizes, NULL, 4, 1,
+                                                                SEED2, 1));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_partition_var_scalar(dst, hist, ptrs, NULL, NULL, 4, 1,
+                                                                SEED2, 1));
+
+    /* no rows: the histogram is still written */
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_partition_scalar(NULL, hist, NULL, 8, NULL, 0, 1, SEED2, 0));
+    TEST_ASSERT_EQUAL_UINT64(0, hist[0]);
+    TEST_ASSERT_EQUAL_UINT64(0, hist[1]);
+
+    /* one partition keeps the input order */
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_partition_var_scalar(dst, hist, ptrs, sizes, keys, 4, 0,
+                                                             SEED2, 0));
+    TEST_ASSERT_EQUAL_UINT64(4, hist[0]);
+    TEST_ASSERT_EQUAL_UINT64(3, dst[2].payload);
+    TEST_ASSERT_EQUAL_UINT64(xxh3_64_scalar(&keys[2], 8, SEED2), dst[2].hash);
+}
+
+typedef struct {
+    size_t (*rendezvous)(const void*, size_t, const uint64_t*, const double*, size_t, size_t*,
+                         size_t);
+    size_t (*batch)(const void* const*, const size_t*, size_t, const uint64_t*, const double*,
+                    size_t, size_t*, size_t);
+    void (*jump_batch)(const void* const*, const size_t*, size_t, uint64_t, uint32_t, uint32_t*);
+} consistent_fns_t;
+
+/* Rendezvous ranking by scoring every node and sorting: ~h ascending
+ * without weights, -ln(u) / w ascending with them, nodes of weight <= 0
+ * left out, the lower index first on equal scores. Returns the number of
+ * nodes ranked. */
+static size_t rendezvous_naive(const void* key, size_t size, const uint64_t* seeds,
+                               const double* weights, size_t nodes, size_t* top, size_t n_top)
+{
+    uint64_t* rank  = (uint64_t*)malloc((nodes + 1) * sizeof(uint64_t));
+    double*   score = (double*)malloc((nodes + 1) * sizeof(double));
+    size_t*   order = (size_t*)malloc((nodes + 1) * sizeof(size_t));
+    size_t    m = 0, i, j;
+
+    for (j = 0; j < nodes; j++) {
+        uint64_t const h = xxh3_64_scalar(key, size, seeds[j]);
+        double         s = 0;
+        if (weights != NULL) {
+            if (!(weights[j] > 0)) {
+                continue;
+            }
+            s = -log(((double)(h >> 12) + 0.5) * 0x1p-52) / weights[j];
+        }
+        for (i = m++; i > 0 && (weights ? s < score[i - 1] : ~h < rank[i - 1]); i--) {
+            rank[i]  = rank[i - 1];
+            score[i] = score[i - 1];
+            order[i] = order[i - 1];
+        }
+        rank[i]  = ~h;
+        score[i] = s;
+        order[i] = j;
+    }
+    n_top = (n_top < XXH3_RENDEZVOUS_MAX_TOP) ? n_top : XXH3_RENDEZVOUS_MAX_TOP;
+    m     = (m < n_top) ? m : n_top;
+    memcpy(top, order, m * sizeof(size_t));
+    free(order);
+    free(score);
+    free(rank);
+    return m;
+}
+
+/* Rankings of one variant against rendezvous_naive() for key sizes on
+ * every multiseed path, node counts around the seed chunk, and top-N sizes
+ * up to past the cap; the batch form against the single one; jump hashing
+ * against xxh3_jump_bucket() of xxh3_64_scalar(). Returns the number of
+ * mismatches. */
+static int run_consistent(const consistent_fns_t* f, const unsigned char* buf,
+                          const uint64_t* seeds, const double* weights)
+{
+    static const size_t key_sizes[] = { 0, 5, 8, 16, 40, 300 };
+    static const size_t node_counts[] = { 1, 7, 64, 65, 500 };
+    static const size_t tops[]      = { 1, 3, 64, 100 };
+    static const uint32_t jump_buckets[] = { 0, 1, 1000 };
+    const void*         ptrs[6];
+    size_t              got[6 * XXH3_RENDEZVOUS_MAX_TOP];
+    size_t              want[XXH3_RENDEZVOUS_MAX_TOP];
+    uint32_t            buckets[6];
+    size_t              k, c, t, i;
+    int                 w, bad = 0;
+
+    for (k = 0; k < 6; k++) {
+        ptrs[k] = buf + 3 * k;
+        for (c = 0; c < 5; c++) {
+            for (t = 0; t < 4; t++) {
+                for (w = 0; w < 2; w++) {
+                    const double* const wt = w ? weights : NULL;
+                    size_t const        m  = rendezvous_naive(ptrs[k], key_sizes[k], seeds, wt,
+                                                              node_counts[c], want, tops[t]);
+                    bad += f->rendezvous(ptrs[k], key_sizes[k], seeds, wt, node_counts[c], got,
+                                         tops[t]) != m;
+                    bad += memcmp(got, want, m * sizeof(size_t)) != 0;
+                }
+            }
+        }
+    }
+
+    for (w = 0; w < 2; w++) {
+        const double* const wt = w ? weights : NULL;
+        bad += f->batch(ptrs, key_sizes, 6, seeds, wt, 500, got, 3) != 3;
+        for (k = 0; k < 6; k++) {
+            size_t const m = rendezvous_naive(ptrs[k], key_sizes[k], seeds, wt, 500, want, 3);
+            bad += m != 3 || memcmp(got + 3 * k, want, 3 * sizeof(size_t)) != 0;
+        }
+    }
+
+    for (i = 0; i < 3; i++) {
+        uint32_t const n = jump_buckets[i];
+        f->jump_batch(ptrs, key_sizes, 6, SEED2, n, buckets);
+        for (k = 0; k < 6; k++) {
+            bad += buckets[k] != xxh3_jump_bucket(xxh3_64_scalar(ptrs[k], key_sizes[k], SEED2), n);
+        }
+    }
+    return bad;
+}
+
+#define CONSISTENT_FNS(v) { xxh3_rendezvous_##v, xxh3_rendezvous_batch_##v, xxh3_jump_batch_##v }
+
+static void test_xxh3_consistent_variants_match_naive(void)
+{
+    static const consistent_fns_t scalar = CONSISTENT_FNS(scalar);
+    unsigned char buf[320];
+    uint64_t      seeds[500];
+    double        weights[500];
+    size_t        i;
+    int           bad = 0;
+
+    for (i = 0; i < sizeof(buf); i++) {
+        buf[i] = (unsigned char)(i * 131 + 7);
+    }
+    for (i = 0; i < 500; i++) {
+        seeds[i]   = (uint64_t)i * 0x9E3779B97F4A7C15ULL;
+        /* a few nodes out of service, and one negative and one NaN weight */
+        weights[i] = (i % 37 == 5) ? 0.0 : 0.25 + (double)(i % 9);
+    }
+    weights[11] = -1.0;
+    weights[12] = nan("");
+
+    TEST_ASSERT_EQUAL_INT(0, run_consistent(&scalar, buf, seeds, weights));
+#if XXH3_HAVE_SSE2
+    {   static const consistent_fns_t sse2 = CONSISTENT_FNS(sse2);
+        TEST_ASSERT_EQUAL_INT(0, run_consistent(&sse2, buf, seeds, weights));
+    }
+#endif
+#if XXH3_HAVE_AVX2
+    TEST_TRY_VARIANT("AVX2", {
+        static const consistent_fns_t avx2 = CONSISTENT_FNS(avx2);
+        bad = run_consistent(&avx2, buf, seeds, weights);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    TEST_TRY_VARIANT("AVX512", {
+        static const consistent_fns_t avx512 = CONSISTENT_FNS(avx512);
+        bad = run_consistent(&avx512, buf, seeds, weights);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    {   static const consistent_fns_t neon = CONSISTENT_FNS(neon);
+        TEST_ASSERT_EQUAL_INT(0, run_consistent(&neon, buf, seeds, weights));
+    }
+#endif
+#if XXH3_HAVE_SVE
+    TEST_TRY_VARIANT("SVE", {
+        static const consistent_fns_t sve = CONSISTENT_FNS(sve);
+        bad = run_consistent(&sve, buf, seeds, weights);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+    (void)bad;
+}
+
+static void test_xxh3_consistent_properties(void)
+{
+    static const double weights[3] = { 1.0, 2.0, 5.0 };
+    static const double retired[3] = { 0.0, -1.0, 0.0 };
+    uint64_t            seeds[3]   = { 11, 22, 33 };
+    size_t              hits[3]    = { 0, 0, 0 };
+    size_t              top[3];
+    uint64_t            i;
+    uint32_t            b;
+
+    /* published values of the jump hash */
+    TEST_ASSERT_EQUAL_UINT32(0, xxh3_jump_bucket(1, 1));
+    TEST_ASSERT_EQUAL_UINT32(43, xxh3_jump_bucket(42, 57));
+    TEST_ASSERT_EQUAL_UINT32(361, xxh3_jump_bucket(0xDEAD10CC, 666));
+    TEST_ASSERT_EQUAL_UINT32(520, xxh3_jump_bucket(256, 1024));
+    TEST_ASSERT_EQUAL_UINT32(0, xxh3_jump_bucket(256, 0));
+
+    /* adding bucket b only moves keys into b */
+    for (i = 0; i < 2000; i++) {
+        uint64_t const h = xxh3_64_scalar(&i, sizeof(i), SEED1);
+        for (b = 1; b < 40; b++) {
+            uint32_t const before = xxh3_jump_bucket(h, b);
+            uint32_t const after  = xxh3_jump_bucket(h, b + 1);
+            TEST_ASSERT_TRUE(before < b);
+            TEST_ASSERT_TRUE(after == before || after == b);
+        }
+    }
+
+    /* keys spread over nodes in proportion to their weights, within 5% */
+    for (i = 0; i < 16000; i++) {
+        TEST_ASSERT_EQUAL_UINT64(1, xxh3_rendezvous_scalar(&i, sizeof(i), seeds, weights, 3, top, 1));
+        hits[top[0]]++;
+    }
+    TEST_ASSERT_TRUE(hits[0] > 1900 && hits[0] < 2100);
+    TEST_ASSERT_TRUE(hits[1] > 3800 && hits[1] < 4200);
+    TEST_ASSERT_TRUE(hits[2] > 9500 && hits[2] < 10500);
+
+    /* removing a node only moves the keys it held */
+    for (i = 0; i < 2000; i++) {
+        size_t before, after;
+        (void)xxh3_rendezvous_scalar(&i, sizeof(i), seeds, NULL, 3, top, 1);
+        before = top[0];
+        (void)xxh3_rendezvous_scalar(&i, sizeof(i), seeds, NULL, 2, top, 1);
+        after = top[0];
+        TEST_ASSERT_TRUE(before == 2 || after == before);
+    }
+
+    /* no nodes, no top-N, or only out-of-service nodes rank nothing */
+    TEST_ASSERT_EQUAL_UINT64(0, xxh3_rendezvous_scalar("k", 1, seeds, NULL, 0, top, 3));
+    TEST_ASSERT_EQUAL_UINT64(0, xxh3_rendezvous_scalar("k", 1, seeds, NULL, 3, top, 0));
+    TEST_ASSERT_EQUAL_UINT64(0, xxh3_rendezvous_scalar("k", 1, seeds, retired, 3, top, 3));
+    TEST_ASSERT_EQUAL_UINT64(2, xxh3_rendezvous_scalar("k", 1, seeds, NULL, 2, top, 3));
+}
+
+/* Spans three 1 MiB thread ranges, with a short last block */
+#define BLOCKS_LEN ((3u << 20) + (1u << 19) + 100)
+
+typedef struct {
+    int (*blocks)(const void*, size_t, size_t, uint64_t, uint64_t*);
+    int (*mt)(const void*, size_t, size_t, uint64_t, uint64_t*, unsigned);
+    int (*verify)(const void*, size_t, size_t, uint64_t, const uint64_t*, size_t*, size_t, size_t*,
+                  unsigned);
+} blocks_fns_t;
+
+/* Checksums of one variant against xxh3_64_scalar() per block, for block
+ * sizes on both sides of the 240-byte long-input threshold, lengths around
+ * a block boundary and both seeds; the threaded form; and verification of
+ * a corrupted buffer across thread ranges. Returns the number of
+ * mismatches. */
+static int run_blocks(const blocks_fns_t* f, unsigned char* buf, uint64_t* out, uint64_t* ref)
+{
+    static const size_t block_sizes[] = { 1, 16, 240, 241, 1024, 4096, 5000 };
+    static const size_t corrupt[]     = { 3, 5, 400, 601 };
+    size_t              bad[2];
+    size_t              b, l, s, i, n, n_bad;
+    int                 errors = 0;
+
+    for (b = 0; b < 7; b++) {
+        size_t const bs     = block_sizes[b];
+        size_t const lens[] = { 0, 1, bs - 1, bs, bs + 1, 10 * bs + 17 };
+        for (l = 0; l < 6; l++) {
+            for (s = 0; s < 2; s++) {
+                uint64_t const seed = s ? SEED2 : SEED1;
+                n = lens[l] / bs + (lens[l] % bs != 0);
+                for (i = 0; i < n; i++) {
+                    size_t const size = (i + 1 < n) ? bs : lens[l] - i * bs;
+                    ref[i] = xxh3_64_scalar(buf + i * bs, size, seed);
+                }
+                out[n] = 0x5A5A5A5A5A5A5A5AULL;
+                errors += f->blocks(buf, lens[l], bs, seed, out) != XXH3_OK;
+                errors += memcmp(out, ref, n * sizeof(uint64_t)) != 0;
+                errors += out[n] != 0x5A5A5A5A5A5A5A5AULL;
+            }
+        }
+    }
+
+    n = BLOCKS_LEN / 4096 + 1;
+    for (i = 0; i < n; i++) {
+        size_t const size = (i + 1 < n) ? 4096 : BLOCKS_LEN - i * 4096;
+        ref[i] = xxh3_64_scalar(buf + i * 4096, size, SEED2);
+    }
+    memset(out, 0, n * sizeof(uint64_t));
+    errors += f->mt(buf, BLOCKS_LEN, 4096, SEED2, out, 3) != XXH3_OK;
+    errors += memcmp(out, ref, n * sizeof(uint64_t)) != 0;
+    errors += f->verify(buf, BLOCKS_LEN, 4096, SEED2, ref, bad, 2, &n_bad, 3) != XXH3_OK;
+    errors += n_bad != 0;
+
+    /* corrupted blocks in each thread's range; only the first two listed */
+    for (i = 0; i < 4; i++) {
+        buf[corrupt[i] * 4096 + 7] ^= 0x80;
+    }
+    errors += f->verify(buf, BLOCKS_LEN, 4096, SEED2, ref, bad, 2, &n_bad, 3) != XXH3_OK;
+    errors += n_bad != 4 || bad[0] != corrupt[0] || bad[1] != corrupt[1];
+    errors += f->verify(buf, BLOCKS_LEN, 4096, SEED2, ref, NULL, 0, &n_bad, 1) != XXH3_OK;
+    errors += n_bad != 4;
+    for (i = 0; i < 4; i++) {
+        buf[corrupt[i] * 4096 + 7] ^= 0x80;
+    }
+    return errors;
+}
+
+#define BLOCKS_FNS(v) { xxh3_64_blocks_##v, xxh3_64_blocks_mt_##v, xxh3_64_blocks_verify_##v }
+
+static void test_xxh3_blocks_variants_match_per_block(void)
+{
+    static const blocks_fns_t scalar = BLOCKS_FNS(scalar);
+    unsigned char* buf = (unsigned char*)malloc(BLOCKS_LEN);
+    uint64_t*      out = (uint64_t*)malloc((BLOCKS_LEN / 16 + 1) * sizeof(uint64_t));
+    uint64_t*      ref = (uint64_t*)malloc((BLOCKS_LEN / 16 + 1) * sizeof(uint64_t));
+    size_t         i;
+    int            bad = 0;
+
+    TEST_ASSERT_NOT_NULL(buf);
+    TEST_ASSERT_NOT_NULL(out);
+    TEST_ASSERT_NOT_NULL(ref);
+    for (i = 0; i < BLOCKS_LEN; i++) {
+        buf[i] = (unsigned char)(i * 2654435761U >> 24);
+    }
+    TEST_ASSERT_EQUAL_INT(0, run_blocks(&scalar, buf, out, ref));
+#if XXH3_HAVE_SSE2
+    {   static const blocks_fns_t sse2 = BLOCKS_FNS(sse2);
+        TEST_ASSERT_EQUAL_INT(0, run_blocks(&sse2, buf, out, ref));
+    }
+#endif
+#if XXH3_HAVE_AVX2
+    TEST_TRY_VARIANT("AVX2", {
+        static const blocks_fns_t avx2 = BLOCKS_FNS(avx2);
+        bad = run_blocks(&avx2, buf, out, ref);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_AVX512
+    TEST_TRY_VARIANT("AVX512", {
+        static const blocks_fns_t avx512 = BLOCKS_FNS(avx512);
+        bad = run_blocks(&avx512, buf, out, ref);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+#if XXH3_HAVE_NEON
+    {   static const blocks_fns_t neon = BLOCKS_FNS(neon);
+        TEST_ASSERT_EQUAL_INT(0, run_blocks(&neon, buf, out, ref));
+    }
+#endif
+#if XXH3_HAVE_SVE
+    TEST_TRY_VARIANT("SVE", {
+        static const blocks_fns_t sve = BLOCKS_FNS(sve);
+        bad = run_blocks(&sve, buf, out, ref);
+        if (!_test_skip_variant) {
+            TEST_ASSERT_EQUAL_INT(0, bad);
+        }
+    });
+#endif
+    (void)bad;
+    free(ref);
+    free(out);
+    free(buf);
+}
+
+static void test_xxh3_blocks_errors(void)
+{
+    static const unsigned char buf[64] = { 0 };
+    uint64_t                   out[1];
+    size_t                     bad[1], n_bad = 7;
+
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_64_blocks_scalar(buf, 64, 0, SEED1, out));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_64_blocks_scalar(NULL, 64, 64, SEED1, out));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_64_blocks_scalar(buf, 64, 64, SEED1, NULL));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_64_blocks_mt_scalar(buf, 64, 0, SEED1, out, 0));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_64_blocks_mt_scalar(buf, 64, 64, SEED1, NULL, 0));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_64_blocks_verify_scalar(buf, 64, 64, SEED1, out, bad, 1,
+                                                                   NULL, 0));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_64_blocks_verify_scalar(buf, 64, 64, SEED1, NULL, bad, 1,
+                                                                   &n_bad, 0));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_64_blocks_verify_scalar(buf, 64, 64, SEED1, out, NULL, 1,
+                                                                   &n_bad, 0));
+
+    /* an empty buffer has no blocks */
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_64_blocks_scalar(NULL, 0, 64, SEED1, NULL));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_64_blocks_verify_scalar(NULL, 0, 64, SEED1, NULL, NULL, 0,
+                                                                &n_bad, 0));
+    TEST_ASSERT_EQUAL_UINT64(0, n_bad);
+}
+
+/* Mismatches seen by the scrubber callbacks, in report order */
+typedef struct {
+    size_t                   region[8];
+    size_t                   block[8];
+    size_t                   n;
+    size_t                   calls;
+    xxh3_scrubber_progress_t last;
+} scrub_log_t;
+
+static void scrub_on_mismatch(void* ctx, size_t region, size_t block)
+{
+    scrub_log_t* const log = (scrub_log_t*)ctx;
+    if (log->n < 8) {
+        log->region[log->n] = region;
+        log->block[log->n]  = block;
+    }
+    log->n++;
+}
+
+static void scrub_on_progress(void* ctx, const xxh3_scrubber_progress_t* progress)
+{
+    scrub_log_t* const log = (scrub_log_t*)ctx;
+    log->calls++;
+    log->last = *progress;
+}
+
+#define SCRUB_LEN   (64 * 1024 + 100)
+#define SCRUB_BLOCK 4096
+
+static void scrub_sleep_ms(long ms)
+{
+    struct timespec ts;
+    ts.tv_sec  = ms / 1000;
+    ts.tv_nsec = (ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+static void test_xxh3_scrubber_step_reports_mismatches(void)
+{
+    static unsigned char     a[SCRUB_LEN], b[SCRUB_LEN];
+    static uint64_t          sums64[SCRUB_LEN / SCRUB_BLOCK + 1];
+    static xxh3_128_t        sums128[SCRUB_LEN / SCRUB_BLOCK + 1];
+    size_t const             n = SCRUB_LEN / SCRUB_BLOCK + 1;
+    xxh3_scrubber_config_t   config;
+    xxh3_scrubber_progress_t p;
+    xxh3_scrubber_t*         s;
+    scrub_log_t              log;
+    size_t                   ra, rb, i;
+
+    for (i = 0; i < SCRUB_LEN; i++) {
+        a[i] = (unsigned char)(i * 2654435761U >> 24);
+        b[i] = (unsigned char)(i * 40503U >> 8);
+    }
+    for (i = 0; i < n; i++) {
+        size_t const size = (i + 1 < n) ? SCRUB_BLOCK : SCRUB_LEN - i * SCRUB_BLOCK;
+        sums64[i]  = xxh3_64_scalar(a + i * SCRUB_BLOCK, size, SEED1);
+        sums128[i] = xxh3_128_scalar(b + i * SCRUB_BLOCK, size, SEED2);
+    }
+    a[5 * SCRUB_BLOCK + 7] ^= 1;
+    b[SCRUB_LEN - 1] ^= 1;   /* the short last block */
+
+    memset(&log, 0, sizeof(log));
+    memset(&config, 0, sizeof(config));
+    config.chunk_bytes = 3 * SCRUB_BLOCK;
+    config.on_mismatch = scrub_on_mismatch;
+    config.on_progress = scrub_on_progress;
+    config.ctx         = &log;
+    s = xxh3_scrubber_create(&config);
+    TEST_ASSERT_NOT_NULL(s);
+    TEST_ASSERT_EQUAL_UINT64(0, xxh3_scrubber_step(s, SCRUB_LEN));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_add(s, a, SCRUB_LEN, SCRUB_BLOCK, SEED1, 64,
+                                                     sums64, &ra));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_add(s, b, SCRUB_LEN, SCRUB_BLOCK, SEED2, 128,
+                                                     sums128, &rb));
+    TEST_ASSERT_EQUAL_UINT64(0, ra);
+    TEST_ASSERT_EQUAL_UINT64(1, rb);
+
+    /* whole blocks, chunk by chunk, and the position carries over */
+    TEST_ASSERT_EQUAL_UINT64(4 * SCRUB_BLOCK, xxh3_scrubber_step(s, 4 * SCRUB_BLOCK));
+    TEST_ASSERT_EQUAL_UINT64(2, log.calls);
+    xxh3_scrubber_progress(s, &p);
+    TEST_ASSERT_EQUAL_UINT64(0, p.region);
+    TEST_ASSERT_EQUAL_UINT64(4, p.block);
+    TEST_ASSERT_EQUAL_UINT64(0, p.mismatches);
+    TEST_ASSERT_EQUAL_UINT64(SCRUB_BLOCK, xxh3_scrubber_step(s, 1));
+    xxh3_scrubber_pause(s);
+    xxh3_scrubber_resume(s);
+    TEST_ASSERT_EQUAL_UINT64(SCRUB_BLOCK, xxh3_scrubber_step(s, 1));
+    TEST_ASSERT_EQUAL_UINT64(1, log.n);
+    TEST_ASSERT_EQUAL_UINT64(0, log.region[0]);
+    TEST_ASSERT_EQUAL_UINT64(5, log.block[0]);
+
+    /* the rest of both regions completes a pass */
+    TEST_ASSERT_EQUAL_UINT64(2 * SCRUB_LEN - 6 * SCRUB_BLOCK,
+                             xxh3_scrubber_step(s, 2 * SCRUB_LEN - 6 * SCRUB_BLOCK));
+    xxh3_scrubber_progress(s, &p);
+    TEST_ASSERT_EQUAL_UINT64(1, p.passes);
+    TEST_ASSERT_EQUAL_UINT64(2 * SCRUB_LEN, p.bytes);
+    TEST_ASSERT_EQUAL_UINT64(2, p.mismatches);
+    TEST_ASSERT_EQUAL_UINT64(0, p.region);
+    TEST_ASSERT_EQUAL_UINT64(0, p.block);
+    TEST_ASSERT_EQUAL_UINT64(2, log.n);
+    TEST_ASSERT_EQUAL_UINT64(1, log.region[1]);
+    TEST_ASSERT_EQUAL_UINT64(n - 1, log.block[1]);
+    TEST_ASSERT_EQUAL_UINT64(p.bytes, log.last.bytes);
+
+    /* a removed region is skipped */
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_remove(s, ra));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_scrubber_remove(s, 2));
+    TEST_ASSERT_EQUAL_UINT64(SCRUB_LEN, xxh3_scrubber_step(s, SCRUB_LEN));
+    xxh3_scrubber_progress(s, &p);
+    TEST_ASSERT_EQUAL_UINT64(2, p.passes);
+    TEST_ASSERT_EQUAL_UINT64(3, p.mismatches);
+    TEST_ASSERT_EQUAL_UINT64(1, log.region[2]);
+    xxh3_scrubber_free(s);
+
+    /* errors */
+    config.cpu_percent = 101;
+    TEST_ASSERT_NULL(xxh3_scrubber_create(&config));
+    TEST_ASSERT_NULL(xxh3_scrubber_create(NULL));
+    config.cpu_percent = 0;
+    s = xxh3_scrubber_create(&config);
+    TEST_ASSERT_NOT_NULL(s);
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_scrubber_add(s, a, SCRUB_LEN, 0, 0, 64, sums64, NULL));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_scrubber_add(s, a, SCRUB_LEN, 64, 0, 32, sums64, NULL));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_scrubber_add(s, a, SCRUB_LEN, 64, 0, 64, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_scrubber_add(s, NULL, SCRUB_LEN, 64, 0, 64, sums64,
+                                                        NULL));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_add(s, NULL, 0, 64, 0, 64, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT64(0, xxh3_scrubber_step(s, SCRUB_LEN));
+    xxh3_scrubber_free(s);
+}
+
+/* Replacing regions reuses their ids, so the region array stays as large
+ * as the regions in use, and removing the region being checked moves the
+ * position on */
+static void test_xxh3_scrubber_reuses_removed_regions(void)
+{
+    static unsigned char     buf[4 * SCRUB_BLOCK];
+    static uint64_t          sums[4];
+    xxh3_scrubber_config_t   config;
+    xxh3_scrubber_progress_t p;
+    xxh3_scrubber_t*         s;
+    size_t                   a, b, c, empty, i;
+
+    for (i = 0; i < sizeof(buf); i++) {
+        buf[i] = (unsigned char)(i * 2654435761U >> 24);
+    }
+    for (i = 0; i < 4; i++) {
+        sums[i] = xxh3_64_scalar(buf + i * SCRUB_BLOCK, SCRUB_BLOCK, SEED1);
+    }
+    memset(&config, 0, sizeof(config));
+    config.chunk_bytes = SCRUB_BLOCK;
+    s = xxh3_scrubber_create(&config);
+    TEST_ASSERT_NOT_NULL(s);
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_add(s, buf, sizeof(buf), SCRUB_BLOCK, SEED1, 64,
+                                                     sums, &a));
+    TEST_ASSERT_EQUAL_UINT64(0, a);
+
+    /* a segment replaced 1000 times, each time removed halfway through */
+    for (i = 0; i < 1000; i++) {
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_add(s, buf, sizeof(buf), SCRUB_BLOCK, SEED1,
+                                                         64, sums, &b));
+        TEST_ASSERT_EQUAL_UINT64(1, b);
+        TEST_ASSERT_EQUAL_UINT64(6 * SCRUB_BLOCK, xxh3_scrubber_step(s, 6 * SCRUB_BLOCK));
+        xxh3_scrubber_progress(s, &p);
+        TEST_ASSERT_EQUAL_UINT64(1, p.region);
+        TEST_ASSERT_EQUAL_UINT64(2, p.block);
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_remove(s, b));
+        xxh3_scrubber_progress(s, &p);
+        TEST_ASSERT_EQUAL_UINT64(0, p.region);
+        TEST_ASSERT_EQUAL_UINT64(0, p.block);
+    }
+    TEST_ASSERT_EQUAL_UINT64(1000, p.passes);
+    TEST_ASSERT_EQUAL_UINT64(6000 * SCRUB_BLOCK, p.bytes);
+    TEST_ASSERT_EQUAL_UINT64(0, p.mismatches);
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_scrubber_remove(s, b));
+
+    /* a hole is filled first, an empty region keeps its slot */
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_add(s, NULL, 0, SCRUB_BLOCK, SEED1, 64, NULL,
+                                                     &empty));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_add(s, buf, sizeof(buf), SCRUB_BLOCK, SEED1, 64,
+                                                     sums, &b));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_add(s, buf, sizeof(buf), SCRUB_BLOCK, SEED1, 64,
+                                                     sums, &c));
+    TEST_ASSERT_EQUAL_UINT64(1, empty);
+    TEST_ASSERT_EQUAL_UINT64(2, b);
+    TEST_ASSERT_EQUAL_UINT64(3, c);
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_remove(s, b));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_add(s, buf, sizeof(buf), SCRUB_BLOCK, SEED1, 64,
+                                                     sums, &b));
+    TEST_ASSERT_EQUAL_UINT64(2, b);
+
+    /* removing a region ahead of the position leaves it alone */
+    TEST_ASSERT_EQUAL_UINT64(SCRUB_BLOCK, xxh3_scrubber_step(s, SCRUB_BLOCK));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_remove(s, c));
+    xxh3_scrubber_progress(s, &p);
+    TEST_ASSERT_EQUAL_UINT64(0, p.region);
+    TEST_ASSERT_EQUAL_UINT64(1, p.block);
+    TEST_ASSERT_EQUAL_UINT64(7 * SCRUB_BLOCK, xxh3_scrubber_step(s, 7 * SCRUB_BLOCK));
+    xxh3_scrubber_progress(s, &p);
+    TEST_ASSERT_EQUAL_UINT64(1001, p.passes);
+    TEST_ASSERT_EQUAL_UINT64(0, p.region);
+    TEST_ASSERT_EQUAL_UINT64(0, p.block);
+
+    /* without regions the position restarts */
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_remove(s, empty));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_remove(s, b));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_remove(s, a));
+    TEST_ASSERT_EQUAL_UINT64(0, xxh3_scrubber_step(s, SCRUB_BLOCK));
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_add(s, buf, sizeof(buf), SCRUB_BLOCK, SEED1, 64,
+                                                     sums, &a));
+    TEST_ASSERT_EQUAL_UINT64(0, a);
+    TEST_ASSERT_EQUAL_UINT64(SCRUB_BLOCK, xxh3_scrubber_step(s, SCRUB_BLOCK));
+    xxh3_scrubber_progress(s, &p);
+    TEST_ASSERT_EQUAL_UINT64(0, p.region);
+    TEST_ASSERT_EQUAL_UINT64(1, p.block);
+    xxh3_scrubber_free(s);
+}
+
+#if !defined(_WIN32)
+/* Progress seen by a scrubber thread, read by the test under `lock` */
+typedef struct {
+    pthread_mutex_t          lock;
+    pthread_cond_t           cond;
+    size_t                   calls;
+    size_t                   mismatches;
+    double                   when;     /* CLOCK_MONOTONIC seconds of `last` */
+    xxh3_scrubber_progress_t last;
+    int                      mark;     /* store the next progress to `marked` */
+    xxh3_scrubber_progress_t marked;
+} scrub_watch_t;
+
+static double scrub_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void scrub_watch_mismatch(void* ctx, size_t region, size_t block)
+{
+    scrub_watch_t* const w = (scrub_watch_t*)ctx;
+    (void)region;
+    (void)block;
+    pthread_mutex_lock(&w->lock);
+    w->mismatches++;
+    pthread_mutex_unlock(&w->lock);
+}
+
+static void scrub_watch_progress(void* ctx, const xxh3_scrubber_progress_t* progress)
+{
+    scrub_watch_t* const w = (scrub_watch_t*)ctx;
+    pthread_mutex_lock(&w->lock);
+    w->calls++;
+    w->when = scrub_now();
+    w->last = *progress;
+    if (w->mark) {
+        w->marked = *progress;
+        w->mark   = 0;
+    }
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+}
+
+/* Waits up to 10 s for `calls` progress reports and no pending mark; 1 if
+ * they came. Called with w->lock held. */
+static int scrub_watch_wait(scrub_watch_t* w, size_t calls)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += 10;
+    while (w->calls < calls || w->mark) {
+        if (pthread_cond_timedwait(&w->cond, &w->lock, &deadline) != 0) {
+            break;
+        }
+    }
+    return w->calls >= calls && !w->mark;
+}
+#endif
+
+static void test_xxh3_scrubber_thread_limits_and_pauses(void)
+{
+    static unsigned char     buf[SCRUB_LEN];
+    static uint64_t          sums[SCRUB_LEN / SCRUB_BLOCK + 1];
+    size_t const             n    = SCRUB_LEN / SCRUB_BLOCK + 1;
+    double const             rate = 256 * 1024;
+    xxh3_scrubber_config_t   config;
+    xxh3_scrubber_t*         s;
+    size_t                   i;
+
+    for (i = 0; i < SCRUB_LEN; i++) {
+        buf[i] = (unsigned char)(i * 2654435761U >> 24);
+    }
+    for (i = 0; i < n; i++) {
+        sums[i] = xxh3_64_nt_scalar(buf + i * SCRUB_BLOCK,
+                                    (i + 1 < n) ? SCRUB_BLOCK : SCRUB_LEN - i * SCRUB_BLOCK, 0);
+    }
+    memset(&config, 0, sizeof(config));
+    config.bytes_per_sec = (uint64_t)rate;
+    config.cpu_percent   = 50;
+    config.chunk_bytes   = SCRUB_BLOCK;
+    config.hash64        = xxh3_64_nt_scalar;
+#if defined(_WIN32)
+    s = xxh3_scrubber_create(&config);
+    TEST_ASSERT_NOT_NULL(s);
+    TEST_ASSERT_EQUAL_INT(XXH3_ERROR, xxh3_scrubber_start(s));
+    xxh3_scrubber_free(s);
+    TEST_IGNORE_MESSAGE("no background thread without pthreads");
+#else
+    {
+        scrub_watch_t            w;
+        xxh3_scrubber_progress_t p, marked;
+        size_t                   calls, b0, b1, later;
+        double                   t0, t1;
+        int                      came;
+
+        memset(&w, 0, sizeof(w));
+        TEST_ASSERT_EQUAL_INT(0, pthread_mutex_init(&w.lock, NULL));
+        TEST_ASSERT_EQUAL_INT(0, pthread_cond_init(&w.cond, NULL));
+        config.on_mismatch = scrub_watch_mismatch;
+        config.on_progress = scrub_watch_progress;
+        config.ctx         = &w;
+        s = xxh3_scrubber_create(&config);
+        TEST_ASSERT_NOT_NULL(s);
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_add(s, buf, SCRUB_LEN, SCRUB_BLOCK, 0, 64,
+                                                         sums, NULL));
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_start(s));
+        TEST_ASSERT_EQUAL_UINT64(0, xxh3_scrubber_step(s, SCRUB_LEN));
+
+        /* Chunks after the one reported at t0 start after t0, and each
+         * waits for the bytes before it, so all but the first of those
+         * reported by t1 fit in rate * (t1 - t0) */
+        pthread_mutex_lock(&w.lock);
+        came  = scrub_watch_wait(&w, 1);
+        calls = w.calls;
+        b0    = (size_t)w.last.bytes;
+        t0    = w.when;
+        came &= scrub_watch_wait(&w, calls + 8);
+        b1    = (size_t)w.last.bytes;
+        t1    = w.when;
+        pthread_mutex_unlock(&w.lock);
+        TEST_ASSERT_TRUE(came);
+        TEST_ASSERT_TRUE((double)(b1 - b0 - SCRUB_BLOCK) <= rate * (t1 - t0) + 1.0);
+
+        /* paused, at most the chunk in flight completes; the next progress
+         * after resuming continues from the last one */
+        xxh3_scrubber_pause(s);
+        pthread_mutex_lock(&w.lock);
+        calls = w.calls;
+        pthread_mutex_unlock(&w.lock);
+        scrub_sleep_ms(100);
+        pthread_mutex_lock(&w.lock);
+        later  = w.calls;
+        p      = w.last;
+        w.mark = 1;
+        pthread_mutex_unlock(&w.lock);
+        TEST_ASSERT_TRUE(later <= calls + 1);
+        xxh3_scrubber_resume(s);
+        pthread_mutex_lock(&w.lock);
+        came   = scrub_watch_wait(&w, 0);
+        marked = w.marked;
+        pthread_mutex_unlock(&w.lock);
+        TEST_ASSERT_TRUE(came);
+        TEST_ASSERT_EQUAL_UINT64(p.bytes + ((p.block + 1 < n) ? SCRUB_BLOCK
+                                                              : SCRUB_LEN % SCRUB_BLOCK),
+                                 marked.bytes);
+        TEST_ASSERT_EQUAL_UINT64(0, marked.region);
+        TEST_ASSERT_EQUAL_UINT64((p.block + 1) % n, marked.block);
+
+        TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_remove(s, 0));
+        xxh3_scrubber_free(s);
+        TEST_ASSERT_EQUAL_UINT64(0, w.mismatches);
+        pthread_cond_destroy(&w.cond);
+        pthread_mutex_destroy(&w.lock);
+    }
+#endif
+}
+
+#if !defined(_WIN32)
+typedef struct {
+    xxh3_scrubber_t* s;
+    size_t           bytes;
+} scrub_step_task_t;
+
+static void* scrub_step_thread(void* arg)
+{
+    scrub_step_task_t* const task = (scrub_step_task_t*)arg;
+    task->bytes = xxh3_scrubber_step(task->s, 16 * SCRUB_BLOCK);
+    return NULL;
+}
+#endif
+
+/* Concurrent xxh3_scrubber_step() calls check disjoint chunks: two passes'
+ * worth of steps make exactly two passes */
+static void test_xxh3_scrubber_concurrent_steps(void)
+{
+#if defined(_WIN32)
+    TEST_IGNORE_MESSAGE("no threads without pthreads");
+#else
+    static unsigned char     buf[16 * SCRUB_BLOCK];
+    static uint64_t          sums[16];
+    xxh3_scrubber_config_t   config;
+    xxh3_scrubber_progress_t p;
+    xxh3_scrubber_t*         s;
+    scrub_step_task_t        tasks[2];
+    pthread_t                thread;
+    size_t                   i;
+
+    for (i = 0; i < sizeof(buf); i++) {
+        buf[i] = (unsigned char)(i * 2654435761U >> 24);
+    }
+    for (i = 0; i < 16; i++) {
+        sums[i] = xxh3_64_scalar(buf + i * SCRUB_BLOCK, SCRUB_BLOCK, SEED1);
+    }
+    sums[9] ^= 1;
+    memset(&config, 0, sizeof(config));
+    config.chunk_bytes = SCRUB_BLOCK;
+    s = xxh3_scrubber_create(&config);
+    TEST_ASSERT_NOT_NULL(s);
+    TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh3_scrubber_add(s, buf, sizeof(buf), SCRUB_BLOCK, SEED1, 64,
+                                                     sums, NULL));
+    tasks[0].s = tasks[1].s = s;
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, scrub_step_thread, &tasks[1]));
+    scrub_step_thread(&tasks[0]);
+    pthread_join(thread, NULL);
+    TEST_ASSERT_EQUAL_UINT64(sizeof(buf), tasks[0].bytes);
+    TEST_ASSERT_EQUAL_UINT64(sizeof(buf), tasks[1].bytes);
+    xxh3_scrubber_progress(s, &p);
+    TEST_ASSERT_EQUAL_UINT64(2, p.passes);
+    TEST_ASSERT_EQUAL_UINT64(2, p.mismatches);
+    TEST_ASSERT_EQUAL_UINT64(0, p.block);
+    xxh3_scrubber_free(s);
+#endif
+}
+
+/* ------------------------------------------------------ xxh64 */
+
+static void test_xxh64_single_shot_stable(void)
+{
+    uint64_t a = xxh64(LOREM, strlen(LOREM), SEED2);
+    uint64_t b = xxh64(LOREM, strlen(LOREM), SEED2);
+    TEST_ASSERT_EQUAL_UINT64(a, b);
+}
+
+static void test_xxh64_different_seeds_differ(void)
+{
+    uint64_t a = xxh64(LOREM, strlen(LOREM), SEED1);
+    uint64_t b = xxh64(LOREM, strlen(LOREM), SEED2);
+    TEST_ASSERT_NOT_EQUAL(a, b);
+}
+
+static void test_xxh64_empty_input_stable(void)
+{
+    uint64_t a = xxh64("", 0, SEED1);
+    uint64_t b = xxh64("", 0, SEED1);
+    TEST_ASSERT_EQUAL_UINT64(a, b);
+}
+
+static void test_xxh64_stream_matches_single_shot(void)
+{
+    const size_t   size  = strlen(LOREM);
+    const uint64_t ref   = xxh64(LOREM, size, SEED2);
+    xxh3_state_t*  state = xxh3_createState();
+
+    TEST_ASSERT_NOT_NULL(state);
     xxh64_reset(state, SEED2);
     TEST_ASSERT_EQUAL_INT(XXH3_OK, xxh64_update(state, LOREM, size));
     TEST_ASSERT_EQUAL_UINT64(ref, xxh64_digest(state));
@@ -1070,6 +4605,7 @@ int main(void)
     RUN_TEST(test_xxh3_64_variants_match_scalar_short);
     RUN_TEST(test_xxh3_64_variants_match_scalar_lorem);
     RUN_TEST(test_xxh3_64_variants_match_scalar_1mb);
+    RUN_TEST(test_xxh3_64_variants_match_scalar_every_short_size);
 
     /* xxh3-128 variants */
     RUN_TEST(test_xxh3_128_variants_match_scalar_short);
@@ -1114,6 +4650,19 @@ int main(void)
     /* state copy operations */
     RUN_TEST(test_xxh3_64_copy_state_matches_continued_hashing);
     RUN_TEST(test_xxh3_128_copy_state_branches_hashing);
+    RUN_TEST(test_xxh3_64_digest_withSuffix_matches_single_shot);
+    RUN_TEST(test_xxh3_128_digest_withSuffix_matches_single_shot);
+
+    /* non-temporal variants */
+    RUN_TEST(test_xxh3_64_nt_variants_match_scalar);
+    RUN_TEST(test_xxh3_128_nt_variants_match_scalar);
+    RUN_TEST(test_xxh3_nt_stream_matches_single_shot);
+    RUN_TEST(test_xxh3_update_multi_matches_single_shot);
+    RUN_TEST(test_xxh3_copy_variants_match_memcpy_and_hash);
+    RUN_TEST(test_xxh3_update_copy_matches_memcpy_and_hash);
+    RUN_TEST(test_xxh3_cstr_matches_sized_hash);
+    RUN_TEST(test_xxh3_64_ci_matches_lowercased_hash);
+    RUN_TEST(test_xxh3_64_strided2d_and_gather_match_contiguous);
 
     /* xxh32 */
     RUN_TEST(test_xxh32_single_shot_stable);
@@ -1122,6 +4671,8 @@ int main(void)
     RUN_TEST(test_xxh32_stream_matches_single_shot);
     RUN_TEST(test_xxh32_chunked_streaming_matches_single_shot);
     RUN_TEST(test_xxh32_stream_reset_reuse);
+    RUN_TEST(test_xxh32_vector_variants_match_scalar);
+    RUN_TEST(test_xxh32_vector_stream_matches_single_shot);
 
     /* xxh64 */
     RUN_TEST(test_xxh64_single_shot_stable);
@@ -1131,10 +4682,39 @@ int main(void)
     RUN_TEST(test_xxh64_chunked_streaming_matches_single_shot);
     RUN_TEST(test_xxh64_stream_reset_reuse);
 
+    /* multi-buffer xxh32/xxh64 */
+    RUN_TEST(test_xxh64_batch_variants_match_single_shot);
+    RUN_TEST(test_xxh32_batch_variants_match_single_shot);
+
+    /* multi-seed xxh3_64 */
+    RUN_TEST(test_xxh3_64_multiseed_variants_match_per_seed);
+    RUN_TEST(test_xxh3_64_multiseed_batch_matches_per_seed);
+
     /* Canonical representation round-trip */
     RUN_TEST(test_xxh32_canonical_roundtrip);
     RUN_TEST(test_xxh64_canonical_roundtrip);
     RUN_TEST(test_xxh128_canonical_roundtrip);
+    RUN_TEST(test_xxh3_128_sort_and_unique_match_cmp);
+    RUN_TEST(test_xxh3_index_matches_sorted_array);
+    RUN_TEST(test_xxh3_map_matches_reference);
+    RUN_TEST(test_hex_and_canonical_batch_match_single);
+    RUN_TEST(test_xxh3_bloom_variants_match_scalar);
+    RUN_TEST(test_xxh3_hll_variants_match_scalar);
+    RUN_TEST(test_xxh3_hll_estimates_and_errors);
+    RUN_TEST(test_xxh3_multiset_variants_match_scalar);
+    RUN_TEST(test_xxh3_multiset_arithmetic);
+    RUN_TEST(test_xxh3_mphf_variants_match_scalar);
+    RUN_TEST(test_xxh3_mphf_image_and_errors);
+    RUN_TEST(test_xxh3_partition_variants_match_direct);
+    RUN_TEST(test_xxh3_partition_errors);
+    RUN_TEST(test_xxh3_consistent_variants_match_naive);
+    RUN_TEST(test_xxh3_consistent_properties);
+    RUN_TEST(test_xxh3_blocks_variants_match_per_block);
+    RUN_TEST(test_xxh3_blocks_errors);
+    RUN_TEST(test_xxh3_scrubber_step_reports_mismatches);
+    RUN_TEST(test_xxh3_scrubber_reuses_removed_regions);
+    RUN_TEST(test_xxh3_scrubber_thread_limits_and_pauses);
+    RUN_TEST(test_xxh3_scrubber_concurrent_steps);
 
     /* cross-algorithm */
     RUN_TEST(test_xxh32_xxh64_outputs_differ_for_same_input);